@@ -93,12 +93,12 @@ dynamic_encoder_cb(const void *data, size_t size, void *keyp) {
                 new_size *= 2;
             } while(new_size <= key->computed_size + size);
 
-            p = REALLOC(key->buffer, new_size);
+            p = realloc(key->buffer, new_size);
             if(p) {
                 key->buffer = p;
                 key->buffer_size = new_size;
             } else {
-                FREEMEM(key->buffer);
+                free(key->buffer);
                 key->buffer = 0;
                 key->buffer_size = 0;
                 key->computed_size += size;
@@ -193,8 +193,12 @@ asn_encode_to_new_buffer(const asn_codec_ctx_t *opt_codec_ctx,
     struct dynamic_encoder_key buf_key;
     asn_encode_to_new_buffer_result_t res;
 
+    /*
+     * The result is released by the caller with free(), so it never comes
+     * from an active arena.
+     */
     buf_key.buffer_size = 16;
-    buf_key.buffer = MALLOC(buf_key.buffer_size);
+    buf_key.buffer = malloc(buf_key.buffer_size);
     buf_key.computed_size = 0;
 
     res.result = asn_encode_internal(opt_codec_ctx, syntax, td, sptr,
@@ -0,0 +1,202 @@
+/*
+ * Bump allocator for the ASN.1 support code, see asn_arena.h.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asn_arena.h"
+
+#define	ASN_ARENA_ALIGN		16
+#define	ASN_ARENA_HEADER	ASN_ARENA_ALIGN	/* Keeps the block size for realloc */
+
+typedef struct asn_arena_chunk_s {
+	struct asn_arena_chunk_s *next;
+	size_t size;		/* Usable bytes in data[] */
+	size_t used;
+	size_t last;		/* Offset of the last block, for in-place realloc */
+	_Alignas(ASN_ARENA_ALIGN) unsigned char data[];
+} asn_arena_chunk_t;
+
+struct asn_arena_s {
+	asn_arena_chunk_t *head;	/* Current chunk, older ones follow */
+	size_t chunk_size;
+};
+
+static _Thread_local asn_arena_t *active_arena;
+static _Thread_local asn_mem_stats_t mem_stats;
+
+static size_t
+align_up(size_t size) {
+	return (size + (ASN_ARENA_ALIGN - 1)) & ~(size_t)(ASN_ARENA_ALIGN - 1);
+}
+
+static asn_arena_chunk_t *
+chunk_new(size_t size) {
+	asn_arena_chunk_t *chunk = malloc(sizeof(*chunk) + size);
+	if(!chunk) return NULL;
+	mem_stats.heap_allocs++;
+	chunk->next = NULL;
+	chunk->size = size;
+	chunk->used = 0;
+	chunk->last = 0;
+	return chunk;
+}
+
+static int
+arena_owns(const asn_arena_t *arena, const void *ptr) {
+	const asn_arena_chunk_t *chunk;
+	for(chunk = arena->head; chunk; chunk = chunk->next) {
+		const unsigned char *p = ptr;
+		if(p >= chunk->data && p < chunk->data + chunk->size)
+			return 1;
+	}
+	return 0;
+}
+
+static void *
+arena_alloc(asn_arena_t *arena, size_t size) {
+	size_t need = ASN_ARENA_HEADER + align_up(size ? size : 1);
+	asn_arena_chunk_t *chunk = arena->head;
+	unsigned char *block;
+
+	if(!chunk || chunk->size - chunk->used < need) {
+		size_t chunk_size = need > arena->chunk_size ? need : arena->chunk_size;
+		asn_arena_chunk_t *fresh = chunk_new(chunk_size);
+		if(!fresh) return NULL;
+		fresh->next = chunk;
+		arena->head = fresh;
+		chunk = fresh;
+	}
+
+	block = chunk->data + chunk->used;
+	*(size_t *)block = size;
+	chunk->last = chunk->used;
+	chunk->used += need;
+	mem_stats.arena_allocs++;
+	return block + ASN_ARENA_HEADER;
+}
+
+asn_arena_t *
+asn_arena_new(size_t chunk_size) {
+	asn_arena_t *arena = malloc(sizeof(*arena));
+	if(!arena) return NULL;
+	arena->head = NULL;
+	arena->chunk_size = align_up(chunk_size ? chunk_size : 1);
+	return arena;
+}
+
+void
+asn_arena_reset(asn_arena_t *arena) {
+	asn_arena_chunk_t *chunk;
+	size_t total = 0;
+
+	if(!arena || !arena->head) return;
+
+	if(!arena->head->next) {
+		arena->head->used = 0;
+		arena->head->last = 0;
+		return;
+	}
+
+	/*
+	 * More than one chunk was needed. Release them all, the next use
+	 * starts with a single chunk that is large enough.
+	 */
+	chunk = arena->head;
+	while(chunk) {
+		asn_arena_chunk_t *next = chunk->next;
+		total += chunk->size;
+		free(chunk);
+		chunk = next;
+	}
+	arena->head = NULL;
+	arena->chunk_size = total;
+}
+
+void
+asn_arena_delete(asn_arena_t *arena) {
+	asn_arena_chunk_t *chunk;
+
+	if(!arena) return;
+
+	chunk = arena->head;
+	while(chunk) {
+		asn_arena_chunk_t *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	free(arena);
+}
+asn_arena_t *
+asn_arena_activate(asn_arena_t *arena) {
+	asn_arena_t *previous = active_arena;
+	active_arena = arena;
+	return previous;
+}
+
+void *
+asn_mem_calloc(size_t nmemb, size_t size) {
+	void *ptr;
+	if(active_arena) {
+		if(size && nmemb > SIZE_MAX / size) return NULL;
+		ptr = arena_alloc(active_arena, nmemb * size);
+		if(ptr) memset(ptr, 0, nmemb * size);
+		return ptr;
+	}
+	mem_stats.heap_allocs++;
+	return calloc(nmemb, size);
+}
+
+void *
+asn_mem_malloc(size_t size) {
+	if(active_arena)
+		return arena_alloc(active_arena, size);
+	mem_stats.heap_allocs++;
+	return malloc(size);
+}
+
+void *
+asn_mem_realloc(void *ptr, size_t size) {
+	asn_arena_t *arena = active_arena;
+	unsigned char *block;
+	size_t old_size;
+	void *fresh;
+
+	if(!arena || (ptr && !arena_owns(arena, ptr))) {
+		mem_stats.heap_allocs++;
+		return realloc(ptr, size);
+	}
+	if(!ptr) return arena_alloc(arena, size);
+
+	block = (unsigned char *)ptr - ASN_ARENA_HEADER;
+	old_size = *(size_t *)block;
+
+	/* Grow the last block of the current chunk in place */
+	if(block == arena->head->data + arena->head->last) {
+		size_t need = ASN_ARENA_HEADER + align_up(size ? size : 1);
+		if(arena->head->size - arena->head->last >= need) {
+			arena->head->used = arena->head->last + need;
+			*(size_t *)block = size;
+			return ptr;
+		}
+	}
+
+	fresh = arena_alloc(arena, size);
+	if(fresh) memcpy(fresh, ptr, old_size < size ? old_size : size);
+	return fresh;
+}
+
+void
+asn_mem_free(void *ptr) {
+	if(!ptr) return;
+	if(active_arena && arena_owns(active_arena, ptr))
+		return;
+	mem_stats.heap_frees++;
+	free(ptr);
+}
+
+asn_mem_stats_t *
+asn_mem_stats(void) {
+	return &mem_stats;
+}
@@ -0,0 +1,68 @@
+/*
+ * Allocation hooks of the ASN.1 support code with an optional per-thread
+ * arena. While an arena is active on a thread, every CALLOC/MALLOC/REALLOC of
+ * the support code on that thread is served from it and FREEMEM of arena
+ * memory is a no-op. Everything is released at once by asn_arena_reset() or
+ * asn_arena_delete(). Structures allocated from an arena must not be used or
+ * freed after the arena is reset.
+ */
+#ifndef	ASN_ARENA_H
+#define	ASN_ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct asn_arena_s asn_arena_t;
+
+/*
+ * Per-thread allocation counters, for measurement purposes.
+ */
+typedef struct asn_mem_stats_s {
+	size_t heap_allocs;	/* Allocations forwarded to the C library */
+	size_t heap_frees;	/* Frees forwarded to the C library */
+	size_t arena_allocs;	/* Allocations served from an arena */
+} asn_mem_stats_t;
+
+/*
+ * Create an arena whose chunks are at least (chunk_size) bytes.
+ */
+asn_arena_t *asn_arena_new(size_t chunk_size);
+
+/*
+ * Release all memory of the arena. Afterwards a single chunk, large enough
+ * for everything allocated so far, is reused.
+ */
+void asn_arena_reset(asn_arena_t *arena);
+
+/*
+ * Release the arena itself. It must not be active on any thread.
+ */
+void asn_arena_delete(asn_arena_t *arena);
+
+/*
+ * Make (arena) the active arena of the calling thread, or deactivate any
+ * arena if NULL. Returns the previously active arena.
+ */
+asn_arena_t *asn_arena_activate(asn_arena_t *arena);
+
+/*
+ * Allocation hooks used by the CALLOC/MALLOC/REALLOC/FREEMEM macros.
+ */
+void *asn_mem_calloc(size_t nmemb, size_t size);
+void *asn_mem_malloc(size_t size);
+void *asn_mem_realloc(void *ptr, size_t size);
+void asn_mem_free(void *ptr);
+
+/*
+ * Returns the allocation counters of the calling thread.
+ */
+asn_mem_stats_t *asn_mem_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* ASN_ARENA_H */
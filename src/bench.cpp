@@ -0,0 +1,277 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <utils/common.hpp>
+#include <utils/constants.hpp>
+#include <utils/options.hpp>
+
+struct BenchmarkEntry
+{
+    std::string name;
+    std::string description;
+    std::function<bool(const bench::BenchOptions &, Json &)> fun;
+};
+
+static const std::vector<BenchmarkEntry> g_benchmarks = {
+    {"ngap-codec", "Compares the fast NGAP NAS transport codec against asn1c", bench::RunNgapCodec},
+    {"asn-alloc", "Counts asn1c allocations per NGAP and RRC message with and without an arena",
+     bench::RunAsnAllocations},
+    {"rlc", "Drives RLC TM/UM/AM entity pairs over a simulated lossy link", bench::RunRlc},
+    {"nas-codec", "Compares the full NAS decoder against the zero-copy message view", bench::RunNasCodec},
+    {"e2e", "Runs nr-core, nr-gnb and nr-ue on loopback and measures the procedure and traffic rates",
+     bench::RunEndToEnd},
+    {"sctp-echo", "Measures the SCTP message rate against an echoing peer on loopback, per stream count and NODELAY",
+     bench::RunSctpEcho},
+};
+
+static struct Options
+{
+    std::vector<std::string> names{};
+    bench::BenchOptions bench{};
+    bool json{};
+    std::string outputFile{};
+} g_options{};
+
+/* Parses "<num>" or "<min>-<max>" */
+static void ParseRange(const std::string &str, int &min, int &max)
+{
+    auto pos = str.find('-');
+    min = utils::ParseInt(str.substr(0, pos));
+    max = pos == std::string::npos ? min : utils::ParseInt(str.substr(pos + 1));
+    if (min <= 0 || max < min)
+        throw std::runtime_error("Invalid range: " + str);
+}
+
+/* Parses "<num>,<num>,..." */
+static std::vector<int> ParseList(const std::string &str)
+{
+    std::vector<int> result{};
+    size_t start = 0;
+    while (start <= str.size())
+    {
+        size_t end = str.find(',', start);
+        if (end == std::string::npos)
+            end = str.size();
+        result.push_back(utils::ParseInt(str.substr(start, end - start)));
+        start = end + 1;
+    }
+    return result;
+}
+
+static void ReadOptions(int argc, char **argv)
+{
+    std::vector<std::string> examples{};
+    for (auto &entry : g_benchmarks)
+        examples.push_back(entry.name + ": " + entry.description);
+
+    opt::OptionsDescription desc{cons::Project,
+                                 cons::Tag,
+                                 cons::DescriptionBench,
+                                 cons::Owner,
+                                 "nr-bench",
+                                 {"[option...] <benchmark>..."},
+                                 examples,
+                                 true,
+                                 false};
+
+    opt::OptionItem itemIterations = {'n', "iterations", "Number of iterations for each benchmark", "num"};
+    opt::OptionItem itemSeed = {'s', "seed", "Seed of the random input generator", "seed"};
+    opt::OptionItem itemJson = {'j', "json", "Print the report in JSON format instead of YAML", std::nullopt};
+    opt::OptionItem itemRlcMode = {std::nullopt, "rlc-mode", "RLC mode to benchmark (tm, um or am), default is all",
+                                   "mode"};
+    opt::OptionItem itemSnLength = {std::nullopt, "sn-length", "RLC SN length in bits (UM: 6 or 12, AM: 12 or 18)",
+                                    "bits"};
+    opt::OptionItem itemSduSize = {std::nullopt, "sdu-size", "RLC SDU size in bytes, default is 100-1500",
+                                   "min-max"};
+    opt::OptionItem itemOpportunity = {std::nullopt, "opportunity",
+                                       "Transmission opportunity size in bytes per ms, default is 200-3000", "min-max"};
+    opt::OptionItem itemLoss = {std::nullopt, "loss", "Percentage of the PDUs lost on the link, default is 0",
+                                "percent"};
+    opt::OptionItem itemReorder = {std::nullopt, "reorder",
+                                   "Maximum additional link delay in ms, causing reordering, default is 0", "ms"};
+    opt::OptionItem itemOutput = {'o', "output", "Write the report to the given file instead of the standard output",
+                                  "file"};
+    opt::OptionItem itemConfigDir = {std::nullopt, "config-dir",
+                                     "Directory of the e2e configuration templates, default is 'config'", "dir"};
+    opt::OptionItem itemUes = {std::nullopt, "ues", "Number of UEs in the e2e benchmark, default is 100", "num"};
+    opt::OptionItem itemPacketSizes = {std::nullopt, "packet-sizes",
+                                       "Comma separated e2e packet sizes in bytes, default is 64,512,1400", "sizes"};
+    opt::OptionItem itemRate = {std::nullopt, "rate", "Uplink packets per second of each e2e UE, default is 100",
+                                "pps"};
+    opt::OptionItem itemDuration = {std::nullopt, "duration",
+                                    "Seconds of e2e traffic per packet size, default is 5", "seconds"};
+
+    desc.items.push_back(itemIterations);
+    desc.items.push_back(itemSeed);
+    desc.items.push_back(itemJson);
+    desc.items.push_back(itemRlcMode);
+    desc.items.push_back(itemSnLength);
+    desc.items.push_back(itemSduSize);
+    desc.items.push_back(itemOpportunity);
+    desc.items.push_back(itemLoss);
+    desc.items.push_back(itemReorder);
+    desc.items.push_back(itemOutput);
+    desc.items.push_back(itemConfigDir);
+    desc.items.push_back(itemUes);
+    desc.items.push_back(itemPacketSizes);
+    desc.items.push_back(itemRate);
+    desc.items.push_back(itemDuration);
+
+    opt::OptionsResult opt{argc, argv, desc, false, nullptr};
+
+    g_options.bench.iterations = 100000;
+    if (opt.hasFlag(itemIterations))
+    {
+        g_options.bench.iterations = utils::ParseInt(opt.getOption(itemIterations));
+        if (g_options.bench.iterations <= 0)
+            throw std::runtime_error("Invalid number of iterations");
+    }
+
+    g_options.bench.seed = 1;
+    if (opt.hasFlag(itemSeed))
+        g_options.bench.seed = utils::ParseInt(opt.getOption(itemSeed));
+
+    g_options.json = opt.hasFlag(itemJson);
+    if (opt.hasFlag(itemOutput))
+        g_options.outputFile = opt.getOption(itemOutput);
+
+    auto &rlc = g_options.bench.rlc;
+    if (opt.hasFlag(itemRlcMode))
+    {
+        rlc.mode = opt.getOption(itemRlcMode);
+        if (rlc.mode != "tm" && rlc.mode != "um" && rlc.mode != "am")
+            throw std::runtime_error("Invalid RLC mode: " + rlc.mode);
+    }
+    if (opt.hasFlag(itemSnLength))
+        rlc.snLength = utils::ParseInt(opt.getOption(itemSnLength));
+
+    rlc.sduSizeMin = 100;
+    rlc.sduSizeMax = 1500;
+    if (opt.hasFlag(itemSduSize))
+        ParseRange(opt.getOption(itemSduSize), rlc.sduSizeMin, rlc.sduSizeMax);
+    if (rlc.sduSizeMin < 4 || rlc.sduSizeMax > 9000)
+        throw std::runtime_error("RLC SDU size must be in range 4-9000");
+
+    rlc.opportunityMin = 200;
+    rlc.opportunityMax = 3000;
+    if (opt.hasFlag(itemOpportunity))
+        ParseRange(opt.getOption(itemOpportunity), rlc.opportunityMin, rlc.opportunityMax);
+
+    if (opt.hasFlag(itemLoss))
+    {
+        rlc.lossPercent = utils::ParseInt(opt.getOption(itemLoss));
+        if (rlc.lossPercent < 0 || rlc.lossPercent >= 100)
+            throw std::runtime_error("Invalid loss percentage");
+    }
+    if (opt.hasFlag(itemReorder))
+    {
+        rlc.reorderWindow = utils::ParseInt(opt.getOption(itemReorder));
+        if (rlc.reorderWindow < 0)
+            throw std::runtime_error("Invalid reorder window");
+    }
+
+    auto &e2e = g_options.bench.e2e;
+    e2e.configDir = opt.hasFlag(itemConfigDir) ? opt.getOption(itemConfigDir) : "config";
+
+    e2e.ueCount = 100;
+    if (opt.hasFlag(itemUes))
+    {
+        e2e.ueCount = utils::ParseInt(opt.getOption(itemUes));
+        if (e2e.ueCount <= 0)
+            throw std::runtime_error("Invalid number of UEs");
+    }
+
+    e2e.packetSizes = {64, 512, 1400};
+    if (opt.hasFlag(itemPacketSizes))
+    {
+        e2e.packetSizes = ParseList(opt.getOption(itemPacketSizes));
+        for (int size : e2e.packetSizes)
+            if (size < 48 || size > cons::TunMtu)
+                throw std::runtime_error("Packet size must be between 48 and " + std::to_string(cons::TunMtu));
+    }
+
+    e2e.rate = 100;
+    if (opt.hasFlag(itemRate))
+    {
+        e2e.rate = utils::ParseInt(opt.getOption(itemRate));
+        if (e2e.rate <= 0 || e2e.rate > 1000000)
+            throw std::runtime_error("Rate must be between 1 and 1000000 packets per second");
+    }
+
+    e2e.duration = 5;
+    if (opt.hasFlag(itemDuration))
+    {
+        e2e.duration = utils::ParseInt(opt.getOption(itemDuration));
+        if (e2e.duration <= 0)
+            throw std::runtime_error("Invalid duration");
+    }
+
+    for (int i = 0; i < opt.positionalCount(); i++)
+        g_options.names.push_back(opt.getPositional(i));
+}
+
+static const BenchmarkEntry *FindBenchmark(const std::string &name)
+{
+    for (auto &entry : g_benchmarks)
+        if (entry.name == name)
+            return &entry;
+    return nullptr;
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        ReadOptions(argc, argv);
+        for (auto &name : g_options.names)
+            if (FindBenchmark(name) == nullptr)
+                throw std::runtime_error("Unknown benchmark: " + name);
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+
+    bool success = true;
+    Json report = Json::Obj({});
+
+    for (auto &name : g_options.names)
+    {
+        Json item = Json::Obj({});
+        bool ok = FindBenchmark(name)->fun(g_options.bench, item);
+        item.put("success", ok);
+        report.put(name, std::move(item));
+        success &= ok;
+    }
+
+    std::string output = g_options.json ? report.dumpJson() : report.dumpYaml();
+    if (g_options.outputFile.empty())
+    {
+        std::cout << output << std::endl;
+    }
+    else
+    {
+        std::ofstream file{g_options.outputFile};
+        file << output << std::endl;
+        if (!file.good())
+        {
+            std::cerr << "ERROR: Report could not be written to " << g_options.outputFile << std::endl;
+            return 1;
+        }
+    }
+    return success ? 0 : 1;
+}
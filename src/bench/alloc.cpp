@@ -0,0 +1,148 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "bench.hpp"
+#include "messages.hpp"
+
+#include <functional>
+
+#include <lib/asn/utils.hpp>
+
+#include <asn/ngap/ASN_NGAP_NGAP-PDU.h>
+#include <asn/rrc/ASN_RRC_BCCH-DL-SCH-Message.h>
+
+namespace
+{
+
+std::vector<uint8_t> Encode(asn_transfer_syntax syntax, const asn_TYPE_descriptor_t &desc, const void *pdu)
+{
+    std::vector<uint8_t> res{};
+    auto enc = asn_encode_to_new_buffer(nullptr, syntax, &desc, pdu);
+    if (enc.buffer != nullptr && enc.result.encoded >= 0)
+    {
+        auto *data = reinterpret_cast<const uint8_t *>(enc.buffer);
+        res.assign(data, data + enc.result.encoded);
+    }
+    free(enc.buffer);
+    return res;
+}
+
+void EncodeNgap(const bench::NasInput &in)
+{
+    auto *pdu = bench::BuildUplinkNasTransport(in);
+    char errorBuffer[1024];
+    size_t len = sizeof(errorBuffer);
+    if (asn_check_constraints(&asn_DEF_ASN_NGAP_NGAP_PDU, pdu, errorBuffer, &len) == 0)
+        Encode(ATS_ALIGNED_CANONICAL_PER, asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+}
+
+void DecodeNgap(const std::vector<uint8_t> &encoded)
+{
+    auto *pdu = asn::New<ASN_NGAP_NGAP_PDU>();
+    aper_decode(nullptr, &asn_DEF_ASN_NGAP_NGAP_PDU, reinterpret_cast<void **>(&pdu), encoded.data(), encoded.size(),
+                0, 0);
+    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+}
+
+void EncodeRrc(const Plmn &plmn)
+{
+    auto *pdu = bench::BuildSib1Message(1, 0x10, plmn);
+    Encode(ATS_UNALIGNED_CANONICAL_PER, asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, pdu);
+    asn::Free(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, pdu);
+}
+
+void DecodeRrc(const std::vector<uint8_t> &encoded)
+{
+    auto *pdu = asn::New<ASN_RRC_BCCH_DL_SCH_Message>();
+    uper_decode(nullptr, &asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, reinterpret_cast<void **>(&pdu), encoded.data(),
+                encoded.size(), 0, 0);
+    asn::Free(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, pdu);
+}
+
+Json MeasureRun(int iterations, asn::Arena *arena, const std::function<void()> &operation)
+{
+    auto before = *asn_mem_stats();
+
+    bench::Stopwatch sw{};
+    for (int i = 0; i < iterations; i++)
+    {
+        if (arena)
+        {
+            asn::ArenaScope scope{*arena};
+            operation();
+        }
+        else
+        {
+            operation();
+        }
+    }
+    int64_t elapsed = sw.elapsedNanos();
+
+    auto after = *asn_mem_stats();
+
+    // Reported in thousandths to keep the fractional part with an integer-only JSON
+    auto perMessage = [iterations](size_t count) { return static_cast<int64_t>(count * 1000 / iterations); };
+
+    return Json::Obj({
+        {"heap-allocs-per-msg-x1000", perMessage(after.heap_allocs - before.heap_allocs)},
+        {"heap-frees-per-msg-x1000", perMessage(after.heap_frees - before.heap_frees)},
+        {"arena-allocs-per-msg-x1000", perMessage(after.arena_allocs - before.arena_allocs)},
+        {"msgs-per-sec", bench::PerSecond(iterations, elapsed)},
+    });
+}
+
+void Measure(const bench::BenchOptions &options, const std::string &name, const std::function<void()> &operation,
+             Json &report)
+{
+    asn::Arena arena{};
+    report.put(name, Json::Obj({
+                         {"heap", MeasureRun(options.iterations, nullptr, operation)},
+                         {"arena", MeasureRun(options.iterations, &arena, operation)},
+                     }));
+}
+
+} // namespace
+
+namespace bench
+{
+
+bool RunAsnAllocations(const BenchOptions &options, Json &report)
+{
+    Random random{options.seed};
+    auto in = RandomNasInput(random, false);
+
+    Plmn plmn{};
+    plmn.mcc = 1;
+    plmn.mnc = 1;
+    plmn.isLongMnc = false;
+
+    auto ngapEncoded = [&in]() {
+        auto *pdu = BuildDownlinkNasTransport(in);
+        auto res = Encode(ATS_ALIGNED_CANONICAL_PER, asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+        asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+        return res;
+    }();
+    auto rrcEncoded = [&plmn]() {
+        auto *pdu = BuildSib1Message(1, 0x10, plmn);
+        auto res = Encode(ATS_UNALIGNED_CANONICAL_PER, asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, pdu);
+        asn::Free(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, pdu);
+        return res;
+    }();
+
+    if (ngapEncoded.empty() || rrcEncoded.empty())
+        return false;
+
+    Measure(options, "ngap-uplink-nas-transport-encode", [&in]() { EncodeNgap(in); }, report);
+    Measure(options, "ngap-downlink-nas-transport-decode", [&ngapEncoded]() { DecodeNgap(ngapEncoded); }, report);
+    Measure(options, "rrc-sib1-encode", [&plmn]() { EncodeRrc(plmn); }, report);
+    Measure(options, "rrc-sib1-decode", [&rrcEncoded]() { DecodeRrc(rrcEncoded); }, report);
+    return true;
+}
+
+} // namespace bench
@@ -0,0 +1,21 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "bench.hpp"
+
+namespace bench
+{
+
+int64_t PerSecond(int64_t count, int64_t elapsedNanos)
+{
+    if (elapsedNanos <= 0)
+        return 0;
+    return static_cast<int64_t>(static_cast<double>(count) * 1e9 / static_cast<double>(elapsedNanos));
+}
+
+} // namespace bench
@@ -0,0 +1,77 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <utils/json.hpp>
+
+namespace bench
+{
+
+struct RlcBenchOptions
+{
+    std::string mode{};   // "tm", "um", "am" or empty for all
+    int snLength{};       // 0 means the default of the mode
+    int sduSizeMin{};
+    int sduSizeMax{};
+    int opportunityMin{}; // Transmission opportunity size in bytes, one per millisecond in each direction
+    int opportunityMax{};
+    int lossPercent{};
+    int reorderWindow{};  // Maximum additional delay of a PDU in milliseconds
+};
+
+struct E2eBenchOptions
+{
+    std::string configDir{};        // Templates of the core, gNB and UE configurations
+    int ueCount{};
+    std::vector<int> packetSizes{}; // One traffic run per packet size
+    int rate{};                     // Uplink packets per second of each UE
+    int duration{};                 // Seconds of traffic per packet size
+};
+
+struct BenchOptions
+{
+    int iterations{};
+    int64_t seed{};
+    RlcBenchOptions rlc{};
+    E2eBenchOptions e2e{};
+};
+
+class Stopwatch
+{
+    std::chrono::steady_clock::time_point m_start;
+
+  public:
+    Stopwatch() : m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    [[nodiscard]] inline int64_t elapsedNanos() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start)
+            .count();
+    }
+};
+
+/* Returns the number of operations per second, or 0 if the elapsed time is too short to measure */
+int64_t PerSecond(int64_t count, int64_t elapsedNanos);
+
+/* Each benchmark returns false if a verification step fails, and fills the given report */
+bool RunNgapCodec(const BenchOptions &options, Json &report);
+bool RunAsnAllocations(const BenchOptions &options, Json &report);
+bool RunRlc(const BenchOptions &options, Json &report);
+bool RunNasCodec(const BenchOptions &options, Json &report);
+bool RunEndToEnd(const BenchOptions &options, Json &report);
+bool RunSctpEcho(const BenchOptions &options, Json &report);
+
+} // namespace bench
@@ -0,0 +1,635 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <lib/app/cli_base.hpp>
+#include <utils/common.hpp>
+#include <utils/constants.hpp>
+#include <utils/io.hpp>
+#include <utils/libc_error.hpp>
+#include <utils/random.hpp>
+#include <utils/yaml_utils.hpp>
+#include <yaml-cpp/yaml.h>
+
+namespace
+{
+
+constexpr int POLL_INTERVAL_MS = 100;
+constexpr int RESPONSE_TIMEOUT_MS = 10000;
+constexpr int STARTUP_TIMEOUT_MS = 10000;
+constexpr int CORE_STARTUP_MS = 500;
+constexpr int DRAIN_MS = 500; // Time given to the last echoed packets to come back
+constexpr int STOP_TIMEOUT_MS = 3000;
+
+struct Process
+{
+    std::string name{};
+    pid_t pid{-1};
+    int64_t phaseCpuMs{}; // CPU time at the start of the current phase
+};
+
+struct Usage
+{
+    int64_t cpuMs{};
+    int64_t peakRssKib{};
+};
+
+sockaddr_un MakeAddress(const std::string &path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+/* Talks to the unix CLI sockets of the UE processes, like nr-cli2 */
+class CliClient
+{
+  private:
+    int m_fd;
+    std::string m_socketName;
+    std::vector<uint8_t> m_buffer;
+
+  public:
+    CliClient() : m_fd{}, m_socketName{}, m_buffer(65536)
+    {
+        io::CreateDirectory(cons::CLI_SOCKET_DIR);
+
+        m_fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (m_fd < 0)
+            throw LibError("Socket open failure");
+
+        Random r;
+        m_socketName = cons::CLI_SOCKET_DIR + std::string{"cli-client."} + utils::IntToHex(r.nextL()) +
+                       utils::IntToHex(r.nextL());
+
+        auto address = MakeAddress(m_socketName);
+        if (bind(m_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+            throw LibError("Socket bind failure");
+    }
+
+    ~CliClient()
+    {
+        close(m_fd);
+        unlink(m_socketName.c_str());
+    }
+
+    /*
+     * Executes the command on the node behind the socket, or on the matching UEs if it is the socket of a UE
+     * process. The outputs of the UEs are handed to 'onEcho'. Returns false if the command failed or timed out.
+     */
+    bool execute(const std::string &socketName, const std::string &nodeName, const std::string &command,
+                 const std::function<void(const std::string &)> &onEcho, std::string &result)
+    {
+        OctetString stream{};
+        app::CliMessage::Encode(app::CliMessage::Command(InetAddress{}, command, nodeName), stream);
+
+        auto address = MakeAddress(cons::CLI_SOCKET_DIR + socketName);
+        if (sendto(m_fd, stream.data(), static_cast<size_t>(stream.length()), 0,
+                   reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+            return false;
+
+        app::CliChunkAssembler assembler{};
+        while (true)
+        {
+            pollfd pfd = {m_fd, POLLIN, 0};
+            if (poll(&pfd, 1, RESPONSE_TIMEOUT_MS) <= 0)
+                return false;
+
+            auto size = recv(m_fd, m_buffer.data(), m_buffer.size(), 0);
+            if (size < 0)
+                return false;
+
+            app::CliMessage msg{};
+            if (!app::CliMessage::Decode(m_buffer.data(), static_cast<size_t>(size), msg) || !assembler.assemble(msg))
+                continue;
+
+            if (msg.type == app::CliMessage::Type::ECHO && onEcho)
+                onEcho(msg.value);
+            else if (msg.type == app::CliMessage::Type::RESULT || msg.type == app::CliMessage::Type::ERROR)
+            {
+                result = std::move(msg.value);
+                return msg.type == app::CliMessage::Type::RESULT;
+            }
+        }
+    }
+};
+
+/* Splits an output of a UE of a bulk command, see FormatOutput() in ue/bulk_cmd.cpp. Returns false on error. */
+bool ParseUeOutput(const std::string &echo, std::string &output)
+{
+    size_t lineEnd = echo.find('\n');
+    std::string firstLine = echo.substr(0, lineEnd);
+    size_t colon = firstLine.find(':');
+    if (colon == std::string::npos || firstLine.find(" ERROR:", colon) == colon + 1)
+        return false;
+
+    output = colon + 2 <= firstLine.size() ? firstLine.substr(colon + 2) : "";
+    if (lineEnd == std::string::npos)
+        return true;
+
+    // Multi-line outputs are indented by two spaces under the node name
+    size_t start = lineEnd + 1;
+    while (start < echo.size())
+    {
+        size_t end = echo.find('\n', start);
+        if (end == std::string::npos)
+            end = echo.size();
+        if (!output.empty())
+            output += '\n';
+        if (end - start > 2)
+            output += echo.substr(start + 2, end - start - 2);
+        start = end + 1;
+    }
+    return true;
+}
+
+/* Executes the command on all UEs of the process, and returns the number of UEs that succeeded */
+int ExecuteOnUes(CliClient &client, pid_t uePid, const std::string &command,
+                 const std::function<void(const YAML::Node &)> &onOutput)
+{
+    int succeeded = 0;
+    std::string result{};
+    client.execute(
+        cons::CLI_PROCESS_PREFIX + std::to_string(uePid), "*", command,
+        [&succeeded, &onOutput](const std::string &echo) {
+            std::string output{};
+            if (!ParseUeOutput(echo, output))
+                return;
+            succeeded++;
+            if (!onOutput)
+                return;
+            try
+            {
+                onOutput(YAML::Load(output));
+            }
+            catch (const YAML::Exception &)
+            {
+                // Not a structured output
+            }
+        },
+        result);
+    return succeeded;
+}
+
+std::string ScalarOf(const YAML::Node &node, const std::string &key)
+{
+    return node.IsMap() && node[key] && node[key].IsScalar() ? node[key].as<std::string>() : "";
+}
+
+int64_t IntOf(const YAML::Node &node, const std::string &key)
+{
+    return node.IsMap() && node[key] && node[key].IsScalar() ? node[key].as<int64_t>() : 0;
+}
+
+pid_t Spawn(const std::string &workDir, const std::string &path, const std::vector<std::string> &args,
+            const std::string &outputFile)
+{
+    std::vector<char *> argv{};
+    argv.push_back(const_cast<char *>(path.c_str()));
+    for (auto &arg : args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0)
+        throw LibError("fork failure");
+
+    if (pid == 0)
+    {
+        int fd = open(outputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        // The log files of the nodes are also created in the working directory
+        if (chdir(workDir.c_str()) == 0)
+            execv(path.c_str(), argv.data());
+        _exit(127);
+    }
+    return pid;
+}
+
+bool IsRunning(Process &process)
+{
+    if (process.pid < 0)
+        return false;
+    int status = 0;
+    if (waitpid(process.pid, &status, WNOHANG) == 0)
+        return true;
+    process.pid = -1;
+    return false;
+}
+
+void Stop(Process &process)
+{
+    if (process.pid < 0)
+        return;
+
+    kill(process.pid, SIGTERM);
+    for (int waited = 0; waited < STOP_TIMEOUT_MS; waited += 50)
+    {
+        if (!IsRunning(process))
+            return;
+        utils::Sleep(50);
+    }
+
+    kill(process.pid, SIGKILL);
+    waitpid(process.pid, nullptr, 0);
+    process.pid = -1;
+}
+
+Usage ReadUsage(const Process &process)
+{
+    Usage usage{};
+    if (process.pid < 0)
+        return usage;
+
+    std::string path = "/proc/" + std::to_string(process.pid);
+
+    std::ifstream statFile{path + "/stat"};
+    std::string stat((std::istreambuf_iterator<char>(statFile)), std::istreambuf_iterator<char>());
+
+    // Fields are counted from the state (3rd field), since the command name may contain spaces
+    auto pos = stat.rfind(')');
+    if (pos != std::string::npos)
+    {
+        std::istringstream fields{stat.substr(pos + 1)};
+        std::string field{};
+        int64_t ticks = 0;
+        for (int i = 3; i <= 15 && fields >> field; i++)
+            if (i == 14 || i == 15) // utime and stime
+                ticks += std::stoll(field);
+        usage.cpuMs = ticks * 1000 / sysconf(_SC_CLK_TCK);
+    }
+
+    std::ifstream statusFile{path + "/status"};
+    std::string line{};
+    while (std::getline(statusFile, line))
+        if (line.rfind("VmHWM:", 0) == 0)
+            usage.peakRssKib = std::atoll(line.c_str() + 6);
+
+    return usage;
+}
+
+/* CPU time of the processes since the previous phase */
+Json PhaseCpu(std::vector<Process> &processes)
+{
+    Json json = Json::Obj({});
+    for (auto &process : processes)
+    {
+        int64_t cpuMs = ReadUsage(process).cpuMs;
+        json.put(process.name, cpuMs - process.phaseCpuMs);
+        process.phaseCpuMs = cpuMs;
+    }
+    return json;
+}
+
+void WriteYaml(const std::string &path, const YAML::Node &node)
+{
+    YAML::Emitter emitter{};
+    emitter << node;
+    io::WriteAllText(path, std::string{emitter.c_str()} + "\n");
+}
+
+std::string ExecutableDirectory()
+{
+    char path[PATH_MAX] = {};
+    auto length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0)
+        throw LibError("Executable path could not be read");
+    std::string result{path, static_cast<size_t>(length)};
+    return result.substr(0, result.rfind('/'));
+}
+
+class EndToEnd
+{
+  private:
+    const bench::E2eBenchOptions &m_options;
+    std::string m_workDir;
+    std::vector<Process> m_processes;
+    CliClient m_client;
+
+    std::string m_destination;
+
+  public:
+    explicit EndToEnd(const bench::E2eBenchOptions &options)
+        : m_options{options}, m_workDir{}, m_processes{}, m_client{}, m_destination{}
+    {
+    }
+
+    ~EndToEnd()
+    {
+        for (auto it = m_processes.rbegin(); it != m_processes.rend(); ++it)
+            Stop(*it);
+    }
+
+    bool run(Json &report)
+    {
+        char workDir[] = "/tmp/nr-bench-e2e.XXXXXX";
+        if (mkdtemp(workDir) == nullptr)
+            throw LibError("Working directory could not be created");
+        m_workDir = workDir;
+
+        writeConfigs();
+
+        bool ok = start(report) && registerUes(report) && establishSessions(report) && runTraffic(report);
+
+        // Peak RSS is only available while the processes are running
+        Json processes = Json::Obj({});
+        for (auto &process : m_processes)
+        {
+            Usage usage = ReadUsage(process);
+            processes.put(process.name, Json::Obj({
+                                            {"cpu-ms", usage.cpuMs},
+                                            {"peak-rss-kib", usage.peakRssKib},
+                                        }));
+        }
+        report.put("processes", processes);
+
+        for (auto it = m_processes.rbegin(); it != m_processes.rend(); ++it)
+            Stop(*it);
+
+        if (ok)
+            io::Remove(m_workDir);
+        else
+            std::cerr << "e2e: configurations and outputs of the nodes are kept in " << m_workDir << std::endl;
+        return ok;
+    }
+
+  private:
+    void writeConfigs()
+    {
+        auto core = YAML::LoadFile(m_options.configDir + "/mock-core.yaml");
+        auto gnb = YAML::LoadFile(m_options.configDir + "/open5gs-gnb.yaml");
+        auto ue = YAML::LoadFile(m_options.configDir + "/open5gs-ue.yaml");
+
+        // The core serves exactly the UEs of the benchmark, and echoes their packets
+        YAML::Node subscriber{};
+        subscriber["supi"] = ue["supi"];
+        subscriber["count"] = m_options.ueCount;
+        for (auto &key : {"key", "op", "opType", "amf"})
+            subscriber[key] = ue[key];
+        core["subscribers"] = YAML::Node{YAML::NodeType::Sequence};
+        core["subscribers"].push_back(subscriber);
+        core["upfMode"] = "echo";
+        core["statsInterval"] = 0;
+
+        // PDU sessions are established by the benchmark, so that they are measured separately
+        ue.remove("sessions");
+
+        WriteYaml(m_workDir + "/core.yaml", core);
+        WriteYaml(m_workDir + "/gnb.yaml", gnb);
+        WriteYaml(m_workDir + "/ue.yaml", ue);
+
+        // Any destination is echoed back by the UPF
+        m_destination = yaml::GetIp4(core, "gtpIp");
+    }
+
+    void spawn(const std::string &name, const std::vector<std::string> &args)
+    {
+        Process process{};
+        process.name = name;
+        process.pid = Spawn(m_workDir, ExecutableDirectory() + "/" + name, args, m_workDir + "/" + name + ".out");
+        m_processes.push_back(process);
+    }
+
+    bool checkRunning()
+    {
+        for (auto &process : m_processes)
+        {
+            if (!IsRunning(process))
+            {
+                std::cerr << "e2e: " << process.name << " has exited" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool start(Json &report)
+    {
+        spawn("nr-core", {"-c", m_workDir + "/core.yaml"});
+        utils::Sleep(CORE_STARTUP_MS);
+        if (!checkRunning())
+            return false;
+
+        bench::Stopwatch sw{};
+        spawn("nr-gnb", {"-c", m_workDir + "/gnb.yaml"});
+
+        // The gNB is not reachable over the unix CLI sockets, its log is watched instead
+        while (true)
+        {
+            // The output file is created by the child, possibly after the first poll
+            auto output = m_workDir + "/nr-gnb.out";
+            if (io::Exists(output) &&
+                io::ReadAllText(output).find("NG Setup procedure is successful") != std::string::npos)
+                break;
+            if (!checkRunning())
+                return false;
+            if (sw.elapsedNanos() > STARTUP_TIMEOUT_MS * 1000000ll)
+            {
+                std::cerr << "e2e: NG Setup is not completed" << std::endl;
+                return false;
+            }
+            utils::Sleep(POLL_INTERVAL_MS);
+        }
+
+        report.put("ues", m_options.ueCount);
+        report.put("ng-setup-ms", sw.elapsedNanos() / 1000000);
+        return true;
+    }
+
+    pid_t uePid()
+    {
+        return m_processes.back().pid;
+    }
+
+    /* Polls the UEs until 'isDone' holds for all of them, and returns the elapsed time or -1 on timeout */
+    int64_t pollUes(const bench::Stopwatch &sw, const std::string &command,
+                    const std::function<bool(const YAML::Node &)> &isDone, int &done)
+    {
+        int64_t timeout = (STARTUP_TIMEOUT_MS + 50ll * m_options.ueCount) * 1000000ll;
+        while (true)
+        {
+            done = 0;
+            ExecuteOnUes(m_client, uePid(), command, [&done, &isDone](const YAML::Node &output) {
+                if (isDone(output))
+                    done++;
+            });
+
+            int64_t elapsed = sw.elapsedNanos();
+            if (done >= m_options.ueCount)
+                return elapsed;
+            if (!checkRunning() || elapsed > timeout)
+                return -1;
+            utils::Sleep(POLL_INTERVAL_MS);
+        }
+    }
+
+    bool registerUes(Json &report)
+    {
+        PhaseCpu(m_processes);
+
+        // The start-up of the UE process is included, as in a real deployment
+        bench::Stopwatch sw{};
+        spawn("nr-ue", {"-c", m_workDir + "/ue.yaml", "-n", std::to_string(m_options.ueCount)});
+        m_processes.back().phaseCpuMs = 0;
+
+        int registered = 0;
+        int64_t elapsed = pollUes(
+            sw, "status", [](const YAML::Node &status) { return ScalarOf(status, "rm-state") == "RM-REGISTERED"; },
+            registered);
+
+        report.put("registration", Json::Obj({
+                                       {"registered", registered},
+                                       {"elapsed-ms", sw.elapsedNanos() / 1000000},
+                                       {"per-sec", bench::PerSecond(registered, sw.elapsedNanos())},
+                                       {"cpu-ms", PhaseCpu(m_processes)},
+                                   }));
+
+        if (elapsed < 0)
+            std::cerr << "e2e: " << m_options.ueCount - registered << " UEs are not registered" << std::endl;
+        return elapsed >= 0;
+    }
+
+    bool establishSessions(Json &report)
+    {
+        bench::Stopwatch sw{};
+        ExecuteOnUes(m_client, uePid(), "ps-establish IPv4 --sst 1", nullptr);
+
+        // The first PDU session of a UE has the PSI 1
+        int established = 0;
+        int64_t elapsed = pollUes(
+            sw, "ps-list",
+            [](const YAML::Node &sessions) {
+                return sessions.IsMap() && ScalarOf(sessions["PDU Session1"], "state") == "PS-ACTIVE";
+            },
+            established);
+
+        report.put("pdu-session", Json::Obj({
+                                      {"established", established},
+                                      {"elapsed-ms", sw.elapsedNanos() / 1000000},
+                                      {"per-sec", bench::PerSecond(established, sw.elapsedNanos())},
+                                      {"cpu-ms", PhaseCpu(m_processes)},
+                                  }));
+
+        if (elapsed < 0)
+            std::cerr << "e2e: " << m_options.ueCount - established << " PDU sessions are not established"
+                      << std::endl;
+        return elapsed >= 0;
+    }
+
+    bool runTraffic(Json &report)
+    {
+        bool ok = true;
+        Json traffic = Json::Arr({});
+
+        for (int packetSize : m_options.packetSizes)
+        {
+            std::string command = "traffic-start 1 " + m_destination + " --size " + std::to_string(packetSize) +
+                                  " --rate " + std::to_string(m_options.rate) + " --duration " +
+                                  std::to_string(m_options.duration);
+            int started = ExecuteOnUes(m_client, uePid(), command, nullptr);
+
+            utils::Sleep(m_options.duration * 1000 + DRAIN_MS);
+
+            int64_t ulPackets = 0, skipped = 0, dlPackets = 0, tagged = 0, lost = 0, rttSum = 0;
+            int64_t rttMin = 0, rttMax = 0;
+            ExecuteOnUes(m_client, uePid(), "traffic-stats", [&](const YAML::Node &stats) {
+                if (!stats.IsMap() || !stats["PDU Session1"])
+                    return;
+                auto uplink = stats["PDU Session1"]["uplink"];
+                auto downlink = stats["PDU Session1"]["downlink"];
+                ulPackets += IntOf(uplink, "packets");
+                skipped += IntOf(uplink, "skipped");
+                dlPackets += IntOf(downlink, "packets");
+
+                lost += IntOf(downlink, "lost");
+
+                int64_t ueTagged = IntOf(downlink, "tagged-packets");
+                if (ueTagged == 0)
+                    return;
+                rttMin = tagged == 0 ? IntOf(downlink, "rtt-min-us") : std::min(rttMin, IntOf(downlink, "rtt-min-us"));
+                rttMax = std::max(rttMax, IntOf(downlink, "rtt-max-us"));
+                rttSum += IntOf(downlink, "rtt-avg-us") * ueTagged;
+                tagged += ueTagged;
+            });
+
+            int64_t durationNanos = m_options.duration * 1000000000ll;
+            traffic.push(Json::Obj({
+                {"packet-size", packetSize},
+                {"ues", started},
+                {"requested-pps", static_cast<int64_t>(started) * m_options.rate},
+                // What the generators actually sent, they skip the packets they cannot keep up with
+                {"ul-packets", ulPackets},
+                {"ul-skipped", skipped},
+                {"offered-pps", bench::PerSecond(ulPackets, durationNanos)},
+                {"dl-packets", dlPackets},
+                {"dl-pps", bench::PerSecond(dlPackets, durationNanos)},
+                {"lost", lost},
+                {"rtt-us-min", rttMin},
+                {"rtt-us-avg", tagged > 0 ? rttSum / tagged : int64_t{0}},
+                {"rtt-us-max", rttMax},
+                {"cpu-ms", PhaseCpu(m_processes)},
+            }));
+
+            if (started != m_options.ueCount || dlPackets == 0)
+            {
+                std::cerr << "e2e: traffic of " << packetSize << " byte packets is not echoed back" << std::endl;
+                ok = false;
+            }
+        }
+
+        report.put("traffic", traffic);
+        return ok;
+    }
+};
+
+} // namespace
+
+namespace bench
+{
+
+bool RunEndToEnd(const BenchOptions &options, Json &report)
+{
+    try
+    {
+        EndToEnd e2e{options.e2e};
+        return e2e.run(report);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "e2e: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+} // namespace bench
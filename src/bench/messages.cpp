@@ -0,0 +1,122 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "messages.hpp"
+
+#include <vector>
+
+#include <lib/asn/ngap_nas.hpp>
+#include <lib/asn/rrc.hpp>
+#include <lib/asn/utils.hpp>
+
+#include <asn/rrc/ASN_RRC_BCCH-DL-SCH-Message.h>
+#include <asn/rrc/ASN_RRC_PLMN-IdentityInfo.h>
+#include <asn/rrc/ASN_RRC_PLMN-IdentityInfoList.h>
+#include <asn/rrc/ASN_RRC_SIB1.h>
+#include <asn/rrc/ASN_RRC_UAC-BarringInfoSet.h>
+#include <asn/rrc/ASN_RRC_UAC-BarringInfoSetIndex.h>
+#include <asn/rrc/ASN_RRC_UAC-BarringPerCat.h>
+#include <asn/rrc/ASN_RRC_UAC-BarringPerCatList.h>
+
+namespace bench
+{
+
+NasInput RandomNasInput(Random &random, bool largeIds)
+{
+    NasInput in{};
+    in.amfUeNgapId = largeIds ? static_cast<int64_t>(random.nextUL() & 0xFFFFFFFFFFLL) : random.nextI(1, 1 << 16);
+    in.ranUeNgapId = largeIds ? static_cast<int64_t>(random.nextUI()) : random.nextI(0, 1 << 16);
+
+    // Cover both short and long length determinants
+    int length = random.nextI(0, 4) == 0 ? random.nextI(128, 2000) : random.nextI(1, 128);
+    std::vector<uint8_t> data(length);
+    for (auto &b : data)
+        b = static_cast<uint8_t>(random.nextUI(256));
+    in.nasPdu = OctetString{std::move(data)};
+
+    in.location.plmn = octet3{random.nextI(0, 0xFFFFFF)};
+    in.location.nci = static_cast<int64_t>(random.nextUL() & 0xFFFFFFFFFLL);
+    in.location.tac = octet3{random.nextI(0, 0xFFFFFF)};
+    in.location.timeStamp = octet4{random.nextUI()};
+
+    in.rrcEstablishmentCause = random.nextI(0, 10);
+    if (random.nextI(0, 2) == 0)
+    {
+        asn::ngap::fast::FiveGSTmsi tmsi{};
+        tmsi.amfSetId = random.nextI(0, 1 << 10);
+        tmsi.amfPointer = random.nextI(0, 1 << 6);
+        tmsi.tmsi = octet4{random.nextUI()};
+        in.sTmsi = tmsi;
+    }
+    return in;
+}
+
+ASN_NGAP_NGAP_PDU *BuildInitialUeMessage(const NasInput &in)
+{
+    auto *pdu = asn::ngap::NewInitialUeMessage(in.nasPdu, in.rrcEstablishmentCause, in.sTmsi);
+    asn::ngap::AddUeAssociatedIes(*pdu, std::nullopt, in.ranUeNgapId, in.location);
+    return pdu;
+}
+
+ASN_NGAP_NGAP_PDU *BuildUplinkNasTransport(const NasInput &in)
+{
+    auto *pdu = asn::ngap::NewUplinkNasTransport(in.nasPdu);
+    asn::ngap::AddUeAssociatedIes(*pdu, in.amfUeNgapId, in.ranUeNgapId, in.location);
+    return pdu;
+}
+
+ASN_NGAP_NGAP_PDU *BuildDownlinkNasTransport(const NasInput &in)
+{
+    // The user location is not an IE of this message, so only the UE NGAP IDs are added as the core does
+    auto *pdu = asn::ngap::NewDownlinkNasTransport(in.nasPdu);
+    asn::ngap::AddUeAssociatedIes(*pdu, in.amfUeNgapId, in.ranUeNgapId, in.location);
+    return pdu;
+}
+
+/* Same content as the SIB1 broadcast by GnbRrcTask, with no access barring */
+ASN_RRC_BCCH_DL_SCH_Message *BuildSib1Message(int tac, int64_t nci, const Plmn &plmn)
+{
+    auto *pdu = asn::New<ASN_RRC_BCCH_DL_SCH_Message>();
+    pdu->message.present = ASN_RRC_BCCH_DL_SCH_MessageType_PR_c1;
+    pdu->message.choice.c1 = asn::NewFor(pdu->message.choice.c1);
+    pdu->message.choice.c1->present = ASN_RRC_BCCH_DL_SCH_MessageType__c1_PR_systemInformationBlockType1;
+    pdu->message.choice.c1->choice.systemInformationBlockType1 = asn::New<ASN_RRC_SIB1>();
+
+    auto &sib1 = *pdu->message.choice.c1->choice.systemInformationBlockType1;
+
+    auto *plmnInfo = asn::New<ASN_RRC_PLMN_IdentityInfo>();
+    plmnInfo->cellReservedForOperatorUse = ASN_RRC_PLMN_IdentityInfo__cellReservedForOperatorUse_notReserved;
+    asn::MakeNew(plmnInfo->trackingAreaCode);
+    asn::SetBitStringInt<24>(tac, *plmnInfo->trackingAreaCode);
+    asn::SetBitStringLong<36>(nci, plmnInfo->cellIdentity);
+    asn::SequenceAdd(plmnInfo->plmn_IdentityList, asn::rrc::NewPlmnId(plmn));
+    asn::SequenceAdd(sib1.cellAccessRelatedInfo.plmn_IdentityList, plmnInfo);
+
+    asn::MakeNew(sib1.uac_BarringInfo);
+
+    auto *info = asn::New<ASN_RRC_UAC_BarringInfoSet>();
+    info->uac_BarringFactor = ASN_RRC_UAC_BarringInfoSet__uac_BarringFactor_p50;
+    info->uac_BarringTime = ASN_RRC_UAC_BarringInfoSet__uac_BarringTime_s4;
+    asn::SetBitStringInt<7>(0, info->uac_BarringForAccessIdentity);
+    asn::SequenceAdd(sib1.uac_BarringInfo->uac_BarringInfoSetList, info);
+
+    asn::MakeNew(sib1.uac_BarringInfo->uac_BarringForCommon);
+
+    for (size_t i = 0; i < 63; i++)
+    {
+        auto *item = asn::New<ASN_RRC_UAC_BarringPerCat>();
+        item->accessCategory = static_cast<decltype(item->accessCategory)>(i + 1);
+        item->uac_barringInfoSetIndex = 1;
+
+        asn::SequenceAdd(*sib1.uac_BarringInfo->uac_BarringForCommon, item);
+    }
+
+    return pdu;
+}
+
+} // namespace bench
@@ -0,0 +1,46 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include <lib/asn/ngap_fast.hpp>
+#include <utils/common_types.hpp>
+#include <utils/octet_string.hpp>
+#include <utils/random.hpp>
+
+extern "C"
+{
+    struct ASN_NGAP_NGAP_PDU;
+    struct ASN_RRC_BCCH_DL_SCH_Message;
+}
+
+namespace bench
+{
+
+struct NasInput
+{
+    int64_t amfUeNgapId{};
+    int64_t ranUeNgapId{};
+    OctetString nasPdu{};
+    asn::ngap::fast::NrUserLocation location{};
+    int64_t rrcEstablishmentCause{};
+    std::optional<asn::ngap::fast::FiveGSTmsi> sTmsi{};
+};
+
+NasInput RandomNasInput(Random &random, bool largeIds);
+
+/* Build the messages with the asn1c builders of the gNB and the core */
+ASN_NGAP_NGAP_PDU *BuildInitialUeMessage(const NasInput &in);
+ASN_NGAP_NGAP_PDU *BuildUplinkNasTransport(const NasInput &in);
+ASN_NGAP_NGAP_PDU *BuildDownlinkNasTransport(const NasInput &in);
+ASN_RRC_BCCH_DL_SCH_Message *BuildSib1Message(int tac, int64_t nci, const Plmn &plmn);
+
+} // namespace bench
@@ -0,0 +1,339 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "bench.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <lib/nas/nas.hpp>
+#include <utils/random.hpp>
+
+namespace
+{
+
+struct Sample
+{
+    const char *name;
+    OctetString encoded;
+};
+
+OctetString RandomOctets(Random &random, int length)
+{
+    OctetString res{};
+    uint8_t *p = res.appendUninitialized(length);
+    for (int i = 0; i < length; i++)
+        p[i] = static_cast<uint8_t>(random.nextUI(256));
+    return res;
+}
+
+OctetString Encode(const nas::NasMessage &msg)
+{
+    OctetString res{};
+    nas::EncodeNasMessage(msg, res);
+    return res;
+}
+
+nas::IESNssai SNssai(int sst, int sd)
+{
+    return nas::IESNssai{octet{sst}, octet3{sd}, std::nullopt, std::nullopt};
+}
+
+OctetString BuildEstablishmentAccept(Random &random)
+{
+    nas::PduSessionEstablishmentAccept msg{};
+    msg.pduSessionId = 1;
+    msg.pti = 1;
+    msg.selectedPduSessionType = nas::IEPduSessionType{nas::EPduSessionType::IPV4};
+    msg.selectedSscMode = nas::IESscMode{nas::ESscMode::SSC_MODE_1};
+    msg.authorizedQoSRules = nas::IEQoSRules{RandomOctets(random, 9)};
+    msg.sessionAmbr = nas::IESessionAmbr{nas::EUnitForSessionAmbr::MULT_1Mbps, octet2{1000},
+                                         nas::EUnitForSessionAmbr::MULT_1Mbps, octet2{1000}};
+    msg.pduAddress = nas::IEPduAddress{nas::EPduSessionType::IPV4, RandomOctets(random, 4)};
+    msg.sNssai = SNssai(1, 0x010203);
+    msg.extendedProtocolConfigurationOptions = nas::IEExtendedProtocolConfigurationOptions{
+        nas::EConfigurationProtocol::PPP, true, RandomOctets(random, 24)};
+    msg.dnn = nas::IEDnn{OctetString::FromAscii("internet")};
+    return Encode(msg);
+}
+
+OctetString BuildDlNasTransport(Random &random, OctetString &&payload)
+{
+    nas::DlNasTransport msg{};
+    msg.payloadContainerType = nas::IEPayloadContainerType{nas::EPayloadContainerType::N1_SM_INFORMATION};
+    msg.payloadContainer = nas::IEPayloadContainer{std::move(payload)};
+    msg.pduSessionId = nas::IEPduSessionIdentity2{1};
+    msg.additionalInformation = nas::IEAdditionalInformation{RandomOctets(random, 4)};
+    return Encode(msg);
+}
+
+OctetString BuildRegistrationAccept(Random &random)
+{
+    nas::RegistrationAccept msg{};
+    msg.registrationResult = nas::IE5gsRegistrationResult{nas::ESmsOverNasTransportAllowed::NOT_ALLOWED,
+                                                          nas::E5gsRegistrationResult::THREEGPP_ACCESS};
+    msg.micoIndication = nas::IEMicoIndication{nas::ERegistrationAreaAllocationIndication::NOT_ALLOCATED};
+    msg.allowedNSSAI = nas::IENssai{{SNssai(1, 0x010203), SNssai(2, 0x040506)}};
+    msg.configuredNSSAI = nas::IENssai{{SNssai(1, 0x010203), SNssai(2, 0x040506), SNssai(3, 0x070809)}};
+    msg.pduSessionStatus = nas::IEPduSessionStatus{std::bitset<16>{0b10}};
+    msg.t3512Value = nas::IEGprsTimer3{random.nextI(1, 31), nas::EGprsTimerValueUnit3::MULTIPLES_OF_1HOUR};
+    msg.t3502Value = nas::IEGprsTimer2{octet{12}};
+    return Encode(msg);
+}
+
+OctetString BuildAuthenticationRequest(Random &random)
+{
+    nas::AuthenticationRequest msg{};
+    msg.ngKSI = nas::IENasKeySetIdentifier{nas::ETypeOfSecurityContext::NATIVE_SECURITY_CONTEXT, 1};
+    msg.abba = nas::IEAbba{OctetString::FromHex("0000")};
+    msg.authParamRAND = nas::IEAuthenticationParameterRand{RandomOctets(random, 16)};
+    msg.authParamAUTN = nas::IEAuthenticationParameterAutn{RandomOctets(random, 16)};
+    return Encode(msg);
+}
+
+OctetString BuildSecured(Random &random, OctetString &&plain)
+{
+    nas::SecuredMmMessage msg{};
+    msg.epd = nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES;
+    msg.sht = nas::ESecurityHeaderType::INTEGRITY_PROTECTED_AND_CIPHERED;
+    msg.messageAuthenticationCode = octet4{random.nextUI()};
+    msg.sequenceNumber = octet{random.nextI(256)};
+    msg.plainNasMessage = std::move(plain);
+    return Encode(msg);
+}
+
+/* Messages as received by the UE. They are generated, there are no captured messages in the tree. */
+std::vector<Sample> BuildSamples(Random &random)
+{
+    std::vector<Sample> res{};
+    res.push_back({"authentication-request", BuildAuthenticationRequest(random)});
+    res.push_back({"registration-accept", BuildRegistrationAccept(random)});
+    res.push_back({"pdu-session-establishment-accept", BuildEstablishmentAccept(random)});
+    res.push_back({"dl-nas-transport", BuildDlNasTransport(random, BuildEstablishmentAccept(random))});
+    res.push_back({"dl-nas-transport-large", BuildDlNasTransport(random, RandomOctets(random, 1500))});
+    res.push_back({"secured-dl-nas-transport",
+                   BuildSecured(random, BuildDlNasTransport(random, BuildEstablishmentAccept(random)))});
+    return res;
+}
+
+bool SameBytes(const OctetView &view, const OctetString &value)
+{
+    return view.remaining() == static_cast<size_t>(value.length()) &&
+           std::memcmp(view.address(), value.data(), view.remaining()) == 0;
+}
+
+/* The IEs located by the view must cover the message without gaps, and agree with the full decoder */
+bool VerifySample(const Sample &sample)
+{
+    auto *data = sample.encoded.data();
+    auto size = static_cast<size_t>(sample.encoded.length());
+
+    auto decoded = nas::DecodeNasMessage(OctetView{sample.encoded});
+    nas::NasMessageView view{};
+    if (!view.parse(data, size))
+        return false;
+
+    if (view.isSecured())
+    {
+        auto &secured = dynamic_cast<nas::SecuredMmMessage &>(*decoded);
+        auto plain = view.plainNasMessage();
+        return view.messageAuthenticationCode() == secured.messageAuthenticationCode &&
+               view.sequenceNumber() == secured.sequenceNumber && SameBytes(plain, secured.plainNasMessage) &&
+               VerifySample(Sample{sample.name, plain.readOctetString()});
+    }
+
+    size_t expectedStart = view.epd() == nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES ? 3 : 4;
+    for (int i = 0; i < view.ieCount(); i++)
+    {
+        auto &entry = view.ieAt(i);
+        size_t ieiOctets = (entry.iei == -1 || entry.layout->halfOctetIei) ? 0 : 1;
+        if (entry.start != expectedStart + ieiOctets)
+            return false;
+        expectedStart = entry.offset + entry.length;
+    }
+    if (expectedStart != size)
+        return false;
+
+    switch (view.messageType())
+    {
+    case nas::EMessageType::AUTHENTICATION_REQUEST: {
+        auto &msg = dynamic_cast<nas::AuthenticationRequest &>(*decoded);
+        auto rand = view.decodeOptional<nas::IEAuthenticationParameterRand>(0x21);
+        return rand.has_value() && rand->value == msg.authParamRAND->value &&
+               SameBytes(view.optionalValue(0x20), msg.authParamAUTN->value) &&
+               view.decodeMandatory<nas::IENasKeySetIdentifier>(0).ksi == msg.ngKSI.ksi;
+    }
+    case nas::EMessageType::REGISTRATION_ACCEPT: {
+        auto &msg = dynamic_cast<nas::RegistrationAccept &>(*decoded);
+        auto t3512 = view.decodeOptional<nas::IEGprsTimer3>(0x5E);
+        auto mico = view.decodeOptional<nas::IEMicoIndication>(0xB);
+        return t3512.has_value() && t3512->timerValue == msg.t3512Value->timerValue && mico.has_value() &&
+               view.decodeOptional<nas::IENssai>(0x31)->sNssais.size() == msg.configuredNSSAI->sNssais.size() &&
+               !view.hasIe(0x77);
+    }
+    case nas::EMessageType::PDU_SESSION_ESTABLISHMENT_ACCEPT: {
+        auto &msg = dynamic_cast<nas::PduSessionEstablishmentAccept &>(*decoded);
+        auto epco = view.optionalValue(0x7B);
+        epco.read(); // configuration protocol
+        return view.pduSessionId() == msg.pduSessionId && view.pti() == msg.pti &&
+               view.decodeMandatory<nas::IEPduSessionType>(0).pduSessionType ==
+                   msg.selectedPduSessionType.pduSessionType &&
+               SameBytes(view.mandatoryValue(1), msg.authorizedQoSRules.data) &&
+               SameBytes(epco, msg.extendedProtocolConfigurationOptions->options) &&
+               view.decodeOptional<nas::IEDnn>(0x25)->apn == msg.dnn->apn;
+    }
+    case nas::EMessageType::DL_NAS_TRANSPORT: {
+        auto &msg = dynamic_cast<nas::DlNasTransport &>(*decoded);
+        return SameBytes(view.mandatoryValue(1), msg.payloadContainer.data) &&
+               view.decodeOptional<nas::IEPduSessionIdentity2>(0x12)->value == msg.pduSessionId->value &&
+               !view.hasIe(0x58);
+    }
+    default:
+        return false;
+    }
+}
+
+bool Verify(const std::vector<Sample> &samples, Json &report)
+{
+    int mismatches = 0;
+    for (auto &sample : samples)
+    {
+        if (!VerifySample(sample))
+        {
+            if (mismatches == 0)
+                std::cerr << "Mismatch in " << sample.name << ": " << sample.encoded.toHexString() << std::endl;
+            mismatches++;
+        }
+    }
+
+    // The pre-sized encoder must give the same octets after the headroom
+    for (auto &sample : samples)
+    {
+        auto decoded = nas::DecodeNasMessage(OctetView{sample.encoded});
+        auto encoded = nas::EncodeNasMessage(*decoded, nas::SECURITY_HEADER_LENGTH);
+        if (!SameBytes(encoded.slice(nas::SECURITY_HEADER_LENGTH), sample.encoded))
+        {
+            if (mismatches == 0)
+                std::cerr << "Encoding mismatch in " << sample.name << std::endl;
+            mismatches++;
+        }
+    }
+
+    // Truncated messages must be rejected, not read beyond the buffer
+    int truncatedAccepted = 0;
+    for (auto &sample : samples)
+    {
+        nas::NasMessageView view{};
+        if (!view.parse(sample.encoded.data(), sample.encoded.length()) || view.isSecured())
+            continue;
+        if (view.parse(sample.encoded.data(), sample.encoded.length() - 1))
+            truncatedAccepted++;
+    }
+
+    // Every prefix must go through the decoder of the received messages without an exception. The prefixes are copied
+    // so that a read beyond them is caught by the sanitizers.
+    int truncatedThrown = 0;
+    for (auto &sample : samples)
+    {
+        for (int length = 0; length < sample.encoded.length(); length++)
+        {
+            std::vector<uint8_t> prefix(sample.encoded.data(), sample.encoded.data() + length);
+            try
+            {
+                nas::DecodeReceivedNasMessage(OctetView{prefix.data(), prefix.size()});
+            }
+            catch (const std::runtime_error &)
+            {
+                truncatedThrown++;
+            }
+        }
+    }
+
+    report.put("verified-messages", static_cast<int>(samples.size()));
+    report.put("mismatches", mismatches);
+    report.put("truncated-accepted", truncatedAccepted);
+    report.put("truncated-thrown", truncatedThrown);
+    return mismatches == 0 && truncatedAccepted == 0 && truncatedThrown == 0;
+}
+
+void Measure(const bench::BenchOptions &options, const Sample &sample, Json &report)
+{
+    auto *data = sample.encoded.data();
+    auto size = static_cast<size_t>(sample.encoded.length());
+    int64_t fullNanos, viewNanos, appendNanos, presizedNanos;
+    size_t sink = 0;
+
+    {
+        bench::Stopwatch sw{};
+        for (int i = 0; i < options.iterations; i++)
+        {
+            auto msg = nas::DecodeNasMessage(OctetView{data, size});
+            sink += msg->epd == nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES;
+        }
+        fullNanos = sw.elapsedNanos();
+    }
+    {
+        bench::Stopwatch sw{};
+        for (int i = 0; i < options.iterations; i++)
+        {
+            nas::NasMessageView view{};
+            if (view.parse(data, size))
+                sink += static_cast<size_t>(view.ieCount());
+        }
+        viewNanos = sw.elapsedNanos();
+    }
+
+    auto decoded = nas::DecodeNasMessage(OctetView{data, size});
+    {
+        bench::Stopwatch sw{};
+        for (int i = 0; i < options.iterations; i++)
+        {
+            OctetString stream{};
+            nas::EncodeNasMessage(*decoded, stream);
+            sink += static_cast<size_t>(stream.length());
+        }
+        appendNanos = sw.elapsedNanos();
+    }
+    {
+        bench::Stopwatch sw{};
+        for (int i = 0; i < options.iterations; i++)
+            sink += static_cast<size_t>(nas::EncodeNasMessage(*decoded, nas::SECURITY_HEADER_LENGTH).length());
+        presizedNanos = sw.elapsedNanos();
+    }
+
+    report.put(sample.name, Json::Obj({
+                                {"size", static_cast<int>(size)},
+                                {"full-decode-per-sec", bench::PerSecond(options.iterations, fullNanos)},
+                                {"view-parse-per-sec", bench::PerSecond(options.iterations, viewNanos)},
+                                {"append-encode-per-sec", bench::PerSecond(options.iterations, appendNanos)},
+                                {"presized-encode-per-sec", bench::PerSecond(options.iterations, presizedNanos)},
+                                {"checksum", static_cast<int64_t>(sink)},
+                            }));
+}
+
+} // namespace
+
+namespace bench
+{
+
+bool RunNasCodec(const BenchOptions &options, Json &report)
+{
+    Random random{options.seed};
+    auto samples = BuildSamples(random);
+
+    if (!Verify(samples, report))
+        return false;
+
+    for (auto &sample : samples)
+        Measure(options, sample, report);
+    return true;
+}
+
+} // namespace bench
@@ -0,0 +1,272 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "bench.hpp"
+#include "messages.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <lib/asn/ngap.hpp>
+#include <lib/asn/ngap_fast.hpp>
+#include <lib/asn/utils.hpp>
+#include <utils/random.hpp>
+
+#include <asn/ngap/ASN_NGAP_NAS-PDU.h>
+#include <asn/ngap/ASN_NGAP_NGAP-PDU.h>
+#include <asn/ngap/ASN_NGAP_ProtocolIE-ID.h>
+
+namespace fast = asn::ngap::fast;
+
+namespace
+{
+
+/* Same steps as the NGAP task: constraint check, APER encoding and copy into a new buffer */
+OctetString EncodeAsn(ASN_NGAP_NGAP_PDU *pdu)
+{
+    char errorBuffer[1024];
+    size_t len = sizeof(errorBuffer);
+
+    OctetString res{};
+    if (asn_check_constraints(&asn_DEF_ASN_NGAP_NGAP_PDU, pdu, errorBuffer, &len) == 0)
+    {
+        auto enc = asn_encode_to_new_buffer(nullptr, ATS_ALIGNED_CANONICAL_PER, &asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+        if (enc.buffer != nullptr && enc.result.encoded >= 0)
+        {
+            std::vector<uint8_t> v(enc.result.encoded);
+            std::memcpy(v.data(), enc.buffer, v.size());
+            res = OctetString{std::move(v)};
+        }
+        free(enc.buffer);
+    }
+
+    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+    return res;
+}
+
+enum class EMessage
+{
+    INITIAL_UE_MESSAGE,
+    UPLINK_NAS_TRANSPORT,
+    DOWNLINK_NAS_TRANSPORT,
+};
+
+OctetString EncodeFast(EMessage type, const bench::NasInput &in)
+{
+    std::vector<uint8_t> buffer(fast::NasTransportEncodeBound(in.nasPdu.length()));
+    size_t encoded = 0;
+    bool ok = false;
+
+    switch (type)
+    {
+    case EMessage::INITIAL_UE_MESSAGE:
+        ok = fast::EncodeInitialUeMessage(in.ranUeNgapId, in.nasPdu, in.location, in.rrcEstablishmentCause, in.sTmsi,
+                                          buffer.data(), buffer.size(), encoded);
+        break;
+    case EMessage::UPLINK_NAS_TRANSPORT:
+        ok = fast::EncodeUplinkNasTransport(in.amfUeNgapId, in.ranUeNgapId, in.nasPdu, in.location, buffer.data(),
+                                            buffer.size(), encoded);
+        break;
+    case EMessage::DOWNLINK_NAS_TRANSPORT:
+        ok = fast::EncodeDownlinkNasTransport(in.amfUeNgapId, in.ranUeNgapId, in.nasPdu, buffer.data(), buffer.size(),
+                                              encoded);
+        break;
+    }
+
+    if (!ok)
+        return {};
+    buffer.resize(encoded);
+    return OctetString{std::move(buffer)};
+}
+
+OctetString EncodeReference(EMessage type, const bench::NasInput &in)
+{
+    switch (type)
+    {
+    case EMessage::INITIAL_UE_MESSAGE:
+        return EncodeAsn(bench::BuildInitialUeMessage(in));
+    case EMessage::UPLINK_NAS_TRANSPORT:
+        return EncodeAsn(bench::BuildUplinkNasTransport(in));
+    case EMessage::DOWNLINK_NAS_TRANSPORT:
+        return EncodeAsn(bench::BuildDownlinkNasTransport(in));
+    }
+    return {};
+}
+
+const char *MessageName(EMessage type)
+{
+    switch (type)
+    {
+    case EMessage::INITIAL_UE_MESSAGE:
+        return "initial-ue-message";
+    case EMessage::UPLINK_NAS_TRANSPORT:
+        return "uplink-nas-transport";
+    case EMessage::DOWNLINK_NAS_TRANSPORT:
+        return "downlink-nas-transport";
+    }
+    return "?";
+}
+
+bool VerifyDecode(const OctetString &encoded, const bench::NasInput &in, bool hasAmfId)
+{
+    fast::NasTransportInfo info{};
+    if (!fast::DecodeNasTransport(encoded.data(), encoded.length(), info))
+        return false;
+    if (hasAmfId && info.amfUeNgapId != in.amfUeNgapId)
+        return false;
+    if (info.ranUeNgapId != in.ranUeNgapId)
+        return false;
+    if (info.nasPduLength != static_cast<size_t>(in.nasPdu.length()))
+        return false;
+    return std::memcmp(info.nasPdu, in.nasPdu.data(), info.nasPduLength) == 0;
+}
+
+/* Compares the fast codec against asn1c for randomly generated messages */
+bool Verify(const bench::BenchOptions &options, Json &report)
+{
+    Random random{options.seed};
+    int mismatches = 0;
+    int checked = 0;
+
+    for (int i = 0; i < options.iterations; i++)
+    {
+        auto in = bench::RandomNasInput(random, i % 2 == 0);
+
+        for (auto type : {EMessage::INITIAL_UE_MESSAGE, EMessage::UPLINK_NAS_TRANSPORT,
+                          EMessage::DOWNLINK_NAS_TRANSPORT})
+        {
+            auto reference = EncodeReference(type, in);
+            auto encoded = EncodeFast(type, in);
+            checked++;
+
+            bool ok = reference.length() > 0 && reference.length() == encoded.length() &&
+                      std::memcmp(reference.data(), encoded.data(), reference.length()) == 0;
+            ok = ok && VerifyDecode(reference, in, type != EMessage::INITIAL_UE_MESSAGE);
+
+            if (!ok)
+            {
+                if (mismatches == 0)
+                {
+                    std::cerr << "Mismatch in " << MessageName(type) << std::endl;
+                    std::cerr << "  asn1c: " << reference.toHexString() << std::endl;
+                    std::cerr << "  fast : " << encoded.toHexString() << std::endl;
+                }
+                mismatches++;
+            }
+        }
+    }
+
+    report.put("verified-messages", checked);
+    report.put("mismatches", mismatches);
+    return mismatches == 0;
+}
+
+void Measure(const bench::BenchOptions &options, EMessage type, Json &report)
+{
+    Random random{options.seed};
+    std::vector<bench::NasInput> inputs;
+    for (int i = 0; i < 64; i++)
+        inputs.push_back(bench::RandomNasInput(random, false));
+
+    int64_t asnEncodeNanos, fastEncodeNanos, asnDecodeNanos, fastDecodeNanos;
+    size_t sink = 0;
+
+    {
+        bench::Stopwatch sw{};
+        for (int i = 0; i < options.iterations; i++)
+            sink += EncodeReference(type, inputs[i % inputs.size()]).length();
+        asnEncodeNanos = sw.elapsedNanos();
+    }
+    {
+        bench::Stopwatch sw{};
+        for (int i = 0; i < options.iterations; i++)
+        {
+            auto &in = inputs[i % inputs.size()];
+            size_t bound = fast::NasTransportEncodeBound(in.nasPdu.length());
+            auto *buffer = new uint8_t[bound];
+            size_t encoded = 0;
+            if (type == EMessage::INITIAL_UE_MESSAGE)
+                fast::EncodeInitialUeMessage(in.ranUeNgapId, in.nasPdu, in.location, in.rrcEstablishmentCause,
+                                             in.sTmsi, buffer, bound, encoded);
+            else if (type == EMessage::UPLINK_NAS_TRANSPORT)
+                fast::EncodeUplinkNasTransport(in.amfUeNgapId, in.ranUeNgapId, in.nasPdu, in.location, buffer, bound,
+                                               encoded);
+            else
+                fast::EncodeDownlinkNasTransport(in.amfUeNgapId, in.ranUeNgapId, in.nasPdu, buffer, bound, encoded);
+            sink += encoded;
+            delete[] buffer;
+        }
+        fastEncodeNanos = sw.elapsedNanos();
+    }
+
+    std::vector<OctetString> encodedList;
+    for (auto &in : inputs)
+        encodedList.push_back(EncodeReference(type, in));
+
+    {
+        bench::Stopwatch sw{};
+        for (int i = 0; i < options.iterations; i++)
+        {
+            auto &encoded = encodedList[i % encodedList.size()];
+            auto *pdu = asn::New<ASN_NGAP_NGAP_PDU>();
+            auto res = aper_decode(nullptr, &asn_DEF_ASN_NGAP_NGAP_PDU, reinterpret_cast<void **>(&pdu),
+                                   encoded.data(), encoded.length(), 0, 0);
+            if (res.code == RC_OK)
+            {
+                auto *ptr = asn::ngap::FindProtocolIeInPdu(*pdu, asn_DEF_ASN_NGAP_NAS_PDU,
+                                                           ASN_NGAP_ProtocolIE_ID_id_NAS_PDU);
+                if (ptr != nullptr)
+                    sink += asn::GetOctetString(*reinterpret_cast<ASN_NGAP_NAS_PDU_t *>(ptr)).length();
+            }
+            asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+        }
+        asnDecodeNanos = sw.elapsedNanos();
+    }
+    {
+        bench::Stopwatch sw{};
+        for (int i = 0; i < options.iterations; i++)
+        {
+            auto &encoded = encodedList[i % encodedList.size()];
+            fast::NasTransportInfo info{};
+            if (fast::DecodeNasTransport(encoded.data(), encoded.length(), info))
+            {
+                std::vector<uint8_t> nasPdu(info.nasPdu, info.nasPdu + info.nasPduLength);
+                sink += nasPdu.size();
+            }
+        }
+        fastDecodeNanos = sw.elapsedNanos();
+    }
+
+    report.put(MessageName(type),
+               Json::Obj({
+                   {"asn1c-encode-per-sec", bench::PerSecond(options.iterations, asnEncodeNanos)},
+                   {"fast-encode-per-sec", bench::PerSecond(options.iterations, fastEncodeNanos)},
+                   {"asn1c-decode-per-sec", bench::PerSecond(options.iterations, asnDecodeNanos)},
+                   {"fast-decode-per-sec", bench::PerSecond(options.iterations, fastDecodeNanos)},
+                   {"checksum", static_cast<int64_t>(sink)},
+               }));
+}
+
+} // namespace
+
+namespace bench
+{
+
+bool RunNgapCodec(const BenchOptions &options, Json &report)
+{
+    if (!Verify(options, report))
+        return false;
+
+    Measure(options, EMessage::INITIAL_UE_MESSAGE, report);
+    Measure(options, EMessage::UPLINK_NAS_TRANSPORT, report);
+    Measure(options, EMessage::DOWNLINK_NAS_TRANSPORT, report);
+    return true;
+}
+
+} // namespace bench
@@ -0,0 +1,395 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <lib/rlc/rlc.hpp>
+
+namespace
+{
+
+constexpr int TX_MAX_SIZE = 1024 * 1024;
+constexpr int RX_MAX_SIZE = 1024 * 1024;
+
+constexpr int AM_POLL_PDU = 16;
+constexpr int AM_POLL_BYTE = 64 * 1024;
+constexpr int AM_MAX_RETX_THRESHOLD = 32;
+constexpr int T_POLL_RETRANSMIT = 45;
+constexpr int T_REASSEMBLY = 35;
+constexpr int T_STATUS_PROHIBIT = 0;
+
+// Upper bound of the simulated time per SDU, in order to detect a stalled link
+constexpr int64_t MAX_MS_PER_SDU = 100;
+
+// Each SDU starts with its index, followed by a pattern depending on the index
+constexpr int SDU_HEADER_SIZE = 4;
+
+enum class EMode
+{
+    TM,
+    UM,
+    AM,
+};
+
+const char *ModeName(EMode mode)
+{
+    switch (mode)
+    {
+    case EMode::TM:
+        return "tm";
+    case EMode::UM:
+        return "um";
+    case EMode::AM:
+        return "am";
+    }
+    return "?";
+}
+
+int DefaultSnLength(EMode mode)
+{
+    return mode == EMode::AM ? 18 : 12;
+}
+
+uint8_t PatternByte(int index, int offset)
+{
+    return static_cast<uint8_t>(index * 31 + offset);
+}
+
+int64_t MaxRssKib()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<int64_t>(usage.ru_maxrss);
+}
+
+/* One direction of the simulated radio link, with random loss and reordering */
+class Channel
+{
+    struct Pdu
+    {
+        int64_t deliverAt;
+        std::vector<uint8_t> data;
+    };
+
+    const bench::RlcBenchOptions &m_options;
+    std::mt19937_64 &m_random;
+    std::vector<Pdu> m_pdus{};
+
+  public:
+    Channel(const bench::RlcBenchOptions &options, std::mt19937_64 &random) : m_options(options), m_random(random)
+    {
+    }
+
+    void send(int64_t now, const uint8_t *data, int size)
+    {
+        if (m_options.lossPercent > 0 && static_cast<int>(m_random() % 100) < m_options.lossPercent)
+            return;
+
+        int64_t delay = 1;
+        if (m_options.reorderWindow > 0)
+            delay += static_cast<int64_t>(m_random() % (m_options.reorderWindow + 1));
+
+        m_pdus.push_back(Pdu{now + delay, std::vector<uint8_t>(data, data + size)});
+    }
+
+    void deliver(int64_t now, rlc::IRlcEntity &receiver)
+    {
+        // Move the due PDUs out first, since the receiver may not be re-entered while iterating
+        std::vector<Pdu> due{};
+        auto it = std::stable_partition(m_pdus.begin(), m_pdus.end(),
+                                        [now](const Pdu &pdu) { return pdu.deliverAt > now; });
+        std::move(it, m_pdus.end(), std::back_inserter(due));
+        m_pdus.erase(it, m_pdus.end());
+
+        for (auto &pdu : due)
+            receiver.receivePdu(pdu.data.data(), static_cast<int>(pdu.data.size()));
+    }
+
+    [[nodiscard]] bool isEmpty() const
+    {
+        return m_pdus.empty();
+    }
+};
+
+struct Endpoint : rlc::IRlcConsumer
+{
+    std::unique_ptr<rlc::IRlcEntity> entity{};
+
+    // Receiver side
+    std::vector<int64_t> latencies{};
+    int64_t deliveredBytes{};
+    int corrupted{};
+    const std::vector<int64_t> *offeredAt{};
+    const std::vector<int> *sduSizes{};
+    int64_t now{};
+
+    // Transmitter side
+    int acknowledged{};
+    int64_t acknowledgedBytes{};
+    int radioLinkFailures{};
+
+    void deliverSdu(rlc::IRlcEntity *e, uint8_t *data, int size) override
+    {
+        int index = -1;
+        if (size >= SDU_HEADER_SIZE)
+            std::memcpy(&index, data, SDU_HEADER_SIZE);
+
+        if (index < 0 || static_cast<size_t>(index) >= sduSizes->size() || (*sduSizes)[index] != size)
+        {
+            corrupted++;
+            return;
+        }
+        for (int i = SDU_HEADER_SIZE; i < size; i++)
+        {
+            if (data[i] != PatternByte(index, i))
+            {
+                corrupted++;
+                return;
+            }
+        }
+
+        latencies.push_back(now - (*offeredAt)[index]);
+        deliveredBytes += size;
+    }
+
+    void maxRetransmissionReached(rlc::IRlcEntity *e) override
+    {
+        radioLinkFailures++;
+    }
+
+    void sduSuccessfulDelivery(rlc::IRlcEntity *e, int sduId) override
+    {
+        acknowledged++;
+        acknowledgedBytes += (*sduSizes)[sduId];
+    }
+};
+
+rlc::IRlcEntity *NewEntity(EMode mode, int snLength, Endpoint &consumer)
+{
+    switch (mode)
+    {
+    case EMode::TM:
+        return rlc::NewTmEntity(&consumer, TX_MAX_SIZE);
+    case EMode::UM:
+        return rlc::NewUmEntity(&consumer, snLength, T_REASSEMBLY, TX_MAX_SIZE, RX_MAX_SIZE);
+    case EMode::AM:
+        return rlc::NewAmEntity(&consumer, snLength, TX_MAX_SIZE, RX_MAX_SIZE, AM_POLL_PDU, AM_POLL_BYTE,
+                                AM_MAX_RETX_THRESHOLD, T_POLL_RETRANSMIT, T_REASSEMBLY, T_STATUS_PROHIBIT);
+    }
+    return nullptr;
+}
+
+/* Returns the size of the data field of an AMD PDU, or 0 if it is a control PDU */
+int AmdDataSize(const uint8_t *pdu, int size, int snLength)
+{
+    if ((pdu[0] >> 7) == 0)
+        return 0;
+    int si = (pdu[0] >> 4) & 0b11;
+    int header = (snLength == 12 ? 2 : 3) + (si == 0b10 || si == 0b11 ? 2 : 0);
+    return size - header;
+}
+
+bool Run(const bench::BenchOptions &options, EMode mode, Json &report)
+{
+    auto &rlcOptions = options.rlc;
+    int snLength = rlcOptions.snLength != 0 ? rlcOptions.snLength : DefaultSnLength(mode);
+    int sduCount = options.iterations;
+
+    bool validSn = mode == EMode::TM || (mode == EMode::UM && (snLength == 6 || snLength == 12)) ||
+                   (mode == EMode::AM && (snLength == 12 || snLength == 18));
+    if (!validSn)
+    {
+        std::cerr << "RLC " << ModeName(mode) << ": invalid SN length " << snLength << std::endl;
+        return false;
+    }
+
+    std::mt19937_64 random{static_cast<uint64_t>(options.seed)};
+
+    // TM does not segment, so every transmission opportunity must fit the largest SDU
+    int opportunityMin = rlcOptions.opportunityMin;
+    int opportunityMax = rlcOptions.opportunityMax;
+    if (mode == EMode::TM)
+    {
+        opportunityMin = std::max(opportunityMin, rlcOptions.sduSizeMax);
+        opportunityMax = std::max(opportunityMax, opportunityMin);
+    }
+
+    std::vector<int> sduSizes(sduCount);
+    for (auto &size : sduSizes)
+        size = rlcOptions.sduSizeMin +
+               static_cast<int>(random() % static_cast<uint64_t>(rlcOptions.sduSizeMax - rlcOptions.sduSizeMin + 1));
+    std::vector<int64_t> offeredAt(sduCount);
+
+    Endpoint tx{}, rx{};
+    tx.sduSizes = rx.sduSizes = &sduSizes;
+    tx.offeredAt = rx.offeredAt = &offeredAt;
+    tx.entity.reset(NewEntity(mode, snLength, tx));
+    rx.entity.reset(NewEntity(mode, snLength, rx));
+
+    Channel uplink{rlcOptions, random}, downlink{rlcOptions, random};
+
+    std::vector<uint8_t> sdu(rlcOptions.sduSizeMax);
+    std::vector<uint8_t> pdu(opportunityMax);
+
+    int offered = 0;
+    int64_t offeredBytes = 0;
+    int64_t transmittedDataBytes = 0;
+    int64_t bufferHighWater = 0;
+    int64_t lastOffer = 0;
+    int64_t rssBefore = MaxRssKib();
+
+    // Without feedback, TM and UM finish once everything is sent and t-Reassembly had the chance to expire
+    auto finished = [&](int64_t now) {
+        if (static_cast<int>(rx.latencies.size()) + rx.corrupted >= sduCount)
+            return true;
+        if (mode == EMode::AM)
+            return tx.radioLinkFailures > 0;
+        rlc::RlcDataVolume volume{};
+        tx.entity->calculateDataVolume(volume);
+        return offered == sduCount && volume.transmissionSize == 0 && uplink.isEmpty() &&
+               now - lastOffer > T_REASSEMBLY * 2 + rlcOptions.reorderWindow;
+    };
+
+    bench::Stopwatch sw{};
+    int64_t now = 0;
+
+    while (!finished(now) && now < 1000 + sduCount * MAX_MS_PER_SDU)
+    {
+        now++;
+        tx.now = rx.now = now;
+        tx.entity->timerCycle(now);
+        rx.entity->timerCycle(now);
+
+        // Offer new SDUs while the transmitter has room. For AM, the SDUs are kept until they are acknowledged.
+        while (offered < sduCount)
+        {
+            int size = sduSizes[offered];
+            rlc::RlcDataVolume volume{};
+            tx.entity->calculateDataVolume(volume);
+            int64_t buffered = mode == EMode::AM ? offeredBytes - tx.acknowledgedBytes : volume.transmissionSize;
+            if (buffered + size > TX_MAX_SIZE / 2)
+                break;
+
+            std::memcpy(sdu.data(), &offered, SDU_HEADER_SIZE);
+            for (int i = SDU_HEADER_SIZE; i < size; i++)
+                sdu[i] = PatternByte(offered, i);
+
+            offeredAt[offered] = now;
+            tx.entity->receiveSdu(sdu.data(), size, offered);
+            offeredBytes += size;
+            offered++;
+            lastOffer = now;
+        }
+
+        int opportunity =
+            opportunityMin + static_cast<int>(random() % static_cast<uint64_t>(opportunityMax - opportunityMin + 1));
+
+        int written = tx.entity->createPdu(pdu.data(), opportunity);
+        if (written > 0)
+        {
+            if (mode == EMode::AM)
+                transmittedDataBytes += AmdDataSize(pdu.data(), written, snLength);
+            uplink.send(now, pdu.data(), written);
+        }
+
+        written = rx.entity->createPdu(pdu.data(), opportunity);
+        if (written > 0)
+            downlink.send(now, pdu.data(), written);
+
+        uplink.deliver(now, *rx.entity);
+        downlink.deliver(now, *tx.entity);
+
+        rlc::RlcDataVolume txVolume{}, rxVolume{};
+        tx.entity->calculateDataVolume(txVolume);
+        rx.entity->calculateDataVolume(rxVolume);
+        int64_t buffered = static_cast<int64_t>(txVolume.transmissionSize) + txVolume.retransmissionSize +
+                           rxVolume.receptionSize;
+        if (mode == EMode::AM)
+            buffered += offeredBytes - tx.acknowledgedBytes - txVolume.transmissionSize;
+        bufferHighWater = std::max(bufferHighWater, buffered);
+    }
+
+    int64_t elapsed = sw.elapsedNanos();
+    int delivered = static_cast<int>(rx.latencies.size());
+
+    std::sort(rx.latencies.begin(), rx.latencies.end());
+    auto percentile = [&rx](int p) -> int64_t {
+        if (rx.latencies.empty())
+            return 0;
+        return rx.latencies[std::min(rx.latencies.size() - 1, rx.latencies.size() * p / 100)];
+    };
+
+    int64_t retransmittedBytes = mode == EMode::AM ? std::max<int64_t>(0, transmittedDataBytes - offeredBytes) : 0;
+
+    report.put(ModeName(mode),
+               Json::Obj({
+                   {"sn-length", snLength},
+                   {"offered-sdus", offered},
+                   {"delivered-sdus", delivered},
+                   {"corrupted-sdus", rx.corrupted},
+                   {"radio-link-failures", tx.radioLinkFailures},
+                   {"simulated-ms", now},
+                   {"sdus-per-sec", bench::PerSecond(delivered, elapsed)},
+                   {"bytes-per-sec", bench::PerSecond(rx.deliveredBytes, elapsed)},
+                   {"retransmitted-bytes", retransmittedBytes},
+                   {"retransmission-permille",
+                    offeredBytes > 0 ? static_cast<int64_t>(retransmittedBytes * 1000 / offeredBytes) : int64_t{0}},
+                   {"latency-ms-p50", percentile(50)},
+                   {"latency-ms-p99", percentile(99)},
+                   {"latency-ms-max", rx.latencies.empty() ? int64_t{0} : rx.latencies.back()},
+                   {"buffer-high-water-bytes", bufferHighWater},
+                   {"max-rss-growth-kib", MaxRssKib() - rssBefore},
+               }));
+
+    if (rx.corrupted > 0)
+    {
+        std::cerr << "RLC " << ModeName(mode) << ": " << rx.corrupted << " corrupted SDUs" << std::endl;
+        return false;
+    }
+    if (mode == EMode::AM && delivered != sduCount)
+    {
+        std::cerr << "RLC am: " << sduCount - delivered << " SDUs are not delivered" << std::endl;
+        return false;
+    }
+    if (mode != EMode::AM && rlcOptions.lossPercent == 0 && rlcOptions.reorderWindow == 0 && delivered != sduCount)
+    {
+        std::cerr << "RLC " << ModeName(mode) << ": SDUs are lost on a lossless link" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace bench
+{
+
+bool RunRlc(const BenchOptions &options, Json &report)
+{
+    auto &mode = options.rlc.mode;
+    bool ok = true;
+
+    if (mode.empty() || mode == "tm")
+        ok &= Run(options, EMode::TM, report);
+    if (mode.empty() || mode == "um")
+        ok &= Run(options, EMode::UM, report);
+    if (mode.empty() || mode == "am")
+        ok &= Run(options, EMode::AM, report);
+    return ok;
+}
+
+} // namespace bench
@@ -0,0 +1,249 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "bench.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <lib/sctp/sctp.hpp>
+
+namespace
+{
+
+constexpr const char *ADDRESS = "127.0.0.1";
+constexpr uint16_t PORT = 38499;
+constexpr int MESSAGE_SIZE = 100;     // About the size of an Uplink NAS Transport
+constexpr int RECEIVE_CAPACITY = 8192;
+constexpr int WINDOW = 256;           // Messages sent but not echoed yet
+constexpr int POLL_TIMEOUT_MS = 1000;
+constexpr int64_t RUN_TIMEOUT_NANOS = 60ll * 1000 * 1000 * 1000;
+
+struct RunConfig
+{
+    int streams{}; // Outbound streams used for the messages, stream 0 is left out if there are more than one
+    bool noDelay{};
+};
+
+class EchoHandler : public sctp::ISctpHandler
+{
+  public:
+    sctp::SctpClient *peer{};
+    bool closed{};
+
+    void onAssociationSetup(int associationId, int inStreams, int outStreams) override
+    {
+    }
+
+    void onAssociationShutdown() override
+    {
+        closed = true;
+    }
+
+    void onConnectionReset() override
+    {
+        closed = true;
+    }
+
+    void onMessage(const uint8_t *buffer, size_t length, uint16_t stream) override
+    {
+        peer->send(stream, buffer, length);
+    }
+
+    void onUnhandledNotification() override
+    {
+    }
+};
+
+class CountingHandler : public sctp::ISctpHandler
+{
+  public:
+    int64_t received{};
+    int64_t malformed{};
+    bool closed{};
+
+    void onAssociationSetup(int associationId, int inStreams, int outStreams) override
+    {
+    }
+
+    void onAssociationShutdown() override
+    {
+        closed = true;
+    }
+
+    void onConnectionReset() override
+    {
+        closed = true;
+    }
+
+    void onMessage(const uint8_t *buffer, size_t length, uint16_t stream) override
+    {
+        if (length != MESSAGE_SIZE || buffer[0] != static_cast<uint8_t>(stream))
+            malformed++;
+        received++;
+    }
+
+    void onUnhandledNotification() override
+    {
+    }
+};
+
+/* Echoes every message back on its stream, until the association is closed */
+void RunEchoPeer(sctp::SctpServer *server, std::atomic<bool> *failed)
+{
+    try
+    {
+        auto peer = server->accept();
+        EchoHandler handler{};
+        handler.peer = peer.get();
+
+        std::vector<uint8_t> buffer(RECEIVE_CAPACITY);
+        while (!handler.closed)
+        {
+            if (peer->tryReceive(&handler, buffer.data(), buffer.size()) == sctp::ReceiveResult::CLOSED)
+                break;
+        }
+    }
+    catch (const sctp::SctpError &e)
+    {
+        std::cerr << "sctp: echo peer failed. " << e.what() << std::endl;
+        failed->store(true);
+    }
+}
+
+bool RunConfiguration(const bench::BenchOptions &options, const RunConfig &config, Json &result)
+{
+    sctp::SocketOptions socketOptions{};
+    socketOptions.inStreams = config.streams + 1;
+    socketOptions.outStreams = config.streams + 1;
+    socketOptions.noDelay = config.noDelay;
+
+    std::unique_ptr<sctp::SctpServer> server{};
+    std::unique_ptr<sctp::SctpClient> client{};
+    try
+    {
+        server = std::make_unique<sctp::SctpServer>(ADDRESS, PORT, sctp::PayloadProtocolId::NGAP, socketOptions);
+        client = std::make_unique<sctp::SctpClient>(sctp::PayloadProtocolId::NGAP, socketOptions);
+    }
+    catch (const sctp::SctpError &e)
+    {
+        // E.g. the kernel has no SCTP support, as in most CI containers
+        std::cerr << "sctp: socket could not be created. " << e.what() << std::endl;
+        return false;
+    }
+
+    std::atomic<bool> echoFailed{};
+    std::thread echoThread{RunEchoPeer, server.get(), &echoFailed};
+
+    int64_t total = options.iterations;
+    int64_t sent = 0;
+    CountingHandler handler{};
+    std::vector<uint8_t> message(MESSAGE_SIZE);
+    std::vector<uint8_t> buffer(RECEIVE_CAPACITY);
+    std::vector<int64_t> perStream(static_cast<size_t>(config.streams + 1));
+    bool ok = true;
+
+    bench::Stopwatch stopwatch{};
+    try
+    {
+        client->connect(ADDRESS, PORT);
+        client->setNonBlocking();
+
+        while (handler.received < total && !handler.closed)
+        {
+            // The messages go round-robin on the streams, so that each stream carries the same load
+            while (sent < total && sent - handler.received < WINDOW)
+            {
+                auto stream = static_cast<uint16_t>(config.streams > 1 ? 1 + sent % config.streams : 0);
+                message[0] = static_cast<uint8_t>(stream);
+                if (!client->trySend(stream, message.data(), message.size(), sent + 1 < total))
+                    break;
+                perStream[stream]++;
+                sent++;
+            }
+
+            pollfd pfd{client->getFd(), static_cast<short>(POLLIN | (sent < total ? POLLOUT : 0)), 0};
+            if (::poll(&pfd, 1, POLL_TIMEOUT_MS) < 0 || stopwatch.elapsedNanos() > RUN_TIMEOUT_NANOS)
+                break;
+
+            sctp::ReceiveResult receiveResult;
+            do
+                receiveResult = client->tryReceive(&handler, buffer.data(), buffer.size());
+            while (receiveResult == sctp::ReceiveResult::RECEIVED && !handler.closed);
+            if (receiveResult == sctp::ReceiveResult::CLOSED)
+                break;
+        }
+    }
+    catch (const sctp::SctpError &e)
+    {
+        std::cerr << "sctp: " << e.what() << std::endl;
+        ok = false;
+    }
+    int64_t elapsed = stopwatch.elapsedNanos();
+
+    // Also wakes the echo peer up if it is still waiting in accept()
+    client.reset();
+    ::shutdown(server->getFd(), SHUT_RDWR);
+    echoThread.join();
+
+    if (handler.received != total || handler.malformed != 0 || echoFailed.load())
+    {
+        std::cerr << "sctp: " << handler.received << " of " << total << " messages echoed back, "
+                  << handler.malformed << " malformed" << std::endl;
+        ok = false;
+    }
+
+    Json streams = Json::Arr({});
+    for (size_t i = 0; i < perStream.size(); i++)
+        if (perStream[i] != 0)
+            streams.push(Json::Obj({{"stream", static_cast<int>(i)}, {"messages", perStream[i]}}));
+
+    result = Json::Obj({
+        {"streams", config.streams},
+        {"no-delay", config.noDelay},
+        {"messages", handler.received},
+        {"echoed-per-sec", bench::PerSecond(handler.received, elapsed)},
+        {"elapsed-ms", elapsed / 1000000},
+        {"per-stream", streams},
+    });
+    return ok;
+}
+
+} // namespace
+
+namespace bench
+{
+
+bool RunSctpEcho(const BenchOptions &options, Json &report)
+{
+    const RunConfig configs[] = {{1, false}, {1, true}, {4, false}, {4, true}};
+
+    bool ok = true;
+    Json runs = Json::Arr({});
+    for (auto &config : configs)
+    {
+        Json result{};
+        ok &= RunConfiguration(options, config, result);
+        // The other configurations are not tried either if no socket could be created
+        if (result.isNull())
+            break;
+        runs.push(result);
+    }
+    report.put("message-size", MESSAGE_SIZE);
+    report.put("runs", runs);
+    return ok;
+}
+
+} // namespace bench
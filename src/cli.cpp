@@ -209,9 +209,21 @@ static bool HandleMessage(const app::CliMessage &msg, bool isOneShot)
     return false;
 }
 
+/* Receives the next message, after reassembling it if it is sent in chunks */
+static app::CliMessage ReceiveMessage(app::CliServer &server, app::CliChunkAssembler &assembler)
+{
+    while (true)
+    {
+        auto msg = server.receiveMessage();
+        if (assembler.assemble(msg))
+            return msg;
+    }
+}
+
 [[noreturn]] static void SendCommand(uint16_t port)
 {
     app::CliServer server{};
+    app::CliChunkAssembler assembler{};
 
     if (g_options.directCmd.empty())
     {
@@ -236,7 +248,7 @@ static bool HandleMessage(const app::CliMessage &msg, bool isOneShot)
             server.sendMessage(
                 app::CliMessage::Command(InetAddress{cons::CMD_SERVER_IP, port}, line, g_options.nodeName));
 
-            while (!HandleMessage(server.receiveMessage(), false))
+            while (!HandleMessage(ReceiveMessage(server, assembler), false))
             {
                 // empty
             }
@@ -248,7 +260,7 @@ static bool HandleMessage(const app::CliMessage &msg, bool isOneShot)
             app::CliMessage::Command(InetAddress{cons::CMD_SERVER_IP, port}, g_options.directCmd, g_options.nodeName));
 
         while (true)
-            HandleMessage(server.receiveMessage(), true);
+            HandleMessage(ReceiveMessage(server, assembler), true);
     }
 }
 
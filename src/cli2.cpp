@@ -1,12 +1,15 @@
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
 
 #include <lib/app/cli_base.hpp>
+#include <lib/app/node_selector.hpp>
 #include <utils/common.hpp>
 #include <utils/constants.hpp>
 #include <utils/io.hpp>
@@ -27,13 +30,19 @@ struct Options
     std::string directCmd{};
 };
 
-static uint8_t g_receiveBuffer[8192];
+static uint8_t g_receiveBuffer[65536];
 
 static void ReadOptions(int argc, char **argv, Options &output)
 {
-    opt::OptionsDescription desc{"UERANSIM",  cons::Tag, cons::DescriptionCli,
-                                 cons::Owner, "nr-cli",  {"<node-name> [option...]", "--dump"},
-                                 {},          true,      false};
+    opt::OptionsDescription desc{"UERANSIM",
+                                 cons::Tag,
+                                 cons::DescriptionCli,
+                                 cons::Owner,
+                                 "nr-cli",
+                                 {"<node-name> [option...]", "<node-selector> [option...]", "--dump"},
+                                 {},
+                                 true,
+                                 false};
 
     opt::OptionItem itemDump = {'d', "dump", "List all UE and gNBs in the environment", std::nullopt};
     opt::OptionItem itemExec = {'e', "exec", "Execute the given command directly without an interactive shell",
@@ -60,7 +69,14 @@ static void ReadOptions(int argc, char **argv, Options &output)
         }
 
         output.nodeName = opt.getPositional(0);
-        if (output.nodeName.size() < cons::MinNodeName)
+
+        std::string error{};
+        if (app::IsNodeSelector(output.nodeName) && !app::ValidateNodeSelector(output.nodeName, error))
+        {
+            opt.showError(error);
+            return;
+        }
+        if (output.nodeName.size() < cons::MinNodeName && !app::IsNodeSelector(output.nodeName))
         {
             opt.showError("Node name is too short");
             return;
@@ -116,6 +132,12 @@ static std::set<std::string> DumpNames()
     return v;
 }
 
+/* Sockets of the UE processes, which are not nodes */
+static bool IsProcessSocket(const std::string &name)
+{
+    return name.rfind(cons::CLI_PROCESS_PREFIX, 0) == 0 || name.rfind(cons::CLI_FAN_OUT_PREFIX, 0) == 0;
+}
+
 static void CleanUnusedFiles(const std::set<std::string> &nodes)
 {
     for (const auto &path : io::GetEntries(cons::CLI_SOCKET_DIR))
@@ -138,37 +160,32 @@ static void SendCommand(int fd, struct sockaddr_un *remoteAddress, const app::Cl
     }
 }
 
-static void ReceiveResponse(int fd, bool isOneShot)
+/* Returns true if the response completes the command, i.e. it is a RESULT or an ERROR */
+static bool ReceiveResponse(int fd, std::map<std::string, app::CliChunkAssembler> &assemblers, bool &isError)
 {
-    InetAddress outAddress;
+    struct sockaddr_un outAddress = {};
+    socklen_t outAddressLength = sizeof(outAddress);
 
-    auto size = recvfrom(fd, g_receiveBuffer, sizeof(g_receiveBuffer), 0,
-                         (struct sockaddr *)outAddress.getStorageAddr(), outAddress.getSockLenAddr());
+    auto size = recvfrom(fd, g_receiveBuffer, sizeof(g_receiveBuffer), 0, (struct sockaddr *)&outAddress,
+                         &outAddressLength);
 
     if (size < 0)
         throw LibError{"recvfrom failure"};
 
-    OctetView v{g_receiveBuffer, static_cast<size_t>(size)};
-    if (v.readI() != cons::Major)
-        return;
-    if (v.readI() != cons::Minor)
-        return;
-    if (v.readI() != cons::Patch)
-        return;
-
     app::CliMessage msg{};
-    msg.type = static_cast<app::CliMessage::Type>(v.readI());
-    int nodeNameLength = v.read4I();
-    msg.nodeName = v.readUtf8String(nodeNameLength);
-    int valueLength = v.read4I();
-    msg.value = v.readUtf8String(valueLength);
-    msg.clientAddr = outAddress;
+    if (!app::CliMessage::Decode(g_receiveBuffer, static_cast<size_t>(size), msg))
+        return false;
+
+    // Chunked responses are reassembled per remote socket
+    std::string remote{outAddress.sun_path, strnlen(outAddress.sun_path, sizeof(outAddress.sun_path))};
+    if (!assemblers[remote].assemble(msg))
+        return false;
 
     if (msg.type == app::CliMessage::Type::ERROR)
     {
         std::cerr << "ERROR: " << msg.value << std::endl;
-        if (isOneShot)
-            exit(1);
+        isError = true;
+        return true;
     }
 
     if (msg.type == app::CliMessage::Type::ECHO)
@@ -179,17 +196,36 @@ static void ReceiveResponse(int fd, bool isOneShot)
     if (msg.type == app::CliMessage::Type::RESULT)
     {
         std::cout << msg.value << std::endl;
-        if (isOneShot)
-            exit(0);
+        return true;
     }
+
+    return false;
+}
+
+/* Sends the command to all the remote sockets, and waits until each of them completes it. Returns true on success. */
+static bool ExecuteCommand(int fd, std::vector<sockaddr_un> &remoteAddresses, const app::CliMessage &msg)
+{
+    for (auto &remoteAddress : remoteAddresses)
+        SendCommand(fd, &remoteAddress, msg);
+
+    std::map<std::string, app::CliChunkAssembler> assemblers{};
+    bool isError = false;
+    size_t completed = 0;
+    while (completed < remoteAddresses.size())
+    {
+        if (ReceiveResponse(fd, assemblers, isError))
+            completed++;
+    }
+    return !isError;
 }
 
-static void SendCommands(const Options &opt, int fd, struct sockaddr_un *remoteAddress)
+static void SendCommands(const Options &opt, int fd, std::vector<sockaddr_un> &remoteAddresses)
 {
     if (!opt.directCmd.empty())
     {
-        SendCommand(fd, remoteAddress, app::CliMessage::Command(InetAddress{}, opt.directCmd, opt.nodeName));
-        ReceiveResponse(fd, true);
+        bool success =
+            ExecuteCommand(fd, remoteAddresses, app::CliMessage::Command(InetAddress{}, opt.directCmd, opt.nodeName));
+        exit(success ? 0 : 1);
     }
     else
     {
@@ -211,9 +247,7 @@ static void SendCommands(const Options &opt, int fd, struct sockaddr_un *remoteA
             if (line.empty())
                 continue;
 
-            SendCommand(fd, remoteAddress, app::CliMessage::Command(InetAddress{}, line, opt.nodeName));
-
-            ReceiveResponse(fd, false);
+            ExecuteCommand(fd, remoteAddresses, app::CliMessage::Command(InetAddress{}, line, opt.nodeName));
         }
     }
 }
@@ -229,7 +263,8 @@ int main(int argc, char **argv)
     if (opt.dumpNodes)
     {
         for (auto &n : nodeNames)
-            std::cout << n << "\n";
+            if (!IsProcessSocket(n))
+                std::cout << n << "\n";
         std::cout.flush();
         return 0;
     }
@@ -246,16 +281,35 @@ int main(int argc, char **argv)
         return 1;
     }
 
-    if (opt.nodeName.size() < cons::MinNodeName)
+    // A node selector is sent to all UE processes, and each one executes the command on its matching UEs
+    std::vector<std::string> remoteNames{};
+    if (app::IsNodeSelector(opt.nodeName))
     {
-        std::cerr << "ERROR: Node name is too short" << std::endl;
-        return 1;
-    }
+        for (auto &n : nodeNames)
+            if (n.rfind(cons::CLI_PROCESS_PREFIX, 0) == 0)
+                remoteNames.push_back(n);
 
-    if (!nodeNames.count(opt.nodeName))
+        if (remoteNames.empty())
+        {
+            std::cerr << "No UE process exists" << std::endl;
+            return 1;
+        }
+    }
+    else
     {
-        std::cerr << "No node exists with name: " << opt.nodeName << std::endl;
-        return 1;
+        if (opt.nodeName.size() < cons::MinNodeName)
+        {
+            std::cerr << "ERROR: Node name is too short" << std::endl;
+            return 1;
+        }
+
+        if (!nodeNames.count(opt.nodeName) || IsProcessSocket(opt.nodeName))
+        {
+            std::cerr << "No node exists with name: " << opt.nodeName << std::endl;
+            return 1;
+        }
+
+        remoteNames.push_back(opt.nodeName);
     }
 
     int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
@@ -266,7 +320,6 @@ int main(int argc, char **argv)
 
     std::string mySocketName =
         cons::CLI_SOCKET_DIR + std::string{"cli-client."} + utils::IntToHex(r.nextL()) + utils::IntToHex(r.nextL());
-    std::string remoteSocketName = cons::CLI_SOCKET_DIR + opt.nodeName;
 
     unlink(mySocketName.c_str());
 
@@ -274,15 +327,22 @@ int main(int argc, char **argv)
     myAddress.sun_family = AF_UNIX;
     strncpy(myAddress.sun_path, mySocketName.c_str(), sizeof(myAddress.sun_path) - 1);
 
-    struct sockaddr_un remoteAddress = {};
-    remoteAddress.sun_family = AF_UNIX;
-    strncpy(remoteAddress.sun_path, remoteSocketName.c_str(), sizeof(remoteAddress.sun_path) - 1);
+    std::vector<sockaddr_un> remoteAddresses{};
+    for (auto &remoteName : remoteNames)
+    {
+        std::string remoteSocketName = cons::CLI_SOCKET_DIR + remoteName;
+
+        struct sockaddr_un remoteAddress = {};
+        remoteAddress.sun_family = AF_UNIX;
+        strncpy(remoteAddress.sun_path, remoteSocketName.c_str(), sizeof(remoteAddress.sun_path) - 1);
+        remoteAddresses.push_back(remoteAddress);
+    }
 
     if (bind(fd, (struct sockaddr *)&myAddress, sizeof(myAddress)) < 0)
         throw LibError("Socket bind failure");
 
     io::RelaxPermissions(mySocketName);
 
-    SendCommands(opt, fd, &remoteAddress);
+    SendCommands(opt, fd, remoteAddresses);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,212 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <core/core.hpp>
+#include <lib/app/base_app.hpp>
+#include <lib/crypt/milenage.hpp>
+#include <utils/clock.hpp>
+#include <utils/common.hpp>
+#include <utils/constants.hpp>
+#include <utils/options.hpp>
+#include <utils/yaml_utils.hpp>
+#include <yaml-cpp/yaml.h>
+
+static nr::core::CoreConfig *g_refConfig = nullptr;
+
+static struct Options
+{
+    std::string configFile{};
+    bool virtualTime{};
+} g_options{};
+
+static void ReadUeSubnet(const std::string &cidr, nr::core::CoreConfig &config)
+{
+    auto slash = cidr.find('/');
+    if (slash == std::string::npos)
+        throw std::runtime_error("Invalid UE subnet: " + cidr);
+
+    in_addr address{};
+    int prefix = std::atoi(cidr.substr(slash + 1).c_str());
+    if (::inet_pton(AF_INET, cidr.substr(0, slash).c_str(), &address) != 1 || prefix < 8 || prefix > 30)
+        throw std::runtime_error("Invalid UE subnet: " + cidr);
+
+    uint32_t mask = ~((1u << (32 - prefix)) - 1);
+    config.ueSubnet = ntohl(address.s_addr) & mask;
+    config.ueSubnetSize = 1u << (32 - prefix);
+}
+
+static nr::core::CoreConfig *ReadConfigYaml()
+{
+    auto *result = new nr::core::CoreConfig();
+    auto config = YAML::LoadFile(g_options.configFile);
+
+    result->plmn.mcc = yaml::GetInt32(config, "mcc", 1, 999);
+    yaml::GetString(config, "mcc", 3, 3);
+    result->plmn.mnc = yaml::GetInt32(config, "mnc", 0, 999);
+    result->plmn.isLongMnc = yaml::GetString(config, "mnc", 2, 3).size() == 3;
+    result->tac = yaml::GetInt32(config, "tac", 0, 0xFFFFFF);
+
+    for (auto &nssai : yaml::GetSequence(config, "slices"))
+    {
+        SingleSlice s{};
+        s.sst = yaml::GetInt32(nssai, "sst", 0, 0xFF);
+        if (yaml::HasField(nssai, "sd"))
+            s.sd = octet3{yaml::GetInt32(nssai, "sd", 0, 0xFFFFFF)};
+        result->nssai.slices.push_back(s);
+    }
+
+    result->amfName = yaml::GetString(config, "amfName", 1, 150);
+    result->amfRegionId = yaml::GetInt32(config, "amfRegionId", 0, 0xFF);
+    result->amfSetId = yaml::GetInt32(config, "amfSetId", 0, 0x3FF);
+    result->amfPointer = yaml::GetInt32(config, "amfPointer", 0, 0x3F);
+    result->relativeCapacity = yaml::GetInt32(config, "relativeCapacity", 0, 255);
+
+    result->ngapIp = yaml::GetIp(config, "ngapIp");
+    result->ngapPort = static_cast<uint16_t>(yaml::GetInt32(config, "ngapPort", 1024, 65535));
+
+    if (yaml::HasField(config, "sctp"))
+    {
+        auto sctp = config["sctp"];
+        if (yaml::HasField(sctp, "inStreams"))
+            result->sctp.inStreams = yaml::GetInt32(sctp, "inStreams", 1, 65535);
+        if (yaml::HasField(sctp, "outStreams"))
+            result->sctp.outStreams = yaml::GetInt32(sctp, "outStreams", 1, 65535);
+        if (yaml::HasField(sctp, "noDelay"))
+            result->sctp.noDelay = yaml::GetBool(sctp, "noDelay");
+        if (yaml::HasField(sctp, "sendBufferSize"))
+            result->sctp.sendBufferSize = yaml::GetInt32(sctp, "sendBufferSize", 0, 64 * 1024 * 1024);
+        if (yaml::HasField(sctp, "receiveBufferSize"))
+            result->sctp.receiveBufferSize = yaml::GetInt32(sctp, "receiveBufferSize", 0, 64 * 1024 * 1024);
+    }
+
+    for (auto &item : yaml::GetSequence(config, "integrity"))
+    {
+        auto alg = item.as<std::string>();
+        if (alg == "IA1")
+            result->integrity.push_back(nas::ETypeOfIntegrityProtectionAlgorithm::IA1_128);
+        else if (alg == "IA2")
+            result->integrity.push_back(nas::ETypeOfIntegrityProtectionAlgorithm::IA2_128);
+        else if (alg == "IA3")
+            result->integrity.push_back(nas::ETypeOfIntegrityProtectionAlgorithm::IA3_128);
+        else
+            throw std::runtime_error("Invalid integrity algorithm: " + alg);
+    }
+    for (auto &item : yaml::GetSequence(config, "ciphering"))
+    {
+        auto alg = item.as<std::string>();
+        if (alg == "EA0")
+            result->ciphering.push_back(nas::ETypeOfCipheringAlgorithm::EA0);
+        else if (alg == "EA1")
+            result->ciphering.push_back(nas::ETypeOfCipheringAlgorithm::EA1_128);
+        else if (alg == "EA2")
+            result->ciphering.push_back(nas::ETypeOfCipheringAlgorithm::EA2_128);
+        else if (alg == "EA3")
+            result->ciphering.push_back(nas::ETypeOfCipheringAlgorithm::EA3_128);
+        else
+            throw std::runtime_error("Invalid ciphering algorithm: " + alg);
+    }
+
+    for (auto &subscriber : yaml::GetSequence(config, "subscribers"))
+    {
+        nr::core::SubscriberConfig s{};
+
+        std::string supi = yaml::GetString(subscriber, "supi");
+        if (supi.rfind("imsi-", 0) != 0 || supi.size() < 10 || supi.size() > 20 ||
+            supi.find_first_not_of("0123456789", 5) != std::string::npos)
+            throw std::runtime_error("Invalid SUPI value: " + supi);
+        s.firstSupi = supi.substr(5);
+
+        s.count = yaml::HasField(subscriber, "count") ? yaml::GetInt32(subscriber, "count", 1, 100000000) : 1;
+        s.key = OctetString::FromHex(yaml::GetString(subscriber, "key", 32, 32));
+        s.amf = OctetString::FromHex(yaml::GetString(subscriber, "amf", 4, 4));
+
+        OctetString op = OctetString::FromHex(yaml::GetString(subscriber, "op", 32, 32));
+        std::string opType = yaml::GetString(subscriber, "opType");
+        if (opType == "OP")
+            s.opC = crypto::milenage::CalculateOpC(op, s.key);
+        else if (opType == "OPC")
+            s.opC = std::move(op);
+        else
+            throw std::runtime_error("Invalid OP type: " + opType);
+
+        result->subscribers.push_back(std::move(s));
+    }
+
+    result->gtpIp = yaml::GetIp4(config, "gtpIp");
+    ReadUeSubnet(yaml::GetString(config, "ueSubnet"), *result);
+
+    yaml::AssertHasField(config, "ambr");
+    result->ambrDl = yaml::GetInt32(config["ambr"], "downlink", 1, 0xFFFF);
+    result->ambrUl = yaml::GetInt32(config["ambr"], "uplink", 1, 0xFFFF);
+
+    std::string upfMode = yaml::GetString(config, "upfMode");
+    if (upfMode == "echo")
+        result->upfMode = nr::core::EUpfMode::ECHO;
+    else if (upfMode == "sink")
+        result->upfMode = nr::core::EUpfMode::SINK;
+    else
+        throw std::runtime_error("Invalid UPF mode: " + upfMode);
+
+    if (yaml::HasField(config, "statsInterval"))
+        result->statsInterval = yaml::GetInt32(config, "statsInterval", 0, 3600);
+
+    result->name = "UERANSIM-core-" + std::to_string(result->plmn.mcc) + "-" + std::to_string(result->plmn.mnc);
+
+    return result;
+}
+
+static void ReadOptions(int argc, char **argv)
+{
+    opt::OptionsDescription desc{
+        cons::Project, cons::Tag, cons::DescriptionCore, cons::Owner, "nr-core", {"-c <config-file> [option...]"}, {},
+        false,         false};
+
+    opt::OptionItem itemConfigFile = {'c', "config", "Use specified configuration file for the mock core",
+                                      "config-file"};
+    opt::OptionItem itemVirtualTime = {std::nullopt, "virtual-time",
+                                       "Fast-forward the timers while all nodes are idle, for long-running load tests",
+                                       std::nullopt};
+    desc.items.push_back(itemConfigFile);
+    desc.items.push_back(itemVirtualTime);
+
+    opt::OptionsResult opt{argc, argv, desc, false, nullptr};
+    g_options.configFile = opt.getOption(itemConfigFile);
+    g_options.virtualTime = opt.hasFlag(itemVirtualTime);
+
+    try
+    {
+        g_refConfig = ReadConfigYaml();
+        if (g_options.virtualTime)
+            utils::EnableVirtualTime();
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    app::Initialize();
+    ReadOptions(argc, argv);
+
+    std::cout << utils::CopyrightDeclarationCore() << std::endl;
+
+    auto *core = new nr::core::CoreNetwork(g_refConfig);
+    core->start();
+
+    while (true)
+        ::pause();
+}
@@ -0,0 +1,648 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "task.hpp"
+
+#include <algorithm>
+
+#include <lib/nas/utils.hpp>
+#include <utils/octet_view.hpp>
+
+using namespace nr::gnb;
+
+// Number of SQN values skipped for each new authentication vector, the increment of SEQ with the IND bits kept zero
+static const uint64_t SQN_STEP = 32;
+static const int MAX_SYNC_FAILURES = 2;
+
+// One QoS rule matching all packets in both directions, mapped to QoS flow 1, see 24.501 9.11.4.13
+static const uint8_t DEFAULT_QOS_RULES[] = {0x01, 0x00, 0x06, 0x31, 0x31, 0x01, 0x01, 0xFF, 0x01};
+
+static bool IsCiphered(nas::ESecurityHeaderType sht)
+{
+    return sht == nas::ESecurityHeaderType::INTEGRITY_PROTECTED_AND_CIPHERED ||
+           sht == nas::ESecurityHeaderType::INTEGRITY_PROTECTED_AND_CIPHERED_WITH_NEW_SECURITY_CONTEXT;
+}
+
+/* The messages that are accepted without integrity protection, see 24.501 4.4.4.3 */
+static bool IsAllowedWithoutIntegrity(nas::EMessageType messageType)
+{
+    switch (messageType)
+    {
+    case nas::EMessageType::REGISTRATION_REQUEST:
+    case nas::EMessageType::IDENTITY_RESPONSE:
+    case nas::EMessageType::AUTHENTICATION_RESPONSE:
+    case nas::EMessageType::AUTHENTICATION_FAILURE:
+    case nas::EMessageType::SECURITY_MODE_REJECT:
+    case nas::EMessageType::DEREGISTRATION_REQUEST_UE_ORIGINATING:
+    case nas::EMessageType::SERVICE_REQUEST:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool SupportsIntegrity(const nas::IEUeSecurityCapability &caps, nas::ETypeOfIntegrityProtectionAlgorithm alg)
+{
+    switch (alg)
+    {
+    case nas::ETypeOfIntegrityProtectionAlgorithm::IA0:
+        return caps.b_5G_IA0 != 0;
+    case nas::ETypeOfIntegrityProtectionAlgorithm::IA1_128:
+        return caps.b_128_5G_IA1 != 0;
+    case nas::ETypeOfIntegrityProtectionAlgorithm::IA2_128:
+        return caps.b_128_5G_IA2 != 0;
+    case nas::ETypeOfIntegrityProtectionAlgorithm::IA3_128:
+        return caps.b_128_5G_IA3 != 0;
+    default:
+        return false;
+    }
+}
+
+static bool SupportsCiphering(const nas::IEUeSecurityCapability &caps, nas::ETypeOfCipheringAlgorithm alg)
+{
+    switch (alg)
+    {
+    case nas::ETypeOfCipheringAlgorithm::EA0:
+        return caps.b_5G_EA0 != 0;
+    case nas::ETypeOfCipheringAlgorithm::EA1_128:
+        return caps.b_128_5G_EA1 != 0;
+    case nas::ETypeOfCipheringAlgorithm::EA2_128:
+        return caps.b_128_5G_EA2 != 0;
+    case nas::ETypeOfCipheringAlgorithm::EA3_128:
+        return caps.b_128_5G_EA3 != 0;
+    default:
+        return false;
+    }
+}
+
+static std::string SupiFromSuci(const ImsiMobileIdentity &imsi)
+{
+    std::string mcc = std::to_string(imsi.plmn.mcc);
+    std::string mnc = std::to_string(imsi.plmn.mnc);
+    mcc.insert(0, 3 - std::min<size_t>(3, mcc.size()), '0');
+    mnc.insert(0, (imsi.plmn.isLongMnc ? 3 : 2) - std::min<size_t>(imsi.plmn.isLongMnc ? 3 : 2, mnc.size()), '0');
+    return mcc + mnc + imsi.schemeOutput;
+}
+
+static const nr::core::SubscriberConfig *FindSubscriber(const nr::core::CoreConfig &config, const std::string &supi)
+{
+    if (supi.empty() || !std::all_of(supi.begin(), supi.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        return nullptr;
+
+    uint64_t value = std::stoull(supi);
+    for (auto &subscriber : config.subscribers)
+    {
+        if (subscriber.firstSupi.size() != supi.size())
+            continue;
+        uint64_t first = std::stoull(subscriber.firstSupi);
+        if (value >= first && value - first < static_cast<uint64_t>(subscriber.count))
+            return &subscriber;
+    }
+    return nullptr;
+}
+
+namespace nr::core
+{
+
+void AmfTask::handleNasMessage(AmfUeContext *ue, const OctetString &nasPdu)
+{
+    auto msg = nas::DecodeNasMessage(OctetView{nasPdu});
+    if (msg == nullptr || msg->epd != nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES)
+    {
+        m_logger->err("Invalid NAS message received for UE[%s]", ue->supi.c_str());
+        return;
+    }
+
+    auto &mmMsg = dynamic_cast<nas::MmMessage &>(*msg);
+    if (mmMsg.sht == nas::ESecurityHeaderType::NOT_PROTECTED)
+    {
+        auto &plainMsg = dynamic_cast<nas::PlainMmMessage &>(mmMsg);
+        if (ue->security != nullptr && !IsAllowedWithoutIntegrity(plainMsg.messageType))
+        {
+            m_logger->warn("Unprotected NAS message ignored for UE[%s]", ue->supi.c_str());
+            return;
+        }
+        receiveMmMessage(ue, plainMsg);
+        return;
+    }
+
+    auto &securedMsg = dynamic_cast<nas::SecuredMmMessage &>(mmMsg);
+    if (ue->security != nullptr)
+    {
+        auto decoded = UnprotectNasMessage(*ue->security, securedMsg);
+        if (decoded != nullptr && decoded->epd == nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES &&
+            dynamic_cast<nas::MmMessage &>(*decoded).sht == nas::ESecurityHeaderType::NOT_PROTECTED)
+        {
+            receiveMmMessage(ue, dynamic_cast<nas::PlainMmMessage &>(*decoded));
+            return;
+        }
+    }
+
+    // The security context of a new connection is not known, the plain content of an initial message that is only
+    // integrity protected is processed as if it was not protected, and the UE is authenticated again
+    if (!IsCiphered(securedMsg.sht))
+    {
+        auto inner = nas::DecodeNasMessage(OctetView{securedMsg.plainNasMessage});
+        if (inner != nullptr && inner->epd == nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES &&
+            dynamic_cast<nas::MmMessage &>(*inner).sht == nas::ESecurityHeaderType::NOT_PROTECTED)
+        {
+            auto &plainMsg = dynamic_cast<nas::PlainMmMessage &>(*inner);
+            if (IsAllowedWithoutIntegrity(plainMsg.messageType))
+            {
+                receiveMmMessage(ue, plainMsg);
+                return;
+            }
+        }
+    }
+
+    m_logger->warn("NAS message integrity check failed for UE[%s]", ue->supi.c_str());
+}
+
+void AmfTask::receiveMmMessage(AmfUeContext *ue, const nas::PlainMmMessage &msg)
+{
+    switch (msg.messageType)
+    {
+    case nas::EMessageType::REGISTRATION_REQUEST:
+        receiveRegistrationRequest(ue, dynamic_cast<const nas::RegistrationRequest &>(msg));
+        break;
+    case nas::EMessageType::IDENTITY_RESPONSE:
+        receiveIdentityResponse(ue, dynamic_cast<const nas::IdentityResponse &>(msg));
+        break;
+    case nas::EMessageType::AUTHENTICATION_RESPONSE:
+        receiveAuthenticationResponse(ue, dynamic_cast<const nas::AuthenticationResponse &>(msg));
+        break;
+    case nas::EMessageType::AUTHENTICATION_FAILURE:
+        receiveAuthenticationFailure(ue, dynamic_cast<const nas::AuthenticationFailure &>(msg));
+        break;
+    case nas::EMessageType::SECURITY_MODE_COMPLETE:
+        receiveSecurityModeComplete(ue, dynamic_cast<const nas::SecurityModeComplete &>(msg));
+        break;
+    case nas::EMessageType::SECURITY_MODE_REJECT:
+        receiveSecurityModeReject(ue, dynamic_cast<const nas::SecurityModeReject &>(msg));
+        break;
+    case nas::EMessageType::REGISTRATION_COMPLETE:
+        receiveRegistrationComplete(ue);
+        break;
+    case nas::EMessageType::DEREGISTRATION_REQUEST_UE_ORIGINATING:
+        receiveDeregistrationRequest(ue, dynamic_cast<const nas::DeRegistrationRequestUeOriginating &>(msg));
+        break;
+    case nas::EMessageType::SERVICE_REQUEST:
+        receiveServiceRequest(ue, dynamic_cast<const nas::ServiceRequest &>(msg));
+        break;
+    case nas::EMessageType::UL_NAS_TRANSPORT:
+        receiveUlNasTransport(ue, dynamic_cast<const nas::UlNasTransport &>(msg));
+        break;
+    case nas::EMessageType::FIVEG_MM_STATUS:
+        m_logger->warn("5GMM Status received for UE[%s] [%s]", ue->supi.c_str(),
+                       nas::utils::EnumToString(dynamic_cast<const nas::FiveGMmStatus &>(msg).mmCause.value));
+        break;
+    default:
+        m_logger->warn("Unhandled NAS message received for UE[%s] (%d)", ue->supi.c_str(),
+                       static_cast<int>(msg.messageType));
+        break;
+    }
+}
+
+OctetString AmfTask::encodeNasMessage(AmfUeContext *ue, const nas::PlainMmMessage &msg)
+{
+    if (ue->security == nullptr)
+        return nas::EncodeNasMessage(msg, 0);
+    return ProtectNasMessage(*ue->security, msg, nas::ESecurityHeaderType::INTEGRITY_PROTECTED_AND_CIPHERED);
+}
+
+OctetString AmfTask::encodeSmMessage(AmfUeContext *ue, const nas::SmMessage &msg)
+{
+    nas::DlNasTransport transport;
+    transport.payloadContainerType.payloadContainerType = nas::EPayloadContainerType::N1_SM_INFORMATION;
+    transport.payloadContainer.data = nas::EncodeNasMessage(msg, 0);
+    transport.pduSessionId = nas::IEPduSessionIdentity2{static_cast<uint8_t>(msg.pduSessionId)};
+    return encodeNasMessage(ue, transport);
+}
+
+void AmfTask::sendNasMessage(AmfUeContext *ue, const nas::PlainMmMessage &msg)
+{
+    sendDownlinkNasTransport(ue, encodeNasMessage(ue, msg));
+}
+
+bool AmfTask::identifySubscriber(AmfUeContext *ue, const nas::IE5gsMobileIdentity &identity)
+{
+    std::string supi{};
+
+    if (identity.type == nas::EIdentityType::SUCI && identity.supiFormat == nas::ESupiFormat::IMSI)
+    {
+        if (identity.imsi.protectionSchemaId != static_cast<int>(nas::EProtectionSchemeIdentifier::NULL_SCHEME))
+        {
+            m_logger->err("SUCI with a protection scheme other than the null scheme received");
+            sendRegistrationReject(ue, nas::EMmCause::UE_IDENTITY_CANNOT_BE_DERIVED_FROM_NETWORK);
+            return false;
+        }
+        supi = SupiFromSuci(identity.imsi);
+    }
+    else if (identity.type == nas::EIdentityType::GUTI || identity.type == nas::EIdentityType::TMSI)
+    {
+        auto it = m_tmsis.find(static_cast<uint32_t>(identity.gutiOrTmsi.tmsi));
+        if (it == m_tmsis.end())
+        {
+            // The 5G-GUTI was not assigned by this AMF, or it is forgotten after a restart
+            ue->state = EAmfUeState::IDENTIFICATION;
+            nas::IdentityRequest req;
+            req.identityType.value = nas::EIdentityType::SUCI;
+            sendNasMessage(ue, req);
+            return false;
+        }
+        ue->tmsi = it->first;
+        supi = it->second;
+    }
+
+    auto *subscriber = FindSubscriber(*m_base->config, supi);
+    if (subscriber == nullptr)
+    {
+        m_logger->err("Unknown subscriber [%s]", supi.c_str());
+        sendRegistrationReject(ue, nas::EMmCause::ILLEGAL_UE);
+        return false;
+    }
+
+    ue->supi = supi;
+    ue->subscriber = subscriber;
+
+    // The older contexts of the same subscriber are stale, e.g. when the UE lost its connection without a release
+    for (auto &item : m_ueContexts)
+    {
+        auto *other = item.second.get();
+        if (other != ue && other->supi == supi && other->state != EAmfUeState::RELEASING)
+        {
+            std::vector<int> sessions{};
+            for (auto &session : other->sessions)
+                sessions.push_back(session.first);
+            for (int psi : sessions)
+                releaseSession(other, psi);
+            sendContextReleaseCommand(other, NgapCause::RadioNetwork_unspecified);
+        }
+    }
+
+    return true;
+}
+
+void AmfTask::receiveRegistrationRequest(AmfUeContext *ue, const nas::RegistrationRequest &msg)
+{
+    if (!msg.ueSecurityCapability.has_value())
+    {
+        m_logger->err("Registration Request without UE security capability received");
+        sendRegistrationReject(ue, nas::EMmCause::SEMANTICALLY_INCORRECT_MESSAGE);
+        return;
+    }
+
+    // Each registration starts from the authentication, the previous security context is not used anymore
+    ue->ueSecurityCapability = msg.ueSecurityCapability;
+    ue->ueKsi = msg.nasKeySetIdentifier.ksi;
+    ue->ueNonCurrentKsi = msg.nonCurrentNgKsi.has_value() ? msg.nonCurrentNgKsi->ksi
+                                                          : nas::IENasKeySetIdentifier::NOT_AVAILABLE_OR_RESERVED;
+    ue->security = nullptr;
+    ue->syncFailures = 0;
+
+    if (!identifySubscriber(ue, msg.mobileIdentity))
+        return;
+
+    auto it = m_sqns.find(ue->supi);
+    sendAuthenticationRequest(ue, (it == m_sqns.end() ? 0 : it->second) + SQN_STEP);
+}
+
+void AmfTask::receiveIdentityResponse(AmfUeContext *ue, const nas::IdentityResponse &msg)
+{
+    if (ue->state != EAmfUeState::IDENTIFICATION)
+        return;
+
+    if (msg.mobileIdentity.type != nas::EIdentityType::SUCI)
+    {
+        sendRegistrationReject(ue, nas::EMmCause::UE_IDENTITY_CANNOT_BE_DERIVED_FROM_NETWORK);
+        return;
+    }
+
+    if (!identifySubscriber(ue, msg.mobileIdentity))
+        return;
+
+    auto it = m_sqns.find(ue->supi);
+    sendAuthenticationRequest(ue, (it == m_sqns.end() ? 0 : it->second) + SQN_STEP);
+}
+
+void AmfTask::sendAuthenticationRequest(AmfUeContext *ue, uint64_t sqn)
+{
+    m_sqns[ue->supi] = sqn;
+
+    OctetString rand{};
+    for (int i = 0; i < 4; i++)
+        rand.append(OctetString::FromOctet4(m_random.nextUI()));
+    OctetString abba = OctetString::FromSpare(2);
+
+    ue->authVector = GenerateAuthVector(*ue->subscriber, ue->supi, m_base->config->plmn, rand, sqn, abba);
+
+    // The new ngKSI must differ from the ones the UE has
+    ue->authKsi = 0;
+    while (ue->authKsi == ue->ueKsi || ue->authKsi == ue->ueNonCurrentKsi)
+        ue->authKsi++;
+
+    ue->state = EAmfUeState::AUTHENTICATION;
+
+    nas::AuthenticationRequest req;
+    req.ngKSI = nas::IENasKeySetIdentifier{nas::ETypeOfSecurityContext::NATIVE_SECURITY_CONTEXT, ue->authKsi};
+    req.abba = nas::IEAbba{std::move(abba)};
+    req.authParamRAND = nas::IEAuthenticationParameterRand{ue->authVector.rand.copy()};
+    req.authParamAUTN = nas::IEAuthenticationParameterAutn{ue->authVector.autn.copy()};
+    sendNasMessage(ue, req);
+}
+
+void AmfTask::sendAuthenticationReject(AmfUeContext *ue)
+{
+    m_logger->err("Authentication failed for UE[%s]", ue->supi.c_str());
+
+    nas::AuthenticationReject reject;
+    sendNasMessage(ue, reject);
+    sendContextReleaseCommand(ue, NgapCause::Nas_normal_release);
+}
+
+void AmfTask::receiveAuthenticationResponse(AmfUeContext *ue, const nas::AuthenticationResponse &msg)
+{
+    if (ue->state != EAmfUeState::AUTHENTICATION)
+        return;
+
+    if (!msg.authenticationResponseParameter.has_value() ||
+        msg.authenticationResponseParameter->rawData != ue->authVector.xresStar)
+    {
+        sendAuthenticationReject(ue);
+        return;
+    }
+
+    auto &caps = *ue->ueSecurityCapability;
+    auto *config = m_base->config;
+
+    auto integrity = std::find_if(config->integrity.begin(), config->integrity.end(),
+                                  [&caps](auto alg) { return SupportsIntegrity(caps, alg); });
+    auto ciphering = std::find_if(config->ciphering.begin(), config->ciphering.end(),
+                                  [&caps](auto alg) { return SupportsCiphering(caps, alg); });
+    if (integrity == config->integrity.end() || ciphering == config->ciphering.end())
+    {
+        m_logger->err("No common NAS security algorithm with UE[%s]", ue->supi.c_str());
+        sendRegistrationReject(ue, nas::EMmCause::UE_SECURITY_CAP_MISMATCH);
+        return;
+    }
+
+    ue->security = std::make_unique<AmfSecurityContext>();
+    ue->security->ngKsi = ue->authKsi;
+    ue->security->kAmf = ue->authVector.kAmf.copy();
+    ue->security->integrity = *integrity;
+    ue->security->ciphering = *ciphering;
+    DeriveNasKeys(*ue->security);
+
+    sendSecurityModeCommand(ue);
+}
+
+void AmfTask::receiveAuthenticationFailure(AmfUeContext *ue, const nas::AuthenticationFailure &msg)
+{
+    if (ue->state != EAmfUeState::AUTHENTICATION)
+        return;
+
+    if (msg.mmCause.value == nas::EMmCause::SYNCH_FAILURE && msg.authenticationFailureParameter.has_value() &&
+        ue->syncFailures < MAX_SYNC_FAILURES)
+    {
+        uint64_t sqnMs;
+        if (RecoverSqnMs(*ue->subscriber, ue->authVector.rand, msg.authenticationFailureParameter->rawData, sqnMs))
+        {
+            // The sequence number is resynchronised to the one of the USIM, see 33.102 6.3.5
+            ue->syncFailures++;
+            sendAuthenticationRequest(ue, sqnMs + SQN_STEP);
+            return;
+        }
+    }
+
+    if (msg.mmCause.value == nas::EMmCause::NGKSI_ALREADY_IN_USE)
+    {
+        ue->ueNonCurrentKsi = ue->authKsi;
+        sendAuthenticationRequest(ue, m_sqns[ue->supi] + SQN_STEP);
+        return;
+    }
+
+    m_logger->err("Authentication Failure received for UE[%s] [%s]", ue->supi.c_str(),
+                  nas::utils::EnumToString(msg.mmCause.value));
+    sendAuthenticationReject(ue);
+}
+
+void AmfTask::sendSecurityModeCommand(AmfUeContext *ue)
+{
+    auto &security = *ue->security;
+
+    nas::SecurityModeCommand cmd;
+    cmd.selectedNasSecurityAlgorithms = nas::IENasSecurityAlgorithms{security.integrity, security.ciphering};
+    cmd.ngKsi = nas::IENasKeySetIdentifier{nas::ETypeOfSecurityContext::NATIVE_SECURITY_CONTEXT, security.ngKsi};
+    cmd.replayedUeSecurityCapabilities = *ue->ueSecurityCapability;
+    // The Registration Request is not integrity checked, so the UE sends it again in the Security Mode Complete
+    cmd.additional5gSecurityInformation = nas::IEAdditional5gSecurityInformation{
+        nas::EHorizontalDerivationParameter::NOT_REQUIRED, nas::ERetransmissionOfInitialNasMessageRequest::REQUESTED};
+    cmd.abba = nas::IEAbba{OctetString::FromSpare(2)};
+
+    ue->state = EAmfUeState::SECURITY_MODE;
+    sendDownlinkNasTransport(
+        ue, ProtectNasMessage(security, cmd, nas::ESecurityHeaderType::INTEGRITY_PROTECTED_WITH_NEW_SECURITY_CONTEXT));
+}
+
+void AmfTask::receiveSecurityModeComplete(AmfUeContext *ue, const nas::SecurityModeComplete &)
+{
+    if (ue->state != EAmfUeState::SECURITY_MODE)
+        return;
+
+    auto *config = m_base->config;
+
+    if (ue->tmsi != 0)
+        m_tmsis.erase(ue->tmsi);
+    ue->tmsi = m_nextTmsi++;
+    if (m_nextTmsi == 0)
+        m_nextTmsi = 1;
+    m_tmsis[ue->tmsi] = ue->supi;
+
+    nas::RegistrationAccept accept;
+    accept.registrationResult = nas::IE5gsRegistrationResult{nas::ESmsOverNasTransportAllowed::NOT_ALLOWED,
+                                                             nas::E5gsRegistrationResult::THREEGPP_ACCESS};
+    accept.mobileIdentity = nas::IE5gsMobileIdentity{};
+    accept.mobileIdentity->type = nas::EIdentityType::GUTI;
+    accept.mobileIdentity->gutiOrTmsi =
+        GutiMobileIdentity{config->plmn, static_cast<octet>(config->amfRegionId), config->amfSetId,
+                           config->amfPointer, octet4{ue->tmsi}};
+    accept.allowedNSSAI = nas::utils::NssaiFrom(config->nssai);
+    accept.taiList = nas::IE5gsTrackingAreaIdentityList{};
+    nas::utils::AddToTaiList(*accept.taiList, nas::VTrackingAreaIdentity{nas::utils::PlmnFrom(config->plmn),
+                                                                         octet3{config->tac}});
+
+    ue->state = EAmfUeState::REGISTRATION;
+    sendInitialContextSetupRequest(ue, encodeNasMessage(ue, accept));
+}
+
+void AmfTask::receiveSecurityModeReject(AmfUeContext *ue, const nas::SecurityModeReject &msg)
+{
+    m_logger->err("Security Mode Reject received for UE[%s] [%s]", ue->supi.c_str(),
+                  nas::utils::EnumToString(msg.mmCause.value));
+
+    ue->security = nullptr;
+    sendContextReleaseCommand(ue, NgapCause::Nas_normal_release);
+}
+
+void AmfTask::receiveRegistrationComplete(AmfUeContext *ue)
+{
+    if (ue->state != EAmfUeState::REGISTRATION)
+        return;
+
+    ue->state = EAmfUeState::REGISTERED;
+    m_logger->info("UE[%s] registered (AMF-UE-NGAP-ID: %ld)", ue->supi.c_str(), static_cast<long>(ue->amfUeNgapId));
+}
+
+void AmfTask::sendRegistrationReject(AmfUeContext *ue, nas::EMmCause cause)
+{
+    m_logger->err("Rejecting the registration of UE[%s] [%s]", ue->supi.c_str(), nas::utils::EnumToString(cause));
+
+    nas::RegistrationReject reject;
+    reject.mmCause.value = cause;
+    sendNasMessage(ue, reject);
+    sendContextReleaseCommand(ue, NgapCause::Nas_normal_release);
+}
+
+void AmfTask::receiveDeregistrationRequest(AmfUeContext *ue, const nas::DeRegistrationRequestUeOriginating &msg)
+{
+    m_logger->info("UE[%s] deregistered", ue->supi.c_str());
+
+    if (msg.deRegistrationType.switchOff == nas::ESwitchOff::NORMAL_DE_REGISTRATION)
+    {
+        nas::DeRegistrationAcceptUeOriginating accept;
+        sendNasMessage(ue, accept);
+    }
+
+    if (ue->tmsi != 0)
+        m_tmsis.erase(ue->tmsi);
+    ue->tmsi = 0;
+
+    sendContextReleaseCommand(ue, NgapCause::Nas_deregister);
+}
+
+void AmfTask::receiveServiceRequest(AmfUeContext *ue, const nas::ServiceRequest &)
+{
+    // The security context of the idle UEs is not kept, so the UE is made to register again on the same connection
+    ue->state = EAmfUeState::IDENTIFICATION;
+    ue->security = nullptr;
+
+    nas::ServiceReject reject;
+    reject.mmCause.value = nas::EMmCause::UE_IDENTITY_CANNOT_BE_DERIVED_FROM_NETWORK;
+    sendNasMessage(ue, reject);
+}
+
+void AmfTask::receiveUlNasTransport(AmfUeContext *ue, const nas::UlNasTransport &msg)
+{
+    if (ue->state != EAmfUeState::REGISTERED)
+        return;
+
+    if (msg.payloadContainerType.payloadContainerType != nas::EPayloadContainerType::N1_SM_INFORMATION)
+    {
+        m_logger->warn("Unhandled UL NAS Transport payload received for UE[%s]", ue->supi.c_str());
+        return;
+    }
+
+    auto smMsg = nas::DecodeNasMessage(OctetView{msg.payloadContainer.data});
+    if (smMsg == nullptr || smMsg->epd != nas::EExtendedProtocolDiscriminator::SESSION_MANAGEMENT_MESSAGES)
+    {
+        m_logger->err("Invalid 5GSM message received for UE[%s]", ue->supi.c_str());
+        return;
+    }
+
+    auto &sm = dynamic_cast<nas::SmMessage &>(*smMsg);
+    switch (sm.messageType)
+    {
+    case nas::EMessageType::PDU_SESSION_ESTABLISHMENT_REQUEST:
+        receiveSessionEstablishmentRequest(ue, dynamic_cast<nas::PduSessionEstablishmentRequest &>(sm), msg);
+        break;
+    case nas::EMessageType::PDU_SESSION_RELEASE_REQUEST:
+        receiveSessionReleaseRequest(ue, dynamic_cast<nas::PduSessionReleaseRequest &>(sm));
+        break;
+    case nas::EMessageType::PDU_SESSION_RELEASE_COMPLETE:
+        break;
+    default:
+        m_logger->warn("Unhandled 5GSM message received for UE[%s] (%d)", ue->supi.c_str(),
+                       static_cast<int>(sm.messageType));
+        break;
+    }
+}
+
+void AmfTask::receiveSessionEstablishmentRequest(AmfUeContext *ue, const nas::PduSessionEstablishmentRequest &msg,
+                                                 const nas::UlNasTransport &transport)
+{
+    auto *config = m_base->config;
+
+    auto reject = [this, ue, &msg](nas::ESmCause cause) {
+        m_logger->err("Rejecting PDU session establishment for UE[%s] [%s]", ue->supi.c_str(),
+                      nas::utils::EnumToString(cause));
+
+        nas::PduSessionEstablishmentReject resp;
+        resp.pduSessionId = msg.pduSessionId;
+        resp.pti = msg.pti;
+        resp.smCause.value = cause;
+        sendDownlinkNasTransport(ue, encodeSmMessage(ue, resp));
+    };
+
+    if (msg.pduSessionType.has_value() && msg.pduSessionType->pduSessionType != nas::EPduSessionType::IPV4 &&
+        msg.pduSessionType->pduSessionType != nas::EPduSessionType::IPV4V6)
+    {
+        reject(nas::ESmCause::UNKNOWN_PDU_SESSION_TYPE);
+        return;
+    }
+
+    // A new session with the same identity replaces the existing one
+    releaseSession(ue, msg.pduSessionId);
+
+    AmfPduSession session{};
+    session.psi = msg.pduSessionId;
+    if (!allocateAddress(session.ueAddress))
+    {
+        reject(nas::ESmCause::INSUFFICIENT_RESOURCES);
+        return;
+    }
+    session.ulTeid = m_nextTeid++;
+    if (m_nextTeid == 0)
+        m_nextTeid = 1;
+    ue->sessions[session.psi] = session;
+
+    nas::IESNssai slice = transport.sNssai.has_value() ? nas::utils::DeepCopyIe(*transport.sNssai)
+                          : config->nssai.slices.empty() ? nas::IESNssai{}
+                                                         : nas::utils::SNssaiFrom(config->nssai.slices[0]);
+
+    nas::PduSessionEstablishmentAccept accept;
+    accept.pduSessionId = msg.pduSessionId;
+    accept.pti = msg.pti;
+    accept.selectedPduSessionType = nas::IEPduSessionType{nas::EPduSessionType::IPV4};
+    accept.selectedSscMode = nas::IESscMode{nas::ESscMode::SSC_MODE_1};
+    accept.authorizedQoSRules =
+        nas::IEQoSRules{OctetString::FromArray(DEFAULT_QOS_RULES, sizeof(DEFAULT_QOS_RULES))};
+    accept.sessionAmbr = nas::IESessionAmbr{nas::EUnitForSessionAmbr::MULT_1Mbps, octet2{config->ambrDl},
+                                            nas::EUnitForSessionAmbr::MULT_1Mbps, octet2{config->ambrUl}};
+    accept.pduAddress = nas::IEPduAddress{nas::EPduSessionType::IPV4, OctetString::FromOctet4(session.ueAddress)};
+    accept.sNssai = nas::utils::DeepCopyIe(slice);
+    if (transport.dnn.has_value())
+        accept.dnn = nas::utils::DeepCopyIe(*transport.dnn);
+
+    m_logger->debug("PDU session established for UE[%s] (PSI: %d, UL TEID: %u)", ue->supi.c_str(), session.psi,
+                    session.ulTeid);
+
+    sendSessionResourceSetupRequest(ue, session, slice, encodeSmMessage(ue, accept));
+}
+
+void AmfTask::receiveSessionReleaseRequest(AmfUeContext *ue, const nas::PduSessionReleaseRequest &msg)
+{
+    releaseSession(ue, msg.pduSessionId);
+
+    nas::PduSessionReleaseCommand cmd;
+    cmd.pduSessionId = msg.pduSessionId;
+    cmd.pti = msg.pti;
+    cmd.smCause.value = nas::ESmCause::REGULAR_DEACTIVATION;
+    sendSessionResourceReleaseCommand(ue, msg.pduSessionId, encodeSmMessage(ue, cmd));
+}
+
+} // namespace nr::core
@@ -0,0 +1,630 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "task.hpp"
+
+#include <core/upf/task.hpp>
+#include <gnb/ngap/encode.hpp>
+#include <gnb/ngap/utils.hpp>
+#include <lib/asn/ngap.hpp>
+#include <lib/asn/ngap_fast.hpp>
+#include <lib/asn/ngap_nas.hpp>
+#include <lib/asn/utils.hpp>
+#include <utils/common.hpp>
+
+#include <asn/ngap/ASN_NGAP_AllowedNSSAI-Item.h>
+#include <asn/ngap/ASN_NGAP_AMF-UE-NGAP-ID.h>
+#include <asn/ngap/ASN_NGAP_ErrorIndication.h>
+#include <asn/ngap/ASN_NGAP_GTPTunnel.h>
+#include <asn/ngap/ASN_NGAP_InitialContextSetupFailure.h>
+#include <asn/ngap/ASN_NGAP_InitialContextSetupRequest.h>
+#include <asn/ngap/ASN_NGAP_InitialContextSetupResponse.h>
+#include <asn/ngap/ASN_NGAP_InitialUEMessage.h>
+#include <asn/ngap/ASN_NGAP_InitiatingMessage.h>
+#include <asn/ngap/ASN_NGAP_NGAP-PDU.h>
+#include <asn/ngap/ASN_NGAP_NGSetupRequest.h>
+#include <asn/ngap/ASN_NGAP_NGSetupResponse.h>
+#include <asn/ngap/ASN_NGAP_NonDynamic5QIDescriptor.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceFailedToSetupItemSURes.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceReleaseCommand.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceReleaseCommandTransfer.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceReleaseResponse.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceSetupItemSUReq.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceSetupItemSURes.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceSetupRequest.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceSetupRequestTransfer.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceSetupResponse.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceSetupResponseTransfer.h>
+#include <asn/ngap/ASN_NGAP_PDUSessionResourceToReleaseItemRelCmd.h>
+#include <asn/ngap/ASN_NGAP_PLMNSupportItem.h>
+#include <asn/ngap/ASN_NGAP_ProcedureCode.h>
+#include <asn/ngap/ASN_NGAP_ProtocolIE-Field.h>
+#include <asn/ngap/ASN_NGAP_QosFlowSetupRequestItem.h>
+#include <asn/ngap/ASN_NGAP_RAN-UE-NGAP-ID.h>
+#include <asn/ngap/ASN_NGAP_ServedGUAMIItem.h>
+#include <asn/ngap/ASN_NGAP_SliceSupportItem.h>
+#include <asn/ngap/ASN_NGAP_SuccessfulOutcome.h>
+#include <asn/ngap/ASN_NGAP_UE-NGAP-ID-pair.h>
+#include <asn/ngap/ASN_NGAP_UE-NGAP-IDs.h>
+#include <asn/ngap/ASN_NGAP_UEContextReleaseCommand.h>
+#include <asn/ngap/ASN_NGAP_UEContextReleaseComplete.h>
+#include <asn/ngap/ASN_NGAP_UEContextReleaseRequest.h>
+#include <asn/ngap/ASN_NGAP_UnsuccessfulOutcome.h>
+#include <asn/ngap/ASN_NGAP_UplinkNASTransport.h>
+
+using namespace nr::gnb;
+
+static const int QOS_FLOW_ID = 1;
+static const int FIVE_QI = 9;
+static const int ARP_PRIORITY_LEVEL = 8;
+
+static void FillGuami(const nr::core::CoreConfig &config, ASN_NGAP_GUAMI &guami)
+{
+    ngap_utils::ToPlmnAsn_Ref(config.plmn, guami.pLMNIdentity);
+    asn::SetBitStringInt<8>(config.amfRegionId, guami.aMFRegionID);
+    asn::SetBitStringInt<10>(config.amfSetId, guami.aMFSetID);
+    asn::SetBitStringInt<6>(config.amfPointer, guami.aMFPointer);
+}
+
+static void FillSNssai(const SingleSlice &slice, ASN_NGAP_S_NSSAI &target)
+{
+    asn::SetOctetString1(target.sST, static_cast<uint8_t>(slice.sst));
+    if (slice.sd.has_value())
+    {
+        target.sD = asn::New<ASN_NGAP_SD_t>();
+        asn::SetOctetString3(*target.sD, *slice.sd);
+    }
+}
+
+static OctetString EncodeSetupRequestTransfer(const nr::core::CoreConfig &config, uint32_t ulTeid)
+{
+    auto *transfer = asn::New<ASN_NGAP_PDUSessionResourceSetupRequestTransfer>();
+
+    auto *ieAmbr = asn::New<ASN_NGAP_PDUSessionResourceSetupRequestTransferIEs>();
+    ieAmbr->id = ASN_NGAP_ProtocolIE_ID_id_PDUSessionAggregateMaximumBitRate;
+    ieAmbr->criticality = ASN_NGAP_Criticality_reject;
+    ieAmbr->value.present =
+        ASN_NGAP_PDUSessionResourceSetupRequestTransferIEs__value_PR_PDUSessionAggregateMaximumBitRate;
+    auto &ambr = ieAmbr->value.choice.PDUSessionAggregateMaximumBitRate;
+    asn::SetUnsigned64(static_cast<uint64_t>(config.ambrDl) * 1000000ull, ambr.pDUSessionAggregateMaximumBitRateDL);
+    asn::SetUnsigned64(static_cast<uint64_t>(config.ambrUl) * 1000000ull, ambr.pDUSessionAggregateMaximumBitRateUL);
+    ASN_SEQUENCE_ADD(&transfer->protocolIEs.list, ieAmbr);
+
+    auto *ieTunnel = asn::New<ASN_NGAP_PDUSessionResourceSetupRequestTransferIEs>();
+    ieTunnel->id = ASN_NGAP_ProtocolIE_ID_id_UL_NGU_UP_TNLInformation;
+    ieTunnel->criticality = ASN_NGAP_Criticality_reject;
+    ieTunnel->value.present = ASN_NGAP_PDUSessionResourceSetupRequestTransferIEs__value_PR_UPTransportLayerInformation;
+    auto &upInfo = ieTunnel->value.choice.UPTransportLayerInformation;
+    upInfo.present = ASN_NGAP_UPTransportLayerInformation_PR_gTPTunnel;
+    upInfo.choice.gTPTunnel = asn::New<ASN_NGAP_GTPTunnel>();
+    asn::SetBitString(upInfo.choice.gTPTunnel->transportLayerAddress, utils::IpToOctetString(config.gtpIp));
+    asn::SetOctetString4(upInfo.choice.gTPTunnel->gTP_TEID, octet4{ulTeid});
+    ASN_SEQUENCE_ADD(&transfer->protocolIEs.list, ieTunnel);
+
+    auto *ieType = asn::New<ASN_NGAP_PDUSessionResourceSetupRequestTransferIEs>();
+    ieType->id = ASN_NGAP_ProtocolIE_ID_id_PDUSessionType;
+    ieType->criticality = ASN_NGAP_Criticality_reject;
+    ieType->value.present = ASN_NGAP_PDUSessionResourceSetupRequestTransferIEs__value_PR_PDUSessionType;
+    ieType->value.choice.PDUSessionType = ASN_NGAP_PDUSessionType_ipv4;
+    ASN_SEQUENCE_ADD(&transfer->protocolIEs.list, ieType);
+
+    auto *ieQosList = asn::New<ASN_NGAP_PDUSessionResourceSetupRequestTransferIEs>();
+    ieQosList->id = ASN_NGAP_ProtocolIE_ID_id_QosFlowSetupRequestList;
+    ieQosList->criticality = ASN_NGAP_Criticality_reject;
+    ieQosList->value.present = ASN_NGAP_PDUSessionResourceSetupRequestTransferIEs__value_PR_QosFlowSetupRequestList;
+    auto *qosFlow = asn::New<ASN_NGAP_QosFlowSetupRequestItem>();
+    qosFlow->qosFlowIdentifier = QOS_FLOW_ID;
+    auto &qosParams = qosFlow->qosFlowLevelQosParameters;
+    qosParams.qosCharacteristics.present = ASN_NGAP_QosCharacteristics_PR_nonDynamic5QI;
+    qosParams.qosCharacteristics.choice.nonDynamic5QI = asn::New<ASN_NGAP_NonDynamic5QIDescriptor>();
+    qosParams.qosCharacteristics.choice.nonDynamic5QI->fiveQI = FIVE_QI;
+    qosParams.allocationAndRetentionPriority.priorityLevelARP = ARP_PRIORITY_LEVEL;
+    qosParams.allocationAndRetentionPriority.pre_emptionCapability =
+        ASN_NGAP_Pre_emptionCapability_shall_not_trigger_pre_emption;
+    qosParams.allocationAndRetentionPriority.pre_emptionVulnerability =
+        ASN_NGAP_Pre_emptionVulnerability_not_pre_emptable;
+    asn::SequenceAdd(ieQosList->value.choice.QosFlowSetupRequestList, qosFlow);
+    ASN_SEQUENCE_ADD(&transfer->protocolIEs.list, ieQosList);
+
+    OctetString encoded = ngap_encode::EncodeS(asn_DEF_ASN_NGAP_PDUSessionResourceSetupRequestTransfer, transfer);
+    asn::Free(asn_DEF_ASN_NGAP_PDUSessionResourceSetupRequestTransfer, transfer);
+    return encoded;
+}
+
+static int BitsOf(int a1, int a2, int a3)
+{
+    return ((a1 != 0) << 15) | ((a2 != 0) << 14) | ((a3 != 0) << 13);
+}
+
+namespace nr::core
+{
+
+void AmfTask::sendNgap(int associationId, uint16_t stream, ASN_NGAP_NGAP_PDU *pdu)
+{
+    ssize_t encoded;
+    uint8_t *buffer;
+    if (!ngap_encode::Encode(asn_DEF_ASN_NGAP_NGAP_PDU, pdu, encoded, buffer))
+        m_logger->err("NGAP APER encoding failed");
+    else
+        sendNgap(associationId, stream, UniqueBuffer{buffer, static_cast<size_t>(encoded)});
+
+    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+}
+
+void AmfTask::sendNgapUeAssociated(AmfUeContext *ue, ASN_NGAP_NGAP_PDU *pdu)
+{
+    asn::ngap::AddProtocolIeIfUsable(*pdu, asn_DEF_ASN_NGAP_AMF_UE_NGAP_ID, ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID,
+                                     ASN_NGAP_Criticality_reject, [ue](void *mem) {
+                                         auto &id = *reinterpret_cast<ASN_NGAP_AMF_UE_NGAP_ID_t *>(mem);
+                                         asn::SetSigned64(ue->amfUeNgapId, id);
+                                     });
+    asn::ngap::AddProtocolIeIfUsable(
+        *pdu, asn_DEF_ASN_NGAP_RAN_UE_NGAP_ID, ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID, ASN_NGAP_Criticality_reject,
+        [ue](void *mem) { *reinterpret_cast<ASN_NGAP_RAN_UE_NGAP_ID_t *>(mem) = ue->ranUeNgapId; });
+
+    sendNgap(ue->associationId, ue->stream, pdu);
+}
+
+void AmfTask::handleNgapMessage(int associationId, uint16_t stream, const uint8_t *buffer, size_t length)
+{
+    // The NAS transport messages carry almost all of the signalling, they are decoded without asn1c
+    asn::ngap::fast::NasTransportInfo info{};
+    if (asn::ngap::fast::DecodeNasTransport(buffer, length, info) && info.ranUeNgapId.has_value())
+    {
+        OctetString nasPdu = OctetString::FromArray(info.nasPdu, info.nasPduLength);
+
+        if (info.procedureCode == ASN_NGAP_ProcedureCode_id_InitialUEMessage)
+        {
+            receiveInitialUeMessage(associationId, stream, *info.ranUeNgapId, nasPdu);
+            return;
+        }
+        if (info.procedureCode == ASN_NGAP_ProcedureCode_id_UplinkNASTransport && info.amfUeNgapId.has_value())
+        {
+            auto *ue = findUeContext(*info.amfUeNgapId);
+            if (ue == nullptr || ue->associationId != associationId)
+                m_logger->warn("Uplink NAS Transport received for unknown UE (AMF-UE-NGAP-ID: %ld)",
+                               static_cast<long>(*info.amfUeNgapId));
+            else
+                handleNasMessage(ue, nasPdu);
+            return;
+        }
+    }
+
+    auto *pdu = ngap_encode::Decode<ASN_NGAP_NGAP_PDU>(asn_DEF_ASN_NGAP_NGAP_PDU, buffer, length);
+    if (pdu == nullptr)
+    {
+        m_logger->err("APER decoding failed for SCTP message (association: %d)", associationId);
+        return;
+    }
+
+    handleNgapPdu(associationId, stream, pdu);
+    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+}
+
+void AmfTask::handleNgapPdu(int associationId, uint16_t stream, ASN_NGAP_NGAP_PDU *pdu)
+{
+    if (pdu->present == ASN_NGAP_NGAP_PDU_PR_initiatingMessage)
+    {
+        auto &value = pdu->choice.initiatingMessage->value;
+        switch (value.present)
+        {
+        case ASN_NGAP_InitiatingMessage__value_PR_NGSetupRequest:
+            receiveNgSetupRequest(associationId, &value.choice.NGSetupRequest);
+            break;
+        case ASN_NGAP_InitiatingMessage__value_PR_InitialUEMessage: {
+            auto *msg = &value.choice.InitialUEMessage;
+            auto *ieRanUeNgapId = asn::ngap::GetProtocolIe(msg, ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID);
+            auto *ieNasPdu = asn::ngap::GetProtocolIe(msg, ASN_NGAP_ProtocolIE_ID_id_NAS_PDU);
+            if (ieRanUeNgapId && ieNasPdu)
+                receiveInitialUeMessage(associationId, stream, ieRanUeNgapId->RAN_UE_NGAP_ID,
+                                        asn::GetOctetString(ieNasPdu->NAS_PDU));
+            break;
+        }
+        case ASN_NGAP_InitiatingMessage__value_PR_UplinkNASTransport: {
+            auto *msg = &value.choice.UplinkNASTransport;
+            auto ids = ngap_utils::FindNgapIdPair(msg);
+            auto *ieNasPdu = asn::ngap::GetProtocolIe(msg, ASN_NGAP_ProtocolIE_ID_id_NAS_PDU);
+            auto *ue = ids.amfUeNgapId.has_value() ? findUeContext(*ids.amfUeNgapId) : nullptr;
+            if (ue != nullptr && ue->associationId == associationId && ieNasPdu)
+                handleNasMessage(ue, asn::GetOctetString(ieNasPdu->NAS_PDU));
+            break;
+        }
+        case ASN_NGAP_InitiatingMessage__value_PR_UEContextReleaseRequest:
+            receiveContextReleaseRequest(&value.choice.UEContextReleaseRequest);
+            break;
+        case ASN_NGAP_InitiatingMessage__value_PR_ErrorIndication:
+            receiveErrorIndication(associationId, &value.choice.ErrorIndication);
+            break;
+        default:
+            m_logger->warn("Unhandled NGAP initiating-message received (%d)", value.present);
+            break;
+        }
+    }
+    else if (pdu->present == ASN_NGAP_NGAP_PDU_PR_successfulOutcome)
+    {
+        auto &value = pdu->choice.successfulOutcome->value;
+        switch (value.present)
+        {
+        case ASN_NGAP_SuccessfulOutcome__value_PR_InitialContextSetupResponse:
+            receiveInitialContextSetupResponse(&value.choice.InitialContextSetupResponse);
+            break;
+        case ASN_NGAP_SuccessfulOutcome__value_PR_PDUSessionResourceSetupResponse:
+            receiveSessionResourceSetupResponse(&value.choice.PDUSessionResourceSetupResponse);
+            break;
+        case ASN_NGAP_SuccessfulOutcome__value_PR_PDUSessionResourceReleaseResponse:
+            receiveSessionResourceReleaseResponse(&value.choice.PDUSessionResourceReleaseResponse);
+            break;
+        case ASN_NGAP_SuccessfulOutcome__value_PR_UEContextReleaseComplete:
+            receiveContextReleaseComplete(&value.choice.UEContextReleaseComplete);
+            break;
+        default:
+            m_logger->warn("Unhandled NGAP successful-outcome received (%d)", value.present);
+            break;
+        }
+    }
+    else if (pdu->present == ASN_NGAP_NGAP_PDU_PR_unsuccessfulOutcome)
+    {
+        auto &value = pdu->choice.unsuccessfulOutcome->value;
+        switch (value.present)
+        {
+        case ASN_NGAP_UnsuccessfulOutcome__value_PR_InitialContextSetupFailure:
+            receiveInitialContextSetupFailure(&value.choice.InitialContextSetupFailure);
+            break;
+        default:
+            m_logger->warn("Unhandled NGAP unsuccessful-outcome received (%d)", value.present);
+            break;
+        }
+    }
+}
+
+void AmfTask::receiveNgSetupRequest(int associationId, ASN_NGAP_NGSetupRequest *msg)
+{
+    auto *config = m_base->config;
+
+    auto *ieRanNodeName = asn::ngap::GetProtocolIe(msg, ASN_NGAP_ProtocolIE_ID_id_RANNodeName);
+    m_logger->info("NG Setup Request received from [%s] (association: %d)",
+                   ieRanNodeName ? asn::GetPrintableString(ieRanNodeName->RANNodeName).c_str() : "unnamed",
+                   associationId);
+
+    auto *ieAmfName = asn::New<ASN_NGAP_NGSetupResponseIEs>();
+    ieAmfName->id = ASN_NGAP_ProtocolIE_ID_id_AMFName;
+    ieAmfName->criticality = ASN_NGAP_Criticality_reject;
+    ieAmfName->value.present = ASN_NGAP_NGSetupResponseIEs__value_PR_AMFName;
+    asn::SetPrintableString(ieAmfName->value.choice.AMFName, config->amfName);
+
+    auto *ieGuamiList = asn::New<ASN_NGAP_NGSetupResponseIEs>();
+    ieGuamiList->id = ASN_NGAP_ProtocolIE_ID_id_ServedGUAMIList;
+    ieGuamiList->criticality = ASN_NGAP_Criticality_reject;
+    ieGuamiList->value.present = ASN_NGAP_NGSetupResponseIEs__value_PR_ServedGUAMIList;
+    auto *servedGuami = asn::New<ASN_NGAP_ServedGUAMIItem>();
+    FillGuami(*config, servedGuami->gUAMI);
+    asn::SequenceAdd(ieGuamiList->value.choice.ServedGUAMIList, servedGuami);
+
+    auto *ieCapacity = asn::New<ASN_NGAP_NGSetupResponseIEs>();
+    ieCapacity->id = ASN_NGAP_ProtocolIE_ID_id_RelativeAMFCapacity;
+    ieCapacity->criticality = ASN_NGAP_Criticality_ignore;
+    ieCapacity->value.present = ASN_NGAP_NGSetupResponseIEs__value_PR_RelativeAMFCapacity;
+    ieCapacity->value.choice.RelativeAMFCapacity = config->relativeCapacity;
+
+    auto *iePlmnList = asn::New<ASN_NGAP_NGSetupResponseIEs>();
+    iePlmnList->id = ASN_NGAP_ProtocolIE_ID_id_PLMNSupportList;
+    iePlmnList->criticality = ASN_NGAP_Criticality_reject;
+    iePlmnList->value.present = ASN_NGAP_NGSetupResponseIEs__value_PR_PLMNSupportList;
+    auto *plmnSupport = asn::New<ASN_NGAP_PLMNSupportItem>();
+    ngap_utils::ToPlmnAsn_Ref(config->plmn, plmnSupport->pLMNIdentity);
+    for (auto &slice : config->nssai.slices)
+    {
+        auto *sliceSupport = asn::New<ASN_NGAP_SliceSupportItem>();
+        FillSNssai(slice, sliceSupport->s_NSSAI);
+        asn::SequenceAdd(plmnSupport->sliceSupportList, sliceSupport);
+    }
+    asn::SequenceAdd(iePlmnList->value.choice.PLMNSupportList, plmnSupport);
+
+    auto *pdu = asn::ngap::NewMessagePdu<ASN_NGAP_NGSetupResponse>({ieAmfName, ieGuamiList, ieCapacity, iePlmnList});
+    sendNgap(associationId, 0, pdu);
+}
+
+void AmfTask::receiveInitialUeMessage(int associationId, uint16_t stream, int64_t ranUeNgapId,
+                                      const OctetString &nasPdu)
+{
+    auto *association = findAssociation(associationId);
+    if (association == nullptr)
+        return;
+
+    auto ue = std::make_unique<AmfUeContext>();
+    ue->amfUeNgapId = m_nextAmfUeNgapId++;
+    ue->ranUeNgapId = ranUeNgapId;
+    ue->associationId = associationId;
+    ue->state = EAmfUeState::IDENTIFICATION;
+
+    // Stream 0 is reserved for the non-UE-associated signalling, the UEs are spread over the others
+    if (association->outStreams > 1)
+        ue->stream = static_cast<uint16_t>(1 + ue->amfUeNgapId % (association->outStreams - 1));
+    else
+        ue->stream = 0;
+
+    m_logger->debug("Initial UE Message received (RAN-UE-NGAP-ID: %ld, AMF-UE-NGAP-ID: %ld, stream: %d)",
+                    static_cast<long>(ranUeNgapId), static_cast<long>(ue->amfUeNgapId), static_cast<int>(stream));
+
+    auto *ptr = ue.get();
+    m_ueContexts[ue->amfUeNgapId] = std::move(ue);
+    handleNasMessage(ptr, nasPdu);
+}
+
+void AmfTask::receiveInitialContextSetupResponse(ASN_NGAP_InitialContextSetupResponse *msg)
+{
+    auto ids = ngap_utils::FindNgapIdPair(msg);
+    if (ids.amfUeNgapId.has_value())
+        m_logger->debug("Initial Context Setup Response received (AMF-UE-NGAP-ID: %ld)",
+                        static_cast<long>(*ids.amfUeNgapId));
+}
+
+void AmfTask::receiveInitialContextSetupFailure(ASN_NGAP_InitialContextSetupFailure *msg)
+{
+    auto ids = ngap_utils::FindNgapIdPair(msg);
+    auto *ue = ids.amfUeNgapId.has_value() ? findUeContext(*ids.amfUeNgapId) : nullptr;
+    if (ue == nullptr)
+        return;
+
+    auto *ieCause = asn::ngap::GetProtocolIe(msg, ASN_NGAP_ProtocolIE_ID_id_Cause);
+    m_logger->err("Initial Context Setup Failure received for UE[%s] (%s)", ue->supi.c_str(),
+                  ieCause ? ngap_utils::CauseToString(ieCause->Cause).c_str() : "no cause");
+
+    sendContextReleaseCommand(ue, NgapCause::RadioNetwork_unspecified);
+}
+
+void AmfTask::receiveSessionResourceSetupResponse(ASN_NGAP_PDUSessionResourceSetupResponse *msg)
+{
+    auto ids = ngap_utils::FindNgapIdPair(msg);
+    auto *ue = ids.amfUeNgapId.has_value() ? findUeContext(*ids.amfUeNgapId) : nullptr;
+    if (ue == nullptr)
+        return;
+
+    auto *ieSetupList = asn::ngap::GetProtocolIe(msg, ASN_NGAP_ProtocolIE_ID_id_PDUSessionResourceSetupListSURes);
+    if (ieSetupList)
+    {
+        asn::ForeachItem(ieSetupList->PDUSessionResourceSetupListSURes,
+                         [this, ue](ASN_NGAP_PDUSessionResourceSetupItemSURes &item) {
+                             auto it = ue->sessions.find(static_cast<int>(item.pDUSessionID));
+                             if (it == ue->sessions.end())
+                                 return;
+
+                             auto *transfer = ngap_encode::Decode<ASN_NGAP_PDUSessionResourceSetupResponseTransfer>(
+                                 asn_DEF_ASN_NGAP_PDUSessionResourceSetupResponseTransfer,
+                                 item.pDUSessionResourceSetupResponseTransfer);
+                             if (transfer == nullptr)
+                             {
+                                 m_logger->err("PDU Session Resource Setup Response Transfer decoding failed");
+                                 return;
+                             }
+
+                             auto &upInfo = transfer->dLQosFlowPerTNLInformation.uPTransportLayerInformation;
+                             if (upInfo.present == ASN_NGAP_UPTransportLayerInformation_PR_gTPTunnel)
+                             {
+                                 auto *tunnel = upInfo.choice.gTPTunnel;
+                                 auto upfMsg = std::make_unique<NmCoreAmfToUpf>(NmCoreAmfToUpf::SESSION_CREATE);
+                                 upfMsg->ulTeid = it->second.ulTeid;
+                                 upfMsg->dlTeid = static_cast<uint32_t>(asn::GetOctet4(tunnel->gTP_TEID));
+                                 upfMsg->dlAddress =
+                                     utils::OctetStringToIp(asn::GetOctetString(tunnel->transportLayerAddress));
+                                 upfMsg->qfi = QOS_FLOW_ID;
+                                 upfMsg->ueAddress = it->second.ueAddress;
+                                 m_base->upfTask->push(std::move(upfMsg));
+                             }
+
+                             asn::Free(asn_DEF_ASN_NGAP_PDUSessionResourceSetupResponseTransfer, transfer);
+                         });
+    }
+
+    auto *ieFailedList =
+        asn::ngap::GetProtocolIe(msg, ASN_NGAP_ProtocolIE_ID_id_PDUSessionResourceFailedToSetupListSURes);
+    if (ieFailedList)
+    {
+        asn::ForeachItem(ieFailedList->PDUSessionResourceFailedToSetupListSURes,
+                         [this, ue](ASN_NGAP_PDUSessionResourceFailedToSetupItemSURes &item) {
+                             int psi = static_cast<int>(item.pDUSessionID);
+                             m_logger->err("PDU session resource setup failed for UE[%s] (PSI: %d)", ue->supi.c_str(),
+                                           psi);
+                             releaseSession(ue, psi);
+                         });
+    }
+}
+
+void AmfTask::receiveSessionResourceReleaseResponse(ASN_NGAP_PDUSessionResourceReleaseResponse *msg)
+{
+    auto ids = ngap_utils::FindNgapIdPair(msg);
+    if (ids.amfUeNgapId.has_value())
+        m_logger->debug("PDU Session Resource Release Response received (AMF-UE-NGAP-ID: %ld)",
+                        static_cast<long>(*ids.amfUeNgapId));
+}
+
+void AmfTask::receiveContextReleaseRequest(ASN_NGAP_UEContextReleaseRequest *msg)
+{
+    auto ids = ngap_utils::FindNgapIdPair(msg);
+    auto *ue = ids.amfUeNgapId.has_value() ? findUeContext(*ids.amfUeNgapId) : nullptr;
+    if (ue == nullptr)
+        return;
+
+    m_logger->debug("UE Context Release Request received for UE[%s]", ue->supi.c_str());
+    sendContextReleaseCommand(ue, NgapCause::RadioNetwork_release_due_to_ngran_generated_reason);
+}
+
+void AmfTask::receiveContextReleaseComplete(ASN_NGAP_UEContextReleaseComplete *msg)
+{
+    auto ids = ngap_utils::FindNgapIdPair(msg);
+    if (!ids.amfUeNgapId.has_value())
+        return;
+
+    m_logger->debug("UE Context Release Complete received (AMF-UE-NGAP-ID: %ld)",
+                    static_cast<long>(*ids.amfUeNgapId));
+    deleteUeContext(*ids.amfUeNgapId);
+}
+
+void AmfTask::receiveErrorIndication(int associationId, ASN_NGAP_ErrorIndication *msg)
+{
+    auto *ieCause = asn::ngap::GetProtocolIe(msg, ASN_NGAP_ProtocolIE_ID_id_Cause);
+    m_logger->err("Error Indication received (association: %d, %s)", associationId,
+                  ieCause ? ngap_utils::CauseToString(ieCause->Cause).c_str() : "no cause");
+}
+
+void AmfTask::sendDownlinkNasTransport(AmfUeContext *ue, const OctetString &nasPdu)
+{
+    size_t capacity = asn::ngap::fast::NasTransportEncodeBound(static_cast<size_t>(nasPdu.length()));
+    auto *buffer = new uint8_t[capacity];
+    size_t encoded = 0;
+
+    if (asn::ngap::fast::EncodeDownlinkNasTransport(ue->amfUeNgapId, ue->ranUeNgapId, nasPdu, buffer, capacity,
+                                                    encoded))
+    {
+        sendNgap(ue->associationId, ue->stream, UniqueBuffer{buffer, encoded});
+        return;
+    }
+    delete[] buffer;
+
+    sendNgapUeAssociated(ue, asn::ngap::NewDownlinkNasTransport(nasPdu));
+}
+
+void AmfTask::sendInitialContextSetupRequest(AmfUeContext *ue, const OctetString &nasPdu)
+{
+    auto *config = m_base->config;
+
+    auto *ieAmbr = asn::New<ASN_NGAP_InitialContextSetupRequestIEs>();
+    ieAmbr->id = ASN_NGAP_ProtocolIE_ID_id_UEAggregateMaximumBitRate;
+    ieAmbr->criticality = ASN_NGAP_Criticality_reject;
+    ieAmbr->value.present = ASN_NGAP_InitialContextSetupRequestIEs__value_PR_UEAggregateMaximumBitRate;
+    asn::SetUnsigned64(static_cast<uint64_t>(config->ambrDl) * 1000000ull,
+                       ieAmbr->value.choice.UEAggregateMaximumBitRate.uEAggregateMaximumBitRateDL);
+    asn::SetUnsigned64(static_cast<uint64_t>(config->ambrUl) * 1000000ull,
+                       ieAmbr->value.choice.UEAggregateMaximumBitRate.uEAggregateMaximumBitRateUL);
+
+    auto *ieGuami = asn::New<ASN_NGAP_InitialContextSetupRequestIEs>();
+    ieGuami->id = ASN_NGAP_ProtocolIE_ID_id_GUAMI;
+    ieGuami->criticality = ASN_NGAP_Criticality_reject;
+    ieGuami->value.present = ASN_NGAP_InitialContextSetupRequestIEs__value_PR_GUAMI;
+    FillGuami(*config, ieGuami->value.choice.GUAMI);
+
+    auto *ieAllowedNssai = asn::New<ASN_NGAP_InitialContextSetupRequestIEs>();
+    ieAllowedNssai->id = ASN_NGAP_ProtocolIE_ID_id_AllowedNSSAI;
+    ieAllowedNssai->criticality = ASN_NGAP_Criticality_reject;
+    ieAllowedNssai->value.present = ASN_NGAP_InitialContextSetupRequestIEs__value_PR_AllowedNSSAI;
+    for (auto &slice : config->nssai.slices)
+    {
+        auto *item = asn::New<ASN_NGAP_AllowedNSSAI_Item>();
+        FillSNssai(slice, item->s_NSSAI);
+        asn::SequenceAdd(ieAllowedNssai->value.choice.AllowedNSSAI, item);
+    }
+
+    // The algorithms the UE supports are forwarded as they are, the first bit of each string is for algorithm 1
+    auto &caps = *ue->ueSecurityCapability;
+    auto *ieSecurityCaps = asn::New<ASN_NGAP_InitialContextSetupRequestIEs>();
+    ieSecurityCaps->id = ASN_NGAP_ProtocolIE_ID_id_UESecurityCapabilities;
+    ieSecurityCaps->criticality = ASN_NGAP_Criticality_reject;
+    ieSecurityCaps->value.present = ASN_NGAP_InitialContextSetupRequestIEs__value_PR_UESecurityCapabilities;
+    auto &asnCaps = ieSecurityCaps->value.choice.UESecurityCapabilities;
+    asn::SetBitStringInt<16>(BitsOf(caps.b_128_5G_EA1, caps.b_128_5G_EA2, caps.b_128_5G_EA3),
+                             asnCaps.nRencryptionAlgorithms);
+    asn::SetBitStringInt<16>(BitsOf(caps.b_128_5G_IA1, caps.b_128_5G_IA2, caps.b_128_5G_IA3),
+                             asnCaps.nRintegrityProtectionAlgorithms);
+    asn::SetBitStringInt<16>(BitsOf(caps.b_128_EEA1, caps.b_128_EEA2, caps.b_128_EEA3),
+                             asnCaps.eUTRAencryptionAlgorithms);
+    asn::SetBitStringInt<16>(BitsOf(caps.b_128_EIA1, caps.b_128_EIA2, caps.b_128_EIA3),
+                             asnCaps.eUTRAintegrityProtectionAlgorithms);
+
+    // K_gNB is derived with the COUNT of the Security Mode Complete, the last uplink message received
+    auto *ieSecurityKey = asn::New<ASN_NGAP_InitialContextSetupRequestIEs>();
+    ieSecurityKey->id = ASN_NGAP_ProtocolIE_ID_id_SecurityKey;
+    ieSecurityKey->criticality = ASN_NGAP_Criticality_reject;
+    ieSecurityKey->value.present = ASN_NGAP_InitialContextSetupRequestIEs__value_PR_SecurityKey;
+    asn::SetBitString(ieSecurityKey->value.choice.SecurityKey,
+                      DeriveKgnb(ue->security->kAmf, (ue->security->ulCount - 1) & 0xFFFFFF));
+
+    auto *ieNasPdu = asn::New<ASN_NGAP_InitialContextSetupRequestIEs>();
+    ieNasPdu->id = ASN_NGAP_ProtocolIE_ID_id_NAS_PDU;
+    ieNasPdu->criticality = ASN_NGAP_Criticality_ignore;
+    ieNasPdu->value.present = ASN_NGAP_InitialContextSetupRequestIEs__value_PR_NAS_PDU;
+    asn::SetOctetString(ieNasPdu->value.choice.NAS_PDU, nasPdu);
+
+    auto *pdu = asn::ngap::NewMessagePdu<ASN_NGAP_InitialContextSetupRequest>(
+        {ieAmbr, ieGuami, ieAllowedNssai, ieSecurityCaps, ieSecurityKey, ieNasPdu});
+    sendNgapUeAssociated(ue, pdu);
+}
+
+void AmfTask::sendSessionResourceSetupRequest(AmfUeContext *ue, const AmfPduSession &session,
+                                              const nas::IESNssai &slice, const OctetString &nasPdu)
+{
+    auto *ieSetupList = asn::New<ASN_NGAP_PDUSessionResourceSetupRequestIEs>();
+    ieSetupList->id = ASN_NGAP_ProtocolIE_ID_id_PDUSessionResourceSetupListSUReq;
+    ieSetupList->criticality = ASN_NGAP_Criticality_reject;
+    ieSetupList->value.present = ASN_NGAP_PDUSessionResourceSetupRequestIEs__value_PR_PDUSessionResourceSetupListSUReq;
+
+    auto *item = asn::New<ASN_NGAP_PDUSessionResourceSetupItemSUReq>();
+    item->pDUSessionID = session.psi;
+    item->pDUSessionNAS_PDU = asn::New<ASN_NGAP_NAS_PDU_t>();
+    asn::SetOctetString(*item->pDUSessionNAS_PDU, nasPdu);
+    FillSNssai(SingleSlice{slice.sst, slice.sd}, item->s_NSSAI);
+    asn::SetOctetString(item->pDUSessionResourceSetupRequestTransfer,
+                        EncodeSetupRequestTransfer(*m_base->config, session.ulTeid));
+    asn::SequenceAdd(ieSetupList->value.choice.PDUSessionResourceSetupListSUReq, item);
+
+    auto *pdu = asn::ngap::NewMessagePdu<ASN_NGAP_PDUSessionResourceSetupRequest>({ieSetupList});
+    sendNgapUeAssociated(ue, pdu);
+}
+
+void AmfTask::sendSessionResourceReleaseCommand(AmfUeContext *ue, int psi, const OctetString &nasPdu)
+{
+    auto *transfer = asn::New<ASN_NGAP_PDUSessionResourceReleaseCommandTransfer>();
+    ngap_utils::ToCauseAsn_Ref(NgapCause::Nas_normal_release, transfer->cause);
+    OctetString encodedTransfer =
+        ngap_encode::EncodeS(asn_DEF_ASN_NGAP_PDUSessionResourceReleaseCommandTransfer, transfer);
+    asn::Free(asn_DEF_ASN_NGAP_PDUSessionResourceReleaseCommandTransfer, transfer);
+
+    auto *ieNasPdu = asn::New<ASN_NGAP_PDUSessionResourceReleaseCommandIEs>();
+    ieNasPdu->id = ASN_NGAP_ProtocolIE_ID_id_NAS_PDU;
+    ieNasPdu->criticality = ASN_NGAP_Criticality_ignore;
+    ieNasPdu->value.present = ASN_NGAP_PDUSessionResourceReleaseCommandIEs__value_PR_NAS_PDU;
+    asn::SetOctetString(ieNasPdu->value.choice.NAS_PDU, nasPdu);
+
+    auto *ieReleaseList = asn::New<ASN_NGAP_PDUSessionResourceReleaseCommandIEs>();
+    ieReleaseList->id = ASN_NGAP_ProtocolIE_ID_id_PDUSessionResourceToReleaseListRelCmd;
+    ieReleaseList->criticality = ASN_NGAP_Criticality_reject;
+    ieReleaseList->value.present =
+        ASN_NGAP_PDUSessionResourceReleaseCommandIEs__value_PR_PDUSessionResourceToReleaseListRelCmd;
+    auto *item = asn::New<ASN_NGAP_PDUSessionResourceToReleaseItemRelCmd>();
+    item->pDUSessionID = psi;
+    asn::SetOctetString(item->pDUSessionResourceReleaseCommandTransfer, encodedTransfer);
+    asn::SequenceAdd(ieReleaseList->value.choice.PDUSessionResourceToReleaseListRelCmd, item);
+
+    auto *pdu = asn::ngap::NewMessagePdu<ASN_NGAP_PDUSessionResourceReleaseCommand>({ieNasPdu, ieReleaseList});
+    sendNgapUeAssociated(ue, pdu);
+}
+
+void AmfTask::sendContextReleaseCommand(AmfUeContext *ue, NgapCause cause)
+{
+    ue->state = EAmfUeState::RELEASING;
+
+    auto *ieUeNgapIds = asn::New<ASN_NGAP_UEContextReleaseCommand_IEs>();
+    ieUeNgapIds->id = ASN_NGAP_ProtocolIE_ID_id_UE_NGAP_IDs;
+    ieUeNgapIds->criticality = ASN_NGAP_Criticality_reject;
+    ieUeNgapIds->value.present = ASN_NGAP_UEContextReleaseCommand_IEs__value_PR_UE_NGAP_IDs;
+    auto &ids = ieUeNgapIds->value.choice.UE_NGAP_IDs;
+    ids.present = ASN_NGAP_UE_NGAP_IDs_PR_uE_NGAP_ID_pair;
+    ids.choice.uE_NGAP_ID_pair = asn::New<ASN_NGAP_UE_NGAP_ID_pair>();
+    asn::SetSigned64(ue->amfUeNgapId, ids.choice.uE_NGAP_ID_pair->aMF_UE_NGAP_ID);
+    ids.choice.uE_NGAP_ID_pair->rAN_UE_NGAP_ID = ue->ranUeNgapId;
+
+    auto *ieCause = asn::New<ASN_NGAP_UEContextReleaseCommand_IEs>();
+    ieCause->id = ASN_NGAP_ProtocolIE_ID_id_Cause;
+    ieCause->criticality = ASN_NGAP_Criticality_ignore;
+    ieCause->value.present = ASN_NGAP_UEContextReleaseCommand_IEs__value_PR_Cause;
+    ngap_utils::ToCauseAsn_Ref(cause, ieCause->value.choice.Cause);
+
+    auto *pdu = asn::ngap::NewMessagePdu<ASN_NGAP_UEContextReleaseCommand>({ieUeNgapIds, ieCause});
+    sendNgap(ue->associationId, ue->stream, pdu);
+}
+
+} // namespace nr::core
@@ -0,0 +1,217 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "security.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+
+#include <lib/crypt/crypt.hpp>
+#include <lib/crypt/milenage.hpp>
+#include <lib/nas/encode.hpp>
+#include <utils/octet_view.hpp>
+
+static const int N_NAS_enc_alg = 0x01;
+static const int N_NAS_int_alg = 0x02;
+
+static const int BEARER_3GPP = 1;
+static const int DIRECTION_UPLINK = 0;
+static const int DIRECTION_DOWNLINK = 1;
+
+static OctetString SqnToOctetString(uint64_t sqn)
+{
+    return OctetString::FromOctet8(sqn).subCopy(2);
+}
+
+static uint32_t ComputeMac(nas::ETypeOfIntegrityProtectionAlgorithm alg, uint32_t count, int direction,
+                           const OctetString &key, const uint8_t *sqnAndMessage, size_t length)
+{
+    switch (alg)
+    {
+    case nas::ETypeOfIntegrityProtectionAlgorithm::IA0:
+        return 0;
+    case nas::ETypeOfIntegrityProtectionAlgorithm::IA1_128:
+        return crypto::ComputeMacEia1(count, BEARER_3GPP, direction, sqnAndMessage, length, key);
+    case nas::ETypeOfIntegrityProtectionAlgorithm::IA2_128:
+        return crypto::ComputeMacEia2(count, BEARER_3GPP, direction, sqnAndMessage, length, key);
+    case nas::ETypeOfIntegrityProtectionAlgorithm::IA3_128:
+        return crypto::ComputeMacEia3(count, BEARER_3GPP, direction, sqnAndMessage, length, key);
+    default:
+        throw std::runtime_error("Bad integrity algorithm");
+    }
+}
+
+/* Ciphering and deciphering are the same operation for the stream ciphers */
+static void Cipher(nas::ETypeOfCipheringAlgorithm alg, uint32_t count, int direction, const OctetString &key,
+                   uint8_t *data, size_t length)
+{
+    switch (alg)
+    {
+    case nas::ETypeOfCipheringAlgorithm::EA0:
+        break;
+    case nas::ETypeOfCipheringAlgorithm::EA1_128:
+        crypto::EncryptEea1(count, BEARER_3GPP, direction, data, length, key);
+        break;
+    case nas::ETypeOfCipheringAlgorithm::EA2_128:
+        crypto::EncryptEea2(count, BEARER_3GPP, direction, data, length, key);
+        break;
+    case nas::ETypeOfCipheringAlgorithm::EA3_128:
+        crypto::EncryptEea3(count, BEARER_3GPP, direction, data, length, key);
+        break;
+    default:
+        throw std::runtime_error("Bad ciphering algorithm");
+    }
+}
+
+static bool IsCiphered(nas::ESecurityHeaderType sht)
+{
+    return sht == nas::ESecurityHeaderType::INTEGRITY_PROTECTED_AND_CIPHERED ||
+           sht == nas::ESecurityHeaderType::INTEGRITY_PROTECTED_AND_CIPHERED_WITH_NEW_SECURITY_CONTEXT;
+}
+
+namespace nr::core
+{
+
+std::string ServingNetworkName(const Plmn &plmn)
+{
+    char buffer[40] = {0};
+    std::snprintf(buffer, sizeof(buffer), "5G:mnc%03d.mcc%03d.3gppnetwork.org", plmn.mnc, plmn.mcc);
+    return std::string{buffer};
+}
+
+AuthVector GenerateAuthVector(const SubscriberConfig &subscriber, const std::string &supi, const Plmn &plmn,
+                              const OctetString &rand, uint64_t sqn, const OctetString &abba)
+{
+    OctetString sqnOctets = SqnToOctetString(sqn);
+    auto milenage = crypto::milenage::Calculate(subscriber.opC, subscriber.key, rand, sqnOctets, subscriber.amf);
+    OctetString sqnXorAk = OctetString::Xor(sqnOctets, milenage.ak);
+    OctetString ckIk = OctetString::Concat(milenage.ck, milenage.ik);
+    std::string snn = ServingNetworkName(plmn);
+
+    AuthVector av{};
+    av.rand = rand.copy();
+    av.autn = OctetString::Concat(OctetString::Concat(sqnXorAk, subscriber.amf), milenage.mac_a);
+
+    OctetString resParams[3];
+    resParams[0] = crypto::EncodeKdfString(snn);
+    resParams[1] = rand.copy();
+    resParams[2] = milenage.res.copy();
+    OctetString resOutput = crypto::CalculateKdfKey(ckIk, 0x6B, resParams, 3);
+    av.xresStar = resOutput.subCopy(resOutput.length() - 16);
+
+    OctetString ausfParams[2];
+    ausfParams[0] = crypto::EncodeKdfString(snn);
+    ausfParams[1] = sqnXorAk.copy();
+    OctetString kAusf = crypto::CalculateKdfKey(ckIk, 0x6A, ausfParams, 2);
+
+    OctetString seafParams[1];
+    seafParams[0] = crypto::EncodeKdfString(snn);
+    OctetString kSeaf = crypto::CalculateKdfKey(kAusf, 0x6C, seafParams, 1);
+
+    OctetString amfParams[2];
+    amfParams[0] = crypto::EncodeKdfString(supi);
+    amfParams[1] = abba.copy();
+    av.kAmf = crypto::CalculateKdfKey(kSeaf, 0x6D, amfParams, 2);
+
+    return av;
+}
+
+bool RecoverSqnMs(const SubscriberConfig &subscriber, const OctetString &rand, const OctetString &auts,
+                  uint64_t &sqnMs)
+{
+    if (auts.length() != 14)
+        return false;
+
+    // AK* does not depend on SQN, and MAC-S is computed with the dummy AMF value, see 33.102 6.3.3
+    auto milenage = crypto::milenage::Calculate(subscriber.opC, subscriber.key, rand, OctetString::FromSpare(6),
+                                                OctetString::FromSpare(2));
+    OctetString sqnOctets = OctetString::Xor(auts.subCopy(0, 6), milenage.ak_r);
+
+    milenage = crypto::milenage::Calculate(subscriber.opC, subscriber.key, rand, sqnOctets, OctetString::FromSpare(2));
+    if (milenage.mac_s != auts.subCopy(6, 8))
+        return false;
+
+    OctetString padded = OctetString::FromSpare(2);
+    padded.append(sqnOctets);
+    sqnMs = padded.get8UL(0);
+    return true;
+}
+
+void DeriveNasKeys(AmfSecurityContext &ctx)
+{
+    OctetString encParams[2];
+    encParams[0] = OctetString::FromOctet(N_NAS_enc_alg);
+    encParams[1] = OctetString::FromOctet(static_cast<int>(ctx.ciphering));
+
+    OctetString intParams[2];
+    intParams[0] = OctetString::FromOctet(N_NAS_int_alg);
+    intParams[1] = OctetString::FromOctet(static_cast<int>(ctx.integrity));
+
+    ctx.kNasEnc = crypto::CalculateKdfKey(ctx.kAmf, 0x69, encParams, 2).subCopy(16, 16);
+    ctx.kNasInt = crypto::CalculateKdfKey(ctx.kAmf, 0x69, intParams, 2).subCopy(16, 16);
+}
+
+OctetString DeriveKgnb(const OctetString &kAmf, uint32_t ulCount)
+{
+    OctetString params[2];
+    params[0] = OctetString::FromOctet4(ulCount);
+    params[1] = OctetString::FromOctet(0x01); // 3GPP access
+    return crypto::CalculateKdfKey(kAmf, 0x6E, params, 2);
+}
+
+OctetString ProtectNasMessage(AmfSecurityContext &ctx, const nas::PlainMmMessage &msg, nas::ESecurityHeaderType sht)
+{
+    uint32_t count = ctx.dlCount & 0xFFFFFF;
+
+    // The plain message is encoded after the security header, then ciphered and integrity protected in place
+    OctetString pdu = nas::EncodeNasMessage(msg, nas::SECURITY_HEADER_LENGTH);
+    uint8_t *data = pdu.data();
+    size_t length = static_cast<size_t>(pdu.length() - nas::SECURITY_HEADER_LENGTH);
+
+    if (IsCiphered(sht))
+        Cipher(ctx.ciphering, count, DIRECTION_DOWNLINK, ctx.kNasEnc, data + nas::SECURITY_HEADER_LENGTH, length);
+
+    data[0] = static_cast<uint8_t>(nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES);
+    data[1] = static_cast<uint8_t>(sht);
+    data[6] = static_cast<uint8_t>(count);
+
+    uint32_t mac = ComputeMac(ctx.integrity, count, DIRECTION_DOWNLINK, ctx.kNasInt, data + 6, length + 1);
+    data[2] = static_cast<uint8_t>(mac >> 24);
+    data[3] = static_cast<uint8_t>(mac >> 16);
+    data[4] = static_cast<uint8_t>(mac >> 8);
+    data[5] = static_cast<uint8_t>(mac);
+
+    ctx.dlCount = (ctx.dlCount + 1) & 0xFFFFFF;
+    return pdu;
+}
+
+std::unique_ptr<nas::NasMessage> UnprotectNasMessage(AmfSecurityContext &ctx, const nas::SecuredMmMessage &msg)
+{
+    // The overflow counter is estimated from the SQN, which only wraps forward
+    auto sqn = static_cast<uint32_t>(static_cast<uint8_t>(msg.sequenceNumber));
+    uint32_t count = (ctx.ulCount & 0xFFFF00) | sqn;
+    if (sqn < (ctx.ulCount & 0xFF))
+        count = (count + 0x100) & 0xFFFFFF;
+
+    OctetString data = OctetString::Concat(OctetString::FromOctet(static_cast<int>(sqn)), msg.plainNasMessage);
+    uint32_t mac = ComputeMac(ctx.integrity, count, DIRECTION_UPLINK, ctx.kNasInt, data.data(),
+                              static_cast<size_t>(data.length()));
+    if (mac != static_cast<uint32_t>(msg.messageAuthenticationCode))
+        return nullptr;
+
+    ctx.ulCount = (count + 1) & 0xFFFFFF;
+
+    if (IsCiphered(msg.sht))
+        Cipher(ctx.ciphering, count, DIRECTION_UPLINK, ctx.kNasEnc, data.data() + 1,
+               static_cast<size_t>(data.length() - 1));
+
+    OctetView view{data.data() + 1, static_cast<size_t>(data.length() - 1)};
+    return nas::DecodeNasMessage(view);
+}
+
+} // namespace nr::core
@@ -0,0 +1,66 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <core/types.hpp>
+#include <lib/nas/msg.hpp>
+#include <utils/common_types.hpp>
+#include <utils/octet_string.hpp>
+
+namespace nr::core
+{
+
+struct AuthVector
+{
+    OctetString rand{};
+    OctetString autn{};
+    OctetString xresStar{};
+    OctetString kAmf{};
+};
+
+/* NAS security context of a UE on the network side */
+struct AmfSecurityContext
+{
+    int ngKsi{};
+    OctetString kAmf{};
+    OctetString kNasInt{};
+    OctetString kNasEnc{};
+    nas::ETypeOfIntegrityProtectionAlgorithm integrity{};
+    nas::ETypeOfCipheringAlgorithm ciphering{};
+    uint32_t ulCount{}; // The next expected uplink NAS COUNT
+    uint32_t dlCount{}; // The next downlink NAS COUNT
+};
+
+std::string ServingNetworkName(const Plmn &plmn);
+
+/* Generates the 5G HE AV of a subscriber for the given RAND and SQN, and derives K_AMF from it, see 33.501 6.1.3.2 */
+AuthVector GenerateAuthVector(const SubscriberConfig &subscriber, const std::string &supi, const Plmn &plmn,
+                              const OctetString &rand, uint64_t sqn, const OctetString &abba);
+
+/* Recovers SQN_MS from the AUTS of a synchronisation failure, returns false if MAC-S does not match */
+bool RecoverSqnMs(const SubscriberConfig &subscriber, const OctetString &rand, const OctetString &auts,
+                  uint64_t &sqnMs);
+
+/* Derives K_NASint and K_NASenc for the selected algorithms */
+void DeriveNasKeys(AmfSecurityContext &ctx);
+
+/* Derives K_gNB for the given uplink NAS COUNT, see 33.501 A.9 */
+OctetString DeriveKgnb(const OctetString &kAmf, uint32_t ulCount);
+
+/* Encodes the message, then ciphers and integrity protects it with the downlink NAS COUNT */
+OctetString ProtectNasMessage(AmfSecurityContext &ctx, const nas::PlainMmMessage &msg, nas::ESecurityHeaderType sht);
+
+/* Verifies and deciphers an uplink message, returns null if the integrity check fails */
+std::unique_ptr<nas::NasMessage> UnprotectNasMessage(AmfSecurityContext &ctx, const nas::SecuredMmMessage &msg);
+
+} // namespace nr::core
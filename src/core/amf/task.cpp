@@ -0,0 +1,336 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "task.hpp"
+
+#include <cstring>
+
+#include <unistd.h>
+
+#include <core/upf/task.hpp>
+
+static constexpr const size_t RECEIVE_BUFFER_SIZE = 8192;
+// Maximum number of messages received from one association before serving the others
+static constexpr const int MAX_RECEIVE_PER_WAKE_UP = 64;
+static constexpr const int MAX_EVENTS_PER_WAIT = 16;
+static constexpr const int WAIT_TIME = 500;
+static constexpr const uint32_t WAKE_UP_TAG = UINT32_MAX;
+static constexpr const uint32_t LISTEN_TAG = UINT32_MAX - 1;
+
+namespace nr::core
+{
+
+class AmfSctpHandler : public sctp::ISctpHandler
+{
+  private:
+    AmfTask *const amfTask;
+    int associationId;
+
+  public:
+    AmfSctpHandler(AmfTask *const amfTask, int associationId) : amfTask(amfTask), associationId(associationId)
+    {
+    }
+
+  private:
+    // The handler is called on the task thread, while receiving from the socket
+    void onAssociationSetup(int, int inStreams, int outStreams) override
+    {
+        auto *association = amfTask->findAssociation(associationId);
+        if (association != nullptr)
+            association->outStreams = outStreams;
+        amfTask->m_logger->debug("SCTP association setup (id: %d, in: %d, out: %d)", associationId, inStreams,
+                                 outStreams);
+    }
+
+    void onAssociationShutdown() override
+    {
+        auto *association = amfTask->findAssociation(associationId);
+        if (association != nullptr)
+            amfTask->closeAssociation(association);
+    }
+
+    void onMessage(const uint8_t *buffer, size_t length, uint16_t stream) override
+    {
+        amfTask->handleNgapMessage(associationId, stream, buffer, length);
+    }
+
+    void onUnhandledNotification() override
+    {
+    }
+
+    void onConnectionReset() override
+    {
+        onAssociationShutdown();
+    }
+};
+
+AmfTask::AmfTask(TaskBase *base)
+    : m_base{base}, m_poller{}, m_wakeUpFd{}, m_receiveBuffer{new uint8_t[RECEIVE_BUFFER_SIZE]},
+      m_associations{}, m_nextAssociationId{1}, m_ueContexts{}, m_nextAmfUeNgapId{1}, m_sqns{}, m_tmsis{},
+      m_nextTmsi{1}, m_nextTeid{1}, m_nextAddress{}, m_freeAddresses{}, m_random{}
+{
+    m_logger = base->logBase->makeUniqueLogger("amf");
+
+    m_wakeUpFd = enableWakeUpFd();
+    m_poller.add(m_wakeUpFd, WAKE_UP_TAG);
+}
+
+void AmfTask::onStart()
+{
+    auto *config = m_base->config;
+    try
+    {
+        m_server = std::make_unique<sctp::SctpServer>(config->ngapIp, config->ngapPort, sctp::PayloadProtocolId::NGAP,
+                                                      config->sctp);
+        m_server->setNonBlocking();
+        m_poller.add(m_server->getFd(), LISTEN_TAG);
+    }
+    catch (const std::exception &exc)
+    {
+        m_logger->err("NGAP server could not be started on %s:%d. %s", config->ngapIp.c_str(), config->ngapPort,
+                      exc.what());
+        m_server = nullptr;
+        return;
+    }
+
+    m_logger->info("NGAP server started on %s:%d", config->ngapIp.c_str(), config->ngapPort);
+}
+
+void AmfTask::onLoop()
+{
+    for (auto &item : m_associations)
+    {
+        auto *association = item.second.get();
+        if (!association->closed && !association->sendQueue.empty() && !association->waitingWritable)
+            flushSendQueue(association);
+    }
+
+    uint32_t tags[MAX_EVENTS_PER_WAIT];
+    int count = m_poller.wait(tags, MAX_EVENTS_PER_WAIT, WAIT_TIME);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (tags[i] == WAKE_UP_TAG)
+        {
+            uint64_t value;
+            while (::read(m_wakeUpFd, &value, sizeof(value)) > 0)
+            {
+            }
+            continue;
+        }
+
+        if (tags[i] == LISTEN_TAG)
+        {
+            acceptAssociations();
+            continue;
+        }
+
+        Association *association = findAssociation(static_cast<int>(tags[i]));
+        if (association == nullptr || association->closed)
+            continue;
+
+        if (association->waitingWritable)
+            flushSendQueue(association);
+        if (!association->closed)
+            receiveFromAssociation(association);
+    }
+
+    // The associations are deleted here, since they may be closed while receiving from them
+    for (auto it = m_associations.begin(); it != m_associations.end();)
+    {
+        if (it->second->closed)
+            it = m_associations.erase(it);
+        else
+            ++it;
+    }
+}
+
+void AmfTask::onQuit()
+{
+    m_associations.clear();
+    m_ueContexts.clear();
+    m_server = nullptr;
+}
+
+AmfTask::Association *AmfTask::findAssociation(int associationId)
+{
+    auto it = m_associations.find(associationId);
+    return it == m_associations.end() ? nullptr : it->second.get();
+}
+
+void AmfTask::acceptAssociations()
+{
+    while (true)
+    {
+        std::unique_ptr<sctp::SctpClient> client;
+        try
+        {
+            client = m_server->accept();
+            if (client == nullptr)
+                return;
+            client->setNonBlocking();
+        }
+        catch (const std::exception &exc)
+        {
+            m_logger->err("SCTP accept failure. %s", exc.what());
+            return;
+        }
+
+        int id = m_nextAssociationId++;
+        m_poller.add(client->getFd(), static_cast<uint32_t>(id));
+
+        auto association = std::make_unique<Association>();
+        association->id = id;
+        association->client = std::move(client);
+        association->handler = std::make_unique<AmfSctpHandler>(this, id);
+        association->waitingWritable = false;
+        association->closed = false;
+        association->outStreams = m_base->config->sctp.outStreams;
+        m_associations[id] = std::move(association);
+
+        m_logger->info("New SCTP association accepted (id: %d)", id);
+    }
+}
+
+void AmfTask::receiveFromAssociation(Association *association)
+{
+    for (int i = 0; i < MAX_RECEIVE_PER_WAKE_UP; i++)
+    {
+        sctp::ReceiveResult result;
+        try
+        {
+            result = association->client->tryReceive(association->handler.get(), m_receiveBuffer.get(),
+                                                      RECEIVE_BUFFER_SIZE);
+        }
+        catch (const sctp::SctpError &exc)
+        {
+            m_logger->err("SCTP receive failure (id: %d). %s", association->id, exc.what());
+            result = sctp::ReceiveResult::CLOSED;
+        }
+
+        if (result == sctp::ReceiveResult::CLOSED)
+            closeAssociation(association);
+        if (result != sctp::ReceiveResult::RECEIVED || association->closed)
+            return;
+    }
+}
+
+void AmfTask::flushSendQueue(Association *association)
+{
+    auto &queue = association->sendQueue;
+    while (!queue.empty())
+    {
+        auto &item = queue.front();
+        bool sent;
+        try
+        {
+            sent = association->client->trySend(item.stream, item.buffer.data(), item.buffer.size(), queue.size() > 1);
+        }
+        catch (const sctp::SctpError &exc)
+        {
+            m_logger->err("SCTP send failure (id: %d). %s", association->id, exc.what());
+            closeAssociation(association);
+            return;
+        }
+
+        if (!sent)
+            break;
+        queue.pop_front();
+    }
+
+    // The rest of the queue is sent when the socket becomes writable
+    bool waitingWritable = !queue.empty();
+    if (waitingWritable != association->waitingWritable)
+    {
+        association->waitingWritable = waitingWritable;
+        m_poller.setWritable(association->client->getFd(), static_cast<uint32_t>(association->id), waitingWritable);
+    }
+}
+
+void AmfTask::closeAssociation(Association *association)
+{
+    if (association->closed)
+        return;
+
+    m_logger->warn("SCTP association closed (id: %d)", association->id);
+
+    association->closed = true;
+    association->sendQueue.clear();
+    m_poller.remove(association->client->getFd());
+
+    // The UE contexts of the gNB are released together with their PDU sessions
+    std::vector<int64_t> released{};
+    for (auto &ue : m_ueContexts)
+        if (ue.second->associationId == association->id)
+            released.push_back(ue.first);
+    for (auto id : released)
+        deleteUeContext(id);
+}
+
+void AmfTask::sendNgap(int associationId, uint16_t stream, UniqueBuffer &&buffer)
+{
+    auto *association = findAssociation(associationId);
+    if (association == nullptr || association->closed)
+        return;
+
+    // Queued messages are flushed before the next wait, so the messages of one loop iteration are coalesced
+    association->sendQueue.push_back(PendingMessage{stream, std::move(buffer)});
+}
+
+AmfUeContext *AmfTask::findUeContext(int64_t amfUeNgapId)
+{
+    auto it = m_ueContexts.find(amfUeNgapId);
+    return it == m_ueContexts.end() ? nullptr : it->second.get();
+}
+
+void AmfTask::deleteUeContext(int64_t amfUeNgapId)
+{
+    auto *ue = findUeContext(amfUeNgapId);
+    if (ue == nullptr)
+        return;
+
+    std::vector<int> sessions{};
+    for (auto &session : ue->sessions)
+        sessions.push_back(session.first);
+    for (int psi : sessions)
+        releaseSession(ue, psi);
+
+    m_ueContexts.erase(amfUeNgapId);
+}
+
+void AmfTask::releaseSession(AmfUeContext *ue, int psi)
+{
+    auto it = ue->sessions.find(psi);
+    if (it == ue->sessions.end())
+        return;
+
+    auto msg = std::make_unique<NmCoreAmfToUpf>(NmCoreAmfToUpf::SESSION_RELEASE);
+    msg->ulTeid = it->second.ulTeid;
+    m_base->upfTask->push(std::move(msg));
+
+    m_freeAddresses.push_back(it->second.ueAddress);
+    ue->sessions.erase(it);
+}
+
+bool AmfTask::allocateAddress(uint32_t &address)
+{
+    if (!m_freeAddresses.empty())
+    {
+        address = m_freeAddresses.back();
+        m_freeAddresses.pop_back();
+        return true;
+    }
+
+    // The network and broadcast addresses of the pool are never assigned
+    if (m_nextAddress + 2 >= m_base->config->ueSubnetSize)
+        return false;
+    address = m_base->config->ueSubnet + ++m_nextAddress;
+    return true;
+}
+
+} // namespace nr::core
@@ -0,0 +1,207 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include "security.hpp"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <core/nts.hpp>
+#include <core/types.hpp>
+#include <gnb/types.hpp>
+#include <lib/nas/nas.hpp>
+#include <lib/sctp/sctp.hpp>
+#include <utils/fd_base.hpp>
+#include <utils/logger.hpp>
+#include <utils/nts.hpp>
+#include <utils/random.hpp>
+#include <utils/unique_buffer.hpp>
+
+extern "C"
+{
+    struct ASN_NGAP_NGAP_PDU;
+    struct ASN_NGAP_NGSetupRequest;
+    struct ASN_NGAP_InitialContextSetupResponse;
+    struct ASN_NGAP_InitialContextSetupFailure;
+    struct ASN_NGAP_PDUSessionResourceSetupResponse;
+    struct ASN_NGAP_PDUSessionResourceReleaseResponse;
+    struct ASN_NGAP_UEContextReleaseRequest;
+    struct ASN_NGAP_UEContextReleaseComplete;
+    struct ASN_NGAP_ErrorIndication;
+    struct ASN_NGAP_InitialUEMessage;
+    struct ASN_NGAP_UplinkNASTransport;
+}
+
+namespace nr::core
+{
+
+enum class EAmfUeState
+{
+    IDENTIFICATION,
+    AUTHENTICATION,
+    SECURITY_MODE,
+    REGISTRATION,
+    REGISTERED,
+    RELEASING, // UE Context Release Command is sent
+};
+
+struct AmfPduSession
+{
+    int psi{};
+    uint32_t ulTeid{};
+    uint32_t ueAddress{};
+};
+
+struct AmfUeContext
+{
+    int64_t amfUeNgapId{};
+    int64_t ranUeNgapId{};
+    int associationId{};
+    uint16_t stream{};
+    EAmfUeState state{};
+
+    std::string supi{}; // IMSI digits
+    const SubscriberConfig *subscriber{};
+    uint32_t tmsi{};
+
+    // Authentication and security mode
+    std::optional<nas::IEUeSecurityCapability> ueSecurityCapability{};
+    int ueKsi{nas::IENasKeySetIdentifier::NOT_AVAILABLE_OR_RESERVED};
+    int ueNonCurrentKsi{nas::IENasKeySetIdentifier::NOT_AVAILABLE_OR_RESERVED};
+    AuthVector authVector{};
+    int authKsi{}; // ngKSI of the authentication in progress
+    int syncFailures{};
+    std::unique_ptr<AmfSecurityContext> security{}; // Taken into use with Security Mode Command
+
+    std::unordered_map<int, AmfPduSession> sessions{};
+};
+
+/*
+ * A minimal AMF serving the gNBs over SCTP. NGAP and NAS are handled on the task thread, which also serves all
+ * associations with a single epoll instance like the gNB's SCTP task. Registration with 5G-AKA, PDU session
+ * establishment and release, and deregistration are supported, the user plane is delegated to the UPF task.
+ */
+class AmfTask : public NtsTask
+{
+  private:
+    struct PendingMessage
+    {
+        uint16_t stream;
+        UniqueBuffer buffer;
+    };
+
+    struct Association
+    {
+        int id;
+        std::unique_ptr<sctp::SctpClient> client;
+        std::unique_ptr<sctp::ISctpHandler> handler;
+        std::deque<PendingMessage> sendQueue;
+        bool waitingWritable;
+        bool closed;
+        int outStreams;
+    };
+
+  private:
+    TaskBase *m_base;
+    std::unique_ptr<Logger> m_logger;
+    std::unique_ptr<sctp::SctpServer> m_server;
+    FdPoller m_poller;
+    int m_wakeUpFd;
+    std::unique_ptr<uint8_t[]> m_receiveBuffer;
+    std::unordered_map<int, std::unique_ptr<Association>> m_associations;
+    int m_nextAssociationId;
+
+    std::unordered_map<int64_t, std::unique_ptr<AmfUeContext>> m_ueContexts;
+    int64_t m_nextAmfUeNgapId;
+    std::unordered_map<std::string, uint64_t> m_sqns;  // The last SQN used for each SUPI
+    std::unordered_map<uint32_t, std::string> m_tmsis; // The SUPI of each assigned 5G-TMSI
+    uint32_t m_nextTmsi;
+    uint32_t m_nextTeid;
+    uint32_t m_nextAddress;
+    std::vector<uint32_t> m_freeAddresses;
+    Random m_random;
+
+    friend class AmfSctpHandler;
+
+  public:
+    explicit AmfTask(TaskBase *base);
+    ~AmfTask() override = default;
+
+  protected:
+    void onStart() override;
+    void onLoop() override;
+    void onQuit() override;
+
+  private: /* SCTP */
+    Association *findAssociation(int associationId);
+    void acceptAssociations();
+    void receiveFromAssociation(Association *association);
+    void flushSendQueue(Association *association);
+    void closeAssociation(Association *association);
+    void sendNgap(int associationId, uint16_t stream, ASN_NGAP_NGAP_PDU *pdu);
+    void sendNgap(int associationId, uint16_t stream, UniqueBuffer &&buffer);
+
+  private: /* NGAP */
+    void handleNgapMessage(int associationId, uint16_t stream, const uint8_t *buffer, size_t length);
+    void handleNgapPdu(int associationId, uint16_t stream, ASN_NGAP_NGAP_PDU *pdu);
+    void receiveNgSetupRequest(int associationId, ASN_NGAP_NGSetupRequest *msg);
+    void receiveInitialUeMessage(int associationId, uint16_t stream, int64_t ranUeNgapId, const OctetString &nasPdu);
+    void receiveInitialContextSetupResponse(ASN_NGAP_InitialContextSetupResponse *msg);
+    void receiveInitialContextSetupFailure(ASN_NGAP_InitialContextSetupFailure *msg);
+    void receiveSessionResourceSetupResponse(ASN_NGAP_PDUSessionResourceSetupResponse *msg);
+    void receiveSessionResourceReleaseResponse(ASN_NGAP_PDUSessionResourceReleaseResponse *msg);
+    void receiveContextReleaseRequest(ASN_NGAP_UEContextReleaseRequest *msg);
+    void receiveContextReleaseComplete(ASN_NGAP_UEContextReleaseComplete *msg);
+    void receiveErrorIndication(int associationId, ASN_NGAP_ErrorIndication *msg);
+    void sendNgapUeAssociated(AmfUeContext *ue, ASN_NGAP_NGAP_PDU *pdu);
+    void sendDownlinkNasTransport(AmfUeContext *ue, const OctetString &nasPdu);
+    void sendInitialContextSetupRequest(AmfUeContext *ue, const OctetString &nasPdu);
+    void sendSessionResourceSetupRequest(AmfUeContext *ue, const AmfPduSession &session, const nas::IESNssai &slice,
+                                         const OctetString &nasPdu);
+    void sendSessionResourceReleaseCommand(AmfUeContext *ue, int psi, const OctetString &nasPdu);
+    void sendContextReleaseCommand(AmfUeContext *ue, gnb::NgapCause cause);
+
+  private: /* UE contexts */
+    AmfUeContext *findUeContext(int64_t amfUeNgapId);
+    void deleteUeContext(int64_t amfUeNgapId);
+    void releaseSession(AmfUeContext *ue, int psi);
+    bool allocateAddress(uint32_t &address);
+
+  private: /* NAS */
+    void handleNasMessage(AmfUeContext *ue, const OctetString &nasPdu);
+    void sendNasMessage(AmfUeContext *ue, const nas::PlainMmMessage &msg);
+    OctetString encodeNasMessage(AmfUeContext *ue, const nas::PlainMmMessage &msg);
+    OctetString encodeSmMessage(AmfUeContext *ue, const nas::SmMessage &msg);
+    void receiveMmMessage(AmfUeContext *ue, const nas::PlainMmMessage &msg);
+    void receiveRegistrationRequest(AmfUeContext *ue, const nas::RegistrationRequest &msg);
+    void receiveIdentityResponse(AmfUeContext *ue, const nas::IdentityResponse &msg);
+    void receiveAuthenticationResponse(AmfUeContext *ue, const nas::AuthenticationResponse &msg);
+    void receiveAuthenticationFailure(AmfUeContext *ue, const nas::AuthenticationFailure &msg);
+    void receiveSecurityModeComplete(AmfUeContext *ue, const nas::SecurityModeComplete &msg);
+    void receiveSecurityModeReject(AmfUeContext *ue, const nas::SecurityModeReject &msg);
+    void receiveRegistrationComplete(AmfUeContext *ue);
+    void receiveDeregistrationRequest(AmfUeContext *ue, const nas::DeRegistrationRequestUeOriginating &msg);
+    void receiveServiceRequest(AmfUeContext *ue, const nas::ServiceRequest &msg);
+    void receiveUlNasTransport(AmfUeContext *ue, const nas::UlNasTransport &msg);
+    void receiveSessionEstablishmentRequest(AmfUeContext *ue, const nas::PduSessionEstablishmentRequest &msg,
+                                            const nas::UlNasTransport &transport);
+    void receiveSessionReleaseRequest(AmfUeContext *ue, const nas::PduSessionReleaseRequest &msg);
+    bool identifySubscriber(AmfUeContext *ue, const nas::IE5gsMobileIdentity &identity);
+    void sendAuthenticationRequest(AmfUeContext *ue, uint64_t sqn);
+    void sendAuthenticationReject(AmfUeContext *ue);
+    void sendSecurityModeCommand(AmfUeContext *ue);
+    void sendRegistrationReject(AmfUeContext *ue, nas::EMmCause cause);
+};
+
+} // namespace nr::core
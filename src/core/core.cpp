@@ -0,0 +1,47 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "core.hpp"
+#include "amf/task.hpp"
+#include "upf/task.hpp"
+
+namespace nr::core
+{
+
+CoreNetwork::CoreNetwork(CoreConfig *config)
+{
+    auto *base = new TaskBase();
+    base->config = config;
+    base->logBase = new LogBase("logs/" + config->name + ".log");
+
+    base->amfTask = new AmfTask(base);
+    base->upfTask = new UpfTask(base);
+
+    taskBase = base;
+}
+
+CoreNetwork::~CoreNetwork()
+{
+    taskBase->amfTask->quit();
+    taskBase->upfTask->quit();
+
+    delete taskBase->amfTask;
+    delete taskBase->upfTask;
+
+    delete taskBase->logBase;
+
+    delete taskBase;
+}
+
+void CoreNetwork::start()
+{
+    taskBase->upfTask->start();
+    taskBase->amfTask->start();
+}
+
+} // namespace nr::core
@@ -8,9 +8,22 @@
 
 #pragma once
 
-namespace rlc
+#include "types.hpp"
+
+namespace nr::core
+{
+
+class CoreNetwork
 {
+  private:
+    TaskBase *taskBase;
+
+  public:
+    explicit CoreNetwork(CoreConfig *config);
+    virtual ~CoreNetwork();
 
-void rlcTestMain();
+  public:
+    void start();
+};
 
-}
\ No newline at end of file
+} // namespace nr::core
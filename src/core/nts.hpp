@@ -0,0 +1,44 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <string>
+
+#include <utils/nts.hpp>
+
+namespace nr::core
+{
+
+struct NmCoreAmfToUpf : NtsMessage
+{
+    enum PR
+    {
+        SESSION_CREATE,
+        SESSION_RELEASE,
+    } present;
+
+    // SESSION_CREATE
+    // SESSION_RELEASE
+    uint32_t ulTeid{};
+
+    // SESSION_CREATE
+    uint32_t dlTeid{};
+    std::string dlAddress{};
+    int qfi{};
+    uint32_t ueAddress{};
+
+    explicit NmCoreAmfToUpf(PR present) : NtsMessage(NtsMessageType::CORE_AMF_TO_UPF), present(present)
+    {
+    }
+};
+
+} // namespace nr::core
@@ -0,0 +1,84 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <lib/nas/enums.hpp>
+#include <lib/sctp/types.hpp>
+#include <utils/common_types.hpp>
+#include <utils/logger.hpp>
+#include <utils/octet_string.hpp>
+
+namespace nr::core
+{
+
+class AmfTask;
+class UpfTask;
+
+/* A range of subscribers with consecutive IMSIs sharing the same credentials */
+struct SubscriberConfig
+{
+    std::string firstSupi{}; // IMSI digits, without the "imsi-" prefix
+    int count{};
+    OctetString key{};
+    OctetString opC{}; // OPc is derived at start-up if OP is configured
+    OctetString amf{};
+};
+
+enum class EUpfMode
+{
+    ECHO, // Uplink packets are sent back to the UE with their addresses and ports swapped
+    SINK, // Uplink packets are counted and dropped
+};
+
+struct CoreConfig
+{
+    /* Read from config file */
+    Plmn plmn{};
+    int tac{};
+    NetworkSlice nssai{};
+
+    std::string amfName{};
+    int amfRegionId{};
+    int amfSetId{};
+    int amfPointer{};
+    int relativeCapacity{};
+
+    std::string ngapIp{};
+    uint16_t ngapPort{};
+    sctp::SocketOptions sctp{};
+
+    std::vector<nas::ETypeOfIntegrityProtectionAlgorithm> integrity{}; // In the order of preference
+    std::vector<nas::ETypeOfCipheringAlgorithm> ciphering{};           // In the order of preference
+    std::vector<SubscriberConfig> subscribers{};
+
+    std::string gtpIp{};
+    uint32_t ueSubnet{};     // First address of the UE IPv4 pool
+    uint32_t ueSubnetSize{}; // Number of addresses in the pool
+    int ambrDl{};            // Mbps, for both the UEs and their PDU sessions
+    int ambrUl{};            // Mbps, for both the UEs and their PDU sessions
+    EUpfMode upfMode{};
+    int statsInterval{}; // Seconds, 0 if the UPF statistics are not logged
+
+    /* Assigned by program */
+    std::string name{};
+};
+
+struct TaskBase
+{
+    CoreConfig *config{};
+    LogBase *logBase{};
+
+    AmfTask *amfTask{};
+    UpfTask *upfTask{};
+};
+
+} // namespace nr::core
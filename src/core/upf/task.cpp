@@ -0,0 +1,397 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "task.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <utils/common.hpp>
+
+static constexpr const uint16_t GTP_PORT = 2152;
+static constexpr const int BATCH_SIZE = 64;
+// Maximum number of batches received before serving the message queue again
+static constexpr const int MAX_BATCHES_PER_WAKE_UP = 16;
+static constexpr const size_t BUFFER_SIZE = 2048;
+static constexpr const size_t DL_HEADER_LENGTH = 16;
+static constexpr const int RECEIVE_BUFFER_SIZE = 8 * 1024 * 1024;
+static constexpr const int MAX_EVENTS_PER_WAIT = 4;
+static constexpr const int WAIT_TIME = 500;
+static constexpr const uint32_t WAKE_UP_TAG = 0;
+static constexpr const uint32_t SOCKET_TAG = 1;
+
+static constexpr const uint8_t GTP_ECHO_REQUEST = 1;
+static constexpr const uint8_t GTP_ECHO_RESPONSE = 2;
+static constexpr const uint8_t GTP_G_PDU = 255;
+
+static inline uint32_t Read32(const uint8_t *p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+static inline void Write16(uint8_t *p, uint32_t value)
+{
+    p[0] = static_cast<uint8_t>(value >> 8);
+    p[1] = static_cast<uint8_t>(value);
+}
+
+static inline void Write32(uint8_t *p, uint32_t value)
+{
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+static inline void SwapBytes(uint8_t *a, uint8_t *b, size_t length)
+{
+    uint8_t temp[4];
+    std::memcpy(temp, a, length);
+    std::memcpy(a, b, length);
+    std::memcpy(b, temp, length);
+}
+
+/* Turns an uplink IPv4 packet into the reply of its peer, the checksums stay valid since the fields are swapped */
+static void EchoIpPacket(uint8_t *ip, size_t length)
+{
+    size_t headerLength = static_cast<size_t>(ip[0] & 0x0F) * 4;
+    SwapBytes(ip + 12, ip + 16, 4);
+
+    bool firstFragment = (ip[6] & 0x1F) == 0 && ip[7] == 0;
+    if (!firstFragment || headerLength + 8 > length)
+        return;
+
+    uint8_t *l4 = ip + headerLength;
+    switch (ip[9])
+    {
+    case IPPROTO_TCP:
+    case IPPROTO_UDP:
+        SwapBytes(l4, l4 + 2, 2);
+        break;
+    case IPPROTO_ICMP:
+        if (l4[0] == 8)
+        {
+            // Echo Request becomes Echo Reply, the checksum is updated incrementally, see RFC 1624
+            uint32_t oldWord = (8u << 8) | l4[1];
+            uint32_t newWord = l4[1];
+            uint32_t checksum = (static_cast<uint32_t>(l4[2]) << 8) | l4[3];
+            uint32_t sum = (~checksum & 0xFFFF) + (~oldWord & 0xFFFF) + newWord;
+            sum = (sum & 0xFFFF) + (sum >> 16);
+            sum = (sum & 0xFFFF) + (sum >> 16);
+            l4[0] = 0;
+            Write16(l4 + 2, ~sum & 0xFFFF);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+namespace nr::core
+{
+
+UpfTask::UpfTask(TaskBase *base)
+    : m_base{base}, m_socket{}, m_poller{}, m_wakeUpFd{}, m_sessions{},
+      m_buffers{new uint8_t[BATCH_SIZE * BUFFER_SIZE]}, m_receiveHeaders{new mmsghdr[BATCH_SIZE]},
+      m_receiveVectors{new iovec[BATCH_SIZE]}, m_peers{new sockaddr_storage[BATCH_SIZE]},
+      m_sendHeaders{new mmsghdr[BATCH_SIZE]}, m_sendVectors{new iovec[BATCH_SIZE]}, m_statistics{},
+      m_lastStatistics{}, m_lastStatisticsTime{}
+{
+    m_logger = base->logBase->makeUniqueLogger("upf");
+
+    m_wakeUpFd = enableWakeUpFd();
+    m_poller.add(m_wakeUpFd, WAKE_UP_TAG);
+
+    // Each buffer has room for the downlink header before the received datagram
+    for (int i = 0; i < BATCH_SIZE; i++)
+    {
+        m_receiveVectors[i].iov_base = m_buffers.get() + i * BUFFER_SIZE + DL_HEADER_LENGTH;
+        m_receiveVectors[i].iov_len = BUFFER_SIZE - DL_HEADER_LENGTH;
+    }
+}
+
+void UpfTask::onStart()
+{
+    auto *config = m_base->config;
+    try
+    {
+        m_socket = Socket::CreateAndBindUdp(InetAddress{config->gtpIp, GTP_PORT});
+        m_socket.setReceiveBufferSize(RECEIVE_BUFFER_SIZE);
+        m_poller.add(m_socket.getFd(), SOCKET_TAG);
+    }
+    catch (const std::exception &exc)
+    {
+        m_logger->err("GTP-U socket could not be created on %s:%d. %s", config->gtpIp.c_str(), GTP_PORT, exc.what());
+        return;
+    }
+
+    m_lastStatisticsTime = utils::CurrentTimeMillis();
+    m_logger->info("UPF started on %s:%d in %s mode", config->gtpIp.c_str(), GTP_PORT,
+                   config->upfMode == EUpfMode::ECHO ? "echo" : "sink");
+}
+
+void UpfTask::onLoop()
+{
+    while (auto msg = poll())
+    {
+        if (msg->msgType == NtsMessageType::CORE_AMF_TO_UPF)
+            handleAmfMessage(dynamic_cast<NmCoreAmfToUpf &>(*msg));
+        else
+            m_logger->unhandledNts(*msg);
+    }
+
+    uint32_t tags[MAX_EVENTS_PER_WAIT];
+    int count = m_poller.wait(tags, MAX_EVENTS_PER_WAIT, WAIT_TIME);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (tags[i] == WAKE_UP_TAG)
+        {
+            uint64_t value;
+            while (::read(m_wakeUpFd, &value, sizeof(value)) > 0)
+            {
+            }
+        }
+        else if (tags[i] == SOCKET_TAG)
+        {
+            receiveBatch();
+        }
+    }
+
+    int statsInterval = m_base->config->statsInterval;
+    if (statsInterval > 0 && utils::CurrentTimeMillis() - m_lastStatisticsTime >= statsInterval * 1000LL)
+        logStatistics();
+}
+
+void UpfTask::onQuit()
+{
+    m_sessions.clear();
+    m_socket.close();
+}
+
+void UpfTask::handleAmfMessage(const NmCoreAmfToUpf &msg)
+{
+    switch (msg.present)
+    {
+    case NmCoreAmfToUpf::SESSION_CREATE: {
+        UpfSession session{};
+        session.dlTeid = msg.dlTeid;
+        session.qfi = static_cast<uint8_t>(msg.qfi);
+        session.ueAddress = msg.ueAddress;
+        session.dlAddress.sin_family = AF_INET;
+        session.dlAddress.sin_port = htons(GTP_PORT);
+        if (::inet_pton(AF_INET, msg.dlAddress.c_str(), &session.dlAddress.sin_addr) != 1)
+        {
+            m_logger->err("Unsupported gNB GTP-U address [%s]", msg.dlAddress.c_str());
+            return;
+        }
+        m_sessions[msg.ulTeid] = session;
+        break;
+    }
+    case NmCoreAmfToUpf::SESSION_RELEASE:
+        m_sessions.erase(msg.ulTeid);
+        break;
+    }
+}
+
+void UpfTask::receiveBatch()
+{
+    int fd = m_socket.getFd();
+
+    for (int batch = 0; batch < MAX_BATCHES_PER_WAKE_UP; batch++)
+    {
+        for (int i = 0; i < BATCH_SIZE; i++)
+        {
+            auto &hdr = m_receiveHeaders[i].msg_hdr;
+            std::memset(&hdr, 0, sizeof(hdr));
+            hdr.msg_iov = &m_receiveVectors[i];
+            hdr.msg_iovlen = 1;
+            hdr.msg_name = &m_peers[i];
+            hdr.msg_namelen = sizeof(sockaddr_storage);
+        }
+
+        int received = ::recvmmsg(fd, m_receiveHeaders.get(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (received <= 0)
+        {
+            if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                m_logger->err("GTP-U receive failure. %s", std::strerror(errno));
+            return;
+        }
+
+        int sendCount = 0;
+        for (int i = 0; i < received; i++)
+        {
+            auto *data = static_cast<uint8_t *>(m_receiveVectors[i].iov_base);
+            size_t length = m_receiveHeaders[i].msg_len;
+            const sockaddr *destination = nullptr;
+
+            if (!handleGtpMessage(i, data, length, destination))
+                continue;
+
+            m_sendVectors[sendCount].iov_base = data;
+            m_sendVectors[sendCount].iov_len = length;
+            auto &hdr = m_sendHeaders[sendCount].msg_hdr;
+            std::memset(&hdr, 0, sizeof(hdr));
+            hdr.msg_iov = &m_sendVectors[sendCount];
+            hdr.msg_iovlen = 1;
+            hdr.msg_name = const_cast<sockaddr *>(destination);
+            hdr.msg_namelen = destination->sa_family == AF_INET ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
+            sendCount++;
+        }
+
+        int sent = 0;
+        while (sent < sendCount)
+        {
+            int result = ::sendmmsg(fd, m_sendHeaders.get() + sent, static_cast<unsigned>(sendCount - sent), 0);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+            {
+                m_statistics.dropped += static_cast<uint64_t>(sendCount - sent);
+                break;
+            }
+            sent += result;
+        }
+
+        if (received < BATCH_SIZE)
+            return;
+    }
+}
+
+bool UpfTask::handleGtpMessage(int index, uint8_t *&data, size_t &length, const sockaddr *&destination)
+{
+    // Only GTPv1 with the protocol type GTP is accepted
+    if (length < 8 || (data[0] >> 5) != 1 || (data[0] & 0x10) == 0)
+    {
+        m_statistics.dropped++;
+        return false;
+    }
+
+    size_t gtpLength = 8 + ((static_cast<size_t>(data[2]) << 8) | data[3]);
+    if (gtpLength > length)
+    {
+        m_statistics.dropped++;
+        return false;
+    }
+    length = gtpLength;
+
+    if (data[1] == GTP_G_PDU)
+        return handleGPdu(data, length, destination);
+
+    if (data[1] == GTP_ECHO_REQUEST)
+    {
+        // The response is written over the request, with the same sequence number and the Recovery IE
+        uint8_t seq0 = (data[0] & 0x02) && length >= 10 ? data[8] : 0;
+        uint8_t seq1 = (data[0] & 0x02) && length >= 10 ? data[9] : 0;
+        const uint8_t response[] = {0x32, GTP_ECHO_RESPONSE, 0, 6, 0, 0, 0, 0, seq0, seq1, 0, 0, 14, 0};
+        std::memcpy(data, response, sizeof(response));
+        length = sizeof(response);
+        destination = reinterpret_cast<const sockaddr *>(&m_peers[index]);
+        return true;
+    }
+
+    return false;
+}
+
+bool UpfTask::handleGPdu(uint8_t *&data, size_t &length, const sockaddr *&destination)
+{
+    uint32_t teid = Read32(data + 4);
+
+    // Skip the optional fields and the extension headers
+    size_t offset = 8;
+    if (data[0] & 0x07)
+    {
+        if (length < 12)
+        {
+            m_statistics.dropped++;
+            return false;
+        }
+        uint8_t next = data[11];
+        offset = 12;
+        while (next != 0)
+        {
+            size_t extLength = offset < length ? static_cast<size_t>(data[offset]) * 4 : 0;
+            if (extLength == 0 || offset + extLength > length)
+            {
+                m_statistics.dropped++;
+                return false;
+            }
+            next = data[offset + extLength - 1];
+            offset += extLength;
+        }
+    }
+
+    uint8_t *ip = data + offset;
+    size_t ipLength = length - offset;
+
+    auto it = m_sessions.find(teid);
+    if (it == m_sessions.end() || ipLength < 20 || (ip[0] >> 4) != 4)
+    {
+        m_statistics.dropped++;
+        return false;
+    }
+
+    m_statistics.ulPackets++;
+    m_statistics.ulBytes += ipLength;
+
+    auto &session = it->second;
+    if (m_base->config->upfMode == EUpfMode::SINK || Read32(ip + 12) != session.ueAddress)
+        return false;
+
+    EchoIpPacket(ip, ipLength);
+
+    // The downlink header replaces the uplink one, there is always headroom for it before the received datagram
+    data = ip - DL_HEADER_LENGTH;
+    length = ipLength + DL_HEADER_LENGTH;
+
+    data[0] = 0x34; // Version 1, protocol type GTP, extension header present
+    data[1] = GTP_G_PDU;
+    Write16(data + 2, static_cast<uint32_t>(length - 8));
+    Write32(data + 4, session.dlTeid);
+    data[8] = 0;
+    data[9] = 0;
+    data[10] = 0;
+    data[11] = 0x85; // PDU Session Container
+    data[12] = 1;
+    data[13] = 0x00; // DL PDU Session Information
+    data[14] = session.qfi & 0x3F;
+    data[15] = 0;
+
+    m_statistics.dlPackets++;
+    m_statistics.dlBytes += ipLength;
+
+    destination = reinterpret_cast<const sockaddr *>(&session.dlAddress);
+    return true;
+}
+
+void UpfTask::logStatistics()
+{
+    int64_t now = utils::CurrentTimeMillis();
+    double seconds = static_cast<double>(now - m_lastStatisticsTime) / 1000.0;
+
+    auto rate = [seconds](uint64_t current, uint64_t last) {
+        return seconds > 0 ? static_cast<double>(current - last) / seconds : 0.0;
+    };
+
+    m_logger->info("UL %.2f Mbps %.0f pps, DL %.2f Mbps %.0f pps, dropped %lu, sessions %u",
+                   rate(m_statistics.ulBytes, m_lastStatistics.ulBytes) * 8.0 / 1e6,
+                   rate(m_statistics.ulPackets, m_lastStatistics.ulPackets),
+                   rate(m_statistics.dlBytes, m_lastStatistics.dlBytes) * 8.0 / 1e6,
+                   rate(m_statistics.dlPackets, m_lastStatistics.dlPackets),
+                   static_cast<unsigned long>(m_statistics.dropped - m_lastStatistics.dropped),
+                   static_cast<unsigned>(m_sessions.size()));
+
+    m_lastStatistics = m_statistics;
+    m_lastStatisticsTime = now;
+}
+
+} // namespace nr::core
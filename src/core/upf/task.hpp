@@ -0,0 +1,87 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <core/nts.hpp>
+#include <core/types.hpp>
+#include <utils/fd_base.hpp>
+#include <utils/logger.hpp>
+#include <utils/network.hpp>
+#include <utils/nts.hpp>
+
+namespace nr::core
+{
+
+struct UpfSession
+{
+    uint32_t dlTeid{};
+    sockaddr_in dlAddress{};
+    uint8_t qfi{};
+    uint32_t ueAddress{};
+};
+
+struct UpfStatistics
+{
+    uint64_t ulPackets{};
+    uint64_t ulBytes{};
+    uint64_t dlPackets{};
+    uint64_t dlBytes{};
+    uint64_t dropped{};
+};
+
+/*
+ * A minimal UPF terminating the N3 tunnels of the sessions set up by the AMF task. The packets are received and sent
+ * in batches, and the uplink packets are turned into downlink ones in place in the receive buffers.
+ */
+class UpfTask : public NtsTask
+{
+  private:
+    TaskBase *m_base;
+    std::unique_ptr<Logger> m_logger;
+    Socket m_socket;
+    FdPoller m_poller;
+    int m_wakeUpFd;
+
+    std::unordered_map<uint32_t, UpfSession> m_sessions; // By the uplink TEID
+    std::unique_ptr<uint8_t[]> m_buffers;
+    std::unique_ptr<mmsghdr[]> m_receiveHeaders;
+    std::unique_ptr<iovec[]> m_receiveVectors;
+    std::unique_ptr<sockaddr_storage[]> m_peers;
+    std::unique_ptr<mmsghdr[]> m_sendHeaders;
+    std::unique_ptr<iovec[]> m_sendVectors;
+
+    UpfStatistics m_statistics;
+    UpfStatistics m_lastStatistics;
+    int64_t m_lastStatisticsTime;
+
+  public:
+    explicit UpfTask(TaskBase *base);
+    ~UpfTask() override = default;
+
+  protected:
+    void onStart() override;
+    void onLoop() override;
+    void onQuit() override;
+
+  private:
+    void handleAmfMessage(const NmCoreAmfToUpf &msg);
+    void receiveBatch();
+    bool handleGtpMessage(int index, uint8_t *&data, size_t &length, const sockaddr *&destination);
+    bool handleGPdu(uint8_t *&data, size_t &length, const sockaddr *&destination);
+    void logStatistics();
+};
+
+} // namespace nr::core
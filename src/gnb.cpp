@@ -7,16 +7,20 @@
 //
 
 #include <iostream>
+#include <optional>
 #include <stdexcept>
 #include <unordered_map>
 
 #include <unistd.h>
 
 #include <gnb/gnb.hpp>
+#include <lib/capture/capture.hpp>
+#include <lib/trace/trace.hpp>
 #include <lib/app/base_app.hpp>
 #include <lib/app/cli_base.hpp>
 #include <lib/app/cli_cmd.hpp>
 #include <lib/app/proc_table.hpp>
+#include <utils/clock.hpp>
 #include <utils/common.hpp>
 #include <utils/constants.hpp>
 #include <utils/io.hpp>
@@ -33,6 +37,8 @@ static struct Options
 {
     std::string configFile{};
     bool disableCmd{};
+    bool virtualTime{};
+    std::optional<std::string> traceFile{};
 } g_options{};
 
 static nr::gnb::GnbConfig *ReadConfigYaml()
@@ -57,6 +63,57 @@ static nr::gnb::GnbConfig *ReadConfigYaml()
         result->gtpAdvertiseIp = yaml::GetIp(config, "gtpAdvertiseIp");
 
     result->ignoreStreamIds = yaml::GetBool(config, "ignoreStreamIds");
+    if (yaml::HasField(config, "ngapDecoderThreads"))
+        result->ngapDecoderThreads = yaml::GetInt32(config, "ngapDecoderThreads", 0, 64);
+
+    result->asnConstraintCheck = nr::gnb::EAsnConstraintCheck::ALWAYS;
+    if (yaml::HasField(config, "asnConstraintCheck"))
+    {
+        std::string check = yaml::GetString(config, "asnConstraintCheck");
+        if (check == "always")
+            result->asnConstraintCheck = nr::gnb::EAsnConstraintCheck::ALWAYS;
+        else if (check == "sampled")
+            result->asnConstraintCheck = nr::gnb::EAsnConstraintCheck::SAMPLED;
+        else if (check == "debug")
+            result->asnConstraintCheck = nr::gnb::EAsnConstraintCheck::DEBUG_ONLY;
+        else
+            throw std::runtime_error("Invalid ASN constraint check policy: " + check);
+    }
+    result->asnConstraintCheckInterval = 100;
+    if (yaml::HasField(config, "asnConstraintCheckInterval"))
+        result->asnConstraintCheckInterval = yaml::GetInt32(config, "asnConstraintCheckInterval", 1, 1000000);
+
+    if (yaml::HasField(config, "rlc"))
+    {
+        auto rlc = config["rlc"];
+        result->rlc.enabled = true;
+
+        std::string mode = yaml::GetString(rlc, "mode");
+        if (mode == "am")
+            result->rlc.drbMode = rls::ERlcMode::AM;
+        else if (mode == "um")
+            result->rlc.drbMode = rls::ERlcMode::UM;
+        else
+            throw std::runtime_error("Invalid RLC mode: " + mode);
+
+        result->rlc.tickPeriod = yaml::GetInt32(rlc, "tickPeriod", 1, 100);
+        result->rlc.opportunity = yaml::GetInt32(rlc, "opportunity", 256, 16000);
+    }
+
+    if (yaml::HasField(config, "sctp"))
+    {
+        auto sctp = config["sctp"];
+        if (yaml::HasField(sctp, "inStreams"))
+            result->sctp.inStreams = yaml::GetInt32(sctp, "inStreams", 1, 65535);
+        if (yaml::HasField(sctp, "outStreams"))
+            result->sctp.outStreams = yaml::GetInt32(sctp, "outStreams", 1, 65535);
+        if (yaml::HasField(sctp, "noDelay"))
+            result->sctp.noDelay = yaml::GetBool(sctp, "noDelay");
+        if (yaml::HasField(sctp, "sendBufferSize"))
+            result->sctp.sendBufferSize = yaml::GetInt32(sctp, "sendBufferSize", 0, 64 * 1024 * 1024);
+        if (yaml::HasField(sctp, "receiveBufferSize"))
+            result->sctp.receiveBufferSize = yaml::GetInt32(sctp, "receiveBufferSize", 0, 64 * 1024 * 1024);
+    }
     result->pagingDrx = EPagingDrx::V128;
     result->name = "UERANSIM-gnb-" + std::to_string(result->plmn.mcc) + "-" + std::to_string(result->plmn.mnc) + "-" +
                    std::to_string(result->getGnbId()); // NOTE: Avoid using "/" dir separator character.
@@ -78,6 +135,38 @@ static nr::gnb::GnbConfig *ReadConfigYaml()
         result->nssai.slices.push_back(s);
     }
 
+    if (yaml::HasField(config, "capture"))
+    {
+        auto cap = config["capture"];
+        result->capture.enabled = true;
+        result->capture.directory = yaml::GetString(cap, "directory", 1, 1024);
+
+        for (auto &itf : yaml::GetSequence(cap, "interfaces"))
+        {
+            capture::EInterface value{};
+            if (!capture::ParseInterface(itf.as<std::string>(), value))
+                throw std::runtime_error("Invalid capture interface: " + itf.as<std::string>());
+            result->capture.interfaces |= 1u << static_cast<int>(value);
+        }
+
+        result->capture.snapLength = 1600;
+        if (yaml::HasField(cap, "snapLength"))
+            result->capture.snapLength = yaml::GetInt32(cap, "snapLength", 64, 9000);
+        result->capture.fileSize = 64ll * 1024 * 1024;
+        if (yaml::HasField(cap, "fileSizeMb"))
+            result->capture.fileSize = yaml::GetInt32(cap, "fileSizeMb", 1, 4096) * 1024ll * 1024;
+        result->capture.fileCount = 8;
+        if (yaml::HasField(cap, "fileCount"))
+            result->capture.fileCount = yaml::GetInt32(cap, "fileCount", 1, 1000);
+
+        if (yaml::HasField(cap, "filter"))
+        {
+            std::string error{};
+            if (!capture::ParseFilter(yaml::GetString(cap, "filter"), result->capture.filter, error))
+                throw std::runtime_error("Invalid capture filter: " + error);
+        }
+    }
+
     return result;
 }
 
@@ -90,19 +179,35 @@ static void ReadOptions(int argc, char **argv)
     opt::OptionItem itemConfigFile = {'c', "config", "Use specified configuration file for gNB", "config-file"};
     opt::OptionItem itemDisableCmd = {'l', "disable-cmd", "Disable command line functionality for this instance",
                                       std::nullopt};
+    opt::OptionItem itemVirtualTime = {std::nullopt, "virtual-time",
+                                       "Fast-forward the timers while all nodes are idle, for long-running load tests",
+                                       std::nullopt};
+    opt::OptionItem itemTrace = {std::nullopt, "trace",
+                                 "Trace the procedures of the UEs into given Chrome trace-event file", "file"};
 
     desc.items.push_back(itemConfigFile);
     desc.items.push_back(itemDisableCmd);
+    desc.items.push_back(itemVirtualTime);
+    desc.items.push_back(itemTrace);
 
     opt::OptionsResult opt{argc, argv, desc, false, nullptr};
 
     if (opt.hasFlag(itemDisableCmd))
         g_options.disableCmd = true;
+    g_options.virtualTime = opt.hasFlag(itemVirtualTime);
     g_options.configFile = opt.getOption(itemConfigFile);
+    if (opt.hasFlag(itemTrace))
+        g_options.traceFile = opt.getOption(itemTrace);
 
     try
     {
         g_refConfig = ReadConfigYaml();
+        if (g_refConfig->capture.enabled)
+            capture::Start(g_refConfig->capture, g_refConfig->name);
+        if (g_options.traceFile.has_value())
+            trace::Start(*g_options.traceFile, g_refConfig->name);
+        if (g_options.virtualTime)
+            utils::EnableVirtualTime();
     }
     catch (const std::runtime_error &e)
     {
@@ -14,6 +14,7 @@
 #include <gnb/rls/task.hpp>
 #include <gnb/rrc/task.hpp>
 #include <gnb/sctp/task.hpp>
+#include <lib/trace/trace.hpp>
 #include <utils/common.hpp>
 #include <utils/printer.hpp>
 
@@ -127,16 +128,24 @@ void GnbCmdHandler::handleCmdImpl(NmGnbCliCommand &msg)
         break;
     }
     case app::GnbCliCommand::UE_LIST: {
-        Json json = Json::Arr({});
+        // The list is sent while it is being written, since it may be too large for one response
+        app::CliChunkWriter output{msg.address, app::CliMessage::Type::RESULT, [this](app::CliMessage &&part) {
+            m_base->cliCallbackTask->push(std::make_unique<app::NwCliSendResponse>(std::move(part)));
+        }};
+        JsonWriter writer{JsonWriter::Format::YAML, [&output](std::string &&piece) { output.write(piece); },
+                          app::CliMessage::MAX_CHUNK_SIZE};
+        writer.beginArray();
         for (auto &ue : m_base->ngapTask->m_ueCtx)
         {
-            json.push(Json::Obj({
+            writer.value(Json::Obj({
                 {"ue-id", ue.first},
                 {"ran-ngap-id", ue.second->ranUeNgapId},
                 {"amf-ngap-id", ue.second->amfUeNgapId},
             }));
         }
-        sendResult(msg.address, json.dumpYaml());
+        writer.end();
+        writer.flush();
+        output.finish();
         break;
     }
     case app::GnbCliCommand::UE_COUNT: {
@@ -154,6 +163,17 @@ void GnbCmdHandler::handleCmdImpl(NmGnbCliCommand &msg)
         }
         break;
     }
+    case app::GnbCliCommand::NGAP_STATS: {
+        sendResult(msg.address, ToJson(m_base->ngapTask->m_statistics).dumpYaml());
+        break;
+    }
+    case app::GnbCliCommand::TRACE_STATS: {
+        if (!trace::IsEnabled())
+            sendError(msg.address, "Tracing is not enabled, see the --trace option");
+        else
+            sendResult(msg.address, trace::Statistics().dumpYaml());
+        break;
+    }
     }
 }
 
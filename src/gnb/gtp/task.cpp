@@ -10,6 +10,7 @@
 
 #include <gnb/gtp/proto.hpp>
 #include <gnb/rls/task.hpp>
+#include <lib/capture/capture.hpp>
 #include <utils/constants.hpp>
 #include <utils/libc_error.hpp>
 
@@ -215,7 +216,11 @@ void GtpTask::handleUplinkData(int ueId, int psi, OctetString &&pdu)
         if (!gtp::EncodeGtpMessage(gtp, gtpPdu))
             m_logger->err("Uplink data failure, GTP encoding failed");
         else
+        {
+            capture::Tap(capture::EInterface::GTP_U, capture::EDirection::OUTBOUND, gtpPdu.data(),
+                         static_cast<size_t>(gtpPdu.length()), ueId, gtp.teid);
             m_udpServer->send(InetAddress(pduSession->upTunnel.address, cons::GtpPort), gtpPdu);
+        }
     }
 }
 
@@ -225,6 +230,11 @@ void GtpTask::handleUdpReceive(const udp::NwUdpServerReceive &msg)
     auto gtp = gtp::DecodeGtpMessage(buffer);
 
     auto sessionInd = m_sessionTree.findByDownTeid(gtp->teid);
+
+    // Packets of unknown TEIDs are captured as well
+    capture::Tap(capture::EInterface::GTP_U, capture::EDirection::INBOUND, msg.packet.data(),
+                 static_cast<size_t>(msg.packet.length()), sessionInd == 0 ? 0 : GetUeId(sessionInd), gtp->teid);
+
     if (sessionInd == 0)
     {
         m_logger->err("TEID %d not found on GTP-U Downlink", gtp->teid);
@@ -12,6 +12,7 @@
 
 #include <gnb/gtp/task.hpp>
 #include <gnb/rrc/task.hpp>
+#include <lib/trace/trace.hpp>
 
 #include <asn/ngap/ASN_NGAP_AMF-UE-NGAP-ID.h>
 #include <asn/ngap/ASN_NGAP_AssociatedQosFlowItem.h>
@@ -64,6 +65,10 @@ void NgapTask::receiveInitialContextSetup(int amfId, ASN_NGAP_InitialContextSetu
     if (ue == nullptr)
         return;
 
+    trace::Hop("NGAP DL", ue->ctxId, "Initial Context Setup Request");
+    trace::End(trace::EProcedure::INITIAL_CONTEXT_SETUP, ue->ctxId, true);
+    trace::End(trace::EProcedure::AMF_RESPONSE, ue->ctxId, true);
+
     auto w = std::make_unique<NmGnbNgapToGtp>(NmGnbNgapToGtp::UE_CONTEXT_UPDATE);
     w->update = std::make_unique<GtpUeContextUpdate>(true, ue->ctxId, ue->ueAmbr);
     m_base->gtpTask->push(std::move(w));
@@ -0,0 +1,82 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "decoder.hpp"
+#include "encode.hpp"
+#include "task.hpp"
+#include "utils.hpp"
+
+#include <lib/asn/ngap_fast.hpp>
+
+#include <asn/ngap/ASN_NGAP_NGAP-PDU.h>
+#include <asn/ngap/ASN_NGAP_ProcedureCode.h>
+
+namespace nr::gnb
+{
+
+NgapDecoderTask::NgapDecoderTask(TaskBase *base, int index) : m_ngapTask{}
+{
+    m_logger = base->logBase->makeUniqueLogger("ngap-dec" + std::to_string(index));
+}
+
+void NgapDecoderTask::initialize(NgapTask *ngapTask)
+{
+    m_ngapTask = ngapTask;
+}
+
+void NgapDecoderTask::onStart()
+{
+}
+
+void NgapDecoderTask::onLoop()
+{
+    auto msg = take();
+    if (!msg)
+        return;
+
+    if (msg->msgType != NtsMessageType::GNB_SCTP)
+    {
+        m_logger->unhandledNts(*msg);
+        return;
+    }
+
+    auto &w = dynamic_cast<NmGnbSctp &>(*msg);
+    if (w.present != NmGnbSctp::RECEIVE_MESSAGE)
+    {
+        m_logger->unhandledNts(*msg);
+        return;
+    }
+
+    // Downlink NAS transport is handed to the fast path of the NGAP task with the result of the fast decoder
+    asn::ngap::fast::NasTransportInfo info{};
+    if (asn::ngap::fast::DecodeNasTransport(w.buffer.data(), w.buffer.size(), info) &&
+        info.procedureCode == ASN_NGAP_ProcedureCode_id_DownlinkNASTransport)
+    {
+        w.nasTransport = info;
+    }
+    else
+    {
+        auto *pdu =
+            ngap_encode::Decode<ASN_NGAP_NGAP_PDU>(asn_DEF_ASN_NGAP_NGAP_PDU, w.buffer.data(), w.buffer.size());
+        if (pdu != nullptr)
+        {
+            w.pdu = asn::WrapUnique(pdu, asn_DEF_ASN_NGAP_NGAP_PDU);
+            w.ueIds = ngap_utils::FindUeIdsInPdu(*pdu);
+        }
+        w.isDecoded = true;
+    }
+
+    // The same message object is forwarded to the NGAP task, no need to copy the buffer
+    m_ngapTask->push(std::move(msg));
+}
+
+void NgapDecoderTask::onQuit()
+{
+}
+
+} // namespace nr::gnb
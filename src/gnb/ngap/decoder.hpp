@@ -0,0 +1,46 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <memory>
+
+#include <gnb/nts.hpp>
+#include <gnb/types.hpp>
+#include <utils/logger.hpp>
+#include <utils/nts.hpp>
+
+namespace nr::gnb
+{
+
+class NgapTask;
+
+/*
+ * Decodes received NGAP PDUs off the NGAP task's thread. The SCTP task selects the decoder by stream number,
+ * and all UE-associated signalling of a UE uses the same stream, so per-UE message order is preserved.
+ */
+class NgapDecoderTask : public NtsTask
+{
+  private:
+    std::unique_ptr<Logger> m_logger;
+    NgapTask *m_ngapTask;
+
+  public:
+    explicit NgapDecoderTask(TaskBase *base, int index);
+    ~NgapDecoderTask() override = default;
+
+  protected:
+    void onStart() override;
+    void onLoop() override;
+    void onQuit() override;
+
+  public:
+    void initialize(NgapTask *ngapTask);
+};
+
+} // namespace nr::gnb
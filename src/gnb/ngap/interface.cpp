@@ -84,6 +84,11 @@ void NgapTask::handleAssociationSetup(int amfId, int ascId, int inCount, int out
         amf->association.inStreams = inCount;
         amf->association.outStreams = outCount;
 
+        // The UE contexts of a previous association are not carried over. The loads are not copied from one instance,
+        // so that each stream gets a sent counter of its own.
+        amf->streamLoads.clear();
+        amf->streamLoads.resize(static_cast<size_t>(std::max(outCount, 1)));
+
         sendNgSetupRequest(amf->ctxId);
     }
 }
@@ -354,7 +359,13 @@ void NgapTask::receiveOverloadStop(int amfId, ASN_NGAP_OverloadStop *msg)
 {
     m_logger->debug("AMF overload stop received");
 
-    // TODO
+    auto *amf = findAmfContext(amfId);
+    if (amf == nullptr)
+        return;
+
+    // The overload is tracked per AMF, not per slice
+    amf->overloadInfo = {};
+    amf->overloadInfo.status = EOverloadStatus::NOT_OVERLOADED;
 }
 
 } // namespace nr::gnb
\ No newline at end of file
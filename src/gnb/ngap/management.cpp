@@ -8,6 +8,7 @@
 
 #include "task.hpp"
 
+#include <lib/trace/trace.hpp>
 #include <utils/common.hpp>
 
 namespace nr::gnb
@@ -33,7 +34,7 @@ void NgapTask::createAmfContext(const GnbAmfConfig &conf)
     m_amfCtx[ctx->ctxId] = ctx;
 }
 
-void NgapTask::createUeContext(int ueId)
+void NgapTask::createUeContext(int ueId, const std::optional<GutiMobileIdentity> &sTmsi)
 {
     auto *ctx = new NgapUeContext(ueId);
     ctx->amfUeNgapId = -1;
@@ -42,11 +43,14 @@ void NgapTask::createUeContext(int ueId)
     m_ueCtx[ctx->ctxId] = ctx;
 
     // Perform AMF selection
-    auto *amf = selectAmf(ueId);
+    auto *amf = selectAmf(ueId, sTmsi);
     if (amf == nullptr)
         m_logger->err("AMF selection for UE[%d] failed. Could not find a suitable AMF.", ueId);
     else
+    {
         ctx->associatedAmfId = amf->ctxId;
+        amf->ueCount++;
+    }
 }
 
 NgapUeContext *NgapTask::findUeContext(int ctxId)
@@ -72,7 +76,7 @@ NgapUeContext *NgapTask::findUeByRanId(int64_t ranUeNgapId)
 
 NgapUeContext *NgapTask::findUeByAmfId(int64_t amfUeNgapId)
 {
-    if (amfUeNgapId <= 0)
+    if (amfUeNgapId < 0)
         return nullptr;
     // TODO: optimize
     for (auto &ue : m_ueCtx)
@@ -139,9 +143,41 @@ void NgapTask::deleteUeContext(int ueId)
     auto *ue = m_ueCtx[ueId];
     if (ue)
     {
+        // The AMF context may have been deleted before, or re-associated with fewer streams
+        auto amf = m_amfCtx.find(ue->associatedAmfId);
+        if (amf != m_amfCtx.end() && amf->second != nullptr)
+        {
+            if (amf->second->ueCount > 0)
+                amf->second->ueCount--;
+            if (static_cast<size_t>(ue->uplinkStream) < amf->second->streamLoads.size() &&
+                amf->second->streamLoads[ue->uplinkStream].ueCount > 0)
+                amf->second->streamLoads[ue->uplinkStream].ueCount--;
+        }
+
         delete ue;
         m_ueCtx.erase(ueId);
     }
+
+    trace::End(trace::EProcedure::INITIAL_CONTEXT_SETUP, ueId, false);
+    trace::Discard(trace::EProcedure::AMF_RESPONSE, ueId);
+}
+
+int NgapTask::selectUplinkStream(NgapAmfContext *amf)
+{
+    if (amf->streamLoads.empty())
+        amf->streamLoads.resize(1);
+
+    // Stream 0 is left to non-UE-associated signalling if there are other streams
+    size_t selected = amf->streamLoads.size() > 1 ? 1 : 0;
+    for (size_t i = selected + 1; i < amf->streamLoads.size(); i++)
+    {
+        auto &load = amf->streamLoads[i];
+        auto &selectedLoad = amf->streamLoads[selected];
+        if (load.ueCount < selectedLoad.ueCount ||
+            (load.ueCount == selectedLoad.ueCount && load.outstandingPdus() < selectedLoad.outstandingPdus()))
+            selected = i;
+    }
+    return static_cast<int>(selected);
 }
 
 void NgapTask::deleteAmfContext(int amfId)
@@ -11,15 +11,18 @@
 #include "utils.hpp"
 
 #include <gnb/rrc/task.hpp>
+#include <lib/asn/ngap_fast.hpp>
+#include <lib/asn/ngap_nas.hpp>
+#include <lib/trace/trace.hpp>
 
 #include <asn/ngap/ASN_NGAP_DownlinkNASTransport.h>
 #include <asn/ngap/ASN_NGAP_InitialUEMessage.h>
 #include <asn/ngap/ASN_NGAP_InitiatingMessage.h>
 #include <asn/ngap/ASN_NGAP_NASNonDeliveryIndication.h>
 #include <asn/ngap/ASN_NGAP_NGAP-PDU.h>
+#include <asn/ngap/ASN_NGAP_ProcedureCode.h>
 #include <asn/ngap/ASN_NGAP_ProtocolIE-Field.h>
 #include <asn/ngap/ASN_NGAP_RerouteNASRequest.h>
-#include <asn/ngap/ASN_NGAP_UplinkNASTransport.h>
 
 namespace nr::gnb
 {
@@ -35,7 +38,7 @@ void NgapTask::handleInitialNasTransport(int ueId, const OctetString &nasPdu, in
         return;
     }
 
-    createUeContext(ueId);
+    createUeContext(ueId, sTmsi);
 
     auto *ueCtx = findUeContext(ueId);
     if (ueCtx == nullptr)
@@ -50,53 +53,41 @@ void NgapTask::handleInitialNasTransport(int ueId, const OctetString &nasPdu, in
         return;
     }
 
-    amfCtx->nextStream = (amfCtx->nextStream + 1) % amfCtx->association.outStreams;
-    if ((amfCtx->nextStream == 0) && (amfCtx->association.outStreams > 1))
-        amfCtx->nextStream += 1;
-    ueCtx->uplinkStream = amfCtx->nextStream;
+    ueCtx->uplinkStream = selectUplinkStream(amfCtx);
+    amfCtx->streamLoads[ueCtx->uplinkStream].ueCount++;
 
-    std::vector<ASN_NGAP_InitialUEMessage_IEs *> ies;
-
-    auto *ieEstablishmentCause = asn::New<ASN_NGAP_InitialUEMessage_IEs>();
-    ieEstablishmentCause->id = ASN_NGAP_ProtocolIE_ID_id_RRCEstablishmentCause;
-    ieEstablishmentCause->criticality = ASN_NGAP_Criticality_ignore;
-    ieEstablishmentCause->value.present = ASN_NGAP_InitialUEMessage_IEs__value_PR_RRCEstablishmentCause;
-    ieEstablishmentCause->value.choice.RRCEstablishmentCause = rrcEstablishmentCause;
-    ies.push_back(ieEstablishmentCause);
-
-    auto *ieCtxRequest = asn::New<ASN_NGAP_InitialUEMessage_IEs>();
-    ieCtxRequest->id = ASN_NGAP_ProtocolIE_ID_id_UEContextRequest;
-    ieCtxRequest->criticality = ASN_NGAP_Criticality_ignore;
-    ieCtxRequest->value.present = ASN_NGAP_InitialUEMessage_IEs__value_PR_UEContextRequest;
-    ieCtxRequest->value.choice.UEContextRequest = ASN_NGAP_UEContextRequest_requested;
-    ies.push_back(ieCtxRequest);
-
-    auto *ieNasPdu = asn::New<ASN_NGAP_InitialUEMessage_IEs>();
-    ieNasPdu->id = ASN_NGAP_ProtocolIE_ID_id_NAS_PDU;
-    ieNasPdu->criticality = ASN_NGAP_Criticality_reject;
-    ieNasPdu->value.present = ASN_NGAP_InitialUEMessage_IEs__value_PR_NAS_PDU;
-    asn::SetOctetString(ieNasPdu->value.choice.NAS_PDU, nasPdu);
-    ies.push_back(ieNasPdu);
+    trace::Hop("NGAP UL", ueId, "Initial UE Message");
+    trace::Begin(trace::EProcedure::INITIAL_CONTEXT_SETUP, ueId);
+    trace::Begin(trace::EProcedure::AMF_RESPONSE, ueId);
 
+    std::optional<asn::ngap::fast::FiveGSTmsi> tmsi{};
     if (sTmsi)
+        tmsi = asn::ngap::fast::FiveGSTmsi{sTmsi->amfSetId, sTmsi->amfPointer, sTmsi->tmsi};
+
+    /* Try the hand-specialised encoder first */
     {
-        auto *ieTmsi = asn::New<ASN_NGAP_InitialUEMessage_IEs>();
-        ieTmsi->id = ASN_NGAP_ProtocolIE_ID_id_FiveG_S_TMSI;
-        ieTmsi->criticality = ASN_NGAP_Criticality_reject;
-        ieTmsi->value.present = ASN_NGAP_InitialUEMessage_IEs__value_PR_FiveG_S_TMSI;
-
-        asn::SetBitStringInt<10>(sTmsi->amfSetId, ieTmsi->value.choice.FiveG_S_TMSI.aMFSetID);
-        asn::SetBitStringInt<6>(sTmsi->amfPointer, ieTmsi->value.choice.FiveG_S_TMSI.aMFPointer);
-        asn::SetOctetString4(ieTmsi->value.choice.FiveG_S_TMSI.fiveG_TMSI, sTmsi->tmsi);
-        ies.push_back(ieTmsi);
+        size_t capacity = asn::ngap::fast::NasTransportEncodeBound(nasPdu.length());
+        auto *buffer = new uint8_t[capacity];
+        size_t encoded;
+
+        if (asn::ngap::fast::EncodeInitialUeMessage(ueCtx->ranUeNgapId, nasPdu,
+                                                    ngap_utils::CurrentUserLocation(*m_base->config),
+                                                    rrcEstablishmentCause, tmsi, buffer, capacity, encoded))
+        {
+            sendNgapUeAssociated(ueCtx, amfCtx, UniqueBuffer{buffer, encoded});
+            return;
+        }
+        delete[] buffer;
     }
 
-    auto *pdu = asn::ngap::NewMessagePdu<ASN_NGAP_InitialUEMessage>(ies);
-    sendNgapUeAssociated(ueId, pdu);
+    sendNgapUeAssociated(ueId, asn::ngap::NewInitialUeMessage(nasPdu, rrcEstablishmentCause, tmsi));
 }
 
 void NgapTask::deliverDownlinkNas(int ueId, OctetString &&nasPdu)
 {
+    trace::Hop("NGAP DL", ueId, "Downlink NAS Transport");
+    trace::End(trace::EProcedure::AMF_RESPONSE, ueId, true);
+
     auto w = std::make_unique<NmGnbNgapToRrc>(NmGnbNgapToRrc::NAS_DELIVERY);
     w->ueId = ueId;
     w->pdu = std::move(nasPdu);
@@ -109,14 +100,28 @@ void NgapTask::handleUplinkNasTransport(int ueId, const OctetString &nasPdu)
     if (ue == nullptr)
         return;
 
-    auto *ieNasPdu = asn::New<ASN_NGAP_UplinkNASTransport_IEs>();
-    ieNasPdu->id = ASN_NGAP_ProtocolIE_ID_id_NAS_PDU;
-    ieNasPdu->criticality = ASN_NGAP_Criticality_reject;
-    ieNasPdu->value.present = ASN_NGAP_UplinkNASTransport_IEs__value_PR_NAS_PDU;
-    asn::SetOctetString(ieNasPdu->value.choice.NAS_PDU, nasPdu);
+    trace::Hop("NGAP UL", ueId, "Uplink NAS Transport");
+    trace::Begin(trace::EProcedure::AMF_RESPONSE, ueId);
 
-    auto *pdu = asn::ngap::NewMessagePdu<ASN_NGAP_UplinkNASTransport>({ieNasPdu});
-    sendNgapUeAssociated(ueId, pdu);
+    /* Try the hand-specialised encoder first */
+    auto *amf = findAmfContext(ue->associatedAmfId);
+    if (amf != nullptr && ue->amfUeNgapId != -1)
+    {
+        size_t capacity = asn::ngap::fast::NasTransportEncodeBound(nasPdu.length());
+        auto *buffer = new uint8_t[capacity];
+        size_t encoded;
+
+        if (asn::ngap::fast::EncodeUplinkNasTransport(ue->amfUeNgapId, ue->ranUeNgapId, nasPdu,
+                                                      ngap_utils::CurrentUserLocation(*m_base->config), buffer,
+                                                      capacity, encoded))
+        {
+            sendNgapUeAssociated(ue, amf, UniqueBuffer{buffer, encoded});
+            return;
+        }
+        delete[] buffer;
+    }
+
+    sendNgapUeAssociated(ueId, asn::ngap::NewUplinkNasTransport(nasPdu));
 }
 
 void NgapTask::sendNasNonDeliveryIndication(int ueId, const OctetString &nasPdu, NgapCause cause)
@@ -150,6 +155,25 @@ void NgapTask::receiveDownlinkNasTransport(int amfId, ASN_NGAP_DownlinkNASTransp
         deliverDownlinkNas(ue->ctxId, asn::GetOctetString(ieNasPdu->NAS_PDU));
 }
 
+bool NgapTask::receiveDownlinkNasTransportFast(int amfId, uint16_t stream,
+                                               const asn::ngap::fast::NasTransportInfo &info)
+{
+    if (info.procedureCode != ASN_NGAP_ProcedureCode_id_DownlinkNASTransport || !info.amfUeNgapId ||
+        !info.ranUeNgapId)
+        return false;
+
+    NgapPduUeIds ueIds{};
+    ueIds.idPair = NgapIdPair{info.amfUeNgapId, info.ranUeNgapId};
+
+    if (!handleSctpStreamId(amfId, stream, ueIds))
+        return true;
+
+    auto *ue = findUeByNgapIdPair(amfId, ueIds.idPair);
+    if (ue != nullptr)
+        deliverDownlinkNas(ue->ctxId, OctetString{std::vector<uint8_t>{info.nasPdu, info.nasPdu + info.nasPduLength}});
+    return true;
+}
+
 void NgapTask::receiveRerouteNasRequest(int amfId, ASN_NGAP_RerouteNASRequest *msg)
 {
     m_logger->debug("Reroute NAS request received");
@@ -8,14 +8,92 @@
 
 #include "task.hpp"
 
+#include <algorithm>
+
 namespace nr::gnb
 {
 
-NgapAmfContext *NgapTask::selectAmf(int ueId)
+static bool ServesAmfId(const NgapAmfContext &amf, int amfSetId, int amfPointer)
 {
-    // todo:
+    for (auto *served : amf.servedGuamiList)
+        if (served->guami.amfSetId == amfSetId && served->guami.amfPointer == amfPointer)
+            return true;
+    return false;
+}
+
+static bool SupportsGnb(const NgapAmfContext &amf, const GnbConfig &config)
+{
+    for (auto *support : amf.plmnSupportList)
+    {
+        if (!(support->plmn == config.plmn))
+            continue;
+        if (config.nssai.slices.empty())
+            return true;
+        for (auto &slice : support->sliceSupportList.slices)
+            for (auto &own : config.nssai.slices)
+                if (slice == own)
+                    return true;
+    }
+    return false;
+}
+
+/* Lower is better. Overloaded AMFs and AMFs with zero relative capacity are only used if there is no other choice. */
+static int SelectionRank(const NgapAmfContext &amf)
+{
+    if (amf.overloadInfo.status == EOverloadStatus::OVERLOADED)
+        return 2;
+    if (amf.relativeCapacity == 0)
+        return 1;
+    return 0;
+}
+
+/* Number of UEs per unit of relative capacity after adding one more UE */
+static double SelectionLoad(const NgapAmfContext &amf)
+{
+    double capacity = static_cast<double>(std::max<int64_t>(amf.relativeCapacity, 1));
+    if (amf.overloadInfo.status == EOverloadStatus::OVERLOADED)
+        capacity *= std::max(100 - amf.overloadInfo.indication.loadReductionPerc, 1) / 100.0;
+    return (amf.ueCount + 1) / capacity;
+}
+
+NgapAmfContext *NgapTask::selectAmf(int ueId, const std::optional<GutiMobileIdentity> &sTmsi)
+{
+    // A UE identified by 5G-S-TMSI stays on the AMF that assigned it, unless that AMF is overloaded
+    if (sTmsi.has_value())
+    {
+        for (auto &amf : m_amfCtx)
+        {
+            if (amf.second->state == EAmfState::CONNECTED && SelectionRank(*amf.second) < 2 &&
+                ServesAmfId(*amf.second, sTmsi->amfSetId, sTmsi->amfPointer))
+                return amf.second;
+        }
+    }
+
+    // Otherwise the connected AMF serving the PLMN and slices of the gNB with the lowest load per capacity is selected
+    NgapAmfContext *selected = nullptr;
+    for (auto &amf : m_amfCtx)
+    {
+        auto *candidate = amf.second;
+        if (candidate->state != EAmfState::CONNECTED || !SupportsGnb(*candidate, *m_base->config))
+            continue;
+        if (selected == nullptr)
+        {
+            selected = candidate;
+            continue;
+        }
+
+        int rank = SelectionRank(*candidate), selectedRank = SelectionRank(*selected);
+        double load = SelectionLoad(*candidate), selectedLoad = SelectionLoad(*selected);
+        if (rank < selectedRank || (rank == selectedRank && load < selectedLoad) ||
+            (rank == selectedRank && load == selectedLoad && candidate->ctxId < selected->ctxId))
+            selected = candidate;
+    }
+    if (selected != nullptr)
+        return selected;
+
+    // No suitable AMF, any one is returned so that the failure is reported by the procedure
     for (auto &amf : m_amfCtx)
-        return amf.second; // return the first one
+        return amf.second;
     return nullptr;
 }
 
@@ -7,6 +7,7 @@
 //
 
 #include "task.hpp"
+#include "decoder.hpp"
 
 #include <sstream>
 
@@ -16,13 +17,31 @@
 namespace nr::gnb
 {
 
-NgapTask::NgapTask(TaskBase *base) : m_base{base}, m_ueNgapIdCounter{}, m_downlinkTeidCounter{}, m_isInitialized{}
+NgapTask::NgapTask(TaskBase *base)
+    : m_base{base}, m_ueNgapIdCounter{}, m_downlinkTeidCounter{}, m_isInitialized{}, m_decoders{}, m_statistics{},
+      m_constraintCheckCounter{}
 {
     m_logger = base->logBase->makeUniqueLogger("ngap");
+
+    int decoderCount = base->config->ngapDecoderThreads;
+
+    // Decoders are selected by stream number, so the order is only kept if streams are also checked
+    if (base->config->ignoreStreamIds && decoderCount > 1)
+        decoderCount = 1;
+
+    for (int i = 0; i < decoderCount; i++)
+    {
+        auto *decoder = new NgapDecoderTask(base, i);
+        decoder->initialize(this);
+        m_decoders.push_back(decoder);
+    }
 }
 
 void NgapTask::onStart()
 {
+    for (auto *decoder : m_decoders)
+        decoder->start();
+
     for (auto &amfConfig : m_base->config->amfConfigs)
         createAmfContext(amfConfig);
     if (m_amfCtx.empty())
@@ -38,6 +57,7 @@ void NgapTask::onStart()
         msg->remotePort = amfCtx.second->port;
         msg->ppid = sctp::PayloadProtocolId::NGAP;
         msg->associatedTask = this;
+        msg->receiverTasks = {m_decoders.begin(), m_decoders.end()};
         m_base->sctpTask->push(std::move(msg));
     }
 }
@@ -77,7 +97,11 @@ void NgapTask::onLoop()
             handleAssociationSetup(w.clientId, w.associationId, w.inStreams, w.outStreams);
             break;
         case NmGnbSctp::RECEIVE_MESSAGE:
-            handleSctpMessage(w.clientId, w.stream, w.buffer);
+            if (w.isDecoded)
+                handleNgapPdu(w.clientId, w.stream, w.pdu.get(), w.ueIds);
+            else if (!w.nasTransport.has_value() ||
+                     !receiveDownlinkNasTransportFast(w.clientId, w.stream, *w.nasTransport))
+                handleSctpMessage(w.clientId, w.stream, w.buffer);
             break;
         case NmGnbSctp::ASSOCIATION_SHUTDOWN:
             handleAssociationShutdown(w.clientId);
@@ -97,6 +121,13 @@ void NgapTask::onLoop()
 
 void NgapTask::onQuit()
 {
+    for (auto *decoder : m_decoders)
+    {
+        decoder->quit();
+        delete decoder;
+    }
+    m_decoders.clear();
+
     for (auto &i : m_ueCtx)
         delete i.second;
     for (auto &i : m_amfCtx)
@@ -10,6 +10,7 @@
 
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include <gnb/nts.hpp>
 #include <gnb/types.hpp>
@@ -42,6 +43,7 @@ class SctpTask;
 class GnbRrcTask;
 class GtpTask;
 class GnbAppTask;
+class NgapDecoderTask;
 
 class NgapTask : public NtsTask
 {
@@ -54,6 +56,9 @@ class NgapTask : public NtsTask
     int64_t m_ueNgapIdCounter;
     uint32_t m_downlinkTeidCounter;
     bool m_isInitialized;
+    std::vector<NgapDecoderTask *> m_decoders;
+    NgapStatistics m_statistics;
+    uint64_t m_constraintCheckCounter; // PDUs subject to the ASN constraint check, sampled in SAMPLED mode
 
     friend class GnbCmdHandler;
 
@@ -70,12 +75,13 @@ class NgapTask : public NtsTask
     /* Utility functions */
     void createAmfContext(const GnbAmfConfig &config);
     NgapAmfContext *findAmfContext(int ctxId);
-    void createUeContext(int ueId);
+    void createUeContext(int ueId, const std::optional<GutiMobileIdentity> &sTmsi);
     NgapUeContext *findUeContext(int ctxId);
     NgapUeContext *findUeByRanId(int64_t ranUeNgapId);
     NgapUeContext *findUeByAmfId(int64_t amfUeNgapId);
     NgapUeContext *findUeByNgapIdPair(int amfCtxId, const NgapIdPair &idPair);
     void deleteUeContext(int ueId);
+    int selectUplinkStream(NgapAmfContext *amf);
     void deleteAmfContext(int amfId);
 
     /* Interface management */
@@ -93,14 +99,18 @@ class NgapTask : public NtsTask
     /* Message transport */
     void sendNgapNonUe(int amfId, ASN_NGAP_NGAP_PDU *pdu);
     void sendNgapUeAssociated(int ueId, ASN_NGAP_NGAP_PDU *pdu);
+    void sendNgapUeAssociated(NgapUeContext *ue, NgapAmfContext *amf, UniqueBuffer &&buffer);
     void handleSctpMessage(int amfId, uint16_t stream, const UniqueBuffer &buffer);
-    bool handleSctpStreamId(int amfId, int stream, const ASN_NGAP_NGAP_PDU &pdu);
+    void handleNgapPdu(int amfId, uint16_t stream, ASN_NGAP_NGAP_PDU *pdu, const NgapPduUeIds &ueIds);
+    bool handleSctpStreamId(int amfId, int stream, const NgapPduUeIds &ueIds);
+    bool checkAsnConstraints(ASN_NGAP_NGAP_PDU *pdu);
 
     /* NAS transport */
     void handleInitialNasTransport(int ueId, const OctetString &nasPdu, int64_t rrcEstablishmentCause,
                                    const std::optional<GutiMobileIdentity> &sTmsi);
     void handleUplinkNasTransport(int ueId, const OctetString &nasPdu);
     void receiveDownlinkNasTransport(int amfId, ASN_NGAP_DownlinkNASTransport *msg);
+    bool receiveDownlinkNasTransportFast(int amfId, uint16_t stream, const asn::ngap::fast::NasTransportInfo &info);
     void deliverDownlinkNas(int ueId, OctetString &&nasPdu);
     void sendNasNonDeliveryIndication(int ueId, const OctetString &nasPdu, NgapCause cause);
     void receiveRerouteNasRequest(int amfId, ASN_NGAP_RerouteNASRequest *msg);
@@ -117,7 +127,7 @@ class NgapTask : public NtsTask
     void sendContextRelease(int ueId, NgapCause cause);
 
     /* NAS Node Selection */
-    NgapAmfContext *selectAmf(int ueId);
+    NgapAmfContext *selectAmf(int ueId, const std::optional<GutiMobileIdentity> &sTmsi);
     NgapAmfContext *selectNewAmfForReAllocation(int ueId, int initiatedAmfId, int amfSetId);
 
     /* Radio resource control */
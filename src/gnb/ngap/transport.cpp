@@ -14,72 +14,14 @@
 #include <gnb/nts.hpp>
 #include <gnb/sctp/task.hpp>
 #include <lib/asn/ngap.hpp>
+#include <lib/asn/ngap_nas.hpp>
 #include <lib/asn/utils.hpp>
 
-#include <asn/ngap/ASN_NGAP_AMF-UE-NGAP-ID.h>
 #include <asn/ngap/ASN_NGAP_InitiatingMessage.h>
 #include <asn/ngap/ASN_NGAP_NGAP-PDU.h>
 #include <asn/ngap/ASN_NGAP_ProtocolIE-Field.h>
-#include <asn/ngap/ASN_NGAP_RAN-UE-NGAP-ID.h>
 #include <asn/ngap/ASN_NGAP_SuccessfulOutcome.h>
 #include <asn/ngap/ASN_NGAP_UnsuccessfulOutcome.h>
-#include <asn/ngap/ASN_NGAP_UserLocationInformation.h>
-#include <asn/ngap/ASN_NGAP_UserLocationInformationNR.h>
-
-static e_ASN_NGAP_Criticality FindCriticalityOfUserIe(ASN_NGAP_NGAP_PDU *pdu, ASN_NGAP_ProtocolIE_ID_t ieId)
-{
-    auto procedureCode =
-        pdu->present == ASN_NGAP_NGAP_PDU_PR_initiatingMessage   ? pdu->choice.initiatingMessage->procedureCode
-        : pdu->present == ASN_NGAP_NGAP_PDU_PR_successfulOutcome ? pdu->choice.successfulOutcome->procedureCode
-                                                                 : pdu->choice.unsuccessfulOutcome->procedureCode;
-
-    if (ieId == ASN_NGAP_ProtocolIE_ID_id_UserLocationInformation)
-    {
-        return procedureCode == ASN_NGAP_ProcedureCode_id_InitialUEMessage ? ASN_NGAP_Criticality_reject
-                                                                           : ASN_NGAP_Criticality_ignore;
-    }
-
-    if (ieId == ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID || ieId == ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID)
-    {
-        if (procedureCode == ASN_NGAP_ProcedureCode_id_RerouteNASRequest)
-        {
-            return ieId == ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID ? ASN_NGAP_Criticality_reject
-                                                                    : ASN_NGAP_Criticality_ignore;
-        }
-
-        if (pdu->present == ASN_NGAP_NGAP_PDU_PR_initiatingMessage)
-        {
-            if (procedureCode == ASN_NGAP_ProcedureCode_id_UEContextReleaseRequest ||
-                procedureCode == ASN_NGAP_ProcedureCode_id_HandoverPreparation)
-                return ASN_NGAP_Criticality_reject;
-        }
-
-        if (procedureCode == ASN_NGAP_ProcedureCode_id_PDUSessionResourceNotify ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_PDUSessionResourceModifyIndication ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_RRCInactiveTransitionReport ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_HandoverNotification ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_PathSwitchRequest ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_HandoverCancel ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_UplinkRANStatusTransfer ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_InitialUEMessage ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_DownlinkNASTransport ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_UplinkNASTransport ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_NASNonDeliveryIndication ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_UplinkUEAssociatedNRPPaTransport ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_UplinkNonUEAssociatedNRPPaTransport ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_CellTrafficTrace ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_TraceStart ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_DeactivateTrace ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_TraceFailureIndication ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_LocationReport ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_LocationReportingControl ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_LocationReportingFailureIndication ||
-            procedureCode == ASN_NGAP_ProcedureCode_id_UERadioCapabilityInfoIndication)
-            return ASN_NGAP_Criticality_reject;
-    }
-
-    return ASN_NGAP_Criticality_ignore;
-}
 
 namespace nr::gnb
 {
@@ -93,12 +35,8 @@ void NgapTask::sendNgapNonUe(int associatedAmf, ASN_NGAP_NGAP_PDU *pdu)
         return;
     }
 
-    char errorBuffer[1024];
-    size_t len;
-
-    if (asn_check_constraints(&asn_DEF_ASN_NGAP_NGAP_PDU, pdu, errorBuffer, &len) != 0)
+    if (!checkAsnConstraints(pdu))
     {
-        m_logger->err("NGAP PDU ASN constraint validation failed");
         asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
         return;
     }
@@ -106,7 +44,10 @@ void NgapTask::sendNgapNonUe(int associatedAmf, ASN_NGAP_NGAP_PDU *pdu)
     ssize_t encoded;
     uint8_t *buffer;
     if (!ngap_encode::Encode(asn_DEF_ASN_NGAP_NGAP_PDU, pdu, encoded, buffer))
+    {
         m_logger->err("NGAP APER encoding failed");
+        m_statistics.encodingFailures++;
+    }
     else
     {
         auto msg = std::make_unique<NmGnbSctp>(NmGnbSctp::SEND_MESSAGE);
@@ -114,6 +55,7 @@ void NgapTask::sendNgapNonUe(int associatedAmf, ASN_NGAP_NGAP_PDU *pdu)
         msg->stream = 0;
         msg->buffer = UniqueBuffer{buffer, static_cast<size_t>(encoded)};
         m_base->sctpTask->push(std::move(msg));
+        m_statistics.sentPdus++;
     }
 
     asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
@@ -138,48 +80,15 @@ void NgapTask::sendNgapUeAssociated(int ueId, ASN_NGAP_NGAP_PDU *pdu)
     }
 
     /* Insert UE-related information elements */
-    {
-        if (ue->amfUeNgapId > 0)
-        {
-            asn::ngap::AddProtocolIeIfUsable(
-                *pdu, asn_DEF_ASN_NGAP_AMF_UE_NGAP_ID, ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID,
-                FindCriticalityOfUserIe(pdu, ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID), [ue](void *mem) {
-                    auto &id = *reinterpret_cast<ASN_NGAP_AMF_UE_NGAP_ID_t *>(mem);
-                    asn::SetSigned64(ue->amfUeNgapId, id);
-                });
-        }
-
-        asn::ngap::AddProtocolIeIfUsable(
-            *pdu, asn_DEF_ASN_NGAP_RAN_UE_NGAP_ID, ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID,
-            FindCriticalityOfUserIe(pdu, ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID),
-            [ue](void *mem) { *reinterpret_cast<ASN_NGAP_RAN_UE_NGAP_ID_t *>(mem) = ue->ranUeNgapId; });
-
-        asn::ngap::AddProtocolIeIfUsable(
-            *pdu, asn_DEF_ASN_NGAP_UserLocationInformation, ASN_NGAP_ProtocolIE_ID_id_UserLocationInformation,
-            FindCriticalityOfUserIe(pdu, ASN_NGAP_ProtocolIE_ID_id_UserLocationInformation), [this](void *mem) {
-                auto *loc = reinterpret_cast<ASN_NGAP_UserLocationInformation *>(mem);
-                loc->present = ASN_NGAP_UserLocationInformation_PR_userLocationInformationNR;
-                loc->choice.userLocationInformationNR = asn::New<ASN_NGAP_UserLocationInformationNR>();
-
-                auto &nr = loc->choice.userLocationInformationNR;
-                nr->timeStamp = asn::New<ASN_NGAP_TimeStamp_t>();
-
-                ngap_utils::ToPlmnAsn_Ref(m_base->config->plmn, nr->nR_CGI.pLMNIdentity);
-                asn::SetBitStringLong<36>(m_base->config->nci, nr->nR_CGI.nRCellIdentity);
-                ngap_utils::ToPlmnAsn_Ref(m_base->config->plmn, nr->tAI.pLMNIdentity);
-                asn::SetOctetString3(nr->tAI.tAC, octet3{m_base->config->tac});
-                asn::SetOctetString4(*nr->timeStamp, octet4{utils::CurrentTimeStamp().seconds32()});
-            });
-    }
+    std::optional<int64_t> amfUeNgapId{};
+    if (ue->amfUeNgapId != -1)
+        amfUeNgapId = ue->amfUeNgapId;
+    asn::ngap::AddUeAssociatedIes(*pdu, amfUeNgapId, ue->ranUeNgapId, ngap_utils::CurrentUserLocation(*m_base->config));
 
     /* Encode and send the PDU */
 
-    char errorBuffer[1024];
-    size_t len;
-
-    if (asn_check_constraints(&asn_DEF_ASN_NGAP_NGAP_PDU, pdu, errorBuffer, &len) != 0)
+    if (!checkAsnConstraints(pdu))
     {
-        m_logger->err("NGAP PDU ASN constraint validation failed");
         asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
         return;
     }
@@ -187,17 +96,62 @@ void NgapTask::sendNgapUeAssociated(int ueId, ASN_NGAP_NGAP_PDU *pdu)
     ssize_t encoded;
     uint8_t *buffer;
     if (!ngap_encode::Encode(asn_DEF_ASN_NGAP_NGAP_PDU, pdu, encoded, buffer))
+    {
         m_logger->err("NGAP APER encoding failed");
+        m_statistics.encodingFailures++;
+    }
     else
+        sendNgapUeAssociated(ue, amf, UniqueBuffer{buffer, static_cast<size_t>(encoded)});
+
+    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+}
+
+void NgapTask::sendNgapUeAssociated(NgapUeContext *ue, NgapAmfContext *amf, UniqueBuffer &&buffer)
+{
+    auto msg = std::make_unique<NmGnbSctp>(NmGnbSctp::SEND_MESSAGE);
+    msg->clientId = amf->ctxId;
+    msg->stream = ue->uplinkStream;
+    msg->buffer = std::move(buffer);
+    if (static_cast<size_t>(ue->uplinkStream) < amf->streamLoads.size())
     {
-        auto msg = std::make_unique<NmGnbSctp>(NmGnbSctp::SEND_MESSAGE);
-        msg->clientId = amf->ctxId;
-        msg->stream = ue->uplinkStream;
-        msg->buffer = UniqueBuffer{buffer, static_cast<size_t>(encoded)};
-        m_base->sctpTask->push(std::move(msg));
+        auto &load = amf->streamLoads[ue->uplinkStream];
+        load.queuedPdus++;
+        msg->sentCounter = load.sentPdus;
     }
+    m_base->sctpTask->push(std::move(msg));
+    m_statistics.sentPdus++;
+}
 
-    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+bool NgapTask::checkAsnConstraints(ASN_NGAP_NGAP_PDU *pdu)
+{
+    switch (m_base->config->asnConstraintCheck)
+    {
+    case EAsnConstraintCheck::ALWAYS:
+        break;
+    case EAsnConstraintCheck::SAMPLED:
+        // Counted separately from the sent PDUs, which also include the ones built without an ASN structure
+        if (m_constraintCheckCounter++ % static_cast<uint64_t>(m_base->config->asnConstraintCheckInterval) != 0)
+            return true;
+        break;
+    case EAsnConstraintCheck::DEBUG_ONLY:
+#ifdef NDEBUG
+        return true;
+#else
+        break;
+#endif
+    }
+
+    char errorBuffer[1024];
+    size_t len = sizeof(errorBuffer);
+
+    m_statistics.constraintChecks++;
+    if (asn_check_constraints(&asn_DEF_ASN_NGAP_NGAP_PDU, pdu, errorBuffer, &len) != 0)
+    {
+        m_logger->err("NGAP PDU ASN constraint validation failed");
+        m_statistics.constraintViolations++;
+        return false;
+    }
+    return true;
 }
 
 void NgapTask::handleSctpMessage(int amfId, uint16_t stream, const UniqueBuffer &buffer)
@@ -206,21 +160,38 @@ void NgapTask::handleSctpMessage(int amfId, uint16_t stream, const UniqueBuffer
     if (amf == nullptr)
         return;
 
+    asn::ngap::fast::NasTransportInfo info{};
+    if (asn::ngap::fast::DecodeNasTransport(buffer.data(), buffer.size(), info) &&
+        receiveDownlinkNasTransportFast(amfId, stream, info))
+        return;
+
     auto *pdu = ngap_encode::Decode<ASN_NGAP_NGAP_PDU>(asn_DEF_ASN_NGAP_NGAP_PDU, buffer.data(), buffer.size());
     if (pdu == nullptr)
     {
-        m_logger->err("APER decoding failed for SCTP message");
-        asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
-        sendErrorIndication(amfId, NgapCause::Protocol_transfer_syntax_error);
+        handleNgapPdu(amfId, stream, nullptr, {});
         return;
     }
 
-    if (!handleSctpStreamId(amf->ctxId, stream, *pdu))
+    handleNgapPdu(amfId, stream, pdu, ngap_utils::FindUeIdsInPdu(*pdu));
+    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+}
+
+void NgapTask::handleNgapPdu(int amfId, uint16_t stream, ASN_NGAP_NGAP_PDU *pdu, const NgapPduUeIds &ueIds)
+{
+    auto *amf = findAmfContext(amfId);
+    if (amf == nullptr)
+        return;
+
+    if (pdu == nullptr)
     {
-        asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
+        m_logger->err("APER decoding failed for SCTP message");
+        sendErrorIndication(amfId, NgapCause::Protocol_transfer_syntax_error);
         return;
     }
 
+    if (!handleSctpStreamId(amf->ctxId, stream, ueIds))
+        return;
+
     if (pdu->present == ASN_NGAP_NGAP_PDU_PR_initiatingMessage)
     {
         auto value = pdu->choice.initiatingMessage->value;
@@ -297,18 +268,14 @@ void NgapTask::handleSctpMessage(int amfId, uint16_t stream, const UniqueBuffer
     {
         m_logger->warn("Empty NGAP PDU ignored");
     }
-
-    asn::Free(asn_DEF_ASN_NGAP_NGAP_PDU, pdu);
 }
 
-bool NgapTask::handleSctpStreamId(int amfId, int stream, const ASN_NGAP_NGAP_PDU &pdu)
+bool NgapTask::handleSctpStreamId(int amfId, int stream, const NgapPduUeIds &ueIds)
 {
     if (m_base->config->ignoreStreamIds)
         return true;
 
-    auto *ptr =
-        asn::ngap::FindProtocolIeInPdu(pdu, asn_DEF_ASN_NGAP_UE_NGAP_IDs, ASN_NGAP_ProtocolIE_ID_id_UE_NGAP_IDs);
-    if (ptr != nullptr)
+    if (ueIds.isUeNgapIdsIe || ueIds.idPair.ranUeNgapId.has_value())
     {
         if (stream == 0)
         {
@@ -317,8 +284,8 @@ bool NgapTask::handleSctpStreamId(int amfId, int stream, const ASN_NGAP_NGAP_PDU
             return false;
         }
 
-        auto &ids = *reinterpret_cast<ASN_NGAP_UE_NGAP_IDs *>(ptr);
-        auto *ue = findUeByNgapIdPair(amfId, ngap_utils::FindNgapIdPairFromAsnNgapIds(ids));
+        auto *ue = ueIds.isUeNgapIdsIe ? findUeByNgapIdPair(amfId, ueIds.idPair)
+                                       : findUeByRanId(ueIds.idPair.ranUeNgapId.value());
         if (ue == nullptr)
             return false;
 
@@ -334,40 +301,11 @@ bool NgapTask::handleSctpStreamId(int amfId, int stream, const ASN_NGAP_NGAP_PDU
     }
     else
     {
-        ptr = asn::ngap::FindProtocolIeInPdu(pdu, asn_DEF_ASN_NGAP_RAN_UE_NGAP_ID,
-                                             ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID);
-        if (ptr != nullptr)
-        {
-            if (stream == 0)
-            {
-                m_logger->err("Received stream number == 0 in UE-associated signalling");
-                sendErrorIndication(amfId, NgapCause::Protocol_unspecified);
-                return false;
-            }
-
-            auto id = static_cast<int64_t>(*reinterpret_cast<ASN_NGAP_RAN_UE_NGAP_ID_t *>(ptr));
-            auto *ue = findUeByRanId(id);
-            if (ue == nullptr)
-                return false;
-
-            if (ue->downlinkStream == 0)
-                ue->downlinkStream = stream;
-            else if (ue->downlinkStream != stream)
-            {
-                m_logger->err("received stream number is inconsistent. received %d, expected :%d", stream,
-                              ue->downlinkStream);
-                sendErrorIndication(amfId, NgapCause::Protocol_unspecified);
-                return false;
-            }
-        }
-        else
+        if (stream != 0)
         {
-            if (stream != 0)
-            {
-                m_logger->err("Received stream number != 0 in non-UE-associated signalling");
-                sendErrorIndication(amfId, NgapCause::Protocol_unspecified);
-                return false;
-            }
+            m_logger->err("Received stream number != 0 in non-UE-associated signalling");
+            sendErrorIndication(amfId, NgapCause::Protocol_unspecified);
+            return false;
         }
     }
 
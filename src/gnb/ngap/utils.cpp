@@ -8,6 +8,10 @@
 
 #include "utils.hpp"
 
+#include <asn/ngap/ASN_NGAP_AMF-UE-NGAP-ID.h>
+#include <asn/ngap/ASN_NGAP_NGAP-PDU.h>
+#include <asn/ngap/ASN_NGAP_RAN-UE-NGAP-ID.h>
+
 namespace nr::gnb::ngap_utils
 {
 
@@ -227,4 +231,40 @@ NgapIdPair FindNgapIdPairFromAsnNgapIds(const ASN_NGAP_UE_NGAP_IDs &ngapIDs)
     return NgapIdPair{amfUeNgapId, ranUeNgapId};
 }
 
-} // namespace nr::gnb::ngap_utils
\ No newline at end of file
+NgapPduUeIds FindUeIdsInPdu(const ASN_NGAP_NGAP_PDU &pdu)
+{
+    NgapPduUeIds res{};
+
+    auto *ptr =
+        asn::ngap::FindProtocolIeInPdu(pdu, asn_DEF_ASN_NGAP_UE_NGAP_IDs, ASN_NGAP_ProtocolIE_ID_id_UE_NGAP_IDs);
+    if (ptr != nullptr)
+    {
+        res.isUeNgapIdsIe = true;
+        res.idPair = FindNgapIdPairFromAsnNgapIds(*reinterpret_cast<ASN_NGAP_UE_NGAP_IDs *>(ptr));
+        return res;
+    }
+
+    ptr = asn::ngap::FindProtocolIeInPdu(pdu, asn_DEF_ASN_NGAP_AMF_UE_NGAP_ID,
+                                         ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID);
+    if (ptr != nullptr)
+        res.idPair.amfUeNgapId = asn::GetSigned64(*reinterpret_cast<ASN_NGAP_AMF_UE_NGAP_ID_t *>(ptr));
+
+    ptr = asn::ngap::FindProtocolIeInPdu(pdu, asn_DEF_ASN_NGAP_RAN_UE_NGAP_ID,
+                                         ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID);
+    if (ptr != nullptr)
+        res.idPair.ranUeNgapId = static_cast<int64_t>(*reinterpret_cast<ASN_NGAP_RAN_UE_NGAP_ID_t *>(ptr));
+
+    return res;
+}
+
+asn::ngap::fast::NrUserLocation CurrentUserLocation(const GnbConfig &config)
+{
+    asn::ngap::fast::NrUserLocation location{};
+    location.plmn = PlmnToOctet3(config.plmn);
+    location.nci = config.nci;
+    location.tac = octet3{config.tac};
+    location.timeStamp = octet4{utils::CurrentTimeStamp().seconds32()};
+    return location;
+}
+
+} // namespace nr::gnb::ngap_utils
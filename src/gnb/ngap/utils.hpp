@@ -10,6 +10,7 @@
 
 #include <gnb/types.hpp>
 #include <lib/asn/ngap.hpp>
+#include <lib/asn/ngap_fast.hpp>
 #include <lib/asn/utils.hpp>
 #include <utils/common.hpp>
 #include <utils/common_types.hpp>
@@ -37,6 +38,10 @@ void ToPlmnAsn_Ref(const Plmn &source, ASN_NGAP_PLMNIdentity_t &target);
 SingleSlice SliceSupportFromAsn(ASN_NGAP_SliceSupportItem &supportItem);
 
 NgapIdPair FindNgapIdPairFromAsnNgapIds(const ASN_NGAP_UE_NGAP_IDs &ngapIDs);
+NgapPduUeIds FindUeIdsInPdu(const ASN_NGAP_NGAP_PDU &pdu);
+
+/* User location of the cell, timestamped now */
+asn::ngap::fast::NrUserLocation CurrentUserLocation(const GnbConfig &config);
 
 template <typename T>
 inline NgapIdPair FindNgapIdPair(T *msg)
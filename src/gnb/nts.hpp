@@ -14,6 +14,7 @@
 
 #include <lib/app/cli_base.hpp>
 #include <lib/app/cli_cmd.hpp>
+#include <lib/asn/ngap_fast.hpp>
 #include <lib/asn/utils.hpp>
 #include <lib/rls/rls_base.hpp>
 #include <lib/rrc/rrc.hpp>
@@ -25,6 +26,7 @@
 
 extern "C"
 {
+    struct ASN_NGAP_NGAP_PDU;
     struct ASN_NGAP_FiveG_S_TMSI;
     struct ASN_NGAP_TAIListForPaging;
 }
@@ -268,6 +270,7 @@ struct NmGnbSctp : NtsMessage
     uint16_t remotePort{};
     sctp::PayloadProtocolId ppid{};
     NtsTask *associatedTask{};
+    std::vector<NtsTask *> receiverTasks{}; // optional, selected by stream number for RECEIVE_MESSAGE
 
     // ASSOCIATION_SETUP
     int associationId{};
@@ -279,6 +282,15 @@ struct NmGnbSctp : NtsMessage
     UniqueBuffer buffer{};
     uint16_t stream{};
 
+    // SEND_MESSAGE
+    std::shared_ptr<std::atomic<uint64_t>> sentCounter{}; // optional, incremented once the message is written
+
+    // RECEIVE_MESSAGE (filled by NGAP decoder tasks)
+    bool isDecoded{};
+    asn::Unique<ASN_NGAP_NGAP_PDU> pdu{};
+    NgapPduUeIds ueIds{};
+    std::optional<asn::ngap::fast::NasTransportInfo> nasTransport{}; // Downlink NAS transport, points into 'buffer'
+
     explicit NmGnbSctp(PR present) : NtsMessage(NtsMessageType::GNB_SCTP), present(present)
     {
     }
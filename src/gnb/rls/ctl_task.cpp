@@ -16,6 +16,7 @@ static constexpr const int MAX_PDU_TTL = 3000;
 
 static constexpr const int TIMER_ID_ACK_CONTROL = 1;
 static constexpr const int TIMER_ID_ACK_SEND = 2;
+static constexpr const int TIMER_ID_RLC_TICK = 3;
 
 static constexpr const int TIMER_PERIOD_ACK_CONTROL = 1500;
 static constexpr const int TIMER_PERIOD_ACK_SEND = 2250;
@@ -24,7 +25,8 @@ namespace nr::gnb
 {
 
 RlsControlTask::RlsControlTask(TaskBase *base, uint64_t sti)
-    : m_sti{sti}, m_mainTask{}, m_udpTask{}, m_pduMap{}, m_pendingAck{}
+    : m_sti{sti}, m_mainTask{}, m_udpTask{}, m_pduMap{}, m_pendingAck{}, m_rlcConfig{base->config->rlc},
+      m_rlcBearers{}, m_rlcBuffer(m_rlcConfig.opportunity)
 {
     m_logger = base->logBase->makeUniqueLogger("rls-ctl");
 }
@@ -39,6 +41,8 @@ void RlsControlTask::onStart()
 {
     setTimer(TIMER_ID_ACK_CONTROL, TIMER_PERIOD_ACK_CONTROL);
     setTimer(TIMER_ID_ACK_SEND, TIMER_PERIOD_ACK_SEND);
+    if (m_rlcConfig.enabled)
+        setTimer(TIMER_ID_RLC_TICK, m_rlcConfig.tickPeriod);
 }
 
 void RlsControlTask::onLoop()
@@ -86,6 +90,11 @@ void RlsControlTask::onLoop()
             setTimer(TIMER_ID_ACK_SEND, TIMER_PERIOD_ACK_SEND);
             onAckSendTimerExpired();
         }
+        else if (w.timerId == TIMER_ID_RLC_TICK)
+        {
+            setTimer(TIMER_ID_RLC_TICK, m_rlcConfig.tickPeriod);
+            onRlcTickTimerExpired();
+        }
         break;
     }
     default:
@@ -107,6 +116,8 @@ void RlsControlTask::handleSignalDetected(int ueId)
 
 void RlsControlTask::handleSignalLost(int ueId)
 {
+    m_rlcBearers.erase(ueId);
+
     auto w = std::make_unique<NmGnbRlsToRls>(NmGnbRlsToRls::SIGNAL_LOST);
     w->ueId = ueId;
     m_mainTask->push(std::move(w));
@@ -136,12 +147,26 @@ void RlsControlTask::handleRlsMessage(int ueId, rls::RlsMessage &msg)
         }
         else if (m.pduType == rls::EPduType::RRC)
         {
+            // A new RRC connection, the UE re-creates its RLC entities at the same point
+            if (static_cast<rrc::RrcChannel>(m.payload) == rrc::RrcChannel::UL_CCCH)
+                m_rlcBearers.erase(ueId);
+
             auto w = std::make_unique<NmGnbRlsToRls>(NmGnbRlsToRls::UPLINK_RRC);
             w->ueId = ueId;
             w->rrcChannel = static_cast<rrc::RrcChannel>(m.payload);
             w->data = std::move(m.pdu);
             m_mainTask->push(std::move(w));
         }
+        else if (m.pduType == rls::EPduType::RLC)
+        {
+            if (!m_rlcConfig.enabled)
+            {
+                m_logger->err("RLC transmission received from UE[%d] but RLC bearers are not configured", ueId);
+                return;
+            }
+            if (!getOrCreateRlcBearers(ueId).receiveTransmission(m.pdu.data(), m.pdu.length()))
+                m_logger->err("Malformed RLC transmission received from UE[%d]", ueId);
+        }
         else
         {
             m_logger->err("Unhandled RLS PDU type");
@@ -161,6 +186,12 @@ void RlsControlTask::handleDownlinkRrcDelivery(int ueId, uint32_t pduId, rrc::Rr
         throw std::runtime_error("");
     }
 
+    if (pduId == 0 && channel == rrc::RrcChannel::DL_DCCH && m_rlcBearers.count(ueId))
+    {
+        m_rlcBearers[ueId]->pushSdu(rls::LCID_SRB1, data.data(), data.length());
+        return;
+    }
+
     if (pduId != 0)
     {
         if (m_pduMap.count(pduId))
@@ -200,6 +231,12 @@ void RlsControlTask::handleDownlinkRrcDelivery(int ueId, uint32_t pduId, rrc::Rr
 
 void RlsControlTask::handleDownlinkDataDelivery(int ueId, int psi, OctetString &&data)
 {
+    if (m_rlcBearers.count(ueId))
+    {
+        m_rlcBearers[ueId]->pushSdu(rls::LCID_DRB_BASE + psi, data.data(), data.length());
+        return;
+    }
+
     rls::RlsPduTransmission msg{m_sti};
     msg.pduType = rls::EPduType::DATA;
     msg.pdu = std::move(data);
@@ -254,4 +291,67 @@ void RlsControlTask::onAckSendTimerExpired()
     }
 }
 
+rls::RlcBearerSet &RlsControlTask::getOrCreateRlcBearers(int ueId)
+{
+    // The bearers of a UE are created with the first RLC transmission of the UE, therefore UEs without RLC
+    // configuration can still use the plain RLS transmissions.
+    auto &bearers = m_rlcBearers[ueId];
+    if (bearers == nullptr)
+    {
+        auto onSdu = [this, ueId](int lcid, const uint8_t *data, size_t size) { handleRlcSdu(ueId, lcid, data, size); };
+        auto onFailure = [this, ueId](int lcid) {
+            m_logger->err("UE[%d] maximum number of RLC retransmissions reached on LCID %d", ueId, lcid);
+
+            auto w = std::make_unique<NmGnbRlsToRls>(NmGnbRlsToRls::RADIO_LINK_FAILURE);
+            w->ueId = ueId;
+            w->rlfCause = rls::ERlfCause::RLC_MAX_RETRANSMISSION;
+            m_mainTask->push(std::move(w));
+        };
+        bearers = std::make_unique<rls::RlcBearerSet>(m_rlcConfig, onSdu, onFailure);
+    }
+    return *bearers;
+}
+
+void RlsControlTask::handleRlcSdu(int ueId, int lcid, const uint8_t *data, size_t size)
+{
+    if (lcid == rls::LCID_SRB1)
+    {
+        auto w = std::make_unique<NmGnbRlsToRls>(NmGnbRlsToRls::UPLINK_RRC);
+        w->ueId = ueId;
+        w->rrcChannel = rrc::RrcChannel::UL_DCCH;
+        w->data = OctetString::FromArray(data, size);
+        m_mainTask->push(std::move(w));
+    }
+    else
+    {
+        auto w = std::make_unique<NmGnbRlsToRls>(NmGnbRlsToRls::UPLINK_DATA);
+        w->ueId = ueId;
+        w->psi = lcid - rls::LCID_DRB_BASE;
+        w->data = OctetString::FromArray(data, size);
+        m_mainTask->push(std::move(w));
+    }
+}
+
+void RlsControlTask::onRlcTickTimerExpired()
+{
+    int64_t current = utils::CurrentTimeMillis();
+
+    for (auto &item : m_rlcBearers)
+    {
+        item.second->timerCycle(current);
+
+        size_t n = item.second->createTransmission(m_rlcBuffer.data(), m_rlcBuffer.size());
+        if (n == 0)
+            continue;
+
+        rls::RlsPduTransmission msg{m_sti};
+        msg.pduType = rls::EPduType::RLC;
+        msg.pdu = OctetString::FromArray(m_rlcBuffer.data(), n);
+        msg.payload = 0;
+        msg.pduId = 0;
+
+        m_udpTask->send(item.first, msg);
+    }
+}
+
 } // namespace nr::gnb
@@ -12,6 +12,7 @@
 
 #include <gnb/nts.hpp>
 #include <gnb/types.hpp>
+#include <lib/rls/rls_rlc.hpp>
 #include <utils/nts.hpp>
 
 namespace nr::gnb
@@ -26,6 +27,9 @@ class RlsControlTask : public NtsTask
     RlsUdpTask *m_udpTask;
     std::unordered_map<uint32_t, rls::PduInfo> m_pduMap;
     std::unordered_map<int, std::vector<uint32_t>> m_pendingAck;
+    rls::RlcBearerConfig m_rlcConfig;
+    std::unordered_map<int, std::unique_ptr<rls::RlcBearerSet>> m_rlcBearers;
+    std::vector<uint8_t> m_rlcBuffer;
 
   public:
     explicit RlsControlTask(TaskBase *base, uint64_t sti);
@@ -47,6 +51,9 @@ class RlsControlTask : public NtsTask
     void handleDownlinkDataDelivery(int ueId, int psi, OctetString &&data);
     void onAckControlTimerExpired();
     void onAckSendTimerExpired();
+    void onRlcTickTimerExpired();
+    rls::RlcBearerSet &getOrCreateRlcBearers(int ueId);
+    void handleRlcSdu(int ueId, int lcid, const uint8_t *data, size_t size);
 };
 
 } // namespace nr::gnb
\ No newline at end of file
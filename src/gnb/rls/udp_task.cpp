@@ -14,6 +14,8 @@
 #include <set>
 
 #include <gnb/nts.hpp>
+#include <lib/capture/capture.hpp>
+#include <lib/trace/trace.hpp>
 #include <utils/common.hpp>
 #include <utils/constants.hpp>
 #include <utils/libc_error.hpp>
@@ -43,7 +45,7 @@ namespace nr::gnb
 
 RlsUdpTask::RlsUdpTask(TaskBase *base, uint64_t sti, Vector3 phyLocation)
     : m_server{}, m_ctlTask{}, m_sti{sti}, m_phyLocation{phyLocation}, m_lastLoop{}, m_stiToUe{}, m_ueMap{},
-      m_newIdCounter{}
+      m_newIdCounter{}, m_sendBuffer(BUFFER_SIZE)
 {
     m_logger = base->logBase->makeUniqueLogger("rls-udp");
 
@@ -80,9 +82,18 @@ void RlsUdpTask::onLoop()
     {
         auto rlsMsg = rls::DecodeRlsMessage(OctetView{buffer, static_cast<size_t>(size)});
         if (rlsMsg == nullptr)
+        {
             m_logger->err("Unable to decode RLS message");
-        else
-            receiveRlsPdu(peerAddress, std::move(rlsMsg));
+            return;
+        }
+
+        if (capture::IsEnabled(capture::EInterface::RLS))
+        {
+            auto it = m_stiToUe.find(rlsMsg->sti);
+            capture::Tap(capture::EInterface::RLS, capture::EDirection::INBOUND, buffer, static_cast<size_t>(size),
+                         it == m_stiToUe.end() ? 0 : it->second);
+        }
+        receiveRlsPdu(peerAddress, std::move(rlsMsg));
     }
 }
 
@@ -102,17 +113,19 @@ void RlsUdpTask::receiveRlsPdu(const InetAddress &addr, std::unique_ptr<rls::Rls
             return;
         }
 
+        int ueId;
         if (m_stiToUe.count(msg->sti))
         {
-            int ueId = m_stiToUe[msg->sti];
+            ueId = m_stiToUe[msg->sti];
             m_ueMap[ueId].address = addr;
             m_ueMap[ueId].lastSeen = utils::CurrentTimeMillis();
         }
         else
         {
-            int ueId = ++m_newIdCounter;
+            ueId = ++m_newIdCounter;
 
             m_stiToUe[msg->sti] = ueId;
+            trace::SetSti(ueId, msg->sti);
             m_ueMap[ueId].address = addr;
             m_ueMap[ueId].lastSeen = utils::CurrentTimeMillis();
 
@@ -124,7 +137,7 @@ void RlsUdpTask::receiveRlsPdu(const InetAddress &addr, std::unique_ptr<rls::Rls
         rls::RlsHeartBeatAck ack{m_sti};
         ack.dbm = dbm;
 
-        sendRlsPdu(addr, ack);
+        sendRlsPdu(addr, ack, ueId);
         return;
     }
 
@@ -140,12 +153,12 @@ void RlsUdpTask::receiveRlsPdu(const InetAddress &addr, std::unique_ptr<rls::Rls
     m_ctlTask->push(std::move(w));
 }
 
-void RlsUdpTask::sendRlsPdu(const InetAddress &addr, const rls::RlsMessage &msg)
+void RlsUdpTask::sendRlsPdu(const InetAddress &addr, const rls::RlsMessage &msg, int ueId)
 {
-    auto buffer = new uint8_t[16384]; // TODO: optimize, and make member
-    int n = rls::EncodeRlsMessage(msg, buffer);
-    m_server->Send(addr, buffer, static_cast<size_t>(n));
-    delete[] buffer;
+    int n = rls::EncodeRlsMessage(msg, m_sendBuffer.data());
+    capture::Tap(capture::EInterface::RLS, capture::EDirection::OUTBOUND, m_sendBuffer.data(), static_cast<size_t>(n),
+                 ueId);
+    m_server->Send(addr, m_sendBuffer.data(), static_cast<size_t>(n));
 }
 
 void RlsUdpTask::heartbeatCycle(int64_t time)
@@ -185,8 +198,17 @@ void RlsUdpTask::send(int ueId, const rls::RlsMessage &msg)
 {
     if (ueId == 0)
     {
+        // Broadcast messages are encoded once and the same bytes are sent to every UE
+        if (m_ueMap.empty())
+            return;
+
+        int n = rls::EncodeRlsMessage(msg, m_sendBuffer.data());
         for (auto &ue : m_ueMap)
-            send(ue.first, msg);
+        {
+            capture::Tap(capture::EInterface::RLS, capture::EDirection::OUTBOUND, m_sendBuffer.data(),
+                         static_cast<size_t>(n), ue.first);
+            m_server->Send(ue.second.address, m_sendBuffer.data(), static_cast<size_t>(n));
+        }
         return;
     }
 
@@ -196,7 +218,7 @@ void RlsUdpTask::send(int ueId, const rls::RlsMessage &msg)
         return;
     }
 
-    sendRlsPdu(m_ueMap[ueId].address, msg);
+    sendRlsPdu(m_ueMap[ueId].address, msg, ueId);
 }
 
 } // namespace nr::gnb
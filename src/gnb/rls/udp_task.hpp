@@ -40,6 +40,7 @@ class RlsUdpTask : public NtsTask
     std::unordered_map<uint64_t, int> m_stiToUe;
     std::unordered_map<int, UeInfo> m_ueMap;
     int m_newIdCounter;
+    std::vector<uint8_t> m_sendBuffer;
 
   public:
     explicit RlsUdpTask(TaskBase *base, uint64_t sti, Vector3 phyLocation);
@@ -52,7 +53,7 @@ class RlsUdpTask : public NtsTask
 
   private:
     void receiveRlsPdu(const InetAddress &addr, std::unique_ptr<rls::RlsMessage> &&msg);
-    void sendRlsPdu(const InetAddress &addr, const rls::RlsMessage &msg);
+    void sendRlsPdu(const InetAddress &addr, const rls::RlsMessage &msg, int ueId);
     void heartbeatCycle(int64_t time);
 
   public:
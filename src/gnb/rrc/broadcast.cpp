@@ -109,14 +109,30 @@ void GnbRrcTask::onBroadcastTimerExpired()
 
 void GnbRrcTask::triggerSysInfoBroadcast()
 {
-    auto *mib = ConstructMibMessage(m_isBarred, m_intraFreqReselectAllowed);
-    auto *sib1 = ConstructSib1Message(m_cellReserved, m_config->tac, m_config->nci, m_config->plmn, m_aiBarringSet);
+    if (m_encodedSysInfoVersion != m_sysInfoVersion)
+    {
+        asn::ArenaScope arenaScope{m_sysInfoArena};
+
+        auto *mib = ConstructMibMessage(m_isBarred, m_intraFreqReselectAllowed);
+        auto *sib1 = ConstructSib1Message(m_cellReserved, m_config->tac, m_config->nci, m_config->plmn, m_aiBarringSet);
+
+        m_encodedMib = rrc::encode::EncodeS(asn_DEF_ASN_RRC_BCCH_BCH_Message, mib);
+        m_encodedSib1 = rrc::encode::EncodeS(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, sib1);
 
-    sendRrcMessage(mib);
-    sendRrcMessage(sib1);
+        asn::Free(asn_DEF_ASN_RRC_BCCH_BCH_Message, mib);
+        asn::Free(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, sib1);
+
+        if (m_encodedMib.length() == 0 || m_encodedSib1.length() == 0)
+        {
+            m_logger->err("RRC system information encoding failed.");
+            return;
+        }
+
+        m_encodedSysInfoVersion = m_sysInfoVersion;
+    }
 
-    asn::Free(asn_DEF_ASN_RRC_BCCH_BCH_Message, mib);
-    asn::Free(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, sib1);
+    sendSysInfoPdu(rrc::RrcChannel::BCCH_BCH, m_encodedMib.copy());
+    sendSysInfoPdu(rrc::RrcChannel::BCCH_DL_SCH, m_encodedSib1.copy());
 }
 
 } // namespace nr::gnb
\ No newline at end of file
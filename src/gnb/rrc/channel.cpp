@@ -65,34 +65,11 @@ void GnbRrcTask::handleUplinkRrc(int ueId, rrc::RrcChannel channel, const OctetS
     }
 }
 
-void GnbRrcTask::sendRrcMessage(ASN_RRC_BCCH_BCH_Message *msg)
+void GnbRrcTask::sendSysInfoPdu(rrc::RrcChannel channel, OctetString &&pdu)
 {
-    OctetString pdu = rrc::encode::EncodeS(asn_DEF_ASN_RRC_BCCH_BCH_Message, msg);
-    if (pdu.length() == 0)
-    {
-        m_logger->err("RRC BCCH-BCH encoding failed.");
-        return;
-    }
-
-    auto w = std::make_unique<NmGnbRrcToRls>(NmGnbRrcToRls::RRC_PDU_DELIVERY);
-    w->ueId = 0;
-    w->channel = rrc::RrcChannel::BCCH_BCH;
-    w->pdu = std::move(pdu);
-    m_base->rlsTask->push(std::move(w));
-}
-
-void GnbRrcTask::sendRrcMessage(ASN_RRC_BCCH_DL_SCH_Message *msg)
-{
-    OctetString pdu = rrc::encode::EncodeS(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, msg);
-    if (pdu.length() == 0)
-    {
-        m_logger->err("RRC BCCH-DL-SCH encoding failed.");
-        return;
-    }
-
     auto w = std::make_unique<NmGnbRrcToRls>(NmGnbRrcToRls::RRC_PDU_DELIVERY);
     w->ueId = 0;
-    w->channel = rrc::RrcChannel::BCCH_DL_SCH;
+    w->channel = channel;
     w->pdu = std::move(pdu);
     m_base->rlsTask->push(std::move(w));
 }
@@ -10,6 +10,7 @@
 
 #include <gnb/ngap/task.hpp>
 #include <lib/rrc/encode.hpp>
+#include <lib/trace/trace.hpp>
 
 #include <asn/ngap/ASN_NGAP_FiveG-S-TMSI.h>
 #include <asn/rrc/ASN_RRC_BCCH-BCH-Message.h>
@@ -129,6 +130,7 @@ void GnbRrcTask::receiveRrcSetupComplete(int ueId, const ASN_RRC_RRCSetupComplet
     w->rrcEstablishmentCause = ue->establishmentCause;
     w->sTmsi = ue->sTmsi;
 
+    trace::Hop("RRC UL", ueId, "RRC Setup Complete");
     m_base->ngapTask->push(std::move(w));
 }
 
@@ -10,6 +10,7 @@
 
 #include <gnb/ngap/task.hpp>
 #include <lib/rrc/encode.hpp>
+#include <lib/trace/trace.hpp>
 
 #include <asn/ngap/ASN_NGAP_FiveG-S-TMSI.h>
 #include <asn/rrc/ASN_RRC_BCCH-BCH-Message.h>
@@ -41,6 +42,8 @@ namespace nr::gnb
 
 void GnbRrcTask::handleDownlinkNasDelivery(int ueId, const OctetString &nasPdu)
 {
+    trace::Hop("RRC DL", ueId, "DL Information Transfer");
+
     auto *pdu = asn::New<ASN_RRC_DL_DCCH_Message>();
     pdu->message.present = ASN_RRC_DL_DCCH_MessageType_PR_c1;
     pdu->message.choice.c1 =
@@ -63,6 +66,7 @@ void GnbRrcTask::deliverUplinkNas(int ueId, OctetString &&nasPdu)
     auto w = std::make_unique<NmGnbRrcToNgap>(NmGnbRrcToNgap::UPLINK_NAS_DELIVERY);
     w->ueId = ueId;
     w->pdu = std::move(nasPdu);
+    trace::Hop("RRC UL", ueId, "UL Information Transfer");
     m_base->ngapTask->push(std::move(w));
 }
 
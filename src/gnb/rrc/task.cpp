@@ -55,6 +55,7 @@ void GnbRrcTask::onLoop()
         {
         case NmGnbNgapToRrc::RADIO_POWER_ON: {
             m_isBarred = false;
+            m_sysInfoVersion++;
             triggerSysInfoBroadcast();
             break;
         }
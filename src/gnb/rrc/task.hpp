@@ -14,6 +14,7 @@
 #include <vector>
 
 #include <gnb/nts.hpp>
+#include <lib/asn/utils.hpp>
 #include <utils/logger.hpp>
 #include <utils/nts.hpp>
 
@@ -48,11 +49,19 @@ class GnbRrcTask : public NtsTask
     std::unordered_map<int, RrcUeContext *> m_ueCtx;
     int m_tidCounter;
 
+    // The system information version must be increased if any of these is changed
     bool m_isBarred = true;
     bool m_cellReserved = false;
     UacAiBarringSet m_aiBarringSet = {};
     bool m_intraFreqReselectAllowed = true;
 
+    /* Encoded MIB and SIB1, rebuilt only if the version is changed */
+    int m_sysInfoVersion = 1;
+    int m_encodedSysInfoVersion = 0;
+    OctetString m_encodedMib{};
+    OctetString m_encodedSib1{};
+    asn::Arena m_sysInfoArena{};
+
     friend class GnbCmdHandler;
 
   public:
@@ -80,8 +89,7 @@ class GnbRrcTask : public NtsTask
     void receiveUplinkInformationTransfer(int ueId, const ASN_RRC_ULInformationTransfer &msg);
 
     /* RRC channel send message */
-    void sendRrcMessage(ASN_RRC_BCCH_BCH_Message *msg);
-    void sendRrcMessage(ASN_RRC_BCCH_DL_SCH_Message *msg);
+    void sendSysInfoPdu(rrc::RrcChannel channel, OctetString &&pdu);
     void sendRrcMessage(int ueId, ASN_RRC_DL_CCCH_Message *msg);
     void sendRrcMessage(int ueId, ASN_RRC_DL_DCCH_Message *msg);
     void sendRrcMessage(ASN_RRC_PCCH_Message *msg);
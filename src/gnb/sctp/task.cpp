@@ -9,9 +9,12 @@
 #include "task.hpp"
 
 #include <cstring>
-#include <thread>
 #include <utility>
 
+#include <unistd.h>
+
+#include <lib/capture/capture.hpp>
+
 // #define MOCKED_PACKETS
 
 #ifdef MOCKED_PACKETS
@@ -38,6 +41,15 @@ static std::string MOCK_LIST[] = {
 static int MOCK_INDEX = -1;
 #endif
 
+static constexpr const size_t RECEIVE_BUFFER_SIZE = 8192;
+// Received messages larger than this are handed over in the receive buffer instead of being copied
+static constexpr const size_t HAND_OVER_THRESHOLD = RECEIVE_BUFFER_SIZE / 4;
+// Maximum number of messages received from one association before serving the others
+static constexpr const int MAX_RECEIVE_PER_WAKE_UP = 64;
+static constexpr const int MAX_EVENTS_PER_WAIT = 16;
+static constexpr const int WAIT_TIME = 500;
+static constexpr const uint32_t WAKE_UP_TAG = UINT32_MAX;
+
 namespace nr::gnb
 {
 
@@ -53,64 +65,40 @@ class SctpHandler : public sctp::ISctpHandler
     }
 
   private:
+    // The handler is called on the task thread, while receiving from the socket
     void onAssociationSetup(int associationId, int inStreams, int outStreams) override
     {
-        auto w = std::make_unique<NmGnbSctp>(NmGnbSctp::ASSOCIATION_SETUP);
-        w->clientId = clientId;
-        w->associationId = associationId;
-        w->inStreams = inStreams;
-        w->outStreams = outStreams;
-        sctpTask->push(std::move(w));
+        sctpTask->receiveAssociationSetup(clientId, associationId, inStreams, outStreams);
     }
 
     void onAssociationShutdown() override
     {
-        auto w = std::make_unique<NmGnbSctp>(NmGnbSctp::ASSOCIATION_SHUTDOWN);
-        w->clientId = clientId;
-        sctpTask->push(std::move(w));
+        sctpTask->receiveAssociationShutdown(clientId);
     }
 
     void onMessage(const uint8_t *buffer, size_t length, uint16_t stream) override
     {
-        auto *data = new uint8_t[length];
-        std::memcpy(data, buffer, length);
-
-        auto w = std::make_unique<NmGnbSctp>(NmGnbSctp::RECEIVE_MESSAGE);
-        w->clientId = clientId;
-        w->buffer = UniqueBuffer{data, length};
-        w->stream = stream;
-        sctpTask->push(std::move(w));
+        sctpTask->receiveClientReceive(clientId, stream, sctpTask->takeReceivedMessage(buffer, length));
     }
 
     void onUnhandledNotification() override
     {
-        auto w = std::make_unique<NmGnbSctp>(NmGnbSctp::UNHANDLED_NOTIFICATION);
-        w->clientId = clientId;
-        sctpTask->push(std::move(w));
+        sctpTask->receiveUnhandledNotification(clientId);
     }
 
     void onConnectionReset() override
     {
-        auto w = std::make_unique<NmGnbSctp>(NmGnbSctp::UNHANDLED_NOTIFICATION);
-        w->clientId = clientId;
-        sctpTask->push(std::move(w));
+        sctpTask->receiveUnhandledNotification(clientId);
     }
 };
 
-[[noreturn]] static void ReceiverThread(std::pair<sctp::SctpClient *, sctp::ISctpHandler *> *args)
-{
-    sctp::SctpClient *client = args->first;
-    sctp::ISctpHandler *handler = args->second;
-
-    delete args;
-
-    while (true)
-        client->receive(handler);
-}
-
-SctpTask::SctpTask(TaskBase *base) : m_base{base}, m_clients{}
+SctpTask::SctpTask(TaskBase *base)
+    : m_base{base}, m_clients{}, m_poller{}, m_wakeUpFd{}, m_receiveBuffer{new uint8_t[RECEIVE_BUFFER_SIZE]}
 {
     m_logger = base->logBase->makeUniqueLogger("sctp");
+
+    m_wakeUpFd = enableWakeUpFd();
+    m_poller.add(m_wakeUpFd, WAKE_UP_TAG);
 }
 
 void SctpTask::onStart()
@@ -119,57 +107,166 @@ void SctpTask::onStart()
 
 void SctpTask::onLoop()
 {
-    auto msg = take();
-    if (!msg)
-        return;
+    // All queued messages are handled before waiting, so the messages to send are coalesced per association
+    while (auto msg = poll())
+        handleMessage(*msg);
+
+    for (auto &client : m_clients)
+    {
+        if (!client.second->sendQueue.empty() && !client.second->waitingWritable)
+            flushSendQueue(client.second);
+    }
+
+    uint32_t tags[MAX_EVENTS_PER_WAIT];
+    int count = m_poller.wait(tags, MAX_EVENTS_PER_WAIT, WAIT_TIME);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (tags[i] == WAKE_UP_TAG)
+        {
+            uint64_t value;
+            while (::read(m_wakeUpFd, &value, sizeof(value)) > 0)
+            {
+            }
+            continue;
+        }
+
+        ClientEntry *entry = findClient(static_cast<int>(tags[i]));
+        if (entry == nullptr || entry->closed)
+            continue;
+
+        if (entry->waitingWritable)
+            flushSendQueue(entry);
+        if (!entry->closed)
+            receiveFromClient(entry);
+    }
+}
 
-    switch (msg->msgType)
+void SctpTask::handleMessage(NtsMessage &msg)
+{
+    switch (msg.msgType)
     {
     case NtsMessageType::GNB_SCTP: {
-        auto& w = dynamic_cast<NmGnbSctp &>(*msg);
+        auto &w = dynamic_cast<NmGnbSctp &>(msg);
         switch (w.present)
         {
         case NmGnbSctp::CONNECTION_REQUEST: {
             receiveSctpConnectionSetupRequest(w.clientId, w.localAddress, w.localPort, w.remoteAddress,
-                                              w.remotePort, w.ppid, w.associatedTask);
+                                              w.remotePort, w.ppid, w.associatedTask, std::move(w.receiverTasks));
             break;
         }
         case NmGnbSctp::CONNECTION_CLOSE: {
             receiveConnectionClose(w.clientId);
             break;
         }
-        case NmGnbSctp::ASSOCIATION_SETUP: {
-            receiveAssociationSetup(w.clientId, w.associationId, w.inStreams, w.outStreams);
-            break;
-        }
-        case NmGnbSctp::ASSOCIATION_SHUTDOWN: {
-            receiveAssociationShutdown(w.clientId);
-            break;
-        }
-        case NmGnbSctp::RECEIVE_MESSAGE: {
-            receiveClientReceive(w.clientId, w.stream, std::move(w.buffer));
-            break;
-        }
         case NmGnbSctp::SEND_MESSAGE: {
-            receiveSendMessage(w.clientId, w.stream, std::move(w.buffer));
-            break;
-        }
-        case NmGnbSctp::UNHANDLED_NOTIFICATION: {
-            receiveUnhandledNotification(w.clientId);
+            receiveSendMessage(w.clientId, w.stream, std::move(w.buffer), std::move(w.sentCounter));
             break;
         }
         default:
-            m_logger->unhandledNts(*msg);
+            m_logger->unhandledNts(msg);
             break;
         }
         break;
     }
     default:
-        m_logger->unhandledNts(*msg);
+        m_logger->unhandledNts(msg);
         break;
     }
 }
 
+SctpTask::ClientEntry *SctpTask::findClient(int clientId)
+{
+    auto it = m_clients.find(clientId);
+    return it == m_clients.end() ? nullptr : it->second;
+}
+
+void SctpTask::receiveFromClient(ClientEntry *entry)
+{
+    for (int i = 0; i < MAX_RECEIVE_PER_WAKE_UP; i++)
+    {
+        sctp::ReceiveResult result;
+        try
+        {
+            result = entry->client->tryReceive(entry->handler, m_receiveBuffer.get(), RECEIVE_BUFFER_SIZE);
+        }
+        catch (const sctp::SctpError &exc)
+        {
+            m_logger->err("SCTP receive failure (clientId: %d). %s", entry->id, exc.what());
+            result = sctp::ReceiveResult::CLOSED;
+        }
+
+        if (result == sctp::ReceiveResult::WOULD_BLOCK)
+            return;
+        if (result == sctp::ReceiveResult::CLOSED)
+        {
+            closeClient(entry);
+            return;
+        }
+    }
+}
+
+void SctpTask::flushSendQueue(ClientEntry *entry)
+{
+    auto &queue = entry->sendQueue;
+    while (!queue.empty())
+    {
+        auto &item = queue.front();
+        bool sent;
+        try
+        {
+            sent = entry->client->trySend(item.stream, item.buffer.data(), item.buffer.size(), queue.size() > 1);
+        }
+        catch (const sctp::SctpError &exc)
+        {
+            m_logger->err("SCTP send failure (clientId: %d). %s", entry->id, exc.what());
+            closeClient(entry);
+            return;
+        }
+
+        if (!sent)
+            break;
+        if (item.sentCounter)
+            item.sentCounter->fetch_add(1, std::memory_order_relaxed);
+        queue.pop_front();
+    }
+
+    // The rest of the queue is sent when the socket becomes writable
+    bool waitingWritable = !queue.empty();
+    if (waitingWritable != entry->waitingWritable)
+    {
+        entry->waitingWritable = waitingWritable;
+        m_poller.setWritable(entry->client->getFd(), static_cast<uint32_t>(entry->id), waitingWritable);
+    }
+}
+
+void SctpTask::closeClient(ClientEntry *entry)
+{
+    if (entry->closed)
+        return;
+
+    entry->closed = true;
+    entry->sendQueue.clear();
+    m_poller.remove(entry->client->getFd());
+
+    // The associated task closes the connection in turn
+    receiveAssociationShutdown(entry->id);
+}
+
+UniqueBuffer SctpTask::takeReceivedMessage(const uint8_t *data, size_t length)
+{
+    if (length <= HAND_OVER_THRESHOLD || data != m_receiveBuffer.get())
+    {
+        auto *copy = new uint8_t[length];
+        std::memcpy(copy, data, length);
+        return UniqueBuffer{copy, length};
+    }
+
+    UniqueBuffer buffer{m_receiveBuffer.release(), length};
+    m_receiveBuffer.reset(new uint8_t[RECEIVE_BUFFER_SIZE]);
+    return buffer;
+}
+
 void SctpTask::onQuit()
 {
     for (auto &client : m_clients)
@@ -183,7 +280,6 @@ void SctpTask::onQuit()
 void SctpTask::DeleteClientEntry(ClientEntry *entry)
 {
     entry->associatedTask = nullptr;
-    delete entry->receiverThread;
     delete entry->client;
     delete entry->handler;
     delete entry;
@@ -191,11 +287,21 @@ void SctpTask::DeleteClientEntry(ClientEntry *entry)
 
 void SctpTask::receiveSctpConnectionSetupRequest(int clientId, const std::string &localAddress, uint16_t localPort,
                                                  const std::string &remoteAddress, uint16_t remotePort,
-                                                 sctp::PayloadProtocolId ppid, NtsTask *associatedTask)
+                                                 sctp::PayloadProtocolId ppid, NtsTask *associatedTask,
+                                                 std::vector<NtsTask *> &&receiverTasks)
 {
     m_logger->info("Trying to establish SCTP connection... (%s:%d)", remoteAddress.c_str(), remotePort);
 
-    auto *client = new sctp::SctpClient(ppid);
+    sctp::SctpClient *client;
+    try
+    {
+        client = new sctp::SctpClient(ppid, m_base->config->sctp);
+    }
+    catch (const sctp::SctpError &exc)
+    {
+        m_logger->err("Socket setup for %s:%d failed. %s", remoteAddress.c_str(), remotePort, exc.what());
+        return;
+    }
 
     try
     {
@@ -221,6 +327,19 @@ void SctpTask::receiveSctpConnectionSetupRequest(int clientId, const std::string
 
     m_logger->info("SCTP connection established (%s:%d)", remoteAddress.c_str(), remotePort);
 
+    try
+    {
+        client->setNonBlocking();
+        m_poller.add(client->getFd(), static_cast<uint32_t>(clientId));
+    }
+    catch (const std::exception &exc)
+    {
+        m_logger->err("SCTP socket could not be registered (%s:%d). %s", remoteAddress.c_str(), remotePort,
+                      exc.what());
+        delete client;
+        return;
+    }
+
     sctp::ISctpHandler *handler = new SctpHandler(this, clientId);
 
     auto *entry = new ClientEntry;
@@ -230,16 +349,16 @@ void SctpTask::receiveSctpConnectionSetupRequest(int clientId, const std::string
     entry->client = client;
     entry->handler = handler;
     entry->associatedTask = associatedTask;
-    entry->receiverThread = new ScopedThread(
-        [](void *arg) { ReceiverThread(reinterpret_cast<std::pair<sctp::SctpClient *, sctp::ISctpHandler *> *>(arg)); },
-        new std::pair<sctp::SctpClient *, sctp::ISctpHandler *>(client, handler));
+    entry->receiverTasks = std::move(receiverTasks);
+    entry->waitingWritable = false;
+    entry->closed = false;
 }
 
 void SctpTask::receiveAssociationSetup(int clientId, int associationId, int inStreams, int outStreams)
 {
     m_logger->debug("SCTP association setup ascId[%d]", associationId);
 
-    ClientEntry *entry = m_clients[clientId];
+    ClientEntry *entry = findClient(clientId);
     if (entry == nullptr)
     {
         m_logger->warn("Client entry not found for id: %d", clientId);
@@ -259,7 +378,7 @@ void SctpTask::receiveAssociationShutdown(int clientId)
 {
     m_logger->debug("SCTP association shutdown (clientId: %d)", clientId);
 
-    ClientEntry *entry = m_clients[clientId];
+    ClientEntry *entry = findClient(clientId);
     if (entry == nullptr)
     {
         m_logger->warn("Client entry not found for id: %d", clientId);
@@ -274,19 +393,25 @@ void SctpTask::receiveAssociationShutdown(int clientId)
 
 void SctpTask::receiveClientReceive(int clientId, uint16_t stream, UniqueBuffer &&buffer)
 {
-    ClientEntry *entry = m_clients[clientId];
+    ClientEntry *entry = findClient(clientId);
     if (entry == nullptr)
     {
         m_logger->warn("Client entry not found for id: %d", clientId);
         return;
     }
 
-    // Notify the relevant task
+    // NGAP messages are not decoded here, so they are captured without the UE ID
+    capture::Tap(capture::EInterface::NGAP, capture::EDirection::INBOUND, buffer.data(), buffer.size());
+
+    // Notify the relevant task, messages of the same stream always go to the same receiver to keep their order
     auto msg = std::make_unique<NmGnbSctp>(NmGnbSctp::RECEIVE_MESSAGE);
     msg->clientId = clientId;
     msg->stream = stream;
     msg->buffer = std::move(buffer);
-    entry->associatedTask->push(std::move(msg));
+    if (entry->receiverTasks.empty())
+        entry->associatedTask->push(std::move(msg));
+    else
+        entry->receiverTasks[stream % entry->receiverTasks.size()]->push(std::move(msg));
 }
 
 void SctpTask::receiveUnhandledNotification(int clientId)
@@ -300,19 +425,24 @@ void SctpTask::receiveUnhandledNotification(int clientId)
 
 void SctpTask::receiveConnectionClose(int clientId)
 {
-    ClientEntry *entry = m_clients[clientId];
+    ClientEntry *entry = findClient(clientId);
     if (entry == nullptr)
     {
         m_logger->warn("Client entry not found for id: %d", clientId);
         return;
     }
 
+    if (!entry->closed)
+        m_poller.remove(entry->client->getFd());
+
+    m_clients.erase(clientId);
     DeleteClientEntry(entry);
 }
 
-void SctpTask::receiveSendMessage(int clientId, uint16_t stream, UniqueBuffer &&buffer)
+void SctpTask::receiveSendMessage(int clientId, uint16_t stream, UniqueBuffer &&buffer,
+                                  std::shared_ptr<std::atomic<uint64_t>> &&sentCounter)
 {
-    ClientEntry *entry = m_clients[clientId];
+    ClientEntry *entry = findClient(clientId);
     if (entry == nullptr)
     {
         m_logger->warn("Client entry not found for id: %d", clientId);
@@ -325,10 +455,12 @@ void SctpTask::receiveSendMessage(int clientId, uint16_t stream, UniqueBuffer &&
         OctetString data = OctetString::FromHex(ss);
         auto *copy = new uint8_t[data.length()];
         std::memcpy(copy, data.data(), data.length());
-        receiveClientReceive(clientId, 0, copy, data.length());
+        receiveClientReceive(clientId, 0, UniqueBuffer{copy, static_cast<size_t>(data.length())});
     }
 #else
-    entry->client->send(stream, buffer.data(), 0, buffer.size());
+    capture::Tap(capture::EInterface::NGAP, capture::EDirection::OUTBOUND, buffer.data(), buffer.size());
+    if (!entry->closed)
+        entry->sendQueue.push_back(PendingMessage{stream, std::move(buffer), std::move(sentCounter)});
 #endif
 }
 
@@ -8,38 +8,59 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <memory>
-#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include <gnb/nts.hpp>
 #include <lib/sctp/sctp.hpp>
+#include <utils/fd_base.hpp>
 #include <utils/logger.hpp>
 #include <utils/nts.hpp>
-#include <utils/scoped_thread.hpp>
 
 namespace nr::gnb
 {
 
+/*
+ * Serves all SCTP associations on the task thread. The non-blocking sockets of the associations are waited on with a
+ * single epoll instance, together with the wake-up fd of the task's message queue. The messages to send are queued per
+ * association and flushed at the end of each loop iteration, so that the messages queued meanwhile are coalesced into
+ * fewer SCTP packets.
+ */
 class SctpTask : public NtsTask
 {
   private:
+    struct PendingMessage
+    {
+        uint16_t stream;
+        UniqueBuffer buffer;
+        std::shared_ptr<std::atomic<uint64_t>> sentCounter;
+    };
+
     struct ClientEntry
     {
         int id;
         sctp::SctpClient *client;
-        ScopedThread *receiverThread;
         sctp::ISctpHandler *handler;
         NtsTask *associatedTask;
+        std::vector<NtsTask *> receiverTasks;
+        std::deque<PendingMessage> sendQueue;
+        bool waitingWritable;
+        bool closed; // The socket is removed from the poller, the entry is deleted on CONNECTION_CLOSE
     };
 
   private:
     TaskBase *m_base;
     std::unique_ptr<Logger> m_logger;
     std::unordered_map<int, ClientEntry *> m_clients;
+    FdPoller m_poller;
+    int m_wakeUpFd;
+    std::unique_ptr<uint8_t[]> m_receiveBuffer; // Shared by all associations, see takeReceivedMessage()
 
     friend class GnbCmdHandler;
+    friend class SctpHandler;
 
   public:
     explicit SctpTask(TaskBase *base);
@@ -54,15 +75,25 @@ class SctpTask : public NtsTask
     static void DeleteClientEntry(ClientEntry *entry);
 
   private:
-    void receiveSctpConnectionSetupRequest(int clientId, const std::string &localAddress, uint16_t localPort,
-                                           const std::string &remoteAddress, uint16_t remotePort,
-                                           sctp::PayloadProtocolId ppid, NtsTask *associatedTask);
+    ClientEntry *findClient(int clientId);
+    void handleMessage(NtsMessage &msg);
+    void receiveFromClient(ClientEntry *entry);
+    void flushSendQueue(ClientEntry *entry);
+    void closeClient(ClientEntry *entry);
+    UniqueBuffer takeReceivedMessage(const uint8_t *data, size_t length);
+
+  private:
     void receiveAssociationSetup(int clientId, int associationId, int inStreams, int outStreams);
     void receiveAssociationShutdown(int clientId);
     void receiveClientReceive(int clientId, uint16_t stream, UniqueBuffer &&buffer);
     void receiveUnhandledNotification(int clientId);
+    void receiveSctpConnectionSetupRequest(int clientId, const std::string &localAddress, uint16_t localPort,
+                                           const std::string &remoteAddress, uint16_t remotePort,
+                                           sctp::PayloadProtocolId ppid, NtsTask *associatedTask,
+                                           std::vector<NtsTask *> &&receiverTasks);
     void receiveConnectionClose(int clientId);
-    void receiveSendMessage(int clientId, uint16_t stream, UniqueBuffer &&buffer);
+    void receiveSendMessage(int clientId, uint16_t stream, UniqueBuffer &&buffer,
+                            std::shared_ptr<std::atomic<uint64_t>> &&sentCounter);
 };
 
 } // namespace nr::gnb
\ No newline at end of file
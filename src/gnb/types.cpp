@@ -31,6 +31,11 @@ Json ToJson(const GnbConfig &v)
         {"gtp-ip", v.gtpIp},
         {"paging-drx", ToJson(v.pagingDrx)},
         {"ignore-sctp-id", v.ignoreStreamIds},
+        {"ngap-decoder-threads", v.ngapDecoderThreads},
+        {"asn-constraint-check", ToJson(v.asnConstraintCheck)},
+        {"asn-constraint-check-interval", v.asnConstraintCheckInterval},
+        {"rlc", rls::ToJson(v.rlc)},
+        {"sctp", ToJson(v.sctp)},
     });
 }
 
@@ -42,7 +47,9 @@ Json ToJson(const NgapAmfContext &v)
         {"address", ((utils::GetIpVersion(v.address) == 6) ? "[" + v.address + "]" : v.address) + ":" + std::to_string(v.port)},
         {"state", ToJson(v.state).str()},
         {"capacity", v.relativeCapacity},
+        {"ue-count", v.ueCount},
         {"association", ToJson(v.association)},
+        {"streams", ::ToJson(v.streamLoads)},
         {"served-guami", ::ToJson(v.servedGuamiList)},
         {"served-plmn", ::ToJson(v.plmnSupportList)},
     });
@@ -80,11 +87,56 @@ Json ToJson(const EPagingDrx &v)
     }
 }
 
+Json ToJson(const EAsnConstraintCheck &v)
+{
+    switch (v)
+    {
+    case EAsnConstraintCheck::ALWAYS:
+        return "always";
+    case EAsnConstraintCheck::SAMPLED:
+        return "sampled";
+    case EAsnConstraintCheck::DEBUG_ONLY:
+        return "debug";
+    default:
+        return "?";
+    }
+}
+
+Json ToJson(const NgapStatistics &v)
+{
+    return Json::Obj({
+        {"sent-pdus", static_cast<int64_t>(v.sentPdus)},
+        {"constraint-checks", static_cast<int64_t>(v.constraintChecks)},
+        {"constraint-violations", static_cast<int64_t>(v.constraintViolations)},
+        {"encoding-failures", static_cast<int64_t>(v.encodingFailures)},
+    });
+}
+
 Json ToJson(const SctpAssociation &v)
 {
     return Json::Obj({{"id", v.associationId}, {"rx-num", v.inStreams}, {"tx-num", v.outStreams}});
 }
 
+Json ToJson(const SctpStreamLoad &v)
+{
+    return Json::Obj({
+        {"ue-count", v.ueCount},
+        {"queued-pdus", static_cast<int64_t>(v.queuedPdus)},
+        {"outstanding-pdus", static_cast<int64_t>(v.outstandingPdus())},
+    });
+}
+
+Json ToJson(const sctp::SocketOptions &v)
+{
+    return Json::Obj({
+        {"in-streams", v.inStreams},
+        {"out-streams", v.outStreams},
+        {"no-delay", v.noDelay},
+        {"send-buffer-size", v.sendBufferSize},
+        {"receive-buffer-size", v.receiveBufferSize},
+    });
+}
+
 Json ToJson(const ServedGuami &v)
 {
     return Json::Obj({{"guami", ToJson(v.guami)}, {"backup-amf", v.backupAmfName}});
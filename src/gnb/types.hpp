@@ -8,9 +8,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <set>
 
 #include <lib/asn/utils.hpp>
+#include <lib/capture/capture.hpp>
+#include <lib/rls/rls_rlc.hpp>
+#include <lib/sctp/types.hpp>
 #include <utils/common_types.hpp>
 #include <utils/logger.hpp>
 #include <utils/network.hpp>
@@ -37,6 +42,13 @@ enum class EAmfState
     CONNECTED
 };
 
+enum class EAsnConstraintCheck
+{
+    ALWAYS,
+    SAMPLED,
+    DEBUG_ONLY,
+};
+
 struct SctpAssociation
 {
     int associationId{};
@@ -44,6 +56,21 @@ struct SctpAssociation
     int outStreams{};
 };
 
+/* Uplink load of an outbound SCTP stream of an AMF association */
+struct SctpStreamLoad
+{
+    int ueCount{};         // UE contexts whose UE-associated signalling is sent on this stream
+    uint64_t queuedPdus{}; // UE-associated PDUs handed to the SCTP task for this stream since the association setup
+    // Of the queued PDUs, the ones written to the socket, counted by the SCTP task
+    std::shared_ptr<std::atomic<uint64_t>> sentPdus{std::make_shared<std::atomic<uint64_t>>()};
+
+    /* PDUs still waiting in the send queue of the SCTP task */
+    [[nodiscard]] uint64_t outstandingPdus() const
+    {
+        return queuedPdus - sentPdus->load(std::memory_order_relaxed);
+    }
+};
+
 struct Guami
 {
     Plmn plmn{};
@@ -94,11 +121,12 @@ struct NgapAmfContext
 {
     int ctxId{};
     SctpAssociation association{};
-    int nextStream{}; // next available SCTP stream for uplink
+    std::vector<SctpStreamLoad> streamLoads{}; // indexed by the outbound stream id
     std::string address{};
     uint16_t port{};
     std::string amfName{};
     int64_t relativeCapacity{};
+    int ueCount{}; // UE contexts associated with this AMF, used for the load balancing in AMF selection
     EAmfState state{};
     OverloadInfo overloadInfo{};
     std::vector<ServedGuami *> servedGuamiList{};
@@ -169,6 +197,13 @@ struct NgapIdPair
     }
 };
 
+struct NgapPduUeIds
+{
+    // True if the IDs are carried in a UE-NGAP-IDs IE, otherwise they are carried in separate AMF/RAN UE NGAP ID IEs
+    bool isUeNgapIdsIe{};
+    NgapIdPair idPair{};
+};
+
 enum class NgapCause
 {
     RadioNetwork_unspecified = 0,
@@ -293,6 +328,14 @@ struct GtpUeContextUpdate
     }
 };
 
+struct NgapStatistics
+{
+    uint64_t sentPdus{};
+    uint64_t constraintChecks{};
+    uint64_t constraintViolations{};
+    uint64_t encodingFailures{};
+};
+
 struct GnbAmfConfig
 {
     std::string address{};
@@ -313,6 +356,12 @@ struct GnbConfig
     std::string gtpIp{};
     std::optional<std::string> gtpAdvertiseIp{};
     bool ignoreStreamIds{};
+    int ngapDecoderThreads{};
+    EAsnConstraintCheck asnConstraintCheck{};
+    int asnConstraintCheckInterval{}; // for SAMPLED
+    rls::RlcBearerConfig rlc{};
+    sctp::SocketOptions sctp{};
+    capture::CaptureConfig capture{};
 
     /* Assigned by program */
     std::string name{};
@@ -349,7 +398,11 @@ Json ToJson(const GnbConfig &v);
 Json ToJson(const NgapAmfContext &v);
 Json ToJson(const EAmfState &v);
 Json ToJson(const EPagingDrx &v);
+Json ToJson(const EAsnConstraintCheck &v);
+Json ToJson(const NgapStatistics &v);
 Json ToJson(const SctpAssociation &v);
+Json ToJson(const SctpStreamLoad &v);
+Json ToJson(const sctp::SocketOptions &v);
 Json ToJson(const ServedGuami &v);
 Json ToJson(const Guami &v);
 
@@ -19,9 +19,18 @@
 static std::atomic_int g_instanceCount{};
 static std::vector<void (*)()> g_runAtExit{};
 static std::vector<std::string> g_deleteAtExit{};
+static void (*g_stopHandler)() = nullptr;
+static std::atomic_int g_stopSignalCount{};
 
 extern "C" void BaseSignalHandler(int num)
 {
+    // The first stop signal is left to the stop handler if there is one, the process exits upon the next one
+    if ((num == SIGTERM || num == SIGINT) && g_stopHandler != nullptr && g_stopSignalCount++ == 0)
+    {
+        g_stopHandler();
+        return;
+    }
+
     for (auto &fun : g_runAtExit)
         fun();
     for (auto &file : g_deleteAtExit)
@@ -55,4 +64,9 @@ void DeleteAtExit(const std::string &file)
     g_deleteAtExit.push_back(file);
 }
 
+void SetStopHandler(void (*fun)())
+{
+    g_stopHandler = fun;
+}
+
 } // namespace app
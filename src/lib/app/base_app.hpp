@@ -21,4 +21,7 @@ void RunAtExit(void (*fun)());
 
 void DeleteAtExit(const std::string &file);
 
+/* Handles the first SIGINT or SIGTERM instead of exiting, the handler must be async-signal-safe */
+void SetStopHandler(void (*fun)());
+
 } // namespace app
@@ -11,9 +11,10 @@
 #include <utils/octet_string.hpp>
 #include <utils/octet_view.hpp>
 
-#define CMD_BUFFER_SIZE 8192
+#define CMD_BUFFER_SIZE 65536
 #define CMD_RCV_TIMEOUT 2500
 #define CMD_MIN_LENGTH (3 + 4 + 4 + 1)
+#define CMD_CHUNK_INFO_LENGTH (1 + 4 + 1)
 
 namespace app
 {
@@ -25,37 +26,28 @@ InetAddress CliServer::assignedAddress() const
 
 CliMessage CliServer::receiveMessage()
 {
-    uint8_t buffer[CMD_BUFFER_SIZE] = {0};
+    uint8_t buffer[CMD_BUFFER_SIZE];
     InetAddress address;
 
     int size = m_socket.receive(buffer, CMD_BUFFER_SIZE, CMD_RCV_TIMEOUT, address);
     if (size < CMD_MIN_LENGTH || size >= CMD_BUFFER_SIZE)
         return {};
 
-    OctetView v{buffer, static_cast<size_t>(size)};
-    if (v.readI() != cons::Major)
-        return {};
-    if (v.readI() != cons::Minor)
-        return {};
-    if (v.readI() != cons::Patch)
-        return {};
-
     CliMessage res{};
-    res.type = static_cast<CliMessage::Type>(v.readI());
-    int nodeNameLength = v.read4I();
-    res.nodeName = v.readUtf8String(nodeNameLength);
-    int valueLength = v.read4I();
-    res.value = v.readUtf8String(valueLength);
+    if (!CliMessage::Decode(buffer, static_cast<size_t>(size), res))
+        return {};
     res.clientAddr = address;
     return res;
 }
 
 void CliServer::sendMessage(const CliMessage &msg)
 {
-    OctetString stream{};
-    CliMessage::Encode(msg, stream);
+    CliChunkWriter::Send(msg, [this](CliMessage &&part) {
+        OctetString stream{};
+        CliMessage::Encode(part, stream);
 
-    m_socket.send(msg.clientAddr, stream.data(), static_cast<size_t>(stream.length()));
+        m_socket.send(part.clientAddr, stream.data(), static_cast<size_t>(stream.length()));
+    });
 }
 
 void CliMessage::Encode(const CliMessage &msg, OctetString &stream)
@@ -64,11 +56,144 @@ void CliMessage::Encode(const CliMessage &msg, OctetString &stream)
     stream.appendOctet(cons::Minor);
     stream.appendOctet(cons::Patch);
     stream.appendOctet(static_cast<int>(msg.type));
+    if (msg.type == CliMessage::Type::CHUNK)
+    {
+        stream.appendOctet(static_cast<int>(msg.chunkType));
+        stream.appendOctet4(msg.chunkSequence);
+        stream.appendOctet(msg.isLastChunk ? 1 : 0);
+    }
     stream.appendOctet4(static_cast<int>(msg.nodeName.size()));
-    for (char c : msg.nodeName)
-        stream.appendOctet(static_cast<uint8_t>(c));
+    stream.appendUtf8(msg.nodeName);
     stream.appendOctet4(static_cast<int>(msg.value.size()));
-    for (char c : msg.value)
-        stream.appendOctet(static_cast<uint8_t>(c));
+    stream.appendUtf8(msg.value);
+}
+
+bool CliMessage::Decode(const uint8_t *data, size_t size, CliMessage &msg)
+{
+    if (size < static_cast<size_t>(CMD_MIN_LENGTH))
+        return false;
+
+    OctetView v{data, size};
+    if (v.readI() != cons::Major)
+        return false;
+    if (v.readI() != cons::Minor)
+        return false;
+    if (v.readI() != cons::Patch)
+        return false;
+
+    msg.type = static_cast<CliMessage::Type>(v.readI());
+    if (msg.type == CliMessage::Type::CHUNK)
+    {
+        if (size < static_cast<size_t>(CMD_MIN_LENGTH + CMD_CHUNK_INFO_LENGTH))
+            return false;
+        msg.chunkType = static_cast<CliMessage::Type>(v.readI());
+        msg.chunkSequence = v.read4UI();
+        msg.isLastChunk = v.readI() != 0;
+    }
+    auto nodeNameLength = static_cast<size_t>(v.read4UI());
+    if (nodeNameLength > v.remaining() - 4)
+        return false;
+    msg.nodeName = v.readUtf8String(nodeNameLength);
+    auto valueLength = static_cast<size_t>(v.read4UI());
+    if (valueLength > v.remaining())
+        return false;
+    msg.value = v.readUtf8String(valueLength);
+    return true;
 }
+
+CliChunkWriter::CliChunkWriter(const InetAddress &address, CliMessage::Type type, Sender sender)
+    : m_address{address}, m_type{type}, m_sender{std::move(sender)}, m_pending{}, m_sequence{}
+{
+}
+
+void CliChunkWriter::write(const std::string &piece)
+{
+    m_pending += piece;
+
+    // At least one octet is kept for the last chunk
+    size_t offset = 0;
+    while (m_pending.size() - offset > CliMessage::MAX_CHUNK_SIZE)
+    {
+        m_sender(CliMessage::Chunk(m_address, m_type, m_sequence++, false,
+                                   m_pending.substr(offset, CliMessage::MAX_CHUNK_SIZE)));
+        offset += CliMessage::MAX_CHUNK_SIZE;
+    }
+    m_pending.erase(0, offset);
+}
+
+void CliChunkWriter::finish()
+{
+    if (m_sequence == 0)
+    {
+        CliMessage msg{};
+        msg.type = m_type;
+        msg.value = std::move(m_pending);
+        msg.clientAddr = m_address;
+        m_sender(std::move(msg));
+    }
+    else
+    {
+        m_sender(CliMessage::Chunk(m_address, m_type, m_sequence, true, std::move(m_pending)));
+    }
+
+    m_pending.clear();
+    m_sequence = 0;
+}
+
+void CliChunkWriter::Send(const CliMessage &msg, const Sender &sender)
+{
+    if (msg.value.size() <= CliMessage::MAX_CHUNK_SIZE || msg.type == CliMessage::Type::CHUNK)
+    {
+        sender(CliMessage{msg});
+        return;
+    }
+
+    CliChunkWriter writer{msg.clientAddr, msg.type, sender};
+    writer.write(msg.value);
+    writer.finish();
+}
+
+CliChunkAssembler::CliChunkAssembler() : m_value{}, m_nextSequence{}, m_isBroken{}
+{
+}
+
+bool CliChunkAssembler::assemble(CliMessage &msg)
+{
+    if (msg.type != CliMessage::Type::CHUNK)
+        return true;
+
+    // The first chunk starts a new message, discarding what remains of a broken one
+    if (msg.chunkSequence == 0)
+    {
+        m_value.clear();
+        m_nextSequence = 0;
+        m_isBroken = false;
+    }
+
+    if (msg.chunkSequence != m_nextSequence)
+        m_isBroken = true;
+    m_nextSequence = msg.chunkSequence + 1;
+
+    if (!m_isBroken)
+        m_value += msg.value;
+    if (!msg.isLastChunk)
+        return false;
+
+    if (m_isBroken)
+    {
+        msg.type = CliMessage::Type::ERROR;
+        msg.value = "Response is incomplete, some of its parts were lost";
+    }
+    else
+    {
+        msg.type = msg.chunkType;
+        msg.value = std::move(m_value);
+    }
+
+    m_value.clear();
+    m_nextSequence = 0;
+    m_isBroken = false;
+    return true;
+}
+
 } // namespace app
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,13 +30,22 @@ struct CliMessage
         ECHO,
         ERROR,
         RESULT,
-        COMMAND
+        COMMAND,
+        CHUNK
     } type{};
 
     std::string nodeName{}; // todo remove
     std::string value{};
     InetAddress clientAddr{}; // todo remove
 
+    // CHUNK messages carry consecutive parts of the value of a large message of type 'chunkType'
+    Type chunkType{};
+    uint32_t chunkSequence{};
+    bool isLastChunk{};
+
+    /* Maximum number of value octets sent in one datagram */
+    static constexpr const size_t MAX_CHUNK_SIZE = 32768;
+
     static CliMessage Error(InetAddress addr, std::string msg, std::string node = "")
     {
         CliMessage m{};
@@ -75,7 +86,71 @@ struct CliMessage
         return m;
     }
 
+    static CliMessage Chunk(InetAddress addr, Type type, uint32_t sequence, bool isLast, std::string msg)
+    {
+        CliMessage m{};
+        m.type = Type::CHUNK;
+        m.value = std::move(msg);
+        m.nodeName = "";
+        m.clientAddr = addr;
+        m.chunkType = type;
+        m.chunkSequence = sequence;
+        m.isLastChunk = isLast;
+        return m;
+    }
+
     static void Encode(const CliMessage& msg, OctetString& stream);
+    /* Returns false if the message is malformed or of another version. The client address is not set. */
+    static bool Decode(const uint8_t *data, size_t size, CliMessage &msg);
+};
+
+/*
+ * Sends a message whose value may not fit into one datagram. The value is given piece by piece, and it is sent in
+ * CHUNK messages of at most MAX_CHUNK_SIZE octets as soon as enough of it is available. A value that fits into one
+ * datagram is sent as a single message of the given type, as usual.
+ */
+class CliChunkWriter
+{
+  public:
+    using Sender = std::function<void(CliMessage &&msg)>;
+
+  private:
+    InetAddress m_address;
+    CliMessage::Type m_type;
+    Sender m_sender;
+    std::string m_pending;
+    uint32_t m_sequence;
+
+  public:
+    CliChunkWriter(const InetAddress &address, CliMessage::Type type, Sender sender);
+
+  public:
+    void write(const std::string &piece);
+    /* Sends the rest of the value, must be called once at the end */
+    void finish();
+
+  public:
+    /* Sends the message, in chunks if it is too large */
+    static void Send(const CliMessage &msg, const Sender &sender);
+};
+
+/*
+ * Reassembles the messages sent in chunks. The chunks of a message are expected in order, since they are sent on a
+ * local socket. If some of them are lost, the message is completed as an ERROR instead of being shown truncated.
+ */
+class CliChunkAssembler
+{
+  private:
+    std::string m_value;
+    uint32_t m_nextSequence;
+    bool m_isBroken;
+
+  public:
+    CliChunkAssembler();
+
+  public:
+    /* Returns true if the message is complete. The last chunk of a message is replaced with the whole message. */
+    bool assemble(CliMessage &msg);
 };
 
 // todo remove
@@ -87,6 +162,8 @@ class CliServer
   public:
     explicit CliServer() : m_socket{Socket::CreateAndBindUdp({cons::CMD_SERVER_IP, 0})}
     {
+        // Room for the chunks of a large response that arrive before they can be read
+        m_socket.setReceiveBufferSize(4 * 1024 * 1024);
     }
 
     ~CliServer()
@@ -102,12 +179,17 @@ class CliServer
 
 struct NwCliSendResponse : NtsMessage
 {
-    InetAddress address{};
-    std::string output{};
-    bool isError{};
+    CliMessage message{};
 
     NwCliSendResponse(const InetAddress &address, std::string output, bool isError)
-        : NtsMessage(NtsMessageType::CLI_SEND_RESPONSE), address(address), output(std::move(output)), isError(isError)
+        : NtsMessage(NtsMessageType::CLI_SEND_RESPONSE),
+          message(isError ? CliMessage::Error(address, std::move(output))
+                          : CliMessage::Result(address, std::move(output)))
+    {
+    }
+
+    explicit NwCliSendResponse(CliMessage message)
+        : NtsMessage(NtsMessageType::CLI_SEND_RESPONSE), message(std::move(message))
     {
     }
 };
@@ -136,8 +218,7 @@ class CliResponseTask : public NtsTask
         if (msg->msgType == NtsMessageType::CLI_SEND_RESPONSE)
         {
             auto& w = dynamic_cast<NwCliSendResponse &>(*msg);
-            cliServer->sendMessage(w.isError ? CliMessage::Error(w.address, w.output)
-                                             : CliMessage::Result(w.address, w.output));
+            cliServer->sendMessage(w.message);
         }
     }
 
@@ -141,6 +141,24 @@ static opt::OptionsDescription DescForPsEstablish(const std::string &subCommand,
     return res;
 }
 
+static opt::OptionsDescription DescForTrafficStart(const std::string &subCommand, const CmdEntry &entry)
+{
+    std::string example1 = "1 10.45.0.1 --rate 1000 --size 1400";
+    std::string example2 = "1 10.45.0.1 --port 5001 --rate 10000 --burst 10 --duration 60";
+
+    auto res = opt::OptionsDescription{
+        {},  {}, entry.descriptionText, {}, subCommand, {entry.usageText}, {example1, example2}, entry.helpIfEmpty,
+        true};
+
+    res.items.emplace_back('p', "port", "UDP destination port (default: 9)", "port");
+    res.items.emplace_back('s', "size", "Size of the IP packets in octets (default: 128)", "octets");
+    res.items.emplace_back('r', "rate", "Packets per second (default: 10)", "value");
+    res.items.emplace_back('b', "burst", "Packets sent back to back at a time (default: 1)", "value");
+    res.items.emplace_back('d', "duration", "Stop after the given time (default: until stopped)", "seconds");
+
+    return res;
+}
+
 namespace app
 {
 
@@ -152,6 +170,8 @@ static OrderedMap<std::string, CmdEntry> g_gnbCmdEntries = {
     {"ue-list", {"List all UEs associated with the gNB", "", DefaultDesc, false}},
     {"ue-count", {"Print the total number of UEs connected the this gNB", "", DefaultDesc, false}},
     {"ue-release", {"Request a UE context release for the given UE", "<ue-id>", DefaultDesc, false}},
+    {"ngap-stats", {"Show NGAP transport statistics", "", DefaultDesc, false}},
+    {"trace-stats", {"Show the latency histograms of the traced procedures of all UEs", "", DefaultDesc, false}},
 };
 
 static OrderedMap<std::string, CmdEntry> g_ueCmdEntries = {
@@ -160,6 +180,7 @@ static OrderedMap<std::string, CmdEntry> g_ueCmdEntries = {
     {"timers", {"Dump current status of the timers in the UE", "", DefaultDesc, false}},
     {"rls-state", {"Show status information about RLS", "", DefaultDesc, false}},
     {"coverage", {"Dump available cells and PLMNs in the coverage", "", DefaultDesc, false}},
+    {"memory", {"Show memory usage of the UE and the process", "", DefaultDesc, false}},
     {"ps-establish",
      {"Trigger a PDU session establishment procedure", "<session-type> [options]", DescForPsEstablish, true}},
     {"ps-list", {"List all PDU sessions", "", DefaultDesc, false}},
@@ -167,6 +188,14 @@ static OrderedMap<std::string, CmdEntry> g_ueCmdEntries = {
     {"ps-release-all", {"Trigger PDU session release procedures for all active sessions", "", DefaultDesc, false}},
     {"deregister",
      {"Perform a de-registration by the UE", "<normal|disable-5g|switch-off|remove-sim>", DefaultDesc, true}},
+    {"traffic-start",
+     {"Send synthetic UDP packets in uplink of a PDU session", "<pdu-session-id> <ip-address> [options]",
+      DescForTrafficStart, true}},
+    {"traffic-stop",
+     {"Stop the uplink traffic of the given or all PDU sessions", "[pdu-session-id...]", DefaultDesc, false}},
+    {"traffic-stats", {"Show the uplink and downlink traffic of the PDU sessions", "", DefaultDesc, false}},
+    {"trace-stats",
+     {"Show the latency histograms of the traced procedures of all UEs in the process", "", DefaultDesc, false}},
 };
 
 static std::unique_ptr<GnbCliCommand> GnbCliParseImpl(const std::string &subCmd, const opt::OptionsResult &options,
@@ -216,6 +245,14 @@ static std::unique_ptr<GnbCliCommand> GnbCliParseImpl(const std::string &subCmd,
             CMD_ERR("Invalid UE ID")
         return cmd;
     }
+    else if (subCmd == "ngap-stats")
+    {
+        return std::make_unique<GnbCliCommand>(GnbCliCommand::NGAP_STATS);
+    }
+    else if (subCmd == "trace-stats")
+    {
+        return std::make_unique<GnbCliCommand>(GnbCliCommand::TRACE_STATS);
+    }
 
     return nullptr;
 }
@@ -331,6 +368,73 @@ static std::unique_ptr<UeCliCommand> UeCliParseImpl(const std::string &subCmd, c
     {
         return std::make_unique<UeCliCommand>(UeCliCommand::COVERAGE);
     }
+    else if (subCmd == "memory")
+    {
+        return std::make_unique<UeCliCommand>(UeCliCommand::MEMORY);
+    }
+    else if (subCmd == "traffic-start")
+    {
+        auto cmd = std::make_unique<UeCliCommand>(UeCliCommand::TRAFFIC_START);
+        if (options.positionalCount() != 2)
+            CMD_ERR("PDU session ID and destination IP address are expected")
+        int n = 0;
+        if (!utils::TryParseInt(options.getPositional(0), n) || n <= 0 || n > 15)
+            CMD_ERR("Invalid PDU session ID value")
+        cmd->psIds[0] = static_cast<int8_t>(n);
+        cmd->psCount = 1;
+        cmd->trafficDestination = options.getPositional(1);
+        if (utils::GetIpVersion(cmd->trafficDestination) != 4)
+            CMD_ERR("Destination must be an IPv4 address")
+
+        cmd->trafficPort = 9;
+        cmd->trafficPacketSize = 128;
+        cmd->trafficRate = 10;
+        cmd->trafficBurst = 1;
+        if (options.hasFlag('p', "port") &&
+            (!utils::TryParseInt(options.getOption('p', "port"), cmd->trafficPort) || cmd->trafficPort <= 0 ||
+             cmd->trafficPort > 0xFFFF))
+            CMD_ERR("Invalid port value")
+        if (options.hasFlag('s', "size") &&
+            (!utils::TryParseInt(options.getOption('s', "size"), cmd->trafficPacketSize) ||
+             cmd->trafficPacketSize < 48 || cmd->trafficPacketSize > cons::TunMtu))
+            CMD_ERR("Packet size must be between 48 and " + std::to_string(cons::TunMtu))
+        if (options.hasFlag('r', "rate") &&
+            (!utils::TryParseInt(options.getOption('r', "rate"), cmd->trafficRate) || cmd->trafficRate <= 0 ||
+             cmd->trafficRate > 1000000))
+            CMD_ERR("Rate must be between 1 and 1000000 packets per second")
+        if (options.hasFlag('b', "burst") &&
+            (!utils::TryParseInt(options.getOption('b', "burst"), cmd->trafficBurst) || cmd->trafficBurst <= 0 ||
+             cmd->trafficBurst > 1000))
+            CMD_ERR("Burst must be between 1 and 1000 packets")
+        if (options.hasFlag('d', "duration") &&
+            (!utils::TryParseInt(options.getOption('d', "duration"), cmd->trafficDuration) ||
+             cmd->trafficDuration <= 0))
+            CMD_ERR("Invalid duration value")
+        return cmd;
+    }
+    else if (subCmd == "traffic-stop")
+    {
+        auto cmd = std::make_unique<UeCliCommand>(UeCliCommand::TRAFFIC_STOP);
+        if (options.positionalCount() > 15)
+            CMD_ERR("Too many PDU session IDs")
+        cmd->psCount = options.positionalCount();
+        for (int i = 0; i < cmd->psCount; i++)
+        {
+            int n = 0;
+            if (!utils::TryParseInt(options.getPositional(i), n) || n <= 0 || n > 15)
+                CMD_ERR("Invalid PDU session ID value")
+            cmd->psIds[i] = static_cast<int8_t>(n);
+        }
+        return cmd;
+    }
+    else if (subCmd == "traffic-stats")
+    {
+        return std::make_unique<UeCliCommand>(UeCliCommand::TRAFFIC_STATS);
+    }
+    else if (subCmd == "trace-stats")
+    {
+        return std::make_unique<UeCliCommand>(UeCliCommand::TRACE_STATS);
+    }
 
     return nullptr;
 }
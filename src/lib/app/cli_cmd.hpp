@@ -29,6 +29,8 @@ struct GnbCliCommand
         UE_LIST,
         UE_COUNT,
         UE_RELEASE_REQ,
+        NGAP_STATS,
+        TRACE_STATS,
     } present;
 
     // AMF_INFO
@@ -56,12 +58,17 @@ struct UeCliCommand
         DE_REGISTER,
         RLS_STATE,
         COVERAGE,
+        MEMORY,
+        TRAFFIC_START,
+        TRAFFIC_STOP,
+        TRAFFIC_STATS,
+        TRACE_STATS,
     } present;
 
     // DE_REGISTER
     EDeregCause deregCause{};
 
-    // PS_RELEASE
+    // PS_RELEASE, TRAFFIC_START, TRAFFIC_STOP
     std::array<int8_t, 16> psIds{};
     int psCount{};
 
@@ -70,6 +77,14 @@ struct UeCliCommand
     std::optional<std::string> apn{};
     bool isEmergency{};
 
+    // TRAFFIC_START
+    std::string trafficDestination{};
+    int trafficPort{};
+    int trafficPacketSize{};
+    int trafficRate{};
+    int trafficBurst{};
+    int trafficDuration{};
+
     explicit UeCliCommand(PR present) : present(present)
     {
     }
@@ -0,0 +1,142 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "node_selector.hpp"
+
+#include <cstdint>
+
+static constexpr const size_t MAX_RANGE_DIGITS = 18;
+
+struct Range
+{
+    size_t width{};
+    int64_t first{};
+    int64_t last{};
+    size_t end{}; // Index after the closing bracket
+};
+
+static bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool ParseNumber(const std::string &s, size_t &index, size_t &width, int64_t &value)
+{
+    width = 0;
+    value = 0;
+    while (index < s.size() && IsDigit(s[index]))
+    {
+        if (++width > MAX_RANGE_DIGITS)
+            return false;
+        value = value * 10 + (s[index] - '0');
+        index++;
+    }
+    return width > 0;
+}
+
+/* Parses the range starting with the '[' character at the given index */
+static bool ParseRange(const std::string &selector, size_t index, Range &range)
+{
+    index++;
+
+    size_t lastWidth;
+    if (!ParseNumber(selector, index, range.width, range.first))
+        return false;
+    if (index >= selector.size() || selector[index] != '-')
+        return false;
+    index++;
+    if (!ParseNumber(selector, index, lastWidth, range.last))
+        return false;
+    if (index >= selector.size() || selector[index] != ']')
+        return false;
+    if (lastWidth != range.width || range.first > range.last)
+        return false;
+
+    range.end = index + 1;
+    return true;
+}
+
+static bool Match(const std::string &selector, size_t si, const std::string &name, size_t ni)
+{
+    while (si < selector.size())
+    {
+        char c = selector[si];
+        if (c == '*')
+        {
+            for (size_t k = ni; k <= name.size(); k++)
+                if (Match(selector, si + 1, name, k))
+                    return true;
+            return false;
+        }
+        if (c == '[')
+        {
+            Range range{};
+            ParseRange(selector, si, range);
+            if (name.size() - ni < range.width)
+                return false;
+
+            int64_t value = 0;
+            for (size_t k = ni; k < ni + range.width; k++)
+            {
+                if (!IsDigit(name[k]))
+                    return false;
+                value = value * 10 + (name[k] - '0');
+            }
+            if (value < range.first || value > range.last)
+                return false;
+
+            si = range.end;
+            ni += range.width;
+            continue;
+        }
+
+        if (ni >= name.size() || (c != '?' && c != name[ni]))
+            return false;
+        si++;
+        ni++;
+    }
+    return ni == name.size();
+}
+
+namespace app
+{
+
+bool IsNodeSelector(const std::string &name)
+{
+    return name.find_first_of("*?[") != std::string::npos;
+}
+
+bool ValidateNodeSelector(const std::string &selector, std::string &error)
+{
+    for (size_t i = 0; i < selector.size(); i++)
+    {
+        if (selector[i] == ']')
+        {
+            error = "Unexpected ']' in node selector";
+            return false;
+        }
+        if (selector[i] != '[')
+            continue;
+
+        Range range{};
+        if (!ParseRange(selector, i, range))
+        {
+            error = "Invalid range in node selector, '[first-last]' with equal number of digits is expected";
+            return false;
+        }
+        i = range.end - 1;
+    }
+    return true;
+}
+
+bool MatchNodeSelector(const std::string &selector, const std::string &nodeName)
+{
+    return Match(selector, 0, nodeName, 0);
+}
+
+} // namespace app
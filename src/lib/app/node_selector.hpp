@@ -0,0 +1,31 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <string>
+
+namespace app
+{
+
+/*
+ * Node selectors address several nodes with one name. A selector is a node name containing:
+ *   '*'             any sequence of characters (including an empty one),
+ *   '?'             any single character,
+ *   '[first-last]'  a decimal number in the given range, with exactly as many digits as 'first',
+ *                   e.g. 'imsi-00101000000[0000-0999]'.
+ */
+bool IsNodeSelector(const std::string &name);
+
+/* Returns false and sets the error if the selector is malformed */
+bool ValidateNodeSelector(const std::string &selector, std::string &error);
+
+/* The selector must be valid */
+bool MatchNodeSelector(const std::string &selector, const std::string &nodeName);
+
+} // namespace app
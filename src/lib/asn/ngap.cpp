@@ -1004,7 +1004,7 @@ bool AddProtocolIeIfUsable(const ASN_NGAP_NGAP_PDU &pdu, const asn_TYPE_descript
 
     /* Create and add new protocol IE field */
     {
-        void *newIe = calloc(1, inf.ieStructSize);
+        void *newIe = asn_mem_calloc(1, inf.ieStructSize);
 
         *reinterpret_cast<ASN_NGAP_ProtocolIE_ID_t *>((reinterpret_cast<int8_t *>(newIe) + inf.ieIdOffset)) =
             protocolIeId;
@@ -0,0 +1,507 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "ngap_fast.hpp"
+
+#include <cstring>
+
+#include <asn/ngap/ASN_NGAP_Criticality.h>
+#include <asn/ngap/ASN_NGAP_ProcedureCode.h>
+#include <asn/ngap/ASN_NGAP_ProtocolIE-ID.h>
+
+static constexpr const int MAX_SHORT_LENGTH = 127;
+static constexpr const int MAX_LONG_LENGTH = 16383;
+
+// Fixed overhead of a NAS transport message excluding the NAS PDU, rounded up
+static constexpr const size_t NAS_TRANSPORT_OVERHEAD = 128;
+
+namespace
+{
+
+/* Minimal aligned PER writer. Bits are written MSB first, an untouched octet is always zero. */
+class AperWriter
+{
+    uint8_t *m_data;
+    size_t m_capacity;
+    size_t m_bitIndex;
+    bool m_failed;
+
+  public:
+    AperWriter(uint8_t *data, size_t capacity) : m_data(data), m_capacity(capacity), m_bitIndex(0), m_failed(false)
+    {
+    }
+
+    inline void putBits(uint32_t value, int length)
+    {
+        for (int i = length - 1; i >= 0; i--)
+        {
+            size_t octetIndex = m_bitIndex / 8;
+            if (octetIndex >= m_capacity)
+            {
+                m_failed = true;
+                return;
+            }
+            if (m_bitIndex % 8 == 0)
+                m_data[octetIndex] = 0;
+            m_data[octetIndex] |= ((value >> i) & 1) << (7 - m_bitIndex % 8);
+            m_bitIndex++;
+        }
+    }
+
+    inline void align()
+    {
+        m_bitIndex = (m_bitIndex + 7) / 8 * 8;
+    }
+
+    inline void putOctet(uint8_t value)
+    {
+        align();
+        if (m_bitIndex / 8 >= m_capacity)
+        {
+            m_failed = true;
+            return;
+        }
+        m_data[m_bitIndex / 8] = value;
+        m_bitIndex += 8;
+    }
+
+    inline void putOctets(const uint8_t *data, size_t length)
+    {
+        align();
+        if (m_bitIndex / 8 + length > m_capacity)
+        {
+            m_failed = true;
+            return;
+        }
+        std::memcpy(m_data + m_bitIndex / 8, data, length);
+        m_bitIndex += length * 8;
+    }
+
+    inline void putUint16(int value)
+    {
+        putOctet((value >> 8) & 0xFF);
+        putOctet(value & 0xFF);
+    }
+
+    /* Unconstrained length determinant, fragmentation is not supported */
+    inline void putLength(size_t length)
+    {
+        if (length <= MAX_SHORT_LENGTH)
+            putOctet(static_cast<uint8_t>(length));
+        else if (length <= MAX_LONG_LENGTH)
+            putUint16(0x8000 | static_cast<int>(length));
+        else
+            m_failed = true;
+    }
+
+    /* Constrained whole number with a range larger than 64K, see INTEGER_encode_aper of asn1c */
+    inline void putLargeInteger(uint64_t value, int lengthBits)
+    {
+        int lastOctet = 7;
+        while (lastOctet > 0 && (value >> (lastOctet * 8)) == 0)
+            lastOctet--;
+
+        putBits(lastOctet, lengthBits);
+        align();
+        for (int i = lastOctet; i >= 0; i--)
+            putOctet((value >> (i * 8)) & 0xFF);
+    }
+
+    /* Reserves space for an open type length and returns the start of the open type contents */
+    inline size_t beginOpenType()
+    {
+        align();
+        m_bitIndex += 16;
+        return m_bitIndex / 8;
+    }
+
+    inline void endOpenType(size_t start)
+    {
+        align();
+        if (m_failed)
+            return;
+
+        size_t length = m_bitIndex / 8 - start;
+        if (length <= MAX_SHORT_LENGTH)
+        {
+            std::memmove(m_data + start - 1, m_data + start, length);
+            m_data[start - 2] = static_cast<uint8_t>(length);
+            m_bitIndex -= 8;
+        }
+        else if (length <= MAX_LONG_LENGTH)
+        {
+            m_data[start - 2] = static_cast<uint8_t>(0x80 | (length >> 8));
+            m_data[start - 1] = static_cast<uint8_t>(length & 0xFF);
+        }
+        else
+        {
+            m_failed = true;
+        }
+    }
+
+    [[nodiscard]] inline bool failed() const
+    {
+        return m_failed || (m_bitIndex + 7) / 8 > m_capacity;
+    }
+
+    [[nodiscard]] inline size_t length() const
+    {
+        return (m_bitIndex + 7) / 8;
+    }
+};
+
+class AperReader
+{
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_bitIndex;
+    bool m_failed;
+
+  public:
+    AperReader(const uint8_t *data, size_t size) : m_data(data), m_size(size), m_bitIndex(0), m_failed(false)
+    {
+    }
+
+    inline uint32_t getBits(int length)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < length; i++)
+        {
+            if (m_bitIndex / 8 >= m_size)
+            {
+                m_failed = true;
+                return 0;
+            }
+            value = (value << 1) | ((m_data[m_bitIndex / 8] >> (7 - m_bitIndex % 8)) & 1);
+            m_bitIndex++;
+        }
+        return value;
+    }
+
+    inline void align()
+    {
+        m_bitIndex = (m_bitIndex + 7) / 8 * 8;
+    }
+
+    inline int getOctet()
+    {
+        align();
+        if (m_bitIndex / 8 >= m_size)
+        {
+            m_failed = true;
+            return 0;
+        }
+        int value = m_data[m_bitIndex / 8];
+        m_bitIndex += 8;
+        return value;
+    }
+
+    inline int getUint16()
+    {
+        int value = getOctet() << 8;
+        return value | getOctet();
+    }
+
+    inline size_t getLength()
+    {
+        int first = getOctet();
+        if ((first & 0x80) == 0)
+            return first;
+        if ((first & 0xC0) == 0x80)
+            return ((first & 0x3F) << 8) | getOctet();
+
+        // Fragmented lengths are not supported
+        m_failed = true;
+        return 0;
+    }
+
+    inline int64_t getLargeInteger(int lengthBits)
+    {
+        int octets = static_cast<int>(getBits(lengthBits)) + 1;
+        int64_t value = 0;
+        for (int i = 0; i < octets; i++)
+            value = (value << 8) | getOctet();
+        return value;
+    }
+
+    inline const uint8_t *skipOctets(size_t length)
+    {
+        align();
+        if (m_bitIndex / 8 + length > m_size)
+        {
+            m_failed = true;
+            return nullptr;
+        }
+        auto *ptr = m_data + m_bitIndex / 8;
+        m_bitIndex += length * 8;
+        return ptr;
+    }
+
+    [[nodiscard]] inline size_t octetIndex() const
+    {
+        return (m_bitIndex + 7) / 8;
+    }
+
+    [[nodiscard]] inline bool failed() const
+    {
+        return m_failed;
+    }
+};
+
+/* AMF-UE-NGAP-ID ::= INTEGER (0..1099511627775) */
+constexpr const int AMF_UE_NGAP_ID_LENGTH_BITS = 3;
+constexpr const int64_t AMF_UE_NGAP_ID_MAX = 1099511627775LL;
+
+/* RAN-UE-NGAP-ID ::= INTEGER (0..4294967295) */
+constexpr const int RAN_UE_NGAP_ID_LENGTH_BITS = 2;
+constexpr const int64_t RAN_UE_NGAP_ID_MAX = 4294967295LL;
+
+/* Number of root values of RRCEstablishmentCause */
+constexpr const int RRC_ESTABLISHMENT_CAUSE_ROOT_COUNT = 10;
+
+inline size_t BeginMessage(AperWriter &w, int procedureCode, int ieCount)
+{
+    // NGAP-PDU: extension bit and choice index of initiatingMessage
+    w.putBits(0, 1);
+    w.putBits(0, 2);
+    // InitiatingMessage: procedureCode and criticality
+    w.putOctet(static_cast<uint8_t>(procedureCode));
+    w.putBits(ASN_NGAP_Criticality_ignore, 2);
+
+    size_t start = w.beginOpenType();
+    // Message SEQUENCE extension bit and ProtocolIE-Container size
+    w.putBits(0, 1);
+    w.align();
+    w.putUint16(ieCount);
+    return start;
+}
+
+inline size_t BeginIe(AperWriter &w, int id, int criticality)
+{
+    w.putUint16(id);
+    w.putBits(criticality, 2);
+    return w.beginOpenType();
+}
+
+inline void PutAmfUeNgapIdIe(AperWriter &w, int64_t value, int criticality)
+{
+    size_t ie = BeginIe(w, ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID, criticality);
+    w.putLargeInteger(static_cast<uint64_t>(value), AMF_UE_NGAP_ID_LENGTH_BITS);
+    w.endOpenType(ie);
+}
+
+inline void PutRanUeNgapIdIe(AperWriter &w, int64_t value, int criticality)
+{
+    size_t ie = BeginIe(w, ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID, criticality);
+    w.putLargeInteger(static_cast<uint64_t>(value), RAN_UE_NGAP_ID_LENGTH_BITS);
+    w.endOpenType(ie);
+}
+
+inline void PutNasPduIe(AperWriter &w, const OctetString &nasPdu, int criticality)
+{
+    size_t ie = BeginIe(w, ASN_NGAP_ProtocolIE_ID_id_NAS_PDU, criticality);
+    w.putLength(nasPdu.length());
+    w.putOctets(nasPdu.data(), nasPdu.length());
+    w.endOpenType(ie);
+}
+
+inline void PutOctet3(AperWriter &w, const octet3 &value)
+{
+    w.putOctet(value[0]);
+    w.putOctet(value[1]);
+    w.putOctet(value[2]);
+}
+
+inline void PutUserLocationIe(AperWriter &w, const asn::ngap::fast::NrUserLocation &location, int criticality)
+{
+    size_t ie = BeginIe(w, ASN_NGAP_ProtocolIE_ID_id_UserLocationInformation, criticality);
+
+    // UserLocationInformation CHOICE index of userLocationInformationNR
+    w.putBits(1, 2);
+    // UserLocationInformationNR: extension bit, timeStamp and iE-Extensions presence
+    w.putBits(0, 1);
+    w.putBits(location.timeStamp.has_value() ? 1 : 0, 1);
+    w.putBits(0, 1);
+
+    // NR-CGI: extension bit, iE-Extensions presence, PLMN identity and 36-bit NR cell identity
+    w.putBits(0, 2);
+    PutOctet3(w, location.plmn);
+    w.align();
+    w.putBits(static_cast<uint32_t>((location.nci >> 4) & 0xFFFFFFFF), 32);
+    w.putBits(static_cast<uint32_t>(location.nci & 0xF), 4);
+
+    // TAI: extension bit, iE-Extensions presence, PLMN identity and TAC
+    w.putBits(0, 2);
+    PutOctet3(w, location.plmn);
+    PutOctet3(w, location.tac);
+
+    if (location.timeStamp.has_value())
+    {
+        for (int i = 0; i < 4; i++)
+            w.putOctet(location.timeStamp.value()[i]);
+    }
+
+    w.endOpenType(ie);
+}
+
+inline bool Finish(AperWriter &w, size_t message, size_t &encoded)
+{
+    w.endOpenType(message);
+    if (w.failed())
+        return false;
+    encoded = w.length();
+    return true;
+}
+
+} // namespace
+
+namespace asn::ngap::fast
+{
+
+size_t NasTransportEncodeBound(size_t nasPduLength)
+{
+    return NAS_TRANSPORT_OVERHEAD + nasPduLength;
+}
+
+bool EncodeInitialUeMessage(int64_t ranUeNgapId, const OctetString &nasPdu, const NrUserLocation &location,
+                            int64_t rrcEstablishmentCause, const std::optional<FiveGSTmsi> &sTmsi, uint8_t *buffer,
+                            size_t capacity, size_t &encoded)
+{
+    if (ranUeNgapId < 0 || ranUeNgapId > RAN_UE_NGAP_ID_MAX)
+        return false;
+    // Extension values of the establishment cause are not handled by the fast path
+    if (rrcEstablishmentCause < 0 || rrcEstablishmentCause >= RRC_ESTABLISHMENT_CAUSE_ROOT_COUNT)
+        return false;
+
+    AperWriter w{buffer, capacity};
+    size_t message = BeginMessage(w, ASN_NGAP_ProcedureCode_id_InitialUEMessage, sTmsi.has_value() ? 6 : 5);
+
+    PutRanUeNgapIdIe(w, ranUeNgapId, ASN_NGAP_Criticality_reject);
+    PutNasPduIe(w, nasPdu, ASN_NGAP_Criticality_reject);
+    PutUserLocationIe(w, location, ASN_NGAP_Criticality_reject);
+
+    size_t ie = BeginIe(w, ASN_NGAP_ProtocolIE_ID_id_RRCEstablishmentCause, ASN_NGAP_Criticality_ignore);
+    w.putBits(0, 1);
+    w.putBits(static_cast<uint32_t>(rrcEstablishmentCause), 4);
+    w.endOpenType(ie);
+
+    if (sTmsi.has_value())
+    {
+        ie = BeginIe(w, ASN_NGAP_ProtocolIE_ID_id_FiveG_S_TMSI, ASN_NGAP_Criticality_reject);
+        // Extension bit, iE-Extensions presence, AMF set ID and AMF pointer
+        w.putBits(0, 2);
+        w.putBits(sTmsi->amfSetId & 0x3FF, 10);
+        w.putBits(sTmsi->amfPointer & 0x3F, 6);
+        for (int i = 0; i < 4; i++)
+            w.putOctet(sTmsi->tmsi[i]);
+        w.endOpenType(ie);
+    }
+
+    // UEContextRequest ::= ENUMERATED {requested, ...}, only the extension bit is encoded
+    ie = BeginIe(w, ASN_NGAP_ProtocolIE_ID_id_UEContextRequest, ASN_NGAP_Criticality_ignore);
+    w.putBits(0, 1);
+    w.endOpenType(ie);
+
+    return Finish(w, message, encoded);
+}
+
+bool EncodeUplinkNasTransport(int64_t amfUeNgapId, int64_t ranUeNgapId, const OctetString &nasPdu,
+                              const NrUserLocation &location, uint8_t *buffer, size_t capacity, size_t &encoded)
+{
+    if (amfUeNgapId < 0 || amfUeNgapId > AMF_UE_NGAP_ID_MAX || ranUeNgapId < 0 || ranUeNgapId > RAN_UE_NGAP_ID_MAX)
+        return false;
+
+    AperWriter w{buffer, capacity};
+    size_t message = BeginMessage(w, ASN_NGAP_ProcedureCode_id_UplinkNASTransport, 4);
+
+    PutAmfUeNgapIdIe(w, amfUeNgapId, ASN_NGAP_Criticality_reject);
+    PutRanUeNgapIdIe(w, ranUeNgapId, ASN_NGAP_Criticality_reject);
+    PutNasPduIe(w, nasPdu, ASN_NGAP_Criticality_reject);
+    PutUserLocationIe(w, location, ASN_NGAP_Criticality_ignore);
+
+    return Finish(w, message, encoded);
+}
+
+bool EncodeDownlinkNasTransport(int64_t amfUeNgapId, int64_t ranUeNgapId, const OctetString &nasPdu, uint8_t *buffer,
+                                size_t capacity, size_t &encoded)
+{
+    if (amfUeNgapId < 0 || amfUeNgapId > AMF_UE_NGAP_ID_MAX || ranUeNgapId < 0 || ranUeNgapId > RAN_UE_NGAP_ID_MAX)
+        return false;
+
+    AperWriter w{buffer, capacity};
+    size_t message = BeginMessage(w, ASN_NGAP_ProcedureCode_id_DownlinkNASTransport, 3);
+
+    PutAmfUeNgapIdIe(w, amfUeNgapId, ASN_NGAP_Criticality_reject);
+    PutRanUeNgapIdIe(w, ranUeNgapId, ASN_NGAP_Criticality_reject);
+    PutNasPduIe(w, nasPdu, ASN_NGAP_Criticality_reject);
+
+    return Finish(w, message, encoded);
+}
+
+bool DecodeNasTransport(const uint8_t *buffer, size_t length, NasTransportInfo &info)
+{
+    AperReader r{buffer, length};
+
+    // Only root alternative initiatingMessage is handled
+    if (r.getBits(1) != 0 || r.getBits(2) != 0)
+        return false;
+
+    int procedureCode = r.getOctet();
+    if (procedureCode != ASN_NGAP_ProcedureCode_id_InitialUEMessage &&
+        procedureCode != ASN_NGAP_ProcedureCode_id_UplinkNASTransport &&
+        procedureCode != ASN_NGAP_ProcedureCode_id_DownlinkNASTransport)
+        return false;
+
+    r.getBits(2); // criticality
+    size_t messageLength = r.getLength();
+    size_t messageEnd = r.octetIndex() + messageLength;
+    if (r.failed() || messageEnd > length)
+        return false;
+
+    // Extension additions of the message are not handled by the fast path
+    if (r.getBits(1) != 0)
+        return false;
+
+    info = {};
+    info.procedureCode = procedureCode;
+
+    int ieCount = r.getUint16();
+    for (int i = 0; i < ieCount && !r.failed(); i++)
+    {
+        int id = r.getUint16();
+        r.getBits(2); // criticality
+        size_t ieLength = r.getLength();
+        size_t ieEnd = r.octetIndex() + ieLength;
+        if (r.failed() || ieEnd > messageEnd)
+            return false;
+
+        switch (id)
+        {
+        case ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID:
+            info.amfUeNgapId = r.getLargeInteger(AMF_UE_NGAP_ID_LENGTH_BITS);
+            break;
+        case ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID:
+            info.ranUeNgapId = r.getLargeInteger(RAN_UE_NGAP_ID_LENGTH_BITS);
+            break;
+        case ASN_NGAP_ProtocolIE_ID_id_NAS_PDU:
+            info.nasPduLength = r.getLength();
+            info.nasPdu = r.skipOctets(info.nasPduLength);
+            break;
+        default:
+            break;
+        }
+
+        if (r.failed() || r.octetIndex() > ieEnd)
+            return false;
+        r.skipOctets(ieEnd - r.octetIndex());
+    }
+
+    return !r.failed() && info.nasPdu != nullptr && r.octetIndex() == messageEnd;
+}
+
+} // namespace asn::ngap::fast
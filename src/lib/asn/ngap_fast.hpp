@@ -0,0 +1,69 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <utils/octet.hpp>
+#include <utils/octet_string.hpp>
+
+/*
+ * Hand-specialised APER codec for the fixed-shape NAS transport messages (Initial UE Message, Uplink NAS Transport
+ * and Downlink NAS Transport). The output is byte-identical to the asn1c encoding of the same message built by the
+ * generic NGAP code. All functions return false if the fast path does not apply, in which case the caller must fall
+ * back to asn1c.
+ */
+namespace asn::ngap::fast
+{
+
+struct NrUserLocation
+{
+    octet3 plmn{}; // Encoded PLMN identity
+    int64_t nci{}; // 36-bit
+    octet3 tac{};
+    std::optional<octet4> timeStamp{};
+};
+
+struct FiveGSTmsi
+{
+    int amfSetId{};   // 10-bit
+    int amfPointer{}; // 6-bit
+    octet4 tmsi{};
+};
+
+struct NasTransportInfo
+{
+    int procedureCode{};
+    std::optional<int64_t> amfUeNgapId{};
+    std::optional<int64_t> ranUeNgapId{};
+
+    // Points into the decoded buffer
+    const uint8_t *nasPdu{};
+    size_t nasPduLength{};
+};
+
+/* Upper bound of the encoded size of any NAS transport message carrying a NAS PDU of the given length */
+size_t NasTransportEncodeBound(size_t nasPduLength);
+
+bool EncodeInitialUeMessage(int64_t ranUeNgapId, const OctetString &nasPdu, const NrUserLocation &location,
+                            int64_t rrcEstablishmentCause, const std::optional<FiveGSTmsi> &sTmsi, uint8_t *buffer,
+                            size_t capacity, size_t &encoded);
+
+bool EncodeUplinkNasTransport(int64_t amfUeNgapId, int64_t ranUeNgapId, const OctetString &nasPdu,
+                              const NrUserLocation &location, uint8_t *buffer, size_t capacity, size_t &encoded);
+
+bool EncodeDownlinkNasTransport(int64_t amfUeNgapId, int64_t ranUeNgapId, const OctetString &nasPdu, uint8_t *buffer,
+                                size_t capacity, size_t &encoded);
+
+/* Decodes the UE NGAP IDs and the NAS PDU of a NAS transport message. Other IEs are skipped. */
+bool DecodeNasTransport(const uint8_t *buffer, size_t length, NasTransportInfo &info);
+
+} // namespace asn::ngap::fast
@@ -0,0 +1,188 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "ngap_nas.hpp"
+#include "ngap.hpp"
+#include "utils.hpp"
+
+#include <vector>
+
+#include <asn/ngap/ASN_NGAP_AMF-UE-NGAP-ID.h>
+#include <asn/ngap/ASN_NGAP_DownlinkNASTransport.h>
+#include <asn/ngap/ASN_NGAP_InitialUEMessage.h>
+#include <asn/ngap/ASN_NGAP_InitiatingMessage.h>
+#include <asn/ngap/ASN_NGAP_NGAP-PDU.h>
+#include <asn/ngap/ASN_NGAP_ProtocolIE-Field.h>
+#include <asn/ngap/ASN_NGAP_RAN-UE-NGAP-ID.h>
+#include <asn/ngap/ASN_NGAP_SuccessfulOutcome.h>
+#include <asn/ngap/ASN_NGAP_UnsuccessfulOutcome.h>
+#include <asn/ngap/ASN_NGAP_UplinkNASTransport.h>
+#include <asn/ngap/ASN_NGAP_UserLocationInformation.h>
+#include <asn/ngap/ASN_NGAP_UserLocationInformationNR.h>
+
+static e_ASN_NGAP_Criticality FindCriticalityOfUserIe(const ASN_NGAP_NGAP_PDU *pdu, ASN_NGAP_ProtocolIE_ID_t ieId)
+{
+    auto procedureCode =
+        pdu->present == ASN_NGAP_NGAP_PDU_PR_initiatingMessage   ? pdu->choice.initiatingMessage->procedureCode
+        : pdu->present == ASN_NGAP_NGAP_PDU_PR_successfulOutcome ? pdu->choice.successfulOutcome->procedureCode
+                                                                 : pdu->choice.unsuccessfulOutcome->procedureCode;
+
+    if (ieId == ASN_NGAP_ProtocolIE_ID_id_UserLocationInformation)
+    {
+        return procedureCode == ASN_NGAP_ProcedureCode_id_InitialUEMessage ? ASN_NGAP_Criticality_reject
+                                                                           : ASN_NGAP_Criticality_ignore;
+    }
+
+    if (ieId == ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID || ieId == ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID)
+    {
+        if (procedureCode == ASN_NGAP_ProcedureCode_id_RerouteNASRequest)
+        {
+            return ieId == ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID ? ASN_NGAP_Criticality_reject
+                                                                    : ASN_NGAP_Criticality_ignore;
+        }
+
+        if (pdu->present == ASN_NGAP_NGAP_PDU_PR_initiatingMessage)
+        {
+            if (procedureCode == ASN_NGAP_ProcedureCode_id_UEContextReleaseRequest ||
+                procedureCode == ASN_NGAP_ProcedureCode_id_HandoverPreparation)
+                return ASN_NGAP_Criticality_reject;
+        }
+
+        if (procedureCode == ASN_NGAP_ProcedureCode_id_PDUSessionResourceNotify ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_PDUSessionResourceModifyIndication ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_RRCInactiveTransitionReport ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_HandoverNotification ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_PathSwitchRequest ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_HandoverCancel ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_UplinkRANStatusTransfer ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_InitialUEMessage ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_DownlinkNASTransport ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_UplinkNASTransport ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_NASNonDeliveryIndication ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_UplinkUEAssociatedNRPPaTransport ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_UplinkNonUEAssociatedNRPPaTransport ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_CellTrafficTrace ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_TraceStart ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_DeactivateTrace ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_TraceFailureIndication ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_LocationReport ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_LocationReportingControl ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_LocationReportingFailureIndication ||
+            procedureCode == ASN_NGAP_ProcedureCode_id_UERadioCapabilityInfoIndication)
+            return ASN_NGAP_Criticality_reject;
+    }
+
+    return ASN_NGAP_Criticality_ignore;
+}
+
+namespace asn::ngap
+{
+
+ASN_NGAP_NGAP_PDU *NewInitialUeMessage(const OctetString &nasPdu, int64_t rrcEstablishmentCause,
+                                       const std::optional<fast::FiveGSTmsi> &sTmsi)
+{
+    std::vector<ASN_NGAP_InitialUEMessage_IEs *> ies;
+
+    auto *ieEstablishmentCause = asn::New<ASN_NGAP_InitialUEMessage_IEs>();
+    ieEstablishmentCause->id = ASN_NGAP_ProtocolIE_ID_id_RRCEstablishmentCause;
+    ieEstablishmentCause->criticality = ASN_NGAP_Criticality_ignore;
+    ieEstablishmentCause->value.present = ASN_NGAP_InitialUEMessage_IEs__value_PR_RRCEstablishmentCause;
+    ieEstablishmentCause->value.choice.RRCEstablishmentCause = rrcEstablishmentCause;
+    ies.push_back(ieEstablishmentCause);
+
+    auto *ieCtxRequest = asn::New<ASN_NGAP_InitialUEMessage_IEs>();
+    ieCtxRequest->id = ASN_NGAP_ProtocolIE_ID_id_UEContextRequest;
+    ieCtxRequest->criticality = ASN_NGAP_Criticality_ignore;
+    ieCtxRequest->value.present = ASN_NGAP_InitialUEMessage_IEs__value_PR_UEContextRequest;
+    ieCtxRequest->value.choice.UEContextRequest = ASN_NGAP_UEContextRequest_requested;
+    ies.push_back(ieCtxRequest);
+
+    auto *ieNasPdu = asn::New<ASN_NGAP_InitialUEMessage_IEs>();
+    ieNasPdu->id = ASN_NGAP_ProtocolIE_ID_id_NAS_PDU;
+    ieNasPdu->criticality = ASN_NGAP_Criticality_reject;
+    ieNasPdu->value.present = ASN_NGAP_InitialUEMessage_IEs__value_PR_NAS_PDU;
+    asn::SetOctetString(ieNasPdu->value.choice.NAS_PDU, nasPdu);
+    ies.push_back(ieNasPdu);
+
+    if (sTmsi)
+    {
+        auto *ieTmsi = asn::New<ASN_NGAP_InitialUEMessage_IEs>();
+        ieTmsi->id = ASN_NGAP_ProtocolIE_ID_id_FiveG_S_TMSI;
+        ieTmsi->criticality = ASN_NGAP_Criticality_reject;
+        ieTmsi->value.present = ASN_NGAP_InitialUEMessage_IEs__value_PR_FiveG_S_TMSI;
+
+        asn::SetBitStringInt<10>(sTmsi->amfSetId, ieTmsi->value.choice.FiveG_S_TMSI.aMFSetID);
+        asn::SetBitStringInt<6>(sTmsi->amfPointer, ieTmsi->value.choice.FiveG_S_TMSI.aMFPointer);
+        asn::SetOctetString4(ieTmsi->value.choice.FiveG_S_TMSI.fiveG_TMSI, sTmsi->tmsi);
+        ies.push_back(ieTmsi);
+    }
+
+    return NewMessagePdu<ASN_NGAP_InitialUEMessage>(ies);
+}
+
+ASN_NGAP_NGAP_PDU *NewUplinkNasTransport(const OctetString &nasPdu)
+{
+    auto *ieNasPdu = asn::New<ASN_NGAP_UplinkNASTransport_IEs>();
+    ieNasPdu->id = ASN_NGAP_ProtocolIE_ID_id_NAS_PDU;
+    ieNasPdu->criticality = ASN_NGAP_Criticality_reject;
+    ieNasPdu->value.present = ASN_NGAP_UplinkNASTransport_IEs__value_PR_NAS_PDU;
+    asn::SetOctetString(ieNasPdu->value.choice.NAS_PDU, nasPdu);
+
+    return NewMessagePdu<ASN_NGAP_UplinkNASTransport>({ieNasPdu});
+}
+
+ASN_NGAP_NGAP_PDU *NewDownlinkNasTransport(const OctetString &nasPdu)
+{
+    auto *ieNasPdu = asn::New<ASN_NGAP_DownlinkNASTransport_IEs>();
+    ieNasPdu->id = ASN_NGAP_ProtocolIE_ID_id_NAS_PDU;
+    ieNasPdu->criticality = ASN_NGAP_Criticality_reject;
+    ieNasPdu->value.present = ASN_NGAP_DownlinkNASTransport_IEs__value_PR_NAS_PDU;
+    asn::SetOctetString(ieNasPdu->value.choice.NAS_PDU, nasPdu);
+
+    return NewMessagePdu<ASN_NGAP_DownlinkNASTransport>({ieNasPdu});
+}
+
+void AddUeAssociatedIes(ASN_NGAP_NGAP_PDU &pdu, const std::optional<int64_t> &amfUeNgapId, int64_t ranUeNgapId,
+                        const fast::NrUserLocation &location)
+{
+    if (amfUeNgapId.has_value())
+    {
+        AddProtocolIeIfUsable(pdu, asn_DEF_ASN_NGAP_AMF_UE_NGAP_ID, ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID,
+                              FindCriticalityOfUserIe(&pdu, ASN_NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID),
+                              [&amfUeNgapId](void *mem) {
+                                  auto &id = *reinterpret_cast<ASN_NGAP_AMF_UE_NGAP_ID_t *>(mem);
+                                  asn::SetSigned64(*amfUeNgapId, id);
+                              });
+    }
+
+    AddProtocolIeIfUsable(
+        pdu, asn_DEF_ASN_NGAP_RAN_UE_NGAP_ID, ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID,
+        FindCriticalityOfUserIe(&pdu, ASN_NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID),
+        [ranUeNgapId](void *mem) { *reinterpret_cast<ASN_NGAP_RAN_UE_NGAP_ID_t *>(mem) = ranUeNgapId; });
+
+    AddProtocolIeIfUsable(
+        pdu, asn_DEF_ASN_NGAP_UserLocationInformation, ASN_NGAP_ProtocolIE_ID_id_UserLocationInformation,
+        FindCriticalityOfUserIe(&pdu, ASN_NGAP_ProtocolIE_ID_id_UserLocationInformation), [&location](void *mem) {
+            auto *loc = reinterpret_cast<ASN_NGAP_UserLocationInformation *>(mem);
+            loc->present = ASN_NGAP_UserLocationInformation_PR_userLocationInformationNR;
+            loc->choice.userLocationInformationNR = asn::New<ASN_NGAP_UserLocationInformationNR>();
+
+            auto &nr = loc->choice.userLocationInformationNR;
+            asn::SetOctetString3(nr->nR_CGI.pLMNIdentity, location.plmn);
+            asn::SetBitStringLong<36>(location.nci, nr->nR_CGI.nRCellIdentity);
+            asn::SetOctetString3(nr->tAI.pLMNIdentity, location.plmn);
+            asn::SetOctetString3(nr->tAI.tAC, location.tac);
+            if (location.timeStamp.has_value())
+            {
+                nr->timeStamp = asn::New<ASN_NGAP_TimeStamp_t>();
+                asn::SetOctetString4(*nr->timeStamp, *location.timeStamp);
+            }
+        });
+}
+
+} // namespace asn::ngap
@@ -0,0 +1,42 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include "ngap_fast.hpp"
+
+#include <cstdint>
+#include <optional>
+
+#include <utils/octet_string.hpp>
+
+extern "C"
+{
+    struct ASN_NGAP_NGAP_PDU;
+}
+
+/*
+ * asn1c builders of the NAS transport messages. They are used by the gNB and the core when the fast codec does not
+ * apply, and by nr-bench as the reference the fast codec is compared against.
+ */
+namespace asn::ngap
+{
+
+ASN_NGAP_NGAP_PDU *NewInitialUeMessage(const OctetString &nasPdu, int64_t rrcEstablishmentCause,
+                                       const std::optional<fast::FiveGSTmsi> &sTmsi);
+ASN_NGAP_NGAP_PDU *NewUplinkNasTransport(const OctetString &nasPdu);
+ASN_NGAP_NGAP_PDU *NewDownlinkNasTransport(const OctetString &nasPdu);
+
+/*
+ * Adds the UE NGAP IDs and the user location to a UE associated PDU of the gNB, each if the message has such an IE,
+ * with the criticality required by the procedure. The AMF UE NGAP ID is not added if it is not assigned yet.
+ */
+void AddUeAssociatedIes(ASN_NGAP_NGAP_PDU &pdu, const std::optional<int64_t> &amfUeNgapId, int64_t ranUeNgapId,
+                        const fast::NrUserLocation &location);
+
+} // namespace asn::ngap
@@ -9,6 +9,7 @@
 #include "utils.hpp"
 
 #include <cstring>
+#include <new>
 #include <stdexcept>
 
 #include <utils/octet_string.hpp>
@@ -63,9 +64,9 @@ void SetOctetString(OCTET_STRING_t &target, const OctetString &value)
 void SetBitString(BIT_STRING_t &target, octet4 value, size_t bitCount)
 {
     if (target.buf)
-        free(target.buf);
+        asn_mem_free(target.buf);
 
-    target.buf = static_cast<uint8_t *>(calloc(4, 1));
+    target.buf = static_cast<uint8_t *>(asn_mem_calloc(4, 1));
     target.buf[0] = value[0];
     target.buf[1] = value[1];
     target.buf[2] = value[2];
@@ -77,8 +78,8 @@ void SetBitString(BIT_STRING_t &target, octet4 value, size_t bitCount)
 void SetBitString(BIT_STRING_t &target, const OctetString &value)
 {
     if (target.buf)
-        free(target.buf);
-    target.buf = static_cast<uint8_t *>(calloc(value.length(), 1));
+        asn_mem_free(target.buf);
+    target.buf = static_cast<uint8_t *>(asn_mem_calloc(value.length(), 1));
     std::memcpy(target.buf, value.data(), value.length());
     target.size = value.length();
     target.bits_unused = 0;
@@ -154,7 +155,7 @@ void SetUnsigned64(uint64_t value, INTEGER_t &target)
     {
         if (target.buf != nullptr)
         {
-            free(target.buf);
+            asn_mem_free(target.buf);
             target.buf = nullptr;
         }
         target.size = 0;
@@ -167,11 +168,32 @@ void SetSigned64(int64_t value, INTEGER_t &target)
     {
         if (target.buf != nullptr)
         {
-            free(target.buf);
+            asn_mem_free(target.buf);
             target.buf = nullptr;
         }
         target.size = 0;
     }
 }
 
-} // namespace asn
\ No newline at end of file
+Arena::Arena(size_t chunkSize) : m_arena{asn_arena_new(chunkSize)}
+{
+    if (m_arena == nullptr)
+        throw std::bad_alloc();
+}
+
+Arena::~Arena()
+{
+    asn_arena_delete(m_arena);
+}
+
+ArenaScope::ArenaScope(Arena &arena) : m_arena{arena}, m_previous{asn_arena_activate(arena.get())}
+{
+}
+
+ArenaScope::~ArenaScope()
+{
+    asn_arena_activate(m_previous);
+    asn_arena_reset(m_arena.get());
+}
+
+} // namespace asn
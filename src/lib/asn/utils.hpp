@@ -21,6 +21,7 @@
 #include <OCTET_STRING.h>
 #include <PrintableString.h>
 #include <asn_SEQUENCE_OF.h>
+#include <asn_arena.h>
 #include <asn_application.h>
 
 #include <utils/bit_buffer.hpp>
@@ -33,7 +34,7 @@ namespace asn
 template <typename T>
 inline T *New()
 {
-    return (T *)calloc(1, sizeof(T));
+    return (T *)asn_mem_calloc(1, sizeof(T));
 }
 
 template <typename T>
@@ -55,6 +56,40 @@ inline void Free(asn_TYPE_descriptor_t &desc, T *ptr)
     ASN_STRUCT_FREE(desc, ptr);
 }
 
+/* Owns an allocation arena for asn1c structures, see asn_arena.h */
+class Arena
+{
+    asn_arena_t *m_arena;
+
+  public:
+    explicit Arena(size_t chunkSize = 16 * 1024);
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    [[nodiscard]] inline asn_arena_t *get() const
+    {
+        return m_arena;
+    }
+};
+
+/* While alive, asn1c structures allocated by this thread come from the given arena, which is reset when the scope
+ * ends. Structures allocated inside the scope must not be used after it, and buffers returned by
+ * asn_encode_to_new_buffer are not affected. */
+class ArenaScope
+{
+    Arena &m_arena;
+    asn_arena_t *m_previous;
+
+  public:
+    explicit ArenaScope(Arena &arena);
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+};
+
 template <typename T>
 struct AsnTraits_ListItemType
 {
@@ -87,9 +122,9 @@ inline void SetBitStringInt(int value, BIT_STRING_t &target)
     static_assert(BitCount >= 1 && BitCount <= 32);
 
     if (target.buf != nullptr)
-        free(target.buf);
+        asn_mem_free(target.buf);
     target.size = bits::NearDiv(static_cast<int>(BitCount), 8) / 8;
-    target.buf = static_cast<uint8_t *>(calloc(1, target.size));
+    target.buf = static_cast<uint8_t *>(asn_mem_calloc(1, target.size));
     target.bits_unused = (8 - (static_cast<int>(BitCount) % 8)) % 8;
     BitBuffer{target.buf}.writeBits(value, BitCount);
 }
@@ -100,9 +135,9 @@ inline void SetBitStringLong(int64_t value, BIT_STRING_t &target)
     static_assert(BitCount >= 1 && BitCount <= 64);
 
     if (target.buf != nullptr)
-        free(target.buf);
+        asn_mem_free(target.buf);
     target.size = bits::NearDiv(static_cast<int>(BitCount), 8) / 8;
-    target.buf = static_cast<uint8_t *>(calloc(1, target.size));
+    target.buf = static_cast<uint8_t *>(asn_mem_calloc(1, target.size));
     target.bits_unused = (8 - (static_cast<int>(BitCount) % 8)) % 8;
     BitBuffer{target.buf}.writeBits(value, BitCount);
 }
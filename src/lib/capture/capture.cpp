@@ -0,0 +1,328 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "capture.hpp"
+#include "pcapng.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include <utils/common.hpp>
+#include <utils/constants.hpp>
+#include <utils/io.hpp>
+
+static constexpr const uint64_t RING_SIZE = 4096; // Must be a power of two
+static constexpr const int IDLE_SLEEP_MS = 5;
+
+static constexpr const char *INTERFACE_NAMES[] = {"rls", "gtp", "ngap"};
+static constexpr const char *DISSECTOR_NAMES[] = {"rls", "gtp", "ngap"}; // See tools/rls-wireshark-dissector.lua
+static constexpr const int INTERFACE_COUNT = 3;
+
+namespace
+{
+
+struct Slot
+{
+    std::atomic<uint64_t> sequence{};
+    int64_t time{};
+    capture::EInterface itf{};
+    capture::EDirection direction{};
+    int ueId{};
+    uint32_t teid{};
+    uint32_t length{};
+    uint32_t capturedLength{};
+};
+
+/*
+ * Bounded multi-producer ring with a single consumer. A slot is free for the producer claiming position 'pos' when its
+ * sequence is 'pos', and it is readable by the consumer when its sequence is 'pos + 1'.
+ */
+class CaptureSession
+{
+  private:
+    capture::CaptureConfig m_config;
+    std::string m_name;
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::unique_ptr<uint8_t[]> m_data; // 'snapLength' octets per slot
+    std::atomic<uint64_t> m_enqueuePos;
+    std::atomic<uint64_t> m_dropped;
+    uint64_t m_dequeuePos;
+
+    std::vector<std::vector<uint8_t>> m_headers; // Exported PDU header of each interface
+    std::vector<uint8_t> m_block;
+    FILE *m_file;
+    int64_t m_fileSize;
+    int m_fileIndex;
+    std::deque<std::string> m_files;
+
+  public:
+    CaptureSession(const capture::CaptureConfig &config, std::string name)
+        : m_config{config}, m_name{std::move(name)}, m_slots{new Slot[RING_SIZE]},
+          m_data{new uint8_t[RING_SIZE * static_cast<size_t>(config.snapLength)]}, m_enqueuePos{}, m_dropped{},
+          m_dequeuePos{}, m_headers{}, m_block{}, m_file{}, m_fileSize{}, m_fileIndex{}, m_files{}
+    {
+        for (uint64_t i = 0; i < RING_SIZE; i++)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        for (auto *dissector : DISSECTOR_NAMES)
+            m_headers.push_back(capture::pcapng::ExportedPduHeader(dissector));
+    }
+
+    bool matches(int ueId, uint32_t teid) const
+    {
+        auto &filter = m_config.filter;
+        if (filter.ueIds.empty() && filter.teids.empty())
+            return true;
+        if (ueId != 0 && std::find(filter.ueIds.begin(), filter.ueIds.end(), ueId) != filter.ueIds.end())
+            return true;
+        return teid != 0 && std::find(filter.teids.begin(), filter.teids.end(), teid) != filter.teids.end();
+    }
+
+    void push(capture::EInterface itf, capture::EDirection direction, const uint8_t *data, size_t length, int ueId,
+              uint32_t teid)
+    {
+        uint64_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true)
+        {
+            slot = &m_slots[pos & (RING_SIZE - 1)];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == pos)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (sequence < pos)
+            {
+                // The ring is full
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->time = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+        slot->itf = itf;
+        slot->direction = direction;
+        slot->ueId = ueId;
+        slot->teid = teid;
+        slot->length = static_cast<uint32_t>(length);
+        slot->capturedLength = static_cast<uint32_t>(std::min(length, static_cast<size_t>(m_config.snapLength)));
+        std::memcpy(slotData(pos), data, slot->capturedLength);
+
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    [[noreturn]] void run()
+    {
+        while (true)
+        {
+            bool wrote = false;
+            while (pop())
+                wrote = true;
+
+            if (wrote && m_file != nullptr)
+                std::fflush(m_file);
+            utils::Sleep(IDLE_SLEEP_MS);
+        }
+    }
+
+  private:
+    uint8_t *slotData(uint64_t pos)
+    {
+        return m_data.get() + (pos & (RING_SIZE - 1)) * static_cast<size_t>(m_config.snapLength);
+    }
+
+    bool pop()
+    {
+        Slot &slot = m_slots[m_dequeuePos & (RING_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+            return false;
+
+        std::string comment{};
+        if (slot.ueId != 0)
+            comment += "ue=" + std::to_string(slot.ueId);
+        if (slot.teid != 0)
+            comment += (comment.empty() ? "" : " ") + std::string{"teid=0x"} + utils::IntToHex(slot.teid);
+        uint64_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped != 0)
+            comment += (comment.empty() ? "" : " ") + std::to_string(dropped) + " packets dropped before";
+
+        auto itf = static_cast<int>(slot.itf);
+        m_block.clear();
+        capture::pcapng::AppendEnhancedPacket(
+            m_block, static_cast<uint32_t>(itf), slot.time, m_headers[itf], slotData(m_dequeuePos),
+            slot.capturedLength, slot.length,
+            slot.direction == capture::EDirection::INBOUND ? capture::pcapng::FLAG_INBOUND
+                                                           : capture::pcapng::FLAG_OUTBOUND,
+            comment);
+
+        slot.sequence.store(m_dequeuePos + RING_SIZE, std::memory_order_release);
+        m_dequeuePos++;
+
+        write(m_block);
+        return true;
+    }
+
+    void write(const std::vector<uint8_t> &block)
+    {
+        if (m_file == nullptr || m_fileSize + static_cast<int64_t>(block.size()) > m_config.fileSize)
+            openNextFile();
+        if (m_file == nullptr)
+            return;
+
+        std::fwrite(block.data(), 1, block.size(), m_file);
+        m_fileSize += static_cast<int64_t>(block.size());
+    }
+
+    void openNextFile()
+    {
+        if (m_file != nullptr)
+            std::fclose(m_file);
+
+        std::string index = std::to_string(++m_fileIndex);
+        index.insert(0, index.size() < 4 ? 4 - index.size() : 0, '0');
+        std::string path = m_config.directory + "/" + m_name + "-" + index + ".pcapng";
+
+        m_file = std::fopen(path.c_str(), "wb");
+        if (m_file == nullptr)
+        {
+            // The capture is given up rather than retried for every packet
+            std::cerr << "ERROR: Capture file could not be created: " << path << std::endl;
+            capture::detail::g_interfaces.store(0, std::memory_order_relaxed);
+            return;
+        }
+
+        m_files.push_back(path);
+        while (static_cast<int>(m_files.size()) > m_config.fileCount)
+        {
+            std::remove(m_files.front().c_str());
+            m_files.pop_front();
+        }
+
+        std::vector<uint8_t> header{};
+        capture::pcapng::AppendSectionHeader(header, cons::Name);
+        for (int i = 0; i < INTERFACE_COUNT; i++)
+            capture::pcapng::AppendInterfaceDescription(
+                header, capture::pcapng::LINKTYPE_EXPORTED_PDU,
+                static_cast<uint32_t>(m_headers[i].size()) + static_cast<uint32_t>(m_config.snapLength),
+                INTERFACE_NAMES[i]);
+
+        std::fwrite(header.data(), 1, header.size(), m_file);
+        m_fileSize = static_cast<int64_t>(header.size());
+    }
+};
+
+CaptureSession *g_session = nullptr;
+
+bool ParseNumber(const std::string &str, uint64_t max, uint64_t &value)
+{
+    if (str.empty() || str[0] == '-')
+        return false;
+    char *end = nullptr;
+    value = std::strtoull(str.c_str(), &end, 0);
+    return *end == '\0' && value != 0 && value <= max;
+}
+
+} // namespace
+
+namespace capture
+{
+
+namespace detail
+{
+
+std::atomic<uint32_t> g_interfaces{};
+
+void Capture(EInterface itf, EDirection direction, const uint8_t *data, size_t length, int ueId, uint32_t teid)
+{
+    if (g_session->matches(ueId, teid))
+        g_session->push(itf, direction, data, length, ueId, teid);
+}
+
+} // namespace detail
+
+bool ParseInterface(const std::string &name, EInterface &itf)
+{
+    for (int i = 0; i < INTERFACE_COUNT; i++)
+    {
+        if (name == INTERFACE_NAMES[i])
+        {
+            itf = static_cast<EInterface>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParseFilter(const std::string &str, CaptureFilter &filter, std::string &error)
+{
+    std::istringstream stream{str};
+    std::vector<std::string> tokens{};
+    std::string token{};
+    while (stream >> token)
+        tokens.push_back(token);
+
+    // term ["or" term]..., where term is "ue <id>" or "teid <value>"
+    for (size_t i = 0; i < tokens.size(); i += 3)
+    {
+        if (i > 0 && tokens[i - 1] != "or")
+        {
+            error = "'or' is expected instead of '" + tokens[i - 1] + "'";
+            return false;
+        }
+        if (i + 1 >= tokens.size())
+        {
+            error = "A value is expected after '" + tokens[i] + "'";
+            return false;
+        }
+
+        uint64_t value = 0;
+        if (tokens[i] == "ue" && ParseNumber(tokens[i + 1], INT32_MAX, value))
+            filter.ueIds.push_back(static_cast<int>(value));
+        else if (tokens[i] == "teid" && ParseNumber(tokens[i + 1], UINT32_MAX, value))
+            filter.teids.push_back(static_cast<uint32_t>(value));
+        else
+        {
+            error = "Invalid filter term '" + tokens[i] + " " + tokens[i + 1] + "'";
+            return false;
+        }
+
+        if (i + 2 == tokens.size() - 1)
+        {
+            error = "A filter term is expected after '" + tokens[i + 2] + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+void Start(const CaptureConfig &config, const std::string &name)
+{
+    io::CreateDirectory(config.directory);
+
+    g_session = new CaptureSession(config, name);
+    std::thread{[]() { g_session->run(); }}.detach();
+
+    detail::g_interfaces.store(config.interfaces, std::memory_order_release);
+}
+
+} // namespace capture
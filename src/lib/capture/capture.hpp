@@ -0,0 +1,87 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace capture
+{
+
+enum class EInterface
+{
+    RLS = 0,
+    GTP_U,
+    NGAP,
+};
+
+enum class EDirection
+{
+    INBOUND,
+    OUTBOUND,
+};
+
+/* A packet is captured if it matches any of the terms, or if there are no terms */
+struct CaptureFilter
+{
+    std::vector<int> ueIds{};
+    std::vector<uint32_t> teids{};
+};
+
+struct CaptureConfig
+{
+    bool enabled{};
+    std::string directory{};
+    uint32_t interfaces{}; // Bit mask of the captured EInterface values
+    int snapLength{};      // Maximum number of octets captured from each packet
+    int64_t fileSize{};    // Octets written to a file before the next one is started
+    int fileCount{};       // Number of files kept, the oldest one is deleted when a new one is started
+    CaptureFilter filter{};
+};
+
+/* Returns false if the name is not one of "rls", "gtp" and "ngap" */
+bool ParseInterface(const std::string &name, EInterface &itf);
+
+/* Parses a filter such as "ue 1 or ue 2 or teid 0x10", returns false and sets the error if it is malformed */
+bool ParseFilter(const std::string &str, CaptureFilter &filter, std::string &error);
+
+/*
+ * Starts the capture of the process into <directory>/<name>-<n>.pcapng, it must be called before the tasks are
+ * started. The tapped packets are copied into a lock-free ring, and a background thread writes them to the files.
+ * Packets are dropped, and counted in the comment of the next captured packet, while the ring is full.
+ */
+void Start(const CaptureConfig &config, const std::string &name);
+
+namespace detail
+{
+
+extern std::atomic<uint32_t> g_interfaces; // 0 unless the capture is started
+
+void Capture(EInterface itf, EDirection direction, const uint8_t *data, size_t length, int ueId, uint32_t teid);
+
+} // namespace detail
+
+/* A relaxed load and a branch, so that it can be called for every packet */
+inline bool IsEnabled(EInterface itf)
+{
+    return (detail::g_interfaces.load(std::memory_order_relaxed) & (1u << static_cast<int>(itf))) != 0;
+}
+
+/* Captures the packet if the interface is enabled and the packet matches the filter. 0 means unknown UE or TEID. */
+inline void Tap(EInterface itf, EDirection direction, const uint8_t *data, size_t length, int ueId = 0,
+                uint32_t teid = 0)
+{
+    if (IsEnabled(itf))
+        detail::Capture(itf, direction, data, length, ueId, teid);
+}
+
+} // namespace capture
@@ -0,0 +1,135 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "pcapng.hpp"
+
+#include <cstring>
+
+static constexpr const uint32_t BLOCK_SECTION_HEADER = 0x0A0D0D0A;
+static constexpr const uint32_t BLOCK_INTERFACE_DESCRIPTION = 0x00000001;
+static constexpr const uint32_t BLOCK_ENHANCED_PACKET = 0x00000006;
+static constexpr const uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+
+static constexpr const uint16_t OPT_END = 0;
+static constexpr const uint16_t OPT_COMMENT = 1;
+static constexpr const uint16_t OPT_SHB_USER_APPLICATION = 4;
+static constexpr const uint16_t OPT_IF_NAME = 2;
+static constexpr const uint16_t OPT_EPB_FLAGS = 2;
+
+static constexpr const uint16_t EXP_PDU_TAG_END = 0;
+static constexpr const uint16_t EXP_PDU_TAG_PROTO_NAME = 12;
+
+template <typename T>
+static void Append(std::vector<uint8_t> &buffer, T value)
+{
+    size_t size = buffer.size();
+    buffer.resize(size + sizeof(T));
+    std::memcpy(buffer.data() + size, &value, sizeof(T));
+}
+
+static void AppendPadded(std::vector<uint8_t> &buffer, const uint8_t *data, size_t length)
+{
+    buffer.insert(buffer.end(), data, data + length);
+    buffer.resize(buffer.size() + (4 - length % 4) % 4, 0);
+}
+
+static void AppendOption(std::vector<uint8_t> &buffer, uint16_t code, const std::string &value)
+{
+    Append<uint16_t>(buffer, code);
+    Append<uint16_t>(buffer, static_cast<uint16_t>(value.size()));
+    AppendPadded(buffer, reinterpret_cast<const uint8_t *>(value.data()), value.size());
+}
+
+/* Appends the type and a placeholder of the total length, returns the start of the block */
+static size_t BeginBlock(std::vector<uint8_t> &buffer, uint32_t type)
+{
+    size_t start = buffer.size();
+    Append<uint32_t>(buffer, type);
+    Append<uint32_t>(buffer, 0);
+    return start;
+}
+
+/* Ends the options and writes the total length at both ends of the block */
+static void EndBlock(std::vector<uint8_t> &buffer, size_t start)
+{
+    Append<uint16_t>(buffer, OPT_END);
+    Append<uint16_t>(buffer, 0);
+
+    auto length = static_cast<uint32_t>(buffer.size() - start + 4);
+    std::memcpy(buffer.data() + start + 4, &length, 4);
+    Append<uint32_t>(buffer, length);
+}
+
+namespace capture::pcapng
+{
+
+void AppendSectionHeader(std::vector<uint8_t> &buffer, const std::string &application)
+{
+    size_t start = BeginBlock(buffer, BLOCK_SECTION_HEADER);
+    Append<uint32_t>(buffer, BYTE_ORDER_MAGIC);
+    Append<uint16_t>(buffer, 1); // Major version
+    Append<uint16_t>(buffer, 0); // Minor version
+    Append<int64_t>(buffer, -1); // Section length is not specified
+    AppendOption(buffer, OPT_SHB_USER_APPLICATION, application);
+    EndBlock(buffer, start);
+}
+
+void AppendInterfaceDescription(std::vector<uint8_t> &buffer, uint16_t linkType, uint32_t snapLength,
+                                const std::string &name)
+{
+    size_t start = BeginBlock(buffer, BLOCK_INTERFACE_DESCRIPTION);
+    Append<uint16_t>(buffer, linkType);
+    Append<uint16_t>(buffer, 0);
+    Append<uint32_t>(buffer, snapLength);
+    AppendOption(buffer, OPT_IF_NAME, name);
+    EndBlock(buffer, start);
+}
+
+void AppendEnhancedPacket(std::vector<uint8_t> &buffer, uint32_t interfaceId, int64_t timeMicros,
+                          const std::vector<uint8_t> &header, const uint8_t *data, size_t capturedLength,
+                          size_t length, uint32_t flags, const std::string &comment)
+{
+    // Timestamps are in microseconds, the default resolution of the interfaces
+    auto time = static_cast<uint64_t>(timeMicros);
+
+    size_t start = BeginBlock(buffer, BLOCK_ENHANCED_PACKET);
+    Append<uint32_t>(buffer, interfaceId);
+    Append<uint32_t>(buffer, static_cast<uint32_t>(time >> 32));
+    Append<uint32_t>(buffer, static_cast<uint32_t>(time));
+    Append<uint32_t>(buffer, static_cast<uint32_t>(header.size() + capturedLength));
+    Append<uint32_t>(buffer, static_cast<uint32_t>(header.size() + length));
+    buffer.insert(buffer.end(), header.begin(), header.end());
+    AppendPadded(buffer, data, capturedLength); // The header is already padded
+
+    Append<uint16_t>(buffer, OPT_EPB_FLAGS);
+    Append<uint16_t>(buffer, 4);
+    Append<uint32_t>(buffer, flags);
+    if (!comment.empty())
+        AppendOption(buffer, OPT_COMMENT, comment);
+    EndBlock(buffer, start);
+}
+
+std::vector<uint8_t> ExportedPduHeader(const std::string &dissector)
+{
+    std::vector<uint8_t> header{};
+    auto appendTag = [&header](uint16_t tag, size_t length) {
+        header.push_back(static_cast<uint8_t>(tag >> 8));
+        header.push_back(static_cast<uint8_t>(tag));
+        header.push_back(static_cast<uint8_t>(length >> 8));
+        header.push_back(static_cast<uint8_t>(length));
+    };
+
+    size_t paddedLength = (dissector.size() + 3) / 4 * 4;
+    appendTag(EXP_PDU_TAG_PROTO_NAME, paddedLength);
+    header.insert(header.end(), dissector.begin(), dissector.end());
+    header.resize(header.size() + paddedLength - dissector.size(), 0);
+    appendTag(EXP_PDU_TAG_END, 0);
+    return header;
+}
+
+} // namespace capture::pcapng
@@ -0,0 +1,36 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace capture::pcapng
+{
+
+/* Packets prefixed with the name of the Wireshark dissector of their payload, see ExportedPduHeader() */
+static constexpr const uint16_t LINKTYPE_EXPORTED_PDU = 252;
+
+static constexpr const uint32_t FLAG_INBOUND = 1;
+static constexpr const uint32_t FLAG_OUTBOUND = 2;
+
+/* The blocks are appended in the host byte order, which is told to the readers by the section header */
+void AppendSectionHeader(std::vector<uint8_t> &buffer, const std::string &application);
+void AppendInterfaceDescription(std::vector<uint8_t> &buffer, uint16_t linkType, uint32_t snapLength,
+                                const std::string &name);
+void AppendEnhancedPacket(std::vector<uint8_t> &buffer, uint32_t interfaceId, int64_t timeMicros,
+                          const std::vector<uint8_t> &header, const uint8_t *data, size_t capturedLength,
+                          size_t length, uint32_t flags, const std::string &comment);
+
+/* Exported PDU tags naming the dissector, they are big-endian regardless of the section */
+std::vector<uint8_t> ExportedPduHeader(const std::string &dissector);
+
+} // namespace capture::pcapng
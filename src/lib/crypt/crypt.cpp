@@ -15,7 +15,9 @@
 #include "uea2.hpp"
 #include "zuc.hpp"
 
+#include <cstring>
 #include <stdexcept>
+#include <vector>
 
 namespace crypto
 {
@@ -126,7 +128,12 @@ void EncryptUea2(const uint8_t *pKey, uint32_t count, uint32_t bearer, uint32_t
 
 void EncryptEea1(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key)
 {
-    EncryptUea2(key.data(), count, bearer, direction, message.data(), message.length());
+    EncryptEea1(count, bearer, direction, message.data(), static_cast<size_t>(message.length()), key);
+}
+
+void EncryptEea1(uint32_t count, int bearer, int direction, uint8_t *data, size_t length, const OctetString &key)
+{
+    EncryptUea2(key.data(), count, bearer, direction, data, static_cast<uint32_t>(length));
 }
 
 void DecryptEea1(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key)
@@ -135,9 +142,15 @@ void DecryptEea1(uint32_t count, int bearer, int direction, OctetString &message
 }
 
 uint32_t ComputeMacEia1(uint32_t count, int bearer, int direction, const OctetString &message, const OctetString &key)
+{
+    return ComputeMacEia1(count, bearer, direction, message.data(), static_cast<size_t>(message.length()), key);
+}
+
+uint32_t ComputeMacEia1(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length,
+                        const OctetString &key)
 {
     uint32_t fresh = bearer << 27;
-    return ComputeMacUia2(key.data(), count, fresh, direction, message.data(), message.length());
+    return ComputeMacUia2(key.data(), count, fresh, direction, data, length);
 }
 
 void EncryptEea2(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key)
@@ -155,6 +168,17 @@ uint32_t ComputeMacEia2(uint32_t count, int bearer, int direction, const OctetSt
     return eia2::Compute(count, bearer, direction, message, key);
 }
 
+void EncryptEea2(uint32_t count, int bearer, int direction, uint8_t *data, size_t length, const OctetString &key)
+{
+    eea2::Encrypt(count, bearer, direction, data, length, key);
+}
+
+uint32_t ComputeMacEia2(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length,
+                        const OctetString &key)
+{
+    return eia2::Compute(count, bearer, direction, data, length, key);
+}
+
 void EncryptEea3(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key)
 {
     eea3::EEA3(key.data(), count, bearer, direction, message.length() * 8,
@@ -173,4 +197,21 @@ uint32_t ComputeMacEia3(uint32_t count, int bearer, int direction, const OctetSt
                       reinterpret_cast<const uint32_t *>(message.data()));
 }
 
+/* EEA3 and EIA3 work on whole words, the data may be unaligned and not padded when it is a part of a larger buffer */
+void EncryptEea3(uint32_t count, int bearer, int direction, uint8_t *data, size_t length, const OctetString &key)
+{
+    std::vector<uint32_t> words((length + 3) / 4);
+    std::memcpy(words.data(), data, length);
+    eea3::EEA3(key.data(), count, bearer, direction, static_cast<uint32_t>(length * 8), words.data());
+    std::memcpy(data, words.data(), length);
+}
+
+uint32_t ComputeMacEia3(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length,
+                        const OctetString &key)
+{
+    std::vector<uint32_t> words((length + 3) / 4);
+    std::memcpy(words.data(), data, length);
+    return eea3::EIA3(key.data(), count, direction, bearer, static_cast<uint32_t>(length * 8), words.data());
+}
+
 } // namespace crypto
@@ -33,15 +33,24 @@ void EncryptUea2(const uint8_t *pKey, uint32_t count, uint32_t bearer, uint32_t
 void EncryptEea1(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key);
 void DecryptEea1(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key);
 uint32_t ComputeMacEia1(uint32_t count, int bearer, int direction, const OctetString &message, const OctetString &key);
+void EncryptEea1(uint32_t count, int bearer, int direction, uint8_t *data, size_t length, const OctetString &key);
+uint32_t ComputeMacEia1(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length,
+                        const OctetString &key);
 
 /* EEA2 and EIA2 */
 void EncryptEea2(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key);
 void DecryptEea2(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key);
 uint32_t ComputeMacEia2(uint32_t count, int bearer, int direction, const OctetString &message, const OctetString &key);
+void EncryptEea2(uint32_t count, int bearer, int direction, uint8_t *data, size_t length, const OctetString &key);
+uint32_t ComputeMacEia2(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length,
+                        const OctetString &key);
 
 /* EEA3 and EIA3 */
 void EncryptEea3(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key);
 void DecryptEea3(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key);
 uint32_t ComputeMacEia3(uint32_t count, int bearer, int direction, const OctetString &message, const OctetString &key);
+void EncryptEea3(uint32_t count, int bearer, int direction, uint8_t *data, size_t length, const OctetString &key);
+uint32_t ComputeMacEia3(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length,
+                        const OctetString &key);
 
 } // namespace crypt
\ No newline at end of file
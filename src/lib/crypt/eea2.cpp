@@ -38,6 +38,13 @@ void Encrypt(uint32_t count, int bearer, int direction, OctetString &message, co
     Cipher(key.data(), iv, message.data(), message.length());
 }
 
+void Encrypt(uint32_t count, int bearer, int direction, uint8_t *data, size_t length, const OctetString &key)
+{
+    uint8_t iv[16] = {0};
+    ComputeIv(iv, count, bearer, direction);
+    Cipher(key.data(), iv, data, length);
+}
+
 void Decrypt(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key)
 {
     uint8_t iv[16] = {0};
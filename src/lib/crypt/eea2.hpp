@@ -15,5 +15,6 @@ namespace crypto::eea2
 
 void Encrypt(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key);
 void Decrypt(uint32_t count, int bearer, int direction, OctetString &message, const OctetString &key);
+void Encrypt(uint32_t count, int bearer, int direction, uint8_t *data, size_t length, const OctetString &key);
 
 } // namespace crypt::eea2
\ No newline at end of file
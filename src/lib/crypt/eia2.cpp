@@ -11,13 +11,14 @@
 
 #include <utils/bits.hpp>
 
-static OctetString GenerateMacInput(uint32_t count, int bearer, int direction, const OctetString &message)
+static OctetString GenerateMacInput(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length)
 {
     OctetString m{};
+    m.reserve(static_cast<int>(length) + 8);
     m.appendOctet4(count);
     m.appendOctet(bits::Ranged8({{5, bearer}, {1, direction}, {2, 0}}));
     m.appendOctet3(0);
-    m.append(message);
+    m.append(data, length);
     return m;
 }
 
@@ -25,10 +26,15 @@ namespace crypto::eia2
 {
 
 uint32_t Compute(uint32_t count, int bearer, int direction, const OctetString &message, const OctetString &key)
+{
+    return Compute(count, bearer, direction, message.data(), static_cast<size_t>(message.length()), key);
+}
+
+uint32_t Compute(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length, const OctetString &key)
 {
     assert(key.length() == 16);
 
-    auto macInput = GenerateMacInput(count, bearer, direction, message);
+    auto macInput = GenerateMacInput(count, bearer, direction, data, length);
 
     uint8_t buf[16] = {0};
     AesCmac(buf, key.data(), macInput.data(), macInput.length());
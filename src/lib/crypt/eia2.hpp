@@ -14,5 +14,6 @@ namespace crypto::eia2
 {
 
 uint32_t Compute(uint32_t count, int bearer, int direction, const OctetString &message, const OctetString &key);
+uint32_t Compute(uint32_t count, int bearer, int direction, const uint8_t *data, size_t length, const OctetString &key);
 
 } // namespace crypt::eia2
\ No newline at end of file
@@ -27,6 +27,7 @@ struct InformationElement2 : InformationElement
 {
 };
 
+/* Fixed length IE, the length of the value is given by the LENGTH member of the IE type */
 struct InformationElement3 : InformationElement
 {
 };
@@ -7,22 +7,22 @@
 //
 
 #include "encode.hpp"
+#include "view.hpp"
 
+#include <atomic>
 #include <stdexcept>
 
 namespace nas
 {
 
+/* Largest encoded length per protocol and message type, shared by all the UE threads */
+static std::atomic<int> g_lengthHints[2][256]{};
+
 template <typename T>
 static void EncodeViaBuilder(T &msg, OctetString &stream)
 {
-    NasMessageBuilder builder{};
+    NasMessageBuilder builder{NasMessageBuilder::ENCODE, &stream};
     msg.onBuild(builder);
-
-    for (auto &f : builder.mandatoryEncoders)
-        f(stream);
-    for (auto &f : builder.optionalEncoders)
-        f(stream);
 }
 
 static void EncodeMm(PlainMmMessage &msg, OctetString &stream)
@@ -205,8 +205,59 @@ void EncodeNasMessage(const NasMessage &msg, OctetString &stream)
         EncodeSm((SmMessage &)msg, stream);
 }
 
+OctetString EncodeNasMessage(const NasMessage &msg, int headroom)
+{
+    std::atomic<int> *hint = nullptr;
+    int expected;
+
+    if (msg.epd == EExtendedProtocolDiscriminator::SESSION_MANAGEMENT_MESSAGES)
+        hint = &g_lengthHints[1][static_cast<uint8_t>(((const SmMessage &)msg).messageType)];
+    else if (((const MmMessage &)msg).sht == ESecurityHeaderType::NOT_PROTECTED)
+        hint = &g_lengthHints[0][static_cast<uint8_t>(((const PlainMmMessage &)msg).messageType)];
+
+    if (hint != nullptr)
+        expected = hint->load(std::memory_order_relaxed);
+    else
+        expected = SECURITY_HEADER_LENGTH + ((const SecuredMmMessage &)msg).plainNasMessage.length();
+
+    OctetString stream{};
+    stream.reserve(headroom + expected);
+    stream.appendUninitialized(headroom);
+    EncodeNasMessage(msg, stream);
+
+    if (hint != nullptr)
+    {
+        int length = stream.length() - headroom;
+        while (length > expected && !hint->compare_exchange_weak(expected, length, std::memory_order_relaxed))
+        {
+        }
+    }
+    return stream;
+}
+
+static void CheckRemaining(const OctetView &stream, size_t length)
+{
+    if (stream.remaining() < length)
+        throw std::runtime_error("Truncated NAS message");
+}
+
+/* Checks the extent of the IE at 'offset' octets from the current position, i.e. after its IEI if any */
+static void CheckIeBounds(const IeLayout &ie, const OctetView &stream, int offset)
+{
+    size_t length = static_cast<size_t>(offset + ie.fixedOctets);
+    CheckRemaining(stream, length);
+
+    if (ie.lengthOctets == 1)
+        length += stream.peek(offset);
+    else if (ie.lengthOctets == 2)
+        length += (static_cast<size_t>(stream.peek(offset)) << 8) | stream.peek(offset + 1);
+    CheckRemaining(stream, length);
+}
+
 static SecuredMmMessage *DecodeSecuredMmMessage(const OctetView &stream, ESecurityHeaderType sht)
 {
+    CheckRemaining(stream, 5);
+
     auto *p = new SecuredMmMessage();
     p->messageAuthenticationCode = stream.read4();
     p->sequenceNumber = stream.read();
@@ -217,26 +268,36 @@ static SecuredMmMessage *DecodeSecuredMmMessage(const OctetView &stream, ESecuri
 template <typename T>
 static T *DecodeViaBuilder(const OctetView &stream)
 {
-    T *p = new T();
+    auto p = std::make_unique<T>();
 
-    NasMessageBuilder builder{};
+    NasMessageBuilder builder{NasMessageBuilder::DECODE};
     p->onBuild(builder);
 
-    for (auto &f : builder.mandatoryDecoders)
-        f(stream);
+    // The layout gives the extent of the IEs in the same order as the decoders
+    const MessageLayout *layout = LayoutOf<T>();
+
+    for (size_t i = 0; i < builder.mandatoryDecoders.size(); i++)
+    {
+        CheckIeBounds(layout->mandatory[i], stream, 0);
+        builder.mandatoryDecoders[i](stream);
+    }
 
     while (stream.hasNext())
     {
         int iei = stream.peekI();
-        if (builder.optionalDecoders.count(iei))
-            builder.optionalDecoders[iei](stream);
-        else if (builder.optionalDecoders.count((iei >> 4) & 0xF))
-            builder.optionalDecoders[(iei >> 4) & 0xF](stream);
-        else
+        auto *decoder = builder.findOptionalDecoder(iei);
+        if (decoder == nullptr)
+            iei = (iei >> 4) & 0xF;
+        decoder = builder.findOptionalDecoder(iei);
+        const IeLayout *ie = layout->findOptional(iei);
+        if (decoder == nullptr || ie == nullptr)
             throw std::runtime_error("Bad constructed NAS message");
+
+        CheckIeBounds(*ie, stream, ie->halfOctetIei ? 0 : 1);
+        (*decoder)(stream);
     }
 
-    return p;
+    return p.release();
 }
 
 static PlainMmMessage *DecodePlainMmMessage(const OctetView &stream, EMessageType messageType)
@@ -347,6 +408,8 @@ static SmMessage *DecodeSmMessage(const OctetView &stream, EMessageType messageT
 
 std::unique_ptr<NasMessage> DecodeNasMessage(const OctetView &stream)
 {
+    CheckRemaining(stream, 3);
+
     auto epd = static_cast<EExtendedProtocolDiscriminator>(stream.readI());
     if (epd == EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES)
     {
@@ -370,6 +433,8 @@ std::unique_ptr<NasMessage> DecodeNasMessage(const OctetView &stream)
     }
     else
     {
+        CheckRemaining(stream, 3);
+
         auto pduSessionId = stream.readI();
         uint8_t pti = stream.read();
         auto messageType = static_cast<EMessageType>(stream.readI());
@@ -384,4 +449,16 @@ std::unique_ptr<NasMessage> DecodeNasMessage(const OctetView &stream)
     }
 }
 
+std::unique_ptr<NasMessage> DecodeReceivedNasMessage(const OctetView &stream)
+{
+    try
+    {
+        return DecodeNasMessage(stream);
+    }
+    catch (const std::runtime_error &)
+    {
+        return nullptr;
+    }
+}
+
 } // namespace nas
@@ -13,7 +13,25 @@
 namespace nas
 {
 
+/* Octets before the plain 5GMM message in a security protected 5GMM message: EPD, SHT, MAC and SQN */
+constexpr int SECURITY_HEADER_LENGTH = 7;
+
 void EncodeNasMessage(const NasMessage &msg, OctetString &stream);
+
+/*
+ * Encodes the message into a new buffer after 'headroom' uninitialized octets, so that headers can be filled in
+ * place by the caller, e.g. the security header with SECURITY_HEADER_LENGTH. The buffer is allocated once, sized
+ * from the largest encoding of the same message type so far.
+ */
+OctetString EncodeNasMessage(const NasMessage &msg, int headroom);
+
+/*
+ * Throws std::runtime_error if the message is malformed or its type is unknown. The extent of each IE is checked
+ * against the end of the buffer before the IE is decoded, so that a truncated message is not read out of bounds.
+ */
 std::unique_ptr<NasMessage> DecodeNasMessage(const OctetView &stream);
 
+/* Same as DecodeNasMessage, but the malformed messages are rejected with nullptr, e.g. for the received messages */
+std::unique_ptr<NasMessage> DecodeReceivedNasMessage(const OctetView &stream);
+
 } // namespace nas
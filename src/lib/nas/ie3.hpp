@@ -16,6 +16,8 @@ namespace nas
 
 struct IE5gMmCause : InformationElement3
 {
+    static constexpr const int LENGTH = 1;
+
     EMmCause value{};
 
     IE5gMmCause() = default;
@@ -27,6 +29,8 @@ struct IE5gMmCause : InformationElement3
 
 struct IE5gsTrackingAreaIdentity : InformationElement3
 {
+    static constexpr const int LENGTH = 6;
+
     int mcc{};
     int mnc{};
     bool isLongMnc{};
@@ -42,6 +46,8 @@ struct IE5gsTrackingAreaIdentity : InformationElement3
 
 struct IEAuthenticationParameterRand : InformationElement3
 {
+    static constexpr const int LENGTH = 16;
+
     OctetString value;
 
     IEAuthenticationParameterRand() = default;
@@ -53,6 +59,8 @@ struct IEAuthenticationParameterRand : InformationElement3
 
 struct IEEpsNasSecurityAlgorithms : InformationElement3
 {
+    static constexpr const int LENGTH = 1;
+
     EEpsTypeOfIntegrityProtectionAlgorithm integrity{};
     EEpsTypeOfCipheringAlgorithm ciphering{};
 
@@ -66,6 +74,8 @@ struct IEEpsNasSecurityAlgorithms : InformationElement3
 
 struct IEGprsTimer : InformationElement3
 {
+    static constexpr const int LENGTH = 1;
+
     int timerValue; // 5-bit
     EGprsTimerValueUnit timerValueUnit;
 
@@ -78,6 +88,8 @@ struct IEGprsTimer : InformationElement3
 
 struct IEIntegrityProtectionMaximumDataRate : InformationElement3
 {
+    static constexpr const int LENGTH = 2;
+
     EMaximumDataRatePerUeForUserPlaneIntegrityProtectionForUplink maxRateUplink{};
     EMaximumDataRatePerUeForUserPlaneIntegrityProtectionForDownlink maxRateDownlink{};
 
@@ -92,6 +104,8 @@ struct IEIntegrityProtectionMaximumDataRate : InformationElement3
 
 struct IEMaximumNumberOfSupportedPacketFilters : InformationElement3
 {
+    static constexpr const int LENGTH = 2;
+
     int value; // 11-bit
 
     IEMaximumNumberOfSupportedPacketFilters();
@@ -103,6 +117,8 @@ struct IEMaximumNumberOfSupportedPacketFilters : InformationElement3
 
 struct IEN1ModeToS1ModeNasTransparentContainer : InformationElement3
 {
+    static constexpr const int LENGTH = 1;
+
     octet sequenceNumber{};
 
     IEN1ModeToS1ModeNasTransparentContainer() = default;
@@ -114,6 +130,8 @@ struct IEN1ModeToS1ModeNasTransparentContainer : InformationElement3
 
 struct IENasSecurityAlgorithms : InformationElement3
 {
+    static constexpr const int LENGTH = 1;
+
     ETypeOfIntegrityProtectionAlgorithm integrity{};
     ETypeOfCipheringAlgorithm ciphering{};
 
@@ -126,6 +144,8 @@ struct IENasSecurityAlgorithms : InformationElement3
 
 struct IEPduSessionIdentity2 : InformationElement3
 {
+    static constexpr const int LENGTH = 1;
+
     octet value{};
 
     IEPduSessionIdentity2() = default;
@@ -137,6 +157,8 @@ struct IEPduSessionIdentity2 : InformationElement3
 
 struct IETimeZone : InformationElement3
 {
+    static constexpr const int LENGTH = 1;
+
     octet value{};
 
     IETimeZone() = default;
@@ -148,6 +170,8 @@ struct IETimeZone : InformationElement3
 
 struct IETimeZoneAndTime : InformationElement3
 {
+    static constexpr const int LENGTH = 7;
+
     VTime time;
     octet timezone{};
 
@@ -160,6 +184,8 @@ struct IETimeZoneAndTime : InformationElement3
 
 struct IE5gSmCause : InformationElement3
 {
+    static constexpr const int LENGTH = 1;
+
     ESmCause value{};
 
     IE5gSmCause() = default;
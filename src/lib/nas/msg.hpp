@@ -17,63 +17,153 @@
 namespace nas
 {
 
+/* Consumes an IE value from the stream, excluding the IEI (and including the length octets if any) */
+using IeSkipper = void (*)(const OctetView &stream);
+
+template <typename T>
+inline void SkipIe(const OctetView &stream)
+{
+    if constexpr (std::is_base_of<InformationElement1, T>::value)
+        stream.read();
+    if constexpr (std::is_base_of<InformationElement3, T>::value)
+        (void)DecodeIe3<T>(stream);
+    if constexpr (std::is_base_of<InformationElement4, T>::value)
+        stream.skip(static_cast<size_t>(stream.readI()));
+    if constexpr (std::is_base_of<InformationElement6, T>::value)
+        stream.skip(static_cast<size_t>(stream.read2I()));
+}
+
+/* Position independent description of an IE of a message, used by NasMessageView */
+struct IeLayout
+{
+    int iei{};           // -1 for the mandatory IEs
+    bool halfOctetIei{}; // Type 1 optional IE, the IEI and the value share the octet
+    int lengthOctets{};  // Number of length octets before the value
+    int fixedOctets{};   // Number of octets read by the skipper before the length of the value is known
+    IeSkipper skipper{}; // SkipIe<T> for the IE type T
+};
+
 struct NasMessageBuilder
 {
-    std::vector<std::function<void(OctetString &)>> mandatoryEncoders{};
-    std::vector<std::function<void(OctetString &)>> optionalEncoders{};
+    enum EMode
+    {
+        ENCODE,
+        DECODE,
+        LAYOUT,
+    };
+
+    const EMode mode;
+
+    /* In ENCODE mode the IEs are encoded directly into the output, in the order of onBuild */
+    OctetString *const output;
 
     std::vector<std::function<void(const OctetView &)>> mandatoryDecoders{};
-    std::unordered_map<int, std::function<void(const OctetView &)>> optionalDecoders{};
+    std::vector<std::pair<int, std::function<void(const OctetView &)>>> optionalDecoders{};
+
+    std::vector<IeLayout> mandatoryLayout{};
+    std::vector<IeLayout> optionalLayout{};
+
+    explicit NasMessageBuilder(EMode mode, OctetString *output = nullptr) : mode(mode), output(output)
+    {
+    }
+
+    template <typename T>
+    static constexpr int LengthOctetsOf()
+    {
+        if constexpr (std::is_base_of<InformationElement4, T>::value)
+            return 1;
+        if constexpr (std::is_base_of<InformationElement6, T>::value)
+            return 2;
+        return 0;
+    }
+
+    template <typename T>
+    static constexpr int FixedOctetsOf()
+    {
+        if constexpr (std::is_base_of<InformationElement1, T>::value)
+            return 1;
+        if constexpr (std::is_base_of<InformationElement3, T>::value)
+            return T::LENGTH;
+        return LengthOctetsOf<T>();
+    }
+
+    [[nodiscard]] inline const std::function<void(const OctetView &)> *findOptionalDecoder(int iei) const
+    {
+        for (auto &item : optionalDecoders)
+            if (item.first == iei)
+                return &item.second;
+        return nullptr;
+    }
 
     template <typename T>
     inline void mandatoryIE(T *ptr)
     {
-        mandatoryEncoders.push_back([ptr](OctetString &stream) { Encode2346(*ptr, stream); });
-        mandatoryDecoders.push_back([ptr](const OctetView &stream) { *ptr = DecodeIe2346<T>(stream); });
+        if (mode == ENCODE)
+            Encode2346(*ptr, *output);
+        else if (mode == DECODE)
+            mandatoryDecoders.push_back([ptr](const OctetView &stream) { *ptr = DecodeIe2346<T>(stream); });
+        else
+            mandatoryLayout.push_back(IeLayout{-1, false, LengthOctetsOf<T>(), FixedOctetsOf<T>(), &SkipIe<T>});
     }
 
     template <typename T>
     inline void mandatoryIE1(T *ptr)
     {
-        mandatoryEncoders.push_back([ptr](OctetString &stream) { EncodeIe1(0, *ptr, stream); });
-        mandatoryDecoders.push_back([ptr](const OctetView &stream) { *ptr = DecodeIe1<T>(stream); });
+        if (mode == ENCODE)
+            EncodeIe1(0, *ptr, *output);
+        else if (mode == DECODE)
+            mandatoryDecoders.push_back([ptr](const OctetView &stream) { *ptr = DecodeIe1<T>(stream); });
+        else
+            mandatoryLayout.push_back(IeLayout{-1, false, 0, 1, &SkipIe<T>});
     }
 
     template <typename T, typename U>
     inline void mandatoryIE1(T *ptr1, U *ptr2)
     {
-        mandatoryEncoders.push_back([ptr1, ptr2](OctetString &stream) { EncodeIe1(*ptr1, *ptr2, stream); });
-        mandatoryDecoders.push_back([ptr1, ptr2](const OctetView &stream) {
-            int octet = stream.readI();
-            *ptr1 = T::Decode((octet >> 4) & 0xF);
-            *ptr2 = U::Decode(octet & 0xF);
-        });
+        if (mode == ENCODE)
+            EncodeIe1(*ptr1, *ptr2, *output);
+        else if (mode == DECODE)
+            mandatoryDecoders.push_back([ptr1, ptr2](const OctetView &stream) {
+                int octet = stream.readI();
+                *ptr1 = T::Decode((octet >> 4) & 0xF);
+                *ptr2 = U::Decode(octet & 0xF);
+            });
+        else // Described by the IE in the lower half-octet
+            mandatoryLayout.push_back(IeLayout{-1, false, 0, 1, &SkipIe<U>});
     }
 
     template <typename T>
     inline void optionalIE(int iei, std::optional<T> *ptr)
     {
-        optionalEncoders.push_back([ptr, iei](OctetString &stream) {
+        if (mode == ENCODE)
+        {
             if (ptr->has_value())
             {
-                stream.appendOctet(iei);
-                Encode2346(ptr->value(), stream);
+                output->appendOctet(iei);
+                Encode2346(ptr->value(), *output);
             }
-        });
-        optionalDecoders[iei] = [ptr](const OctetView &stream) {
-            stream.readI();
-            *ptr = DecodeIe2346<T>(stream);
-        };
+        }
+        else if (mode == DECODE)
+            optionalDecoders.emplace_back(iei, [ptr](const OctetView &stream) {
+                stream.readI();
+                *ptr = DecodeIe2346<T>(stream);
+            });
+        else
+            optionalLayout.push_back(IeLayout{iei, false, LengthOctetsOf<T>(), FixedOctetsOf<T>(), &SkipIe<T>});
     }
 
     template <typename T>
     inline void optionalIE1(int iei, std::optional<T> *ptr)
     {
-        optionalEncoders.push_back([ptr, iei](OctetString &stream) {
+        if (mode == ENCODE)
+        {
             if (ptr->has_value())
-                EncodeIe1(iei, ptr->value(), stream);
-        });
-        optionalDecoders[iei] = [ptr](const OctetView &stream) { *ptr = DecodeIe1<T>(stream); };
+                EncodeIe1(iei, ptr->value(), *output);
+        }
+        else if (mode == DECODE)
+            optionalDecoders.emplace_back(iei, [ptr](const OctetView &stream) { *ptr = DecodeIe1<T>(stream); });
+        else
+            optionalLayout.push_back(IeLayout{iei, true, 0, 1, &SkipIe<T>});
     }
 };
 
@@ -8,6 +8,7 @@
 
 #include "msg.hpp"
 #include "encode.hpp"
+#include "view.hpp"
 
 namespace nas
 {
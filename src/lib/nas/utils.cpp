@@ -60,6 +60,103 @@ const char *EnumToString(ERegistrationType v)
     }
 }
 
+const char *EnumToString(EMessageType v)
+{
+    switch (v)
+    {
+    case EMessageType::REGISTRATION_REQUEST:
+        return "Registration Request";
+    case EMessageType::REGISTRATION_ACCEPT:
+        return "Registration Accept";
+    case EMessageType::REGISTRATION_COMPLETE:
+        return "Registration Complete";
+    case EMessageType::REGISTRATION_REJECT:
+        return "Registration Reject";
+    case EMessageType::DEREGISTRATION_REQUEST_UE_ORIGINATING:
+        return "Deregistration Request (UE Originating)";
+    case EMessageType::DEREGISTRATION_ACCEPT_UE_ORIGINATING:
+        return "Deregistration Accept (UE Originating)";
+    case EMessageType::DEREGISTRATION_REQUEST_UE_TERMINATED:
+        return "Deregistration Request (UE Terminated)";
+    case EMessageType::DEREGISTRATION_ACCEPT_UE_TERMINATED:
+        return "Deregistration Accept (UE Terminated)";
+    case EMessageType::SERVICE_REQUEST:
+        return "Service Request";
+    case EMessageType::SERVICE_REJECT:
+        return "Service Reject";
+    case EMessageType::SERVICE_ACCEPT:
+        return "Service Accept";
+    case EMessageType::CONFIGURATION_UPDATE_COMMAND:
+        return "Configuration Update Command";
+    case EMessageType::CONFIGURATION_UPDATE_COMPLETE:
+        return "Configuration Update Complete";
+    case EMessageType::AUTHENTICATION_REQUEST:
+        return "Authentication Request";
+    case EMessageType::AUTHENTICATION_RESPONSE:
+        return "Authentication Response";
+    case EMessageType::AUTHENTICATION_REJECT:
+        return "Authentication Reject";
+    case EMessageType::AUTHENTICATION_FAILURE:
+        return "Authentication Failure";
+    case EMessageType::AUTHENTICATION_RESULT:
+        return "Authentication Result";
+    case EMessageType::IDENTITY_REQUEST:
+        return "Identity Request";
+    case EMessageType::IDENTITY_RESPONSE:
+        return "Identity Response";
+    case EMessageType::SECURITY_MODE_COMMAND:
+        return "Security Mode Command";
+    case EMessageType::SECURITY_MODE_COMPLETE:
+        return "Security Mode Complete";
+    case EMessageType::SECURITY_MODE_REJECT:
+        return "Security Mode Reject";
+    case EMessageType::FIVEG_MM_STATUS:
+        return "5GMM Status";
+    case EMessageType::NOTIFICATION:
+        return "Notification";
+    case EMessageType::NOTIFICATION_RESPONSE:
+        return "Notification Response";
+    case EMessageType::UL_NAS_TRANSPORT:
+        return "UL NAS Transport";
+    case EMessageType::DL_NAS_TRANSPORT:
+        return "DL NAS Transport";
+    case EMessageType::PDU_SESSION_ESTABLISHMENT_REQUEST:
+        return "PDU Session Establishment Request";
+    case EMessageType::PDU_SESSION_ESTABLISHMENT_ACCEPT:
+        return "PDU Session Establishment Accept";
+    case EMessageType::PDU_SESSION_ESTABLISHMENT_REJECT:
+        return "PDU Session Establishment Reject";
+    case EMessageType::PDU_SESSION_AUTHENTICATION_COMMAND:
+        return "PDU Session Authentication Command";
+    case EMessageType::PDU_SESSION_AUTHENTICATION_COMPLETE:
+        return "PDU Session Authentication Complete";
+    case EMessageType::PDU_SESSION_AUTHENTICATION_RESULT:
+        return "PDU Session Authentication Result";
+    case EMessageType::PDU_SESSION_MODIFICATION_REQUEST:
+        return "PDU Session Modification Request";
+    case EMessageType::PDU_SESSION_MODIFICATION_REJECT:
+        return "PDU Session Modification Reject";
+    case EMessageType::PDU_SESSION_MODIFICATION_COMMAND:
+        return "PDU Session Modification Command";
+    case EMessageType::PDU_SESSION_MODIFICATION_COMPLETE:
+        return "PDU Session Modification Complete";
+    case EMessageType::PDU_SESSION_MODIFICATION_COMMAND_REJECT:
+        return "PDU Session Modification Command Reject";
+    case EMessageType::PDU_SESSION_RELEASE_REQUEST:
+        return "PDU Session Release Request";
+    case EMessageType::PDU_SESSION_RELEASE_REJECT:
+        return "PDU Session Release Reject";
+    case EMessageType::PDU_SESSION_RELEASE_COMMAND:
+        return "PDU Session Release Command";
+    case EMessageType::PDU_SESSION_RELEASE_COMPLETE:
+        return "PDU Session Release Complete";
+    case EMessageType::FIVEG_SM_STATUS:
+        return "5GSM Status";
+    default:
+        return "?";
+    }
+}
+
 const char *EnumToString(EMmCause v)
 {
     switch (v)
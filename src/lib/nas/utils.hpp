@@ -45,6 +45,7 @@ bool ServiceAreaListAllowsTai(const nas::VPartialServiceAreaList &list, const VT
 void RemoveFromServiceAreaList(nas::IEServiceAreaList &list, const VTrackingAreaIdentity &tai);
 
 const char *EnumToString(ERegistrationType v);
+const char *EnumToString(EMessageType v);
 const char *EnumToString(EMmCause v);
 const char *EnumToString(ESmCause v);
 const char *EnumToString(eap::ECode v);
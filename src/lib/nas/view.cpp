@@ -0,0 +1,252 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "view.hpp"
+
+namespace nas
+{
+
+static const MessageLayout *MmLayout(EMessageType messageType)
+{
+    switch (messageType)
+    {
+    case EMessageType::REGISTRATION_REQUEST:
+        return LayoutOf<RegistrationRequest>();
+    case EMessageType::REGISTRATION_ACCEPT:
+        return LayoutOf<RegistrationAccept>();
+    case EMessageType::REGISTRATION_COMPLETE:
+        return LayoutOf<RegistrationComplete>();
+    case EMessageType::REGISTRATION_REJECT:
+        return LayoutOf<RegistrationReject>();
+    case EMessageType::DEREGISTRATION_REQUEST_UE_ORIGINATING:
+        return LayoutOf<DeRegistrationRequestUeOriginating>();
+    case EMessageType::DEREGISTRATION_ACCEPT_UE_ORIGINATING:
+        return LayoutOf<DeRegistrationAcceptUeOriginating>();
+    case EMessageType::DEREGISTRATION_REQUEST_UE_TERMINATED:
+        return LayoutOf<DeRegistrationRequestUeTerminated>();
+    case EMessageType::DEREGISTRATION_ACCEPT_UE_TERMINATED:
+        return LayoutOf<DeRegistrationAcceptUeTerminated>();
+    case EMessageType::SERVICE_REQUEST:
+        return LayoutOf<ServiceRequest>();
+    case EMessageType::SERVICE_REJECT:
+        return LayoutOf<ServiceReject>();
+    case EMessageType::SERVICE_ACCEPT:
+        return LayoutOf<ServiceAccept>();
+    case EMessageType::CONFIGURATION_UPDATE_COMMAND:
+        return LayoutOf<ConfigurationUpdateCommand>();
+    case EMessageType::CONFIGURATION_UPDATE_COMPLETE:
+        return LayoutOf<ConfigurationUpdateComplete>();
+    case EMessageType::AUTHENTICATION_REQUEST:
+        return LayoutOf<AuthenticationRequest>();
+    case EMessageType::AUTHENTICATION_RESPONSE:
+        return LayoutOf<AuthenticationResponse>();
+    case EMessageType::AUTHENTICATION_REJECT:
+        return LayoutOf<AuthenticationReject>();
+    case EMessageType::AUTHENTICATION_FAILURE:
+        return LayoutOf<AuthenticationFailure>();
+    case EMessageType::AUTHENTICATION_RESULT:
+        return LayoutOf<AuthenticationResult>();
+    case EMessageType::IDENTITY_REQUEST:
+        return LayoutOf<IdentityRequest>();
+    case EMessageType::IDENTITY_RESPONSE:
+        return LayoutOf<IdentityResponse>();
+    case EMessageType::SECURITY_MODE_COMMAND:
+        return LayoutOf<SecurityModeCommand>();
+    case EMessageType::SECURITY_MODE_COMPLETE:
+        return LayoutOf<SecurityModeComplete>();
+    case EMessageType::SECURITY_MODE_REJECT:
+        return LayoutOf<SecurityModeReject>();
+    case EMessageType::FIVEG_MM_STATUS:
+        return LayoutOf<FiveGMmStatus>();
+    case EMessageType::NOTIFICATION:
+        return LayoutOf<Notification>();
+    case EMessageType::NOTIFICATION_RESPONSE:
+        return LayoutOf<NotificationResponse>();
+    case EMessageType::UL_NAS_TRANSPORT:
+        return LayoutOf<UlNasTransport>();
+    case EMessageType::DL_NAS_TRANSPORT:
+        return LayoutOf<DlNasTransport>();
+    default:
+        return nullptr;
+    }
+}
+
+static const MessageLayout *SmLayout(EMessageType messageType)
+{
+    switch (messageType)
+    {
+    case EMessageType::PDU_SESSION_ESTABLISHMENT_REQUEST:
+        return LayoutOf<PduSessionEstablishmentRequest>();
+    case EMessageType::PDU_SESSION_ESTABLISHMENT_ACCEPT:
+        return LayoutOf<PduSessionEstablishmentAccept>();
+    case EMessageType::PDU_SESSION_ESTABLISHMENT_REJECT:
+        return LayoutOf<PduSessionEstablishmentReject>();
+    case EMessageType::PDU_SESSION_AUTHENTICATION_COMMAND:
+        return LayoutOf<PduSessionAuthenticationCommand>();
+    case EMessageType::PDU_SESSION_AUTHENTICATION_COMPLETE:
+        return LayoutOf<PduSessionAuthenticationComplete>();
+    case EMessageType::PDU_SESSION_AUTHENTICATION_RESULT:
+        return LayoutOf<PduSessionAuthenticationResult>();
+    case EMessageType::PDU_SESSION_MODIFICATION_REQUEST:
+        return LayoutOf<PduSessionModificationRequest>();
+    case EMessageType::PDU_SESSION_MODIFICATION_REJECT:
+        return LayoutOf<PduSessionModificationReject>();
+    case EMessageType::PDU_SESSION_MODIFICATION_COMMAND:
+        return LayoutOf<PduSessionModificationCommand>();
+    case EMessageType::PDU_SESSION_MODIFICATION_COMPLETE:
+        return LayoutOf<PduSessionModificationComplete>();
+    case EMessageType::PDU_SESSION_MODIFICATION_COMMAND_REJECT:
+        return LayoutOf<PduSessionModificationCommandReject>();
+    case EMessageType::PDU_SESSION_RELEASE_REQUEST:
+        return LayoutOf<PduSessionReleaseRequest>();
+    case EMessageType::PDU_SESSION_RELEASE_REJECT:
+        return LayoutOf<PduSessionReleaseReject>();
+    case EMessageType::PDU_SESSION_RELEASE_COMMAND:
+        return LayoutOf<PduSessionReleaseCommand>();
+    case EMessageType::PDU_SESSION_RELEASE_COMPLETE:
+        return LayoutOf<PduSessionReleaseComplete>();
+    case EMessageType::FIVEG_SM_STATUS:
+        return LayoutOf<FiveGSmStatus>();
+    default:
+        return nullptr;
+    }
+}
+
+const IeLayout *MessageLayout::findOptional(int iei) const
+{
+    for (auto &ie : optional)
+        if (ie.iei == iei)
+            return &ie;
+    return nullptr;
+}
+
+bool NasMessageView::parse(const uint8_t *data, size_t size)
+{
+    m_data = data;
+    m_size = size;
+    m_sht = ESecurityHeaderType::NOT_PROTECTED;
+    m_messageType = {};
+    m_pduSessionId = 0;
+    m_pti = 0;
+    m_layout = nullptr;
+    m_mandatoryCount = 0;
+    m_ieCount = 0;
+
+    if (size < 3)
+        return false;
+
+    OctetView stream{data, size};
+    m_epd = static_cast<EExtendedProtocolDiscriminator>(stream.readI());
+    if (m_epd == EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES)
+    {
+        m_sht = static_cast<ESecurityHeaderType>(stream.readI());
+        if (m_sht != ESecurityHeaderType::NOT_PROTECTED)
+            return size >= 7;
+
+        m_messageType = static_cast<EMessageType>(stream.readI());
+        m_layout = MmLayout(m_messageType);
+    }
+    else
+    {
+        if (size < 4)
+            return false;
+
+        m_pduSessionId = stream.readI();
+        m_pti = stream.readI();
+        m_messageType = static_cast<EMessageType>(stream.readI());
+        m_layout = SmLayout(m_messageType);
+    }
+
+    if (m_layout == nullptr)
+        return false;
+
+    for (auto &ie : m_layout->mandatory)
+        if (!addEntry(&ie, -1, stream))
+            return false;
+    m_mandatoryCount = m_ieCount;
+
+    while (stream.hasNext())
+    {
+        int iei = stream.peekI();
+        const IeLayout *ie = m_layout->findOptional(iei);
+        if (ie == nullptr)
+            ie = m_layout->findOptional((iei >> 4) & 0xF);
+        if (ie == nullptr)
+            return false;
+
+        if (!ie->halfOctetIei)
+            stream.read();
+        if (!addEntry(ie, ie->iei, stream))
+            return false;
+    }
+    return true;
+}
+
+bool NasMessageView::addEntry(const IeLayout *layout, int iei, const OctetView &stream)
+{
+    // The skipper reads the fixed part of the IE without any bounds check, i.e. the length octets, or the whole value
+    // of type 1 and 3 IEs which are decoded while skipping. The rest is only skipped and checked afterwards.
+    size_t start = stream.currentIndex();
+    if (m_ieCount == MAX_IES || start + static_cast<size_t>(layout->fixedOctets) > m_size)
+        return false;
+
+    layout->skipper(stream);
+
+    size_t end = stream.currentIndex();
+    if (end > m_size)
+        return false;
+
+    size_t offset = start + static_cast<size_t>(layout->lengthOctets);
+    m_ies[m_ieCount++] = IeEntry{layout, iei, static_cast<uint32_t>(start), static_cast<uint32_t>(offset),
+                                 static_cast<uint32_t>(end - offset)};
+    return true;
+}
+
+octet4 NasMessageView::messageAuthenticationCode() const
+{
+    return octet4{m_data[2], m_data[3], m_data[4], m_data[5]};
+}
+
+octet NasMessageView::sequenceNumber() const
+{
+    return octet{m_data[6]};
+}
+
+OctetView NasMessageView::plainNasMessage() const
+{
+    return OctetView{m_data + 7, m_size - 7};
+}
+
+const NasMessageView::IeEntry *NasMessageView::findOptional(int iei) const
+{
+    for (int i = m_mandatoryCount; i < m_ieCount; i++)
+        if (m_ies[i].iei == iei)
+            return &m_ies[i];
+    return nullptr;
+}
+
+bool NasMessageView::hasIe(int iei) const
+{
+    return findOptional(iei) != nullptr;
+}
+
+OctetView NasMessageView::mandatoryValue(int index) const
+{
+    auto &entry = m_ies[index];
+    return OctetView{m_data + entry.offset, entry.length};
+}
+
+OctetView NasMessageView::optionalValue(int iei) const
+{
+    const IeEntry *entry = findOptional(iei);
+    if (entry == nullptr)
+        return OctetView{nullptr, 0};
+    return OctetView{m_data + entry->offset, entry->length};
+}
+
+} // namespace nas
@@ -0,0 +1,173 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include "encode.hpp"
+#include "msg.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace nas
+{
+
+/* IE layout of a message type, built once from the onBuild function of the message */
+struct MessageLayout
+{
+    std::vector<IeLayout> mandatory{};
+    std::vector<IeLayout> optional{};
+
+    [[nodiscard]] const IeLayout *findOptional(int iei) const;
+};
+
+/* Layout of the message type T, built on the first use */
+template <typename T>
+const MessageLayout *LayoutOf()
+{
+    static const MessageLayout layout = [] {
+        NasMessageBuilder builder{NasMessageBuilder::LAYOUT};
+        T msg{};
+        msg.onBuild(builder);
+        return MessageLayout{std::move(builder.mandatoryLayout), std::move(builder.optionalLayout)};
+    }();
+    return &layout;
+}
+
+/*
+ * Zero-copy view of an encoded NAS message. Parsing only locates the IEs in the buffer, nothing is copied or
+ * allocated. The IE values can then be accessed as views into the buffer, or decoded on demand. The buffer must
+ * outlive the view.
+ * <p>
+ * For a security protected 5GMM message, only the security header is parsed and the view of the plain NAS message
+ * is given by plainNasMessage(), which can be parsed into another NasMessageView after the integrity check.
+ */
+class NasMessageView
+{
+  public:
+    static constexpr const int MAX_IES = 48;
+
+    struct IeEntry
+    {
+        const IeLayout *layout{};
+        int iei{};         // -1 for the mandatory IEs
+        uint32_t start{};  // Offset of the IE after the IEI (of the IEI octet for half-octet IEs)
+        uint32_t offset{}; // Offset of the value, after the length octets
+        uint32_t length{}; // Length of the value
+    };
+
+  private:
+    const uint8_t *m_data{};
+    size_t m_size{};
+
+    EExtendedProtocolDiscriminator m_epd{};
+    ESecurityHeaderType m_sht{};
+    EMessageType m_messageType{};
+    int m_pduSessionId{};
+    int m_pti{};
+
+    const MessageLayout *m_layout{};
+    std::array<IeEntry, MAX_IES> m_ies{};
+    int m_mandatoryCount{};
+    int m_ieCount{};
+
+  public:
+    /* Returns false if the message type is unknown or the message is malformed */
+    bool parse(const uint8_t *data, size_t size);
+
+    [[nodiscard]] inline EExtendedProtocolDiscriminator epd() const
+    {
+        return m_epd;
+    }
+
+    [[nodiscard]] inline ESecurityHeaderType sht() const
+    {
+        return m_sht;
+    }
+
+    [[nodiscard]] inline bool isSecured() const
+    {
+        return m_epd == EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES &&
+               m_sht != ESecurityHeaderType::NOT_PROTECTED;
+    }
+
+    /* Not applicable to security protected messages */
+    [[nodiscard]] inline EMessageType messageType() const
+    {
+        return m_messageType;
+    }
+
+    [[nodiscard]] inline int pduSessionId() const
+    {
+        return m_pduSessionId;
+    }
+
+    [[nodiscard]] inline int pti() const
+    {
+        return m_pti;
+    }
+
+    [[nodiscard]] octet4 messageAuthenticationCode() const;
+    [[nodiscard]] octet sequenceNumber() const;
+    [[nodiscard]] OctetView plainNasMessage() const;
+
+    [[nodiscard]] inline int ieCount() const
+    {
+        return m_ieCount;
+    }
+
+    [[nodiscard]] inline const IeEntry &ieAt(int index) const
+    {
+        return m_ies[index];
+    }
+
+    [[nodiscard]] bool hasIe(int iei) const;
+
+    /* Value of the mandatory IE with given index, in the order of the specification */
+    [[nodiscard]] OctetView mandatoryValue(int index) const;
+
+    /* Value of the optional IE with given IEI, or an empty view if it is not present */
+    [[nodiscard]] OctetView optionalValue(int iei) const;
+
+    template <typename T>
+    [[nodiscard]] T decodeMandatory(int index) const
+    {
+        assert(index < m_mandatoryCount && m_ies[index].layout->skipper == &SkipIe<T>);
+        return decodeEntry<T>(m_ies[index]);
+    }
+
+    template <typename T>
+    [[nodiscard]] std::optional<T> decodeOptional(int iei) const
+    {
+        const IeEntry *entry = findOptional(iei);
+        if (entry == nullptr)
+            return std::nullopt;
+        assert(entry->layout->skipper == &SkipIe<T>);
+        return decodeEntry<T>(*entry);
+    }
+
+  private:
+    [[nodiscard]] const IeEntry *findOptional(int iei) const;
+    bool addEntry(const IeLayout *layout, int iei, const OctetView &stream);
+
+    template <typename T>
+    [[nodiscard]] T decodeEntry(const IeEntry &entry) const
+    {
+        OctetView stream{m_data + entry.start, m_size - entry.start};
+        if constexpr (std::is_base_of<InformationElement1, T>::value)
+            return DecodeIe1<T>(stream);
+        else
+            return DecodeIe2346<T>(stream);
+    }
+};
+
+} // namespace nas
@@ -0,0 +1,307 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rlc
+{
+
+inline int SnOf(const RxPdu &pdu)
+{
+    return pdu.sn;
+}
+
+inline int SnOf(const RlcSduSegment &segment)
+{
+    return segment.sdu->sn;
+}
+
+/**
+ * RLC buffer indexed by SN modulo the window size. Items with the same SN are kept in the same slot sorted by SO.
+ * Slots are grouped in pages of 64 which are allocated on demand and released when they become empty, therefore
+ * the memory usage depends on the number of SNs in use, not on the SN length.
+ * <p>
+ * All the items must be in a window of the given size, i.e. two different SNs in the buffer never map to the same
+ * slot. Ordered traversal is done relative to a base SN (lower edge of the window) given by the caller.
+ */
+template <typename T>
+class SnRing
+{
+    static constexpr int PAGE_BITS = 6;
+    static constexpr int PAGE_SIZE = 1 << PAGE_BITS;
+
+    struct Page
+    {
+        uint64_t occupied{};
+        int count{};
+        std::vector<T *> slots[PAGE_SIZE];
+    };
+
+    int snModulus;
+    int windowSize;
+    std::vector<std::unique_ptr<Page>> pages;
+    int count;
+
+  public:
+    SnRing(int snModulus, int windowSize)
+        : snModulus(snModulus), windowSize(windowSize), pages((windowSize + PAGE_SIZE - 1) / PAGE_SIZE), count(0)
+    {
+        assert((windowSize & (windowSize - 1)) == 0);
+    }
+
+    ~SnRing()
+    {
+        clearAndDelete();
+    }
+
+    SnRing(const SnRing &) = delete;
+    SnRing &operator=(const SnRing &) = delete;
+
+  private:
+    [[nodiscard]] inline int slotIndex(int sn) const
+    {
+        return sn & (windowSize - 1);
+    }
+
+    [[nodiscard]] inline int distance(int base, int sn) const
+    {
+        int r = sn - base;
+        return r < 0 ? r + snModulus : r;
+    }
+
+    void releaseIfEmpty(int index)
+    {
+        auto &page = pages[index >> PAGE_BITS];
+        if (page->slots[index & (PAGE_SIZE - 1)].empty())
+            page->occupied &= ~(uint64_t{1} << (index & (PAGE_SIZE - 1)));
+        if (page->count == 0)
+            page.reset();
+    }
+
+  public:
+    [[nodiscard]] inline int getCount() const
+    {
+        return count;
+    }
+
+    [[nodiscard]] inline bool isEmpty() const
+    {
+        return count == 0;
+    }
+
+    /* Returns the items with given SN sorted by SO, or null if there is no such item */
+    [[nodiscard]] const std::vector<T *> *find(int sn) const
+    {
+        int index = slotIndex(sn);
+        auto &page = pages[index >> PAGE_BITS];
+        if (page == nullptr)
+            return nullptr;
+        auto &slot = page->slots[index & (PAGE_SIZE - 1)];
+        if (slot.empty())
+            return nullptr;
+        assert(SnOf(*slot[0]) == sn);
+        return &slot;
+    }
+
+    /* Inserts the item after the items with the same SN and a smaller or equal SO */
+    void insert(T *item)
+    {
+        int index = slotIndex(SnOf(*item));
+        auto &page = pages[index >> PAGE_BITS];
+        if (page == nullptr)
+            page = std::make_unique<Page>();
+
+        auto &slot = page->slots[index & (PAGE_SIZE - 1)];
+        assert(slot.empty() || SnOf(*slot[0]) == SnOf(*item));
+
+        auto pos = std::upper_bound(slot.begin(), slot.end(), item,
+                                    [](const T *a, const T *b) { return a->so < b->so; });
+        slot.insert(pos, item);
+
+        page->occupied |= uint64_t{1} << (index & (PAGE_SIZE - 1));
+        page->count++;
+        count++;
+    }
+
+    /* Removes the given item from the buffer without deleting it */
+    void remove(T *item)
+    {
+        int index = slotIndex(SnOf(*item));
+        auto &page = pages[index >> PAGE_BITS];
+        assert(page != nullptr);
+
+        auto &slot = page->slots[index & (PAGE_SIZE - 1)];
+        auto it = std::find(slot.begin(), slot.end(), item);
+        assert(it != slot.end());
+        slot.erase(it);
+
+        page->count--;
+        count--;
+        releaseIfEmpty(index);
+    }
+
+    /* Removes all the items with given SN from the buffer and returns them, sorted by SO */
+    std::vector<T *> take(int sn)
+    {
+        int index = slotIndex(sn);
+        auto &page = pages[index >> PAGE_BITS];
+        if (page == nullptr)
+            return {};
+
+        std::vector<T *> res{};
+        res.swap(page->slots[index & (PAGE_SIZE - 1)]);
+        if (res.empty())
+            return res;
+        assert(SnOf(*res[0]) == sn);
+
+        page->count -= static_cast<int>(res.size());
+        count -= static_cast<int>(res.size());
+        releaseIfEmpty(index);
+        return res;
+    }
+
+    /* Removes and deletes all the items with given SN */
+    void eraseAndDelete(int sn)
+    {
+        for (auto *item : take(sn))
+            delete item;
+    }
+
+    /**
+     * Returns the first SN in the buffer which is at or after the given SN, considering the window starting from the
+     * given base SN. If no such an SN is found, then -1 is returned.
+     */
+    [[nodiscard]] int nextSn(int base, int sn) const
+    {
+        int remaining = windowSize - distance(base, sn);
+        int index = slotIndex(sn);
+
+        while (remaining > 0)
+        {
+            int bit = index & (PAGE_SIZE - 1);
+            int span = std::min(PAGE_SIZE - bit, remaining);
+
+            auto &page = pages[index >> PAGE_BITS];
+            if (page != nullptr)
+            {
+                uint64_t bits = page->occupied >> bit;
+                if (span < PAGE_SIZE)
+                    bits &= (uint64_t{1} << span) - 1;
+                if (bits != 0)
+                    return SnOf(*page->slots[bit + __builtin_ctzll(bits)][0]);
+            }
+
+            remaining -= span;
+            index = (index + span) & (windowSize - 1);
+        }
+        return -1;
+    }
+
+    /* Returns the first SN in the window starting from the given base SN, or -1 if the buffer is empty */
+    [[nodiscard]] inline int firstSn(int base) const
+    {
+        return count == 0 ? -1 : nextSn(base, base);
+    }
+
+    /* Invokes the function for all items, in no particular order */
+    template <typename Fun>
+    void forEach(Fun fun) const
+    {
+        for (auto &page : pages)
+        {
+            if (page == nullptr)
+                continue;
+            for (auto &slot : page->slots)
+                for (auto *item : slot)
+                    fun(item);
+        }
+    }
+
+    /* Removes all the items whose SN satisfies the predicate, and invokes the consumer for each removed item */
+    template <typename SnPredicate, typename Consumer>
+    void removeIf(SnPredicate predicate, Consumer consumer)
+    {
+        for (size_t i = 0; i < pages.size(); i++)
+        {
+            if (pages[i] == nullptr)
+                continue;
+            for (int j = 0; j < PAGE_SIZE; j++)
+            {
+                auto &slot = pages[i]->slots[j];
+                if (!slot.empty() && predicate(SnOf(*slot[0])))
+                {
+                    for (auto *item : take(SnOf(*slot[0])))
+                        consumer(item);
+                    if (pages[i] == nullptr)
+                        break;
+                }
+            }
+        }
+    }
+
+    void clearAndDelete()
+    {
+        for (auto &page : pages)
+        {
+            if (page == nullptr)
+                continue;
+            for (auto &slot : page->slots)
+                for (auto *item : slot)
+                    delete item;
+            page.reset();
+        }
+        count = 0;
+    }
+};
+
+/**
+ * Set of SNs in a window, kept as a bitmap of the window size. Only the words that are set are cleared, so that
+ * the bitmap can be reused cheaply for every STATUS PDU.
+ */
+class SnBitmap
+{
+    int windowSize;
+    std::vector<uint64_t> words;
+    std::vector<int> dirty;
+
+  public:
+    explicit SnBitmap(int windowSize) : windowSize(windowSize), words((windowSize + 63) / 64), dirty()
+    {
+    }
+
+    [[nodiscard]] inline bool test(int sn) const
+    {
+        int index = sn & (windowSize - 1);
+        return (words[index >> 6] >> (index & 63)) & 1;
+    }
+
+    inline void set(int sn)
+    {
+        int index = sn & (windowSize - 1);
+        if (words[index >> 6] == 0)
+            dirty.push_back(index >> 6);
+        words[index >> 6] |= uint64_t{1} << (index & 63);
+    }
+
+    inline void clear()
+    {
+        for (int word : dirty)
+            words[word] = 0;
+        dirty.clear();
+    }
+};
+
+} // namespace rlc
@@ -16,8 +16,24 @@ namespace rlc
 
 UmdPdu *RlcEncoder::DecodeUmd(uint8_t *data, int size, bool isShortSn)
 {
+    if (size < 1)
+        return nullptr;
+
+    auto si = static_cast<ESegmentInfo>(bits::BitRange8<6, 7>(data[0]));
+
+    int headerSize = 1;
+    if (si != ESegmentInfo::FULL)
+    {
+        if (!isShortSn)
+            headerSize++;
+        if (si::requiresSo(si))
+            headerSize += 2;
+    }
+    if (size < headerSize)
+        return nullptr;
+
     auto *pdu = new UmdPdu();
-    pdu->si = static_cast<ESegmentInfo>(bits::BitRange8<6, 7>(data[0]));
+    pdu->si = si;
     pdu->so = 0;
     pdu->sn = 0;
     pdu->isProcessed = false;
@@ -26,16 +42,17 @@ UmdPdu *RlcEncoder::DecodeUmd(uint8_t *data, int size, bool isShortSn)
 
     if (pdu->si != ESegmentInfo::FULL)
     {
+        // The SN starts in the first octet, after the SI field (and the R bits for 12-bit SN)
         if (isShortSn)
         {
-            pdu->sn = bits::BitRange8<0, 5>(data[index]);
+            pdu->sn = bits::BitRange8<0, 5>(data[0]);
         }
         else
         {
-            pdu->sn = bits::BitRange8<0, 3>(data[index]);
+            pdu->sn = bits::BitRange8<0, 3>(data[0]);
             pdu->sn <<= 8;
+            pdu->sn |= data[index];
             index++;
-            pdu->sn |= bits::BitRange8<0, 7>(data[index]);
         }
 
         if (si::requiresSo(pdu->si))
@@ -64,11 +81,11 @@ int RlcEncoder::EncodeUmd(uint8_t *buffer, bool isShortSn, ESegmentInfo si, int
     {
         if (isShortSn)
         {
-            octet0 |= sn & 0b11111;
+            octet0 |= sn & 0b111111;
         }
         else
         {
-            octet0 |= (sn >> 8) & 0b111;
+            octet0 |= (sn >> 8) & 0b1111;
             remainingSn = sn & 0b11111111;
         }
     }
@@ -92,6 +109,9 @@ int RlcEncoder::EncodeUmd(uint8_t *buffer, bool isShortSn, ESegmentInfo si, int
 
 AmdPdu *RlcEncoder::DecodeAmd(uint8_t *data, int size, bool isShortSn)
 {
+    if (size < 1)
+        return nullptr;
+
     uint8_t octet = data[0];
 
     if (octet >> 7 != 1)
@@ -100,6 +120,12 @@ AmdPdu *RlcEncoder::DecodeAmd(uint8_t *data, int size, bool isShortSn)
         return nullptr;
     }
 
+    int headerSize = isShortSn ? 2 : 3;
+    if (si::requiresSo(static_cast<ESegmentInfo>(bits::BitRange8<4, 5>(octet))))
+        headerSize += 2;
+    if (size < headerSize)
+        return nullptr;
+
     auto *pdu = new AmdPdu();
     pdu->isProcessed = false;
     pdu->so = 0;
@@ -165,6 +191,11 @@ int RlcEncoder::EncodeAmd(uint8_t *buffer, bool isShortSn, ESegmentInfo si, int
 
 StatusPdu *RlcEncoder::DecodeStatus(uint8_t *data, int size, bool isShortSn)
 {
+    // The fixed part is 3 octets for both SN lengths
+    if (size < 3)
+        return nullptr;
+
+    size_t bitCount = static_cast<size_t>(size) * 8;
     BitBuffer buffer{data};
 
     if (buffer.read() != 0)
@@ -190,6 +221,12 @@ StatusPdu *RlcEncoder::DecodeStatus(uint8_t *data, int size, bool isShortSn)
 
     while (e1)
     {
+        if (buffer.currentIndex() + (isShortSn ? 16 : 24) > bitCount)
+        {
+            delete pdu;
+            return nullptr;
+        }
+
         int nackSn = buffer.readBits(isShortSn ? 12 : 18);
         e1 = buffer.read();
         bool e2 = buffer.read();
@@ -198,6 +235,12 @@ StatusPdu *RlcEncoder::DecodeStatus(uint8_t *data, int size, bool isShortSn)
         // consume reserved
         buffer.readBits(isShortSn ? 1 : 3);
 
+        if (buffer.currentIndex() + (e2 ? 32 : 0) + (e3 ? 8 : 0) > bitCount)
+        {
+            delete pdu;
+            return nullptr;
+        }
+
         int soStart = -1;
         int soEnd = -1;
         int nackRange = -1;
@@ -13,6 +13,7 @@
 namespace rlc
 {
 
+/* The decoders return nullptr if the PDU is shorter than its header, or than the fields announced in the header */
 class RlcEncoder
 {
   public:
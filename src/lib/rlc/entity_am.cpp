@@ -26,10 +26,11 @@ AmEntity::AmEntity(IRlcConsumer *consumer, int snLength, int txMaxSize, int rxMa
     : IRlcEntity(consumer), snLength(snLength), snModulus(1 << snLength), windowSize((1 << snLength) / 2),
       txMaxSize(txMaxSize), rxMaxSize(rxMaxSize), pollPdu(pollPdu), pollByte(pollByte),
       maxRetThreshold(maxRetThreshold), txNext(0), txNextAck(0), pollSn(0), pduWithoutPoll(0), byteWithoutPoll(0),
-      txCurrentSize(0), txBuffer{}, rxCurrentSize(0), rxBuffer{}, retBuffer{}, waitBuffer{}, ackBuffer{}, rxNext(0),
-      rxNextHighest(0), rxHighestStatus(0), rxNextStatusTrigger(0), statusTriggered(false), forcePoll(false),
-      tCurrent(0), pollRetransmitTimer(pollRetransmitPeriod), reassemblyTimer(reassemblyPeriod),
-      statusProhibitTimer(statusProhibitPeriod)
+      txCurrentSize(0), txBuffer{}, rxCurrentSize(0), rxBuffer(snModulus, windowSize),
+      retBuffer(snModulus, windowSize), waitBuffer(snModulus, windowSize), ackBuffer(snModulus, windowSize),
+      retIncremented(windowSize), rxNext(0), rxNextHighest(0), rxHighestStatus(0), rxNextStatusTrigger(0),
+      statusTriggered(false), forcePoll(false), tCurrent(0), pollRetransmitTimer(pollRetransmitPeriod),
+      reassemblyTimer(reassemblyPeriod), statusProhibitTimer(statusProhibitPeriod)
 {
     assert(snLength == 12 || snLength == 18);
     clearEntity();
@@ -119,66 +120,41 @@ bool AmEntity::pollControlForTransmissionOrRetransmission()
 
 bool AmEntity::areAllSegmentsInAck(int sn)
 {
-    int ackCount = 0, refCount = -1;
-
-    auto cursor = ackBuffer.getFirst();
-    while (cursor != nullptr)
-    {
-        RlcSdu *sdu = cursor->value->sdu;
-        if (snCompareTx(sdu->sn, sn) > 0)
-            break;
-        if (snCompareTx(sdu->sn, sn) == 0)
-        {
-            if (refCount == -1)
-                refCount = sdu->_refCount;
-            ackCount++;
-        }
-        cursor = cursor->getNext();
-    }
-
-    return ackCount == refCount;
-}
-
-int AmEntity::sduListCompare(const RlcSduSegment &a, const RlcSduSegment &b)
-{
-    if (a.sdu->sn == b.sdu->sn)
-        return a.so - b.so;
-    return snCompareTx(a.sdu->sn, b.sdu->sn);
-}
-
-void AmEntity::insertToList(LinkedList<RlcSduSegment> &list, RlcSduSegment *segment)
-{
-    auto comp = [this](const RlcSduSegment &a, const RlcSduSegment &b) { return sduListCompare(a, b); };
-    func::InsertSortedLinkedList(list, segment, ILambdaComparator<RlcSduSegment, decltype(comp)>{comp});
+    // Every segment holds a reference to the SDU, so all the segments are in the ACK buffer iff the count matches.
+    auto slot = ackBuffer.find(sn);
+    return slot != nullptr && static_cast<int>(slot->size()) == (*slot)[0]->sdu->_refCount;
 }
 
 //======================================================================================================
 //                                          PDU RECEIVE RELATED
 //======================================================================================================
 
-void AmEntity::receivePdu(uint8_t *data, int size)
+bool AmEntity::receivePdu(uint8_t *data, int size)
 {
-    if (size == 0)
-        return;
+    if (size <= 0)
+        return false;
 
     if (data[0] >> 7)
     {
         auto *pdu = RlcEncoder::DecodeAmd(data, size, snLength == 12);
-        if (pdu)
-            receiveAmdPdu(pdu);
+        if (pdu == nullptr)
+            return false;
+        receiveAmdPdu(pdu);
     }
     else
     {
         if ((data[0] >> 4) & 0b111)
         {
             // Discard the control PDU if it is not a STATUS PDU
-            return;
+            return true;
         }
 
         auto *pdu = RlcEncoder::DecodeStatus(data, size, snLength == 12);
-        if (pdu)
-            receiveStatusPdu(pdu);
+        if (pdu == nullptr)
+            return false;
+        receiveStatusPdu(pdu);
     }
+    return true;
 }
 
 void AmEntity::receiveAmdPdu(AmdPdu *pdu)
@@ -227,8 +203,7 @@ void AmEntity::receiveAmdPdu(AmdPdu *pdu)
     }
 
     // Place the received AMD PDU in the reception buffer
-    rxCurrentSize +=
-        func::InsertToRxBuffer(rxBuffer, pdu, ISnCompare([this](int a, int b) { return snCompareRx(a, b); }));
+    rxCurrentSize += func::InsertToRxBuffer(rxBuffer, pdu);
 
     // Actions when an AMD PDU is placed in the reception buffer
     actionsOnReception(*pdu);
@@ -289,13 +264,9 @@ void AmEntity::actionsOnReception(AmdPdu &pdu)
         //  for which not all bytes have been received.
         if (x == rxNext)
         {
-            while (!rxBuffer.isEmpty() && rxBuffer.getFirst()->value->isProcessed &&
-                   rxBuffer.getFirst()->value->sn == rxNext)
+            while (func::IsDelivered(rxBuffer, rxNext))
             {
-                do
-                {
-                    delete rxBuffer.removeFirst();
-                } while (!rxBuffer.isEmpty() && rxBuffer.getFirst()->value->sn == rxNext);
+                rxBuffer.eraseAndDelete(rxNext);
                 rxNext = (rxNext + 1) % snModulus;
             }
         }
@@ -348,8 +319,6 @@ void AmEntity::receiveStatusPdu(StatusPdu *pdu)
 
     ackReceived(pdu->ackSn);
 
-    Snset alreadyRetIncremented;
-
     for (auto &nackBlock : pdu->nackBlocks)
     {
         int nackSn = nackBlock.nackSn;
@@ -371,8 +340,7 @@ void AmEntity::receiveStatusPdu(StatusPdu *pdu)
 
         for (int i = 0; i < range; i++)
         {
-            nackReceived((nackSn + i) % snModulus, i == 0 ? soStart : 0, i == range - 1 ? soEnd : -1,
-                         alreadyRetIncremented);
+            nackReceived((nackSn + i) % snModulus, i == 0 ? soStart : 0, i == range - 1 ? soEnd : -1);
         }
 
         // Similar as above
@@ -380,99 +348,56 @@ void AmEntity::receiveStatusPdu(StatusPdu *pdu)
             pollRetransmitTimer.stop();
     }
 
+    retIncremented.clear();
+
     checkForSuccessIndication();
 }
 
 void AmEntity::ackReceived(int ackSn)
 {
-    Snset alreadyDec;
-
-    auto cursor = waitBuffer.getFirst();
-    while (cursor != nullptr)
+    // Move all the segments with SN < ACK_SN to the ACK buffer
+    int sn = waitBuffer.firstSn(txNextAck);
+    while (sn != -1 && snCompareTx(sn, ackSn) < 0)
     {
-        auto segment = cursor->value;
-        if (snCompareTx(segment->sdu->sn, ackSn) < 0)
-        {
-            waitBuffer.removeAndIncrement(cursor);
-            insertToList(ackBuffer, segment);
-        }
-        else
-        {
-            cursor = cursor->getNext();
-        }
+        for (auto *segment : waitBuffer.take(sn))
+            ackBuffer.insert(segment);
+        sn = waitBuffer.nextSn(txNextAck, sn);
     }
 
-    cursor = retBuffer.getFirst();
-    while (cursor != nullptr)
+    sn = retBuffer.firstSn(txNextAck);
+    while (sn != -1 && snCompareTx(sn, ackSn) < 0)
     {
-        auto segment = cursor->value;
-        if (snCompareTx(segment->sdu->sn, ackSn) < 0)
-        {
-            if (!alreadyDec[segment->sdu->sn])
-            {
-                segment->sdu->retransmissionCount--;
-                alreadyDec[segment->sdu->sn] = true;
-            }
-            retBuffer.removeAndIncrement(cursor);
-            insertToList(ackBuffer, segment);
-        }
-        else
-        {
-            cursor = cursor->getNext();
-        }
+        auto segments = retBuffer.take(sn);
+        segments[0]->sdu->retransmissionCount--;
+        for (auto *segment : segments)
+            ackBuffer.insert(segment);
+        sn = retBuffer.nextSn(txNextAck, sn);
     }
 }
 
-void AmEntity::nackReceived(int nackSn, int soStart, int soEnd, AmEntity::Snset &alreadyRetIncremented)
+void AmEntity::nackReceived(int nackSn, int soStart, int soEnd)
 {
     if (snCompareTx(txNextAck, nackSn) > 0 || snCompareTx(nackSn, txNext) >= 0)
         return;
 
-    auto cursor = waitBuffer.getFirst();
-
-    while (cursor != nullptr)
+    for (auto *buffer : {&waitBuffer, &ackBuffer})
     {
-        auto segment = cursor->value;
-        if (segment->sdu->sn == nackSn)
-        {
-            if (func::SoOverlap(soStart, soEnd, segment->so, segment->so + segment->size - 1))
-            {
-                waitBuffer.removeAndIncrement(cursor);
-                considerRetransmission(segment, !alreadyRetIncremented[nackSn]);
-                alreadyRetIncremented[nackSn] = true;
-            }
-            else
-            {
-                cursor = cursor->getNext();
-            }
-        }
-        else
-        {
-            cursor = cursor->getNext();
-        }
-    }
+        auto slot = buffer->find(nackSn);
+        if (slot == nullptr)
+            continue;
 
-    cursor = ackBuffer.getFirst();
-    while (cursor != nullptr)
-    {
-        auto segment = cursor->value;
-
-        if (segment->sdu->sn == nackSn)
+        std::vector<RlcSduSegment *> nacked{};
+        for (auto *segment : *slot)
         {
             if (func::SoOverlap(soStart, soEnd, segment->so, segment->so + segment->size - 1))
-            {
-                ackBuffer.removeAndIncrement(cursor);
-                considerRetransmission(segment, !alreadyRetIncremented[nackSn]);
-                alreadyRetIncremented[nackSn] = true;
-            }
-            else
-            {
-                cursor = cursor->getNext();
-            }
+                nacked.push_back(segment);
         }
-        else
+
+        for (auto *segment : nacked)
         {
-            cursor = cursor->getNext();
+            buffer->remove(segment);
+            considerRetransmission(segment, !retIncremented.test(nackSn));
+            retIncremented.set(nackSn);
         }
     }
 }
@@ -485,23 +410,20 @@ void AmEntity::considerRetransmission(RlcSduSegment *segment, bool updateRetX)
         if (segment->sdu->retransmissionCount >= maxRetThreshold)
             consumer->maxRetransmissionReached(this);
     }
-    insertToList(retBuffer, segment);
+    retBuffer.insert(segment);
 }
 
 void AmEntity::checkForSuccessIndication()
 {
-    auto cursor = ackBuffer.getFirst();
-
     // TODO: Currently sequential succ indication, but not immediate.
-    while (cursor != nullptr && cursor->value->sdu->sn == txNextAck && areAllSegmentsInAck(cursor->value->sdu->sn))
+    while (areAllSegmentsInAck(txNextAck))
     {
-        txCurrentSize -= cursor->value->sdu->size;
-        int sn = cursor->value->sdu->sn;
+        auto sdu = (*ackBuffer.find(txNextAck))[0]->sdu;
+        txCurrentSize -= sdu->size;
 
-        consumer->sduSuccessfulDelivery(this, cursor->value->sdu->sduId);
+        consumer->sduSuccessfulDelivery(this, sdu->sduId);
 
-        while (cursor != nullptr && cursor->value->sdu->sn == sn)
-            delete ackBuffer.removeAndIncrement(cursor);
+        ackBuffer.eraseAndDelete(txNextAck);
         txNextAck = (txNextAck + 1) % snModulus;
     }
 }
@@ -554,8 +476,8 @@ int AmEntity::createStatusPdu(uint8_t *buffer, int maxSize, bool noSideEffect)
             break;
 
         MissingBlock missing{};
-        if (!func::FindMissingBlock(rxBuffer, startSn, startSo, (rxHighestStatus - 1 + snModulus) % snModulus, 0xFFFF,
-                                    snModulus, missing))
+        if (!func::FindMissingBlock(rxBuffer, rxNext, startSn, startSo, (rxHighestStatus - 1 + snModulus) % snModulus,
+                                    0xFFFF, snModulus, missing))
             break;
 
         NackBlock block{};
@@ -623,17 +545,12 @@ int AmEntity::createStatusPdu(uint8_t *buffer, int maxSize, bool noSideEffect)
 
     if (!noSideEffect)
     {
-        auto cursor = rxBuffer.getFirst();
-        while (cursor != nullptr)
+        int sn = rxBuffer.firstSn(rxNext);
+        while (sn != -1 && snCompareRx(sn, rxHighestStatus) < 0)
         {
-            if (snCompareRx(cursor->value->sn, rxHighestStatus) >= 0)
-                break;
-            if (snCompareRx(cursor->value->sn, rxNext) >= 0)
-            {
-                if (cursor->value->isProcessed)
-                    ackSn = (cursor->value->sn + 1) % snModulus;
-            }
-            cursor = cursor->getNext();
+            if (func::IsDelivered(rxBuffer, sn))
+                ackSn = (sn + 1) % snModulus;
+            sn = rxBuffer.nextSn(rxNext, (sn + 1) % snModulus);
         }
     }
 
@@ -652,17 +569,19 @@ int AmEntity::createStatusPdu(uint8_t *buffer, int maxSize, bool noSideEffect)
 
 int AmEntity::createRetPdu(uint8_t *buffer, int maxSize)
 {
-    auto segment = retBuffer.getFirstElement();
-    if (segment == nullptr)
+    int sn = retBuffer.firstSn(txNextAck);
+    if (sn == -1)
         return 0;
 
+    auto segment = (*retBuffer.find(sn))[0];
+
     int headerSize = func::AmdPduHeaderSize(snLength, segment->si);
 
     // Fragmentation is irrelevant since no byte fits the size.
     if (headerSize + 1 > maxSize)
         return 0;
 
-    retBuffer.removeFirst();
+    retBuffer.remove(segment);
 
     // Perform segmentation if it is needed
     if (headerSize + segment->size > maxSize)
@@ -670,10 +589,10 @@ int AmEntity::createRetPdu(uint8_t *buffer, int maxSize)
         auto next = func::AmPerformSegmentation(segment, maxSize, snLength);
         if (next == nullptr)
             return 0;
-        retBuffer.addFirst(next);
+        retBuffer.insert(next);
     }
 
-    insertToList(waitBuffer, segment);
+    waitBuffer.insert(segment);
 
     bool includePoll = pollControlForTransmissionOrRetransmission();
 
@@ -716,7 +635,7 @@ int AmEntity::createTxPdu(uint8_t *buffer, int maxSize)
     if (si::hasLast(segment->si))
         txNext = (txNext + 1) % snModulus;
 
-    insertToList(waitBuffer, segment);
+    waitBuffer.insert(segment);
 
     // 5.3.3.2	Transmission of a AMD PDU
     //  Upon notification of a transmission opportunity by lower layer, for each AMD PDU submitted for
@@ -831,36 +750,23 @@ void AmEntity::actionsOnPollRetransmitTimerExpired()
     {
         // 5.3.3.4: Consider the RLC SDU with the highest SN among the RLC SDUs submitted to lower layer for
         // retransmission
-        auto item = func::FirstItemWithSn(waitBuffer, (txNext - 1 + snModulus) % snModulus);
+        int sn = (txNext - 1 + snModulus) % snModulus;
 
         // 5.3.3.4: ... or consider any RLC SDU which has not been positively acknowledged for retransmission.
-        if (item == nullptr)
+        if (waitBuffer.find(sn) == nullptr)
         {
             // The spec says 'any', here we take first one.
-            item = waitBuffer.getFirst();
+            sn = waitBuffer.firstSn(txNextAck);
         }
 
-        if (item != nullptr)
+        if (sn != -1)
         {
-            auto sn = item->value->sdu->sn;
-            bool alreadyRetIncremented = false;
-            auto cursor = waitBuffer.getFirst();
-
             // Spec says SDU, not segment. Therefore take all segments.
-            while (cursor != nullptr)
+            bool alreadyRetIncremented = false;
+            for (auto *segment : waitBuffer.take(sn))
             {
-                if (snCompareTx(cursor->value->sdu->sn, sn) > 0)
-                    break;
-                if (snCompareTx(cursor->value->sdu->sn, sn) == 0)
-                {
-                    considerRetransmission(cursor->value, !alreadyRetIncremented);
-                    alreadyRetIncremented = true;
-                    waitBuffer.removeAndIncrement(cursor);
-                }
-                else
-                {
-                    cursor = cursor->getNext();
-                }
+                considerRetransmission(segment, !alreadyRetIncremented);
+                alreadyRetIncremented = true;
             }
         }
     }
@@ -883,7 +789,8 @@ void AmEntity::calculateDataVolume(RlcDataVolume &volume)
     volume.receptionSize = rxCurrentSize; // An estimation.
 
     // Calculate RETX
-    volume.retransmissionSize = func::ListSum<RlcSduSegment>(retBuffer, txCalc);
+    volume.retransmissionSize = 0;
+    retBuffer.forEach([&volume, &txCalc](const RlcSduSegment *v) { volume.retransmissionSize += txCalc(v); });
 
     // Calculate STATUS
     volume.statusSize = estimateStatusSize();
@@ -8,11 +8,10 @@
 
 #pragma once
 
+#include "buffer.hpp"
 #include "rlc.hpp"
 #include "utils.hpp"
 
-#include <bitset>
-
 #include <utils/linked_list.hpp>
 
 namespace rlc
@@ -20,8 +19,6 @@ namespace rlc
 
 class AmEntity : public IRlcEntity
 {
-    using Snset = std::bitset<262144>;
-
     // Configurations
     int snLength;
     int snModulus;
@@ -45,12 +42,15 @@ class AmEntity : public IRlcEntity
 
     // RX buffer
     int rxCurrentSize;
-    LinkedList<AmdPdu> rxBuffer;
+    SnRing<AmdPdu> rxBuffer;
 
     // Other Buffers
-    LinkedList<RlcSduSegment> retBuffer;
-    LinkedList<RlcSduSegment> waitBuffer;
-    LinkedList<RlcSduSegment> ackBuffer;
+    SnRing<RlcSduSegment> retBuffer;
+    SnRing<RlcSduSegment> waitBuffer;
+    SnRing<RlcSduSegment> ackBuffer;
+
+    // SNs whose RETX_COUNT is already incremented while processing a STATUS PDU
+    SnBitmap retIncremented;
 
     // RX state variables
     int rxNext;
@@ -88,15 +88,13 @@ class AmEntity : public IRlcEntity
 
     /* Internal */
     bool areAllSegmentsInAck(int sn);
-    int sduListCompare(const RlcSduSegment &a, const RlcSduSegment &b);
-    void insertToList(LinkedList<RlcSduSegment> &list, RlcSduSegment *segment);
 
     /* PDU receive related */
     void receiveAmdPdu(AmdPdu *pdu);
     void actionsOnReception(AmdPdu &pdu);
     void receiveStatusPdu(StatusPdu *pdu);
     void ackReceived(int ackSn);
-    void nackReceived(int nackSn, int soStart, int soEnd, Snset &alreadyRetIncremented);
+    void nackReceived(int nackSn, int soStart, int soEnd);
     void considerRetransmission(RlcSduSegment *segment, bool updateRetX);
     void checkForSuccessIndication();
 
@@ -114,7 +112,7 @@ class AmEntity : public IRlcEntity
     int estimateStatusSize();
 
   public:
-    void receivePdu(uint8_t *data, int size) override;
+    bool receivePdu(uint8_t *data, int size) override;
     int createPdu(uint8_t *buffer, int maxSize) override;
     void timerCycle(int64_t currentTime) override;
     void receiveSdu(uint8_t *data, int size, int sduId) override;
@@ -20,9 +20,10 @@ void TmEntity::clearEntity()
     txBuffer.clearAndDelete();
 }
 
-void TmEntity::receivePdu(uint8_t *data, int size)
+bool TmEntity::receivePdu(uint8_t *data, int size)
 {
     consumer->deliverSdu(this, data, size);
+    return true;
 }
 
 void TmEntity::receiveSdu(uint8_t *data, int size, int sduId)
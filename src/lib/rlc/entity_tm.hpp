@@ -36,7 +36,7 @@ class TmEntity : public IRlcEntity
     void clearEntity();
 
   public:
-    void receivePdu(uint8_t *data, int size) override;
+    bool receivePdu(uint8_t *data, int size) override;
     void receiveSdu(uint8_t *data, int size, int sduId) override;
     int createPdu(uint8_t *buffer, int maxSize) override;
     void timerCycle(int64_t currentTime) override;
@@ -20,8 +20,9 @@
 
 rlc::UmEntity::UmEntity(rlc::IRlcConsumer *consumer, int snLength, int tReassemblyPeriod, int txMaxSize, int rxMaxSize)
     : IRlcEntity(consumer), snLength(snLength), snModulus(1 << snLength), windowSize((1 << snLength) / 2),
-      txMaxSize(txMaxSize), rxMaxSize(rxMaxSize), txCurrentSize(0), txNext(0), rxCurrentSize(0), rxNextReassembly(0),
-      rxNextHighest(0), rxTimerTrigger(0), tCurrent(0), reassemblyTimer(tReassemblyPeriod)
+      txMaxSize(txMaxSize), rxMaxSize(rxMaxSize), txCurrentSize(0), txNext(0), rxCurrentSize(0),
+      rxBuffer(snModulus, snModulus), rxNextReassembly(0), rxNextHighest(0), rxTimerTrigger(0), tCurrent(0),
+      reassemblyTimer(tReassemblyPeriod)
 {
     assert(snLength == 6 || snLength == 12);
 
@@ -212,43 +213,44 @@ void rlc::UmEntity::actionsOnReassemblyTimerExpired()
 //                                             BASE FUNCTIONS
 //======================================================================================================
 
-void rlc::UmEntity::receivePdu(uint8_t *data, int size)
+bool rlc::UmEntity::receivePdu(uint8_t *data, int size)
 {
-    auto pdu = RlcEncoder::DecodeUmd(data, size, snLength == 6);
+    auto pdu = std::unique_ptr<UmdPdu>(RlcEncoder::DecodeUmd(data, size, snLength == 6));
     if (pdu == nullptr)
-        return;
+        return false;
 
     pdu->isProcessed = false;
 
     // If data length == 0, then discard.
     if (pdu->size == 0)
-        return;
+        return true;
 
     // If it is a full SDU, deliver directly.
     if (pdu->si == ESegmentInfo::FULL)
     {
         consumer->deliverSdu(this, pdu->data, pdu->size);
-        return;
+        return true;
     }
 
     // If SO is invalid, then discard.
     if (si::requiresSo(pdu->si) && pdu->so == 0)
-        return;
+        return true;
 
     // If (RX_Next_Highest – UM_Window_Size) <= SN < RX_Next_Reassembly, then discard.
     if (snCompareRx(pdu->sn, rxNextReassembly) < 0)
-        return;
+        return true;
 
     // If no room, then discard.
     if (rxCurrentSize + pdu->size > rxMaxSize)
-        return;
+        return true;
 
     // Place the received UMD PDU in the reception buffer
-    rxCurrentSize +=
-        func::InsertToRxBuffer(rxBuffer, pdu, ISnCompare([this](int a, int b) { return snCompareRx(a, b); }));
+    auto &placed = *pdu;
+    rxCurrentSize += func::InsertToRxBuffer(rxBuffer, pdu.release());
 
     // Actions when an UMD PDU is placed in the reception buffer (5.2.2.2.3)
-    actionsOnReception(*pdu);
+    actionsOnReception(placed);
+    return true;
 }
 
 void rlc::UmEntity::receiveSdu(uint8_t *data, int size, int sduId)
@@ -285,8 +287,10 @@ int rlc::UmEntity::createPdu(uint8_t *buffer, int maxSize)
 
     txCurrentSize -= segment->size;
 
-    return RlcEncoder::EncodeUmd(buffer, snLength == 6, segment->si, segment->so, segment->sdu->sn,
-                                 segment->sdu->data + segment->so, segment->size);
+    int written = RlcEncoder::EncodeUmd(buffer, snLength == 6, segment->si, segment->so, segment->sdu->sn,
+                                        segment->sdu->data + segment->so, segment->size);
+    delete segment;
+    return written;
 }
 
 void rlc::UmEntity::timerCycle(int64_t currentTime)
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "buffer.hpp"
 #include "rlc.hpp"
 #include "utils.hpp"
 
@@ -34,7 +35,7 @@ class UmEntity : public IRlcEntity
 
     // RX buffer
     int rxCurrentSize;
-    LinkedList<UmdPdu> rxBuffer;
+    SnRing<UmdPdu> rxBuffer;
 
     // RX state variables
     int rxNextReassembly; // Earliest SN that is still considered for reassembly
@@ -62,7 +63,7 @@ class UmEntity : public IRlcEntity
     void actionsOnReassemblyTimerExpired();
 
   public:
-    void receivePdu(uint8_t *data, int size) override;
+    bool receivePdu(uint8_t *data, int size) override;
     void receiveSdu(uint8_t *data, int size, int sduId) override;
     int createPdu(uint8_t *buffer, int maxSize) override;
     void timerCycle(int64_t currentTime) override;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "buffer.hpp"
 #include "utils.hpp"
 
 #include <cassert>
@@ -19,36 +20,6 @@
 namespace rlc::func
 {
 
-/**
- * Inserts the item to the linked list as sorted.
- */
-template <typename T>
-inline void InsertSortedLinkedList(LinkedList<T> &list, T *item, const IComparator<T> &comparator)
-{
-    if (list.isEmpty())
-    {
-        list.addFirst(item);
-        return;
-    }
-
-    auto cursor = list.getFirst();
-    while (cursor != nullptr)
-    {
-        if (comparator.compare(*cursor->value, *item) > 0)
-            break;
-        cursor = cursor->getNext();
-    }
-
-    if (cursor != nullptr)
-    {
-        list.addBefore(cursor, item);
-    }
-    else
-    {
-        list.addLast(item);
-    }
-}
-
 /**
  * Returns UMD PDU header size. UMD PDU header size depends on snLength and SI
  */
@@ -105,14 +76,6 @@ inline RlcSduSegment *UmPerformSegmentation(RlcSduSegment *sdu, int maxSize, int
     return next;
 }
 
-/**
- * Raw comparison function for SN. This function is only used for its special place.
- */
-inline int SnCompareRaw(int a, int b)
-{
-    return a - b;
-}
-
 /**
  * Returns AMD PDU header size. AMD PDU header size depends on snLength and SI
  */
@@ -215,64 +178,53 @@ inline bool SoOverlap(int start1, int end1, int start2, int end2)
 }
 
 /**
- * Return true iff there exists some segment in the list such that SN=sn.
- * The list may or may not be sorted. Therefore, iteration is done until the end of the list,
- * i.e no shortcut is performed.
- */
-inline bool SduListContainsSn(LinkedList<RlcSduSegment> &list, int sn)
-{
-    return list.any([sn](RlcSduSegment *s) { return s->sdu->sn == sn; });
-}
-
-/**
- * Returns the first item in the list such that SN=sn. If no such an item is found, then null is returned.
+ * Returns the first item that covers given SN and SO. In other words, among the PDUs with SN=sn, we look for the
+ * first PDU that overlaps with the given SO.
  */
 template <typename T>
-inline LinkedItem<T> *FirstItemWithSn(LinkedList<T> &list, int sn)
+inline const T *FirstItemIntersecting(const SnRing<T> &list, int sn, int so)
 {
-    auto cursor = list.getFirst();
-    while (cursor != nullptr && cursor->value->sn != sn)
-        cursor = cursor->getNext();
-    return cursor;
-}
+    auto slot = list.find(sn);
+    if (slot == nullptr)
+        return nullptr;
 
-/**
- * Returns the first item in the list such that SN=sn. If no such an item is found, then null is returned.
- */
-inline LinkedItem<RlcSduSegment> *FirstItemWithSn(LinkedList<RlcSduSegment> &list, int sn)
-{
-    auto cursor = list.getFirst();
-    while (cursor != nullptr && cursor->value->sdu->sn != sn)
-        cursor = cursor->getNext();
-    return cursor;
+    for (auto *item : *slot)
+    {
+        auto startSo = si::requiresSo(item->si) ? item->so : 0;
+        auto endSo = startSo + item->size;
+
+        if (so >= startSo && so < endSo)
+            return item;
+    }
+    return nullptr;
 }
 
 /**
- * Returns the first item that covers given SN and SO. In other words, first we find the first PDU with SN.
- * Then while maintaining the SN=sn invariant, we look for the first PDU that overlaps with the given SO.
+ * Returns the first item which is at or after the given SN and SO, considering the window starting from the base SN.
+ * If no such an item is found, then null is returned.
  */
 template <typename T>
-inline LinkedItem<T> *FirstItemIntersecting(LinkedList<T> &list, int sn, int so)
+inline const T *FirstItemNotBefore(const SnRing<T> &list, int base, int sn, int so, int snModulus)
 {
-    auto cursor = FirstItemWithSn(list, sn);
-    while (cursor != nullptr && cursor->value->sn == sn)
+    auto slot = list.find(sn);
+    if (slot != nullptr)
     {
-        auto startSo = si::requiresSo(cursor->value->si) ? cursor->value->so : 0;
-        auto endSo = startSo + cursor->value->size;
-
-        if (so >= startSo && so < endSo)
+        for (auto *item : *slot)
         {
-            return cursor;
+            if ((si::requiresSo(item->si) ? item->so : 0) >= so)
+                return item;
         }
-        cursor = cursor->getNext();
     }
-    return nullptr;
+
+    int next = list.nextSn(base, (sn + 1) % snModulus);
+    return next == -1 ? nullptr : (*list.find(next))[0];
 }
 
 /**
  * Finds the next missing block and returns that block. If no such a block is found, then null is returned.
+ * SN values are compared in the window starting from the base SN.
  */
-inline bool FindMissingBlock(LinkedList<AmdPdu> &rxBuffer, int startSn, int startSo, int endSn, int endSo,
+inline bool FindMissingBlock(const SnRing<AmdPdu> &rxBuffer, int base, int startSn, int startSo, int endSn, int endSo,
                              int snModulus, MissingBlock &res)
 {
     // Start line >= end line ise missin part yok demektir.
@@ -296,46 +248,36 @@ inline bool FindMissingBlock(LinkedList<AmdPdu> &rxBuffer, int startSn, int star
     //        end line olur
     // Son
     //
-    // NOT: Kayıp blokları bulurken döngüsel arama istemediğimiz için snCompareRx yerine SnCompareRaw kullanılıyor.
-    //
 
-    if (SnCompareRaw(startSn, endSn) > 0 || (SnCompareRaw(startSn, endSn) == 0 && startSo >= endSo))
+    auto snCompare = [base, snModulus](int a, int b) {
+        return (a - base + snModulus) % snModulus - (b - base + snModulus) % snModulus;
+    };
+
+    if (snCompare(startSn, endSn) > 0 || (snCompare(startSn, endSn) == 0 && startSo >= endSo))
         return false;
 
     auto segment = FirstItemIntersecting(rxBuffer, startSn, startSo);
     if (segment != nullptr)
     {
-        auto endPointSn = segment->value->sn;
-        auto endPointSo =
-            si::requiresSo(segment->value->si) ? segment->value->so + segment->value->size : segment->value->size;
+        auto endPointSn = segment->sn;
+        auto endPointSo = si::requiresSo(segment->si) ? segment->so + segment->size : segment->size;
 
         // An assertion just in case (checking for infinite recursion)
-        if (SnCompareRaw(startSn, endPointSn) == 0 && endPointSo == startSo)
+        if (snCompare(startSn, endPointSn) == 0 && endPointSo == startSo)
             assert(false);
 
-        if (si::hasLast(segment->value->si))
-            return FindMissingBlock(rxBuffer, (endPointSn + 1) % snModulus, 0, endSn, endSo, snModulus, res);
+        if (si::hasLast(segment->si))
+            return FindMissingBlock(rxBuffer, base, (endPointSn + 1) % snModulus, 0, endSn, endSo, snModulus, res);
         else
-            return FindMissingBlock(rxBuffer, endPointSn, endPointSo, endSn, endSo, snModulus, res);
+            return FindMissingBlock(rxBuffer, base, endPointSn, endPointSo, endSn, endSo, snModulus, res);
     }
 
     res.snStart = startSn;
     res.soStart = startSo;
 
-    auto cursor = rxBuffer.getFirst();
-
-    while (cursor != nullptr)
-    {
-        auto val = cursor->value;
-        auto so = si::requiresSo(val->si) ? val->so : 0;
-
-        if (SnCompareRaw(val->sn, startSn) < 0 || (SnCompareRaw(val->sn, startSn) == 0 && so < startSo))
-            cursor = cursor->getNext();
-        else
-            break;
-    }
+    auto next = FirstItemNotBefore(rxBuffer, base, startSn, startSo, snModulus);
 
-    if (cursor == nullptr)
+    if (next == nullptr)
     {
         res.snEnd = endSn;
         res.soEnd = endSo;
@@ -347,10 +289,10 @@ inline bool FindMissingBlock(LinkedList<AmdPdu> &rxBuffer, int startSn, int star
         return true;
     }
 
-    auto startPointSn = cursor->value->sn;
-    auto startPointSo = si::requiresSo(cursor->value->si) ? cursor->value->so : 0;
+    auto startPointSn = next->sn;
+    auto startPointSo = si::requiresSo(next->si) ? next->so : 0;
 
-    if (SnCompareRaw(startPointSn, endSn) > 0 || (SnCompareRaw(startPointSn, endSn) == 0 && startPointSo > endSo))
+    if (snCompare(startPointSn, endSn) > 0 || (snCompare(startPointSn, endSn) == 0 && startPointSo > endSo))
     {
         res.snEnd = endSn;
         res.soEnd = endSo;
@@ -367,7 +309,7 @@ inline bool FindMissingBlock(LinkedList<AmdPdu> &rxBuffer, int startSn, int star
         res.snEnd = startPointSn;
         res.soEnd = startPointSo - 1;
 
-        if (si::hasLast(cursor->value->si))
+        if (si::hasLast(next->si))
         {
             res.snNext = (startPointSn + 1) % snModulus;
             res.soNext = 0;
@@ -375,7 +317,7 @@ inline bool FindMissingBlock(LinkedList<AmdPdu> &rxBuffer, int startSn, int star
         else
         {
             res.snNext = startPointSn;
-            res.soNext = (si::requiresSo(cursor->value->si) ? cursor->value->so : 0) + cursor->value->size;
+            res.soNext = startPointSo + next->size;
         }
     }
     else
@@ -394,26 +336,28 @@ inline bool FindMissingBlock(LinkedList<AmdPdu> &rxBuffer, int startSn, int star
  * (SO value should be non-negative.)
  */
 template <typename T>
-inline bool IsAlreadyReceived(LinkedList<T> &rxList, int sn, int so, int size)
+inline bool IsAlreadyReceived(const SnRing<T> &rxList, int sn, int so, int size)
 {
-    auto cursor = rxList.getFirst();
-    while (cursor != nullptr && size > 0)
+    auto slot = rxList.find(sn);
+    if (slot == nullptr)
+        return size <= 0;
+
+    for (auto *item : *slot)
     {
-        if (cursor->value->sn == sn)
+        if (size <= 0)
+            break;
+
+        if (item->so <= so && so < item->so + item->size)
         {
-            if (cursor->value->so <= so && so < cursor->value->so + cursor->value->size)
-            {
-                int done = cursor->value->size - (so - cursor->value->so);
-                size -= done;
-                so += done;
-            }
-            else if (cursor->value->so <= so + size - 1 && so + size - 1 < cursor->value->so + cursor->value->size)
-            {
-                int done = size - (cursor->value->so - so);
-                size -= done;
-            }
+            int done = item->size - (so - item->so);
+            size -= done;
+            so += done;
+        }
+        else if (item->so <= so + size - 1 && so + size - 1 < item->so + item->size)
+        {
+            int done = size - (item->so - so);
+            size -= done;
         }
-        cursor = cursor->getNext();
     }
     return size <= 0;
 }
@@ -423,23 +367,22 @@ inline bool IsAlreadyReceived(LinkedList<T> &rxList, int sn, int so, int size)
  * NOTE: If no such a segment, the false is returned as there is no missing segment
  */
 template <typename T>
-inline bool HasMissingSegment(LinkedList<T> &list, int sn)
+inline bool HasMissingSegment(const SnRing<T> &list, int sn)
 {
-    auto cursor = FirstItemWithSn(list, sn);
+    auto slot = list.find(sn);
 
-    if (cursor == nullptr || cursor->value->isProcessed)
+    if (slot == nullptr || (*slot)[0]->isProcessed)
         return false;
 
     int lastByte = -1;
 
-    while (cursor != nullptr && cursor->value->sn == sn)
+    for (auto *item : *slot)
     {
-        if (cursor->value->so > lastByte + 1)
+        if (item->so > lastByte + 1)
             return true;
-        auto newLastByte = cursor->value->so + cursor->value->size - 1;
+        auto newLastByte = item->so + item->size - 1;
         if (newLastByte > lastByte)
             lastByte = newLastByte;
-        cursor = cursor->getNext();
     }
 
     return false;
@@ -451,24 +394,23 @@ inline bool HasMissingSegment(LinkedList<T> &list, int sn)
  * processed, then false is returned.
  */
 template <typename T>
-inline bool IsAllSegmentsReceived(LinkedList<T> &list, int sn)
+inline bool IsAllSegmentsReceived(const SnRing<T> &list, int sn)
 {
-    auto cursor = FirstItemWithSn(list, sn);
+    auto slot = list.find(sn);
 
-    if (cursor != nullptr && cursor->value->isProcessed)
+    if (slot == nullptr || (*slot)[0]->isProcessed)
         return false;
 
     int last = -1;
-    while (cursor != nullptr && cursor->value->sn == sn)
+    for (auto *item : *slot)
     {
-        if (cursor->value->so > last + 1)
+        if (item->so > last + 1)
             return false;
-        if (si::hasLast(cursor->value->si))
+        if (si::hasLast(item->si))
             return true;
-        int newLast = cursor->value->so + cursor->value->size - 1;
+        int newLast = item->so + item->size - 1;
         if (newLast > last)
             last = newLast;
-        cursor = cursor->getNext();
     }
 
     return false;
@@ -476,13 +418,13 @@ inline bool IsAllSegmentsReceived(LinkedList<T> &list, int sn)
 
 /**
  * Returns true if the given SN is already delivered (processed). If no such an RX PDU is found,
- * it is treated as it is already processed.
+ * it is treated as it is not delivered.
  */
 template <typename T>
-inline bool IsDelivered(LinkedList<T> &list, int sn)
+inline bool IsDelivered(const SnRing<T> &list, int sn)
 {
-    auto cursor = FirstItemWithSn(list, sn);
-    return cursor != nullptr && cursor->value->isProcessed;
+    auto slot = list.find(sn);
+    return slot != nullptr && (*slot)[0]->isProcessed;
 }
 
 /**
@@ -491,43 +433,28 @@ inline bool IsDelivered(LinkedList<T> &list, int sn)
  * its size is treated as zero. Because buffer size is already decremented while setting isProcessed = true.
  */
 template <typename T, typename SnPredicate>
-inline int DiscardRxPduIf(LinkedList<T> &list, SnPredicate predicate)
+inline int DiscardRxPduIf(SnRing<T> &list, SnPredicate predicate)
 {
     int decreased = 0;
 
-    auto cursor = list.getFirst();
-    while (cursor != nullptr)
-    {
-        if (predicate(cursor->value->sn))
-        {
-            if (!cursor->value->isProcessed)
-                decreased += cursor->value->size;
-            delete list.removeAndIncrement(cursor);
-        }
-        else
-        {
-            cursor = cursor->getNext();
-        }
-    }
+    list.removeIf(predicate, [&decreased](T *item) {
+        if (!item->isProcessed)
+            decreased += item->size;
+        delete item;
+    });
 
     return decreased;
 }
 
 /**
- * Inserts the given RX PDU to the RX buffer as sorted. Comparison is performed according to given comparator.
+ * Inserts the given RX PDU to the RX buffer, sorted by SO among the PDUs with the same SN.
  * Size of the added item is returned. Note that this function always succeeds. Buffer size checking is not
  * done in this function.
  */
 template <typename T>
-inline int InsertToRxBuffer(LinkedList<T> &list, T *item, const IComparator<int> &snComparator)
+inline int InsertToRxBuffer(SnRing<T> &list, T *item)
 {
-    auto comp = [&snComparator](const T &a, const T &b) {
-        if (a.sn == b.sn)
-            return a.so - b.so;
-        return snComparator.compare(a.sn, b.sn);
-    };
-
-    InsertSortedLinkedList(list, item, ILambdaComparator<T, decltype(comp)>{comp});
+    list.insert(item);
     return item->size;
 }
 
@@ -538,17 +465,18 @@ inline int InsertToRxBuffer(LinkedList<T> &list, T *item, const IComparator<int>
  * If the given SN value is already processed, the behaviour is undefined. So don't do this.
  */
 template <typename T>
-inline int Reassemble(LinkedList<T> &list, int sn, uint8_t *buffer)
+inline int Reassemble(SnRing<T> &list, int sn, uint8_t *buffer)
 {
-    auto cursor = FirstItemWithSn(list, sn);
-    int written = 0;
+    auto slot = list.find(sn);
+    if (slot == nullptr)
+        return 0;
 
-    while (cursor != nullptr && cursor->value->sn == sn)
+    int written = 0;
+    for (auto *item : *slot)
     {
-        std::memcpy(buffer + written, cursor->value->data, cursor->value->size);
-        written += cursor->value->size;
-        cursor->value->isProcessed = true;
-        cursor = cursor->getNext();
+        std::memcpy(buffer + written, item->data, item->size);
+        written += item->size;
+        item->isProcessed = true;
     }
     return written;
 }
@@ -28,7 +28,9 @@ class IRlcEntity
     }
 
     virtual ~IRlcEntity() = default;
-    virtual void receivePdu(uint8_t *data, int size) = 0;
+
+    /* Returns false if the PDU is malformed, in which case it is discarded */
+    virtual bool receivePdu(uint8_t *data, int size) = 0;
     virtual void receiveSdu(uint8_t *data, int size, int sduId) = 0;
     virtual int createPdu(uint8_t *buffer, int maxSize) = 0;
     virtual void timerCycle(int64_t currentTime) = 0;
@@ -9,9 +9,125 @@
 #include "utils.hpp"
 #include "encoder.hpp"
 
+#include <mutex>
+#include <vector>
+
 int rlc::StatusPdu::calculatedSize(bool isShortSn) const
 {
     // TODO optimize. this is waay slow and just for POC
     uint8_t buffer[32768];
     return RlcEncoder::EncodeStatus(buffer, *this, isShortSn);
 }
+
+namespace
+{
+
+constexpr size_t SEGMENT_BLOCK_SIZE =
+    sizeof(rlc::RlcSduSegment) > sizeof(void *) ? sizeof(rlc::RlcSduSegment) : sizeof(void *);
+constexpr size_t SEGMENT_CHUNK_BLOCKS = 256;
+
+/*
+ * Chunks and free blocks left by the threads that have exited, reused by the other threads. The chunks are freed at
+ * the process exit, provided that all their blocks are free by then.
+ */
+struct SegmentDepot
+{
+    std::mutex mutex{};
+    std::vector<void *> chunks{};
+    void *freeList = nullptr;
+    size_t freeCount = 0;
+
+    ~SegmentDepot()
+    {
+        if (freeCount != chunks.size() * SEGMENT_CHUNK_BLOCKS)
+            return;
+        for (void *chunk : chunks)
+            ::operator delete(chunk);
+    }
+};
+
+SegmentDepot g_segmentDepot{};
+
+/*
+ * Free list of RLC SDU segment blocks. A block may be freed by a thread other than the one that allocated it, and so
+ * end up in the free list of any thread. Hence a thread cannot free its chunks when it exits, it hands them over to
+ * the depot together with its free blocks instead.
+ */
+struct SegmentSlab
+{
+    std::vector<void *> chunks{};
+    void *freeList = nullptr;
+    size_t freeCount = 0;
+
+    SegmentSlab() = default;
+    SegmentSlab(const SegmentSlab &) = delete;
+    SegmentSlab &operator=(const SegmentSlab &) = delete;
+
+    ~SegmentSlab()
+    {
+        std::lock_guard<std::mutex> lock{g_segmentDepot.mutex};
+        g_segmentDepot.chunks.insert(g_segmentDepot.chunks.end(), chunks.begin(), chunks.end());
+        while (freeList != nullptr)
+        {
+            void *block = freeList;
+            freeList = *static_cast<void **>(block);
+            *static_cast<void **>(block) = g_segmentDepot.freeList;
+            g_segmentDepot.freeList = block;
+        }
+        g_segmentDepot.freeCount += freeCount;
+    }
+
+    void *allocate()
+    {
+        if (freeList == nullptr)
+            refill();
+
+        void *block = freeList;
+        freeList = *static_cast<void **>(block);
+        freeCount--;
+        return block;
+    }
+
+    void release(void *block)
+    {
+        *static_cast<void **>(block) = freeList;
+        freeList = block;
+        freeCount++;
+    }
+
+  private:
+    void refill()
+    {
+        {
+            std::lock_guard<std::mutex> lock{g_segmentDepot.mutex};
+            if (g_segmentDepot.freeList != nullptr)
+            {
+                freeList = g_segmentDepot.freeList;
+                freeCount = g_segmentDepot.freeCount;
+                g_segmentDepot.freeList = nullptr;
+                g_segmentDepot.freeCount = 0;
+                return;
+            }
+        }
+
+        auto *chunk = static_cast<uint8_t *>(::operator new(SEGMENT_BLOCK_SIZE * SEGMENT_CHUNK_BLOCKS));
+        chunks.push_back(chunk);
+        for (size_t i = 0; i < SEGMENT_CHUNK_BLOCKS; i++)
+            release(chunk + i * SEGMENT_BLOCK_SIZE);
+    }
+};
+
+thread_local SegmentSlab g_segmentSlab{};
+
+} // namespace
+
+void *rlc::RlcSduSegment::operator new(size_t size)
+{
+    return g_segmentSlab.allocate();
+}
+
+void rlc::RlcSduSegment::operator delete(void *ptr)
+{
+    if (ptr != nullptr)
+        g_segmentSlab.release(ptr);
+}
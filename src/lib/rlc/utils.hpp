@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstring>
 #include <memory>
+#include <new>
 #include <vector>
 
 namespace rlc
@@ -127,16 +129,20 @@ class RlcSdu
     }
 
   public:
-    ~RlcSdu()
+    ~RlcSdu() = default;
+
+    // The data is placed right after the object, in the same allocation
+    static RlcSdu *NewFromData(uint8_t *data, int size, int sduId)
     {
-        delete[] data;
+        auto *memory = static_cast<uint8_t *>(::operator new(sizeof(RlcSdu) + static_cast<size_t>(size)));
+        auto *sdu = ::new (memory) RlcSdu(memory + sizeof(RlcSdu), size, sduId);
+        std::memcpy(sdu->data, data, size);
+        return sdu;
     }
 
-    static RlcSdu *NewFromData(uint8_t *data, int size, int sduId)
+    static void operator delete(void *ptr)
     {
-        auto *copy = new uint8_t[size];
-        std::memcpy(copy, data, size);
-        return new RlcSdu(copy, size, sduId);
+        ::operator delete(ptr);
     }
 };
 
@@ -157,6 +163,10 @@ struct RlcSduSegment
         if (--sdu->_refCount == 0)
             delete sdu;
     }
+
+    // Segments are allocated from a per-thread slab, see utils.cpp
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
 };
 
 class RlcTimer
@@ -204,42 +214,6 @@ class RlcTimer
     }
 };
 
-template <typename T>
-struct IComparator
-{
-    [[nodiscard]] virtual int compare(const T &a, const T &b) const = 0;
-};
-
-template <typename T, typename U>
-struct ILambdaComparator : IComparator<T>
-{
-    const U &u;
-
-    explicit ILambdaComparator(const U &u) : u(u)
-    {
-    }
-
-    int compare(const T &a, const T &b) const override
-    {
-        return u(a, b);
-    }
-};
-
-template <typename TComparator>
-struct ISnCompare : IComparator<int>
-{
-    const TComparator &comp;
-
-    explicit ISnCompare(const TComparator &comp) : comp(comp)
-    {
-    }
-
-    [[nodiscard]] inline int compare(const int &a, const int &b) const override
-    {
-        return comp(a, b);
-    }
-};
-
 struct MissingBlock
 {
     // Start SN and SO of the missing block
@@ -27,7 +27,8 @@ enum class ERlfCause
 {
     PDU_ID_EXISTS,
     PDU_ID_FULL,
-    SIGNAL_LOST_TO_CONNECTED_CELL
+    SIGNAL_LOST_TO_CONNECTED_CELL,
+    RLC_MAX_RETRANSMISSION,
 };
 
 } // namespace rls
\ No newline at end of file
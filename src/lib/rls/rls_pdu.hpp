@@ -39,7 +39,8 @@ enum class EPduType : uint8_t
 {
     RESERVED = 0,
     RRC,
-    DATA
+    DATA,
+    RLC, // Multiplexed RLC PDUs, see RlcBearerSet
 };
 
 struct RlsMessage // TODO: remove
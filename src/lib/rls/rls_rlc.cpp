@@ -0,0 +1,206 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "rls_rlc.hpp"
+
+#include <algorithm>
+
+static constexpr const int SUBHEADER_SIZE = 3;
+static constexpr const int MAX_PDU_SIZE = 0xFFFF;
+
+static constexpr const int TX_MAX_SIZE = 4 * 1024 * 1024;
+static constexpr const int RX_MAX_SIZE = 4 * 1024 * 1024;
+
+static constexpr const int SRB_SN_LENGTH = 12;
+static constexpr const int SRB_MAX_RETX_THRESHOLD = 8;
+
+static constexpr const int DRB_AM_SN_LENGTH = 18;
+static constexpr const int DRB_UM_SN_LENGTH = 12;
+static constexpr const int DRB_POLL_PDU = 16;
+static constexpr const int DRB_POLL_BYTE = 64 * 1024;
+static constexpr const int DRB_MAX_RETX_THRESHOLD = 32;
+
+static constexpr const int T_POLL_RETRANSMIT = 45;
+static constexpr const int T_REASSEMBLY = 35;
+static constexpr const int T_STATUS_PROHIBIT = 0;
+
+namespace rls
+{
+
+RlcBearerSet::RlcBearerSet(const RlcBearerConfig &config, SduHandler sduHandler, FailureHandler failureHandler)
+    : m_config{config}, m_sduHandler{std::move(sduHandler)}, m_failureHandler{std::move(failureHandler)},
+      m_bearers{}, m_sduIdCounter{}, m_stats{}
+{
+}
+
+RlcBearerSet::~RlcBearerSet() = default;
+
+rlc::IRlcEntity *RlcBearerSet::getOrCreateEntity(int lcid)
+{
+    auto it = std::lower_bound(m_bearers.begin(), m_bearers.end(), lcid,
+                               [](const Bearer &bearer, int value) { return bearer.lcid < value; });
+    if (it != m_bearers.end() && it->lcid == lcid)
+        return it->entity.get();
+
+    rlc::IRlcEntity *entity;
+    if (lcid == LCID_SRB1)
+        entity = rlc::NewAmEntity(this, SRB_SN_LENGTH, TX_MAX_SIZE, RX_MAX_SIZE, -1, -1, SRB_MAX_RETX_THRESHOLD,
+                                  T_POLL_RETRANSMIT, T_REASSEMBLY, T_STATUS_PROHIBIT);
+    else if (m_config.drbMode == ERlcMode::AM)
+        entity = rlc::NewAmEntity(this, DRB_AM_SN_LENGTH, TX_MAX_SIZE, RX_MAX_SIZE, DRB_POLL_PDU, DRB_POLL_BYTE,
+                                  DRB_MAX_RETX_THRESHOLD, T_POLL_RETRANSMIT, T_REASSEMBLY, T_STATUS_PROHIBIT);
+    else
+        entity = rlc::NewUmEntity(this, DRB_UM_SN_LENGTH, T_REASSEMBLY, TX_MAX_SIZE, RX_MAX_SIZE);
+
+    it = m_bearers.insert(it, Bearer{lcid, std::unique_ptr<rlc::IRlcEntity>(entity)});
+    return it->entity.get();
+}
+
+int RlcBearerSet::findLcid(rlc::IRlcEntity *entity) const
+{
+    for (auto &bearer : m_bearers)
+        if (bearer.entity.get() == entity)
+            return bearer.lcid;
+    return 0;
+}
+
+void RlcBearerSet::deliverSdu(rlc::IRlcEntity *entity, uint8_t *data, int size)
+{
+    m_stats.rxSdus++;
+    m_stats.rxSduBytes += static_cast<uint64_t>(size);
+    m_sduHandler(findLcid(entity), data, static_cast<size_t>(size));
+}
+
+void RlcBearerSet::maxRetransmissionReached(rlc::IRlcEntity *entity)
+{
+    m_failureHandler(findLcid(entity));
+}
+
+void RlcBearerSet::sduSuccessfulDelivery(rlc::IRlcEntity *entity, int sduId)
+{
+}
+
+void RlcBearerSet::pushSdu(int lcid, const uint8_t *data, size_t size)
+{
+    m_stats.txSdus++;
+    m_stats.txSduBytes += size;
+
+    // The entity copies the SDU
+    getOrCreateEntity(lcid)->receiveSdu(const_cast<uint8_t *>(data), static_cast<int>(size), ++m_sduIdCounter);
+}
+
+void RlcBearerSet::timerCycle(int64_t currentTime)
+{
+    for (auto &bearer : m_bearers)
+        bearer.entity->timerCycle(currentTime);
+}
+
+size_t RlcBearerSet::createTransmission(uint8_t *buffer, size_t capacity)
+{
+    capacity = std::min(capacity, static_cast<size_t>(m_config.opportunity));
+
+    size_t written = 0;
+    for (auto &bearer : m_bearers)
+    {
+        while (written + SUBHEADER_SIZE < capacity)
+        {
+            int maxSize = static_cast<int>(std::min(capacity - written - SUBHEADER_SIZE, size_t{MAX_PDU_SIZE}));
+            int n = bearer.entity->createPdu(buffer + written + SUBHEADER_SIZE, maxSize);
+            if (n <= 0)
+                break;
+
+            buffer[written] = static_cast<uint8_t>(bearer.lcid);
+            buffer[written + 1] = static_cast<uint8_t>(n >> 8);
+            buffer[written + 2] = static_cast<uint8_t>(n);
+            written += SUBHEADER_SIZE + static_cast<size_t>(n);
+        }
+    }
+
+    if (written > 0)
+    {
+        m_stats.txTransmissions++;
+        m_stats.txPduBytes += written;
+    }
+    return written;
+}
+
+bool RlcBearerSet::receiveTransmission(const uint8_t *data, size_t size)
+{
+    m_stats.rxTransmissions++;
+    m_stats.rxPduBytes += size;
+
+    size_t index = 0;
+    while (index < size)
+    {
+        if (index + SUBHEADER_SIZE > size)
+        {
+            m_stats.rxMalformed++;
+            return false;
+        }
+
+        int lcid = data[index];
+        size_t length = (static_cast<size_t>(data[index + 1]) << 8) | static_cast<size_t>(data[index + 2]);
+        index += SUBHEADER_SIZE;
+
+        // Other LCIDs are rejected rather than given an entity, so that a corrupt transmission cannot create entities
+        if (index + length > size || (lcid != LCID_SRB1 && (lcid <= LCID_DRB_BASE || lcid > LCID_DRB_BASE + MAX_DRB)))
+        {
+            m_stats.rxMalformed++;
+            return false;
+        }
+
+        // The entity copies the PDU content. A truncated PDU is counted, but the following PDUs are still delivered
+        // since the subheader of each PDU gives its length.
+        if (!getOrCreateEntity(lcid)->receivePdu(const_cast<uint8_t *>(data + index), static_cast<int>(length)))
+            m_stats.rxMalformed++;
+        index += length;
+    }
+    return true;
+}
+
+Json ToJson(const ERlcMode &v)
+{
+    switch (v)
+    {
+    case ERlcMode::AM:
+        return "am";
+    case ERlcMode::UM:
+        return "um";
+    default:
+        return "?";
+    }
+}
+
+Json ToJson(const RlcBearerConfig &v)
+{
+    if (!v.enabled)
+        return nullptr;
+
+    return Json::Obj({
+        {"drb-mode", ToJson(v.drbMode)},
+        {"tick-period", v.tickPeriod},
+        {"opportunity", v.opportunity},
+    });
+}
+
+Json ToJson(const RlcStatistics &v)
+{
+    return Json::Obj({
+        {"tx-sdus", static_cast<int64_t>(v.txSdus)},
+        {"tx-sdu-bytes", static_cast<int64_t>(v.txSduBytes)},
+        {"tx-pdu-bytes", static_cast<int64_t>(v.txPduBytes)},
+        {"tx-transmissions", static_cast<int64_t>(v.txTransmissions)},
+        {"rx-sdus", static_cast<int64_t>(v.rxSdus)},
+        {"rx-sdu-bytes", static_cast<int64_t>(v.rxSduBytes)},
+        {"rx-pdu-bytes", static_cast<int64_t>(v.rxPduBytes)},
+        {"rx-transmissions", static_cast<int64_t>(v.rxTransmissions)},
+        {"rx-malformed", static_cast<int64_t>(v.rxMalformed)},
+    });
+}
+
+} // namespace rls
@@ -0,0 +1,120 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <lib/rlc/rlc.hpp>
+#include <utils/json.hpp>
+
+namespace rls
+{
+
+enum class ERlcMode
+{
+    AM,
+    UM,
+};
+
+/* Optional RLC bearer layer on the radio link. Must be configured identically in the gNB and the UEs. */
+struct RlcBearerConfig
+{
+    bool enabled{};
+    ERlcMode drbMode{};
+    int tickPeriod{};  // Transmission opportunity period in milliseconds
+    int opportunity{}; // Size of a transmission opportunity in bytes
+};
+
+/*
+ * Logical channels carried in an RLC transmission. SRB1 (DCCH) always uses AM, the DRB of the PDU session with
+ * identity PSI uses the LCID (LCID_DRB_BASE + PSI) in the configured mode. CCCH and the broadcast channels are not
+ * carried by RLC.
+ */
+constexpr int LCID_SRB1 = 1;
+constexpr int LCID_DRB_BASE = 3;
+constexpr int MAX_DRB = 15; // One per PDU session identity
+
+struct RlcStatistics
+{
+    uint64_t txSdus{};
+    uint64_t txSduBytes{};
+    uint64_t txPduBytes{}; // RLC PDUs including the RLC and multiplexing headers
+    uint64_t txTransmissions{};
+    uint64_t rxSdus{};
+    uint64_t rxSduBytes{};
+    uint64_t rxPduBytes{};
+    uint64_t rxTransmissions{};
+    uint64_t rxMalformed{};
+};
+
+/*
+ * RLC entities of one UE, on one side of the radio link. In every tick, the PDUs of all bearers are multiplexed into
+ * a single transmission of at most 'opportunity' bytes, in the order of the LCIDs. Each PDU in the transmission is
+ * preceded by a 3 octet subheader containing the LCID and the PDU length.
+ */
+class RlcBearerSet : private rlc::IRlcConsumer
+{
+  public:
+    using SduHandler = std::function<void(int lcid, const uint8_t *data, size_t size)>;
+    using FailureHandler = std::function<void(int lcid)>;
+
+  private:
+    struct Bearer
+    {
+        int lcid{};
+        std::unique_ptr<rlc::IRlcEntity> entity{};
+    };
+
+    RlcBearerConfig m_config;
+    SduHandler m_sduHandler;
+    FailureHandler m_failureHandler;
+    std::vector<Bearer> m_bearers; // sorted by LCID
+    int m_sduIdCounter;
+    RlcStatistics m_stats;
+
+  public:
+    RlcBearerSet(const RlcBearerConfig &config, SduHandler sduHandler, FailureHandler failureHandler);
+    ~RlcBearerSet();
+
+    RlcBearerSet(const RlcBearerSet &) = delete;
+    RlcBearerSet &operator=(const RlcBearerSet &) = delete;
+
+  private:
+    rlc::IRlcEntity *getOrCreateEntity(int lcid);
+    int findLcid(rlc::IRlcEntity *entity) const;
+
+    void deliverSdu(rlc::IRlcEntity *entity, uint8_t *data, int size) override;
+    void maxRetransmissionReached(rlc::IRlcEntity *entity) override;
+    void sduSuccessfulDelivery(rlc::IRlcEntity *entity, int sduId) override;
+
+  public:
+    void pushSdu(int lcid, const uint8_t *data, size_t size);
+    void timerCycle(int64_t currentTime);
+
+    /* Fills a transmission opportunity, returns the number of bytes written, or 0 if there is nothing to send */
+    size_t createTransmission(uint8_t *buffer, size_t capacity);
+
+    /* Returns false if the transmission is malformed. The remaining PDUs are discarded in that case. */
+    bool receiveTransmission(const uint8_t *data, size_t size);
+
+    [[nodiscard]] const RlcStatistics &statistics() const
+    {
+        return m_stats;
+    }
+};
+
+Json ToJson(const ERlcMode &v);
+Json ToJson(const RlcBearerConfig &v);
+Json ToJson(const RlcStatistics &v);
+
+} // namespace rls
@@ -9,12 +9,14 @@
 #include "client.hpp"
 #include "internal.hpp"
 
-sctp::SctpClient::SctpClient(PayloadProtocolId ppid) : sd(CreateSocket()), ppid(ppid)
+sctp::SctpClient::SctpClient(PayloadProtocolId ppid, const SocketOptions &options) : sd(CreateSocket()), ppid(ppid)
 {
     try
     {
-        SetInitOptions(sd, 10, 10, 10, 10 * 1000);
+        SetInitOptions(sd, options.inStreams, options.outStreams, 10, 10 * 1000);
         SetEventOptions(sd);
+        SetNoDelay(sd, options.noDelay);
+        SetBufferSizes(sd, options.sendBufferSize, options.receiveBufferSize);
     }
     catch (const std::exception &e)
     {
@@ -23,6 +25,10 @@ sctp::SctpClient::SctpClient(PayloadProtocolId ppid) : sd(CreateSocket()), ppid(
     }
 }
 
+sctp::SctpClient::SctpClient(int sd, PayloadProtocolId ppid) : sd(sd), ppid(ppid)
+{
+}
+
 sctp::SctpClient::~SctpClient()
 {
     CloseSocket(sd);
@@ -53,6 +59,26 @@ void sctp::SctpClient::receive(ISctpHandler *handler)
     ReceiveMessage(sd, static_cast<uint32_t>(ppid), handler);
 }
 
+int sctp::SctpClient::getFd() const
+{
+    return sd;
+}
+
+void sctp::SctpClient::setNonBlocking()
+{
+    SetNonBlocking(sd);
+}
+
+bool sctp::SctpClient::trySend(uint16_t stream, const uint8_t *buffer, size_t length, bool more)
+{
+    return TrySendMessage(sd, buffer, length, (int)ppid, stream, more);
+}
+
+sctp::ReceiveResult sctp::SctpClient::tryReceive(ISctpHandler *handler, uint8_t *buffer, size_t capacity)
+{
+    return TryReceiveMessage(sd, static_cast<uint32_t>(ppid), handler, buffer, capacity);
+}
+
 void sctp::SctpClient::bind(const std::string &address, uint16_t port)
 {
     BindSocket(sd, address, port);
@@ -23,7 +23,9 @@ class SctpClient
     const PayloadProtocolId ppid;
 
   public:
-    explicit SctpClient(PayloadProtocolId ppid);
+    explicit SctpClient(PayloadProtocolId ppid, const SocketOptions &options = {});
+    /* Takes the ownership of an already established association, e.g. one accepted by a server */
+    SctpClient(int sd, PayloadProtocolId ppid);
     ~SctpClient();
 
     void bind(const std::string &address, uint16_t port);
@@ -34,6 +36,13 @@ class SctpClient
     void send(uint16_t stream, const std::vector<uint8_t> &data);
 
     void receive(ISctpHandler *handler);
+
+    /* Non-blocking I/O, for the clients served by an event loop */
+    [[nodiscard]] int getFd() const;
+    void setNonBlocking();
+    /* Returns false if the message could not be sent without blocking. 'more' hints that another message follows. */
+    bool trySend(uint16_t stream, const uint8_t *buffer, size_t length, bool more);
+    ReceiveResult tryReceive(ISctpHandler *handler, uint8_t *buffer, size_t capacity);
 };
 
 } // namespace sctp
\ No newline at end of file
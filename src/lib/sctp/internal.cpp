@@ -12,6 +12,7 @@
 #include <cstring>
 
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/sctp.h>
@@ -104,6 +105,22 @@ void SetEventOptions(int sd)
         ThrowError("SCTP SCTP_EVENTS option failed");
 }
 
+void SetNoDelay(int sd, bool noDelay)
+{
+    int value = noDelay ? 1 : 0;
+    if (setsockopt(sd, IPPROTO_SCTP, SCTP_NODELAY, &value, (socklen_t)sizeof(value)) < 0)
+        ThrowError("SCTP SCTP_NODELAY option failed");
+}
+
+void SetBufferSizes(int sd, int sendBufferSize, int receiveBufferSize)
+{
+    if (sendBufferSize > 0 && setsockopt(sd, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, (socklen_t)sizeof(int)) < 0)
+        ThrowError("SCTP SO_SNDBUF option failed");
+    if (receiveBufferSize > 0 &&
+        setsockopt(sd, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, (socklen_t)sizeof(int)) < 0)
+        ThrowError("SCTP SO_RCVBUF option failed");
+}
+
 void StartListening(int sd)
 {
     if (listen(sd, 10))
@@ -115,14 +132,19 @@ void CloseSocket(int sd)
     close(sd);
 }
 
-void Accept(int sd)
+int Accept(int sd)
 {
-    sockaddr saddr{};
-    socklen_t saddr_size{};
+    sockaddr_storage saddr{};
+    auto saddr_size = (socklen_t)sizeof(sockaddr_storage);
 
-    int clientSd = accept(sd, &saddr, &saddr_size);
+    int clientSd = accept(sd, (sockaddr *)&saddr, &saddr_size);
     if (clientSd < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return -1;
         ThrowError("SCTP accept failure: ", errno);
+    }
+    return clientSd;
 }
 
 void Connect(int sd, const std::string &address, uint16_t port)
@@ -158,15 +180,61 @@ void Connect(int sd, const std::string &address, uint16_t port)
         ThrowError("SCTP could not connect: ", errno);
 }
 
+void SetNonBlocking(int sd)
+{
+    int flags = fcntl(sd, F_GETFL, 0);
+    if (flags < 0 || fcntl(sd, F_SETFL, flags | O_NONBLOCK) < 0)
+        ThrowError("SCTP socket could not be set non-blocking: ", errno);
+}
+
 void SendMessage(int sd, const uint8_t *buffer, size_t length, int ppid, uint16_t stream)
 {
     if (sctp_sendmsg(sd, buffer, length, nullptr, 0, htonl(ppid), 0, stream, 0, 0) < 0)
         ThrowError("SCTP send message failure: ", errno);
 }
 
+bool TrySendMessage(int sd, const uint8_t *buffer, size_t length, int ppid, uint16_t stream, bool more)
+{
+    // sctp_sendmsg() does not accept the send flags, hence the SCTP header information is given as a control message.
+    // MSG_MORE lets the kernel bundle the message with the following ones into the same packet.
+    char control[CMSG_SPACE(sizeof(sctp_sndrcvinfo))] = {};
+
+    iovec iov{};
+    iov.iov_base = const_cast<uint8_t *>(buffer);
+    iov.iov_len = length;
+
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = IPPROTO_SCTP;
+    cmsg->cmsg_type = SCTP_SNDRCV;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
+
+    auto *info = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsg));
+    info->sinfo_stream = stream;
+    info->sinfo_ppid = htonl(ppid);
+
+    if (sendmsg(sd, &msg, more ? MSG_MORE : 0) < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return false;
+        ThrowError("SCTP send message failure: ", errno);
+    }
+    return true;
+}
+
 void ReceiveMessage(int sd, uint32_t ppid, ISctpHandler *handler)
 {
     uint8_t buffer[RECEIVE_BUFFER_SIZE];
+    TryReceiveMessage(sd, ppid, handler, buffer, RECEIVE_BUFFER_SIZE);
+}
+
+ReceiveResult TryReceiveMessage(int sd, uint32_t ppid, ISctpHandler *handler, uint8_t *buffer, size_t capacity)
+{
     sockaddr_in addr{};
     sctp_sndrcvinfo info{};
     int flags = 0;
@@ -176,21 +244,23 @@ void ReceiveMessage(int sd, uint32_t ppid, ISctpHandler *handler)
     std::memset((void *)&addr, 0, sizeof(sockaddr_in));
     std::memset((void *)&info, 0, sizeof(sctp_sndrcvinfo));
 
-    int r = sctp_recvmsg(sd, (void *)buffer, RECEIVE_BUFFER_SIZE, (sockaddr *)&addr, &fromLen, &info, &flags);
+    int r = sctp_recvmsg(sd, (void *)buffer, capacity, (sockaddr *)&addr, &fromLen, &info, &flags);
 
     if (r < 0)
     {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return ReceiveResult::WOULD_BLOCK;
         if (errno == ECONNRESET)
         {
             if (handler)
                 handler->onConnectionReset();
-            return;
+            return ReceiveResult::CLOSED;
         }
         ThrowError("SCTP receive message failure: ", errno);
     }
 
     if (r == 0)
-        return; // no data
+        return ReceiveResult::CLOSED; // no data, the peer has closed the association
 
     if (!(flags & MSG_EOR))
         ThrowError("SCTP partial message received, which is not handled");
@@ -249,6 +319,8 @@ void ReceiveMessage(int sd, uint32_t ppid, ISctpHandler *handler)
 
         handler->onMessage(buffer, r, info.sinfo_stream);
     }
+
+    return ReceiveResult::RECEIVED;
 }
 
 } // namespace sctp
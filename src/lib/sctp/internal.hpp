@@ -19,11 +19,16 @@ int CreateSocket();
 void BindSocket(int sd, const std::string &address, uint16_t port);
 void SetInitOptions(int sd, int maxRxStreams, int maxTxStreams, int maxAttempts, int initTimeoutMs);
 void SetEventOptions(int sd);
+void SetNoDelay(int sd, bool noDelay);
+void SetBufferSizes(int sd, int sendBufferSize, int receiveBufferSize);
 void StartListening(int sd);
 void CloseSocket(int sd);
-void Accept(int sd);
+int Accept(int sd);
 void Connect(int sd, const std::string &address, uint16_t port);
+void SetNonBlocking(int sd);
 void SendMessage(int sd, const uint8_t *buffer, size_t length, int ppid, uint16_t stream);
+bool TrySendMessage(int sd, const uint8_t *buffer, size_t length, int ppid, uint16_t stream, bool more);
 void ReceiveMessage(int sd, uint32_t ppid, ISctpHandler *handler);
+ReceiveResult TryReceiveMessage(int sd, uint32_t ppid, ISctpHandler *handler, uint8_t *buffer, size_t capacity);
 
 } // namespace sctp
\ No newline at end of file
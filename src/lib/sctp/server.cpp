@@ -9,14 +9,18 @@
 #include "server.hpp"
 #include "internal.hpp"
 
-sctp::SctpServer::SctpServer(const std::string &address, uint16_t port) : sd(0)
+sctp::SctpServer::SctpServer(const std::string &address, uint16_t port, PayloadProtocolId ppid,
+                             const SocketOptions &options)
+    : sd(0), ppid(ppid)
 {
     try
     {
         sd = CreateSocket();
         BindSocket(sd, address, port);
-        SetInitOptions(sd, 10, 10, 10, 10 * 1000);
+        SetInitOptions(sd, options.inStreams, options.outStreams, 10, 10 * 1000);
         SetEventOptions(sd);
+        SetNoDelay(sd, options.noDelay);
+        SetBufferSizes(sd, options.sendBufferSize, options.receiveBufferSize);
         StartListening(sd);
     }
     catch (const SctpError &e)
@@ -31,7 +35,20 @@ sctp::SctpServer::~SctpServer()
     CloseSocket(sd);
 }
 
-void sctp::SctpServer::start()
+int sctp::SctpServer::getFd() const
 {
-    Accept(sd);
+    return sd;
+}
+
+void sctp::SctpServer::setNonBlocking()
+{
+    SetNonBlocking(sd);
+}
+
+std::unique_ptr<sctp::SctpClient> sctp::SctpServer::accept()
+{
+    int clientSd = Accept(sd);
+    if (clientSd < 0)
+        return nullptr;
+    return std::make_unique<SctpClient>(clientSd, ppid);
 }
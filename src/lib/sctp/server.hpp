@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include "client.hpp"
+#include "types.hpp"
+
+#include <memory>
 #include <string>
 
 namespace sctp
@@ -17,14 +21,18 @@ class SctpServer
 {
   private:
     int sd;
+    const PayloadProtocolId ppid;
 
   public:
-    SctpServer(const std::string &address, uint16_t port);
+    SctpServer(const std::string &address, uint16_t port, PayloadProtocolId ppid, const SocketOptions &options = {});
     ~SctpServer();
 
-    void start();
-
-    // TODO: Other functionalities
+    /* Non-blocking I/O, for the servers driven by an event loop */
+    [[nodiscard]] int getFd() const;
+    void setNonBlocking();
+    /* Returns the next accepted association, or null if there is none pending on a non-blocking socket. The accepted
+     * socket inherits the options of the listening one. */
+    std::unique_ptr<SctpClient> accept();
 };
 
 } // namespace sctp
\ No newline at end of file
@@ -33,6 +33,24 @@ class SctpError : public std::runtime_error
     }
 };
 
+/* Options of a client socket, applied before the association is established */
+struct SocketOptions
+{
+    int inStreams = 10;        // Maximum number of inbound streams requested in INIT
+    int outStreams = 10;       // Number of outbound streams requested in INIT
+    bool noDelay = false;      // Disables the Nagle-like bundling delay of the SCTP stack
+    int sendBufferSize = 0;    // SO_SNDBUF in bytes, 0 keeps the system default
+    int receiveBufferSize = 0; // SO_RCVBUF in bytes, 0 keeps the system default
+};
+
+/* Result of a receive attempt on a non-blocking socket */
+enum class ReceiveResult
+{
+    RECEIVED,
+    WOULD_BLOCK,
+    CLOSED,
+};
+
 class ISctpHandler
 {
   public:
@@ -0,0 +1,359 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <unistd.h>
+
+#include <utils/common.hpp>
+#include <utils/libc_error.hpp>
+
+static constexpr const int FLUSH_PERIOD_MS = 100;
+
+static constexpr const int SUB_BUCKETS = 8; // Per power of two, i.e. at most 12.5% error in the percentiles
+static constexpr const int BUCKET_COUNT = 40 * SUB_BUCKETS;
+
+static constexpr const char *PROCEDURE_NAMES[] = {
+    "Registration",          "Mobility Registration", "Service Request", "PDU Session Establishment",
+    "Initial Context Setup", "AMF Response",
+};
+static constexpr const int PROCEDURE_COUNT = static_cast<int>(trace::EProcedure::COUNT);
+
+static constexpr const int64_t DISTRIBUTION_LIMITS[] = {1000, 10000, 100000, 1000000, 10000000}; // Microseconds
+static constexpr const char *DISTRIBUTION_NAMES[] = {"<1ms", "1ms-10ms", "10ms-100ms", "100ms-1s", "1s-10s", ">=10s"};
+static constexpr const int DISTRIBUTION_COUNT = 6;
+
+static_assert(sizeof(PROCEDURE_NAMES) / sizeof(PROCEDURE_NAMES[0]) == PROCEDURE_COUNT);
+
+namespace
+{
+
+/* Log-linear histogram of latencies in microseconds */
+struct Histogram
+{
+    std::array<int64_t, BUCKET_COUNT> buckets{};
+    std::array<int64_t, DISTRIBUTION_COUNT> distribution{};
+    int64_t count{};
+    int64_t failed{};
+    int64_t superseded{};
+    int64_t sum{};
+    int64_t min{};
+    int64_t max{};
+
+    static int BucketOf(int64_t value)
+    {
+        if (value < SUB_BUCKETS)
+            return static_cast<int>(value);
+        int exponent = 63 - __builtin_clzll(static_cast<uint64_t>(value)); // >= 3
+        int sub = static_cast<int>(value >> (exponent - 3)) & (SUB_BUCKETS - 1);
+        return std::min((exponent - 2) * SUB_BUCKETS + sub, BUCKET_COUNT - 1);
+    }
+
+    static int64_t LowerBoundOf(int bucket)
+    {
+        if (bucket < SUB_BUCKETS)
+            return bucket;
+        int exponent = bucket / SUB_BUCKETS + 2;
+        return static_cast<int64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - 3);
+    }
+
+    void record(int64_t value)
+    {
+        value = std::max<int64_t>(value, 0);
+        buckets[BucketOf(value)]++;
+
+        int d = 0;
+        while (d < DISTRIBUTION_COUNT - 1 && value >= DISTRIBUTION_LIMITS[d])
+            d++;
+        distribution[d]++;
+
+        min = count == 0 ? value : std::min(min, value);
+        max = std::max(max, value);
+        sum += value;
+        count++;
+    }
+
+    /* Midpoint of the bucket holding the given percentile, clamped to the observed range */
+    int64_t percentile(int percent) const
+    {
+        int64_t rank = (count * percent + 99) / 100;
+        int64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++)
+        {
+            seen += buckets[i];
+            if (seen >= rank && buckets[i] != 0)
+            {
+                int64_t mid = (LowerBoundOf(i) + (i + 1 < BUCKET_COUNT ? LowerBoundOf(i + 1) : max + 1)) / 2;
+                return std::clamp(mid, min, max);
+            }
+        }
+        return max;
+    }
+
+    Json toJson() const
+    {
+        Json distributionJson = Json::Obj({});
+        for (int i = 0; i < DISTRIBUTION_COUNT; i++)
+            distributionJson.put(DISTRIBUTION_NAMES[i], distribution[i]);
+
+        return Json::Obj({
+            {"count", count},
+            {"failed", failed},
+            {"superseded", superseded},
+            {"min-us", min},
+            {"mean-us", count == 0 ? 0 : sum / count},
+            {"p50-us", percentile(50)},
+            {"p90-us", percentile(90)},
+            {"p99-us", percentile(99)},
+            {"max-us", max},
+            {"distribution", distributionJson},
+        });
+    }
+};
+
+struct Tracer
+{
+    std::mutex mutex{};
+    FILE *file{};
+    int pid{};
+    std::string pending{}; // Events waiting to be written
+    std::unordered_map<uint64_t, int64_t> startTimes{};
+    std::unordered_set<int> namedUes{};
+    std::unordered_map<int, uint64_t> stis{};
+    std::array<Histogram, PROCEDURE_COUNT> histograms{};
+};
+
+Tracer *g_tracer = nullptr;
+
+int64_t NowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+uint64_t KeyOf(trace::EProcedure procedure, int ueId, int instance)
+{
+    return (static_cast<uint64_t>(procedure) << 56) | (static_cast<uint64_t>(instance & 0xFFFFFF) << 32) |
+           static_cast<uint32_t>(ueId);
+}
+
+/* Names the track of the UE on its first event, must be called with the mutex held */
+void NameUe(int ueId)
+{
+    if (!g_tracer->namedUes.insert(ueId).second)
+        return;
+
+    char event[160];
+    std::snprintf(event, sizeof(event),
+                  R"({"name":"thread_name","ph":"M","pid":%d,"tid":%d,"args":{"name":"UE[%d]"}},)"
+                  "\n",
+                  g_tracer->pid, ueId, ueId);
+    g_tracer->pending += event;
+}
+
+/*
+ * Closes an event with its arguments. The RLS STI of the UE is given in every event, since it is the only identifier
+ * known to both the UE and the gNB. Must be called with the mutex held.
+ */
+void AppendArgs(int ueId, const char *key, const char *value)
+{
+    char args[160];
+    int n = std::snprintf(args, sizeof(args), R"(,"args":{)");
+
+    auto it = g_tracer->stis.find(ueId);
+    if (it != g_tracer->stis.end())
+        n += std::snprintf(args + n, sizeof(args) - n, R"("sti":"%016)" PRIX64 R"(")", it->second);
+    if (value != nullptr)
+        std::snprintf(args + n, sizeof(args) - n, R"(%s"%s":"%s")", it != g_tracer->stis.end() ? "," : "", key, value);
+
+    g_tracer->pending += args;
+    g_tracer->pending += "}},\n";
+}
+
+/* Async events of the procedures, scoped to the process so that the files of several processes can be merged */
+void AppendAsync(char phase, trace::EProcedure procedure, int ueId, int instance, int64_t time, const char *result)
+{
+    char event[256];
+    std::snprintf(event, sizeof(event),
+                  R"({"name":"%s","cat":"procedure","ph":"%c","id2":{"local":"0x%x"},"pid":%d,"tid":%d,"ts":%)" PRId64,
+                  PROCEDURE_NAMES[static_cast<int>(procedure)], phase,
+                  static_cast<unsigned>(ueId) * 16u + static_cast<unsigned>(instance & 15), g_tracer->pid, ueId, time);
+    g_tracer->pending += event;
+    AppendArgs(ueId, "result", result);
+}
+
+/* Must be called with the mutex held */
+void EndStarted(std::unordered_map<uint64_t, int64_t>::iterator it, int64_t time, bool success)
+{
+    auto procedure = static_cast<trace::EProcedure>(it->first >> 56);
+    auto ueId = static_cast<int>(static_cast<uint32_t>(it->first));
+    auto instance = static_cast<int>((it->first >> 32) & 0xFFFFFF);
+
+    auto &histogram = g_tracer->histograms[static_cast<int>(procedure)];
+    if (success)
+        histogram.record(time - it->second);
+    else
+        histogram.failed++;
+    g_tracer->startTimes.erase(it);
+
+    AppendAsync('e', procedure, ueId, instance, time, success ? "success" : "failure");
+}
+
+[[noreturn]] void RunWriter()
+{
+    std::string buffer{};
+    while (true)
+    {
+        utils::Sleep(FLUSH_PERIOD_MS);
+        {
+            std::lock_guard<std::mutex> lock(g_tracer->mutex);
+            std::swap(buffer, g_tracer->pending);
+        }
+        if (buffer.empty())
+            continue;
+
+        // The closing bracket of the array is optional in the trace-event format, so the file is always readable
+        std::fwrite(buffer.data(), 1, buffer.size(), g_tracer->file);
+        std::fflush(g_tracer->file);
+        buffer.clear();
+    }
+}
+
+} // namespace
+
+namespace trace
+{
+
+namespace detail
+{
+
+std::atomic<bool> g_enabled{};
+
+void Begin(EProcedure procedure, int ueId, int instance)
+{
+    int64_t time = NowMicros();
+
+    std::lock_guard<std::mutex> lock(g_tracer->mutex);
+    NameUe(ueId);
+
+    auto it = g_tracer->startTimes.find(KeyOf(procedure, ueId, instance));
+    if (it != g_tracer->startTimes.end())
+    {
+        g_tracer->histograms[static_cast<int>(procedure)].superseded++;
+        AppendAsync('e', procedure, ueId, instance, time, "superseded");
+        it->second = time;
+    }
+    else
+    {
+        g_tracer->startTimes[KeyOf(procedure, ueId, instance)] = time;
+    }
+    AppendAsync('b', procedure, ueId, instance, time, nullptr);
+}
+
+void End(EProcedure procedure, int ueId, int instance, bool success)
+{
+    int64_t time = NowMicros();
+
+    std::lock_guard<std::mutex> lock(g_tracer->mutex);
+    auto it = g_tracer->startTimes.find(KeyOf(procedure, ueId, instance));
+    if (it != g_tracer->startTimes.end())
+        EndStarted(it, time, success);
+}
+
+void Abort(int ueId)
+{
+    int64_t time = NowMicros();
+
+    std::lock_guard<std::mutex> lock(g_tracer->mutex);
+    for (auto it = g_tracer->startTimes.begin(); it != g_tracer->startTimes.end();)
+    {
+        auto next = std::next(it);
+        if (static_cast<int>(static_cast<uint32_t>(it->first)) == ueId)
+            EndStarted(it, time, false);
+        it = next;
+    }
+}
+
+void Discard(EProcedure procedure, int ueId, int instance)
+{
+    int64_t time = NowMicros();
+
+    std::lock_guard<std::mutex> lock(g_tracer->mutex);
+    if (g_tracer->startTimes.erase(KeyOf(procedure, ueId, instance)) != 0)
+        AppendAsync('e', procedure, ueId, instance, time, "discarded");
+}
+
+void Hop(const char *name, int ueId, const char *message)
+{
+    int64_t time = NowMicros();
+
+    char event[192];
+    std::snprintf(event, sizeof(event),
+                  R"({"name":"%s","cat":"hop","ph":"i","s":"t","pid":%d,"tid":%d,"ts":%)" PRId64, name,
+                  g_tracer->pid, ueId, time);
+
+    std::lock_guard<std::mutex> lock(g_tracer->mutex);
+    NameUe(ueId);
+    g_tracer->pending += event;
+    AppendArgs(ueId, "message", message);
+}
+
+void SetSti(int ueId, uint64_t sti)
+{
+    std::lock_guard<std::mutex> lock(g_tracer->mutex);
+    g_tracer->stis[ueId] = sti;
+}
+
+} // namespace detail
+
+void Start(const std::string &file, const std::string &processName)
+{
+    FILE *f = std::fopen(file.c_str(), "w");
+    if (f == nullptr)
+        throw LibError("Trace file '" + file + "' could not be created:", errno);
+
+    g_tracer = new Tracer();
+    g_tracer->file = f;
+    g_tracer->pid = static_cast<int>(getpid());
+    g_tracer->pending = "[\n";
+    g_tracer->pending += R"({"name":"process_name","ph":"M","pid":)" + std::to_string(g_tracer->pid) +
+                         R"(,"args":{"name":)" + Json{processName}.dumpJson() + "}},\n";
+
+    std::thread{RunWriter}.detach();
+    detail::g_enabled.store(true, std::memory_order_release);
+}
+
+Json Statistics()
+{
+    std::array<Histogram, PROCEDURE_COUNT> histograms{};
+    {
+        std::lock_guard<std::mutex> lock(g_tracer->mutex);
+        histograms = g_tracer->histograms;
+    }
+
+    Json json = Json::Obj({});
+    for (int i = 0; i < PROCEDURE_COUNT; i++)
+    {
+        auto &h = histograms[i];
+        if (h.count != 0 || h.failed != 0 || h.superseded != 0)
+            json.put(PROCEDURE_NAMES[i], h.toJson());
+    }
+    return json;
+}
+
+} // namespace trace
@@ -0,0 +1,116 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <utils/json.hpp>
+
+namespace trace
+{
+
+enum class EProcedure
+{
+    // UE
+    REGISTRATION = 0,
+    MOBILITY_REGISTRATION,
+    SERVICE_REQUEST,
+    PDU_SESSION_ESTABLISHMENT,
+
+    // gNB
+    INITIAL_CONTEXT_SETUP, // From the Initial UE Message to the Initial Context Setup Request
+    AMF_RESPONSE,          // From an uplink NAS message to the next downlink NAS message of the UE
+
+    COUNT
+};
+
+/*
+ * Starts the tracing of the process into a Chrome trace-event file, which can be opened in Perfetto or in
+ * chrome://tracing. Must be called before the tasks are started. The events of each UE are put on a track of their
+ * own, named after the UE ID, and timestamped with the wall clock, so that the files of the UE and gNB processes can
+ * be viewed side by side.
+ */
+void Start(const std::string &file, const std::string &processName);
+
+/* Latency histograms of the procedures completed so far */
+Json Statistics();
+
+namespace detail
+{
+
+extern std::atomic<bool> g_enabled;
+
+void Begin(EProcedure procedure, int ueId, int instance);
+void End(EProcedure procedure, int ueId, int instance, bool success);
+void Discard(EProcedure procedure, int ueId, int instance);
+void Abort(int ueId);
+void Hop(const char *name, int ueId, const char *message);
+void SetSti(int ueId, uint64_t sti);
+
+} // namespace detail
+
+/* A relaxed load and a branch, so that the probes can be left in the hot paths */
+inline bool IsEnabled()
+{
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+/*
+ * Starts a procedure of a UE. A procedure that is started again before its end, e.g. after a timer expiry, is closed
+ * as superseded and is not counted in the histograms. The instance tells apart the concurrent procedures of the same
+ * UE, e.g. the PDU session ID.
+ */
+inline void Begin(EProcedure procedure, int ueId, int instance = 0)
+{
+    if (IsEnabled())
+        detail::Begin(procedure, ueId, instance);
+}
+
+/* Ends a started procedure and records its latency, ignored if the procedure was not started */
+inline void End(EProcedure procedure, int ueId, bool success, int instance = 0)
+{
+    if (IsEnabled())
+        detail::End(procedure, ueId, instance, success);
+}
+
+/* Forgets a started procedure without recording it, e.g. when the context of the UE is deleted */
+inline void Discard(EProcedure procedure, int ueId, int instance = 0)
+{
+    if (IsEnabled())
+        detail::Discard(procedure, ueId, instance);
+}
+
+/* Ends all the started procedures of a UE as failed, e.g. when they are aborted by a release or a switch-off */
+inline void Abort(int ueId)
+{
+    if (IsEnabled())
+        detail::Abort(ueId);
+}
+
+/* Marks a message crossing a layer of the UE, e.g. "NAS UL" with the name of the NAS message */
+inline void Hop(const char *name, int ueId, const char *message = nullptr)
+{
+    if (IsEnabled())
+        detail::Hop(name, ueId, message);
+}
+
+/*
+ * Gives the RLS STI of a UE, which is put in the arguments of its later events. The UE IDs of the UE and gNB processes
+ * are independent, so the STI is what matches the events of a UE across their files, e.g. the "RRC UL" hops of both
+ * sides, whose gap is the time spent in RLS.
+ */
+inline void SetSti(int ueId, uint64_t sti)
+{
+    if (IsEnabled())
+        detail::SetSti(ueId, sti);
+}
+
+} // namespace trace
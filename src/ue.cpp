@@ -6,19 +6,27 @@
 // and subject to the terms and conditions defined in LICENSE file.
 //
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <thread>
 
 #include <unistd.h>
 
 #include <lib/app/base_app.hpp>
 #include <lib/app/cli_base.hpp>
 #include <lib/app/cli_cmd.hpp>
+#include <lib/capture/capture.hpp>
+#include <lib/trace/trace.hpp>
+#include <ue/bulk_cmd.hpp>
 #include <ue/task.hpp>
 #include <ue/types.hpp>
+#include <ue/worker.hpp>
+#include <utils/clock.hpp>
 #include <utils/common.hpp>
 #include <utils/constants.hpp>
+#include <utils/io.hpp>
 #include <utils/options.hpp>
 #include <utils/yaml_utils.hpp>
 #include <yaml-cpp/yaml.h>
@@ -30,8 +38,12 @@ static struct Options
     std::string configFile{};
     bool noRoutingConfigs{};
     bool disableCmd{};
+    bool virtualTime{};
     std::string imsi{};
     int count{};
+    int uesPerThread{};
+    std::optional<std::string> contextDir{};
+    std::optional<std::string> traceFile{};
 } g_options{};
 
 static nr::ue::UeConfig *ReadConfigYaml()
@@ -81,6 +93,7 @@ static nr::ue::UeConfig *ReadConfigYaml()
     result->prefixLogger = g_options.count > 1;
 
     result->disableCmd = g_options.disableCmd;
+    result->contextDir = g_options.contextDir;
 
     if (yaml::HasField(config, "supi"))
         result->supi = Supi::Parse(yaml::GetString(config, "supi"));
@@ -172,6 +185,55 @@ static nr::ue::UeConfig *ReadConfigYaml()
         result->uacAcc.cls15 = yaml::GetBool(config["uacAcc"], "class15");
     }
 
+    if (yaml::HasField(config, "rlc"))
+    {
+        auto rlc = config["rlc"];
+        result->rlc.enabled = true;
+
+        std::string mode = yaml::GetString(rlc, "mode");
+        if (mode == "am")
+            result->rlc.drbMode = rls::ERlcMode::AM;
+        else if (mode == "um")
+            result->rlc.drbMode = rls::ERlcMode::UM;
+        else
+            throw std::runtime_error("Invalid RLC mode: " + mode);
+
+        result->rlc.tickPeriod = yaml::GetInt32(rlc, "tickPeriod", 1, 100);
+        result->rlc.opportunity = yaml::GetInt32(rlc, "opportunity", 256, 16000);
+    }
+
+    if (yaml::HasField(config, "capture"))
+    {
+        auto cap = config["capture"];
+        result->capture.enabled = true;
+        result->capture.directory = yaml::GetString(cap, "directory", 1, 1024);
+
+        for (auto &itf : yaml::GetSequence(cap, "interfaces"))
+        {
+            capture::EInterface value{};
+            if (!capture::ParseInterface(itf.as<std::string>(), value))
+                throw std::runtime_error("Invalid capture interface: " + itf.as<std::string>());
+            result->capture.interfaces |= 1u << static_cast<int>(value);
+        }
+
+        result->capture.snapLength = 1600;
+        if (yaml::HasField(cap, "snapLength"))
+            result->capture.snapLength = yaml::GetInt32(cap, "snapLength", 64, 9000);
+        result->capture.fileSize = 64ll * 1024 * 1024;
+        if (yaml::HasField(cap, "fileSizeMb"))
+            result->capture.fileSize = yaml::GetInt32(cap, "fileSizeMb", 1, 4096) * 1024ll * 1024;
+        result->capture.fileCount = 8;
+        if (yaml::HasField(cap, "fileCount"))
+            result->capture.fileCount = yaml::GetInt32(cap, "fileCount", 1, 1000);
+
+        if (yaml::HasField(cap, "filter"))
+        {
+            std::string error{};
+            if (!capture::ParseFilter(yaml::GetString(cap, "filter"), result->capture.filter, error))
+                throw std::runtime_error("Invalid capture filter: " + error);
+        }
+    }
+
     return result;
 }
 
@@ -189,12 +251,26 @@ static void ReadOptions(int argc, char **argv)
                                       std::nullopt};
     opt::OptionItem itemDisableRouting = {'r', "no-routing-config",
                                           "Do not auto configure routing for UE TUN interface", std::nullopt};
+    opt::OptionItem itemVirtualTime = {std::nullopt, "virtual-time",
+                                       "Fast-forward the timers while all nodes are idle, for long-running load tests",
+                                       std::nullopt};
+    opt::OptionItem itemUesPerThread = {std::nullopt, "ues-per-thread",
+                                        "Number of UEs running on each thread, default is 64", "num"};
+    opt::OptionItem itemContextDir = {std::nullopt, "context-dir",
+                                      "Persist the security contexts of the UEs in given directory for warm restarts",
+                                      "dir"};
+    opt::OptionItem itemTrace = {std::nullopt, "trace",
+                                 "Trace the procedures of the UEs into given Chrome trace-event file", "file"};
 
     desc.items.push_back(itemConfigFile);
     desc.items.push_back(itemImsi);
     desc.items.push_back(itemCount);
     desc.items.push_back(itemDisableCmd);
     desc.items.push_back(itemDisableRouting);
+    desc.items.push_back(itemVirtualTime);
+    desc.items.push_back(itemUesPerThread);
+    desc.items.push_back(itemContextDir);
+    desc.items.push_back(itemTrace);
 
     opt::OptionsResult opt{argc, argv, desc, false, nullptr};
 
@@ -227,6 +303,26 @@ static void ReadOptions(int argc, char **argv)
     }
 
     g_options.disableCmd = opt.hasFlag(itemDisableCmd);
+    g_options.virtualTime = opt.hasFlag(itemVirtualTime);
+
+    g_options.uesPerThread = 64;
+    if (opt.hasFlag(itemUesPerThread))
+    {
+        g_options.uesPerThread = utils::ParseInt(opt.getOption(itemUesPerThread));
+        if (g_options.uesPerThread <= 0)
+            throw std::runtime_error("Invalid number of UEs per thread");
+    }
+
+    g_options.contextDir = std::nullopt;
+    if (opt.hasFlag(itemContextDir))
+    {
+        g_options.contextDir = opt.getOption(itemContextDir);
+        io::CreateDirectory(*g_options.contextDir);
+    }
+
+    g_options.traceFile = std::nullopt;
+    if (opt.hasFlag(itemTrace))
+        g_options.traceFile = opt.getOption(itemTrace);
 }
 
 static std::string LargeSum(std::string a, std::string b)
@@ -283,9 +379,12 @@ static std::unique_ptr<nr::ue::UeConfig> GetConfigByUe(int ueIndex)
     c->configureRouting = g_refConfig->configureRouting;
     c->prefixLogger = g_refConfig->prefixLogger;
     c->disableCmd = g_refConfig->disableCmd;
+    c->contextDir = g_refConfig->contextDir;
     c->integrityMaxRate = g_refConfig->integrityMaxRate;
     c->uacAic = g_refConfig->uacAic;
     c->uacAcc = g_refConfig->uacAcc;
+    c->rlc = g_refConfig->rlc;
+    c->index = ueIndex + 1;
 
     if (c->supi.has_value())
         IncrementNumber(c->supi->value, ueIndex);
@@ -297,26 +396,22 @@ static std::unique_ptr<nr::ue::UeConfig> GetConfigByUe(int ueIndex)
     return c;
 }
 
-static void ExecuteUeTask(std::unique_ptr<nr::ue::UeTask> &ue)
+static void ExecuteUeTasks(std::vector<std::unique_ptr<nr::ue::UeTask>> &&v)
 {
-    ue->onStart();
-    while (true)
+    std::vector<std::unique_ptr<nr::ue::UeWorker>> workers;
+    for (size_t i = 0; i < v.size(); i += static_cast<size_t>(g_options.uesPerThread))
     {
-        if (ue->onLoop())
-            break;
+        std::vector<std::unique_ptr<nr::ue::UeTask>> ues;
+        for (size_t j = i; j < std::min(v.size(), i + static_cast<size_t>(g_options.uesPerThread)); j++)
+            ues.push_back(std::move(v[j]));
+        workers.push_back(std::make_unique<nr::ue::UeWorker>(std::move(ues)));
     }
-    ue->onQuit();
-    ue = nullptr;
-}
 
-static void ExecuteUeTasks(std::vector<std::unique_ptr<nr::ue::UeTask>> &v)
-{
     std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers.size(); i++)
+        threads.emplace_back([&workers, i]() { workers[i]->run(); });
 
-    for (size_t i = 1; i < v.size(); i++)
-        threads.emplace_back([&v, i]() { ExecuteUeTask(v[i]); });
-
-    ExecuteUeTask(v[0]);
+    workers[0]->run();
 
     for (auto &thread : threads)
         thread.join();
@@ -326,12 +421,22 @@ int main(int argc, char **argv)
 {
     app::Initialize();
 
+    // The UEs are stopped on SIGINT and SIGTERM rather than the process exiting at once, so that their contexts are
+    // persisted
+    app::SetStopHandler(nr::ue::UeWorker::RequestStop);
+
     try
     {
         ReadOptions(argc, argv);
         g_refConfig = ReadConfigYaml();
         if (g_options.imsi.length() > 0)
             g_refConfig->supi = Supi::Parse("imsi-" + g_options.imsi);
+        if (g_refConfig->capture.enabled)
+            capture::Start(g_refConfig->capture, g_refConfig->getNodeName());
+        if (g_options.traceFile.has_value())
+            trace::Start(*g_options.traceFile, g_refConfig->getNodeName());
+        if (g_options.virtualTime)
+            utils::EnableVirtualTime();
     }
     catch (const std::runtime_error &e)
     {
@@ -341,15 +446,35 @@ int main(int argc, char **argv)
 
     std::cout << utils::CopyrightDeclarationUe() << std::endl;
 
+    // The log sinks are shared by all UEs
+    auto logBase = std::make_shared<LogBase>("logs/ue.log");
+
     std::vector<std::unique_ptr<nr::ue::UeTask>> ueTasks;
 
     for (int i = 0; i < g_options.count; i++)
     {
         auto config = GetConfigByUe(i);
-        auto nodeName = config->getNodeName();
-        ueTasks.push_back(std::make_unique<nr::ue::UeTask>(std::move(config)));
+        ueTasks.push_back(std::make_unique<nr::ue::UeTask>(std::move(config), logBase));
+    }
+
+    // Bulk commands are served until the UEs are stopped
+    std::unique_ptr<nr::ue::UeBulkCmdServer> bulkCmdServer{};
+    std::thread bulkCmdThread{};
+    if (!g_options.disableCmd)
+    {
+        std::vector<std::string> nodeNames;
+        for (auto &ue : ueTasks)
+            nodeNames.push_back(ue->config->getNodeName());
+        bulkCmdServer = std::make_unique<nr::ue::UeBulkCmdServer>(std::move(nodeNames));
+        bulkCmdThread = std::thread{[&bulkCmdServer]() { bulkCmdServer->run(); }};
     }
 
-    ExecuteUeTasks(ueTasks);
+    ExecuteUeTasks(std::move(ueTasks));
+
+    if (bulkCmdServer != nullptr)
+    {
+        bulkCmdServer->stop();
+        bulkCmdThread.join();
+    }
     return 0;
 }
@@ -0,0 +1,320 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "bulk_cmd.hpp"
+
+#include <cstring>
+#include <map>
+#include <set>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <lib/app/cli_cmd.hpp>
+#include <lib/app/node_selector.hpp>
+#include <utils/constants.hpp>
+#include <utils/io.hpp>
+#include <utils/libc_error.hpp>
+#include <utils/octet_string.hpp>
+#include <utils/options.hpp>
+
+static constexpr const size_t BUFFER_SIZE = 65536;
+// Kept below the default queue length of unix datagram sockets, since the UEs drop the responses that do not fit
+static constexpr const size_t MAX_IN_FLIGHT = 8;
+static constexpr const int RESPONSE_TIMEOUT = 5000;
+static constexpr const int CLIENT_SEND_TIMEOUT = 2000;
+
+static int BindSocket(const std::string &socketName)
+{
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0)
+        throw LibError("Could not open domain socket");
+
+    unlink(socketName.c_str());
+
+    struct sockaddr_un name = {};
+    name.sun_family = AF_UNIX;
+    strncpy(name.sun_path, socketName.c_str(), sizeof(name.sun_path) - 1);
+
+    if (bind(fd, (const struct sockaddr *)&name, sizeof(name)) < 0)
+    {
+        close(fd);
+        throw LibError("Could not bind domain socket");
+    }
+
+    io::RelaxPermissions(socketName);
+    return fd;
+}
+
+static std::string FormatOutput(const std::string &nodeName, const std::string &output, bool isError)
+{
+    std::string prefix = nodeName + ":" + (isError ? " ERROR:" : "");
+    if (output.empty())
+        return prefix;
+    if (output.find('\n') == std::string::npos)
+        return prefix + " " + output;
+
+    // Multi-line outputs are indented under the node name
+    std::string result = prefix;
+    size_t start = 0;
+    while (start < output.size())
+    {
+        size_t end = output.find('\n', start);
+        if (end == std::string::npos)
+            end = output.size();
+        result += "\n  " + output.substr(start, end - start);
+        start = end + 1;
+    }
+    return result;
+}
+
+namespace nr::ue
+{
+
+UeBulkCmdServer::UeBulkCmdServer(std::vector<std::string> &&nodeNames)
+    : m_nodeNames{std::move(nodeNames)}, m_socketName{}, m_fanOutSocketName{}, m_fd{-1}, m_fanOutFd{-1},
+      m_commandSequence{}, m_clientLost{}, m_stopRequested{}
+{
+    io::CreateDirectory(cons::CLI_SOCKET_DIR);
+
+    m_socketName = cons::CLI_SOCKET_DIR + (cons::CLI_PROCESS_PREFIX + std::to_string(getpid()));
+    m_fd = BindSocket(m_socketName);
+
+    // A client that does not read its responses must not block the server forever
+    timeval timeout{CLIENT_SEND_TIMEOUT / 1000, (CLIENT_SEND_TIMEOUT % 1000) * 1000};
+    setsockopt(m_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+UeBulkCmdServer::~UeBulkCmdServer()
+{
+    closeFanOutSocket();
+    close(m_fd);
+    unlink(m_socketName.c_str());
+}
+
+void UeBulkCmdServer::run()
+{
+    uint8_t buffer[BUFFER_SIZE];
+
+    while (!m_stopRequested.load())
+    {
+        InetAddress address;
+        address.setSockLen(sizeof(sockaddr_storage));
+        ssize_t size = recvfrom(m_fd, buffer, sizeof(buffer), 0, (struct sockaddr *)address.getStorageAddr(),
+                                address.getSockLenAddr());
+        if (size <= 0)
+            continue;
+
+        app::CliMessage msg{};
+        if (!app::CliMessage::Decode(buffer, static_cast<size_t>(size), msg))
+            continue;
+        msg.clientAddr = address;
+        m_clientLost = false;
+
+        if (msg.type == app::CliMessage::Type::ECHO)
+            sendToClient(msg);
+        else if (msg.type == app::CliMessage::Type::COMMAND)
+            handleCommand(msg);
+    }
+}
+
+void UeBulkCmdServer::stop()
+{
+    m_stopRequested.store(true);
+
+    // Wakes up the blocking receive of run()
+    shutdown(m_fd, SHUT_RDWR);
+}
+
+void UeBulkCmdServer::openFanOutSocket()
+{
+    closeFanOutSocket();
+
+    m_commandSequence++;
+    m_fanOutSocketName = cons::CLI_SOCKET_DIR + (cons::CLI_FAN_OUT_PREFIX + std::to_string(getpid())) + "-" +
+                         std::to_string(m_commandSequence);
+    m_fanOutFd = BindSocket(m_fanOutSocketName);
+}
+
+void UeBulkCmdServer::closeFanOutSocket()
+{
+    if (m_fanOutFd < 0)
+        return;
+
+    close(m_fanOutFd);
+    unlink(m_fanOutSocketName.c_str());
+    m_fanOutFd = -1;
+}
+
+void UeBulkCmdServer::handleCommand(const app::CliMessage &msg)
+{
+    std::string error{}, output{};
+    if (!app::ValidateNodeSelector(msg.nodeName, error))
+    {
+        sendToClient(app::CliMessage::Error(msg.clientAddr, error));
+        return;
+    }
+
+    // The command is parsed once here, so that an invalid command is not reported by every UE
+    std::vector<std::string> tokens{};
+    if (opt::PerformExpansion(msg.value, tokens) != opt::ExpansionResult::SUCCESS || tokens.empty())
+    {
+        sendToClient(app::CliMessage::Error(msg.clientAddr, "Invalid command: " + msg.value));
+        return;
+    }
+    auto cmd = app::ParseUeCliCommand(std::move(tokens), error, output);
+    if (!error.empty())
+    {
+        sendToClient(app::CliMessage::Error(msg.clientAddr, error));
+        return;
+    }
+    if (!output.empty())
+    {
+        sendToClient(app::CliMessage::Result(msg.clientAddr, output));
+        return;
+    }
+    if (cmd == nullptr)
+    {
+        sendToClient(app::CliMessage::Error(msg.clientAddr, ""));
+        return;
+    }
+
+    std::vector<std::string> matching{};
+    for (auto &nodeName : m_nodeNames)
+        if (app::MatchNodeSelector(msg.nodeName, nodeName))
+            matching.push_back(nodeName);
+
+    try
+    {
+        openFanOutSocket();
+    }
+    catch (const LibError &e)
+    {
+        sendToClient(app::CliMessage::Error(msg.clientAddr, e.what()));
+        return;
+    }
+
+    executeCommand(msg.clientAddr, matching, msg.value);
+    closeFanOutSocket();
+}
+
+void UeBulkCmdServer::executeCommand(const InetAddress &client, const std::vector<std::string> &nodeNames,
+                                     const std::string &command)
+{
+    std::set<std::string> pending{};
+    std::map<std::string, app::CliChunkAssembler> assemblers{};
+    size_t next = 0;
+    int succeeded = 0, failed = 0, timedOut = 0;
+    uint8_t buffer[BUFFER_SIZE];
+
+    auto report = [this, &client](const std::string &nodeName, const std::string &output, bool isError) {
+        sendToClient(app::CliMessage::Echo(client, FormatOutput(nodeName, output, isError)));
+    };
+
+    while ((next < nodeNames.size() || !pending.empty()) && !m_stopRequested.load())
+    {
+        // Commands are forwarded to at most MAX_IN_FLIGHT UEs at a time
+        while (next < nodeNames.size() && pending.size() < MAX_IN_FLIGHT)
+        {
+            const std::string &nodeName = nodeNames[next++];
+
+            OctetString stream{};
+            app::CliMessage::Encode(app::CliMessage::Command(InetAddress{}, command, nodeName), stream);
+
+            struct sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            strncpy(address.sun_path, (cons::CLI_SOCKET_DIR + nodeName).c_str(), sizeof(address.sun_path) - 1);
+
+            if (sendto(m_fanOutFd, stream.data(), static_cast<size_t>(stream.length()), MSG_DONTWAIT,
+                       (const struct sockaddr *)&address, sizeof(address)) < 0)
+            {
+                failed++;
+                report(nodeName, "UE is not reachable", true);
+            }
+            else
+                pending.insert(nodeName);
+        }
+
+        if (pending.empty())
+            continue;
+
+        pollfd pfd{m_fanOutFd, POLLIN, 0};
+        int rc = poll(&pfd, 1, RESPONSE_TIMEOUT);
+        if (rc == 0)
+        {
+            for (auto &nodeName : pending)
+                report(nodeName, "No response from UE", true);
+            timedOut += static_cast<int>(pending.size());
+            pending.clear();
+            assemblers.clear();
+            continue;
+        }
+        if (rc < 0)
+            continue;
+
+        struct sockaddr_un address = {};
+        socklen_t addressLength = sizeof(address);
+        ssize_t size =
+            recvfrom(m_fanOutFd, buffer, sizeof(buffer), 0, (struct sockaddr *)&address, &addressLength);
+        if (size < 0)
+            continue;
+
+        // The responding UE is identified by the name of its socket. The responses to earlier commands went to the
+        // fan-out sockets of their own sequence numbers, so they are not received here.
+        std::string path{address.sun_path, strnlen(address.sun_path, sizeof(address.sun_path))};
+        std::string dir{cons::CLI_SOCKET_DIR};
+        if (path.compare(0, dir.size(), dir) != 0)
+            continue;
+        auto it = pending.find(path.substr(dir.size()));
+        if (it == pending.end())
+            continue;
+
+        app::CliMessage response{};
+        if (!app::CliMessage::Decode(buffer, static_cast<size_t>(size), response))
+            continue;
+        if (!assemblers[*it].assemble(response))
+            continue;
+        assemblers.erase(*it);
+
+        bool isError = response.type == app::CliMessage::Type::ERROR;
+        if (isError)
+            failed++;
+        else
+            succeeded++;
+        report(*it, response.value, isError);
+        pending.erase(it);
+    }
+
+    sendToClient(app::CliMessage::Result(client, std::to_string(nodeNames.size()) + " UE(s) matched, " +
+                                                     std::to_string(succeeded) + " succeeded, " +
+                                                     std::to_string(failed) + " failed, " +
+                                                     std::to_string(timedOut) + " timed out"));
+}
+
+void UeBulkCmdServer::sendToClient(const app::CliMessage &msg)
+{
+    // The rest of the output is dropped once the client has quit or stopped reading
+    if (m_clientLost)
+        return;
+
+    app::CliChunkWriter::Send(msg, [this](app::CliMessage &&part) {
+        if (m_clientLost)
+            return;
+
+        OctetString stream{};
+        app::CliMessage::Encode(part, stream);
+
+        if (sendto(m_fd, stream.data(), static_cast<size_t>(stream.length()), 0, part.clientAddr.getSockAddr(),
+                   part.clientAddr.getSockLen()) < 0)
+            m_clientLost = true;
+    });
+}
+
+} // namespace nr::ue
@@ -0,0 +1,65 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <lib/app/cli_base.hpp>
+
+namespace nr::ue
+{
+
+/*
+ * Executes a CLI command on all UEs of the process whose node names match a node selector. The command is forwarded
+ * to the CLI sockets of the matching UEs, so it is handled by each UE on its own worker thread as usual, and the UEs
+ * on different workers run it in parallel. The result of each UE is streamed to the client as an ECHO message as soon
+ * as it arrives, followed by a RESULT message summarising the outcome.
+ *
+ * Each bulk command gets a sequence number, and is forwarded from a fan-out socket named after it. The socket is closed
+ * when the command completes, so that a late response of a UE to an earlier command cannot be taken for its response
+ * to the current one.
+ */
+class UeBulkCmdServer
+{
+  private:
+    std::vector<std::string> m_nodeNames;
+    std::string m_socketName;
+    std::string m_fanOutSocketName;
+    int m_fd;       // Receives the bulk commands of the clients
+    int m_fanOutFd; // Sends the current command to the UEs and receives their responses, -1 between the commands
+    uint32_t m_commandSequence;
+    bool m_clientLost;
+    std::atomic<bool> m_stopRequested;
+
+  public:
+    explicit UeBulkCmdServer(std::vector<std::string> &&nodeNames);
+    ~UeBulkCmdServer();
+
+    UeBulkCmdServer(const UeBulkCmdServer &) = delete;
+    UeBulkCmdServer &operator=(const UeBulkCmdServer &) = delete;
+
+  public:
+    /* Serves the bulk commands one at a time, until stop() is called */
+    void run();
+    /* Makes run() return, the command being executed is abandoned. Can be called from any thread. */
+    void stop();
+
+  private:
+    void openFanOutSocket();
+    void closeFanOutSocket();
+    void handleCommand(const app::CliMessage &msg);
+    void executeCommand(const InetAddress &client, const std::vector<std::string> &nodeNames,
+                        const std::string &command);
+    void sendToClient(const app::CliMessage &msg);
+};
+
+} // namespace nr::ue
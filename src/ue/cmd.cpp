@@ -8,12 +8,17 @@
 
 #include "cmd.hpp"
 #include "task.hpp"
+#include "worker.hpp"
+
+#include <algorithm>
+#include <fstream>
 
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
 
 #include <lib/app/cli_base.hpp>
+#include <lib/trace/trace.hpp>
 #include <utils/common.hpp>
 #include <utils/io.hpp>
 #include <utils/libc_error.hpp>
@@ -35,6 +40,16 @@ static std::string SignalDescription(int dbm)
     return "Poor";
 }
 
+/* Resident memory of the process in bytes, or 0 if it is not available */
+static int64_t ResidentMemory()
+{
+    int64_t pages = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (!(statm >> pages >> pages))
+        return 0;
+    return pages * static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+}
+
 namespace nr::ue
 {
 
@@ -158,10 +173,12 @@ void UeCmdHandler::sendError(const InetAddress &address, const std::string &outp
 
 void UeCmdHandler::sendMessage(const app::CliMessage &msg)
 {
-    OctetString stream;
-    app::CliMessage::Encode(msg, stream);
+    app::CliChunkWriter::Send(msg, [this](app::CliMessage &&part) {
+        OctetString stream;
+        app::CliMessage::Encode(part, stream);
 
-    m_ue->fdBase->sendTo(FdBase::CLI, stream.data(), static_cast<size_t>(stream.length()), msg.clientAddr);
+        m_ue->fdBase->sendTo(FdBase::CLI, stream.data(), static_cast<size_t>(stream.length()), part.clientAddr);
+    });
 }
 
 void UeCmdHandler::handleCmd(const InetAddress &address, std::unique_ptr<app::UeCliCommand> &&cmd)
@@ -260,9 +277,9 @@ void UeCmdHandler::handleCmd(const InetAddress &address, std::unique_ptr<app::Ue
     }
     case app::UeCliCommand::PS_LIST: {
         Json json = Json::Obj({});
-        for (auto *pduSession : m_ue->nas->m_sm->m_pduSessions)
+        for (auto &pduSession : m_ue->nas->m_sm->m_pduSessions)
         {
-            if (pduSession->psi == 0 || pduSession->psState == EPsState::INACTIVE)
+            if (pduSession == nullptr)
                 continue;
 
             auto obj = Json::Obj({
@@ -285,6 +302,7 @@ void UeCmdHandler::handleCmd(const InetAddress &address, std::unique_ptr<app::Ue
         Json json = Json::Obj({
             {"sti", OctetString::FromOctet8(m_ue->shCtx.sti).toHexString()},
             {"gnb-search-space", ::ToJson(m_ue->config->gnbSearchList)},
+            {"rlc", m_ue->rlsCtl->m_rlc ? rls::ToJson(m_ue->rlsCtl->m_rlc->statistics()) : Json{nullptr}},
         });
         sendResult(address, json.dumpYaml());
         break;
@@ -331,7 +349,97 @@ void UeCmdHandler::handleCmd(const InetAddress &address, std::unique_ptr<app::Ue
         sendResult(address, json.dumpYaml());
         break;
     }
+    case app::UeCliCommand::MEMORY: {
+        int64_t resident = ResidentMemory();
+        int ueCount = UeTask::InstanceCount();
+
+        Json json = Json::Obj({
+            {"ue-objects", estimateUeMemory()},
+            {"procedure-transactions", static_cast<int>(m_ue->nas->m_sm->m_procedureTransactions.size())},
+            {"process", Json::Obj({
+                            {"resident", resident},
+                            {"ue-count", ueCount},
+                            {"worker-threads", UeWorker::InstanceCount()},
+                            {"resident-per-ue", ueCount > 0 ? resident / ueCount : 0},
+                        })},
+        });
+        sendResult(address, json.dumpYaml());
+        break;
+    }
+    case app::UeCliCommand::TRAFFIC_START: {
+        TrafficProfile profile{};
+        profile.destination = cmd->trafficDestination;
+        profile.port = static_cast<uint16_t>(cmd->trafficPort);
+        profile.packetSize = cmd->trafficPacketSize;
+        profile.rate = cmd->trafficRate;
+        profile.burst = cmd->trafficBurst;
+        profile.duration = cmd->trafficDuration;
+
+        std::string error{};
+        if (!m_ue->trafficLayer().start(cmd->psIds[0], profile, error))
+            sendError(address, error);
+        else
+            sendResult(address, "Uplink traffic started");
+        break;
+    }
+    case app::UeCliCommand::TRAFFIC_STOP: {
+        if (m_ue->traffic && cmd->psCount == 0)
+        {
+            for (int psi = PduSession::MIN_ID; psi <= PduSession::MAX_ID; psi++)
+                m_ue->traffic->stop(psi);
+        }
+        for (int i = 0; i < cmd->psCount && m_ue->traffic; i++)
+            m_ue->traffic->stop(cmd->psIds[i]);
+        sendResult(address, "Uplink traffic stopped");
+        break;
+    }
+    case app::UeCliCommand::TRAFFIC_STATS: {
+        Json json = Json::Obj({});
+        for (int psi = PduSession::MIN_ID; psi <= PduSession::MAX_ID && m_ue->traffic; psi++)
+        {
+            auto &uplink = m_ue->traffic->m_uplink[psi];
+            auto &downlink = m_ue->traffic->m_downlink[psi];
+            if (uplink.startTime == 0 && downlink.packets == 0)
+                continue;
+
+            json.put("PDU Session" + std::to_string(psi), Json::Obj({
+                                                              {"uplink", ToJson(uplink)},
+                                                              {"downlink", ToJson(downlink, uplink)},
+                                                          }));
+        }
+        sendResult(address, json.dumpYaml());
+        break;
+    }
+    case app::UeCliCommand::TRACE_STATS: {
+        if (!trace::IsEnabled())
+            sendError(address, "Tracing is not enabled, see the --trace option");
+        else
+            sendResult(address, trace::Statistics().dumpYaml());
+        break;
+    }
     }
 }
 
+/*
+ * Approximate size of the objects owned by this UE in bytes. Only the fixed size parts and the main containers are
+ * counted, the heap usage of the loggers and the allocator overhead are not included.
+ */
+int64_t UeCmdHandler::estimateUeMemory()
+{
+    auto *sm = m_ue->nas->m_sm;
+
+    size_t size = sizeof(UeTask) + sizeof(UeConfig) + sizeof(FdBase) + sizeof(UeCmdHandler);
+    size += sizeof(RlsUdpLayer) + sizeof(RlsCtlLayer) + sizeof(UeRrcLayer);
+    size += sizeof(NasLayer) + sizeof(NasMm) + sizeof(NasSm) + sizeof(Usim);
+    size += std::count_if(sm->m_pduSessions.begin(), sm->m_pduSessions.end(),
+                          [](auto &ps) { return ps != nullptr; }) * sizeof(PduSession);
+    size += sm->m_procedureTransactions.size() * (sizeof(std::pair<const int, ProcedureTransaction>) + 32);
+    size += m_ue->rrc->m_cellDesc.size() * sizeof(std::pair<const int, UeCellDesc>);
+    if (m_ue->tun)
+        size += sizeof(TunLayer);
+    if (m_ue->traffic)
+        size += sizeof(TrafficLayer);
+    return static_cast<int64_t>(size);
+}
+
 } // namespace nr::ue
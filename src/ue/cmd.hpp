@@ -36,6 +36,7 @@ class UeCmdHandler
     void sendMessage(const app::CliMessage &msg);
     void sendResult(const InetAddress &address, const std::string &output);
     void sendError(const InetAddress &address, const std::string &output);
+    int64_t estimateUeMemory();
 };
 
 } // namespace nr::ue
@@ -36,59 +36,28 @@ static nas::ESecurityHeaderType MakeSecurityHeaderType(const NasSecurityContext
     return nas::ESecurityHeaderType::INTEGRITY_PROTECTED_AND_CIPHERED;
 }
 
-static OctetString EncryptData(nas::ETypeOfCipheringAlgorithm alg, const NasCount &count, bool is3gppAccess,
-                               const OctetString &data, const OctetString &key)
+static void EncryptData(nas::ETypeOfCipheringAlgorithm alg, const NasCount &count, bool is3gppAccess, uint8_t *data,
+                        size_t length, const OctetString &key)
 {
     int bearer = is3gppAccess ? 1 : 2;
     int direction = 0;
 
-    OctetString msg = data.copy();
-
     switch (alg)
     {
     case nas::ETypeOfCipheringAlgorithm::EA0:
         break;
     case nas::ETypeOfCipheringAlgorithm::EA1_128:
-        crypto::EncryptEea1((uint32_t)count.toOctet4(), bearer, direction, msg, key);
+        crypto::EncryptEea1((uint32_t)count.toOctet4(), bearer, direction, data, length, key);
         break;
     case nas::ETypeOfCipheringAlgorithm::EA2_128:
-        crypto::EncryptEea2((uint32_t)count.toOctet4(), bearer, direction, msg, key);
+        crypto::EncryptEea2((uint32_t)count.toOctet4(), bearer, direction, data, length, key);
         break;
     case nas::ETypeOfCipheringAlgorithm::EA3_128:
-        crypto::EncryptEea3((uint32_t)count.toOctet4(), bearer, direction, msg, key);
+        crypto::EncryptEea3((uint32_t)count.toOctet4(), bearer, direction, data, length, key);
         break;
     default:
         throw std::runtime_error("Bad ciphering algorithm");
     }
-
-    return msg;
-}
-
-static std::unique_ptr<nas::SecuredMmMessage> Encrypt(NasSecurityContext &ctx, OctetString &&plainNasMessage,
-                                                      nas::EMessageType msgType, bool bypassCiphering,
-                                                      bool noCipheredHeader)
-{
-    auto count = ctx.uplinkCount;
-    auto is3gppAccess = ctx.is3gppAccess;
-    auto &intKey = ctx.keys.kNasInt;
-    auto &encKey = ctx.keys.kNasEnc;
-    auto intAlg = ctx.integrity;
-    auto encAlg = ctx.ciphering;
-
-    auto encryptedData =
-        bypassCiphering ? plainNasMessage.copy() : EncryptData(encAlg, count, is3gppAccess, plainNasMessage, encKey);
-    auto mac = ComputeMac(intAlg, count, is3gppAccess, true, intKey, encryptedData);
-
-    auto secured = std::make_unique<nas::SecuredMmMessage>();
-    secured->epd = nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES;
-    secured->sht = MakeSecurityHeaderType(ctx, msgType, noCipheredHeader);
-    secured->messageAuthenticationCode = octet4{mac};
-    secured->sequenceNumber = count.sqn;
-    secured->plainNasMessage = std::move(encryptedData);
-
-    ctx.countOnEncrypt();
-
-    return secured;
 }
 
 static OctetString DecryptData(nas::ETypeOfCipheringAlgorithm alg, const NasCount &count, bool is3gppAccess,
@@ -123,18 +92,41 @@ static OctetString DecryptData(nas::ETypeOfCipheringAlgorithm alg, const NasCoun
     return msg;
 }
 
-std::unique_ptr<nas::SecuredMmMessage> Encrypt(NasSecurityContext &ctx, const nas::PlainMmMessage &msg,
-                                               bool bypassCiphering, bool noCipheredHeader)
+OctetString Encrypt(NasSecurityContext &ctx, const nas::PlainMmMessage &msg, bool bypassCiphering,
+                    bool noCipheredHeader)
 {
-    nas::EMessageType msgType = msg.messageType;
+    auto count = ctx.uplinkCount;
+    auto is3gppAccess = ctx.is3gppAccess;
+    auto &intKey = ctx.keys.kNasInt;
+    auto &encKey = ctx.keys.kNasEnc;
+    auto intAlg = ctx.integrity;
+    auto encAlg = ctx.ciphering;
+
+    // The plain message is encoded after the security header, then ciphered and integrity protected in place
+    OctetString pdu = nas::EncodeNasMessage(msg, nas::SECURITY_HEADER_LENGTH);
+    uint8_t *data = pdu.data();
+    size_t length = static_cast<size_t>(pdu.length() - nas::SECURITY_HEADER_LENGTH);
+
+    if (!bypassCiphering)
+        EncryptData(encAlg, count, is3gppAccess, data + nas::SECURITY_HEADER_LENGTH, length, encKey);
+
+    data[0] = static_cast<uint8_t>(nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES);
+    data[1] = static_cast<uint8_t>(MakeSecurityHeaderType(ctx, msg.messageType, noCipheredHeader));
+    data[6] = static_cast<uint8_t>(count.sqn);
 
-    OctetString stream;
-    nas::EncodeNasMessage(msg, stream);
+    // MAC is computed over the SQN and the message, which are adjacent in the PDU
+    uint32_t mac = ComputeMac(intAlg, count, is3gppAccess, true, intKey, data + 6, length + 1);
+    data[2] = static_cast<uint8_t>(mac >> 24);
+    data[3] = static_cast<uint8_t>(mac >> 16);
+    data[4] = static_cast<uint8_t>(mac >> 8);
+    data[5] = static_cast<uint8_t>(mac);
 
-    return Encrypt(ctx, std::move(stream), msgType, bypassCiphering, noCipheredHeader);
+    ctx.countOnEncrypt();
+
+    return pdu;
 }
 
-std::unique_ptr<nas::NasMessage> Decrypt(NasSecurityContext &ctx, const nas::SecuredMmMessage &msg)
+bool Decrypt(NasSecurityContext &ctx, const nas::SecuredMmMessage &msg, OctetString &plainMessage)
 {
     auto estimatedCount = ctx.estimatedDownlinkCount(msg.sequenceNumber);
 
@@ -149,13 +141,12 @@ std::unique_ptr<nas::NasMessage> Decrypt(NasSecurityContext &ctx, const nas::Sec
     if (mac != (uint32_t)msg.messageAuthenticationCode)
     {
         // MAC mismatch
-        return nullptr;
+        return false;
     }
 
     ctx.updateDownlinkCount(estimatedCount);
-    OctetString decryptedData = DecryptData(encAlg, estimatedCount, is3gppAccess, encKey, msg.sht, msg.plainNasMessage);
-    OctetView buff{decryptedData};
-    return nas::DecodeNasMessage(buff);
+    plainMessage = DecryptData(encAlg, estimatedCount, is3gppAccess, encKey, msg.sht, msg.plainNasMessage);
+    return true;
 }
 
 uint32_t ComputeMac(nas::ETypeOfIntegrityProtectionAlgorithm alg, NasCount count, bool is3gppAccess, bool isUplink,
@@ -165,6 +156,14 @@ uint32_t ComputeMac(nas::ETypeOfIntegrityProtectionAlgorithm alg, NasCount count
         return 0;
 
     auto data = OctetString::Concat(OctetString::FromOctet(count.sqn), plainMessage);
+    return ComputeMac(alg, count, is3gppAccess, isUplink, key, data.data(), static_cast<size_t>(data.length()));
+}
+
+uint32_t ComputeMac(nas::ETypeOfIntegrityProtectionAlgorithm alg, NasCount count, bool is3gppAccess, bool isUplink,
+                    const OctetString &key, const uint8_t *sqnAndMessage, size_t length)
+{
+    if (alg == nas::ETypeOfIntegrityProtectionAlgorithm::IA0)
+        return 0;
 
     int bearer = is3gppAccess ? 1 : 2;
     int direction = isUplink ? 0 : 1;
@@ -172,11 +171,11 @@ uint32_t ComputeMac(nas::ETypeOfIntegrityProtectionAlgorithm alg, NasCount count
     switch (alg)
     {
     case nas::ETypeOfIntegrityProtectionAlgorithm::IA1_128:
-        return crypto::ComputeMacEia1((int)count.toOctet4(), bearer, direction, data, key);
+        return crypto::ComputeMacEia1((int)count.toOctet4(), bearer, direction, sqnAndMessage, length, key);
     case nas::ETypeOfIntegrityProtectionAlgorithm::IA2_128:
-        return crypto::ComputeMacEia2((int)count.toOctet4(), bearer, direction, data, key);
+        return crypto::ComputeMacEia2((int)count.toOctet4(), bearer, direction, sqnAndMessage, length, key);
     case nas::ETypeOfIntegrityProtectionAlgorithm::IA3_128:
-        return crypto::ComputeMacEia3((int)count.toOctet4(), bearer, direction, data, key);
+        return crypto::ComputeMacEia3((int)count.toOctet4(), bearer, direction, sqnAndMessage, length, key);
     default:
         throw std::runtime_error("Bad integrity algorithm");
     }
@@ -14,11 +14,15 @@
 namespace nr::ue::nas_enc
 {
 
-std::unique_ptr<nas::SecuredMmMessage> Encrypt(NasSecurityContext &ctx, const nas::PlainMmMessage &msg,
-                                               bool bypassCiphering, bool noCipheredHeader);
-std::unique_ptr<nas::NasMessage> Decrypt(NasSecurityContext &ctx, const nas::SecuredMmMessage &msg);
+/* Returns the encoded security protected message */
+OctetString Encrypt(NasSecurityContext &ctx, const nas::PlainMmMessage &msg, bool bypassCiphering,
+                    bool noCipheredHeader);
+/* Returns false on MAC mismatch, otherwise gives the deciphered plain NAS message */
+bool Decrypt(NasSecurityContext &ctx, const nas::SecuredMmMessage &msg, OctetString &plainMessage);
 
 uint32_t ComputeMac(nas::ETypeOfIntegrityProtectionAlgorithm alg, NasCount count, bool is3gppAccess, bool isUplink,
                     const OctetString &key, const OctetString &plainMessage);
+uint32_t ComputeMac(nas::ETypeOfIntegrityProtectionAlgorithm alg, NasCount count, bool is3gppAccess, bool isUplink,
+                    const OctetString &key, const uint8_t *sqnAndMessage, size_t length);
 
 } // namespace nr::ue::nas_enc
@@ -8,10 +8,15 @@
 
 #include "layer.hpp"
 
+#include <lib/nas/encode.hpp>
+#include <utils/common.hpp>
+
+static constexpr const int EXPIRY_RETRY_PERIOD = 1000;
+
 namespace nr::ue
 {
 
-NasLayer::NasLayer(UeTask *ue) : m_ue{ue}, m_timers{}
+NasLayer::NasLayer(UeTask *ue) : m_ue{ue}, m_timers{}, m_lastTimerCycle{}
 {
     m_logger = ue->logBase->makeUniqueLogger(ue->config->getLoggerPrefix() + "nas");
 
@@ -40,6 +45,11 @@ void NasLayer::onQuit()
 }
 
 void NasLayer::performCycle()
+{
+    m_mm->performMmCycle();
+}
+
+void NasLayer::performTimerCycle()
 {
     UeTimer *const arr[] = {
         &m_timers.t3346, &m_timers.t3396, &m_timers.t3444, &m_timers.t3445, &m_timers.t3502, &m_timers.t3510,
@@ -60,7 +70,18 @@ void NasLayer::performCycle()
 
     m_sm->onTimerTick();
 
-    m_mm->performMmCycle();
+    m_lastTimerCycle = utils::CurrentTimeMillis();
+}
+
+int64_t NasLayer::nextTimerDeadline() const
+{
+    int64_t deadline = m_timers.queue.nextDeadline();
+
+    // The expiry of some timers is not handled in the current state (e.g. SM timers in MM-NULL), those are checked
+    // again in the next second instead of making the task spin
+    if (deadline != -1 && deadline <= m_lastTimerCycle)
+        deadline = m_lastTimerCycle + EXPIRY_RETRY_PERIOD;
+    return deadline;
 }
 
 void NasLayer::handleRrcConnectionSetup()
@@ -101,9 +122,11 @@ void NasLayer::handleActiveCellChange(const Tai &prevTai)
 void NasLayer::handleNasDelivery(const OctetString &data)
 {
     OctetView buffer{data};
-    auto nasMessage = nas::DecodeNasMessage(buffer);
+    auto nasMessage = nas::DecodeReceivedNasMessage(buffer);
     if (nasMessage != nullptr)
         m_mm->receiveNasMessage(*nasMessage);
+    else
+        m_logger->err("Malformed or unknown NAS message received, ignoring");
 }
 
 void NasLayer::handleUplinkDataRequest(int psi, CompoundBuffer &buffer)
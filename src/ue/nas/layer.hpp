@@ -29,8 +29,10 @@ class NasLayer
     NasMm *m_mm;
     NasSm *m_sm;
     Usim *m_usim;
+    int64_t m_lastTimerCycle;
 
     friend class UeCmdHandler;
+    friend class TrafficLayer;
 
   public:
     explicit NasLayer(UeTask *ue);
@@ -42,6 +44,8 @@ class NasLayer
 
   public:
     void performCycle();
+    void performTimerCycle();
+    [[nodiscard]] int64_t nextTimerDeadline() const;
     void handleRrcConnectionSetup();
     void handleRrcConnectionRelease();
     void handlePaging(const std::vector<GutiMobileIdentity> &tmsiIds);
@@ -474,11 +474,11 @@ EAutnValidationRes NasMm::validateAutn(const OctetString &rand, const OctetStrin
 {
     // Decode AUTN
     OctetString receivedSQNxorAK = autn.subCopy(0, 6);
-    OctetString receivedAMF = autn.subCopy(6, 2);
-    OctetString receivedMAC = autn.subCopy(8, 8);
+    OctetView receivedAMF = autn.slice(6, 2);
+    OctetView receivedMAC = autn.slice(8, 8);
 
     // Check the separation bit
-    if (receivedAMF.get(0).bit(7) != 1)
+    if (receivedAMF.peek().bit(7) != 1)
     {
         m_logger->err("AUTN validation SEP-BIT failure. expected: 1, received: 0");
         return EAutnValidationRes::AMF_SEPARATION_BIT_FAILURE;
@@ -496,10 +496,10 @@ EAutnValidationRes NasMm::validateAutn(const OctetString &rand, const OctetStrin
     milenage = calculateMilenage(m_usim->m_sqnMng->getSqn(), rand, false);
 
     // Check MAC
-    if (receivedMAC != milenage.mac_a)
+    if (milenage.mac_a != receivedMAC)
     {
         m_logger->err("AUTN validation MAC mismatch. expected [%s] received [%s]", milenage.mac_a.toHexString().c_str(),
-                      receivedMAC.toHexString().c_str());
+                      receivedMAC.readOctetString().toHexString().c_str());
         return EAutnValidationRes::MAC_FAILURE;
     }
 
@@ -9,6 +9,7 @@
 #include "mm.hpp"
 
 #include <lib/nas/utils.hpp>
+#include <lib/trace/trace.hpp>
 #include <ue/nas/usim/usim.hpp>
 #include <ue/task.hpp>
 #include <utils/common.hpp>
@@ -69,12 +70,14 @@ void NasMm::onStart(NasSm *sm, Usim *usim)
     m_sm = sm;
     m_usim = usim;
 
+    restoreContext();
+
     triggerMmCycle();
 }
 
 void NasMm::onQuit()
 {
-    // TODO
+    persistContext();
 }
 
 void NasMm::triggerMmCycle()
@@ -358,6 +361,9 @@ void NasMm::onSwitchCmState(ECmState oldState, ECmState newState)
                 switchMmState(EMmSubState::MM_DEREGISTERED_PS);
         }
 
+        // A service request not answered before the release is aborted
+        trace::End(trace::EProcedure::SERVICE_REQUEST, m_ue->config->index, false);
+
         // "If the UE enters the 5GMM-IDLE, the RAND and RES* values stored in the ME shall be deleted and timer T3516,
         // if running, shall be stopped"
         m_usim->m_rand = {};
@@ -367,6 +373,10 @@ void NasMm::onSwitchCmState(ECmState oldState, ECmState newState)
         // "Timer T3512 is reset and started with its initial value, when the UE changes from 5GMM-CONNECTED over 3GPP
         // access to 5GMM-IDLE mode over 3GPP access"
         m_timers->t3512.start();
+
+        // The NAS counts do not change in idle mode, so the persisted context stays valid until the next connection
+        if (m_rmState == ERmState::RM_REGISTERED)
+            persistContext();
     }
 
     if (oldState == ECmState::CM_IDLE && newState == ECmState::CM_CONNECTED)
@@ -9,6 +9,7 @@
 #include "mm.hpp"
 
 #include <lib/nas/utils.hpp>
+#include <lib/trace/trace.hpp>
 #include <ue/nas/sm/sm.hpp>
 #include <ue/task.hpp>
 
@@ -97,6 +98,7 @@ EProcRc NasMm::sendDeregistration(EDeregCause deregCause)
     }
 
     m_sm->localReleaseAllSessions();
+    trace::Abort(m_ue->config->index);
 
     switchMmState(EMmSubState::MM_DEREGISTERED_INITIATED_PS);
 
@@ -363,6 +365,7 @@ void NasMm::performLocalDeregistration()
     m_storage->storedSuci->clear();
 
     m_sm->localReleaseAllSessions();
+    trace::Abort(m_ue->config->index);
 
     switchMmState(EMmSubState::MM_DEREGISTERED_PS);
 }
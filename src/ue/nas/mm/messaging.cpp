@@ -8,7 +8,9 @@
 
 #include "mm.hpp"
 
+#include <lib/nas/encode.hpp>
 #include <lib/nas/utils.hpp>
+#include <lib/trace/trace.hpp>
 #include <ue/nas/enc.hpp>
 #include <ue/nas/sm/sm.hpp>
 #include <ue/task.hpp>
@@ -119,6 +121,8 @@ EProcRc NasMm::sendNasMessage(const nas::PlainMmMessage &msg)
         return EProcRc::STAY;
     }
 
+    trace::Hop("NAS UL", m_ue->config->index, nas::utils::EnumToString(msg.messageType));
+
     bool hasNsCtx =
         m_usim->m_currentNsCtx && (m_usim->m_currentNsCtx->integrity != nas::ETypeOfIntegrityProtectionAlgorithm::IA0 ||
                                    m_usim->m_currentNsCtx->ciphering != nas::ETypeOfCipheringAlgorithm::EA0);
@@ -136,6 +140,9 @@ EProcRc NasMm::sendNasMessage(const nas::PlainMmMessage &msg)
             return EProcRc::STAY;
         }
 
+        // The persisted uplink count must stay ahead of the counts that are used
+        persistContextBeforeUplink();
+
         if (msg.messageType == nas::EMessageType::REGISTRATION_REQUEST ||
             msg.messageType == nas::EMessageType::SERVICE_REQUEST)
         {
@@ -147,24 +154,20 @@ EProcRc NasMm::sendNasMessage(const nas::PlainMmMessage &msg)
                 auto copy = nas::utils::DeepCopyMsg(msg);
                 RemoveCleartextIEs((nas::PlainMmMessage &)*copy, std::move(originalPdu));
 
-                auto copySecured = nas_enc::Encrypt(*m_usim->m_currentNsCtx, (nas::PlainMmMessage &)*copy, true, true);
-                nas::EncodeNasMessage(*copySecured, pdu);
+                pdu = nas_enc::Encrypt(*m_usim->m_currentNsCtx, (nas::PlainMmMessage &)*copy, true, true);
             }
             else
             {
-                auto secured = nas_enc::Encrypt(*m_usim->m_currentNsCtx, msg, true, false);
-                nas::EncodeNasMessage(*secured, pdu);
+                pdu = nas_enc::Encrypt(*m_usim->m_currentNsCtx, msg, true, false);
             }
         }
         else if (msg.messageType == nas::EMessageType::DEREGISTRATION_REQUEST_UE_ORIGINATING)
         {
-            auto secured = nas_enc::Encrypt(*m_usim->m_currentNsCtx, msg, true, false);
-            nas::EncodeNasMessage(*secured, pdu);
+            pdu = nas_enc::Encrypt(*m_usim->m_currentNsCtx, msg, true, false);
         }
         else
         {
-            auto secured = nas_enc::Encrypt(*m_usim->m_currentNsCtx, msg, false, false);
-            nas::EncodeNasMessage(*secured, pdu);
+            pdu = nas_enc::Encrypt(*m_usim->m_currentNsCtx, msg, false, false);
         }
     }
     else
@@ -174,11 +177,11 @@ EProcRc NasMm::sendNasMessage(const nas::PlainMmMessage &msg)
             auto copy = nas::utils::DeepCopyMsg(msg);
             RemoveCleartextIEs((nas::PlainMmMessage &)*copy, {});
 
-            nas::EncodeNasMessage(*copy, pdu);
+            pdu = nas::EncodeNasMessage(*copy, 0);
         }
         else
         {
-            nas::EncodeNasMessage(msg, pdu);
+            pdu = nas::EncodeNasMessage(msg, 0);
         }
     }
 
@@ -217,9 +220,9 @@ void NasMm::receiveNasMessage(const nas::NasMessage &msg)
 
     if (mmMsg.sht == nas::ESecurityHeaderType::INTEGRITY_PROTECTED_WITH_NEW_SECURITY_CONTEXT)
     {
-        auto smcMsg = nas::DecodeNasMessage(OctetView{securedMm.plainNasMessage});
+        auto smcMsg = nas::DecodeReceivedNasMessage(OctetView{securedMm.plainNasMessage});
 
-        if (smcMsg->epd != nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES ||
+        if (smcMsg == nullptr || smcMsg->epd != nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES ||
             (((const nas::MmMessage &)(*smcMsg)).sht != nas::ESecurityHeaderType::NOT_PROTECTED) ||
             (((const nas::PlainMmMessage &)(*smcMsg)).messageType != nas::EMessageType::SECURITY_MODE_COMMAND))
         {
@@ -258,14 +261,23 @@ void NasMm::receiveNasMessage(const nas::NasMessage &msg)
         }
     }
 
-    auto decrypted = nas_enc::Decrypt(*m_usim->m_currentNsCtx, securedMm);
-    if (decrypted == nullptr)
+    OctetString plainMessage{};
+    if (!nas_enc::Decrypt(*m_usim->m_currentNsCtx, securedMm, plainMessage))
     {
         m_logger->err("MAC mismatch in NAS encryption. Ignoring received NAS Message.");
         sendMmStatus(nas::EMmCause::MAC_FAILURE);
         return;
     }
 
+    OctetView buff{plainMessage};
+    auto decrypted = nas::DecodeReceivedNasMessage(buff);
+    if (decrypted == nullptr)
+    {
+        m_logger->err("Malformed or unknown NAS message received in a protected message, ignoring");
+        sendMmStatus(nas::EMmCause::SEMANTICALLY_INCORRECT_MESSAGE);
+        return;
+    }
+
     auto &innerMsg = *decrypted;
     if (innerMsg.epd == nas::EExtendedProtocolDiscriminator::MOBILITY_MANAGEMENT_MESSAGES)
     {
@@ -291,6 +303,8 @@ void NasMm::receiveNasMessage(const nas::NasMessage &msg)
 
 void NasMm::receiveMmMessage(const nas::PlainMmMessage &msg)
 {
+    trace::Hop("NAS DL", m_ue->config->index, nas::utils::EnumToString(msg.messageType));
+
     switch (msg.messageType)
     {
     case nas::EMessageType::REGISTRATION_ACCEPT:
@@ -367,9 +381,9 @@ bool NasMm::checkForReplay(const nas::SecuredMmMessage &msg)
             if (seq == n)
                 return false;
 
+        if (lastNasSequenceNums.size() >= 16)
+            lastNasSequenceNums.erase(lastNasSequenceNums.begin());
         lastNasSequenceNums.push_back(n);
-        while (lastNasSequenceNums.size() > 16)
-            lastNasSequenceNums.pop_front();
     }
 
     return true;
@@ -65,6 +65,8 @@ class NasMm
     int64_t m_lastTimePlmnSearchFailureLogged{};
     // Last time MM state changed
     int64_t m_lastTimeMmStateChange{};
+    // Indicates that the current NAS security context was restored from the persisted storage in this power cycle
+    bool m_nsCtxRestored{};
 
     friend class UeCmdHandler;
     friend class NasSm;
@@ -193,6 +195,11 @@ class NasMm
     void deregistrationRequired(EDeregCause cause);
     void invokeProcedures();
     bool hasPendingProcedure();
+
+  private: /* Persistence */
+    void restoreContext();
+    void persistContext();
+    void persistContextBeforeUplink();
 };
 
 } // namespace nr::ue
\ No newline at end of file
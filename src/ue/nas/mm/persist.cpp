@@ -0,0 +1,408 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "mm.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <lib/nas/utils.hpp>
+#include <utils/io.hpp>
+
+/*
+ * The persisted context of a UE is a small binary file in the following format. All fields have fixed sizes and all
+ * integers are big endian, so that the file can be validated without decoding any NAS IE.
+ *
+ *   magic "UECX" (4), version (1), node name length (1), node name
+ *   flags (1): bit 0 GUTI, bit 1 last visited registered TAI, bit 2 NAS security context
+ *   GUTI: MCC (2), MNC (2), long MNC (1), AMF region ID (1), AMF set ID (2), AMF pointer (1), 5G-TMSI (4)
+ *   TAI: MCC (2), MNC (2), long MNC (1), TAC (3)
+ *   allowed NSSAI: number of slices (1), each slice is SST (1), SD present (1), SD (3)
+ *   NAS security context: TSC (1), ngKSI (1), DL count (3), UL count (3), integrity (1), ciphering (1), and then the
+ *   ABBA, K_AUSF, K_SEAF, K_AMF, K_NASint and K_NASenc with a length octet each
+ *   SQN array: number of entries (2), each entry (8)
+ *
+ * The persisted UL count is UPLINK_COUNT_MARGIN ahead of the current one, and the context is persisted again before
+ * the UE reaches it. Therefore a UE restarted from the file never reuses an uplink NAS COUNT, even if the process was
+ * killed in the connected mode, while the file is written only once per UPLINK_COUNT_MARGIN protected messages.
+ */
+
+static constexpr const uint8_t PERSIST_MAGIC[4] = {'U', 'E', 'C', 'X'};
+static constexpr const int PERSIST_VERSION = 2;
+static constexpr const uint32_t UPLINK_COUNT_MARGIN = 256;
+static constexpr const uint32_t MAX_NAS_COUNT = 0xFFFFFF;
+
+static constexpr const int FLAG_GUTI = 1 << 0;
+static constexpr const int FLAG_TAI = 1 << 1;
+static constexpr const int FLAG_NS_CTX = 1 << 2;
+
+namespace
+{
+
+/* Reads the fields of a persisted context, all reads fail after the first out of bounds access */
+class ContextReader
+{
+  private:
+    OctetView m_stream;
+    bool m_ok;
+
+  public:
+    explicit ContextReader(const OctetString &data) : m_stream{data}, m_ok{true}
+    {
+    }
+
+    [[nodiscard]] bool ok() const
+    {
+        return m_ok;
+    }
+
+    [[nodiscard]] bool atEnd() const
+    {
+        return m_ok && !m_stream.hasNext();
+    }
+
+    bool check(size_t size)
+    {
+        m_ok = m_ok && m_stream.remaining() >= size;
+        return m_ok;
+    }
+
+    int readI()
+    {
+        return check(1) ? m_stream.readI() : 0;
+    }
+
+    int read2I()
+    {
+        return check(2) ? m_stream.read2I() : 0;
+    }
+
+    int read3I()
+    {
+        return check(3) ? m_stream.read3I() : 0;
+    }
+
+    uint32_t read4UI()
+    {
+        return check(4) ? m_stream.read4UI() : 0;
+    }
+
+    uint64_t read8UL()
+    {
+        return check(8) ? m_stream.read8UL() : 0;
+    }
+
+    OctetString readOctetString(int length)
+    {
+        return check(static_cast<size_t>(length)) ? m_stream.readOctetString(length) : OctetString{};
+    }
+
+    std::string readUtf8String(int length)
+    {
+        return check(static_cast<size_t>(length)) ? m_stream.readUtf8String(length) : std::string{};
+    }
+};
+
+} // namespace
+
+static void WritePlmn(const Plmn &plmn, OctetString &stream)
+{
+    stream.appendOctet2(plmn.mcc);
+    stream.appendOctet2(plmn.mnc);
+    stream.appendOctet(plmn.isLongMnc ? 1 : 0);
+}
+
+static Plmn ReadPlmn(ContextReader &reader)
+{
+    Plmn plmn{};
+    plmn.mcc = reader.read2I();
+    plmn.mnc = reader.read2I();
+    plmn.isLongMnc = reader.readI() != 0;
+    return plmn;
+}
+
+static void WriteKey(const OctetString &key, OctetString &stream)
+{
+    stream.appendOctet(key.length());
+    stream.append(key);
+}
+
+static OctetString ReadKey(ContextReader &reader)
+{
+    return reader.readOctetString(reader.readI());
+}
+
+static void WriteNasCount(const nr::ue::NasCount &count, OctetString &stream)
+{
+    stream.appendOctet2(count.overflow);
+    stream.appendOctet(count.sqn);
+}
+
+static nr::ue::NasCount NasCountOf(uint32_t value)
+{
+    nr::ue::NasCount count{};
+    count.overflow = octet2{static_cast<int>(value >> 8) & 0xFFFF};
+    count.sqn = static_cast<uint8_t>(value & 0xFF);
+    return count;
+}
+
+static nr::ue::NasCount ReadNasCount(ContextReader &reader)
+{
+    nr::ue::NasCount count{};
+    count.overflow = octet2{reader.read2I()};
+    count.sqn = static_cast<uint8_t>(reader.readI());
+    return count;
+}
+
+static bool WriteFileAtomically(const std::string &path, const OctetString &data)
+{
+    // The file contains the NAS keys, hence it is only accessible by the owner
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+        return false;
+
+    // The data must be on the disk before the rename, otherwise a crash may leave an empty or torn file in place of
+    // the previous one
+    bool written = ::write(fd, data.data(), static_cast<size_t>(data.length())) == data.length() && ::fsync(fd) == 0;
+    ::close(fd);
+
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // And the rename itself is made durable, so that the reserved uplink count is not lost either
+    auto slash = path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirFd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd < 0)
+        return false;
+    bool synced = ::fsync(dirFd) == 0;
+    ::close(dirFd);
+    return synced;
+}
+
+namespace nr::ue
+{
+
+static std::string ContextFilePath(const UeConfig &config)
+{
+    return *config.contextDir + "/" + config.getNodeName() + ".ctx";
+}
+
+void NasMm::restoreContext()
+{
+    auto &config = *m_ue->config;
+    if (!config.contextDir.has_value() || !config.supi.has_value())
+        return;
+
+    std::string path = ContextFilePath(config);
+    if (!io::Exists(path))
+        return;
+
+    OctetString data;
+    try
+    {
+        std::string content = io::ReadAllText(path);
+        data = OctetString{std::vector<uint8_t>{content.begin(), content.end()}};
+    }
+    catch (const std::exception &)
+    {
+        m_logger->warn("Persisted context could not be read from %s", path.c_str());
+        return;
+    }
+
+    ContextReader reader{data};
+
+    auto magic = reader.readOctetString(4);
+    int version = reader.readI();
+    std::string nodeName = reader.readUtf8String(reader.readI());
+    if (!reader.ok() || std::memcmp(magic.data(), PERSIST_MAGIC, 4) != 0 || version != PERSIST_VERSION ||
+        nodeName != config.getNodeName())
+    {
+        m_logger->warn("Ignoring the persisted context in %s, it does not belong to this UE", path.c_str());
+        return;
+    }
+
+    int flags = reader.readI();
+
+    std::optional<nas::IE5gsMobileIdentity> guti{};
+    if (flags & FLAG_GUTI)
+    {
+        guti = nas::IE5gsMobileIdentity{};
+        guti->type = nas::EIdentityType::GUTI;
+        guti->gutiOrTmsi.plmn = ReadPlmn(reader);
+        guti->gutiOrTmsi.amfRegionId = static_cast<uint8_t>(reader.readI());
+        guti->gutiOrTmsi.amfSetId = reader.read2I();
+        guti->gutiOrTmsi.amfPointer = reader.readI();
+        guti->gutiOrTmsi.tmsi = octet4{reader.read4UI()};
+    }
+
+    std::optional<Tai> tai{};
+    if (flags & FLAG_TAI)
+    {
+        Plmn plmn = ReadPlmn(reader);
+        tai = Tai{plmn, reader.read3I()};
+    }
+
+    NetworkSlice allowedNssai{};
+    int sliceCount = reader.readI();
+    for (int i = 0; i < sliceCount && reader.ok(); i++)
+    {
+        SingleSlice slice{};
+        slice.sst = static_cast<uint8_t>(reader.readI());
+        bool hasSd = reader.readI() != 0;
+        int sd = reader.read3I();
+        if (hasSd)
+            slice.sd = octet3{sd};
+        allowedNssai.slices.push_back(slice);
+    }
+
+    std::unique_ptr<NasSecurityContext> nsCtx{};
+    if (flags & FLAG_NS_CTX)
+    {
+        nsCtx = std::make_unique<NasSecurityContext>();
+        nsCtx->tsc = static_cast<nas::ETypeOfSecurityContext>(reader.readI());
+        nsCtx->ngKsi = reader.readI();
+        nsCtx->downlinkCount = ReadNasCount(reader);
+        nsCtx->uplinkCount = ReadNasCount(reader);
+        nsCtx->persistedUplinkCount = static_cast<uint32_t>(nsCtx->uplinkCount.toOctet4());
+        nsCtx->integrity = static_cast<nas::ETypeOfIntegrityProtectionAlgorithm>(reader.readI());
+        nsCtx->ciphering = static_cast<nas::ETypeOfCipheringAlgorithm>(reader.readI());
+        nsCtx->keys.abba = ReadKey(reader);
+        nsCtx->keys.kAusf = ReadKey(reader);
+        nsCtx->keys.kSeaf = ReadKey(reader);
+        nsCtx->keys.kAmf = ReadKey(reader);
+        nsCtx->keys.kNasInt = ReadKey(reader);
+        nsCtx->keys.kNasEnc = ReadKey(reader);
+    }
+
+    std::vector<uint64_t> sqnArr(static_cast<size_t>(reader.read2I()));
+    for (auto &sqn : sqnArr)
+        sqn = reader.read8UL();
+
+    if (!reader.atEnd() || !m_usim->m_sqnMng->restoreSqnArray(sqnArr))
+    {
+        m_logger->warn("Ignoring the persisted context in %s, the file is malformed", path.c_str());
+        return;
+    }
+
+    if (guti.has_value())
+        m_storage->storedGuti->set(*guti);
+    if (tai.has_value())
+        m_storage->lastVisitedRegisteredTai->set(*tai);
+    m_storage->allowedNssai->set(allowedNssai);
+
+    m_usim->m_currentNsCtx = std::move(nsCtx);
+    m_nsCtxRestored = m_usim->m_currentNsCtx != nullptr;
+
+    m_logger->info("Persisted context restored from %s%s", path.c_str(),
+                   m_nsCtxRestored ? " with a NAS security context" : "");
+}
+
+void NasMm::persistContext()
+{
+    auto &config = *m_ue->config;
+    if (!config.contextDir.has_value() || !config.supi.has_value())
+        return;
+
+    auto &guti = m_storage->storedGuti->get();
+    bool hasGuti = guti.type == nas::EIdentityType::GUTI;
+    auto &tai = m_storage->lastVisitedRegisteredTai->get();
+    auto &nsCtx = m_usim->m_currentNsCtx;
+
+    int flags = 0;
+    if (hasGuti)
+        flags |= FLAG_GUTI;
+    if (tai.hasValue())
+        flags |= FLAG_TAI;
+    if (nsCtx)
+        flags |= FLAG_NS_CTX;
+
+    OctetString stream;
+    stream.append(PERSIST_MAGIC, 4);
+    stream.appendOctet(PERSIST_VERSION);
+    std::string nodeName = config.getNodeName();
+    stream.appendOctet(static_cast<int>(nodeName.size()));
+    stream.appendUtf8(nodeName);
+    stream.appendOctet(flags);
+
+    if (hasGuti)
+    {
+        WritePlmn(guti.gutiOrTmsi.plmn, stream);
+        stream.appendOctet(guti.gutiOrTmsi.amfRegionId);
+        stream.appendOctet2(guti.gutiOrTmsi.amfSetId);
+        stream.appendOctet(guti.gutiOrTmsi.amfPointer);
+        stream.appendOctet4(guti.gutiOrTmsi.tmsi);
+    }
+
+    if (tai.hasValue())
+    {
+        WritePlmn(tai.plmn, stream);
+        stream.appendOctet3(tai.tac);
+    }
+
+    auto &slices = m_storage->allowedNssai->get().slices;
+    stream.appendOctet(static_cast<int>(slices.size()));
+    for (auto &slice : slices)
+    {
+        stream.appendOctet(slice.sst);
+        stream.appendOctet(slice.sd.has_value() ? 1 : 0);
+        stream.appendOctet3(slice.sd.value_or(octet3{}));
+    }
+
+    uint32_t reservedUplinkCount = 0;
+    if (nsCtx)
+    {
+        reservedUplinkCount =
+            std::min(static_cast<uint32_t>(nsCtx->uplinkCount.toOctet4()) + UPLINK_COUNT_MARGIN, MAX_NAS_COUNT);
+
+        stream.appendOctet(static_cast<int>(nsCtx->tsc));
+        stream.appendOctet(nsCtx->ngKsi);
+        WriteNasCount(nsCtx->downlinkCount, stream);
+        WriteNasCount(NasCountOf(reservedUplinkCount), stream);
+        stream.appendOctet(static_cast<int>(nsCtx->integrity));
+        stream.appendOctet(static_cast<int>(nsCtx->ciphering));
+        WriteKey(nsCtx->keys.abba, stream);
+        WriteKey(nsCtx->keys.kAusf, stream);
+        WriteKey(nsCtx->keys.kSeaf, stream);
+        WriteKey(nsCtx->keys.kAmf, stream);
+        WriteKey(nsCtx->keys.kNasInt, stream);
+        WriteKey(nsCtx->keys.kNasEnc, stream);
+    }
+
+    auto &sqnArr = m_usim->m_sqnMng->getSqnArray();
+    stream.appendOctet2(static_cast<int>(sqnArr.size()));
+    for (uint64_t sqn : sqnArr)
+        stream.appendOctet8(sqn);
+
+    std::string path = ContextFilePath(config);
+    if (!WriteFileAtomically(path, stream))
+    {
+        m_logger->warn("Persisted context could not be written to %s", path.c_str());
+        return;
+    }
+
+    if (nsCtx)
+        nsCtx->persistedUplinkCount = reservedUplinkCount;
+}
+
+void NasMm::persistContextBeforeUplink()
+{
+    auto &nsCtx = m_usim->m_currentNsCtx;
+    if (nsCtx && m_ue->config->contextDir.has_value() &&
+        static_cast<uint32_t>(nsCtx->uplinkCount.toOctet4()) >= nsCtx->persistedUplinkCount)
+        persistContext();
+}
+
+} // namespace nr::ue
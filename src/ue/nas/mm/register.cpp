@@ -11,6 +11,15 @@
 #include <ue/nas/sm/sm.hpp>
 #include <algorithm>
 #include <lib/nas/utils.hpp>
+#include <lib/trace/trace.hpp>
+
+static trace::EProcedure RegistrationProcedure(nas::ERegistrationType regType)
+{
+    if (regType == nas::ERegistrationType::INITIAL_REGISTRATION ||
+        regType == nas::ERegistrationType::EMERGENCY_REGISTRATION)
+        return trace::EProcedure::REGISTRATION;
+    return trace::EProcedure::MOBILITY_REGISTRATION;
+}
 
 namespace nr::ue
 {
@@ -61,8 +70,10 @@ EProcRc NasMm::sendInitialRegistration(EInitialRegCause regCause)
     updateProvidedGuti();
 
     // The UE shall mark the 5G NAS security context on the USIM or in the non-volatile memory as invalid when the UE
-    // initiates an initial registration procedure
-    m_usim->m_currentNsCtx = {};
+    // initiates an initial registration procedure. A context just restored from the non-volatile memory is still used
+    // in the memory, so that the network can skip the authentication.
+    if (!m_nsCtxRestored)
+        m_usim->m_currentNsCtx = {};
 
     // Prepare requested NSSAI
     bool isDefaultNssai{};
@@ -110,10 +121,12 @@ EProcRc NasMm::sendInitialRegistration(EInitialRegCause regCause)
     auto rc = sendNasMessage(*request);
     if (rc != EProcRc::OK)
         return rc;
+    trace::Begin(trace::EProcedure::REGISTRATION, m_ue->config->index);
 
     // Switch MM state
     switchMmState(EMmSubState::MM_REGISTERED_INITIATED_PS);
 
+    m_nsCtxRestored = false;
     m_lastRegistrationRequest = std::move(request);
     m_lastRegWithoutNsc = m_usim->m_currentNsCtx == nullptr;
 
@@ -243,6 +256,7 @@ EProcRc NasMm::sendMobilityRegistration(ERegUpdateCause updateCause)
     auto rc = sendNasMessage(*request);
     if (rc != EProcRc::OK)
         return rc;
+    trace::Begin(trace::EProcedure::MOBILITY_REGISTRATION, m_ue->config->index);
     m_lastRegistrationRequest = std::move(request);
     m_lastRegWithoutNsc = m_usim->m_currentNsCtx == nullptr;
 
@@ -286,6 +300,8 @@ void NasMm::receiveRegistrationAccept(const nas::RegistrationAccept &msg)
     m_usim->m_rand = {};
     m_usim->m_resStar = {};
     m_timers->t3516.stop();
+
+    persistContext();
 }
 
 void NasMm::receiveInitialRegistrationAccept(const nas::RegistrationAccept &msg)
@@ -433,6 +449,7 @@ void NasMm::receiveInitialRegistrationAccept(const nas::RegistrationAccept &msg)
         m_registeredForEmergency = true;
 
     m_logger->info("%s is successful", nas::utils::EnumToString(regType));
+    trace::End(RegistrationProcedure(regType), m_ue->config->index, true);
 }
 
 void NasMm::receiveMobilityRegistrationAccept(const nas::RegistrationAccept &msg)
@@ -577,6 +594,7 @@ void NasMm::receiveMobilityRegistrationAccept(const nas::RegistrationAccept &msg
 
     auto regType = m_lastRegistrationRequest->registrationType.registrationType;
     m_logger->info("%s is successful", nas::utils::EnumToString(regType));
+    trace::End(RegistrationProcedure(regType), m_ue->config->index, true);
 }
 
 void NasMm::receiveRegistrationReject(const nas::RegistrationReject &msg)
@@ -592,6 +610,7 @@ void NasMm::receiveRegistrationReject(const nas::RegistrationReject &msg)
     auto regType = m_lastRegistrationRequest->registrationType.registrationType;
 
     m_logger->err("%s failed [%s]", nas::utils::EnumToString(regType), nas::utils::EnumToString(cause));
+    trace::End(RegistrationProcedure(regType), m_ue->config->index, false);
 
     if (regType == nas::ERegistrationType::INITIAL_REGISTRATION ||
         regType == nas::ERegistrationType::EMERGENCY_REGISTRATION)
@@ -931,6 +950,8 @@ void NasMm::receiveMobilityRegistrationReject(const nas::RegistrationReject &msg
 
 void NasMm::handleAbnormalInitialRegFailure(nas::ERegistrationType regType)
 {
+    trace::End(RegistrationProcedure(regType), m_ue->config->index, false);
+
     // Timer T3510 shall be stopped if still running
     m_timers->t3510.stop();
 
@@ -975,6 +996,8 @@ void NasMm::handleAbnormalInitialRegFailure(nas::ERegistrationType regType)
 
 void NasMm::handleAbnormalMobilityRegFailure(nas::ERegistrationType regType)
 {
+    trace::End(RegistrationProcedure(regType), m_ue->config->index, false);
+
     // "Timer T3510 shall be stopped if still running"
     m_timers->t3510.stop();
 
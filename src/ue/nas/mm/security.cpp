@@ -203,6 +203,7 @@ void NasMm::receiveSecurityModeCommand(const nas::SecurityModeCommand &msg)
         nsCtx->keys.kAmf = keys::DeriveAmfPrimeInMobility(true, nsCtx->uplinkCount, nsCtx->keys.kAmf);
         nsCtx->uplinkCount = {};
         nsCtx->downlinkCount = {};
+        nsCtx->persistedUplinkCount = 0; // The new keys are persisted with the next uplink message
     }
 
     // Assign selected algorithms to security context, and derive NAS keys
@@ -219,6 +220,7 @@ void NasMm::receiveSecurityModeCommand(const nas::SecurityModeCommand &msg)
     {
         nsCtx->uplinkCount.sqn = 0;
         nsCtx->uplinkCount.overflow = octet2{0};
+        nsCtx->persistedUplinkCount = 0;
     }
 
     // Set the new NAS Security Context as current one. (If it is not already the current one)
@@ -9,6 +9,7 @@
 #include "mm.hpp"
 
 #include <lib/nas/utils.hpp>
+#include <lib/trace/trace.hpp>
 #include <ue/nas/sm/sm.hpp>
 
 namespace nr::ue
@@ -200,6 +201,7 @@ EProcRc NasMm::sendServiceRequest(EServiceReqCause reqCause)
     auto rc = sendNasMessage(*request);
     if (rc != EProcRc::OK)
         return rc;
+    trace::Begin(trace::EProcedure::SERVICE_REQUEST, m_ue->config->index);
     m_lastServiceRequest = std::move(request);
     m_lastServiceReqCause = reqCause;
     m_timers->t3517.start();
@@ -221,6 +223,7 @@ void NasMm::receiveServiceAccept(const nas::ServiceAccept &msg)
     if (m_lastServiceReqCause != EServiceReqCause::EMERGENCY_FALLBACK)
     {
         m_logger->info("Service Accept received");
+        trace::End(trace::EProcedure::SERVICE_REQUEST, m_ue->config->index, true);
         m_serCounter = 0;
         m_timers->t3517.stop();
         switchMmState(EMmSubState::MM_REGISTERED_PS);
@@ -288,6 +291,7 @@ void NasMm::receiveServiceReject(const nas::ServiceReject &msg)
 
     auto cause = msg.mmCause.value;
     m_logger->err("Service Reject received with cause [%s]", nas::utils::EnumToString(cause));
+    trace::End(trace::EProcedure::SERVICE_REQUEST, m_ue->config->index, false);
 
     auto handleAbnormalCase = [this]() {
         m_logger->debug("Handling Service Reject abnormal case");
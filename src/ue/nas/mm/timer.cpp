@@ -9,6 +9,7 @@
 #include "mm.hpp"
 
 #include <lib/nas/utils.hpp>
+#include <lib/trace/trace.hpp>
 
 namespace nr::ue
 {
@@ -119,6 +120,7 @@ void NasMm::onTimerExpire(UeTimer &timer)
         if (m_mmState == EMmState::MM_SERVICE_REQUEST_INITIATED)
         {
             logExpired();
+            trace::End(trace::EProcedure::SERVICE_REQUEST, m_ue->config->index, false);
 
             switchMmState(EMmSubState::MM_REGISTERED_PS);
 
@@ -8,6 +8,7 @@
 
 #include "mm.hpp"
 
+#include <lib/nas/encode.hpp>
 #include <lib/nas/utils.hpp>
 #include <ue/nas/enc.hpp>
 #include <ue/nas/sm/sm.hpp>
@@ -53,9 +54,9 @@ void NasMm::receiveDlNasTransport(const nas::DlNasTransport &msg)
     }
 
     OctetView buff{msg.payloadContainer.data.data(), static_cast<size_t>(msg.payloadContainer.data.length())};
-    auto nasMessage = nas::DecodeNasMessage(buff);
+    auto nasMessage = nas::DecodeReceivedNasMessage(buff);
 
-    if (nasMessage->epd != nas::EExtendedProtocolDiscriminator::SESSION_MANAGEMENT_MESSAGES)
+    if (nasMessage == nullptr || nasMessage->epd != nas::EExtendedProtocolDiscriminator::SESSION_MANAGEMENT_MESSAGES)
     {
         m_logger->err("Bad payload container in DL NAS Transport, ignoring received message");
         return;
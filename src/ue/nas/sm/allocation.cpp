@@ -25,7 +25,7 @@ int NasSm::allocatePduSessionId(const SessionConfig &config)
     int id = -1;
     for (int i = PduSession::MIN_ID; i <= PduSession::MAX_ID; i++)
     {
-        if (arr[i]->psState == EPsState::INACTIVE)
+        if (arr[i] == nullptr)
         {
             id = i;
             break;
@@ -38,17 +38,20 @@ int NasSm::allocatePduSessionId(const SessionConfig &config)
         return 0;
     }
 
+    arr[id] = std::make_unique<PduSession>(id);
+
     return id;
 }
 
 int NasSm::allocateProcedureTransactionId()
 {
-    auto &arr = m_procedureTransactions;
+    auto &map = m_procedureTransactions;
 
     int id = -1;
     for (int i = ProcedureTransaction::MIN_ID; i <= ProcedureTransaction::MAX_ID; i++)
     {
-        if (arr[i].state == EPtState::INACTIVE)
+        auto it = map.find(i);
+        if (it == map.end() || it->second.state == EPtState::INACTIVE)
         {
             id = i;
             break;
@@ -61,19 +64,19 @@ int NasSm::allocateProcedureTransactionId()
         return 0;
     }
 
-    arr[id] = {};
+    map[id] = {};
 
     return id;
 }
 
 void NasSm::freeProcedureTransactionId(int pti)
 {
-    m_procedureTransactions[pti] = {};
+    m_procedureTransactions.erase(pti);
 }
 
 void NasSm::freePduSessionId(int psi)
 {
-    m_pduSessions[psi]->psState = EPsState::INACTIVE;
+    m_pduSessions[psi].reset();
 }
 
 } // namespace nr::ue
\ No newline at end of file
@@ -14,9 +14,6 @@ namespace nr::ue
 NasSm::NasSm(UeTask *ue, NasTimers *timers) : m_ue(ue), m_timers(timers), m_mm(nullptr)
 {
     m_logger = ue->logBase->makeUniqueLogger(ue->config->getLoggerPrefix() + "nas");
-
-    for (int i = 0; i < 16; i++)
-        m_pduSessions[i] = new PduSession(i);
 }
 
 void NasSm::onStart(NasMm *mm)
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <lib/nas/proto_conf.hpp>
 #include <lib/nas/utils.hpp>
+#include <lib/trace/trace.hpp>
 #include <ue/nas/mm/mm.hpp>
 
 namespace nr::ue
@@ -129,6 +130,7 @@ void NasSm::sendEstablishmentRequest(const SessionConfig &config)
     pt.psi = psi;
 
     /* Send SM message */
+    trace::Begin(trace::EProcedure::PDU_SESSION_ESTABLISHMENT, m_ue->config->index, psi);
     sendSmMessage(psi, *pt.message);
 }
 
@@ -142,7 +144,7 @@ void NasSm::receiveEstablishmentAccept(const nas::PduSessionEstablishmentAccept
     freeProcedureTransactionId(msg.pti);
 
     auto &pduSession = m_pduSessions[msg.pduSessionId];
-    if (pduSession->psState != EPsState::ACTIVE_PENDING)
+    if (pduSession == nullptr || pduSession->psState != EPsState::ACTIVE_PENDING)
     {
         m_logger->err("PS establishment accept received without being requested");
         sendSmCause(nas::ESmCause::MESSAGE_TYPE_NOT_COMPATIBLE_WITH_THE_PROTOCOL_STATE, msg.pti, msg.pduSessionId);
@@ -171,6 +173,7 @@ void NasSm::receiveEstablishmentAccept(const nas::PduSessionEstablishmentAccept
         pduSession->pduAddress = {};
 
     m_logger->info("PDU Session establishment is successful PSI[%d]", pduSession->psi);
+    trace::End(trace::EProcedure::PDU_SESSION_ESTABLISHMENT, m_ue->config->index, true, pduSession->psi);
     setupTunInterface(*pduSession);
 }
 
@@ -185,20 +188,22 @@ void NasSm::receiveEstablishmentReject(const nas::PduSessionEstablishmentReject
 
     auto &pduSession = m_pduSessions[msg.pduSessionId];
 
-    if (pduSession->psState != EPsState::ACTIVE_PENDING)
+    if (pduSession == nullptr || pduSession->psState != EPsState::ACTIVE_PENDING)
     {
         m_logger->err("PS establishment reject received without being requested");
         sendSmCause(nas::ESmCause::MESSAGE_TYPE_NOT_COMPATIBLE_WITH_THE_PROTOCOL_STATE, msg.pti, msg.pduSessionId);
         return;
     }
 
-    pduSession->psState = EPsState::INACTIVE;
+    trace::End(trace::EProcedure::PDU_SESSION_ESTABLISHMENT, m_ue->config->index, false, msg.pduSessionId);
 
     if (pduSession->isEmergency)
     {
         // This not much important and no need for now
         // TODO: inform the upper layers of the failure of the procedure
     }
+
+    freePduSessionId(msg.pduSessionId);
 }
 
 } // namespace nr::ue
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include <set>
 
 #include <lib/nas/utils.hpp>
+#include <lib/trace/trace.hpp>
 #include <ue/nas/mm/mm.hpp>
 
 namespace nr::ue
@@ -56,6 +57,7 @@ void NasSm::abortProcedureByPti(int pti)
 
     if (msgType == nas::EMessageType::PDU_SESSION_ESTABLISHMENT_REQUEST)
     {
+        trace::End(trace::EProcedure::PDU_SESSION_ESTABLISHMENT, m_ue->config->index, false, psi);
         freeProcedureTransactionId(pti);
         freePduSessionId(psi);
     }
@@ -71,12 +73,10 @@ void NasSm::abortProcedureByPti(int pti)
 void NasSm::abortProcedureByPtiOrPsi(int pti, int psi)
 {
     std::set<int> ptiToAbort{};
-    int i = 0;
-    for (auto &pt : m_procedureTransactions)
+    for (auto &[i, pt] : m_procedureTransactions)
     {
         if (pt.state == EPtState::PENDING && pt.psi == psi)
             ptiToAbort.insert(i);
-        i++;
     }
 
     ptiToAbort.insert(pti);
@@ -28,7 +28,7 @@ void NasSm::sendReleaseRequest(int psi)
 
     /* Control the PDU session state */
     auto &ps = m_pduSessions[psi];
-    if (ps->psState != EPsState::ACTIVE)
+    if (ps == nullptr || ps->psState != EPsState::ACTIVE)
     {
         m_logger->warn("PDU session release procedure could not start: PS[%d] is not active already", psi);
         return;
@@ -62,7 +62,7 @@ void NasSm::sendReleaseRequest(int psi)
 void NasSm::sendReleaseRequestForAll()
 {
     for (auto &ps : m_pduSessions)
-        if (ps->psState == EPsState::ACTIVE)
+        if (ps != nullptr && ps->psState == EPsState::ACTIVE)
             sendReleaseRequest(ps->psi);
 }
 
@@ -81,7 +81,7 @@ void NasSm::receiveReleaseReject(const nas::PduSessionReleaseReject &msg)
     {
         auto &pduSession = m_pduSessions[msg.pduSessionId];
 
-        if (pduSession->psState != EPsState::INACTIVE_PENDING)
+        if (pduSession == nullptr || pduSession->psState != EPsState::INACTIVE_PENDING)
         {
             m_logger->err("PS release reject received without being requested");
             sendSmCause(nas::ESmCause::MESSAGE_TYPE_NOT_COMPATIBLE_WITH_THE_PROTOCOL_STATE, msg.pti, msg.pduSessionId);
@@ -104,7 +104,7 @@ void NasSm::receiveReleaseCommand(const nas::PduSessionReleaseCommand &msg)
     int pti = msg.pti;
 
     /* Abnormal case handling 6.3.3.6/a */
-    if (m_pduSessions[msg.pduSessionId]->psState == EPsState::INACTIVE)
+    if (psi < PduSession::MIN_ID || psi > PduSession::MAX_ID || m_pduSessions[psi] == nullptr)
     {
         m_logger->err("PS[%d] is already in inactive state, ignoring release command", msg.pduSessionId);
         sendSmCause(nas::ESmCause::INVALID_PDU_SESSION_IDENTITY, msg.pti, msg.pduSessionId);
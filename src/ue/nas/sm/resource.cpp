@@ -33,7 +33,7 @@ void NasSm::localReleaseSession(int psi)
 {
     m_logger->debug("Performing local release of PDU session[%d]", psi);
 
-    bool isEstablished = IsEstablished(m_pduSessions[psi]->psState);
+    bool isEstablished = m_pduSessions[psi] != nullptr && IsEstablished(m_pduSessions[psi]->psState);
 
     freePduSessionId(psi);
 
@@ -44,7 +44,7 @@ void NasSm::localReleaseSession(int psi)
 void NasSm::localReleaseAllSessions()
 {
     for (auto &session : m_pduSessions)
-        if (IsEstablished(session->psState))
+        if (session != nullptr && IsEstablished(session->psState))
             localReleaseSession(session->psi);
 }
 
@@ -52,7 +52,7 @@ bool NasSm::anyEmergencySession()
 {
     // ACTIVE_PENDING etc. are also included
     return std::any_of(m_pduSessions.begin(), m_pduSessions.end(),
-                       [](auto &ps) { return ps->psState != EPsState::INACTIVE && ps->isEmergency; });
+                       [](auto &ps) { return ps != nullptr && ps->isEmergency; });
 }
 
 void NasSm::handleUplinkStatusChange(int psi, bool isPending)
@@ -90,7 +90,8 @@ std::bitset<16> NasSm::getUplinkDataStatus()
 {
     std::bitset<16> res{};
     for (int i = 1; i < 16; i++)
-        if (m_pduSessions[i]->psState == EPsState::ACTIVE && m_pduSessions[i]->uplinkPending)
+        if (m_pduSessions[i] != nullptr && m_pduSessions[i]->psState == EPsState::ACTIVE &&
+            m_pduSessions[i]->uplinkPending)
             res[i] = true;
     return res;
 }
@@ -99,7 +100,7 @@ std::bitset<16> NasSm::getPduSessionStatus()
 {
     std::bitset<16> res{};
     for (int i = 1; i < 16; i++)
-        if (m_pduSessions[i]->psState == EPsState::ACTIVE)
+        if (m_pduSessions[i] != nullptr && m_pduSessions[i]->psState == EPsState::ACTIVE)
             res[i] = true;
     return res;
 }
@@ -132,7 +133,7 @@ bool NasSm::anySessionMatches(const SessionConfig &config)
 {
     // ACTIVE_PENDING etc. are also included
     return std::any_of(m_pduSessions.begin(), m_pduSessions.end(), [&config](auto &ps) {
-        if (ps->psState == EPsState::INACTIVE)
+        if (ps == nullptr)
             return false;
 
         if (config.isEmergency)
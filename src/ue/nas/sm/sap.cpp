@@ -9,6 +9,7 @@
 #include "sm.hpp"
 
 #include <algorithm>
+#include <vector>
 
 #include <lib/nas/proto_conf.hpp>
 #include <ue/nas/mm/mm.hpp>
@@ -22,13 +23,15 @@ void NasSm::onTimerTick()
     if (m_mm->m_mmState == EMmState::MM_NULL)
         return;
 
-    int pti = 0;
-    for (auto &pt : m_procedureTransactions)
+    // The expiry handlers may free the transactions, hence the expired PTIs are collected first
+    std::vector<int> expired{};
+    for (auto &[pti, pt] : m_procedureTransactions)
     {
         if (pt.timer && pt.timer->performTick())
-            onTransactionTimerExpire(pti);
-        pti++;
+            expired.push_back(pti);
     }
+    for (int pti : expired)
+        onTransactionTimerExpire(pti);
 }
 
 void NasSm::handleUplinkDataRequest(int psi, CompoundBuffer &buffer)
@@ -40,7 +43,7 @@ void NasSm::handleUplinkDataRequest(int psi, CompoundBuffer &buffer)
         state != EMmSubState::MM_SERVICE_REQUEST_INITIATED_PS)
         return;
 
-    if (m_pduSessions[psi]->psState != EPsState::ACTIVE)
+    if (m_pduSessions[psi] == nullptr || m_pduSessions[psi]->psState != EPsState::ACTIVE)
         return;
 
     if (m_mm->m_cmState == ECmState::CM_CONNECTED)
@@ -78,6 +81,7 @@ void NasSm::handleDownlinkDataRequest(int psi, const uint8_t *buffer, size_t siz
         state != EMmSubState::MM_SERVICE_REQUEST_INITIATED_PS)
         return;
 
+    m_ue->trafficLayer().handleDownlinkData(psi, buffer, size);
     m_ue->fdBase->write(FdBase::PS_START + psi, buffer, size);
 }
 
@@ -10,6 +10,7 @@
 
 #include <array>
 #include <bitset>
+#include <map>
 #include <lib/nas/nas.hpp>
 #include <ue/task.hpp>
 #include <ue/types.hpp>
@@ -28,12 +29,13 @@ class NasSm
     std::unique_ptr<Logger> m_logger;
     NasMm *m_mm;
 
-    std::array<PduSession *, 16> m_pduSessions{};
-    std::array<ProcedureTransaction, 255> m_procedureTransactions{};
+    std::array<std::unique_ptr<PduSession>, 16> m_pduSessions{}; // Only the allocated PSIs are present
+    std::map<int, ProcedureTransaction> m_procedureTransactions{}; // Only the allocated PTIs are present
 
     friend class UeCmdHandler;
     friend class NasMm;
     friend class NasLayer;
+    friend class TrafficLayer;
 
   public:
     NasSm(UeTask *ue, NasTimers *timers);
@@ -34,6 +34,7 @@ std::unique_ptr<UeTimer> NasSm::newTransactionTimer(int code)
         return nullptr;
     }
 
+    timer->attach(&m_timers->queue);
     timer->start();
     return timer;
 }
@@ -44,10 +45,12 @@ void NasSm::onTimerExpire(UeTimer &timer)
 
 void NasSm::onTransactionTimerExpire(int pti)
 {
-    auto &pt = m_procedureTransactions[pti];
-    if (pt.state == EPtState::INACTIVE)
+    auto it = m_procedureTransactions.find(pti);
+    if (it == m_procedureTransactions.end() || it->second.state == EPtState::INACTIVE)
         return;
 
+    auto &pt = it->second;
+
     switch (pt.timer->getCode())
     {
     case 3580: {
@@ -59,8 +59,6 @@ static ENasTransportHint MapMsgTypeToHint(nas::EMessageType msgType)
 
 void NasSm::sendSmMessage(int psi, const nas::SmMessage &msg)
 {
-    auto &session = m_pduSessions[psi];
-
     nas::UlNasTransport m;
     m.payloadContainerType.payloadContainerType = nas::EPayloadContainerType::N1_SM_INFORMATION;
     nas::EncodeNasMessage(msg, m.payloadContainer.data);
@@ -70,6 +68,8 @@ void NasSm::sendSmMessage(int psi, const nas::SmMessage &msg)
     if (msg.messageType == nas::EMessageType::PDU_SESSION_ESTABLISHMENT_REQUEST ||
         msg.messageType == nas::EMessageType::PDU_SESSION_MODIFICATION_REQUEST)
     {
+        auto &session = m_pduSessions[psi];
+
         m.requestType = nas::IERequestType{};
         m.requestType->requestType =
             session->isEmergency ? nas::ERequestType::INITIAL_EMERGENCY_REQUEST : nas::ERequestType::INITIAL_REQUEST;
@@ -70,4 +70,17 @@ OctetString SqnManager::getSqn() const
     return OctetString::FromOctet8(getSqnMs()).subCopy(2);
 }
 
+const std::vector<uint64_t> &SqnManager::getSqnArray() const
+{
+    return m_sqnArr;
+}
+
+bool SqnManager::restoreSqnArray(const std::vector<uint64_t> &sqnArr)
+{
+    if (sqnArr.size() != m_sqnArr.size())
+        return false;
+    m_sqnArr = sqnArr;
+    return true;
+}
+
 } // namespace nr::ue
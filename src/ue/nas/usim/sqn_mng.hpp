@@ -38,6 +38,10 @@ class SqnManager
   public:
     [[nodiscard]] OctetString getSqn() const;
     bool checkSqn(const OctetString &sqn);
+
+    /* The SQN array is persisted with the security context, restoring fails if the array size does not match */
+    [[nodiscard]] const std::vector<uint64_t> &getSqnArray() const;
+    bool restoreSqnArray(const std::vector<uint64_t> &sqnArr);
 };
 
 } // namespace nr::ue
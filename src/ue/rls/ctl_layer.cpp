@@ -5,10 +5,17 @@
 static constexpr const size_t MAX_PDU_COUNT = 128;
 static constexpr const int MAX_PDU_TTL = 3000;
 
+// Shared by the UEs of a worker thread. All UEs of a process have the same RLC configuration.
+static CompoundBuffer &ScratchBuffer(const rls::RlcBearerConfig &config)
+{
+    static thread_local CompoundBuffer buffer{std::max<size_t>(8192, 2 * static_cast<size_t>(config.opportunity + 64))};
+    return buffer;
+}
+
 namespace nr::ue
 {
 
-RlsCtlLayer::RlsCtlLayer(UeTask *ue) : m_ue{ue}, m_servingCell{}, m_pduMap{}, m_pendingAck{}, m_cBuffer{8192}
+RlsCtlLayer::RlsCtlLayer(UeTask *ue) : m_ue{ue}, m_servingCell{}, m_pduMap{}, m_pendingAck{}, m_rlc{}
 {
     m_logger = ue->logBase->makeUniqueLogger(ue->config->getLoggerPrefix() + "rls-ctl");
 }
@@ -47,6 +54,14 @@ void RlsCtlLayer::handleRlsMessage(int cellId, rls::EMessageType msgType, uint8_
         }
         else if (pduType == rls::EPduType::RRC)
             m_ue->rrc->handleDownlinkRrc(cellId, static_cast<rrc::RrcChannel>(payload), pduData, pduLength);
+        else if (pduType == rls::EPduType::RLC)
+        {
+            // RLC transmissions are only expected from the serving cell, just like DATA
+            if (m_rlc == nullptr || cellId != m_servingCell)
+                return;
+            if (!m_rlc->receiveTransmission(pduData, pduLength))
+                m_logger->err("Malformed RLC transmission received");
+        }
         else
             m_logger->err("Unhandled RLS PDU type");
     }
@@ -58,6 +73,18 @@ void RlsCtlLayer::handleRlsMessage(int cellId, rls::EMessageType msgType, uint8_
 
 void RlsCtlLayer::handleUplinkRrcDelivery(int cellId, uint32_t pduId, rrc::RrcChannel channel, OctetString &&data)
 {
+    // Every RRC connection starts with a CCCH message, upon which the gNB re-creates the RLC entities of the UE as
+    // well. Otherwise the sequence numbers of the two sides go out of sync if the gNB dropped the entities, e.g. after
+    // losing the signal of the UE, while the UE kept its own.
+    if (m_rlc != nullptr && channel == rrc::RrcChannel::UL_CCCH && cellId == m_servingCell)
+        resetRlc();
+
+    if (m_rlc != nullptr && pduId == 0 && channel == rrc::RrcChannel::UL_DCCH && cellId == m_servingCell)
+    {
+        m_rlc->pushSdu(rls::LCID_SRB1, data.data(), data.length());
+        return;
+    }
+
     if (pduId != 0)
     {
         if (m_pduMap.count(pduId))
@@ -80,15 +107,22 @@ void RlsCtlLayer::handleUplinkRrcDelivery(int cellId, uint32_t pduId, rrc::RrcCh
         m_pduMap[pduId].sentTime = utils::CurrentTimeMillis();
     }
 
-    m_cBuffer.reset();
-    m_cBuffer.setCmSize(static_cast<size_t>(data.length()));
-    std::memcpy(m_cBuffer.cmAddress(), data.data(), m_cBuffer.cmSize());
-    rls::EncodePduTransmission(m_cBuffer, m_ue->shCtx.sti, rls::EPduType::RRC, static_cast<uint32_t>(channel), pduId);
-    m_ue->rlsUdp->send(cellId, m_cBuffer);
+    CompoundBuffer &buffer = ScratchBuffer(m_ue->config->rlc);
+    buffer.reset();
+    buffer.setCmSize(static_cast<size_t>(data.length()));
+    std::memcpy(buffer.cmAddress(), data.data(), buffer.cmSize());
+    rls::EncodePduTransmission(buffer, m_ue->shCtx.sti, rls::EPduType::RRC, static_cast<uint32_t>(channel), pduId);
+    m_ue->rlsUdp->send(cellId, buffer);
 }
 
 void RlsCtlLayer::handleUplinkDataDelivery(int psi, CompoundBuffer &buffer)
 {
+    if (m_rlc != nullptr)
+    {
+        m_rlc->pushSdu(rls::LCID_DRB_BASE + psi, buffer.cmAddress(), buffer.cmSize());
+        return;
+    }
+
     rls::EncodePduTransmission(buffer, m_ue->shCtx.sti, rls::EPduType::DATA, static_cast<uint32_t>(psi), 0);
     m_ue->rlsUdp->send(m_servingCell, buffer);
 }
@@ -124,15 +158,61 @@ void RlsCtlLayer::onAckSendTimerExpired()
         if (!item.second.empty())
             continue;
 
-        rls::EncodePduTransmissionAck(m_cBuffer, m_ue->shCtx.sti, item.second);
-        m_ue->rlsUdp->send(item.first, m_cBuffer);
+        CompoundBuffer &buffer = ScratchBuffer(m_ue->config->rlc);
+        rls::EncodePduTransmissionAck(buffer, m_ue->shCtx.sti, item.second);
+        m_ue->rlsUdp->send(item.first, buffer);
     }
     m_pendingAck.clear();
 }
 
+void RlsCtlLayer::onRlcTickTimerExpired()
+{
+    if (m_rlc == nullptr)
+        return;
+
+    m_rlc->timerCycle(utils::CurrentTimeMillis());
+
+    CompoundBuffer &buffer = ScratchBuffer(m_ue->config->rlc);
+    buffer.reset();
+    size_t n = m_rlc->createTransmission(buffer.cmAddress(), buffer.cmCapacity());
+    if (n == 0)
+        return;
+
+    buffer.setCmSize(n);
+    rls::EncodePduTransmission(buffer, m_ue->shCtx.sti, rls::EPduType::RLC, 0, 0);
+    m_ue->rlsUdp->send(m_servingCell, buffer);
+}
+
+void RlsCtlLayer::handleRlcSdu(int lcid, const uint8_t *data, size_t size)
+{
+    if (lcid == rls::LCID_SRB1)
+        m_ue->rrc->handleDownlinkRrc(m_servingCell, rrc::RrcChannel::DL_DCCH, data, size);
+    else
+        m_ue->nas->handleDownlinkDataRequest(lcid - rls::LCID_DRB_BASE, data, size);
+}
+
 void RlsCtlLayer::assignCurrentCell(int cellId)
 {
+    // RLC entities are bound to the serving cell, and re-created when the serving cell changes
+    bool changed = m_rlc == nullptr || cellId != m_servingCell;
     m_servingCell = cellId;
+
+    if (m_ue->config->rlc.enabled && changed)
+        resetRlc();
+}
+
+void RlsCtlLayer::resetRlc()
+{
+    m_rlc = nullptr;
+    if (m_servingCell == 0)
+        return;
+
+    auto onSdu = [this](int lcid, const uint8_t *data, size_t size) { handleRlcSdu(lcid, data, size); };
+    auto onFailure = [this](int lcid) {
+        m_logger->err("Maximum number of RLC retransmissions reached on LCID %d", lcid);
+        declareRadioLinkFailure(rls::ERlfCause::RLC_MAX_RETRANSMISSION);
+    };
+    m_rlc = std::make_unique<rls::RlcBearerSet>(m_ue->config->rlc, onSdu, onFailure);
 }
 
 void RlsCtlLayer::declareRadioLinkFailure(rls::ERlfCause cause)
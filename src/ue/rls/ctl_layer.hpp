@@ -12,6 +12,7 @@
 #include <vector>
 
 #include <lib/rls/rls_base.hpp>
+#include <lib/rls/rls_rlc.hpp>
 #include <lib/rrc/rrc.hpp>
 #include <ue/types.hpp>
 #include <utils/compound_buffer.hpp>
@@ -28,7 +29,9 @@ class RlsCtlLayer
     int m_servingCell;
     std::unordered_map<uint32_t, rls::PduInfo> m_pduMap;
     std::unordered_map<int, std::vector<uint32_t>> m_pendingAck;
-    CompoundBuffer m_cBuffer;
+    std::unique_ptr<rls::RlcBearerSet> m_rlc;
+
+    friend class UeCmdHandler;
 
   public:
     explicit RlsCtlLayer(UeTask *ue);
@@ -36,10 +39,13 @@ class RlsCtlLayer
 
   private:
     void declareRadioLinkFailure(rls::ERlfCause cause);
+    void handleRlcSdu(int lcid, const uint8_t *data, size_t size);
+    void resetRlc();
 
   public:
     void onAckControlTimerExpired();
     void onAckSendTimerExpired();
+    void onRlcTickTimerExpired();
     void handleRlsMessage(int cellId, rls::EMessageType msgType, uint8_t *buffer, size_t size);
     void assignCurrentCell(int cellId);
     void handleUplinkRrcDelivery(int cellId, uint32_t pduId, rrc::RrcChannel channel, OctetString &&data);
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <stdexcept>
 
+#include <lib/capture/capture.hpp>
 #include <ue/task.hpp>
 #include <utils/common.hpp>
 #include <utils/constants.hpp>
@@ -15,7 +16,7 @@ namespace nr::ue
 {
 
 RlsUdpLayer::RlsUdpLayer(UeTask *ue)
-    : m_ue{ue}, m_cBuffer(BUFFER_SIZE), m_searchSpace{}, m_cells{}, m_cellIdToSti{}, m_lastLoop{}, m_cellIdCounter{}
+    : m_ue{ue}, m_searchSpace{}, m_cells{}, m_cellIdToSti{}, m_lastLoop{}, m_cellIdCounter{}
 {
     m_logger = ue->logBase->makeUniqueLogger(ue->config->getLoggerPrefix() + "rls-udp");
 
@@ -40,12 +41,19 @@ void RlsUdpLayer::checkHeartbeat()
     }
 }
 
+int64_t RlsUdpLayer::nextHeartbeat() const
+{
+    return m_lastLoop + LOOP_PERIOD + 1;
+}
+
 void RlsUdpLayer::sendRlsPdu(const InetAddress &address, CompoundBuffer &buffer)
 {
     int version = address.getIpVersion();
     if (version != 4 && version != 6)
         throw std::runtime_error{"UdpServer::Send failure: Invalid IP version"};
 
+    capture::Tap(capture::EInterface::RLS, capture::EDirection::OUTBOUND, buffer.data(), buffer.size(),
+                 m_ue->config->index);
     m_ue->fdBase->sendTo(version == 4 ? FdBase::RLS_IP4 : FdBase::RLS_IP6, buffer.data(), buffer.size(), address);
 }
 
@@ -60,6 +68,8 @@ void RlsUdpLayer::send(int cellId, CompoundBuffer &buffer)
 
 void RlsUdpLayer::receiveRlsPdu(const InetAddress &addr, uint8_t *buffer, size_t size)
 {
+    capture::Tap(capture::EInterface::RLS, capture::EDirection::INBOUND, buffer, size, m_ue->config->index);
+
     rls::EMessageType msgType;
     uint64_t sti;
 
@@ -134,10 +144,12 @@ void RlsUdpLayer::heartbeatCycle(uint64_t time, const Vector3 &simPos)
     for (auto cell : toRemove)
         onSignalChangeOrLost(cell);
 
-    rls::EncodeHeartbeat(m_cBuffer, m_ue->shCtx.sti, simPos);
+    // Shared by the UEs of a worker thread
+    static thread_local CompoundBuffer buffer{BUFFER_SIZE};
+    rls::EncodeHeartbeat(buffer, m_ue->shCtx.sti, simPos);
 
     for (auto &address : m_searchSpace)
-        sendRlsPdu(address, m_cBuffer);
+        sendRlsPdu(address, buffer);
 }
 
 } // namespace nr::ue
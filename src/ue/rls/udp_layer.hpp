@@ -36,7 +36,6 @@ class RlsUdpLayer
   private:
     UeTask *m_ue;
     std::unique_ptr<Logger> m_logger;
-    CompoundBuffer m_cBuffer;
     std::vector<InetAddress> m_searchSpace;
     std::unordered_map<uint64_t, CellInfo> m_cells;
     std::unordered_map<int, uint64_t> m_cellIdToSti;
@@ -57,6 +56,7 @@ class RlsUdpLayer
 
   public:
     void checkHeartbeat();
+    [[nodiscard]] int64_t nextHeartbeat() const;
     void send(int cellId, CompoundBuffer &buffer);
     void receiveRlsPdu(const InetAddress &address, uint8_t *buffer, size_t size);
 };
@@ -26,24 +26,12 @@ void UeRrcLayer::handleDownlinkRrc(int cellId, rrc::RrcChannel channel, const ui
 
     switch (channel)
     {
-    case rrc::RrcChannel::BCCH_BCH: {
-        auto *pdu = rrc::encode::Decode<ASN_RRC_BCCH_BCH_Message>(asn_DEF_ASN_RRC_BCCH_BCH_Message, buffer, size);
-        if (pdu == nullptr)
-            m_logger->err("RRC BCCH-BCH PDU decoding failed.");
-        else
-            receiveRrcMessage(cellId, pdu);
-        asn::Free(asn_DEF_ASN_RRC_BCCH_BCH_Message, pdu);
+    case rrc::RrcChannel::BCCH_BCH:
+        receiveBcchBch(cellId, buffer, size);
         break;
-    }
-    case rrc::RrcChannel::BCCH_DL_SCH: {
-        auto *pdu = rrc::encode::Decode<ASN_RRC_BCCH_DL_SCH_Message>(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, buffer, size);
-        if (pdu == nullptr)
-            m_logger->err("RRC BCCH-DL-SCH PDU decoding failed.");
-        else
-            receiveRrcMessage(cellId, pdu);
-        asn::Free(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, pdu);
+    case rrc::RrcChannel::BCCH_DL_SCH:
+        receiveBcchDlSch(cellId, buffer, size);
         break;
-    }
     case rrc::RrcChannel::DL_CCCH: {
         auto *pdu = rrc::encode::Decode<ASN_RRC_DL_CCCH_Message>(asn_DEF_ASN_RRC_DL_CCCH_Message, buffer, size);
         if (pdu == nullptr)
@@ -120,28 +108,6 @@ void UeRrcLayer::sendRrcMessage(ASN_RRC_UL_DCCH_Message *msg)
     m_ue->rlsCtl->handleUplinkRrcDelivery(m_ue->shCtx.currentCell.cellId, 0, rrc::RrcChannel::UL_DCCH, std::move(pdu));
 }
 
-void UeRrcLayer::receiveRrcMessage(int cellId, ASN_RRC_BCCH_BCH_Message *msg)
-{
-    if (msg->message.present == ASN_RRC_BCCH_BCH_MessageType_PR_mib)
-        receiveMib(cellId, *msg->message.choice.mib);
-}
-
-void UeRrcLayer::receiveRrcMessage(int cellId, ASN_RRC_BCCH_DL_SCH_Message *msg)
-{
-    if (msg->message.present != ASN_RRC_BCCH_DL_SCH_MessageType_PR_c1)
-        return;
-
-    auto &c1 = msg->message.choice.c1;
-    switch (c1->present)
-    {
-    case ASN_RRC_BCCH_DL_SCH_MessageType__c1_PR_systemInformationBlockType1:
-        receiveSib1(cellId, *c1->choice.systemInformationBlockType1);
-        break;
-    default:
-        break;
-    }
-}
-
 void UeRrcLayer::receiveRrcMessage(int cellId, ASN_RRC_DL_CCCH_Message *msg)
 {
     if (msg->message.present != ASN_RRC_DL_CCCH_MessageType_PR_c1)
@@ -9,6 +9,7 @@
 #include "layer.hpp"
 
 #include <lib/rrc/encode.hpp>
+#include <lib/trace/trace.hpp>
 #include <ue/task.hpp>
 #include <utils/random.hpp>
 
@@ -163,6 +164,7 @@ void UeRrcLayer::performLocalRelease(bool treatBarred)
     switchState(ERrcState::RRC_IDLE);
 
     m_ue->shCtx.sti = Random::Mixed(m_ue->config->getNodeName()).nextL();
+    trace::SetSti(m_ue->config->index, m_ue->shCtx.sti);
     m_ue->nas->handleRrcConnectionRelease();
 }
 
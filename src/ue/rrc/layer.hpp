@@ -13,6 +13,7 @@
 #include <ue/types.hpp>
 #include <utils/logger.hpp>
 #include <utils/nts.hpp>
+#include <lib/asn/utils.hpp>
 #include <lib/rrc/rrc.hpp>
 #include <lib/rls/rls_base.hpp>
 
@@ -20,8 +21,6 @@
 
 extern "C"
 {
-    struct ASN_RRC_BCCH_BCH_Message;
-    struct ASN_RRC_BCCH_DL_SCH_Message;
     struct ASN_RRC_DL_CCCH_Message;
     struct ASN_RRC_DL_DCCH_Message;
     struct ASN_RRC_PCCH_Message;
@@ -36,8 +35,6 @@ extern "C"
     struct ASN_RRC_RRCReject;
     struct ASN_RRC_RRCRelease;
     struct ASN_RRC_Paging;
-    struct ASN_RRC_MIB;
-    struct ASN_RRC_SIB1;
 }
 
 namespace nr::ue
@@ -83,8 +80,6 @@ class UeRrcLayer
     void sendRrcMessage(int cellId, ASN_RRC_UL_CCCH_Message *msg);
     void sendRrcMessage(int cellId, ASN_RRC_UL_CCCH1_Message *msg);
     void sendRrcMessage(ASN_RRC_UL_DCCH_Message *msg);
-    void receiveRrcMessage(int cellId, ASN_RRC_BCCH_BCH_Message *msg);
-    void receiveRrcMessage(int cellId, ASN_RRC_BCCH_DL_SCH_Message *msg);
     void receiveRrcMessage(int cellId, ASN_RRC_DL_CCCH_Message *msg);
     void receiveRrcMessage(ASN_RRC_DL_DCCH_Message *msg);
     void receiveRrcMessage(ASN_RRC_PCCH_Message *msg);
@@ -107,8 +102,10 @@ class UeRrcLayer
     void updateAvailablePlmns();
 
     /* System Information and Broadcast */
-    void receiveMib(int cellId, const ASN_RRC_MIB &msg);
-    void receiveSib1(int cellId, const ASN_RRC_SIB1 &msg);
+    void receiveBcchBch(int cellId, const uint8_t *buffer, size_t size);
+    void receiveBcchDlSch(int cellId, const uint8_t *buffer, size_t size);
+    void receiveMib(int cellId, const UeCellDesc::Mib &mib);
+    void receiveSib1(int cellId, const UeCellDesc::Sib1 &sib1);
 
     /* NAS Transport */
     void receiveDownlinkInformationTransfer(const ASN_RRC_DLInformationTransfer &msg);
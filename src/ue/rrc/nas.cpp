@@ -9,6 +9,7 @@
 #include "layer.hpp"
 
 #include <lib/rrc/encode.hpp>
+#include <lib/trace/trace.hpp>
 #include <ue/task.hpp>
 
 #include <asn/rrc/ASN_RRC_DLInformationTransfer-IEs.h>
@@ -30,6 +31,8 @@ void UeRrcLayer::deliverUplinkNas(uint32_t pduId, OctetString &&nasPdu)
     if (nasPdu.length() == 0)
         return;
 
+    trace::Hop("RRC UL", m_ue->config->index, m_state == ERrcState::RRC_IDLE ? "RRC Setup Request" : nullptr);
+
     if (m_state == ERrcState::RRC_IDLE)
     {
         startConnectionEstablishment(std::move(nasPdu));
@@ -63,6 +66,7 @@ void UeRrcLayer::receiveDownlinkInformationTransfer(const ASN_RRC_DLInformationT
 {
     OctetString nasPdu =
         asn::GetOctetString(*msg.criticalExtensions.choice.dlInformationTransfer->dedicatedNAS_Message);
+    trace::Hop("RRC DL", m_ue->config->index);
 
     m_ue->nas->handleNasDelivery(nasPdu);
 }
@@ -8,62 +8,170 @@
 
 #include "layer.hpp"
 
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
 #include <lib/asn/rrc.hpp>
 #include <lib/asn/utils.hpp>
 #include <lib/rrc/encode.hpp>
 
+#include <asn/rrc/ASN_RRC_BCCH-BCH-Message.h>
+#include <asn/rrc/ASN_RRC_BCCH-DL-SCH-Message.h>
 #include <asn/rrc/ASN_RRC_MIB.h>
 #include <asn/rrc/ASN_RRC_PLMN-IdentityInfo.h>
 #include <asn/rrc/ASN_RRC_PLMN-IdentityInfoList.h>
 #include <asn/rrc/ASN_RRC_SIB1.h>
 #include <asn/rrc/ASN_RRC_UAC-BarringInfoSet.h>
 
-namespace nr::ue
+namespace
 {
 
-void UeRrcLayer::receiveMib(int cellId, const ASN_RRC_MIB &msg)
+/*
+ * All UEs of the process receive the same MIB and SIB1 bytes from a cell, so the decoded content is shared by the
+ * UE threads, keyed by the encoded bytes. An empty value means that the message is valid but not of interest.
+ */
+template <typename T>
+class SysInfoMemo
 {
-    auto &desc = m_cellDesc[cellId];
-
-    desc.mib.isBarred = msg.cellBarred == ASN_RRC_MIB__cellBarred_barred;
-    desc.mib.isIntraFreqReselectAllowed = msg.intraFreqReselection == ASN_RRC_MIB__intraFreqReselection_allowed;
-
-    desc.mib.hasMib = true;
-
-    updateAvailablePlmns();
+  private:
+    static constexpr const size_t MAX_ENTRIES = 64;
+
+    std::mutex m_mutex{};
+    std::unordered_map<std::string, std::optional<T>> m_entries{};
+
+  public:
+    bool find(const std::string &key, std::optional<T> &value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return false;
+        value = it->second;
+        return true;
+    }
+
+    void put(std::string &&key, const std::optional<T> &value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_entries.size() >= MAX_ENTRIES)
+            m_entries.clear();
+        m_entries[std::move(key)] = value;
+    }
+};
+
+SysInfoMemo<nr::ue::UeCellDesc::Mib> g_mibMemo{};
+SysInfoMemo<nr::ue::UeCellDesc::Sib1> g_sib1Memo{};
+
+nr::ue::UeCellDesc::Mib ExtractMib(const ASN_RRC_MIB &msg)
+{
+    nr::ue::UeCellDesc::Mib mib{};
+    mib.isBarred = msg.cellBarred == ASN_RRC_MIB__cellBarred_barred;
+    mib.isIntraFreqReselectAllowed = msg.intraFreqReselection == ASN_RRC_MIB__intraFreqReselection_allowed;
+    mib.hasMib = true;
+    return mib;
 }
 
-void UeRrcLayer::receiveSib1(int cellId, const ASN_RRC_SIB1 &msg)
+nr::ue::UeCellDesc::Sib1 ExtractSib1(const ASN_RRC_SIB1 &msg)
 {
-    auto &desc = m_cellDesc[cellId];
+    nr::ue::UeCellDesc::Sib1 sib1{};
 
-    desc.sib1.isReserved = msg.cellAccessRelatedInfo.cellReservedForOtherUse != nullptr;
+    sib1.isReserved = msg.cellAccessRelatedInfo.cellReservedForOtherUse != nullptr;
 
     auto *plmnIdentityInfo = msg.cellAccessRelatedInfo.plmn_IdentityList.list.array[0];
-    desc.sib1.nci = asn::GetBitStringLong<36>(plmnIdentityInfo->cellIdentity);
+    sib1.nci = asn::GetBitStringLong<36>(plmnIdentityInfo->cellIdentity);
 
-    desc.sib1.isReserved &=
+    sib1.isReserved &=
         plmnIdentityInfo->cellReservedForOperatorUse == ASN_RRC_PLMN_IdentityInfo__cellReservedForOperatorUse_reserved;
 
-    desc.sib1.tac = asn::GetBitStringInt<24>(*plmnIdentityInfo->trackingAreaCode);
+    sib1.tac = asn::GetBitStringInt<24>(*plmnIdentityInfo->trackingAreaCode);
 
     auto plmnIdentity = plmnIdentityInfo->plmn_IdentityList.list.array[0];
-    desc.sib1.plmn = asn::rrc::GetPlmnId(*plmnIdentity);
+    sib1.plmn = asn::rrc::GetPlmnId(*plmnIdentity);
 
     auto *barringInfo = msg.uac_BarringInfo->uac_BarringInfoSetList.list.array[0];
 
     int barringBits = asn::GetBitStringInt<7>(barringInfo->uac_BarringForAccessIdentity);
-    desc.sib1.aiBarringSet.ai15 = bits::BitAt<0>(barringBits);
-    desc.sib1.aiBarringSet.ai14 = bits::BitAt<1>(barringBits);
-    desc.sib1.aiBarringSet.ai13 = bits::BitAt<2>(barringBits);
-    desc.sib1.aiBarringSet.ai12 = bits::BitAt<3>(barringBits);
-    desc.sib1.aiBarringSet.ai11 = bits::BitAt<4>(barringBits);
-    desc.sib1.aiBarringSet.ai2 = bits::BitAt<5>(barringBits);
-    desc.sib1.aiBarringSet.ai1 = bits::BitAt<6>(barringBits);
+    sib1.aiBarringSet.ai15 = bits::BitAt<0>(barringBits);
+    sib1.aiBarringSet.ai14 = bits::BitAt<1>(barringBits);
+    sib1.aiBarringSet.ai13 = bits::BitAt<2>(barringBits);
+    sib1.aiBarringSet.ai12 = bits::BitAt<3>(barringBits);
+    sib1.aiBarringSet.ai11 = bits::BitAt<4>(barringBits);
+    sib1.aiBarringSet.ai2 = bits::BitAt<5>(barringBits);
+    sib1.aiBarringSet.ai1 = bits::BitAt<6>(barringBits);
+
+    sib1.hasSib1 = true;
+    return sib1;
+}
+
+} // namespace
+
+namespace nr::ue
+{
+
+void UeRrcLayer::receiveBcchBch(int cellId, const uint8_t *buffer, size_t size)
+{
+    std::string key{reinterpret_cast<const char *>(buffer), size};
+
+    std::optional<UeCellDesc::Mib> mib{};
+    if (!g_mibMemo.find(key, mib))
+    {
+        auto *pdu = rrc::encode::Decode<ASN_RRC_BCCH_BCH_Message>(asn_DEF_ASN_RRC_BCCH_BCH_Message, buffer, size);
+        if (pdu == nullptr)
+        {
+            m_logger->err("RRC BCCH-BCH PDU decoding failed.");
+            return;
+        }
+
+        if (pdu->message.present == ASN_RRC_BCCH_BCH_MessageType_PR_mib)
+            mib = ExtractMib(*pdu->message.choice.mib);
+        asn::Free(asn_DEF_ASN_RRC_BCCH_BCH_Message, pdu);
+
+        g_mibMemo.put(std::move(key), mib);
+    }
+
+    if (mib.has_value())
+        receiveMib(cellId, *mib);
+}
 
-    desc.sib1.hasSib1 = true;
+void UeRrcLayer::receiveBcchDlSch(int cellId, const uint8_t *buffer, size_t size)
+{
+    std::string key{reinterpret_cast<const char *>(buffer), size};
+
+    std::optional<UeCellDesc::Sib1> sib1{};
+    if (!g_sib1Memo.find(key, sib1))
+    {
+        auto *pdu =
+            rrc::encode::Decode<ASN_RRC_BCCH_DL_SCH_Message>(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, buffer, size);
+        if (pdu == nullptr)
+        {
+            m_logger->err("RRC BCCH-DL-SCH PDU decoding failed.");
+            return;
+        }
+
+        if (pdu->message.present == ASN_RRC_BCCH_DL_SCH_MessageType_PR_c1 &&
+            pdu->message.choice.c1->present == ASN_RRC_BCCH_DL_SCH_MessageType__c1_PR_systemInformationBlockType1)
+            sib1 = ExtractSib1(*pdu->message.choice.c1->choice.systemInformationBlockType1);
+        asn::Free(asn_DEF_ASN_RRC_BCCH_DL_SCH_Message, pdu);
+
+        g_sib1Memo.put(std::move(key), sib1);
+    }
+
+    if (sib1.has_value())
+        receiveSib1(cellId, *sib1);
+}
 
+void UeRrcLayer::receiveMib(int cellId, const UeCellDesc::Mib &mib)
+{
+    m_cellDesc[cellId].mib = mib;
+    updateAvailablePlmns();
+}
+
+void UeRrcLayer::receiveSib1(int cellId, const UeCellDesc::Sib1 &sib1)
+{
+    m_cellDesc[cellId].sib1 = sib1;
     updateAvailablePlmns();
 }
 
-} // namespace nr::ue
\ No newline at end of file
+} // namespace nr::ue
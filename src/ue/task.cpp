@@ -9,12 +9,15 @@
 #include "task.hpp"
 #include "cmd.hpp"
 
+#include <algorithm>
+#include <atomic>
+
+#include <lib/trace/trace.hpp>
 #include <utils/random.hpp>
 
 struct TimerPeriod
 {
     static constexpr const int L3_MACHINE_CYCLE = 2500;
-    static constexpr const int L3_TIMER = 1000;
     static constexpr const int RLS_ACK_CONTROL = 1500;
     static constexpr const int RLS_ACK_SEND = 2250;
     static constexpr const int SWITCH_OFF = 500;
@@ -22,18 +25,35 @@ struct TimerPeriod
 
 #define BUFFER_SIZE 32768ull
 
+static constexpr const int MAX_FDS_PER_WAKE_UP = 16;
+
 namespace nr::ue
 {
 
-ue::UeTask::UeTask(std::unique_ptr<UeConfig> &&config) : m_cBuffer(BUFFER_SIZE)
+// Scratch buffers shared by the UEs of a worker thread
+static uint8_t *ReceiveBuffer()
+{
+    static thread_local std::unique_ptr<uint8_t[]> buffer{new uint8_t[BUFFER_SIZE]};
+    return buffer.get();
+}
+
+static CompoundBuffer &UplinkDataBuffer()
+{
+    static thread_local CompoundBuffer buffer{BUFFER_SIZE};
+    return buffer;
+}
+
+static std::atomic<int> g_ueCount{};
+
+ue::UeTask::UeTask(std::unique_ptr<UeConfig> &&config, std::shared_ptr<LogBase> logBase)
 {
-    this->logBase = std::make_unique<LogBase>("logs/ue-" + config->getNodeName() + ".log");
+    this->logBase = std::move(logBase);
     this->config = std::move(config);
     this->fdBase = std::make_unique<FdBase>();
-    this->m_buffer = std::unique_ptr<uint8_t[]>(new uint8_t[BUFFER_SIZE]);
     this->m_cmdHandler = std::make_unique<UeCmdHandler>(this);
 
     this->shCtx.sti = Random::Mixed(this->config->getNodeName()).nextL();
+    trace::SetSti(this->config->index, this->shCtx.sti);
 
     this->rlsUdp = std::make_unique<RlsUdpLayer>(this);
     this->rlsCtl = std::make_unique<RlsCtlLayer>(this);
@@ -42,15 +62,25 @@ ue::UeTask::UeTask(std::unique_ptr<UeConfig> &&config) : m_cBuffer(BUFFER_SIZE)
     this->tun = std::make_unique<TunLayer>(this);
 
     this->m_timerL3MachineCycle = -1;
-    this->m_timerL3Timer = -1;
     this->m_timerRlsAckControl = -1;
     this->m_timerRlsAckSend = -1;
+    this->m_timerRlcTick = -1;
     this->m_timerSwitchOff = -1;
 
     this->m_immediateCycle = true;
+
+    g_ueCount++;
 }
 
-UeTask::~UeTask() = default;
+UeTask::~UeTask()
+{
+    g_ueCount--;
+}
+
+int UeTask::InstanceCount()
+{
+    return g_ueCount;
+}
 
 void UeTask::onStart()
 {
@@ -60,12 +90,13 @@ void UeTask::onStart()
 
     auto current = utils::CurrentTimeMillis();
     m_timerL3MachineCycle = current + TimerPeriod::L3_MACHINE_CYCLE;
-    m_timerL3Timer = current + TimerPeriod::L3_TIMER;
     m_timerRlsAckControl = current + TimerPeriod::RLS_ACK_CONTROL;
     m_timerRlsAckSend = current + TimerPeriod::RLS_ACK_SEND;
+    if (config->rlc.enabled)
+        m_timerRlcTick = current + config->rlc.tickPeriod;
 }
 
-bool UeTask::onLoop()
+bool UeTask::performWork()
 {
     rlsUdp->checkHeartbeat();
 
@@ -77,35 +108,40 @@ bool UeTask::onLoop()
         m_immediateCycle = false;
         rrc->performCycle();
         nas->performCycle();
-        return false;
     }
 
-    int fdId = fdBase->performSelect();
-    if (fdId >= 0)
+    return false;
+}
+
+void UeTask::handleReadyFds()
+{
+    for (int i = 0; i < MAX_FDS_PER_WAKE_UP; i++)
     {
+        int fdId = fdBase->performSelect(0);
+        if (fdId < 0)
+            return;
+
         if (fdId >= FdBase::PS_START && fdId <= FdBase::PS_END)
         {
-            size_t n = fdBase->read(fdId, m_cBuffer.cmAddress(), m_cBuffer.cmCapacity());
-            m_cBuffer.reset();
-            m_cBuffer.setCmSize(n);
-            nas->handleUplinkDataRequest(fdId - FdBase::PS_START, m_cBuffer);
+            CompoundBuffer &buffer = UplinkDataBuffer();
+            size_t n = fdBase->read(fdId, buffer.cmAddress(), buffer.cmCapacity());
+            buffer.reset();
+            buffer.setCmSize(n);
+            nas->handleUplinkDataRequest(fdId - FdBase::PS_START, buffer);
         }
         else if (fdId == FdBase::RLS_IP4 || fdId == FdBase::RLS_IP6)
         {
             InetAddress peer;
-            size_t n = fdBase->receive(fdId, m_buffer.get(), BUFFER_SIZE, peer);
-            rlsUdp->receiveRlsPdu(peer, m_buffer.get(), n);
+            size_t n = fdBase->receive(fdId, ReceiveBuffer(), BUFFER_SIZE, peer);
+            rlsUdp->receiveRlsPdu(peer, ReceiveBuffer(), n);
         }
         else if (fdId == FdBase::CLI)
         {
             InetAddress peer;
-            size_t n = fdBase->receive(fdId, m_buffer.get(), BUFFER_SIZE, peer);
-            m_cmdHandler->receiveCmd(peer, m_buffer.get(), n);
+            size_t n = fdBase->receive(fdId, ReceiveBuffer(), BUFFER_SIZE, peer);
+            m_cmdHandler->receiveCmd(peer, ReceiveBuffer(), n);
         }
-        return false;
     }
-
-    return false;
 }
 
 void UeTask::onQuit()
@@ -118,15 +154,26 @@ bool UeTask::checkTimers()
 {
     auto current = utils::CurrentTimeMillis();
 
+    // Checked separately, since the other timers must not delay the transmission opportunities
+    if (m_timerRlcTick != -1 && m_timerRlcTick <= current)
+    {
+        m_timerRlcTick = current + config->rlc.tickPeriod;
+        rlsCtl->onRlcTickTimerExpired();
+    }
+
+    if (int64_t trafficDeadline = traffic ? traffic->nextDeadline() : -1;
+        trafficDeadline != -1 && trafficDeadline <= current)
+        traffic->onTick(current);
+
     if (m_timerL3MachineCycle != -1 && m_timerL3MachineCycle <= current)
     {
         m_timerL3MachineCycle = current + TimerPeriod::L3_MACHINE_CYCLE;
         rrc->performCycle();
         nas->performCycle();
     }
-    else if (m_timerL3Timer != -1 && m_timerL3Timer <= current)
+    else if (int64_t nasDeadline = nas->nextTimerDeadline(); nasDeadline != -1 && nasDeadline <= current)
     {
-        m_timerL3Timer = current + TimerPeriod::L3_TIMER;
+        nas->performTimerCycle();
         rrc->performCycle();
         nas->performCycle();
     }
@@ -148,6 +195,24 @@ bool UeTask::checkTimers()
     return false;
 }
 
+int64_t UeTask::nextDeadline()
+{
+    if (m_immediateCycle)
+        return 0;
+
+    // The L3 machine cycle and the RLS heartbeat are always scheduled, so that the task never sleeps indefinitely
+    int64_t deadline = std::min(m_timerL3MachineCycle, rlsUdp->nextHeartbeat());
+
+    for (int64_t timer : {m_timerRlsAckControl, m_timerRlsAckSend, m_timerRlcTick, m_timerSwitchOff,
+                          nas->nextTimerDeadline(), traffic ? traffic->nextDeadline() : -1})
+    {
+        if (timer != -1)
+            deadline = std::min(deadline, timer);
+    }
+
+    return deadline;
+}
+
 void UeTask::triggerCycle()
 {
     m_immediateCycle = true;
@@ -158,4 +223,11 @@ void UeTask::triggerSwitchOff()
     m_timerSwitchOff = utils::CurrentTimeMillis() + TimerPeriod::SWITCH_OFF;
 }
 
+TrafficLayer &UeTask::trafficLayer()
+{
+    if (traffic == nullptr)
+        traffic = std::make_unique<TrafficLayer>(this);
+    return *traffic;
+}
+
 } // namespace nr::ue
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include <ue/rls/ctl_layer.hpp>
 #include <ue/rls/udp_layer.hpp>
 #include <ue/rrc/layer.hpp>
+#include <ue/traffic/layer.hpp>
 #include <ue/tun/layer.hpp>
 #include <utils/common_types.hpp>
 #include <utils/compound_buffer.hpp>
@@ -38,26 +39,25 @@ class RlsCtlLayer;
 class UeRrcLayer;
 class NasLayer;
 class TunLayer;
+class TrafficLayer;
 class UeCmdHandler;
 
 class UeTask
 {
   private:
     int64_t m_timerL3MachineCycle;
-    int64_t m_timerL3Timer;
     int64_t m_timerRlsAckControl;
     int64_t m_timerRlsAckSend;
+    int64_t m_timerRlcTick;
     int64_t m_timerSwitchOff;
 
   private:
     bool m_immediateCycle;
-    std::unique_ptr<uint8_t[]> m_buffer;
     std::unique_ptr<UeCmdHandler> m_cmdHandler;
-    CompoundBuffer m_cBuffer;
 
   public:
     std::unique_ptr<UeConfig> config;
-    std::unique_ptr<LogBase> logBase;
+    std::shared_ptr<LogBase> logBase; // Shared by all UEs in the process
     std::unique_ptr<FdBase> fdBase;
     UeSharedContext shCtx;
 
@@ -67,19 +67,31 @@ class UeTask
     std::unique_ptr<UeRrcLayer> rrc;
     std::unique_ptr<NasLayer> nas;
     std::unique_ptr<TunLayer> tun;
+    std::unique_ptr<TrafficLayer> traffic; // Null until there is traffic to generate or measure, see trafficLayer()
 
   public:
-    explicit UeTask(std::unique_ptr<UeConfig> &&config);
+    UeTask(std::unique_ptr<UeConfig> &&config, std::shared_ptr<LogBase> logBase);
     ~UeTask();
 
+    /* Number of UE instances in the process */
+    static int InstanceCount();
+
   public:
     void onStart();
-    bool onLoop();
     void onQuit();
 
+    /* Handles the due heartbeat, timers and state machine cycles. Returns true if the UE is switched off. */
+    bool performWork();
+    /* Handles the fds of the UE which are ready to read, without blocking */
+    void handleReadyFds();
+    /* Time of the next call to performWork() in milliseconds, 0 if it is due immediately */
+    int64_t nextDeadline();
+
   public:
     void triggerCycle();
     void triggerSwitchOff();
+    /* Creates the traffic layer on first use, most of the UEs of a load test never carry user plane traffic */
+    TrafficLayer &trafficLayer();
 
   private:
     bool checkTimers();
@@ -14,10 +14,16 @@
 
 UeTimer::UeTimer(int timerCode, bool isMmTimer, int defaultInterval)
     : m_code(timerCode), m_isMm(isMmTimer), m_interval(defaultInterval), m_startMillis(0), m_isRunning(false),
-      m_expiryCount(0), m_lastDebugPrintMs(0)
+      m_expiryCount(0), m_queue(nullptr)
 {
 }
 
+UeTimer::~UeTimer()
+{
+    if (m_queue != nullptr && m_isRunning)
+        m_queue->m_entries.erase({getDeadline(), this});
+}
+
 bool UeTimer::isRunning() const
 {
     return m_isRunning;
@@ -37,17 +43,23 @@ void UeTimer::start(bool clearExpiryCount)
 {
     if (clearExpiryCount)
         resetExpiryCount();
+
+    int64_t oldDeadline = getDeadline();
     m_startMillis = utils::CurrentTimeMillis();
     m_isRunning = true;
+    updateQueue(oldDeadline);
 }
 
 void UeTimer::start(const nas::IEGprsTimer2 &v, bool clearExpiryCount)
 {
     if (clearExpiryCount)
         resetExpiryCount();
+
+    int64_t oldDeadline = getDeadline();
     m_interval = v.value;
     m_startMillis = utils::CurrentTimeMillis();
     m_isRunning = true;
+    updateQueue(oldDeadline);
 }
 
 void UeTimer::start(const nas::IEGprsTimer3 &v, bool clearExpiryCount)
@@ -73,9 +85,11 @@ void UeTimer::start(const nas::IEGprsTimer3 &v, bool clearExpiryCount)
     else if (v.unit == nas::EGprsTimerValueUnit3::MULTIPLES_OF_320HOUR)
         secs = val * 60 * 60 * 320;
 
+    int64_t oldDeadline = getDeadline();
     m_interval = secs;
     m_startMillis = utils::CurrentTimeMillis();
     m_isRunning = true;
+    updateQueue(oldDeadline);
 }
 
 void UeTimer::stop(bool clearExpiryCount)
@@ -85,28 +99,20 @@ void UeTimer::stop(bool clearExpiryCount)
 
     if (m_isRunning)
     {
+        int64_t oldDeadline = getDeadline();
         m_startMillis = utils::CurrentTimeMillis();
         m_isRunning = false;
+        updateQueue(oldDeadline);
     }
 }
 
 bool UeTimer::performTick()
 {
-    if (m_isRunning)
+    if (m_isRunning && utils::CurrentTimeMillis() >= getDeadline())
     {
-        int64_t currentMs = utils::CurrentTimeMillis();
-        int64_t deltaSec = (currentMs - m_startMillis) / 1000LL;
-        int64_t remainingSec = m_interval - deltaSec;
-
-        if (currentMs - m_lastDebugPrintMs > 10LL * 1000LL)
-            m_lastDebugPrintMs = currentMs;
-
-        if (remainingSec <= 0LL)
-        {
-            stop(false);
-            m_expiryCount++;
-            return true;
-        }
+        stop(false);
+        m_expiryCount++;
+        return true;
     }
     return false;
 }
@@ -135,6 +141,32 @@ int UeTimer::getExpiryCount() const
     return m_expiryCount;
 }
 
+int64_t UeTimer::getDeadline() const
+{
+    return m_isRunning ? m_startMillis + static_cast<int64_t>(m_interval) * 1000LL : -1;
+}
+
+void UeTimer::attach(UeTimerQueue *queue)
+{
+    m_queue = queue;
+}
+
+void UeTimer::updateQueue(int64_t oldDeadline)
+{
+    if (m_queue == nullptr)
+        return;
+
+    if (oldDeadline != -1)
+        m_queue->m_entries.erase({oldDeadline, this});
+    if (m_isRunning)
+        m_queue->m_entries.insert({getDeadline(), this});
+}
+
+int64_t UeTimerQueue::nextDeadline() const
+{
+    return m_entries.empty() ? -1 : m_entries.begin()->first;
+}
+
 Json ToJson(const UeTimer &v)
 {
     std::stringstream ss{};
@@ -8,9 +8,14 @@
 
 #pragma once
 
+#include <set>
+#include <utility>
+
 #include <lib/nas/ie4.hpp>
 #include <utils/json.hpp>
 
+class UeTimerQueue;
+
 class UeTimer
 {
   private:
@@ -22,10 +27,14 @@ class UeTimer
     bool m_isRunning;
     int m_expiryCount;
 
-    int64_t m_lastDebugPrintMs;
+    UeTimerQueue *m_queue;
 
   public:
     UeTimer(int timerCode, bool isMmTimer, int defaultInterval);
+    ~UeTimer();
+
+    UeTimer(const UeTimer &) = delete;
+    UeTimer &operator=(const UeTimer &) = delete;
 
   public:
     void start(bool clearExpiryCount = true);
@@ -40,6 +49,31 @@ class UeTimer
     [[nodiscard]] int getInterval() const;
     [[nodiscard]] int getRemaining() const;
     [[nodiscard]] int getExpiryCount() const;
+
+    /* Expiry time in milliseconds, or -1 if the timer is not running */
+    [[nodiscard]] int64_t getDeadline() const;
+
+    /* The timer is kept in the given queue while running. Must be called before the timer is started. */
+    void attach(UeTimerQueue *queue);
+
+  private:
+    void updateQueue(int64_t oldDeadline);
+};
+
+/*
+ * Running timers of a UE ordered by their deadlines, so that the UE task can sleep until the next expiry instead of
+ * polling the timers periodically.
+ */
+class UeTimerQueue
+{
+  private:
+    std::set<std::pair<int64_t, UeTimer *>> m_entries;
+
+    friend class UeTimer;
+
+  public:
+    /* Earliest deadline of the running timers, or -1 if there is none */
+    [[nodiscard]] int64_t nextDeadline() const;
 };
 
 Json ToJson(const UeTimer &v);
@@ -0,0 +1,321 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "layer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <ue/nas/sm/sm.hpp>
+#include <ue/task.hpp>
+#include <utils/common.hpp>
+#include <utils/constants.hpp>
+
+static constexpr const size_t IP_HEADER_SIZE = 20;
+static constexpr const size_t UDP_HEADER_SIZE = 8;
+static constexpr const uint32_t TAG_MAGIC = 0x4E525447; // "NRTG"
+static constexpr const size_t TAG_SIZE = 4 + 8 + 8;     // Magic, sequence number and send time in microseconds
+static constexpr const uint16_t SOURCE_PORT = 50000;
+// Upper bound of the packets sent in one tick, 4 ms worth of the maximum rate, so that a late tick catches up
+static constexpr const int64_t MAX_PACKETS_PER_TICK = 4000;
+
+static void Write2(uint8_t *p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v >> 8);
+    p[1] = static_cast<uint8_t>(v);
+}
+
+static void Write4(uint8_t *p, uint32_t v)
+{
+    Write2(p, v >> 16);
+    Write2(p + 2, v);
+}
+
+static void Write8(uint8_t *p, uint64_t v)
+{
+    Write4(p, static_cast<uint32_t>(v >> 32));
+    Write4(p + 4, static_cast<uint32_t>(v));
+}
+
+static uint32_t Read4(const uint8_t *p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+static uint64_t Read8(const uint8_t *p)
+{
+    return (static_cast<uint64_t>(Read4(p)) << 32) | Read4(p + 4);
+}
+
+static uint16_t IpChecksum(const uint8_t *header, size_t size)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < size; i += 2)
+        sum += (static_cast<uint32_t>(header[i]) << 8) | header[i + 1];
+    while (sum >> 16)
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    return static_cast<uint16_t>(~sum);
+}
+
+static CompoundBuffer &PacketBuffer()
+{
+    static thread_local CompoundBuffer buffer{8192};
+    return buffer;
+}
+
+namespace nr::ue
+{
+
+TrafficLayer::TrafficLayer(UeTask *ue) : m_ue{ue}, m_uplink{}, m_downlink{}, m_runningCount{}
+{
+}
+
+bool TrafficLayer::start(int psi, const TrafficProfile &profile, std::string &outError)
+{
+    if (psi < PduSession::MIN_ID || psi > PduSession::MAX_ID)
+    {
+        outError = "Invalid PDU session ID";
+        return false;
+    }
+
+    auto *session = m_ue->nas->m_sm->m_pduSessions[psi].get();
+    if (session == nullptr || session->psState != EPsState::ACTIVE)
+    {
+        outError = "PDU session is not active";
+        return false;
+    }
+    if (!session->pduAddress.has_value() || session->pduAddress->sessionType != nas::EPduSessionType::IPV4 ||
+        session->pduAddress->pduAddressInformation.length() != 4)
+    {
+        outError = "PDU session has no IPv4 address";
+        return false;
+    }
+
+    auto destination = utils::IpToOctetString(profile.destination);
+    if (destination.length() != 4)
+    {
+        outError = "Destination must be an IPv4 address";
+        return false;
+    }
+
+    stop(psi);
+
+    auto &traffic = m_uplink[psi];
+    traffic = {};
+    traffic.profile = profile;
+    for (int i = 0; i < 4; i++)
+    {
+        traffic.source[i] = session->pduAddress->pduAddressInformation.getI(i);
+        traffic.destination[i] = destination.getI(i);
+    }
+
+    traffic.isRunning = true;
+    traffic.startTime = utils::CurrentTimeMillis();
+    traffic.lastTime = traffic.startTime;
+    if (profile.duration > 0)
+        traffic.endTime = traffic.startTime + static_cast<int64_t>(profile.duration) * 1000;
+    m_runningCount++;
+
+    m_downlink[psi] = {};
+    return true;
+}
+
+void TrafficLayer::stop(int psi)
+{
+    if (psi < 0 || psi >= static_cast<int>(m_uplink.size()) || !m_uplink[psi].isRunning)
+        return;
+
+    m_uplink[psi].isRunning = false;
+    m_runningCount--;
+}
+
+void TrafficLayer::handleDownlinkData(int psi, const uint8_t *buffer, size_t size)
+{
+    if (psi < 0 || psi >= static_cast<int>(m_downlink.size()))
+        return;
+
+    auto &traffic = m_downlink[psi];
+    int64_t current = utils::CurrentTimeMicros();
+
+    if (traffic.packets == 0)
+        traffic.firstTime = current;
+    traffic.lastTime = current;
+    traffic.packets++;
+    traffic.octets += static_cast<int64_t>(size);
+
+    // Only the IPv4/UDP packets carrying a tag are measured further
+    if (size < IP_HEADER_SIZE || (buffer[0] >> 4) != 4 || buffer[9] != 17)
+        return;
+    size_t payload = static_cast<size_t>(buffer[0] & 0xF) * 4 + UDP_HEADER_SIZE;
+    if (size < payload + TAG_SIZE || Read4(buffer + payload) != TAG_MAGIC)
+        return;
+
+    auto sequence = static_cast<int64_t>(Read8(buffer + payload + 4));
+    auto rtt = std::max(current - static_cast<int64_t>(Read8(buffer + payload + 12)), int64_t{0});
+
+    if (traffic.taggedPackets == 0)
+    {
+        traffic.maxSequence = sequence;
+        traffic.rttMin = traffic.rttMax = rtt;
+    }
+    else
+    {
+        if (sequence < traffic.maxSequence)
+            traffic.reordered++;
+        traffic.maxSequence = std::max(traffic.maxSequence, sequence);
+        traffic.rttMin = std::min(traffic.rttMin, rtt);
+        traffic.rttMax = std::max(traffic.rttMax, rtt);
+    }
+    traffic.taggedPackets++;
+    traffic.rttSum += rtt;
+}
+
+void TrafficLayer::onTick(int64_t current)
+{
+    if (m_runningCount == 0)
+        return;
+
+    for (int psi = PduSession::MIN_ID; psi <= PduSession::MAX_ID; psi++)
+    {
+        auto &traffic = m_uplink[psi];
+        if (!traffic.isRunning)
+            continue;
+
+        // The generator is stopped together with its PDU session
+        auto &session = m_ue->nas->m_sm->m_pduSessions[psi];
+        if (session == nullptr || session->psState != EPsState::ACTIVE)
+        {
+            stop(psi);
+            continue;
+        }
+
+        int64_t until = traffic.endTime != 0 ? std::min(current, traffic.endTime) : current;
+        int64_t due = (until - traffic.startTime) * traffic.profile.rate / 1000 - traffic.scheduled;
+
+        if (due >= traffic.profile.burst)
+        {
+            // The whole backlog is sent in bursts, up to the per-tick bound. The packets beyond it are skipped, and
+            // counted as such.
+            int64_t backlog = due - due % traffic.profile.burst;
+            int64_t count = std::min(backlog, MAX_PACKETS_PER_TICK - MAX_PACKETS_PER_TICK % traffic.profile.burst);
+            traffic.skipped += backlog - count;
+            traffic.scheduled += backlog - count;
+            for (int64_t i = 0; i < count; i++)
+                sendPacket(psi, traffic);
+            traffic.scheduled += count;
+            traffic.lastTime = until;
+        }
+
+        if (traffic.endTime != 0 && current >= traffic.endTime)
+            stop(psi);
+    }
+}
+
+int64_t TrafficLayer::nextDeadline() const
+{
+    if (m_runningCount == 0)
+        return -1;
+
+    int64_t deadline = -1;
+    for (auto &traffic : m_uplink)
+    {
+        if (!traffic.isRunning)
+            continue;
+
+        auto rate = static_cast<int64_t>(traffic.profile.rate);
+        int64_t next = traffic.startTime + ((traffic.scheduled + traffic.profile.burst) * 1000 + rate - 1) / rate;
+        if (traffic.endTime != 0)
+            next = std::min(next, traffic.endTime);
+        if (deadline == -1 || next < deadline)
+            deadline = next;
+    }
+    return deadline;
+}
+
+void TrafficLayer::sendPacket(int psi, UplinkTraffic &traffic)
+{
+    auto size = static_cast<size_t>(traffic.profile.packetSize);
+
+    CompoundBuffer &buffer = PacketBuffer();
+    buffer.reset();
+    uint8_t *p = buffer.cmAddress();
+    std::memset(p, 0, size);
+
+    p[0] = 0x45;
+    Write2(p + 2, static_cast<uint32_t>(size));
+    Write2(p + 4, static_cast<uint32_t>(traffic.sequence));
+    p[6] = 0x40; // Don't fragment
+    p[8] = 64;
+    p[9] = 17;
+    std::memcpy(p + 12, traffic.source.data(), 4);
+    std::memcpy(p + 16, traffic.destination.data(), 4);
+    Write2(p + 10, IpChecksum(p, IP_HEADER_SIZE));
+
+    // The UDP checksum is left zero, which is allowed over IPv4
+    uint8_t *udp = p + IP_HEADER_SIZE;
+    Write2(udp, SOURCE_PORT);
+    Write2(udp + 2, traffic.profile.port);
+    Write2(udp + 4, static_cast<uint32_t>(size - IP_HEADER_SIZE));
+
+    uint8_t *tag = udp + UDP_HEADER_SIZE;
+    Write4(tag, TAG_MAGIC);
+    Write8(tag + 4, traffic.sequence);
+    Write8(tag + 12, static_cast<uint64_t>(utils::CurrentTimeMicros()));
+
+    buffer.setCmSize(size);
+    m_ue->nas->handleUplinkDataRequest(psi, buffer);
+
+    traffic.sequence++;
+    traffic.packets++;
+    traffic.octets += static_cast<int64_t>(size);
+}
+
+/* Throughput in kilobits per second over the given number of milliseconds */
+static int64_t Throughput(int64_t octets, int64_t millis)
+{
+    return millis > 0 ? octets * 8 / millis : 0;
+}
+
+Json ToJson(const UplinkTraffic &v)
+{
+    return Json::Obj({
+        {"running", v.isRunning},
+        {"destination", v.profile.destination + ":" + std::to_string(v.profile.port)},
+        {"packet-size", v.profile.packetSize},
+        {"rate", v.profile.rate},
+        {"burst", v.profile.burst},
+        {"packets", v.packets},
+        {"skipped", v.skipped},
+        {"octets", v.octets},
+        {"throughput-kbps", Throughput(v.octets, v.lastTime - v.startTime)},
+    });
+}
+
+Json ToJson(const DownlinkTraffic &v, const UplinkTraffic &uplink)
+{
+    Json json = Json::Obj({
+        {"packets", v.packets},
+        {"octets", v.octets},
+        {"throughput-kbps", Throughput(v.octets, (v.lastTime - v.firstTime) / 1000)},
+        {"tagged-packets", v.taggedPackets},
+        // Packets still in flight are counted as lost while the generator is running
+        {"lost", std::max(uplink.packets - v.taggedPackets, int64_t{0})},
+    });
+
+    if (v.taggedPackets > 0)
+    {
+        json.put("reordered", v.reordered);
+        json.put("rtt-min-us", v.rttMin);
+        json.put("rtt-avg-us", v.rttSum / v.taggedPackets);
+        json.put("rtt-max-us", v.rttMax);
+    }
+    return json;
+}
+
+} // namespace nr::ue
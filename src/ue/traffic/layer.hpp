@@ -0,0 +1,106 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <ue/types.hpp>
+#include <utils/json.hpp>
+
+namespace nr::ue
+{
+
+struct TrafficProfile
+{
+    std::string destination{}; // IPv4 address
+    uint16_t port{};
+    int packetSize{}; // Size of the IP packets in octets
+    int rate{};       // Packets per second
+    int burst{};      // Packets sent back to back at each transmission opportunity
+    int duration{};   // Seconds, 0 if the traffic runs until it is stopped
+};
+
+struct UplinkTraffic
+{
+    bool isRunning{};
+    TrafficProfile profile{};
+    std::array<uint8_t, 4> source{};
+    std::array<uint8_t, 4> destination{};
+
+    int64_t startTime{}; // Milliseconds
+    int64_t endTime{};   // Milliseconds, 0 if there is no end
+    int64_t lastTime{};  // Milliseconds
+    int64_t scheduled{}; // Packets that are due since the start, including the skipped ones
+
+    uint64_t sequence{};
+    int64_t packets{};
+    int64_t skipped{}; // Packets not sent since they were due beyond the bound of a late tick
+    int64_t octets{};
+};
+
+struct DownlinkTraffic
+{
+    int64_t packets{};
+    int64_t octets{};
+    int64_t firstTime{}; // Microseconds
+    int64_t lastTime{};  // Microseconds
+
+    // Packets of the traffic generator echoed back, which carry their sequence number and the time the UE sent them.
+    // Hence the measured delay is a round trip time including the echoing side, not a one-way latency.
+    int64_t taggedPackets{};
+    int64_t maxSequence{-1};
+    int64_t reordered{};
+    int64_t rttMin{};
+    int64_t rttMax{};
+    int64_t rttSum{};
+};
+
+/*
+ * Generates synthetic IPv4/UDP uplink traffic on the PDU sessions, and measures the downlink traffic of the sessions.
+ * Packets are injected into NAS directly, hence no TUN interface or privilege is needed. Each generated packet carries
+ * a sequence number and its send time. The receiving side (e.g. an echoing UPF) can measure the loss of the packets it
+ * gets, and this layer measures the loss and the round trip time of the tagged packets echoed back in downlink.
+ */
+class TrafficLayer
+{
+  private:
+    UeTask *m_ue;
+    std::array<UplinkTraffic, 16> m_uplink;
+    std::array<DownlinkTraffic, 16> m_downlink;
+    int m_runningCount;
+
+    friend class UeCmdHandler;
+
+  public:
+    explicit TrafficLayer(UeTask *ue);
+
+  public:
+    /* Starts the generator on the PDU session and resets its statistics */
+    bool start(int psi, const TrafficProfile &profile, std::string &outError);
+    void stop(int psi);
+
+    void handleDownlinkData(int psi, const uint8_t *buffer, size_t size);
+
+    /* Sends the packets which are due */
+    void onTick(int64_t current);
+    /* Time of the next transmission opportunity in milliseconds, or -1 if no generator is running */
+    [[nodiscard]] int64_t nextDeadline() const;
+
+  private:
+    void sendPacket(int psi, UplinkTraffic &traffic);
+};
+
+Json ToJson(const UplinkTraffic &v);
+/* The loss is counted against the packets sent by the generator of the same PDU session */
+Json ToJson(const DownlinkTraffic &v, const UplinkTraffic &uplink);
+
+} // namespace nr::ue
@@ -13,12 +13,19 @@ namespace nr::ue
 {
 
 NasTimers::NasTimers()
-    : t3346(3346, true, INT32_MAX), t3396(3396, false, INT32_MAX), t3444(3444, true, 12 * 60 * 60),
+    : queue{}, t3346(3346, true, INT32_MAX), t3396(3396, false, INT32_MAX), t3444(3444, true, 12 * 60 * 60),
       t3445(3445, true, 12 * 60 * 60), t3502(3502, true, 12 * 60), t3510(3510, true, 15), t3511(3511, true, 10),
       t3512(3512, true, 54 * 60), t3516(3516, true, 30), t3517(3517, true, 15), t3519(3519, true, 60),
       t3520(3520, true, 15), t3521(3521, true, 15), t3525(3525, true, 60), t3540(3540, true, 10),
       t3584(3584, false, INT32_MAX), t3585(3585, false, INT32_MAX)
 {
+    UeTimer *const arr[] = {
+        &t3346, &t3396, &t3444, &t3445, &t3502, &t3510, &t3511, &t3512, &t3516,
+        &t3517, &t3519, &t3520, &t3521, &t3525, &t3540, &t3584, &t3585,
+    };
+
+    for (auto *timer : arr)
+        timer->attach(&queue);
 }
 
 Json ToJson(const ECmState &state)
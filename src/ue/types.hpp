@@ -12,13 +12,15 @@
 
 #include <array>
 #include <atomic>
-#include <deque>
 #include <memory>
 #include <queue>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
+#include <lib/capture/capture.hpp>
 #include <lib/nas/nas.hpp>
+#include <lib/rls/rls_rlc.hpp>
 #include <utils/common_types.hpp>
 #include <utils/json.hpp>
 #include <utils/locked.hpp>
@@ -35,14 +37,14 @@ struct UeCellDesc
 {
     int dbm{};
 
-    struct
+    struct Mib
     {
         bool hasMib = false;
         bool isBarred = true;
         bool isIntraFreqReselectAllowed = true;
     } mib{};
 
-    struct
+    struct Sib1
     {
         bool hasSib1 = false;
         bool isReserved = false;
@@ -100,6 +102,8 @@ struct UeConfig
     IntegrityMaxDataRateConfig integrityMaxRate{};
     NetworkSlice defaultConfiguredNssai{};
     NetworkSlice configuredNssai{};
+    rls::RlcBearerConfig rlc{};
+    capture::CaptureConfig capture{}; // Shared by the UEs of the process
 
     struct
     {
@@ -118,9 +122,11 @@ struct UeConfig
     } uacAcc;
 
     /* Assigned by program */
+    int index{}; // 1-based index of the UE in the process
     bool configureRouting{};
     bool prefixLogger{};
     bool disableCmd{};
+    std::optional<std::string> contextDir{}; // Directory of the persisted security context files
 
     [[nodiscard]] std::string getNodeName() const
     {
@@ -192,6 +198,8 @@ struct RrcTimers
 
 struct NasTimers
 {
+    UeTimerQueue queue; // Declared first, the timers are removed from the queue on destruction
+
     UeTimer t3346; /* MM - ... */
     UeTimer t3396; /* SM - ... */
 
@@ -398,7 +406,10 @@ struct NasSecurityContext
     nas::ETypeOfIntegrityProtectionAlgorithm integrity{};
     nas::ETypeOfCipheringAlgorithm ciphering{};
 
-    std::deque<int> lastNasSequenceNums{};
+    std::vector<int> lastNasSequenceNums{}; // At most 16, a deque would allocate a 512 byte block per context
+
+    // Uplink count stored in the persisted context, the context is persisted again before this count is used
+    uint32_t persistedUplinkCount{};
 
     void updateDownlinkCount(const NasCount &validatedCount)
     {
@@ -454,6 +465,7 @@ struct NasSecurityContext
         ctx.integrity = integrity;
         ctx.ciphering = ciphering;
         ctx.lastNasSequenceNums = lastNasSequenceNums;
+        ctx.persistedUplinkCount = persistedUplinkCount;
         return ctx;
     }
 };
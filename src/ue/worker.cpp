@@ -0,0 +1,166 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "worker.hpp"
+#include "task.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+static constexpr const uint32_t WAKE_TAG = std::numeric_limits<uint32_t>::max();
+static constexpr const uint32_t STOP_TAG = std::numeric_limits<uint32_t>::max() - 1;
+static constexpr const int MAX_EVENTS = 64;
+
+static std::atomic<int> g_workerCount{};
+
+// Shared by all workers and never read, so that it stays readable for all of them once the stop is requested
+static std::atomic<int> g_stopFd{-1};
+static std::atomic<bool> g_stopRequested{};
+
+namespace nr::ue
+{
+
+UeWorker::UeWorker(std::vector<std::unique_ptr<UeTask>> &&ues) : m_ues{std::move(ues)}, m_poller{}, m_wakeFd{-1}
+{
+    if (utils::IsVirtualTime())
+    {
+        m_wakeFd = eventfd(0, EFD_CLOEXEC);
+        if (m_wakeFd < 0)
+            throw std::runtime_error("eventfd could not be created");
+        m_poller.add(m_wakeFd, WAKE_TAG);
+
+        int wakeFd = m_wakeFd;
+        m_clockWaiter = std::make_unique<ClockWaiter>([wakeFd]() {
+            uint64_t value = 1;
+            (void)::write(wakeFd, &value, sizeof(value));
+        });
+    }
+
+    // The workers are created by the main thread
+    if (g_stopFd.load() < 0)
+    {
+        int stopFd = eventfd(0, EFD_CLOEXEC);
+        if (stopFd < 0)
+            throw std::runtime_error("eventfd could not be created");
+        g_stopFd.store(stopFd);
+    }
+    m_poller.add(g_stopFd.load(), STOP_TAG);
+
+    g_workerCount++;
+}
+
+UeWorker::~UeWorker()
+{
+    // The wake up function must not be called after the wake fd is closed
+    m_clockWaiter = nullptr;
+    if (m_wakeFd >= 0)
+        ::close(m_wakeFd);
+
+    g_workerCount--;
+}
+
+int UeWorker::InstanceCount()
+{
+    return g_workerCount;
+}
+
+void UeWorker::RequestStop()
+{
+    g_stopRequested.store(true);
+
+    int stopFd = g_stopFd.load();
+    if (stopFd >= 0)
+    {
+        uint64_t value = 1;
+        (void)::write(stopFd, &value, sizeof(value));
+    }
+}
+
+void UeWorker::run()
+{
+    for (size_t i = 0; i < m_ues.size(); i++)
+    {
+        m_ues[i]->onStart();
+        m_ues[i]->fdBase->attach(&m_poller, static_cast<uint32_t>(i));
+    }
+
+    size_t running = m_ues.size();
+    uint32_t tags[MAX_EVENTS];
+
+    while (running > 0)
+    {
+        if (g_stopRequested.load(std::memory_order_relaxed))
+        {
+            for (size_t i = 0; i < m_ues.size(); i++)
+                if (m_ues[i] != nullptr)
+                    stopUe(i);
+            break;
+        }
+
+        int64_t current = utils::CurrentTimeMillis();
+        int64_t deadline = std::numeric_limits<int64_t>::max();
+
+        for (size_t i = 0; i < m_ues.size(); i++)
+        {
+            auto &ue = m_ues[i];
+            if (ue == nullptr)
+                continue;
+
+            if (ue->nextDeadline() <= current && ue->performWork())
+            {
+                stopUe(i);
+                running--;
+                continue;
+            }
+
+            deadline = std::min(deadline, ue->nextDeadline());
+        }
+
+        if (running == 0)
+            break;
+
+        int timeout = static_cast<int>(std::max(deadline - utils::CurrentTimeMillis(), int64_t{0}));
+
+        if (m_clockWaiter)
+            m_clockWaiter->beginIdle(utils::CurrentTimeMillis() + timeout);
+        int n = m_poller.wait(tags, MAX_EVENTS, timeout);
+        if (m_clockWaiter)
+            m_clockWaiter->endIdle();
+
+        for (int i = 0; i < n; i++)
+        {
+            if (tags[i] == WAKE_TAG)
+            {
+                // The virtual clock jumped over the deadline of a UE
+                uint64_t value;
+                (void)::read(m_wakeFd, &value, sizeof(value));
+            }
+            else if (tags[i] == STOP_TAG)
+            {
+                // Handled at the beginning of the loop
+            }
+            else if (m_ues[tags[i]] != nullptr)
+            {
+                m_ues[tags[i]]->handleReadyFds();
+            }
+        }
+    }
+}
+
+void UeWorker::stopUe(size_t index)
+{
+    m_ues[index]->onQuit();
+    m_ues[index] = nullptr;
+}
+
+} // namespace nr::ue
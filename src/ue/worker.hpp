@@ -0,0 +1,55 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <utils/clock.hpp>
+#include <utils/fd_base.hpp>
+
+namespace nr::ue
+{
+
+class UeTask;
+
+/*
+ * Runs several UEs on one thread. The fds of all UEs are waited on with a single epoll instance, and the thread sleeps
+ * until the earliest deadline among the UEs or an fd event.
+ */
+class UeWorker
+{
+  private:
+    std::vector<std::unique_ptr<UeTask>> m_ues;
+    FdPoller m_poller;
+    int m_wakeFd;
+    std::unique_ptr<ClockWaiter> m_clockWaiter; // Only in virtual time mode
+
+  public:
+    explicit UeWorker(std::vector<std::unique_ptr<UeTask>> &&ues);
+    ~UeWorker();
+
+    UeWorker(const UeWorker &) = delete;
+    UeWorker &operator=(const UeWorker &) = delete;
+
+    /* Number of worker threads in the process */
+    static int InstanceCount();
+
+    /* Makes all workers stop their UEs as if they were switched off, async-signal-safe */
+    static void RequestStop();
+
+  public:
+    /* Returns when all UEs are switched off, or when the stop is requested */
+    void run();
+
+  private:
+    void stopUe(size_t index);
+};
+
+} // namespace nr::ue
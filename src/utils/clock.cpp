@@ -0,0 +1,349 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#include "clock.hpp"
+#include "common.hpp"
+#include "constants.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr const int IDLE_GRACE_PERIOD = 5;
+static constexpr const int POLL_PERIOD = 1;
+static constexpr const int MAX_PROCESSES = 256;
+
+namespace
+{
+
+/* Idle state of one process, published to the other processes sharing the clock */
+struct SharedSlot
+{
+    std::atomic<int32_t> pid;
+    std::atomic<int32_t> idle;     // All the waiters of the process are idle
+    std::atomic<int64_t> deadline; // Earliest deadline among the waiters of the process
+};
+
+/* Mapped from the virtual clock file by all the processes of the user in virtual time mode */
+struct SharedClock
+{
+    std::atomic<int64_t> offset;
+    std::atomic<uint64_t> generation; // Incremented in every state change of any process
+    SharedSlot slots[MAX_PROCESSES];
+};
+
+static_assert(std::atomic<int64_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free);
+
+bool IsAlive(int32_t pid)
+{
+    return pid != 0 && (::kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+/* The file is per user, so that no other user can move the clock of the nodes */
+std::string VirtualClockPath()
+{
+    const char *runtimeDir = ::getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir != nullptr && runtimeDir[0] == '/')
+        return std::string{runtimeDir} + "/" + cons::VIRTUAL_CLOCK_FILE;
+    return std::string{"/tmp/"} + cons::VIRTUAL_CLOCK_FILE + "." + std::to_string(::getuid());
+}
+
+SharedClock *AttachSharedClock(SharedSlot *&slot)
+{
+    std::string path = VirtualClockPath();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+    if (fd < 0)
+        throw std::runtime_error("Virtual clock file could not be opened: " + path);
+
+    // A file planted by another user in a shared directory is not used
+    struct stat st = {};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != ::getuid() || (st.st_mode & 0077) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Virtual clock file is not a private file of the user: " + path);
+    }
+
+    // The file is locked while the slots are assigned, the clock itself is only accessed with atomic operations
+    ::flock(fd, LOCK_EX);
+    if (::ftruncate(fd, sizeof(SharedClock)) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Virtual clock file could not be resized");
+    }
+    void *mapping = ::mmap(nullptr, sizeof(SharedClock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        ::close(fd);
+        throw std::runtime_error("Virtual clock file could not be mapped");
+    }
+    auto *clock = static_cast<SharedClock *>(mapping);
+
+    bool anyAlive = false;
+    slot = nullptr;
+    for (auto &item : clock->slots)
+    {
+        if (IsAlive(item.pid.load()))
+            anyAlive = true;
+        else if (slot == nullptr)
+            slot = &item;
+    }
+    if (slot == nullptr)
+    {
+        ::close(fd);
+        throw std::runtime_error("Too many processes are sharing the virtual clock");
+    }
+
+    // A new run starts from the real time
+    if (!anyAlive)
+        clock->offset.store(0);
+
+    // The process holds back the clock until its tasks are idle
+    slot->idle.store(0);
+    slot->deadline.store(std::numeric_limits<int64_t>::max());
+    slot->pid.store(static_cast<int32_t>(::getpid()));
+    clock->generation++;
+
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+    return clock;
+}
+
+} // namespace
+
+static SharedClock *g_shared = nullptr;
+
+struct VirtualClock
+{
+    std::mutex mutex{};
+    std::condition_variable cv{};
+    std::vector<ClockWaiter *> waiters{}; // Registered waiters
+    int busyCount{};
+    SharedSlot *slot{};
+
+    /* Publishes the idle state of the process, must be called with the mutex held after every state change */
+    void publish()
+    {
+        int64_t deadline = std::numeric_limits<int64_t>::max();
+        for (auto *waiter : waiters)
+            deadline = std::min(deadline, waiter->m_deadline);
+
+        slot->deadline.store(deadline);
+        slot->idle.store(busyCount == 0 && !waiters.empty() ? 1 : 0);
+        g_shared->generation++;
+        cv.notify_all();
+    }
+
+    void setBusy(ClockWaiter *waiter)
+    {
+        if (waiter->m_registered && waiter->m_idle)
+        {
+            waiter->m_idle = false;
+            busyCount++;
+        }
+        publish();
+    }
+
+    /* Earliest deadline among all the processes, or nullopt if any of them is busy */
+    static std::optional<int64_t> globalDeadline()
+    {
+        int64_t deadline = std::numeric_limits<int64_t>::max();
+        for (auto &item : g_shared->slots)
+        {
+            int32_t pid = item.pid.load();
+            if (pid == 0)
+                continue;
+            if (!IsAlive(pid))
+            {
+                // The slot of a process that was killed
+                item.pid.compare_exchange_strong(pid, 0);
+                continue;
+            }
+            if (item.idle.load() == 0)
+                return std::nullopt;
+            deadline = std::min(deadline, item.deadline.load());
+        }
+        return deadline;
+    }
+
+    /* Wakes the idle waiters whose deadlines are passed, e.g. after a jump made by another process */
+    void wakeExpired(std::unique_lock<std::mutex> &lock)
+    {
+        int64_t current = utils::CurrentTimeMillis();
+
+        std::vector<ClockWaiter *> woken{};
+        for (auto *waiter : waiters)
+        {
+            if (waiter->m_idle && waiter->m_deadline <= current)
+            {
+                waiter->m_idle = false;
+                waiter->m_pendingWakeUps++;
+                busyCount++;
+                woken.push_back(waiter);
+            }
+        }
+        if (woken.empty())
+            return;
+        publish();
+
+        // The wake up functions may lock the mutex of the task, which is held while entering the idle state
+        lock.unlock();
+        for (auto *waiter : woken)
+            waiter->m_wakeUp();
+        lock.lock();
+
+        for (auto *waiter : woken)
+            waiter->m_pendingWakeUps--;
+        cv.notify_all();
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        int64_t lastOffset = g_shared->offset.load();
+        uint64_t lastGeneration = g_shared->generation.load();
+        auto quietSince = std::chrono::steady_clock::now();
+
+        while (true)
+        {
+            cv.wait_for(lock, std::chrono::milliseconds(POLL_PERIOD));
+
+            int64_t offset = g_shared->offset.load();
+            if (offset != lastOffset)
+            {
+                lastOffset = offset;
+                wakeExpired(lock);
+            }
+
+            // The grace period is restarted if any task of any process changes its state meanwhile
+            uint64_t generation = g_shared->generation.load();
+            auto now = std::chrono::steady_clock::now();
+            if (generation != lastGeneration)
+            {
+                lastGeneration = generation;
+                quietSince = now;
+                continue;
+            }
+            if (busyCount != 0 || now - quietSince < std::chrono::milliseconds(IDLE_GRACE_PERIOD))
+                continue;
+
+            auto deadline = globalDeadline();
+            if (!deadline.has_value())
+                continue;
+
+            // Only one of the processes makes the jump, and only if nothing changed since the state was read
+            int64_t delta = *deadline - utils::CurrentTimeMillis();
+            if (delta > 0 && g_shared->generation.compare_exchange_strong(generation, generation + 1))
+                g_shared->offset += delta;
+        }
+    }
+};
+
+static VirtualClock *g_clock = nullptr;
+
+void utils::EnableVirtualTime()
+{
+    if (g_clock != nullptr)
+        return;
+
+    SharedSlot *slot = nullptr;
+    g_shared = AttachSharedClock(slot);
+
+    g_clock = new VirtualClock();
+    g_clock->slot = slot;
+    std::thread{[]() { g_clock->run(); }}.detach();
+}
+
+bool utils::IsVirtualTime()
+{
+    return g_clock != nullptr;
+}
+
+int64_t utils::VirtualTimeOffset()
+{
+    return g_shared == nullptr ? 0 : g_shared->offset.load(std::memory_order_relaxed);
+}
+
+ClockWaiter::ClockWaiter(std::function<void()> wakeUp)
+    : m_wakeUp{std::move(wakeUp)}, m_deadline{}, m_registered{}, m_idle{}, m_pendingWakeUps{}
+{
+}
+
+ClockWaiter::~ClockWaiter()
+{
+    if (g_clock == nullptr)
+        return;
+
+    std::unique_lock<std::mutex> lock(g_clock->mutex);
+    g_clock->cv.wait(lock, [this] { return m_pendingWakeUps == 0; });
+
+    if (m_registered)
+    {
+        if (!m_idle)
+            g_clock->busyCount--;
+        auto &waiters = g_clock->waiters;
+        waiters.erase(std::remove(waiters.begin(), waiters.end(), this), waiters.end());
+    }
+    g_clock->publish();
+}
+
+void ClockWaiter::beginIdle(int64_t deadline)
+{
+    if (g_clock == nullptr)
+        return;
+
+    std::unique_lock<std::mutex> lock(g_clock->mutex);
+    if (!m_registered)
+    {
+        m_registered = true;
+        g_clock->waiters.push_back(this);
+    }
+    else if (!m_idle)
+    {
+        g_clock->busyCount--;
+    }
+
+    m_idle = true;
+    m_deadline = deadline;
+    g_clock->publish();
+}
+
+void ClockWaiter::endIdle()
+{
+    if (g_clock == nullptr)
+        return;
+
+    std::unique_lock<std::mutex> lock(g_clock->mutex);
+    g_clock->setBusy(this);
+}
+
+void ClockWaiter::notifyEvent()
+{
+    if (g_clock == nullptr)
+        return;
+
+    std::unique_lock<std::mutex> lock(g_clock->mutex);
+    g_clock->setBusy(this);
+}
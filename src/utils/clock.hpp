@@ -0,0 +1,69 @@
+//
+// This file is a part of UERANSIM open source project.
+// Copyright (c) 2021 ALİ GÜNGÖR.
+//
+// The software and all associated files are licensed under GPL-3.0
+// and subject to the terms and conditions defined in LICENSE file.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace utils
+{
+
+/*
+ * Switches the protocol clock (utils::CurrentTimeMillis) of the process to virtual time. The clock still advances in
+ * real time, but whenever all the tasks waiting on it have been idle for a short grace period, it jumps forward to the
+ * earliest deadline among them. The grace period lets the messages in flight from other processes arrive before the
+ * jump. Must be called before any task is created.
+ *
+ * The virtual clock is shared by all the processes of the user in virtual time mode on the host, e.g. nr-core, nr-gnb
+ * and nr-ue, through a memory mapped file in $XDG_RUNTIME_DIR, or in /tmp with the user ID in its name. A jump is only
+ * made when the tasks of all of them are idle, and the clock of each node advances by the same amount, so that the
+ * timeouts between the nodes, e.g. the RLS heartbeats, keep working. The processes in real time mode are not taken
+ * into account, hence the nodes of a setup must all be in the same mode. Throws if the shared clock cannot be attached
+ * to.
+ */
+void EnableVirtualTime();
+
+bool IsVirtualTime();
+
+/* Total amount of time skipped by the virtual clock in milliseconds, always 0 in real time mode */
+int64_t VirtualTimeOffset();
+
+} // namespace utils
+
+/*
+ * Idle state of a task as seen by the virtual clock. A task is taken into account after its first wait, so the tasks
+ * blocked in other calls do not prevent the clock from advancing. Only used in virtual time mode.
+ */
+class ClockWaiter
+{
+  private:
+    std::function<void()> m_wakeUp;
+    int64_t m_deadline;
+    bool m_registered;
+    bool m_idle;
+    int m_pendingWakeUps;
+
+    friend struct VirtualClock;
+
+  public:
+    /* The wake up function is called from the clock thread when the clock jumps over the deadline of the task */
+    explicit ClockWaiter(std::function<void()> wakeUp);
+    ~ClockWaiter();
+
+    ClockWaiter(const ClockWaiter &) = delete;
+    ClockWaiter &operator=(const ClockWaiter &) = delete;
+
+  public:
+    /* Called before blocking until the given time of the protocol clock, or until an event is received */
+    void beginIdle(int64_t deadline);
+    /* Called after waking up */
+    void endIdle();
+    /* Called by other threads delivering an event to the task, so that the clock does not jump until it is handled */
+    void notifyEvent();
+};
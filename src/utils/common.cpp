@@ -7,6 +7,7 @@
 //
 
 #include "common.hpp"
+#include "clock.hpp"
 #include "constants.hpp"
 
 #include <algorithm>
@@ -149,7 +150,8 @@ int utils::NextId()
 int64_t utils::CurrentTimeMillis()
 {
     return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
-        .count();
+               .count() +
+           VirtualTimeOffset();
 }
 
 int64_t utils::CurrentTimeMicros()
@@ -216,10 +218,15 @@ OctetString utils::IpToOctetString(const std::string &address)
 
 std::string utils::VectorToHexString(const std::vector<uint8_t> &hex)
 {
-    std::string str(hex.size() * 2, '0');
-    for (size_t i = 0; i < hex.size(); i++)
+    return ArrayToHexString(hex.data(), hex.size());
+}
+
+std::string utils::ArrayToHexString(const uint8_t *data, size_t length)
+{
+    std::string str(length * 2, '0');
+    for (size_t i = 0; i < length; i++)
     {
-        uint8_t octet = hex[i];
+        uint8_t octet = data[i];
         int big = (octet >> 4) & 0xF;
         int little = octet & 0xF;
 
@@ -369,3 +376,13 @@ std::string utils::CopyrightDeclarationCli()
     return std::string{cons::Name} + " | " + cons::DescriptionCli + " | Copyright (c) " + std::to_string(year) + " " +
            cons::Owner;
 }
+
+std::string utils::CopyrightDeclarationCore()
+{
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    auto parts = std::localtime(&now);
+    auto year = 1900 + parts->tm_year;
+
+    return std::string{cons::Name} + " | " + cons::DescriptionCore + " | Copyright (c) " + std::to_string(year) + " " +
+           cons::Owner;
+}
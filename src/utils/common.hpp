@@ -24,10 +24,11 @@ namespace utils
 
 std::vector<uint8_t> HexStringToVector(const std::string &hex);
 std::string VectorToHexString(const std::vector<uint8_t> &hex);
+std::string ArrayToHexString(const uint8_t *data, size_t length);
 int GetIpVersion(const std::string &address);
 OctetString IpToOctetString(const std::string &address);
 std::string OctetStringToIp(const OctetString &address);
-int64_t CurrentTimeMillis();
+int64_t CurrentTimeMillis(); // Follows the virtual clock if enabled, see clock.hpp
 int64_t CurrentTimeMicros();
 int64_t CurrentTimeNanos();
 TimeStamp CurrentTimeStamp();
@@ -46,6 +47,7 @@ bool IsLittleEndian();
 std::string CopyrightDeclarationUe();
 std::string CopyrightDeclarationGnb();
 std::string CopyrightDeclarationCli();
+std::string CopyrightDeclarationCore();
 
 template <typename T>
 inline void ClearAndDelete(std::vector<T *> &vector)
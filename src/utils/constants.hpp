@@ -23,6 +23,8 @@ struct cons
     static constexpr const char *DescriptionUe = "5G-SA UE implementation";
     static constexpr const char *DescriptionGnb = "5G-SA gNB implementation";
     static constexpr const char *DescriptionCli = "Command Line Interface";
+    static constexpr const char *DescriptionBench = "Micro-benchmarks and end-to-end benchmarks";
+    static constexpr const char *DescriptionCore = "Mock 5G core (AMF and UPF) for closed-loop benchmarking";
 
     // Some port values
     static constexpr const uint16_t GtpPort = 2152;
@@ -42,4 +44,7 @@ struct cons
     static constexpr const char *PROC_TABLE_DIR = "/tmp/UERANSIM.proc-table/"; // todo remove
     static constexpr const char *PROCESS_DIR = "/proc/";                       // todo remove
     static constexpr const char *CLI_SOCKET_DIR = "/tmp/UERANSIM.cli-ipc/";
+    static constexpr const char *CLI_PROCESS_PREFIX = "ue-process."; // Sockets of the bulk commands of UE processes
+    static constexpr const char *CLI_FAN_OUT_PREFIX = "ue-fan-out."; // Sockets of the UE processes towards their UEs
+    static constexpr const char *VIRTUAL_CLOCK_FILE = "UERANSIM.virtual-clock"; // See utils::EnableVirtualTime
 };
@@ -11,6 +11,8 @@
 #include <algorithm>
 #include <cstring>
 #include <stdexcept>
+#include <poll.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -23,17 +25,50 @@ static std::string GetErrorMessage(const std::string &cause)
     return what;
 }
 
-static timeval MakeTimeVal(int timeout)
+FdPoller::FdPoller() : m_epollFd{epoll_create1(EPOLL_CLOEXEC)}
 {
-    timeval to{};
-    to.tv_sec = timeout / 1000;
-    to.tv_usec = (timeout % 1000) * 1000;
-    return to;
+    if (m_epollFd < 0)
+        throw std::runtime_error(GetErrorMessage("epoll could not be created"));
 }
 
-FdBase::FdBase(int timeout)
-    : m_fd{}, m_dice{}, m_timeout{timeout}, m_timevalCache{MakeTimeVal(timeout)}, m_fdSetCache{}, m_maxFdCache{},
-      m_minFdSize{}
+FdPoller::~FdPoller()
+{
+    ::close(m_epollFd);
+}
+
+void FdPoller::add(int fd, uint32_t tag)
+{
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u32 = tag;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+        throw std::runtime_error(GetErrorMessage("fd could not be added to epoll"));
+}
+
+void FdPoller::setWritable(int fd, uint32_t tag, bool writable)
+{
+    epoll_event event{};
+    event.events = writable ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    event.data.u32 = tag;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &event) < 0)
+        throw std::runtime_error(GetErrorMessage("fd could not be modified in epoll"));
+}
+
+void FdPoller::remove(int fd)
+{
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int FdPoller::wait(uint32_t *tags, int maxCount, int timeout)
+{
+    epoll_event events[64];
+    int n = epoll_wait(m_epollFd, events, std::min(maxCount, 64), timeout);
+    for (int i = 0; i < n; i++)
+        tags[i] = events[i].data.u32;
+    return std::max(n, 0);
+}
+
+FdBase::FdBase() : m_fd{}, m_dice{}, m_minFdSize{}, m_poller{}, m_pollerTag{}
 {
     for (auto &fd : m_fd)
         fd = -1;
@@ -44,7 +79,11 @@ FdBase::~FdBase()
     for (auto &fd : m_fd)
     {
         if (fd >= 0)
+        {
+            if (m_poller)
+                m_poller->remove(fd);
             ::close(fd);
+        }
         fd = -1;
     }
 }
@@ -58,15 +97,22 @@ void FdBase::allocate(int id, int fd)
         throw std::runtime_error{"FdBase existing id"};
 
     m_fd[id] = fd;
-    updateFdSetCache();
+    updateMinFdSize();
+
+    if (m_poller)
+        m_poller->add(fd, m_pollerTag);
 }
 
 void FdBase::release(int id)
 {
     if (m_fd[id] >= 0)
+    {
+        if (m_poller)
+            m_poller->remove(m_fd[id]);
         ::close(m_fd[id]);
+    }
     m_fd[id] = -1;
-    updateFdSetCache();
+    updateMinFdSize();
 }
 
 void FdBase::write(int id, const uint8_t *buffer, size_t size)
@@ -128,50 +174,44 @@ bool FdBase::contains(int id) const
     return m_fd[id] >= 0;
 }
 
-int FdBase::performSelect()
+void FdBase::attach(FdPoller *poller, uint32_t tag)
 {
-    fd_set fdSet = m_fdSetCache;
-    timeval to = m_timevalCache;
+    m_poller = poller;
+    m_pollerTag = tag;
+
+    for (int fd : m_fd)
+        if (fd >= 0)
+            m_poller->add(fd, m_pollerTag);
+}
 
-    int ret = select(m_maxFdCache, &fdSet, nullptr, nullptr, m_timeout <= 0 ? nullptr : &to);
-    if (ret < 0)
+int FdBase::performSelect(int timeout)
+{
+    // Negative fds of the unused ids are ignored by poll()
+    std::array<pollfd, SIZE> fds{};
+    for (size_t i = 0; i < m_minFdSize; i++)
+        fds[i] = pollfd{m_fd[i], POLLIN, 0};
+
+    int ret = poll(fds.data(), static_cast<nfds_t>(m_minFdSize), timeout < 0 ? -1 : timeout);
+    if (ret <= 0)
         return -1;
 
     size_t dice = m_dice++;
     for (size_t i = 0; i < m_minFdSize; i++)
     {
         size_t j = (dice + i) % m_minFdSize;
-        int fd = m_fd[j];
-        if (fd >= 0 && FD_ISSET(fd, &fdSet))
+        if (m_fd[j] >= 0 && (fds[j].revents & (POLLIN | POLLERR | POLLHUP)) != 0)
             return static_cast<int>(j);
     }
 
     return -1;
 }
 
-void FdBase::updateFdSetCache()
+void FdBase::updateMinFdSize()
 {
+    m_minFdSize = 0;
     for (size_t i = 0; i < SIZE; i++)
     {
         if (m_fd[i] >= 0)
             m_minFdSize = i + 1;
     }
-
-    int max = 0;
-
-    fd_set fdSet;
-    FD_ZERO(&fdSet);
-
-    for (size_t i = 0; i < m_minFdSize; i++)
-    {
-        int fd = m_fd[i];
-        if (fd >= 0)
-        {
-            FD_SET(fd, &fdSet);
-            max = std::max(max, fd);
-        }
-    }
-
-    m_maxFdCache = max + 1;
-    m_fdSetCache = fdSet;
 }
@@ -13,6 +13,29 @@
 #include <cstdint>
 #include <utils/network.hpp>
 
+/* epoll instance shared by the FdBase objects of a worker thread */
+class FdPoller
+{
+  private:
+    int m_epollFd;
+
+  public:
+    FdPoller();
+    ~FdPoller();
+
+    FdPoller(const FdPoller &) = delete;
+    FdPoller &operator=(const FdPoller &) = delete;
+
+  public:
+    void add(int fd, uint32_t tag);
+    void remove(int fd);
+    /* Also reports the fd when it becomes writable, until disabled again */
+    void setWritable(int fd, uint32_t tag, bool writable);
+
+    /* Waits at most 'timeout' milliseconds for ready fds, writes their tags and returns the number of them */
+    int wait(uint32_t *tags, int maxCount, int timeout);
+};
+
 class FdBase
 {
   public:
@@ -27,14 +50,12 @@ class FdBase
   private:
     std::array<int, SIZE> m_fd;
     size_t m_dice;
-    const int m_timeout;
-    const timeval m_timevalCache;
-    fd_set m_fdSetCache;
-    int m_maxFdCache;
     size_t m_minFdSize;
+    FdPoller *m_poller;
+    uint32_t m_pollerTag;
 
   public:
-    explicit FdBase(int timeout = 500);
+    FdBase();
     ~FdBase();
 
   public:
@@ -42,7 +63,14 @@ class FdBase
     void release(int id);
     [[nodiscard]] bool contains(int id) const;
 
-    int performSelect();
+    /* Adds the current and future fds to the poller, so that their readiness is reported with the given tag */
+    void attach(FdPoller *poller, uint32_t tag);
+
+    /*
+     * Waits at most 'timeout' milliseconds, or indefinitely if it is negative. Returns -1 if no fd is ready.
+     * Uses poll() rather than select(), since the fd numbers exceed FD_SETSIZE when many UEs run in the process.
+     */
+    int performSelect(int timeout);
 
     size_t read(int id, uint8_t *buffer, size_t size);
     void write(int id, const uint8_t *buffer, size_t size);
@@ -51,5 +79,5 @@ class FdBase
     void sendTo(int id, const uint8_t *buffer, size_t size, const InetAddress &address);
 
   private:
-    void updateFdSetCache();
+    void updateMinFdSize();
 };
\ No newline at end of file
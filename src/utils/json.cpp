@@ -8,7 +8,7 @@
 
 #include "json.hpp"
 
-#include <sstream>
+#include <cstdint>
 #include <utility>
 
 static std::string EscapeJson(const std::string &str)
@@ -52,111 +52,6 @@ static std::string EscapeJson(const std::string &str)
     return output;
 }
 
-static void AppendJson(const Json &json, std::stringstream &stream, int indentation)
-{
-    std::string indent(indentation, ' ');
-
-    switch (json.type())
-    {
-    case Json::Type::NULL_TYPE:
-        stream << "null";
-        break;
-    case Json::Type::STRING:
-        stream << "\"" << EscapeJson(json.str()) << "\"";
-        break;
-    case Json::Type::NUMBER:
-    case Json::Type::BOOL:
-        stream << json.str();
-        break;
-    case Json::Type::OBJECT: {
-        stream << "{\n";
-        int index = 0;
-        for (auto &item : json)
-        {
-            stream << indent << " " << item.first << ": ";
-            AppendJson(item.second, stream, indentation + 1);
-            if (index == json.itemCount() - 1)
-                stream << "\n";
-            else
-                stream << ",\n";
-            index++;
-        }
-        stream << indent << "}";
-        break;
-    }
-    case Json::Type::ARRAY: {
-        stream << "[\n";
-        int index = 0;
-        for (auto &item : json)
-        {
-            stream << indent << " ";
-            AppendJson(item.second, stream, indentation + 1);
-            if (index == json.itemCount() - 1)
-                stream << "\n";
-            else
-                stream << ",\n";
-            index++;
-        }
-        stream << indent << "]";
-        break;
-    }
-    }
-}
-
-static void AppendYaml(const Json &json, std::stringstream &stream, int indentation, bool initialIndentation)
-{
-    std::string indent(indentation, ' ');
-
-    switch (json.type())
-    {
-    case Json::Type::NULL_TYPE:
-        stream << "null";
-        break;
-    case Json::Type::STRING:
-    case Json::Type::NUMBER:
-    case Json::Type::BOOL:
-        stream << json.str(); // TODO: Escape YAML
-        break;
-    case Json::Type::OBJECT: {
-        int index = 0;
-        for (auto &item : json)
-        {
-            if (index > 0 || initialIndentation)
-                stream << indent;
-            stream << item.first << ": ";
-
-            int initialPos = -1;
-            if (item.second.isPrimitive())
-                AppendYaml(item.second, stream, indentation + 1, false);
-            else
-            {
-                stream << "\n";
-                initialPos = static_cast<int>(stream.tellp());
-                AppendYaml(item.second, stream, indentation + 1, true);
-            }
-            if (index != json.itemCount() - 1 && initialPos != stream.tellp())
-                stream << "\n";
-            index++;
-        }
-        break;
-    }
-    case Json::Type::ARRAY: {
-        int index = 0;
-        for (auto &item : json)
-        {
-            if (index > 0 || initialIndentation)
-                stream << indent;
-            stream << "- ";
-            AppendYaml(item.second, stream, indentation + 2, false);
-            if (index != json.itemCount() - 1)
-                stream << "\n";
-            index++;
-        }
-        break;
-    }
-    }
-}
-
 Json::Json() : m_type{Type::NULL_TYPE}
 {
 }
@@ -286,18 +181,23 @@ Json::const_iterator Json::end() const
     return m_children.end();
 }
 
+static std::string Dump(const Json &json, JsonWriter::Format format)
+{
+    std::string output{};
+    JsonWriter writer{format, [&output](std::string &&piece) { output += piece; }, SIZE_MAX};
+    writer.value(json);
+    writer.flush();
+    return output;
+}
+
 std::string Json::dumpJson() const
 {
-    std::stringstream ss{};
-    AppendJson(*this, ss, 0);
-    return ss.str();
+    return Dump(*this, JsonWriter::Format::JSON);
 }
 
 std::string Json::dumpYaml() const
 {
-    std::stringstream ss{};
-    AppendYaml(*this, ss, 0, false);
-    return ss.str();
+    return Dump(*this, JsonWriter::Format::YAML);
 }
 
 Json Json::Arr(std::initializer_list<Json> &&elements)
@@ -411,3 +311,171 @@ Json ToJson(int64_t v)
 {
     return v;
 }
+
+JsonWriter::JsonWriter(Format format, Sink sink, size_t flushSize)
+    : m_format{format}, m_sink{std::move(sink)}, m_flushSize{flushSize}, m_buffer{}, m_levels{}, m_key{}
+{
+}
+
+void JsonWriter::key(std::string key)
+{
+    m_key = std::move(key);
+}
+
+void JsonWriter::value(const Json &json)
+{
+    if (json.isObject())
+    {
+        beginObject();
+        for (auto &item : json)
+        {
+            key(item.first);
+            value(item.second);
+        }
+        end();
+    }
+    else if (json.isArray())
+    {
+        beginArray();
+        for (auto &item : json)
+            value(item.second);
+        end();
+    }
+    else
+    {
+        int indentation;
+        bool initialIndentation;
+        beginItem(false, indentation, initialIndentation);
+        writePrimitive(json);
+        flushIfFull();
+    }
+}
+
+void JsonWriter::beginObject()
+{
+    beginContainer(false);
+}
+
+void JsonWriter::beginArray()
+{
+    beginContainer(true);
+}
+
+void JsonWriter::end()
+{
+    if (m_levels.empty())
+        return;
+
+    Level level = m_levels.back();
+    m_levels.pop_back();
+
+    if (m_format == Format::JSON)
+    {
+        if (level.itemCount > 0)
+            m_buffer += '\n';
+        m_buffer.append(static_cast<size_t>(level.indentation), ' ');
+        m_buffer += level.isArray ? ']' : '}';
+    }
+    else if (level.itemCount == 0 && !m_levels.empty())
+    {
+        m_levels.back().lastItemEmpty = true;
+    }
+
+    flushIfFull();
+}
+
+void JsonWriter::flush()
+{
+    if (m_sink && !m_buffer.empty())
+        m_sink(std::move(m_buffer));
+    m_buffer.clear();
+}
+
+/* Writes what precedes the item in its parent, and determines the indentation of the item */
+void JsonWriter::beginItem(bool isContainer, int &indentation, bool &initialIndentation)
+{
+    indentation = 0;
+    initialIndentation = false;
+    if (m_levels.empty())
+        return;
+
+    Level &parent = m_levels.back();
+
+    if (m_format == Format::JSON)
+    {
+        if (parent.itemCount > 0)
+            m_buffer += ",\n";
+        m_buffer.append(static_cast<size_t>(parent.indentation), ' ');
+        m_buffer += ' ';
+        if (!parent.isArray)
+        {
+            m_buffer += '"';
+            m_buffer += EscapeJson(m_key);
+            m_buffer += "\": ";
+        }
+        indentation = parent.indentation + 1;
+    }
+    else
+    {
+        // An empty container writes nothing in YAML, hence no line break is needed after it
+        if (parent.itemCount > 0 && (parent.isArray || !parent.lastItemEmpty))
+            m_buffer += '\n';
+        if (parent.itemCount > 0 || parent.initialIndentation)
+            m_buffer.append(static_cast<size_t>(parent.indentation), ' ');
+
+        if (parent.isArray)
+        {
+            m_buffer += "- ";
+            indentation = parent.indentation + 2;
+        }
+        else
+        {
+            m_buffer += m_key;
+            m_buffer += ": ";
+            indentation = parent.indentation + 1;
+            if (isContainer)
+            {
+                m_buffer += '\n';
+                initialIndentation = true;
+            }
+        }
+    }
+
+    parent.itemCount++;
+    parent.lastItemEmpty = false;
+    m_key.clear();
+}
+
+void JsonWriter::beginContainer(bool isArray)
+{
+    Level level{};
+    level.isArray = isArray;
+    beginItem(true, level.indentation, level.initialIndentation);
+    m_levels.push_back(level);
+
+    if (m_format == Format::JSON)
+        m_buffer += isArray ? "[\n" : "{\n";
+}
+
+void JsonWriter::writePrimitive(const Json &json)
+{
+    if (json.isNull())
+        m_buffer += "null";
+    else if (json.isString() && m_format == Format::JSON)
+    {
+        m_buffer += '"';
+        m_buffer += EscapeJson(json.str());
+        m_buffer += '"';
+    }
+    else
+        m_buffer += json.str(); // TODO: Escape YAML
+}
+
+void JsonWriter::flushIfFull()
+{
+    if (m_sink && m_buffer.size() >= m_flushSize)
+    {
+        m_sink(std::move(m_buffer));
+        m_buffer.clear();
+    }
+}
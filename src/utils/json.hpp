@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <functional>
 #include <initializer_list>
 #include <map>
 #include <memory>
@@ -105,6 +106,62 @@ class Json
     [[nodiscard]] std::string dumpYaml() const;
 };
 
+/*
+ * Writes a JSON or YAML document progressively, without building a Json tree first. The output is identical to
+ * dumpJson() and dumpYaml() of the equivalent tree, and it is handed to the sink in pieces of about 'flushSize'
+ * octets, so that large documents can be sent while they are being produced.
+ *
+ * Items of an object are preceded by key(). Any Json value can be written as an item, e.g. one small object per
+ * element of a large array.
+ */
+class JsonWriter
+{
+  public:
+    enum class Format
+    {
+        JSON,
+        YAML,
+    };
+
+    using Sink = std::function<void(std::string &&piece)>;
+
+  private:
+    struct Level
+    {
+        bool isArray{};
+        int indentation{};
+        bool initialIndentation{};
+        int itemCount{};
+        bool lastItemEmpty{}; // The last item is an empty container, which writes nothing in YAML
+    };
+
+    Format m_format;
+    Sink m_sink;
+    size_t m_flushSize;
+    std::string m_buffer;
+    std::vector<Level> m_levels;
+    std::string m_key;
+
+  public:
+    JsonWriter(Format format, Sink sink, size_t flushSize = 16384);
+
+  public:
+    void key(std::string key);
+    void value(const Json &json);
+    void beginObject();
+    void beginArray();
+    void end();
+
+    /* Hands the rest of the output to the sink */
+    void flush();
+
+  private:
+    void beginItem(bool isContainer, int &indentation, bool &initialIndentation);
+    void beginContainer(bool isArray);
+    void writePrimitive(const Json &json);
+    void flushIfFull();
+};
+
 Json ToJson(std::nullptr_t);
 Json ToJson(bool v);
 Json ToJson(const std::string &v);
@@ -13,6 +13,7 @@
 
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <poll.h>
 #include <random>
 #include <stdexcept>
 #include <sys/socket.h>
@@ -149,27 +150,13 @@ void Socket::bind(const InetAddress &address) const
 
 int Socket::receive(uint8_t *buffer, size_t bufferSize, int timeoutMs, InetAddress &outAddress) const
 {
-    fd_set s1;
-    FD_ZERO(&s1);
-    FD_SET(fd, &s1);
-
-    // fd_set s2;
-    // FD_ZERO(&s2);
-    // FD_SET(fd, &s2);
-
-    fd_set s3;
-    FD_ZERO(&s3);
-    FD_SET(fd, &s3);
-
-    timeval timeout{};
-    timeout.tv_sec = timeoutMs / 1000;
-    timeout.tv_usec = (timeoutMs % 1000) * 1000;
-
-    int rc = select(fd + 1, &s1, /*&s2 no write operation for unnecessary selection */ nullptr, &s3, &timeout);
+    // poll() rather than select(), the fd may exceed FD_SETSIZE in a process running many UEs
+    pollfd pfd{fd, POLLIN, 0};
+    int rc = poll(&pfd, 1, timeoutMs);
     if (rc == -1)
-        throw LibError("select failed: ", errno);
+        throw LibError("poll failed: ", errno);
 
-    if (rc > 0 && FD_ISSET(fd, &s1))
+    if (rc > 0 && (pfd.revents & POLLIN) != 0)
     {
         sockaddr_storage peerAddr{};
         socklen_t peerAddrLen = sizeof(struct sockaddr_storage);
@@ -223,39 +210,23 @@ Socket Socket::CreateAndBindTcp(const InetAddress &address)
 bool Socket::Select(const std::vector<Socket> &inReadSockets, const std::vector<Socket> &inWriteSockets,
                     std::vector<Socket> &outReadSockets, std::vector<Socket> &outWriteSockets, int timeout)
 {
-    assert(inReadSockets.size() + inWriteSockets.size() < FD_SETSIZE);
-
-    int max = 0;
-
-    fd_set readFds, writeFds;
-    FD_ZERO(&readFds);
-    FD_ZERO(&writeFds);
-
+    std::vector<pollfd> fds{};
+    fds.reserve(inReadSockets.size() + inWriteSockets.size());
     for (const Socket &s : inReadSockets)
-    {
-        FD_SET(s.fd, &readFds);
-        max = std::max(max, s.fd);
-    }
-
+        fds.push_back(pollfd{s.fd, POLLIN, 0});
     for (const Socket &s : inWriteSockets)
-    {
-        FD_SET(s.fd, &writeFds);
-        max = std::max(max, s.fd);
-    }
+        fds.push_back(pollfd{s.fd, POLLOUT, 0});
 
-    timeval to{};
-    to.tv_sec = timeout / 1000;
-    to.tv_usec = (timeout % 1000) * 1000;
-
-    int ret = select(max + 1, &readFds, &writeFds, nullptr, timeout > 0 ? &to : nullptr);
+    int ret = poll(fds.data(), static_cast<nfds_t>(fds.size()), timeout > 0 ? timeout : -1);
     if (ret < 0)
         return false;
 
+    size_t i = 0;
     for (const Socket &s : inReadSockets)
-        if (FD_ISSET(s.fd, &readFds))
+        if ((fds[i++].revents & POLLIN) != 0)
             outReadSockets.push_back(s);
     for (const Socket &s : inWriteSockets)
-        if (FD_ISSET(s.fd, &writeFds))
+        if ((fds[i++].revents & POLLOUT) != 0)
             outWriteSockets.push_back(s);
 
     return outReadSockets.size() + outWriteSockets.size() > 0;
@@ -294,6 +265,12 @@ void Socket::setReuseAddress() const
         throw LibError("setsockopt SO_REUSEADDR failed: ", errno);
 }
 
+void Socket::setReceiveBufferSize(int size) const
+{
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) < 0)
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+}
+
 InetAddress Socket::getAddress() const
 {
     struct sockaddr_storage storage = {};
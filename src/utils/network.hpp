@@ -80,6 +80,8 @@ class Socket
 
     /* Socket options */
     void setReuseAddress() const;
+    /* Best effort, the size is limited by the system unless the process is privileged */
+    void setReceiveBufferSize(int size) const;
 
   public:
     static Socket CreateAndBindUdp(const InetAddress &address);
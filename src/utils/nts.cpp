@@ -11,6 +11,9 @@
 
 #include <stdexcept>
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #define WAIT_TIME_IF_NO_TIMER 500
 #define PAUSE_POLLING_PERIOD 20
 
@@ -53,6 +56,46 @@ int TimerBase::getAndRemoveExpiredTimer()
     return -1;
 }
 
+NtsTask::NtsTask()
+{
+    if (utils::IsVirtualTime())
+    {
+        clockWaiter = std::make_unique<ClockWaiter>([this]() {
+            // Makes sure that the task is either waiting or has not checked the timers yet
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+            }
+            cv.notify_one();
+        });
+    }
+}
+
+NtsTask::~NtsTask()
+{
+    if (wakeUpFd >= 0)
+        ::close(wakeUpFd);
+}
+
+int NtsTask::enableWakeUpFd()
+{
+    if (wakeUpFd < 0)
+    {
+        wakeUpFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeUpFd < 0)
+            throw std::runtime_error("eventfd could not be created");
+    }
+    return wakeUpFd;
+}
+
+void NtsTask::signalWakeUp()
+{
+    if (wakeUpFd >= 0)
+    {
+        uint64_t value = 1;
+        (void)::write(wakeUpFd, &value, sizeof(value));
+    }
+}
+
 bool NtsTask::push(std::unique_ptr<NtsMessage> &&msg)
 {
     if (isQuiting)
@@ -63,7 +106,10 @@ bool NtsTask::push(std::unique_ptr<NtsMessage> &&msg)
         msgQueue.push_back(std::move(msg));
     }
 
+    if (clockWaiter)
+        clockWaiter->notifyEvent();
     cv.notify_one();
+    signalWakeUp();
     return true;
 }
 
@@ -77,7 +123,10 @@ bool NtsTask::pushFront(std::unique_ptr<NtsMessage> &&msg)
         msgQueue.push_front(std::move(msg));
     }
 
+    if (clockWaiter)
+        clockWaiter->notifyEvent();
     cv.notify_one();
+    signalWakeUp();
     return true;
 }
 
@@ -99,7 +148,10 @@ bool NtsTask::setTimerAbsolute(int timerId, int64_t timeMs)
         timerBase.setTimerAbsolute(timerId, timeMs);
     }
 
+    if (clockWaiter)
+        clockWaiter->notifyEvent();
     cv.notify_one();
+    signalWakeUp();
     return true;
 }
 
@@ -144,7 +196,13 @@ std::unique_ptr<NtsMessage> NtsTask::poll(int64_t timeout)
             msgQueue.pop_front();
             return ret;
         }
-        cv.wait_for(lock, std::chrono::milliseconds(std::min(timerBase.getNextWaitTime(), timeout)));
+
+        int64_t waitTime = std::min(timerBase.getNextWaitTime(), timeout);
+        if (clockWaiter)
+            clockWaiter->beginIdle(utils::CurrentTimeMillis() + waitTime);
+        cv.wait_for(lock, std::chrono::milliseconds(waitTime));
+        if (clockWaiter)
+            clockWaiter->endIdle();
     }
 
     if (isQuiting)
@@ -210,6 +268,7 @@ void NtsTask::quit()
         return;
 
     cv.notify_one();
+    signalWakeUp();
 
     if (thread.joinable())
         thread.join();
@@ -229,7 +288,10 @@ void NtsTask::requestPause()
         throw std::runtime_error("NTS pause overflow");
 
     if (!isQuiting)
+    {
         cv.notify_one();
+        signalWakeUp();
+    }
 }
 
 void NtsTask::requestUnpause()
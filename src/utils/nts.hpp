@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "clock.hpp"
 #include "scoped_thread.hpp"
 
 #include <atomic>
@@ -42,6 +43,8 @@ enum class NtsMessageType
     GNB_RRC_TO_NGAP,
     GNB_NGAP_TO_GTP,
     GNB_SCTP,
+
+    CORE_AMF_TO_UPF,
 };
 
 struct NtsMessage
@@ -102,15 +105,17 @@ class NtsTask
     TimerBase timerBase{};
     std::mutex mutex{};
     std::condition_variable cv{};
+    std::unique_ptr<ClockWaiter> clockWaiter{}; // Only in virtual time mode
+    int wakeUpFd{-1};                           // Only for the tasks waiting on their own fds
     std::atomic_bool isQuiting{};
     std::atomic_int pauseReqCount{};
     std::atomic_bool pauseConfirmed{};
     std::thread thread;
 
   public:
-    NtsTask() = default;
+    NtsTask();
 
-    virtual ~NtsTask() = default;
+    virtual ~NtsTask();
 
     bool push(std::unique_ptr<NtsMessage> &&msg);
     bool pushFront(std::unique_ptr<NtsMessage> &&msg);
@@ -122,6 +127,16 @@ class NtsTask
     std::unique_ptr<NtsMessage> poll(int64_t timeout);
     std::unique_ptr<NtsMessage> take();
 
+    /*
+     * Creates an eventfd which becomes readable whenever a message or a timer is added to the task, or the task is
+     * asked to pause or quit. It lets a task wait on its own fds instead of the message queue, in which case the queue
+     * is read with poll() without a timeout. The task must read the fd to reset it.
+     */
+    int enableWakeUpFd();
+
+  private:
+    void signalWakeUp();
+
   protected:
     // Called exactly once after start() called and before onLoop() callbacks.
     virtual void onStart() = 0;
@@ -8,39 +8,89 @@
 
 #include "octet_string.hpp"
 #include "common.hpp"
+#include "octet_view.hpp"
 
+#include <algorithm>
 #include <cstring>
 
+static inline void Store2(uint8_t *p, uint16_t v)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap16(v);
+#endif
+    std::memcpy(p, &v, 2);
+}
+
+static inline void Store4(uint8_t *p, uint32_t v)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    std::memcpy(p, &v, 4);
+}
+
+static inline void Store8(uint8_t *p, uint64_t v)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    std::memcpy(p, &v, 8);
+}
+
+void OctetString::grow(int capacity)
+{
+    if (m_heap.empty())
+    {
+        std::vector<uint8_t> heap(static_cast<size_t>(capacity));
+        std::memcpy(heap.data(), m_inline, static_cast<size_t>(m_length));
+        m_heap.swap(heap);
+    }
+    else
+    {
+        m_heap.resize(static_cast<size_t>(capacity));
+    }
+}
+
+void OctetString::reserve(int capacity)
+{
+    if (capacity > this->capacity())
+        grow(capacity);
+}
+
 void OctetString::append(const OctetString &v)
 {
-    m_data.insert(m_data.end(), v.m_data.begin(), v.m_data.end());
+    append(v.data(), static_cast<size_t>(v.length()));
+}
+
+void OctetString::append(const uint8_t *data, size_t length)
+{
+    if (length > 0)
+        std::memcpy(appendUninitialized(static_cast<int>(length)), data, length);
 }
 
 void OctetString::appendUtf8(const std::string &v)
 {
-    m_data.insert(m_data.end(), v.begin(), v.end());
+    append(reinterpret_cast<const uint8_t *>(v.data()), v.size());
 }
 
 void OctetString::appendOctet(uint8_t v)
 {
-    m_data.push_back(v);
+    *appendUninitialized(1) = v;
 }
 
 void OctetString::appendOctet(int v)
 {
-    m_data.push_back(v & 0xFF);
+    *appendUninitialized(1) = static_cast<uint8_t>(v & 0xFF);
 }
 
 void OctetString::appendOctet2(octet2 v)
 {
-    m_data.push_back(v[0]);
-    m_data.push_back(v[1]);
+    Store2(appendUninitialized(2), static_cast<uint16_t>(v));
 }
 
 void OctetString::appendOctet2(uint16_t v)
 {
-    appendOctet(static_cast<uint8_t>(v >> 8 & 0xFF));
-    appendOctet(static_cast<uint8_t>(v & 0xFF));
+    Store2(appendUninitialized(2), v);
 }
 
 void OctetString::appendOctet2(int v)
@@ -50,9 +100,7 @@ void OctetString::appendOctet2(int v)
 
 void OctetString::appendOctet3(octet3 v)
 {
-    m_data.push_back(v[0]);
-    m_data.push_back(v[1]);
-    m_data.push_back(v[2]);
+    octet3::SetTo(v, appendUninitialized(3));
 }
 
 void OctetString::appendOctet3(int v)
@@ -62,22 +110,12 @@ void OctetString::appendOctet3(int v)
 
 void OctetString::appendOctet4(octet4 v)
 {
-    m_data.push_back(v[0]);
-    m_data.push_back(v[1]);
-    m_data.push_back(v[2]);
-    m_data.push_back(v[3]);
+    Store4(appendUninitialized(4), static_cast<uint32_t>(v));
 }
 
 void OctetString::appendOctet8(octet8 v)
 {
-    m_data.push_back(v[0]);
-    m_data.push_back(v[1]);
-    m_data.push_back(v[2]);
-    m_data.push_back(v[3]);
-    m_data.push_back(v[4]);
-    m_data.push_back(v[5]);
-    m_data.push_back(v[6]);
-    m_data.push_back(v[7]);
+    Store8(appendUninitialized(8), static_cast<uint64_t>(v));
 }
 
 void OctetString::appendOctet8(int64_t v)
@@ -97,12 +135,7 @@ void OctetString::appendOctet4(int v)
 
 void OctetString::appendOctet4(uint32_t v)
 {
-    appendOctet4(octet4{v});
-}
-
-int OctetString::length() const
-{
-    return static_cast<int>(m_data.size());
+    Store4(appendUninitialized(4), v);
 }
 
 void OctetString::appendOctet(int bigHalf, int littleHalf)
@@ -112,30 +145,21 @@ void OctetString::appendOctet(int bigHalf, int littleHalf)
     appendOctet(bigHalf << 4 | littleHalf);
 }
 
-const uint8_t *OctetString::data() const
-{
-    return m_data.data();
-}
-
-uint8_t *OctetString::data()
-{
-    return m_data.data();
-}
-
 void OctetString::appendPadding(int length)
 {
-    for (int i = 0; i < length; i++)
-        appendOctet(0);
+    if (length > 0)
+        std::memset(appendUninitialized(length), 0, static_cast<size_t>(length));
 }
 
 OctetString OctetString::FromHex(const std::string &hex)
 {
-    return OctetString{utils::HexStringToVector(hex)};
+    auto v = utils::HexStringToVector(hex);
+    return FromArray(v.data(), v.size());
 }
 
 std::string OctetString::toHexString() const
 {
-    return utils::VectorToHexString(m_data);
+    return utils::ArrayToHexString(data(), static_cast<size_t>(length()));
 }
 
 OctetString OctetString::subCopy(int index) const
@@ -145,12 +169,38 @@ OctetString OctetString::subCopy(int index) const
 
 OctetString OctetString::subCopy(int index, int length) const
 {
-    return OctetString{std::vector<uint8_t>{m_data.data() + index, m_data.data() + index + length}};
+    return FromArray(data() + index, static_cast<size_t>(length));
+}
+
+bool OctetString::operator==(const OctetView &other) const
+{
+    return static_cast<size_t>(length()) == other.remaining() &&
+           std::memcmp(data(), other.address(), other.remaining()) == 0;
+}
+
+bool OctetString::operator!=(const OctetView &other) const
+{
+    return !(*this == other);
+}
+
+OctetView OctetString::view() const
+{
+    return OctetView{data(), static_cast<size_t>(length())};
+}
+
+OctetView OctetString::slice(int index) const
+{
+    return slice(index, length() - index);
+}
+
+OctetView OctetString::slice(int index, int length) const
+{
+    return OctetView{data() + index, static_cast<size_t>(length)};
 }
 
 octet OctetString::get(int index) const
 {
-    return m_data[index];
+    return data()[index];
 }
 
 octet2 OctetString::get2(int index) const
@@ -211,22 +261,18 @@ uint64_t OctetString::get8UL(int index) const
 
 OctetString OctetString::Concat(const OctetString &a, const OctetString &b)
 {
-    std::vector<uint8_t> v1 = a.m_data;
-    std::vector<uint8_t> v2 = b.m_data;
-    std::vector<uint8_t> v3;
-
-    v3.reserve(v1.size() + v2.size());
-    v3.insert(v3.end(), v1.begin(), v1.end());
-    v3.insert(v3.end(), v2.begin(), v2.end());
-
-    return OctetString{std::move(v3)};
+    OctetString res{};
+    res.reserve(a.length() + b.length());
+    res.append(a);
+    res.append(b);
+    return res;
 }
 
 OctetString OctetString::FromOctet(uint8_t value)
 {
-    std::vector<uint8_t> v(1);
-    v[0] = value;
-    return OctetString{std::move(v)};
+    OctetString res{};
+    res.appendOctet(value);
+    return res;
 }
 
 OctetString OctetString::FromOctet(int value)
@@ -236,10 +282,9 @@ OctetString OctetString::FromOctet(int value)
 
 OctetString OctetString::FromOctet2(octet2 value)
 {
-    std::vector<uint8_t> v(2);
-    v[0] = value[0];
-    v[1] = value[1];
-    return OctetString{std::move(v)};
+    OctetString res{};
+    res.appendOctet2(value);
+    return res;
 }
 
 OctetString OctetString::FromOctet2(int value)
@@ -249,12 +294,9 @@ OctetString OctetString::FromOctet2(int value)
 
 OctetString OctetString::FromOctet4(octet4 value)
 {
-    std::vector<uint8_t> v(4);
-    v[0] = value[0];
-    v[1] = value[1];
-    v[2] = value[2];
-    v[3] = value[3];
-    return OctetString{std::move(v)};
+    OctetString res{};
+    res.appendOctet4(value);
+    return res;
 }
 
 OctetString OctetString::FromOctet4(int value)
@@ -269,16 +311,9 @@ OctetString OctetString::FromOctet4(uint32_t value)
 
 OctetString OctetString::FromOctet8(octet8 value)
 {
-    std::vector<uint8_t> v(8);
-    v[0] = value[0];
-    v[1] = value[1];
-    v[2] = value[2];
-    v[3] = value[3];
-    v[4] = value[4];
-    v[5] = value[5];
-    v[6] = value[6];
-    v[7] = value[7];
-    return OctetString{std::move(v)};
+    OctetString res{};
+    res.appendOctet8(value);
+    return res;
 }
 
 OctetString OctetString::FromOctet8(int64_t value)
@@ -298,12 +333,14 @@ OctetString OctetString::copy() const
 
 OctetString OctetString::FromAscii(const std::string &ascii)
 {
-    return OctetString{std::vector<uint8_t>{ascii.c_str(), ascii.c_str() + ascii.length()}};
+    return FromArray(reinterpret_cast<const uint8_t *>(ascii.data()), ascii.size());
 }
 
 OctetString OctetString::FromSpare(int length)
 {
-    return OctetString{std::vector<uint8_t>(length)};
+    OctetString res{};
+    res.appendPadding(length);
+    return res;
 }
 
 OctetString OctetString::Xor(const OctetString &a, const OctetString &b)
@@ -324,7 +361,7 @@ OctetString OctetString::Empty()
 
 OctetString OctetString::FromArray(const uint8_t *arr, size_t len)
 {
-    std::vector<uint8_t> v(len);
-    std::memcpy(v.data(), arr, len);
-    return OctetString(std::move(v));
+    OctetString res{};
+    res.append(arr, len);
+    return res;
 }
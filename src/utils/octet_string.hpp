@@ -10,6 +10,7 @@
 
 #include "octet.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -17,26 +18,61 @@
 #include <vector>
 #include <array>
 
+class OctetView;
+
 class OctetString
 {
+  public:
+    // Values up to this length are stored in place without a heap allocation
+    static constexpr int INLINE_CAPACITY = 32;
+
   private:
-    std::vector<uint8_t> m_data;
+    int m_length;
+    uint8_t m_inline[INLINE_CAPACITY];
+    std::vector<uint8_t> m_heap; // Empty if the value is stored in m_inline, otherwise its size is the capacity
 
   public:
-    OctetString() : m_data()
+    OctetString() : m_length(0), m_heap()
     {
     }
 
-    explicit OctetString(std::vector<uint8_t> &&data) : m_data(std::move(data))
+    explicit OctetString(std::vector<uint8_t> &&data) : m_length(static_cast<int>(data.size())), m_heap(std::move(data))
     {
     }
 
-    OctetString(OctetString &&octetString) noexcept : m_data(std::move(octetString.m_data))
+    OctetString(OctetString &&octetString) noexcept
+        : m_length(octetString.m_length), m_heap(std::move(octetString.m_heap))
     {
+        if (m_heap.empty() && m_length > 0)
+            std::memcpy(m_inline, octetString.m_inline, static_cast<size_t>(m_length));
+        octetString.m_length = 0;
+        octetString.m_heap.clear();
+    }
+
+  private:
+    void grow(int capacity);
+
+    [[nodiscard]] inline int capacity() const
+    {
+        return m_heap.empty() ? INLINE_CAPACITY : static_cast<int>(m_heap.size());
     }
 
   public:
+    /* Ensures that appending up to the given total length does not reallocate */
+    void reserve(int capacity);
+
+    /* Extends the string by the given length and returns the address of the new octets, to be written by the caller */
+    inline uint8_t *appendUninitialized(int length)
+    {
+        if (m_length + length > capacity())
+            grow(std::max(m_length + length, 2 * capacity()));
+        uint8_t *res = data() + m_length;
+        m_length += length;
+        return res;
+    }
+
     void append(const OctetString &v);
+    void append(const uint8_t *data, size_t length);
     void appendUtf8(const std::string &v);
     void appendOctet(uint8_t v);
     void appendOctet(int v);
@@ -55,9 +91,20 @@ class OctetString
     void appendPadding(int length);
 
   public:
-    [[nodiscard]] const uint8_t *data() const;
-    [[nodiscard]] int length() const;
-    uint8_t *data();
+    [[nodiscard]] inline const uint8_t *data() const
+    {
+        return m_heap.empty() ? m_inline : m_heap.data();
+    }
+
+    [[nodiscard]] inline int length() const
+    {
+        return m_length;
+    }
+
+    inline uint8_t *data()
+    {
+        return m_heap.empty() ? m_inline : m_heap.data();
+    }
 
   public:
     [[nodiscard]] octet get(int index) const;
@@ -79,23 +126,37 @@ class OctetString
     [[nodiscard]] OctetString subCopy(int index) const;
     [[nodiscard]] OctetString subCopy(int index, int length) const;
 
+    /* Views share the storage of this string, and are valid until it is modified or destroyed */
+    [[nodiscard]] OctetView view() const;
+    [[nodiscard]] OctetView slice(int index) const;
+    [[nodiscard]] OctetView slice(int index, int length) const;
+
   public:
     inline OctetString &operator=(OctetString &&other) noexcept
     {
-        m_data = std::move(other.m_data);
+        m_length = other.m_length;
+        m_heap = std::move(other.m_heap);
+        if (m_heap.empty() && m_length > 0)
+            std::memcpy(m_inline, other.m_inline, static_cast<size_t>(m_length));
+        other.m_length = 0;
+        other.m_heap.clear();
         return *this;
     }
 
-    inline bool operator==(const OctetString &other)
+    inline bool operator==(const OctetString &other) const
     {
-        return m_data == other.m_data;
+        return length() == other.length() && std::memcmp(data(), other.data(), static_cast<size_t>(length())) == 0;
     }
 
-    inline bool operator!=(const OctetString &other)
+    inline bool operator!=(const OctetString &other) const
     {
-        return m_data != other.m_data;
+        return !(*this == other);
     }
 
+    /* Compares with the remaining octets of the view */
+    bool operator==(const OctetView &other) const;
+    bool operator!=(const OctetView &other) const;
+
   public:
     static OctetString Empty();
     static OctetString FromHex(const std::string &hex);
@@ -22,9 +22,9 @@ OctetString OctetView::readOctetString(int length) const
     if (length == 0)
         return {};
 
-    std::vector<uint8_t> v{data + index, data + index + length};
+    auto res = OctetString::FromArray(data + index, static_cast<size_t>(length));
     index += length;
-    return OctetString(std::move(v));
+    return res;
 }
 
 OctetString OctetView::readOctetString(size_t length) const
@@ -114,6 +114,11 @@ class OctetView
         return (int64_t)read8();
     }
 
+    inline void skip(size_t length) const
+    {
+        index += length;
+    }
+
     inline size_t currentIndex() const
     {
         return index;
@@ -124,6 +129,17 @@ class OctetView
         return index < size;
     }
 
+    /* Address of the current position, e.g. for bulk copies */
+    inline const uint8_t *address() const
+    {
+        return data + index;
+    }
+
+    inline size_t remaining() const
+    {
+        return size - index;
+    }
+
     OctetString readOctetString(int length) const;
     OctetString readOctetString(size_t length) const;
     OctetString readOctetString() const;